@@ -0,0 +1,62 @@
+#include "ast.h"
+#include <algorithm>
+#include <cstring>
+
+namespace mc_core {
+
+    char* BumpAllocator::allocate(size_t size) {
+        if (static_cast<size_t>(end_ - cur_) < size) {
+            size_t blockSize = std::max(blockSize_, size);
+            blocks_.emplace_back(new char[blockSize]);
+            cur_ = blocks_.back().get();
+            end_ = cur_ + blockSize;
+            reserved_ += blockSize;
+        }
+        char* result = cur_;
+        cur_ += size;
+        return result;
+    }
+
+    AstArena::AstArena() {
+        nodes_.emplace_back();  // nodo nulo en el índice 0
+    }
+
+    void AstArena::reserveForSource(size_t sourceBytes) {
+        // Estimación empírica: ~1 nodo por cada 6 bytes de código y 1 entrada de lista por cada 12
+        nodes_.reserve(sourceBytes / 6 + 16);
+        lists_.reserve(sourceBytes / 12 + 16);
+        strings_.reserve(sourceBytes / 32 + 16);
+        interned_.reserve(sourceBytes / 256 + 16);
+    }
+
+    uint32_t AstArena::addList(const NodeId* items, uint32_t count) {
+        uint32_t start = static_cast<uint32_t>(lists_.size());
+        lists_.insert(lists_.end(), items, items + count);
+        return start;
+    }
+
+    StrId AstArena::intern(std::string_view text) {
+        auto it = interned_.find(text);
+        if (it != interned_.end()) {
+            return it->second;
+        }
+        StrId id = addString(text);
+        interned_.emplace(strings_[id], id);
+        return id;
+    }
+
+    StrId AstArena::addString(std::string_view text) {
+        char* bytes = chars_.allocate(text.size());
+        std::memcpy(bytes, text.data(), text.size());
+        strings_.emplace_back(bytes, text.size());
+        return static_cast<StrId>(strings_.size() - 1);
+    }
+
+    size_t AstArena::memoryUsage() const {
+        return nodes_.capacity() * sizeof(AstNode) +
+               lists_.capacity() * sizeof(NodeId) +
+               strings_.capacity() * sizeof(std::string_view) +
+               chars_.bytesReserved();
+    }
+
+} // namespace mc_core
@@ -0,0 +1,218 @@
+#ifndef AST_H
+#define AST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mc_core {
+
+    // Índice de 32 bits de un nodo dentro de AstArena. El índice 0 es el nodo nulo.
+    using NodeId = uint32_t;
+    // Índice de 32 bits de una cadena dentro de AstArena
+    using StrId = uint32_t;
+
+    constexpr NodeId kNoNode = 0;
+
+    /**
+     * Tipos de nodo del AST. Cada nodo usa los campos genéricos a, b, c, d y el
+     * valor inmediato v según la tabla siguiente; las listas de hijos se guardan
+     * como rango (b = inicio, c = cantidad) en el vector de listas de la arena.
+     *
+     *   INT_LIT / FLOAT_LIT / BOOL_LIT   v.i / v.f / v.i
+     *   STRING_LIT / IDENT               v.str
+     *   UNARY        op, a = operando
+     *   BINARY       op, a = izquierda, b = derecha
+     *   ASSIGN       op (NONE o compuesto), a = destino, b = valor
+     *   CALL         a = función, lista de argumentos
+     *   INDEX        a = objeto, b = índice
+     *   MEMBER       a = objeto, v.str = campo
+     *   ARRAY_LIT    lista de elementos
+     *   MAP_LIT      lista alternando clave, valor
+     *   COND_EXPR    a = condición, b = valor si verdadero, d = valor si falso
+     *   BLOCK        lista de sentencias
+     *   EXPR_STMT    a = expresión
+     *   VAR_DECL     v.str = nombre, a = tipo, d = inicializador, flags CONST
+     *   IF           a = condición, b = bloque, d = rama alternativa (BLOCK o IF)
+     *   WHILE        a = condición, d = cuerpo
+     *   FOR_RANGE    v.str = variable, a = desde, b = hasta, c = incremento, d = cuerpo
+     *   FOR_EACH     v.str = variable, a = colección, d = cuerpo
+     *   PARALLEL_FOR a = FOR_RANGE, lista de REDUCTION (PARA PARALELO ... REDUCIR)
+     *   REDUCTION    v.str = variable, op (ADD = SUMA, MUL = PRODUCTO, LT = MIN, GT = MAX)
+     *   RETURN       a = valor (opcional)
+     *   SWITCH       a = sujeto, lista de CASE
+     *   CASE         a = valor (kNoNode en DEFECTO), lista de sentencias, flags GUARD
+     *   FUNC_DECL    v.str = nombre, a = tipo de retorno, lista de PARAM, d = cuerpo
+     *   PARAM        v.str = nombre, a = tipo
+     *   STRUCT_DECL  v.str = nombre, lista de FIELD y FUNC_DECL
+     *   CLASS_DECL   v.str = nombre, a = clase base (IDENT), lista de miembros
+     *   FIELD        v.str = nombre, a = tipo, d = inicializador, flags PRIVATE
+     *   CTOR_DECL    a = llamada al constructor base, lista de PARAM, d = cuerpo
+     *   IMPORT       v.str = módulo
+     *   MODULE_DECL  v.str = nombre, lista de declaraciones
+     *   TYPE         v.str = nombre, lista de argumentos de tipo
+     *   PROGRAM      lista de declaraciones de nivel superior
+     */
+    enum class NodeKind : uint8_t {
+        NONE,
+        INT_LIT,
+        FLOAT_LIT,
+        STRING_LIT,
+        BOOL_LIT,
+        NULL_LIT,
+        IDENT,
+        UNARY,
+        BINARY,
+        ASSIGN,
+        CALL,
+        INDEX,
+        MEMBER,
+        ARRAY_LIT,
+        MAP_LIT,
+        COND_EXPR,
+        BLOCK,
+        EXPR_STMT,
+        VAR_DECL,
+        IF,
+        WHILE,
+        FOR_RANGE,
+        FOR_EACH,
+        PARALLEL_FOR,
+        REDUCTION,
+        RETURN,
+        BREAK,
+        CONTINUE,
+        SWITCH,
+        CASE,
+        FUNC_DECL,
+        PARAM,
+        STRUCT_DECL,
+        CLASS_DECL,
+        FIELD,
+        CTOR_DECL,
+        IMPORT,
+        MODULE_DECL,
+        TYPE,
+        PROGRAM
+    };
+
+    // Operadores de UNARY, BINARY y ASSIGN (compuesto)
+    enum class OpKind : uint8_t {
+        NONE,
+        ADD,
+        SUB,
+        MUL,
+        DIV,
+        MOD,
+        EQ,
+        NE,
+        LT,
+        LE,
+        GT,
+        GE,
+        AND,
+        OR,
+        NEG,
+        NOT
+    };
+
+    // Banderas de nodo
+    enum NodeFlags : uint16_t {
+        FLAG_CONST = 1 << 0,    // VAR_DECL declarado con CONST
+        FLAG_GUARD = 1 << 1,    // CASE cuya etiqueta es una condición booleana
+        FLAG_PRIVATE = 1 << 2,  // FIELD / FUNC_DECL en sección PRIVADO
+        FLAG_METHOD = 1 << 3    // FUNC_DECL declarado dentro de una CLASE o STRUCT
+    };
+
+    // Nodo compacto de 32 bytes; los hijos son índices, nunca punteros
+    struct AstNode {
+        NodeKind kind = NodeKind::NONE;
+        OpKind op = OpKind::NONE;
+        uint16_t flags = 0;
+        uint32_t line = 0;
+        NodeId a = kNoNode;
+        NodeId b = kNoNode;
+        NodeId c = kNoNode;
+        NodeId d = kNoNode;
+        union {
+            int64_t i;
+            double f;
+            StrId str;
+        } v = {0};
+    };
+
+    static_assert(sizeof(AstNode) == 32, "AstNode debe ocupar 32 bytes");
+
+    /**
+     * Asignador por desplazamiento (bump allocator) para los bytes de cadenas del AST.
+     * Reserva bloques grandes y nunca libera individualmente: toda la memoria se
+     * devuelve al destruir la arena.
+     */
+    class BumpAllocator {
+    public:
+        explicit BumpAllocator(size_t blockSize = 64 * 1024) : blockSize_(blockSize) {}
+
+        char* allocate(size_t size);
+        size_t bytesReserved() const { return reserved_; }
+
+    private:
+        size_t blockSize_;
+        size_t reserved_ = 0;
+        char* cur_ = nullptr;
+        char* end_ = nullptr;
+        std::vector<std::unique_ptr<char[]>> blocks_;
+    };
+
+    /**
+     * Arena que contiene todos los nodos, listas de hijos y cadenas de un AST.
+     *
+     * Los nodos viven en un único arreglo contiguo y se direccionan con índices de
+     * 32 bits, de modo que construir el árbol no realiza una asignación por nodo y
+     * recorrerlo es secuencial en memoria.
+     */
+    class AstArena {
+    public:
+        AstArena();
+
+        // Reserva capacidad en función del tamaño del código fuente
+        void reserveForSource(size_t sourceBytes);
+
+        NodeId add(const AstNode& node) {
+            nodes_.push_back(node);
+            return static_cast<NodeId>(nodes_.size() - 1);
+        }
+
+        AstNode& node(NodeId id) { return nodes_[id]; }
+        const AstNode& node(NodeId id) const { return nodes_[id]; }
+        NodeKind kind(NodeId id) const { return nodes_[id].kind; }
+
+        // Copia una lista de hijos a la arena y devuelve su índice inicial
+        uint32_t addList(const NodeId* items, uint32_t count);
+        const NodeId* list(uint32_t start) const { return lists_.data() + start; }
+
+        // Hijos de un nodo con lista (b = inicio, c = cantidad)
+        const NodeId* children(NodeId id) const { return list(nodes_[id].b); }
+        uint32_t childCount(NodeId id) const { return nodes_[id].c; }
+
+        // Cadenas: intern() deduplica identificadores, addString() no
+        StrId intern(std::string_view text);
+        StrId addString(std::string_view text);
+        std::string_view str(StrId id) const { return strings_[id]; }
+
+        size_t nodeCount() const { return nodes_.size() - 1; }
+        size_t memoryUsage() const;
+
+    private:
+        std::vector<AstNode> nodes_;
+        std::vector<NodeId> lists_;
+        std::vector<std::string_view> strings_;
+        std::unordered_map<std::string_view, StrId> interned_;
+        BumpAllocator chars_;
+    };
+
+} // namespace mc_core
+
+#endif // AST_H
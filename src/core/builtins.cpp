@@ -0,0 +1,448 @@
+#include "builtins.h"
+#include "library_bindings.h"
+#include "output.h"
+#include "typed_array.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace mc_core {
+
+    namespace {
+
+        double numberArg(Value* args, int index, const char* function) {
+            if (!args[index].isNumber()) {
+                throw RuntimeError(std::string(function) + " espera un número, no " + typeName(args[index]));
+            }
+            return args[index].asNumber();
+        }
+
+        // Longitud en caracteres (no en bytes) de una cadena UTF-8
+        int64_t utf8Count(std::string_view text) {
+            int64_t count = 0;
+            for (unsigned char c : text) {
+                if ((c & 0xC0) != 0x80) ++count;
+            }
+            return count;
+        }
+
+        int64_t lengthOf(Value v) {
+            if (isString(v)) return utf8Count(asString(v)->view());
+            if (isObjType(v, ObjType::ARRAY)) return static_cast<int64_t>(asArray(v)->items.size());
+            if (isObjType(v, ObjType::TYPED_ARRAY)) return static_cast<int64_t>(asTypedArray(v)->size());
+            if (isObjType(v, ObjType::MAP)) return static_cast<int64_t>(asMap(v)->entries.size());
+            throw RuntimeError(std::string("LONGITUD no admite valores de tipo ") + typeName(v));
+        }
+
+        // -------------------------------------
+        // Funciones globales
+        // -------------------------------------
+
+        Value nativeMostrar(VM&, Value* args, int argc) {
+            // Se reutiliza la línea de la llamada anterior para no reservar memoria cada vez
+            thread_local std::string line;
+            line.clear();
+            for (int i = 0; i < argc; ++i) {
+                if (i > 0) line += ' ';
+                if (isString(args[i])) {
+                    line += asString(args[i])->view();
+                } else {
+                    line += valueToString(args[i]);
+                }
+            }
+            line += '\n';
+            OutputBuffer::local().write(line);
+            return Value::nil();
+        }
+
+        Value nativeLongitud(VM&, Value* args, int) {
+            return Value::integer(lengthOf(args[0]));
+        }
+
+        Value nativeRaiz(VM&, Value* args, int) {
+            double x = numberArg(args, 0, "RAIZ");
+            if (x < 0) throw RuntimeError("RAIZ de un número negativo");
+            return Value::number(std::sqrt(x));
+        }
+
+        Value nativeAbs(VM&, Value* args, int) {
+            if (args[0].isInt() && args[0].asInt() != INT64_MIN) return Value::integer(std::llabs(args[0].asInt()));
+            return Value::number(std::fabs(numberArg(args, 0, "ABS")));
+        }
+
+        Value nativePotencia(VM&, Value* args, int) {
+            if (args[0].isInt() && args[1].isInt() && args[1].asInt() >= 0) {
+                // Exponenciación entera por cuadrados; si desborda se recalcula en FLOAT
+                int64_t base = args[0].asInt();
+                int64_t exponent = args[1].asInt();
+                int64_t result = 1;
+                bool overflow = false;
+                while (exponent > 0 && !overflow) {
+                    if (exponent & 1) overflow = __builtin_mul_overflow(result, base, &result);
+                    exponent >>= 1;
+                    if (exponent > 0 && !overflow) overflow = __builtin_mul_overflow(base, base, &base);
+                }
+                if (!overflow) return Value::integer(result);
+            }
+            return Value::number(std::pow(numberArg(args, 0, "POTENCIA"), numberArg(args, 1, "POTENCIA")));
+        }
+
+        // Dentro de una corrutina la suspende; en otro caso deja correr a las demás
+        Value nativeEsperar(VM& vm, Value* args, int) {
+            vm.wait(numberArg(args, 0, "ESPERAR"));
+            return Value::nil();
+        }
+
+        // LANZAR(f, args...): ejecuta f(args...) en una corrutina nueva y devuelve su identificador
+        Value nativeLanzar(VM& vm, Value* args, int argc) {
+            if (argc < 1) throw RuntimeError("LANZAR espera una función");
+            Value callee = args[0];
+            if (!isObjType(callee, ObjType::FUNCTION) && !isObjType(callee, ObjType::NATIVE) &&
+                !isObjType(callee, ObjType::CLASS)) {
+                throw RuntimeError(std::string("LANZAR espera una función, no ") + typeName(callee));
+            }
+            return Value::integer(vm.spawn(callee, std::vector<Value>(args + 1, args + argc)));
+        }
+
+        Value nativeCadena(VM& vm, Value* args, int) {
+            if (isString(args[0])) return args[0];
+            return vm.newString(valueToString(args[0]));
+        }
+
+        Value nativeEntero(VM&, Value* args, int) {
+            Value v = args[0];
+            if (v.isInt()) return v;
+            if (v.isFloat()) return Value::integer(static_cast<int64_t>(v.asFloat()));
+            if (v.isBool()) return Value::integer(v.asBool() ? 1 : 0);
+            if (isString(v)) {
+                try {
+                    size_t used = 0;
+                    int64_t result = std::stoll(asString(v)->str(), &used);
+                    if (used == asString(v)->length()) return Value::integer(result);
+                } catch (const std::exception&) {
+                }
+                throw RuntimeError("no se puede convertir \"" + asString(v)->str() + "\" a INT");
+            }
+            throw RuntimeError(std::string("no se puede convertir ") + typeName(v) + " a INT");
+        }
+
+        Value nativeDecimal(VM&, Value* args, int) {
+            Value v = args[0];
+            if (v.isNumber()) return Value::number(v.asNumber());
+            if (isString(v)) {
+                try {
+                    size_t used = 0;
+                    double result = std::stod(asString(v)->str(), &used);
+                    if (used == asString(v)->length()) return Value::number(result);
+                } catch (const std::exception&) {
+                }
+                throw RuntimeError("no se puede convertir \"" + asString(v)->str() + "\" a FLOAT");
+            }
+            throw RuntimeError(std::string("no se puede convertir ") + typeName(v) + " a FLOAT");
+        }
+
+        Value nativeTipo(VM& vm, Value* args, int) {
+            return vm.newString(typeName(args[0]));
+        }
+
+        Value nativeAgregar(VM&, Value* args, int) {
+            if (isObjType(args[0], ObjType::TYPED_ARRAY)) {
+                if (!asTypedArray(args[0])->push(args[1])) throw typedElementError(asTypedArray(args[0]), args[1]);
+                return args[0];
+            }
+            if (!isObjType(args[0], ObjType::ARRAY)) {
+                throw RuntimeError(std::string("AGREGAR espera un ARRAY, no ") + typeName(args[0]));
+            }
+            asArray(args[0])->items.push_back(args[1]);
+            writeBarrier(args[0].asObj(), args[1]);
+            return args[0];
+        }
+
+        // -------------------------------------
+        // Métodos de STRING, ARRAY y MAP (args[0] es el receptor)
+        // -------------------------------------
+
+        Value methodLongitud(VM&, Value* args, int) {
+            return Value::integer(lengthOf(args[0]));
+        }
+
+        Value methodEsVacio(VM&, Value* args, int) {
+            return Value::boolean(lengthOf(args[0]) == 0);
+        }
+
+        Value methodNoEsVacio(VM&, Value* args, int) {
+            return Value::boolean(lengthOf(args[0]) != 0);
+        }
+
+        Value methodHasKey(VM&, Value* args, int) {
+            return Value::boolean(asMap(args[0])->find(args[1]) != nullptr);
+        }
+
+        Value methodClaves(VM& vm, Value* args, int) {
+            ObjArray* keys = vm.heap().allocate<ObjArray>();
+            for (const auto& entry : asMap(args[0])->entries) {
+                keys->items.push_back(entry.first);
+            }
+            return Value::object(keys);
+        }
+
+        Value methodContiene(VM&, Value* args, int) {
+            if (isObjType(args[0], ObjType::TYPED_ARRAY)) {
+                const ObjTypedArray* array = asTypedArray(args[0]);
+                if (!args[1].isNumber()) return Value::boolean(false);
+                if (array->elementType == ElementType::INT) {
+                    if (!args[1].isInt()) {
+                        // 2.0 es igual a 2: sólo un FLOAT entero puede estar en un ARRAY<INT>
+                        double x = args[1].asFloat();
+                        if (x != std::trunc(x) || std::fabs(x) > static_cast<double>(Value::kIntMax)) {
+                            return Value::boolean(false);
+                        }
+                        return Value::boolean(std::find(array->ints.begin(), array->ints.end(),
+                                                        static_cast<int64_t>(x)) != array->ints.end());
+                    }
+                    return Value::boolean(std::find(array->ints.begin(), array->ints.end(), args[1].asInt()) !=
+                                          array->ints.end());
+                }
+                return Value::boolean(std::find(array->floats.begin(), array->floats.end(), args[1].asNumber()) !=
+                                      array->floats.end());
+            }
+            for (Value item : asArray(args[0])->items) {
+                if (valuesEqual(item, args[1])) return Value::boolean(true);
+            }
+            return Value::boolean(false);
+        }
+
+        // Reducciones numéricas: sobre ARRAY<INT> / ARRAY<FLOAT> usan los núcleos
+        // vectoriales de typed_array.h; sobre un ARRAY normal, la aritmética de MC++
+        Value methodSuma(VM&, Value* args, int) {
+            if (isObjType(args[0], ObjType::TYPED_ARRAY)) {
+                const ObjTypedArray* array = asTypedArray(args[0]);
+                if (array->elementType == ElementType::FLOAT) {
+                    return Value::number(sumFloats(array->floats.data(), array->floats.size()));
+                }
+                int64_t sum;
+                if (sumInts(array->ints.data(), array->ints.size(), sum)) return Value::integer(sum);
+                double total = 0.0;
+                for (int64_t x : array->ints) total += static_cast<double>(x);
+                return Value::number(total);
+            }
+            int64_t intSum = 0;
+            double floatSum = 0.0;
+            bool isFloat = false;
+            for (Value item : asArray(args[0])->items) {
+                if (!item.isNumber()) throw RuntimeError(std::string("SUMA espera números, no ") + typeName(item));
+                if (!isFloat && item.isInt() && !__builtin_add_overflow(intSum, item.asInt(), &intSum)) continue;
+                if (!isFloat) floatSum = static_cast<double>(intSum);
+                isFloat = true;
+                floatSum += item.asNumber();
+            }
+            return isFloat ? Value::number(floatSum) : Value::integer(intSum);
+        }
+
+        Value extreme(Value* args, bool isMax, const char* name) {
+            if (lengthOf(args[0]) == 0) throw RuntimeError(std::string(name) + " de un ARRAY vacío");
+            if (isObjType(args[0], ObjType::TYPED_ARRAY)) {
+                const ObjTypedArray* array = asTypedArray(args[0]);
+                if (array->elementType == ElementType::INT) {
+                    return Value::integer(isMax ? maxInts(array->ints.data(), array->ints.size())
+                                                : minInts(array->ints.data(), array->ints.size()));
+                }
+                return Value::number(isMax ? maxFloats(array->floats.data(), array->floats.size())
+                                           : minFloats(array->floats.data(), array->floats.size()));
+            }
+            Value best = Value::nil();
+            for (Value item : asArray(args[0])->items) {
+                if (!item.isNumber()) {
+                    throw RuntimeError(std::string(name) + " espera números, no " + typeName(item));
+                }
+                if (best.isNil() || (isMax ? item.asNumber() > best.asNumber() : item.asNumber() < best.asNumber())) {
+                    best = item;
+                }
+            }
+            return best;
+        }
+
+        Value methodMinimo(VM&, Value* args, int) { return extreme(args, false, "MINIMO"); }
+        Value methodMaximo(VM&, Value* args, int) { return extreme(args, true, "MAXIMO"); }
+
+        /**
+         * MAPEAR y FILTRAR llaman a una función de MC++ por elemento. La llamada puede
+         * recolectar basura y mover la pila del VM, así que los argumentos se copian
+         * antes y el resultado parcial se registra como raíz. Sobre un array tipado
+         * devuelven otro del mismo tipo de elemento (MAPEAR sólo si todos los
+         * resultados caben en él; si no, un ARRAY normal).
+         */
+        Value methodMapear(VM& vm, Value* args, int) {
+            Value source = args[0];
+            Value function = args[1];
+            size_t count = static_cast<size_t>(lengthOf(source));
+            ObjArray* mapped = vm.heap().allocate<ObjArray>();
+            vm.pushRoot(Value::object(mapped));
+            std::vector<Value> argument(1);
+            for (size_t i = 0; i < count; ++i) {
+                argument[0] = isObjType(source, ObjType::TYPED_ARRAY) ? asTypedArray(source)->get(i)
+                                                                      : asArray(source)->items[i];
+                Value result = vm.call(function, argument);
+                mapped->items.push_back(result);
+                writeBarrier(mapped, result);
+            }
+            Value result = Value::object(mapped);
+            if (isObjType(source, ObjType::TYPED_ARRAY)) {
+                ObjTypedArray* typed = vm.heap().allocate<ObjTypedArray>(asTypedArray(source)->elementType);
+                bool fits = true;
+                for (size_t i = 0; i < mapped->items.size() && fits; ++i) fits = typed->push(mapped->items[i]);
+                if (fits) result = Value::object(typed);
+            }
+            vm.popRoot();
+            return result;
+        }
+
+        Value methodFiltrar(VM& vm, Value* args, int) {
+            Value source = args[0];
+            Value function = args[1];
+            size_t count = static_cast<size_t>(lengthOf(source));
+            bool typed = isObjType(source, ObjType::TYPED_ARRAY);
+            Value result = typed ? Value::object(vm.heap().allocate<ObjTypedArray>(asTypedArray(source)->elementType))
+                                 : Value::object(vm.heap().allocate<ObjArray>());
+            vm.pushRoot(result);
+            std::vector<Value> argument(1);
+            for (size_t i = 0; i < count; ++i) {
+                argument[0] = typed ? asTypedArray(source)->get(i) : asArray(source)->items[i];
+                if (!vm.call(function, argument).isTruthy()) continue;
+                if (typed) {
+                    asTypedArray(result)->push(argument[0]);
+                } else {
+                    asArray(result)->items.push_back(argument[0]);
+                    writeBarrier(result.asObj(), argument[0]);
+                }
+            }
+            vm.popRoot();
+            return result;
+        }
+
+        Value methodMayusculas(VM& vm, Value* args, int) {
+            std::string text = asString(args[0])->str();
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            return vm.newString(text);
+        }
+
+        Value methodMinusculas(VM& vm, Value* args, int) {
+            std::string text = asString(args[0])->str();
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return vm.newString(text);
+        }
+
+        // -------------------------------------
+        // Módulo "math"
+        // -------------------------------------
+
+        Value mathBinary(VM& vm, Value* args, OpCode op, const char* name) {
+            (void)vm;
+            double a = numberArg(args, 0, name);
+            double b = numberArg(args, 1, name);
+            if (args[0].isInt() && args[1].isInt() && op != OpCode::DIV) {
+                int64_t result;
+                bool overflow = op == OpCode::ADD ? __builtin_add_overflow(args[0].asInt(), args[1].asInt(), &result)
+                              : op == OpCode::SUB ? __builtin_sub_overflow(args[0].asInt(), args[1].asInt(), &result)
+                                                  : __builtin_mul_overflow(args[0].asInt(), args[1].asInt(), &result);
+                if (!overflow) return Value::integer(result);
+            }
+            switch (op) {
+                case OpCode::ADD: return Value::number(a + b);
+                case OpCode::SUB: return Value::number(a - b);
+                case OpCode::MUL: return Value::number(a * b);
+                default:
+                    if (b == 0.0) throw RuntimeError("división por cero");
+                    return Value::number(a / b);
+            }
+        }
+
+        Value mathSumar(VM& vm, Value* args, int) { return mathBinary(vm, args, OpCode::ADD, "math.sumar"); }
+        Value mathRestar(VM& vm, Value* args, int) { return mathBinary(vm, args, OpCode::SUB, "math.restar"); }
+        Value mathMultiplicar(VM& vm, Value* args, int) { return mathBinary(vm, args, OpCode::MUL, "math.multiplicar"); }
+        Value mathDividir(VM& vm, Value* args, int) { return mathBinary(vm, args, OpCode::DIV, "math.dividir"); }
+
+        // -------------------------------------
+        // Módulo "gc"
+        // -------------------------------------
+
+        Value gcEstadisticas(VM& vm, Value*, int) {
+            GcStats stats = vm.heap().stats();
+            ObjMap* map = vm.heap().allocate<ObjMap>();
+            auto set = [&vm, map](const char* key, Value value) { map->set(vm.intern(key), value); };
+            set("memoria_heap", Value::integer(static_cast<int64_t>(stats.heapBytes)));
+            set("memoria_viva", Value::integer(static_cast<int64_t>(stats.liveBytes)));
+            set("objetos", Value::integer(static_cast<int64_t>(stats.objectCount)));
+            set("recolecciones_menores", Value::integer(static_cast<int64_t>(stats.minorCollections)));
+            set("recolecciones_completas", Value::integer(static_cast<int64_t>(stats.majorCollections)));
+            set("pausa_ultima_ms", Value::number(stats.lastPauseMs));
+            set("pausa_maxima_ms", Value::number(stats.maxPauseMs));
+            set("pausa_total_ms", Value::number(stats.totalPauseMs));
+            set("tasa_promocion", Value::number(stats.promotionRate()));
+            return Value::object(map);
+        }
+
+        Value gcRecolectar(VM& vm, Value*, int) {
+            vm.collectGarbage(true);
+            return Value::nil();
+        }
+
+        void defineModuleFunction(VM& vm, ObjModule* module, const std::string& name, NativeFn fn, int arity) {
+            Value native = Value::object(vm.heap().allocate<ObjNative>(fn, module->name + "." + name, arity));
+            module->members[name] = native;
+            writeBarrier(module, native);
+        }
+
+    } // namespace
+
+    void registerBuiltins(VM& vm) {
+        vm.defineNative("MOSTRAR", nativeMostrar, -1);
+        vm.defineNative("LONGITUD", nativeLongitud, 1);
+        vm.defineNative("RAIZ", nativeRaiz, 1);
+        vm.defineNative("ABS", nativeAbs, 1);
+        vm.defineNative("POTENCIA", nativePotencia, 2);
+        vm.defineNative("ESPERAR", nativeEsperar, 1);
+        vm.defineNative("LANZAR", nativeLanzar, -1);
+        vm.defineNative("CADENA", nativeCadena, 1);
+        vm.defineNative("ENTERO", nativeEntero, 1);
+        vm.defineNative("DECIMAL", nativeDecimal, 1);
+        vm.defineNative("TIPO", nativeTipo, 1);
+        vm.defineNative("AGREGAR", nativeAgregar, 2);
+
+        for (ObjType type : {ObjType::STRING, ObjType::ARRAY, ObjType::MAP}) {
+            vm.defineMethod(type, "LONGITUD", methodLongitud, 0);
+            vm.defineMethod(type, "ES_VACIO", methodEsVacio, 0);
+            vm.defineMethod(type, "NO_ES_VACIO", methodNoEsVacio, 0);
+        }
+        vm.defineMethod(ObjType::ARRAY, "AGREGAR", nativeAgregar, 1);
+        vm.defineMethod(ObjType::ARRAY, "CONTIENE", methodContiene, 1);
+        vm.defineMethod(ObjType::ARRAY, "SUMA", methodSuma, 0);
+        vm.defineMethod(ObjType::ARRAY, "MINIMO", methodMinimo, 0);
+        vm.defineMethod(ObjType::ARRAY, "MAXIMO", methodMaximo, 0);
+        vm.defineMethod(ObjType::ARRAY, "MAPEAR", methodMapear, 1);
+        vm.defineMethod(ObjType::ARRAY, "FILTRAR", methodFiltrar, 1);
+        vm.defineMethod(ObjType::MAP, "HAS_KEY", methodHasKey, 1);
+        vm.defineMethod(ObjType::MAP, "CONTIENE", methodHasKey, 1);
+        vm.defineMethod(ObjType::MAP, "CLAVES", methodClaves, 0);
+        vm.defineMethod(ObjType::STRING, "MAYUSCULAS", methodMayusculas, 0);
+        vm.defineMethod(ObjType::STRING, "MINUSCULAS", methodMinusculas, 0);
+
+        ObjModule* math = vm.defineModule("math");
+        defineModuleFunction(vm, math, "sumar", mathSumar, 2);
+        defineModuleFunction(vm, math, "restar", mathRestar, 2);
+        defineModuleFunction(vm, math, "multiplicar", mathMultiplicar, 2);
+        defineModuleFunction(vm, math, "dividir", mathDividir, 2);
+        defineModuleFunction(vm, math, "potencia", nativePotencia, 2);
+        defineModuleFunction(vm, math, "raiz", nativeRaiz, 1);
+        defineModuleFunction(vm, math, "abs", nativeAbs, 1);
+
+        ObjModule* gc = vm.defineModule("gc");
+        defineModuleFunction(vm, gc, "estadisticas", gcEstadisticas, 0);
+        defineModuleFunction(vm, gc, "recolectar", gcRecolectar, 0);
+
+        registerLibraryBindings(vm);
+    }
+
+} // namespace mc_core
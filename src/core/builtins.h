@@ -0,0 +1,18 @@
+#ifndef BUILTINS_H
+#define BUILTINS_H
+
+#include "vm.h"
+
+namespace mc_core {
+
+    /**
+     * Registra en el VM las funciones integradas del lenguaje (MOSTRAR, LONGITUD,
+     * RAIZ, ESPERAR, LANZAR, conversiones...), los métodos de STRING, ARRAY y MAP y los
+     * módulos nativos "math" y "gc" (estadísticas y recolección del heap), más las
+     * funciones de las bibliotecas de C++ enlazadas en library_bindings.h.
+     */
+    void registerBuiltins(VM& vm);
+
+} // namespace mc_core
+
+#endif // BUILTINS_H
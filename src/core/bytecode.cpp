@@ -0,0 +1,151 @@
+#include "bytecode.h"
+#include "object.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace mc_core {
+
+    namespace {
+
+        // Rango máximo de una tabla densa por etiqueta: más huecos pasan al hash perfecto
+        constexpr uint64_t kDenseSpread = 3;
+        // Semillas que se prueban con cada tamaño de tabla antes de duplicarlo
+        constexpr uint64_t kSeedAttempts = 64;
+        constexpr size_t kMaxSlotsPerKey = 16;
+
+        size_t switchSlot(size_t hash, uint64_t seed, size_t mask) {
+            return static_cast<size_t>(((static_cast<uint64_t>(hash) ^ seed) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        }
+
+    } // namespace
+
+    void SwitchTable::build(const std::vector<Value>& constants) {
+        dense.clear();
+        slots.clear();
+        uint32_t none = static_cast<uint32_t>(keys.size());
+        // Una etiqueta repetida nunca se elige: gana el primer CASO, como en la cadena de EQ
+        std::vector<uint32_t> distinct;
+        for (uint32_t c = 0; c < keys.size(); ++c) {
+            bool repeated = false;
+            for (uint32_t d : distinct) repeated = repeated || valuesEqual(constants[keys[d]], constants[keys[c]]);
+            if (!repeated) distinct.push_back(c);
+        }
+        if (distinct.empty()) return;
+
+        bool integers = std::all_of(distinct.begin(), distinct.end(),
+                                    [&](uint32_t c) { return constants[keys[c]].isInt(); });
+        if (integers) {
+            auto range = std::minmax_element(distinct.begin(), distinct.end(), [&](uint32_t x, uint32_t y) {
+                return constants[keys[x]].asInt() < constants[keys[y]].asInt();
+            });
+            int64_t low = constants[keys[*range.first]].asInt();
+            uint64_t spread = static_cast<uint64_t>(constants[keys[*range.second]].asInt()) - static_cast<uint64_t>(low);
+            if (spread < kDenseSpread * distinct.size()) {
+                base = low;
+                dense.assign(spread + 1, none);
+                for (uint32_t c : distinct) {
+                    dense[static_cast<uint64_t>(constants[keys[c]].asInt()) - static_cast<uint64_t>(low)] = c;
+                }
+                return;
+            }
+        }
+
+        size_t size = 1;
+        while (size < 2 * distinct.size()) size <<= 1;
+        for (; size <= kMaxSlotsPerKey * distinct.size(); size <<= 1) {
+            for (uint64_t attempt = 0; attempt < kSeedAttempts; ++attempt) {
+                std::vector<uint32_t> table(size, none);
+                bool collision = false;
+                for (uint32_t c : distinct) {
+                    uint32_t& slot = table[switchSlot(hashValue(constants[keys[c]]), attempt, size - 1)];
+                    collision = collision || slot != none;
+                    slot = c;
+                }
+                if (!collision) {
+                    seed = attempt;
+                    slots = std::move(table);
+                    return;
+                }
+            }
+        }
+        // Etiquetas con el mismo hash: lookup() las recorre en orden
+    }
+
+    uint32_t SwitchTable::lookup(Value subject, const Value* constants) const {
+        uint32_t none = static_cast<uint32_t>(keys.size());
+        if (!dense.empty()) {
+            // Un FLOAT con valor entero es igual a su INT
+            if (!subject.isFloat()) return none;
+            double f = subject.asFloat();
+            if (std::floor(f) != f || std::fabs(f) >= 9.2e18) return none;
+            uint64_t offset = static_cast<uint64_t>(static_cast<int64_t>(f)) - static_cast<uint64_t>(base);
+            return offset < dense.size() ? dense[offset] : none;
+        }
+        if (!slots.empty()) {
+            uint32_t c = slots[switchSlot(hashValue(subject), seed, slots.size() - 1)];
+            return c != none && valuesEqual(subject, constants[keys[c]]) ? c : none;
+        }
+        for (uint32_t c = 0; c < none; ++c) {
+            if (valuesEqual(subject, constants[keys[c]])) return c;
+        }
+        return none;
+    }
+
+    const char* opName(OpCode op) {
+        static const char* const kNames[] = {
+#define MC_OPCODE_NAME(name) #name,
+            MC_OPCODES(MC_OPCODE_NAME)
+#undef MC_OPCODE_NAME
+        };
+        size_t index = static_cast<size_t>(op);
+        return index < static_cast<size_t>(OpCode::COUNT) ? kNames[index] : "???";
+    }
+
+    std::string disassemble(const FunctionProto& proto) {
+        std::string out = "FUNC " + proto.name + " (params=" + std::to_string(proto.numParams) +
+                          ", regs=" + std::to_string(proto.numRegs) +
+                          ", consts=" + std::to_string(proto.constants.size()) + ")\n";
+        char line[160];
+        for (size_t pc = 0; pc < proto.codeSize(); ++pc) {
+            Instr i = proto.codeBegin()[pc];
+            OpCode op = opOf(i);
+            switch (op) {
+                case OpCode::LOADK:
+                    std::snprintf(line, sizeof(line), "%5zu  [%4u]  %-10s %3u %5u    ; %s\n", pc, proto.lineAt(pc),
+                                  opName(op), argA(i), argBx(i),
+                                  valueToString(proto.constants[argBx(i)]).c_str());
+                    break;
+                case OpCode::GETGLOBAL:
+                case OpCode::SETGLOBAL:
+                case OpCode::SWITCH:
+                    std::snprintf(line, sizeof(line), "%5zu  [%4u]  %-10s %3u %5u\n", pc, proto.lineAt(pc),
+                                  opName(op), argA(i), argBx(i));
+                    break;
+                case OpCode::LOADI:
+                case OpCode::LOADIADD:
+                case OpCode::LOADISUB:
+                case OpCode::JMP:
+                case OpCode::JMPIF:
+                case OpCode::JMPIFNOT:
+                case OpCode::FORPREP:
+                case OpCode::FORLOOP:
+                case OpCode::FOREACH:
+                    std::snprintf(line, sizeof(line), "%5zu  [%4u]  %-10s %3u %5d\n", pc, proto.lineAt(pc),
+                                  opName(op), argA(i), argSBx(i));
+                    break;
+                case OpCode::EXTRAARG:
+                    std::snprintf(line, sizeof(line), "%5zu  [%4u]  %-10s %9u\n", pc, proto.lineAt(pc), opName(op),
+                                  argAx(i));
+                    break;
+                default:
+                    std::snprintf(line, sizeof(line), "%5zu  [%4u]  %-10s %3u %3u %3u\n", pc, proto.lineAt(pc),
+                                  opName(op), argA(i), argB(i), argC(i));
+                    break;
+            }
+            out += line;
+        }
+        return out;
+    }
+
+} // namespace mc_core
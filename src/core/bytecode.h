@@ -0,0 +1,290 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "value.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mc_core {
+
+    /**
+     * Juego de instrucciones de la máquina virtual de registros de MC++.
+     *
+     * Cada instrucción ocupa 32 bits: op(8) A(8) B(8) C(8), op(8) A(8) Bx(16) con
+     * sBx = Bx - 32767 para saltos, u op(8) Ax(24). R[x] es un registro del marco
+     * actual, K[x] una constante del prototipo, G[x] una ranura global e IC[x] una
+     * caché en línea del prototipo.
+     *
+     *   NOP                         sin efecto
+     *   MOVE      A B               R[A] = R[B]
+     *   LOADK     A Bx              R[A] = K[Bx]
+     *   LOADI     A sBx             R[A] = sBx (INT)
+     *   LOADBOOL  A B               R[A] = (B != 0)
+     *   LOADNIL   A                 R[A] = NULO
+     *   GETGLOBAL A Bx              R[A] = G[Bx]
+     *   SETGLOBAL A Bx              G[Bx] = R[A]
+     *   ADD..MOD  A B C             R[A] = R[B] op R[C]
+     *   NEG / NOT A B               R[A] = op R[B]
+     *   EQ..LE    A B C             R[A] = R[B] op R[C] (BOOL)
+     *   JMP       sBx               pc += sBx
+     *   JMPIF     A sBx             si R[A] es verdadero: pc += sBx
+     *   JMPIFNOT  A sBx             si R[A] es falso: pc += sBx
+     *   FORPREP   A sBx             R[A]=i, R[A+1]=límite, R[A+2]=paso; si el rango está vacío: pc += sBx
+     *   FORLOOP   A sBx             i += paso; si i sigue en rango: pc += sBx
+     *   FOREACH   A sBx             R[A]=colección, R[A+1]=índice, R[A+2]=elemento; al terminar: pc += sBx
+     *   SWITCH    A Bx              salta al JMP que sigue en la posición del CASO de R[A] en la tabla
+     *                               ST[Bx]: pc += 1 + caso; después de los n JMP de los CASO va el del DEFECTO
+     *   CALL      A B C             R[A] = R[A](R[A+1] .. R[A+B]); C = 1 si R[A+1] es el receptor (SELF)
+     *   PARFOR    A B               PARA PARALELO: R[A] = [trozo(R[A+1] .. R[A+B-3], desde, hasta, paso) ...]
+     *                               con R[A] la función del cuerpo y el rango en R[A+B-2] .. R[A+B]
+     *   SELF      A B C             R[A+1] = R[B]; R[A] = método K[C] de R[B] (+ EXTRAARG)
+     *   RETURN    A B               retorna R[A] (B = 1) o NULO (B = 0)
+     *   NEWARRAY  A B C             R[A] = [R[B] .. R[B+C-1]]
+     *   NEWMAP    A B C             R[A] = {R[B]: R[B+1], ...} con C pares
+     *   GETINDEX  A B C             R[A] = R[B][R[C]]
+     *   SETINDEX  A B C             R[A][R[B]] = R[C]
+     *   GETFIELD  A B C             R[A] = R[B].K[C] (+ EXTRAARG)
+     *   SETFIELD  A B C             R[A].K[B] = R[C] (+ EXTRAARG)
+     *   TOTYPED   A B               R[A] = R[A] convertido en ARRAY<INT> (B = 0) o ARRAY<FLOAT> (B = 1)
+     *   GETTYPED  A B C             R[A] = R[B][R[C]] sin comprobar límites (R[B] es un ARRAY tipado)
+     *   SETTYPED  A B C             R[A][R[B]] = R[C] sin comprobar límites (R[A] es un ARRAY tipado)
+     *   EQJMP..LEJMP A B C          EQ..LE seguida de su JMPIF / JMPIFNOT sobre R[A]: ejecuta las dos
+     *   LOADIADD  A sBx             LOADI seguida de ADD: ejecuta las dos
+     *   LOADISUB  A sBx             LOADI seguida de SUB: ejecuta las dos
+     *   TAILCALL  A B C             CALL seguida de RETURN A 1: si R[A] es una FUNC, su marco
+     *                               sustituye al actual (llamada final); si no, es un CALL
+     *   EXTRAARG  Ax                operando de la instrucción anterior: su caché IC[Ax];
+     *                               nunca se ejecuta por sí misma
+     *
+     * Las superinstrucciones (EQJMP..TAILCALL) sustituyen el código de operación de la
+     * primera instrucción de un par y dejan la segunda intacta detrás, así que un salto a
+     * la segunda sigue siendo válido y deshacer la fusión (unfuse) devuelve el bytecode
+     * original. Las genera el optimizador, salvo TAILCALL, que ya emite el generador de
+     * código para RETORNAR f(...) para que la recursión final no acumule marcos en -O0.
+     */
+#define MC_OPCODES(X) \
+    X(NOP)            \
+    X(MOVE)           \
+    X(LOADK)          \
+    X(LOADI)          \
+    X(LOADBOOL)       \
+    X(LOADNIL)        \
+    X(GETGLOBAL)      \
+    X(SETGLOBAL)      \
+    X(ADD)            \
+    X(SUB)            \
+    X(MUL)            \
+    X(DIV)            \
+    X(MOD)            \
+    X(NEG)            \
+    X(NOT)            \
+    X(EQ)             \
+    X(NE)             \
+    X(LT)             \
+    X(LE)             \
+    X(JMP)            \
+    X(JMPIF)          \
+    X(JMPIFNOT)       \
+    X(FORPREP)        \
+    X(FORLOOP)        \
+    X(FOREACH)        \
+    X(SWITCH)         \
+    X(CALL)           \
+    X(PARFOR)         \
+    X(SELF)           \
+    X(RETURN)         \
+    X(NEWARRAY)       \
+    X(NEWMAP)         \
+    X(GETINDEX)       \
+    X(SETINDEX)       \
+    X(GETFIELD)       \
+    X(SETFIELD)       \
+    X(TOTYPED)        \
+    X(GETTYPED)       \
+    X(SETTYPED)       \
+    X(EQJMP)          \
+    X(NEJMP)          \
+    X(LTJMP)          \
+    X(LEJMP)          \
+    X(LOADIADD)       \
+    X(LOADISUB)       \
+    X(TAILCALL)       \
+    X(EXTRAARG)
+
+    enum class OpCode : uint8_t {
+#define MC_OPCODE_ENUM(name) name,
+        MC_OPCODES(MC_OPCODE_ENUM)
+#undef MC_OPCODE_ENUM
+        COUNT
+    };
+
+    using Instr = uint32_t;
+
+    constexpr int kMaxBx = 0xFFFF;
+    constexpr int kSBxBias = 0x7FFF;
+    constexpr int kMaxRegisters = 250;
+    constexpr uint32_t kMaxAx = 0xFFFFFF;
+
+    inline Instr encodeABC(OpCode op, uint32_t a, uint32_t b, uint32_t c) {
+        return static_cast<uint32_t>(op) | (a << 8) | (b << 16) | (c << 24);
+    }
+
+    inline Instr encodeABx(OpCode op, uint32_t a, uint32_t bx) {
+        return static_cast<uint32_t>(op) | (a << 8) | (bx << 16);
+    }
+
+    inline Instr encodeAx(OpCode op, uint32_t ax) {
+        return static_cast<uint32_t>(op) | (ax << 8);
+    }
+
+    inline Instr encodeAsBx(OpCode op, uint32_t a, int32_t sbx) {
+        return encodeABx(op, a, static_cast<uint32_t>(sbx + kSBxBias));
+    }
+
+    inline OpCode opOf(Instr i) { return static_cast<OpCode>(i & 0xFF); }
+    inline uint32_t argA(Instr i) { return (i >> 8) & 0xFF; }
+    inline uint32_t argB(Instr i) { return (i >> 16) & 0xFF; }
+    inline uint32_t argC(Instr i) { return (i >> 24) & 0xFF; }
+    inline uint32_t argBx(Instr i) { return i >> 16; }
+    inline int32_t argSBx(Instr i) { return static_cast<int32_t>(i >> 16) - kSBxBias; }
+    inline uint32_t argAx(Instr i) { return i >> 8; }
+
+    // Instrucciones seguidas de un EXTRAARG con el índice de su caché en línea
+    inline bool hasInlineCache(OpCode op) {
+        return op == OpCode::GETFIELD || op == OpCode::SETFIELD || op == OpCode::SELF;
+    }
+
+    // Instrucción que el optimizador fusionó en una superinstrucción, o la propia `op`
+    inline OpCode baseOp(OpCode op) {
+        switch (op) {
+            case OpCode::EQJMP: return OpCode::EQ;
+            case OpCode::NEJMP: return OpCode::NE;
+            case OpCode::LTJMP: return OpCode::LT;
+            case OpCode::LEJMP: return OpCode::LE;
+            case OpCode::LOADIADD:
+            case OpCode::LOADISUB: return OpCode::LOADI;
+            case OpCode::TAILCALL: return OpCode::CALL;
+            default: return op;
+        }
+    }
+
+    inline bool isFused(OpCode op) { return baseOp(op) != op; }
+
+    // La primera instrucción del par con su código de operación original
+    inline Instr unfuse(Instr i) { return (i & ~Instr(0xFF)) | static_cast<Instr>(baseOp(opOf(i))); }
+
+    // Nombre textual de un código de operación
+    const char* opName(OpCode op);
+
+    struct ObjClass;
+
+    /**
+     * Caché en línea de un acceso a campo o método (GETFIELD, SETFIELD, SELF).
+     *
+     * La clase de una instancia hace de forma ("hidden class"): su disposición de
+     * campos queda fija al declararla y las subclases la amplían por el final, así que
+     * para una clase dada el nombre se resuelve siempre al mismo índice o al mismo
+     * método. Con una clase registrada el sitio es monomórfico y el acceso se reduce a
+     * comparar la clase y cargar un campo de desplazamiento fijo; admite hasta kWays
+     * clases (polimórfico) y después queda megamórfico: las clases nuevas se buscan
+     * en una tabla del VM indexada por (clase, nombre).
+     */
+    struct InlineCache {
+        static constexpr uint8_t kWays = 4;
+        static constexpr uint32_t kMethod = 0xFFFFFFFF;
+
+        struct Entry {
+            ObjClass* klass = nullptr;
+            uint32_t field = kMethod;   // Índice del campo, o kMethod si es un método
+            Value method;
+        };
+
+        Entry entries[kWays];
+        uint8_t count = 0;
+        bool megamorphic = false;
+
+        const Entry* find(const ObjClass* klass) const {
+            for (uint8_t i = 0; i < count; ++i) {
+                if (entries[i].klass == klass) return &entries[i];
+            }
+            return nullptr;
+        }
+
+        void add(ObjClass* klass, uint32_t field, Value method) {
+            if (count == kWays) {
+                megamorphic = true;
+                return;
+            }
+            entries[count++] = Entry{klass, field, method};
+        }
+    };
+
+    /**
+     * Tabla de saltos de una SELECCION cuyos CASO son todos literales INT o STRING.
+     *
+     * find() devuelve la posición del primer CASO igual al sujeto (con la igualdad de
+     * EQ: 2.0 coincide con CASO 2) o keys.size() para el DEFECTO. Si las etiquetas son
+     * enteros densos se indexa directamente un arreglo; si no, un hash perfecto (una
+     * semilla sin colisiones entre las etiquetas) deja una sola comparación por
+     * búsqueda. La caché .mcc guarda sólo `keys` y la tabla se reconstruye al cargarla.
+     */
+    struct SwitchTable {
+        std::vector<uint32_t> keys;     // Constante de la etiqueta de cada CASO, en orden
+        int64_t base = 0;               // Tabla densa: CASO de cada entero base, base+1...
+        std::vector<uint32_t> dense;
+        std::vector<uint32_t> slots;    // Hash perfecto: CASO de cada ranura
+        uint64_t seed = 0;
+
+        // Prepara la búsqueda para las constantes del prototipo
+        void build(const std::vector<Value>& constants);
+
+        uint32_t find(Value subject, const Value* constants) const {
+            if (subject.isInt() && !dense.empty()) {
+                uint64_t offset = static_cast<uint64_t>(subject.asInt()) - static_cast<uint64_t>(base);
+                return offset < dense.size() ? dense[offset] : static_cast<uint32_t>(keys.size());
+            }
+            return lookup(subject, constants);
+        }
+
+    private:
+        uint32_t lookup(Value subject, const Value* constants) const;
+    };
+
+    /**
+     * Prototipo de función compilada: código, tabla de líneas y constantes.
+     * Pertenece al VM que lo creó y vive mientras éste exista.
+     *
+     * El generador de código rellena `code` y `lines`. Un prototipo cargado de la
+     * caché .mcc apunta en cambio al archivo mapeado (mappedCode/mappedLines), que
+     * `storage` mantiene abierto; por eso el VM accede al código con codeBegin().
+     * Las cachés en línea son estado de ejecución: se crean vacías en ambos casos.
+     */
+    struct FunctionProto {
+        std::string name;
+        uint8_t numParams = 0;
+        uint8_t numRegs = 0;      // Tamaño del marco de registros
+        bool isMethod = false;    // R[0] recibe la instancia (este)
+        std::vector<Instr> code;
+        std::vector<uint32_t> lines;
+        std::vector<Value> constants;
+        mutable std::vector<InlineCache> inlineCaches;
+        std::vector<SwitchTable> switchTables;
+
+        const Instr* mappedCode = nullptr;
+        const uint32_t* mappedLines = nullptr;
+        uint32_t mappedSize = 0;
+        std::shared_ptr<const void> storage;
+
+        const Instr* codeBegin() const { return mappedCode != nullptr ? mappedCode : code.data(); }
+        size_t codeSize() const { return mappedCode != nullptr ? mappedSize : code.size(); }
+        uint32_t lineAt(size_t pc) const { return mappedCode != nullptr ? mappedLines[pc] : lines[pc]; }
+    };
+
+    // Listado legible del bytecode de un prototipo
+    std::string disassemble(const FunctionProto& proto);
+
+} // namespace mc_core
+
+#endif // BYTECODE_H
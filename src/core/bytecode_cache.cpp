@@ -0,0 +1,711 @@
+#include "bytecode_cache.h"
+#include "../../version.h"
+#include "object.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mc_core {
+
+    namespace {
+
+        constexpr char kMagic[4] = {'M', 'C', 'C', '\0'};
+        constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+        /**
+         * Formato del archivo (todos los enteros en el orden de bytes nativo):
+         *
+         *   CacheHeader                     con el hash de todo lo que la sigue (payloadHash)
+         *   CachedConstant[constantCount]   constantes de todos los prototipos
+         *   CachedProto[protoCount]
+         *   CachedObject[objectCount]       cadenas, funciones, clases y módulos
+         *   CachedString[stringCount]       rangos dentro de chars
+         *   uint32_t[wordCount]             código, líneas, globales, tablas de SWITCH y listas de clases
+         *   char[charCount]
+         */
+        struct CacheHeader {
+            char magic[4];
+            uint32_t format;
+            uint64_t sourceHash;
+            uint64_t compilerHash;
+            uint64_t payloadHash;    // hashPayload de las secciones que siguen a la cabecera
+            uint32_t scriptProto;
+            uint32_t globals;        // Primer word de la tabla de globales (ids de cadena)
+            uint32_t globalCount;
+            uint32_t constantCount;
+            uint32_t protoCount;
+            uint32_t objectCount;
+            uint32_t stringCount;
+            uint32_t wordCount;
+            uint32_t charCount;
+            uint32_t optimizationLevel;  // -O con el que se optimizó el bytecode
+        };
+
+        struct CachedConstant {
+            uint64_t bits;           // Valor inmediato (si object == kNone)
+            uint32_t object;         // Índice en la tabla de objetos
+            uint32_t reserved;
+        };
+
+        struct CachedProto {
+            uint32_t name;
+            uint32_t numParams;
+            uint32_t numRegs;
+            uint32_t isMethod;
+            uint32_t code;           // Primer word del código
+            uint32_t lines;          // Primer word de la tabla de líneas
+            uint32_t size;           // Número de instrucciones
+            uint32_t constants;      // Primera constante
+            uint32_t constantCount;
+            uint32_t inlineCaches;   // Número de cachés en línea (se crean vacías)
+            uint32_t switchTables;   // Primer word de las tablas: (n, n constantes) por tabla
+            uint32_t switchTableCount;
+        };
+
+        struct CachedObject {
+            uint32_t type;           // ObjType
+            uint32_t name;           // Texto de la cadena o nombre de la clase/módulo
+            uint32_t proto;          // FUNCTION
+            uint32_t base;           // CLASS: objeto de la clase base o kNone
+            uint32_t constructor;    // CLASS: objeto función del constructor
+            uint32_t fields;         // CLASS: ids de cadena de los campos
+            uint32_t fieldCount;
+            uint32_t methods;        // CLASS: pares (id de cadena, objeto)
+            uint32_t methodCount;
+        };
+
+        struct CachedString {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        static_assert(sizeof(CacheHeader) % 8 == 0, "las constantes deben quedar alineadas a 8 bytes");
+
+        uint64_t compilerHash() {
+            return hashSource(mc_version::getVersion() + "/" + std::to_string(kCacheFormatVersion));
+        }
+
+        // Hash de las secciones, de 8 en 8 bytes para no alargar la carga: detecta un archivo
+        // dañado. No es una firma: validate comprueba además cada referencia y operando
+        uint64_t hashPayload(const char* data, size_t size) {
+            uint64_t hash = 0xcbf29ce484222325ull ^ size;
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, data + i, sizeof(word));
+                hash = (hash ^ word) * 0x100000001b3ull;
+                hash ^= hash >> 29;
+            }
+            for (; i < size; ++i) hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001b3ull;
+            return hash;
+        }
+
+        // Construye la imagen del archivo a partir de los prototipos del VM
+        class CacheWriter {
+        public:
+            explicit CacheWriter(const VM& vm) : vm_(vm) {}
+
+            bool build(const FunctionProto* script, uint64_t sourceHash, int optimizationLevel, std::string& image) {
+                const auto& protos = vm_.protos();
+                for (size_t i = 0; i < protos.size(); ++i) {
+                    protoIndex_.emplace(protos[i].get(), static_cast<uint32_t>(i));
+                }
+                auto scriptIt = protoIndex_.find(script);
+                if (scriptIt == protoIndex_.end()) return false;
+
+                CacheHeader header{};
+                std::memcpy(header.magic, kMagic, sizeof(kMagic));
+                header.format = kCacheFormatVersion;
+                header.sourceHash = sourceHash;
+                header.compilerHash = compilerHash();
+                header.optimizationLevel = static_cast<uint32_t>(optimizationLevel);
+                header.scriptProto = scriptIt->second;
+
+                header.globals = static_cast<uint32_t>(words_.size());
+                header.globalCount = static_cast<uint32_t>(vm_.globalCount());
+                for (uint32_t slot = 0; slot < header.globalCount; ++slot) {
+                    words_.push_back(stringId(vm_.globalName(slot)));
+                }
+
+                for (const auto& proto : protos) {
+                    CachedProto cached{};
+                    cached.name = stringId(proto->name);
+                    cached.numParams = proto->numParams;
+                    cached.numRegs = proto->numRegs;
+                    cached.isMethod = proto->isMethod ? 1 : 0;
+                    cached.size = static_cast<uint32_t>(proto->codeSize());
+                    cached.inlineCaches = static_cast<uint32_t>(proto->inlineCaches.size());
+                    cached.code = static_cast<uint32_t>(words_.size());
+                    words_.insert(words_.end(), proto->codeBegin(), proto->codeBegin() + proto->codeSize());
+                    cached.lines = static_cast<uint32_t>(words_.size());
+                    for (size_t pc = 0; pc < proto->codeSize(); ++pc) words_.push_back(proto->lineAt(pc));
+                    cached.switchTables = static_cast<uint32_t>(words_.size());
+                    cached.switchTableCount = static_cast<uint32_t>(proto->switchTables.size());
+                    for (const SwitchTable& table : proto->switchTables) {
+                        words_.push_back(static_cast<uint32_t>(table.keys.size()));
+                        words_.insert(words_.end(), table.keys.begin(), table.keys.end());
+                    }
+                    cached.constants = static_cast<uint32_t>(constants_.size());
+                    cached.constantCount = static_cast<uint32_t>(proto->constants.size());
+                    for (Value value : proto->constants) {
+                        CachedConstant constant{};
+                        constant.bits = value.bits();
+                        constant.object = kNone;
+                        if (value.isObj()) {
+                            constant.bits = 0;
+                            constant.object = objectId(value.asObj());
+                        }
+                        constants_.push_back(constant);
+                    }
+                    protos_.push_back(cached);
+                }
+                if (!ok_) return false;
+
+                header.constantCount = static_cast<uint32_t>(constants_.size());
+                header.protoCount = static_cast<uint32_t>(protos_.size());
+                header.objectCount = static_cast<uint32_t>(objects_.size());
+                header.stringCount = static_cast<uint32_t>(strings_.size());
+                header.wordCount = static_cast<uint32_t>(words_.size());
+                header.charCount = static_cast<uint32_t>(chars_.size());
+
+                image.clear();
+                append(image, &header, sizeof(header));
+                append(image, constants_.data(), constants_.size() * sizeof(CachedConstant));
+                append(image, protos_.data(), protos_.size() * sizeof(CachedProto));
+                append(image, objects_.data(), objects_.size() * sizeof(CachedObject));
+                append(image, strings_.data(), strings_.size() * sizeof(CachedString));
+                append(image, words_.data(), words_.size() * sizeof(uint32_t));
+                append(image, chars_.data(), chars_.size());
+                header.payloadHash = hashPayload(image.data() + sizeof(header), image.size() - sizeof(header));
+                std::memcpy(&image[0], &header, sizeof(header));
+                return true;
+            }
+
+        private:
+            const VM& vm_;
+            bool ok_ = true;
+            std::vector<CachedConstant> constants_;
+            std::vector<CachedProto> protos_;
+            std::vector<CachedObject> objects_;
+            std::vector<CachedString> strings_;
+            std::vector<uint32_t> words_;
+            std::string chars_;
+            std::unordered_map<const FunctionProto*, uint32_t> protoIndex_;
+            std::unordered_map<const Obj*, uint32_t> objectIndex_;
+            std::unordered_map<std::string, uint32_t> stringIndex_;
+
+            static void append(std::string& image, const void* data, size_t size) {
+                image.append(static_cast<const char*>(data), size);
+            }
+
+            uint32_t stringId(const std::string& text) {
+                auto it = stringIndex_.find(text);
+                if (it != stringIndex_.end()) return it->second;
+                uint32_t id = static_cast<uint32_t>(strings_.size());
+                strings_.push_back(CachedString{static_cast<uint32_t>(chars_.size()), static_cast<uint32_t>(text.size())});
+                chars_ += text;
+                stringIndex_.emplace(text, id);
+                return id;
+            }
+
+            uint32_t objectId(const Obj* object) {
+                auto it = objectIndex_.find(object);
+                if (it != objectIndex_.end()) return it->second;
+                // Se reserva el índice antes de recorrer las referencias (clase base, métodos)
+                uint32_t id = static_cast<uint32_t>(objects_.size());
+                objectIndex_.emplace(object, id);
+                objects_.emplace_back();
+
+                CachedObject cached{};
+                cached.type = static_cast<uint32_t>(object->type);
+                cached.proto = kNone;
+                cached.base = kNone;
+                cached.constructor = kNone;
+                switch (object->type) {
+                    case ObjType::STRING:
+                        cached.name = stringId(static_cast<const ObjString*>(object)->str());
+                        break;
+                    case ObjType::FUNCTION: {
+                        auto proto = protoIndex_.find(static_cast<const ObjFunction*>(object)->proto);
+                        if (proto == protoIndex_.end()) {
+                            ok_ = false;
+                            break;
+                        }
+                        cached.proto = proto->second;
+                        break;
+                    }
+                    case ObjType::CLASS: {
+                        const ObjClass* klass = static_cast<const ObjClass*>(object);
+                        cached.name = stringId(klass->name);
+                        if (klass->base != nullptr) cached.base = objectId(klass->base);
+                        if (klass->constructor.isObj()) cached.constructor = objectId(klass->constructor.asObj());
+                        std::vector<uint32_t> list;
+                        for (const std::string& field : klass->fields) list.push_back(stringId(field));
+                        cached.fields = static_cast<uint32_t>(words_.size());
+                        cached.fieldCount = static_cast<uint32_t>(list.size());
+                        words_.insert(words_.end(), list.begin(), list.end());
+
+                        // Orden estable para que el mismo programa produzca el mismo archivo
+                        std::vector<std::pair<std::string, Value>> methods(klass->methods.begin(), klass->methods.end());
+                        std::sort(methods.begin(), methods.end(),
+                                  [](const auto& a, const auto& b) { return a.first < b.first; });
+                        list.clear();
+                        for (const auto& method : methods) {
+                            if (!isObjType(method.second, ObjType::FUNCTION)) {
+                                ok_ = false;
+                                continue;
+                            }
+                            list.push_back(stringId(method.first));
+                            list.push_back(objectId(method.second.asObj()));
+                        }
+                        cached.methods = static_cast<uint32_t>(words_.size());
+                        cached.methodCount = static_cast<uint32_t>(list.size() / 2);
+                        words_.insert(words_.end(), list.begin(), list.end());
+                        break;
+                    }
+                    case ObjType::MODULE:
+                        cached.name = stringId(static_cast<const ObjModule*>(object)->name);
+                        break;
+                    default:
+                        // Las constantes nunca contienen nativas, listas ni instancias
+                        ok_ = false;
+                        break;
+                }
+                objects_[id] = cached;
+                return id;
+            }
+        };
+
+        // Archivo mapeado en memoria de solo lectura; se libera con el último prototipo que lo usa
+        class MappedFile {
+        public:
+            static std::shared_ptr<MappedFile> open(const std::string& path) {
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0) return nullptr;
+                struct stat info;
+                if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+                    ::close(fd);
+                    return nullptr;
+                }
+                size_t size = static_cast<size_t>(info.st_size);
+                void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (data == MAP_FAILED) return nullptr;
+                return std::shared_ptr<MappedFile>(new MappedFile(data, size));
+            }
+
+            ~MappedFile() { ::munmap(data_, size_); }
+
+            const char* data() const { return static_cast<const char*>(data_); }
+            size_t size() const { return size_; }
+
+        private:
+            MappedFile(void* data, size_t size) : data_(data), size_(size) {}
+
+            void* data_;
+            size_t size_;
+        };
+
+        // Vista validada de las secciones de un archivo mapeado
+        struct CacheImage {
+            const CacheHeader* header;
+            const CachedConstant* constants;
+            const CachedProto* protos;
+            const CachedObject* objects;
+            const CachedString* strings;
+            const uint32_t* words;
+            const char* chars;
+
+            std::string string(uint32_t id) const {
+                return std::string(chars + strings[id].offset, strings[id].length);
+            }
+
+            bool wordRange(uint64_t first, uint64_t count) const { return first + count <= header->wordCount; }
+        };
+
+        // Operandos de la instrucción code[pc]: registros por debajo de numRegs, constantes y
+        // globales que existen y saltos que caen dentro del código. payloadHash no es una firma
+        // (quien edita el archivo puede recalcularlo), así que el VM no se fía de ninguno
+        bool operandsValid(const CachedProto& p, const uint32_t* code, uint32_t pc, uint32_t globalCount) {
+            Instr instr = code[pc];
+            uint64_t a = argA(instr), b = argB(instr), c = argC(instr);
+            auto regs = [&p](uint64_t first, uint64_t count) { return first + count <= p.numRegs; };
+            auto target = [&p, pc](Instr jump) {
+                int64_t to = static_cast<int64_t>(pc) + 1 + argSBx(jump);
+                return to >= 0 && to < static_cast<int64_t>(p.size);
+            };
+            switch (opOf(instr)) {
+                case OpCode::NOP:
+                case OpCode::EXTRAARG:  // Su índice lo comprueba la instrucción a la que acompaña
+                    return true;
+                case OpCode::LOADI:
+                case OpCode::LOADBOOL:
+                case OpCode::LOADNIL:
+                case OpCode::TOTYPED:
+                case OpCode::SWITCH:
+                    return regs(a, 1);
+                case OpCode::MOVE:
+                case OpCode::NEG:
+                case OpCode::NOT:
+                    return regs(a, 1) && regs(b, 1);
+                case OpCode::LOADK:
+                    return regs(a, 1) && argBx(instr) < p.constantCount;
+                case OpCode::GETGLOBAL:
+                case OpCode::SETGLOBAL:
+                    return regs(a, 1) && argBx(instr) < globalCount;
+                case OpCode::ADD:
+                case OpCode::SUB:
+                case OpCode::MUL:
+                case OpCode::DIV:
+                case OpCode::MOD:
+                case OpCode::EQ:
+                case OpCode::NE:
+                case OpCode::LT:
+                case OpCode::LE:
+                case OpCode::GETINDEX:
+                case OpCode::SETINDEX:
+                case OpCode::GETTYPED:
+                case OpCode::SETTYPED:
+                    return regs(a, 1) && regs(b, 1) && regs(c, 1);
+                case OpCode::EQJMP:
+                case OpCode::NEJMP:
+                case OpCode::LTJMP:
+                case OpCode::LEJMP: {
+                    // El salto lo hace la instrucción que sigue, que se comprueba como JMPIF o JMPIFNOT
+                    OpCode next = opOf(code[pc + 1]);
+                    return regs(a, 1) && regs(b, 1) && regs(c, 1) &&
+                           (next == OpCode::JMPIF || next == OpCode::JMPIFNOT);
+                }
+                case OpCode::LOADIADD:
+                    return regs(a, 1) && opOf(code[pc + 1]) == OpCode::ADD;
+                case OpCode::LOADISUB:
+                    return regs(a, 1) && opOf(code[pc + 1]) == OpCode::SUB;
+                case OpCode::JMP:
+                    return target(instr);
+                case OpCode::JMPIF:
+                case OpCode::JMPIFNOT:
+                    return regs(a, 1) && target(instr);
+                case OpCode::FORPREP:
+                case OpCode::FORLOOP:
+                case OpCode::FOREACH:
+                    return regs(a, 3) && target(instr);
+                case OpCode::CALL:
+                case OpCode::TAILCALL:
+                case OpCode::PARFOR:
+                    return regs(a, 1 + b);
+                case OpCode::NEWARRAY:
+                    return regs(a, 1) && regs(b, c);
+                case OpCode::NEWMAP:
+                    return regs(a, 1) && regs(b, 2 * c);
+                case OpCode::SELF:
+                    return regs(a, 2) && regs(b, 1) && c < p.constantCount;
+                case OpCode::RETURN:
+                    return b == 0 || regs(a, 1);
+                case OpCode::GETFIELD:
+                    return regs(a, 1) && regs(b, 1) && c < p.constantCount;
+                case OpCode::SETFIELD:
+                    return regs(a, 1) && b < p.constantCount && regs(c, 1);
+                case OpCode::COUNT:
+                    break;
+            }
+            return false;
+        }
+
+        // Comprueba que las referencias entre secciones (cadenas, constantes, prototipos, objetos,
+        // tablas y cachés en línea) están dentro de rango, que los códigos de operación existen y
+        // que los operandos de cada instrucción son válidos (operandsValid)
+        bool validate(const CacheImage& image) {
+            const CacheHeader& h = *image.header;
+            if (h.scriptProto >= h.protoCount || !image.wordRange(h.globals, h.globalCount)) return false;
+            for (uint32_t i = 0; i < h.stringCount; ++i) {
+                if (static_cast<uint64_t>(image.strings[i].offset) + image.strings[i].length > h.charCount) return false;
+            }
+            for (uint32_t i = 0; i < h.globalCount; ++i) {
+                if (image.words[h.globals + i] >= h.stringCount) return false;
+            }
+            for (uint32_t i = 0; i < h.constantCount; ++i) {
+                uint32_t object = image.constants[i].object;
+                if (object != kNone && object >= h.objectCount) return false;
+                if (object == kNone && Value::fromBits(image.constants[i].bits).isObj()) return false;
+            }
+            for (uint32_t i = 0; i < h.protoCount; ++i) {
+                const CachedProto& p = image.protos[i];
+                if (p.name >= h.stringCount || p.numRegs > static_cast<uint32_t>(kMaxRegisters) ||
+                    p.numParams > p.numRegs) {
+                    return false;
+                }
+                if (!image.wordRange(p.code, p.size) || !image.wordRange(p.lines, p.size)) return false;
+                if (static_cast<uint64_t>(p.constants) + p.constantCount > h.constantCount) return false;
+                std::vector<uint32_t> tableCases;
+                uint64_t word = p.switchTables;
+                for (uint32_t t = 0; t < p.switchTableCount; ++t) {
+                    if (!image.wordRange(word, 1) || !image.wordRange(word + 1, image.words[word])) return false;
+                    for (uint32_t k = 0; k < image.words[word]; ++k) {
+                        if (image.words[word + 1 + k] >= p.constantCount) return false;
+                    }
+                    tableCases.push_back(image.words[word]);
+                    word += 1 + image.words[word];
+                }
+                // El VM indexa las cachés en línea y las tablas sin comprobar: cada acceso
+                // debe ir seguido de su EXTRAARG con un índice válido, cada SWITCH de sus
+                // JMP y cada superinstrucción de su segunda instrucción
+                const uint32_t* code = image.words + p.code;
+                // La última instrucción no puede seguir de largo más allá del código
+                OpCode lastOp = p.size == 0 ? OpCode::NOP : opOf(code[p.size - 1]);
+                if (lastOp != OpCode::RETURN && lastOp != OpCode::JMP) return false;
+                for (uint32_t pc = 0; pc < p.size; ++pc) {
+                    OpCode op = opOf(code[pc]);
+                    // El despacho por hilos salta a través de una tabla indexada por el código
+                    if (static_cast<uint32_t>(op) >= static_cast<uint32_t>(OpCode::COUNT)) return false;
+                    if (op == OpCode::SWITCH) {
+                        if (argBx(code[pc]) >= p.switchTableCount) return false;
+                        uint64_t last = static_cast<uint64_t>(pc) + tableCases[argBx(code[pc])] + 1;
+                        if (last >= p.size) return false;
+                        for (uint64_t j = pc + 1; j <= last; ++j) {
+                            if (opOf(code[j]) != OpCode::JMP) return false;
+                        }
+                    } else if (isFused(op) && pc + 1 >= p.size) {
+                        return false;
+                    }
+                    if (!operandsValid(p, code, pc, h.globalCount)) return false;
+                    if (!hasInlineCache(op)) continue;
+                    if (pc + 1 >= p.size || opOf(code[pc + 1]) != OpCode::EXTRAARG ||
+                        argAx(code[pc + 1]) >= p.inlineCaches) {
+                        return false;
+                    }
+                    ++pc;
+                }
+            }
+            for (uint32_t i = 0; i < h.objectCount; ++i) {
+                const CachedObject& o = image.objects[i];
+                switch (static_cast<ObjType>(o.type)) {
+                    case ObjType::STRING:
+                    case ObjType::MODULE:
+                        if (o.name >= h.stringCount) return false;
+                        break;
+                    case ObjType::FUNCTION:
+                        if (o.proto >= h.protoCount) return false;
+                        break;
+                    case ObjType::CLASS: {
+                        if (o.name >= h.stringCount) return false;
+                        if (o.base != kNone && (o.base >= h.objectCount || image.objects[o.base].type != o.type)) return false;
+                        if (o.constructor != kNone &&
+                            (o.constructor >= h.objectCount ||
+                             image.objects[o.constructor].type != static_cast<uint32_t>(ObjType::FUNCTION))) {
+                            return false;
+                        }
+                        if (!image.wordRange(o.fields, o.fieldCount) ||
+                            !image.wordRange(o.methods, static_cast<uint64_t>(o.methodCount) * 2)) {
+                            return false;
+                        }
+                        for (uint32_t f = 0; f < o.fieldCount; ++f) {
+                            if (image.words[o.fields + f] >= h.stringCount) return false;
+                        }
+                        for (uint32_t m = 0; m < o.methodCount; ++m) {
+                            uint32_t method = image.words[o.methods + 2 * m + 1];
+                            if (image.words[o.methods + 2 * m] >= h.stringCount || method >= h.objectCount ||
+                                image.objects[method].type != static_cast<uint32_t>(ObjType::FUNCTION)) {
+                                return false;
+                            }
+                        }
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // Las globales del archivo deben coincidir ranura a ranura con las que ya tiene el VM
+        bool globalsMatch(const CacheImage& image, const VM& vm) {
+            const CacheHeader& h = *image.header;
+            if (h.globalCount < vm.globalCount()) return false;
+            std::unordered_set<std::string> added;
+            for (uint32_t slot = 0; slot < h.globalCount; ++slot) {
+                std::string name = image.string(image.words[h.globals + slot]);
+                if (slot < vm.globalCount()) {
+                    if (vm.globalName(slot) != name) return false;
+                } else if (vm.findGlobal(name) >= 0 || !added.insert(name).second) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    } // namespace
+
+    uint64_t hashSource(const std::string& source) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (unsigned char c : source) {
+            hash ^= c;
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    std::string cachePathFor(const std::string& sourcePath) {
+        std::filesystem::path source(sourcePath);
+        const char* dir = std::getenv("MCPP_CACHE_DIR");
+        if (dir != nullptr && *dir != '\0') {
+            // El hash de la ruta absoluta evita colisiones entre fuentes con el mismo nombre
+            std::error_code error;
+            std::filesystem::path absolute = std::filesystem::absolute(source, error);
+            char suffix[24];
+            std::snprintf(suffix, sizeof(suffix), "-%016llx",
+                          static_cast<unsigned long long>(hashSource(error ? sourcePath : absolute.string())));
+            return (std::filesystem::path(dir) / (source.stem().string() + suffix + ".mcc")).string();
+        }
+        return source.replace_extension(".mcc").string();
+    }
+
+    bool writeBytecodeCache(const VM& vm, const FunctionProto* script, uint64_t sourceHash, int optimizationLevel,
+                            const std::string& path) {
+        std::string image;
+        CacheWriter writer(vm);
+        if (!writer.build(script, sourceHash, optimizationLevel, image)) return false;
+
+        std::error_code error;
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, error);
+
+        // Se escribe en un temporal y se renombra: un lector concurrente ve el archivo completo o ninguno
+        std::string temporary = path + ".tmp" + std::to_string(::getpid());
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            if (!out) return false;
+            out.write(image.data(), static_cast<std::streamsize>(image.size()));
+            if (!out) {
+                out.close();
+                std::remove(temporary.c_str());
+                return false;
+            }
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    FunctionProto* loadBytecodeCache(VM& vm, uint64_t sourceHash, int optimizationLevel, const std::string& path) {
+        std::shared_ptr<MappedFile> file = MappedFile::open(path);
+        if (file == nullptr || file->size() < sizeof(CacheHeader)) return nullptr;
+
+        CacheImage image{};
+        image.header = reinterpret_cast<const CacheHeader*>(file->data());
+        const CacheHeader& h = *image.header;
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.format != kCacheFormatVersion ||
+            h.sourceHash != sourceHash || h.compilerHash != compilerHash() ||
+            h.optimizationLevel != static_cast<uint32_t>(optimizationLevel)) {
+            return nullptr;
+        }
+
+        uint64_t offset = sizeof(CacheHeader);
+        image.constants = reinterpret_cast<const CachedConstant*>(file->data() + offset);
+        offset += static_cast<uint64_t>(h.constantCount) * sizeof(CachedConstant);
+        image.protos = reinterpret_cast<const CachedProto*>(file->data() + offset);
+        offset += static_cast<uint64_t>(h.protoCount) * sizeof(CachedProto);
+        image.objects = reinterpret_cast<const CachedObject*>(file->data() + offset);
+        offset += static_cast<uint64_t>(h.objectCount) * sizeof(CachedObject);
+        image.strings = reinterpret_cast<const CachedString*>(file->data() + offset);
+        offset += static_cast<uint64_t>(h.stringCount) * sizeof(CachedString);
+        image.words = reinterpret_cast<const uint32_t*>(file->data() + offset);
+        offset += static_cast<uint64_t>(h.wordCount) * sizeof(uint32_t);
+        image.chars = file->data() + offset;
+        offset += h.charCount;
+        if (offset != file->size() ||
+            hashPayload(file->data() + sizeof(CacheHeader), file->size() - sizeof(CacheHeader)) != h.payloadHash ||
+            !validate(image) || !globalsMatch(image, vm)) {
+            return nullptr;
+        }
+
+        // A partir de aquí la carga no puede fallar, así que ya es seguro modificar el VM
+        for (uint32_t slot = static_cast<uint32_t>(vm.globalCount()); slot < h.globalCount; ++slot) {
+            vm.globalSlot(image.string(image.words[h.globals + slot]));
+        }
+
+        std::vector<FunctionProto*> protos(h.protoCount);
+        for (uint32_t i = 0; i < h.protoCount; ++i) {
+            const CachedProto& cached = image.protos[i];
+            FunctionProto* proto = vm.newProto(image.string(cached.name));
+            proto->numParams = static_cast<uint8_t>(cached.numParams);
+            proto->numRegs = static_cast<uint8_t>(cached.numRegs);
+            proto->isMethod = cached.isMethod != 0;
+            proto->inlineCaches.resize(cached.inlineCaches);
+            proto->mappedCode = image.words + cached.code;
+            proto->mappedLines = image.words + cached.lines;
+            proto->mappedSize = cached.size;
+            proto->storage = file;
+            protos[i] = proto;
+        }
+
+        // Primero se crean todos los objetos y después se enlazan (clase base, métodos)
+        std::vector<Obj*> objects(h.objectCount);
+        for (uint32_t i = 0; i < h.objectCount; ++i) {
+            const CachedObject& cached = image.objects[i];
+            switch (static_cast<ObjType>(cached.type)) {
+                case ObjType::STRING:
+                    objects[i] = vm.heap().intern(image.string(cached.name));
+                    break;
+                case ObjType::FUNCTION:
+                    objects[i] = vm.heap().allocate<ObjFunction>(protos[cached.proto]);
+                    break;
+                case ObjType::CLASS:
+                    objects[i] = vm.heap().allocate<ObjClass>(image.string(cached.name));
+                    break;
+                default: {
+                    std::string name = image.string(cached.name);
+                    ObjModule* module = vm.findModule(name);
+                    objects[i] = module != nullptr ? module : vm.defineModule(name);
+                    break;
+                }
+            }
+        }
+        for (uint32_t i = 0; i < h.objectCount; ++i) {
+            const CachedObject& cached = image.objects[i];
+            if (static_cast<ObjType>(cached.type) != ObjType::CLASS) continue;
+            ObjClass* klass = static_cast<ObjClass*>(objects[i]);
+            if (cached.base != kNone) klass->base = static_cast<ObjClass*>(objects[cached.base]);
+            if (cached.constructor != kNone) klass->constructor = Value::object(objects[cached.constructor]);
+            for (uint32_t f = 0; f < cached.fieldCount; ++f) {
+                klass->fieldIndex.emplace(image.string(image.words[cached.fields + f]), f);
+                klass->fields.push_back(image.string(image.words[cached.fields + f]));
+            }
+            for (uint32_t m = 0; m < cached.methodCount; ++m) {
+                const uint32_t* method = image.words + cached.methods + 2 * m;
+                klass->methods.emplace(image.string(method[0]), Value::object(objects[method[1]]));
+            }
+        }
+
+        for (uint32_t i = 0; i < h.protoCount; ++i) {
+            const CachedProto& cached = image.protos[i];
+            std::vector<Value>& constants = protos[i]->constants;
+            constants.reserve(cached.constantCount);
+            for (uint32_t k = 0; k < cached.constantCount; ++k) {
+                const CachedConstant& constant = image.constants[cached.constants + k];
+                constants.push_back(constant.object == kNone ? Value::fromBits(constant.bits)
+                                                             : Value::object(objects[constant.object]));
+            }
+            const uint32_t* word = image.words + cached.switchTables;
+            for (uint32_t t = 0; t < cached.switchTableCount; ++t) {
+                SwitchTable table;
+                table.keys.assign(word + 1, word + 1 + word[0]);
+                table.build(constants);
+                protos[i]->switchTables.push_back(std::move(table));
+                word += 1 + word[0];
+            }
+        }
+        return protos[h.scriptProto];
+    }
+
+} // namespace mc_core
@@ -0,0 +1,60 @@
+#ifndef BYTECODE_CACHE_H
+#define BYTECODE_CACHE_H
+
+#include "bytecode.h"
+#include "vm.h"
+#include <cstdint>
+#include <string>
+
+namespace mc_core {
+
+    /**
+     * Caché de bytecode precompilado (.mcc).
+     *
+     * El archivo guarda todos los prototipos de un programa junto con la tabla de
+     * globales y los objetos constantes (cadenas, funciones, clases y módulos). Se
+     * identifica por el hash del código fuente, el de la versión del compilador
+     * (version.h + kCacheFormatVersion) y el nivel de -O, de modo que cualquier cambio
+     * invalida la caché: un bytecode de -O2 nunca se ejecuta donde se pidió -O0.
+     * Un hash de todo el contenido tras la cabecera descarta además los archivos dañados,
+     * y como quien edita el archivo puede recalcularlo, también se comprueban las
+     * referencias entre secciones y los operandos de cada instrucción (registros,
+     * constantes, globales y saltos). Si algo falla, el intérprete vuelve a compilar el fuente.
+     *
+     * Al cargarla, el archivo se mapea en memoria de solo lectura: el código y las
+     * tablas de líneas de cada prototipo se usan directamente desde el mapeo. Sólo
+     * las constantes que apuntan al heap y las tablas de los SWITCH se reconstruyen.
+     */
+
+    // Incrementar al cambiar el juego de instrucciones o el formato del archivo
+    constexpr uint32_t kCacheFormatVersion = 8;
+
+    // Hash FNV-1a de 64 bits del código fuente
+    uint64_t hashSource(const std::string& source);
+
+    /**
+     * Ruta del archivo de caché de un fuente: en el directorio MCPP_CACHE_DIR si la
+     * variable de entorno está definida, o junto al fuente con extensión .mcc.
+     */
+    std::string cachePathFor(const std::string& sourcePath);
+
+    /**
+     * Escribe la caché del programa compilado en `vm` cuyo nivel superior es `script`,
+     * optimizado con optimizationLevel. La escritura es atómica (archivo temporal + rename).
+     * @return false si el programa no puede guardarse o el archivo no puede escribirse.
+     */
+    bool writeBytecodeCache(const VM& vm, const FunctionProto* script, uint64_t sourceHash,
+                            int optimizationLevel, const std::string& path);
+
+    /**
+     * Carga un programa desde la caché en un VM con las funciones integradas ya
+     * registradas.
+     * @return El prototipo de nivel superior, o nullptr si la caché no existe, no
+     *         corresponde al fuente, a esta versión o a optimizationLevel, o está
+     *         dañada. En ese caso el VM no se modifica.
+     */
+    FunctionProto* loadBytecodeCache(VM& vm, uint64_t sourceHash, int optimizationLevel, const std::string& path);
+
+} // namespace mc_core
+
+#endif // BYTECODE_CACHE_H
@@ -0,0 +1,1661 @@
+#include "codegen.h"
+#include <algorithm>
+#include <cstring>
+
+namespace mc_core {
+
+    namespace {
+
+        constexpr std::string_view kSelfName = "este";
+
+        // Con menos CASO la cadena de comparaciones es igual de rápida que la tabla de saltos
+        constexpr uint32_t kMinSwitchTableCases = 4;
+
+        OpCode arithOp(OpKind op) {
+            switch (op) {
+                case OpKind::ADD: return OpCode::ADD;
+                case OpKind::SUB: return OpCode::SUB;
+                case OpKind::MUL: return OpCode::MUL;
+                case OpKind::DIV: return OpCode::DIV;
+                case OpKind::MOD: return OpCode::MOD;
+                default: return OpCode::NOP;
+            }
+        }
+
+        // Instrucciones que solo escriben R[A] después de leer sus operandos
+        bool isRetargetable(OpCode op) {
+            switch (op) {
+                case OpCode::MOVE:
+                case OpCode::LOADK:
+                case OpCode::LOADI:
+                case OpCode::LOADBOOL:
+                case OpCode::LOADNIL:
+                case OpCode::GETGLOBAL:
+                case OpCode::ADD:
+                case OpCode::SUB:
+                case OpCode::MUL:
+                case OpCode::DIV:
+                case OpCode::MOD:
+                case OpCode::NEG:
+                case OpCode::NOT:
+                case OpCode::EQ:
+                case OpCode::NE:
+                case OpCode::LT:
+                case OpCode::LE:
+                case OpCode::NEWARRAY:
+                case OpCode::NEWMAP:
+                case OpCode::GETINDEX:
+                case OpCode::GETFIELD:
+                case OpCode::GETTYPED:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+    } // namespace
+
+    CodeGenerator::CodeGenerator(VM& vm, const AstArena& arena) : vm_(vm), arena_(arena), symbols_(ownSymbols_) {}
+
+    CodeGenerator::CodeGenerator(VM& vm, const AstArena& arena, Symbols& symbols)
+        : vm_(vm), arena_(arena), symbols_(symbols) {}
+
+    FunctionProto* compileProgram(VM& vm, const AstArena& arena, NodeId program) {
+        CodeGenerator generator(vm, arena);
+        return generator.compileProgram(program);
+    }
+
+    FunctionProto* compileModule(VM& vm, const AstArena& arena, NodeId program, const std::string& moduleName) {
+        CodeGenerator generator(vm, arena);
+        return generator.compileModule(program, moduleName);
+    }
+
+    FunctionProto* CompilerSession::compile(const AstArena& arena, NodeId program) {
+        CodeGenerator generator(vm_, arena, symbols_);
+        uint32_t count = arena.childCount(program);
+        if (count > 0) {
+            NodeId last = arena.children(program)[count - 1];
+            const AstNode& n = arena.node(last);
+            if (n.kind == NodeKind::EXPR_STMT && arena.kind(n.a) != NodeKind::ASSIGN) generator.resultStatement_ = last;
+        }
+        // Si no compila se deshace lo que haya declarado: sus nombres, sus clases, sus
+        // asignaciones contadas y las globales que registró en el VM
+        CodeGenerator::Symbols::Added added;
+        size_t classCount = symbols_.classInfos.size();
+        size_t globalCount = vm_.globalCount();
+        symbols_.added = &added;
+        try {
+            FunctionProto* script = generator.compileProgram(program);
+            symbols_.added = nullptr;
+            return script;
+        } catch (...) {
+            symbols_.added = nullptr;
+            for (const std::string& module : added.modules) symbols_.modules.erase(module);
+            for (const std::string& name : added.constGlobals) symbols_.constGlobals.erase(name);
+            for (auto it = added.typedGlobals.rbegin(); it != added.typedGlobals.rend(); ++it) {
+                if (it->second < 0) {
+                    symbols_.typedGlobals.erase(it->first);
+                } else {
+                    symbols_.typedGlobals[it->first] = it->second;
+                }
+            }
+            for (size_t i = classCount; i < symbols_.classInfos.size(); ++i) {
+                const CodeGenerator::ClassInfo& info = symbols_.classInfos[i];
+                symbols_.classByName.erase(info.prefix + generator.name(info.node));
+                if (info.klass != nullptr) symbols_.classByObject.erase(info.klass);
+            }
+            symbols_.classInfos.resize(classCount);
+            generator.countBindings(-1);
+            vm_.truncateGlobals(globalCount);
+            throw;
+        }
+    }
+
+    // -------------------------------------
+    // Declaraciones de nivel superior
+    // -------------------------------------
+
+    FunctionProto* CodeGenerator::compileProgram(NodeId program) {
+        return compileUnit(program, "", "<script>");
+    }
+
+    FunctionProto* CodeGenerator::compileModule(NodeId program, const std::string& moduleName) {
+        addModule(moduleName);
+        return compileUnit(program, moduleName + ".", "<módulo " + moduleName + ">");
+    }
+
+    FunctionProto* CodeGenerator::compileUnit(NodeId program, const std::string& prefix, const std::string& unitName) {
+        // Los módulos de fuente ya cargados en el VM se usan como un MODULO del programa
+        for (const SourceModule& module : vm_.sourceModules()) {
+            addModule(module.name);
+        }
+        countBindings(1);
+        declareGlobals(program, prefix);
+        for (ClassInfo& info : symbols_.classInfos) {
+            layoutClass(info);
+        }
+
+        FuncState script;
+        script.proto = vm_.newProto(unitName);
+        script.isScript = true;
+        fs_ = &script;
+
+        // El programa inicializa antes sus módulos importados, en orden de dependencias
+        if (prefix.empty()) {
+            for (FunctionProto* init : vm_.takeModuleInits()) {
+                int reg = allocReg();
+                emit(encodeABx(OpCode::LOADK, reg, constant(Value::object(vm_.heap().allocate<ObjFunction>(init)))));
+                emit(encodeABC(OpCode::CALL, reg, 0, 0));
+                freeTo(reg);
+            }
+        }
+
+        // Clases y funciones quedan definidas antes de ejecutar la primera sentencia
+        for (ClassInfo& info : symbols_.classInfos) {
+            compileClass(info);
+        }
+        defineFunctions(program, prefix);
+        compileTopLevel(program, prefix);
+        emit(encodeABC(OpCode::RETURN, 0, 0, 0));
+
+        fs_ = nullptr;
+        return script.proto;
+    }
+
+    void CodeGenerator::declareGlobals(NodeId owner, const std::string& prefix) {
+        const NodeId* items = arena_.children(owner);
+        uint32_t count = arena_.childCount(owner);
+        std::vector<NodeId> imports;
+        for (uint32_t i = 0; i < count; ++i) {
+            const AstNode& n = arena_.node(items[i]);
+            line_ = n.line;
+            bool named = n.kind == NodeKind::FUNC_DECL || n.kind == NodeKind::VAR_DECL ||
+                         n.kind == NodeKind::STRUCT_DECL || n.kind == NodeKind::CLASS_DECL ||
+                         n.kind == NodeKind::MODULE_DECL;
+            std::string qualified = named ? prefix + name(items[i]) : std::string();
+            switch (n.kind) {
+                case NodeKind::FUNC_DECL:
+                    if (symbols_.constGlobals.count(qualified)) error("'" + qualified + "' ya está declarado");
+                    vm_.globalSlot(qualified);
+                    addConstGlobal(qualified);
+                    break;
+                case NodeKind::VAR_DECL:
+                    vm_.globalSlot(qualified);
+                    if (n.flags & FLAG_CONST) addConstGlobal(qualified);
+                    if (n.d != kNoNode && typedElement(n.a) >= 0) setTypedGlobal(qualified, typedElement(n.a));
+                    break;
+                case NodeKind::STRUCT_DECL:
+                case NodeKind::CLASS_DECL: {
+                    if (symbols_.classByName.count(qualified)) error("la clase '" + qualified + "' ya está declarada");
+                    vm_.globalSlot(qualified);
+                    addConstGlobal(qualified);
+                    ClassInfo info;
+                    info.node = items[i];
+                    info.prefix = prefix;
+                    symbols_.classByName.emplace(qualified, symbols_.classInfos.size());
+                    symbols_.classInfos.push_back(std::move(info));
+                    break;
+                }
+                case NodeKind::MODULE_DECL:
+                    addModule(qualified);
+                    declareGlobals(items[i], qualified + ".");
+                    break;
+                case NodeKind::IMPORT:
+                    imports.push_back(items[i]);
+                    break;
+                default:
+                    break;
+            }
+        }
+        // Un IMPORTAR de un MODULO del propio programa no crea ninguna global
+        for (NodeId import : imports) {
+            std::string module = name(import);
+            if (!symbols_.modules.count(module)) vm_.globalSlot(module);
+        }
+    }
+
+    CodeGenerator::ClassInfo* CodeGenerator::findClass(const std::string& className, const std::string& prefix) {
+        auto it = symbols_.classByName.find(prefix + className);
+        if (it == symbols_.classByName.end()) it = symbols_.classByName.find(className);
+        return it == symbols_.classByName.end() ? nullptr : &symbols_.classInfos[it->second];
+    }
+
+    CodeGenerator::ClassInfo& CodeGenerator::classInfo(const ObjClass* klass) {
+        return symbols_.classInfos[symbols_.classByObject.at(klass)];
+    }
+
+    void CodeGenerator::layoutClass(ClassInfo& info) {
+        if (info.laidOut) return;
+        const AstNode& n = arena_.node(info.node);
+        line_ = n.line;
+        if (info.klass != nullptr) error("herencia circular en la clase '" + name(info.node) + "'");
+
+        ObjClass* klass = vm_.heap().allocate<ObjClass>(name(info.node));
+        info.klass = klass;
+        symbols_.classByObject.emplace(klass, static_cast<size_t>(&info - symbols_.classInfos.data()));
+
+        if (n.kind == NodeKind::CLASS_DECL && n.a != kNoNode) {
+            std::string baseName = name(n.a);
+            ClassInfo* base = findClass(baseName, info.prefix);
+            if (base == nullptr) error("clase base desconocida: " + baseName);
+            layoutClass(*base);
+            line_ = n.line;
+            klass->base = base->klass;
+            klass->fields = base->klass->fields;
+            klass->fieldIndex = base->klass->fieldIndex;
+            info.methodNames = base->methodNames;
+        }
+
+        const NodeId* members = arena_.children(info.node);
+        for (uint32_t i = 0; i < arena_.childCount(info.node); ++i) {
+            const AstNode& member = arena_.node(members[i]);
+            if (member.kind != NodeKind::FIELD && member.kind != NodeKind::FUNC_DECL) continue;
+            std::string memberName = name(members[i]);
+            if (member.kind == NodeKind::FIELD) {
+                if (klass->fieldIndex.count(memberName)) {
+                    line_ = member.line;
+                    error("el campo '" + memberName + "' ya existe en " + klass->name);
+                }
+                klass->fieldIndex.emplace(memberName, static_cast<uint32_t>(klass->fields.size()));
+                klass->fields.push_back(memberName);
+            } else if (member.kind == NodeKind::FUNC_DECL) {
+                info.methodNames.insert(memberName);
+            }
+        }
+        info.laidOut = true;
+    }
+
+    void CodeGenerator::compileClass(ClassInfo& info) {
+        if (info.compiled) return;
+        ObjClass* klass = info.klass;
+        if (klass->base != nullptr) compileClass(classInfo(klass->base));
+
+        std::unordered_set<std::string> own;
+        const NodeId* members = arena_.children(info.node);
+        for (uint32_t i = 0; i < arena_.childCount(info.node); ++i) {
+            if (arena_.kind(members[i]) != NodeKind::FUNC_DECL) continue;
+            std::string methodName = name(members[i]);
+            line_ = arena_.node(members[i]).line;
+            if (!own.insert(methodName).second) {
+                error("el método '" + methodName + "' ya existe en " + klass->name);
+            }
+            FunctionProto* proto = compileFunction(members[i], klass->name + "." + methodName, klass, info.prefix);
+            klass->methods[methodName] = Value::object(vm_.heap().allocate<ObjFunction>(proto));
+        }
+        klass->constructor = Value::object(vm_.heap().allocate<ObjFunction>(compileConstructor(info)));
+        if (klass->base != nullptr) {
+            for (const auto& method : klass->base->methods) {
+                klass->methods.emplace(method.first, method.second);
+            }
+        }
+        info.compiled = true;
+
+        line_ = arena_.node(info.node).line;
+        defineGlobal(static_cast<uint32_t>(vm_.findGlobal(info.prefix + klass->name)), Value::object(klass));
+    }
+
+    void CodeGenerator::defineFunctions(NodeId owner, const std::string& prefix) {
+        const NodeId* items = arena_.children(owner);
+        for (uint32_t i = 0; i < arena_.childCount(owner); ++i) {
+            NodeKind kind = arena_.kind(items[i]);
+            if (kind == NodeKind::FUNC_DECL) {
+                std::string qualified = prefix + name(items[i]);
+                FunctionProto* proto = compileFunction(items[i], qualified, nullptr, prefix);
+                line_ = arena_.node(items[i]).line;
+                defineGlobal(static_cast<uint32_t>(vm_.findGlobal(qualified)),
+                             Value::object(vm_.heap().allocate<ObjFunction>(proto)));
+            } else if (kind == NodeKind::MODULE_DECL) {
+                defineFunctions(items[i], prefix + name(items[i]) + ".");
+            }
+        }
+    }
+
+    void CodeGenerator::compileTopLevel(NodeId owner, const std::string& prefix) {
+        std::string saved = fs_->prefix;
+        fs_->prefix = prefix;
+        const NodeId* items = arena_.children(owner);
+        for (uint32_t i = 0; i < arena_.childCount(owner); ++i) {
+            switch (arena_.kind(items[i])) {
+                case NodeKind::FUNC_DECL:
+                case NodeKind::STRUCT_DECL:
+                case NodeKind::CLASS_DECL:
+                    break;
+                case NodeKind::MODULE_DECL:
+                    compileTopLevel(items[i], prefix + name(items[i]) + ".");
+                    break;
+                default:
+                    statement(items[i]);
+                    break;
+            }
+        }
+        fs_->prefix = saved;
+    }
+
+    FunctionProto* CodeGenerator::compileFunction(NodeId node, const std::string& qualifiedName, ObjClass* klass,
+                                                  const std::string& prefix) {
+        FuncState state;
+        state.proto = vm_.newProto(qualifiedName);
+        state.klass = klass;
+        state.prefix = prefix;
+        FuncState* enclosing = fs_;
+        fs_ = &state;
+
+        const AstNode& n = arena_.node(node);
+        line_ = n.line;
+        if (klass != nullptr) {
+            state.proto->isMethod = true;
+            declareLocal(kSelfName, allocReg(), true);
+        }
+        const NodeId* params = arena_.children(node);
+        uint32_t count = arena_.childCount(node);
+        for (uint32_t i = 0; i < count; ++i) {
+            declareLocal(arena_.str(arena_.node(params[i]).v.str), allocReg(), false);
+        }
+        state.proto->numParams = static_cast<uint8_t>(count);
+        block(n.d);
+        emit(encodeABC(OpCode::RETURN, 0, 0, 0));
+
+        fs_ = enclosing;
+        return state.proto;
+    }
+
+    FunctionProto* CodeGenerator::compileConstructor(ClassInfo& info) {
+        ObjClass* klass = info.klass;
+        const AstNode& classNode = arena_.node(info.node);
+        const NodeId* members = arena_.children(info.node);
+        uint32_t memberCount = arena_.childCount(info.node);
+        NodeId ctor = kNoNode;
+        for (uint32_t i = 0; i < memberCount; ++i) {
+            if (arena_.kind(members[i]) == NodeKind::CTOR_DECL) {
+                line_ = arena_.node(members[i]).line;
+                if (ctor != kNoNode) error("la clase " + klass->name + " tiene más de un CONSTRUCTOR");
+                ctor = members[i];
+            }
+        }
+
+        FuncState state;
+        state.proto = vm_.newProto(klass->name);
+        state.proto->isMethod = true;
+        state.klass = klass;
+        state.isConstructor = true;
+        state.prefix = info.prefix;
+        FuncState* enclosing = fs_;
+        fs_ = &state;
+        line_ = ctor != kNoNode ? arena_.node(ctor).line : classNode.line;
+
+        declareLocal(kSelfName, allocReg(), true);
+        bool positional = ctor == kNoNode && classNode.kind == NodeKind::STRUCT_DECL;
+        if (ctor != kNoNode) {
+            const NodeId* params = arena_.children(ctor);
+            for (uint32_t i = 0; i < arena_.childCount(ctor); ++i) {
+                declareLocal(arena_.str(arena_.node(params[i]).v.str), allocReg(), false);
+            }
+            state.proto->numParams = static_cast<uint8_t>(arena_.childCount(ctor));
+        } else if (positional) {
+            // STRUCT sin constructor: un parámetro por campo, en orden de declaración
+            for (const std::string& field : klass->fields) {
+                declareLocal(field, allocReg(), false);
+            }
+            state.proto->numParams = static_cast<uint8_t>(klass->fields.size());
+        }
+
+        // Constructor base: explícito (": Base(args)") o implícito si no recibe argumentos
+        NodeId superCall = ctor != kNoNode ? arena_.node(ctor).a : kNoNode;
+        if (superCall != kNoNode && klass->base == nullptr) {
+            error("la clase " + klass->name + " no tiene clase base");
+        }
+        if (klass->base != nullptr) {
+            const FunctionProto* baseCtor = asFunction(klass->base->constructor)->proto;
+            uint32_t argc = superCall != kNoNode ? arena_.childCount(superCall) : 0;
+            if (superCall == kNoNode && baseCtor->numParams != 0) {
+                error("la clase " + klass->name + " debe invocar al constructor de " + klass->base->name);
+            }
+            int base = allocReg();
+            emit(encodeABx(OpCode::LOADK, base, constant(klass->base->constructor)));
+            emit(encodeABC(OpCode::MOVE, allocReg(), 0, 0));
+            const NodeId* args = argc > 0 ? arena_.children(superCall) : nullptr;
+            for (uint32_t i = 0; i < argc; ++i) {
+                expr(args[i], allocReg());
+            }
+            emit(encodeABC(OpCode::CALL, base, argc + 1, 1));
+            freeTo(localTop());
+        }
+
+        // Inicializadores de campo declarados en la clase
+        for (uint32_t i = 0; i < memberCount; ++i) {
+            const AstNode& member = arena_.node(members[i]);
+            if (member.kind != NodeKind::FIELD || member.d == kNoNode) continue;
+            line_ = member.line;
+            int value = exprAnyReg(member.d);
+            emit(encodeABC(OpCode::SETFIELD, 0, fieldConstant(arena_.str(member.v.str)), value));
+            freeTo(localTop());
+        }
+        if (positional) {
+            for (size_t i = 0; i < klass->fields.size(); ++i) {
+                emit(encodeABC(OpCode::SETFIELD, 0, fieldConstant(klass->fields[i]), static_cast<uint32_t>(i + 1)));
+            }
+        }
+
+        if (ctor != kNoNode) block(arena_.node(ctor).d);
+        emit(encodeABC(OpCode::RETURN, 0, 1, 0));
+
+        fs_ = enclosing;
+        return state.proto;
+    }
+
+    // -------------------------------------
+    // Sentencias
+    // -------------------------------------
+
+    void CodeGenerator::statement(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        line_ = n.line;
+        switch (n.kind) {
+            case NodeKind::VAR_DECL: varDecl(node); break;
+            case NodeKind::IF: ifStatement(node); break;
+            case NodeKind::WHILE: whileStatement(node); break;
+            case NodeKind::FOR_RANGE: forRange(node); break;
+            case NodeKind::FOR_EACH: forEach(node); break;
+            case NodeKind::PARALLEL_FOR: parallelFor(node); break;
+            case NodeKind::SWITCH: switchStatement(node); break;
+            case NodeKind::RETURN: returnStatement(node); break;
+            case NodeKind::BREAK: jumpOutOfLoop(node, true); break;
+            case NodeKind::CONTINUE: jumpOutOfLoop(node, false); break;
+            case NodeKind::BLOCK: block(node); break;
+            case NodeKind::IMPORT: importStatement(node); break;
+            case NodeKind::EXPR_STMT: {
+                const AstNode& e = arena_.node(n.a);
+                if (node == resultStatement_) {
+                    emit(encodeABC(OpCode::RETURN, exprAnyReg(n.a), 1, 0));
+                } else if (e.kind == NodeKind::ASSIGN) {
+                    assign(n.a);
+                } else if (e.kind == NodeKind::CALL) {
+                    call(n.a, allocReg());
+                } else {
+                    expr(n.a, allocReg());
+                }
+                break;
+            }
+            case NodeKind::FUNC_DECL:
+            case NodeKind::STRUCT_DECL:
+            case NodeKind::CLASS_DECL:
+            case NodeKind::MODULE_DECL:
+                error("las declaraciones de FUNC, CLASE, STRUCT y MODULO solo se admiten en el nivel superior");
+            default:
+                error("sentencia no válida");
+        }
+        freeTo(localTop());
+    }
+
+    void CodeGenerator::block(NodeId node) {
+        beginScope();
+        const NodeId* items = arena_.children(node);
+        for (uint32_t i = 0; i < arena_.childCount(node); ++i) {
+            statement(items[i]);
+        }
+        endScope();
+    }
+
+    void CodeGenerator::varDecl(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        bool isConst = (n.flags & FLAG_CONST) != 0;
+        // ARRAY<INT> / ARRAY<FLOAT> con inicializador: el valor se convierte al declararla
+        int element = n.d != kNoNode ? typedElement(n.a) : -1;
+        if (fs_->isScript && fs_->scopes.empty()) {
+            // Variable global (declarada de antemano por declareGlobals)
+            int value = allocReg();
+            if (n.d != kNoNode) {
+                expr(n.d, value);
+            } else {
+                emit(encodeABC(OpCode::LOADNIL, value, 0, 0));
+            }
+            line_ = n.line;
+            if (element >= 0) emit(encodeABC(OpCode::TOTYPED, value, element, 0));
+            emit(encodeABx(OpCode::SETGLOBAL, value, static_cast<uint32_t>(vm_.findGlobal(fs_->prefix + name(node)))));
+            return;
+        }
+        int reg = allocReg();
+        if (n.d != kNoNode) {
+            expr(n.d, reg);
+        } else {
+            emit(encodeABC(OpCode::LOADNIL, reg, 0, 0));
+        }
+        line_ = n.line;
+        if (element >= 0) emit(encodeABC(OpCode::TOTYPED, reg, element, 0));
+        declareLocal(arena_.str(n.v.str), reg, isConst, element);
+    }
+
+    void CodeGenerator::ifStatement(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        int cond = exprAnyReg(n.a);
+        size_t skipThen = emitJump(OpCode::JMPIFNOT, cond);
+        freeTo(localTop());
+        block(n.b);
+        if (n.d == kNoNode) {
+            patchJump(skipThen);
+            return;
+        }
+        size_t skipElse = emitJump(OpCode::JMP, 0);
+        patchJump(skipThen);
+        if (arena_.kind(n.d) == NodeKind::IF) {
+            statement(n.d);
+        } else {
+            block(n.d);
+        }
+        patchJump(skipElse);
+    }
+
+    void CodeGenerator::whileStatement(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        size_t start = label();
+        int cond = exprAnyReg(n.a);
+        size_t exit = emitJump(OpCode::JMPIFNOT, cond);
+        freeTo(localTop());
+
+        fs_->loops.emplace_back();
+        block(n.d);
+        Loop loop = std::move(fs_->loops.back());
+        fs_->loops.pop_back();
+
+        for (size_t jump : loop.continues) patchJumpTo(jump, start);
+        emitJumpBack(OpCode::JMP, 0, start);
+        patchJump(exit);
+        for (size_t jump : loop.breaks) patchJump(jump);
+    }
+
+    void CodeGenerator::forRange(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        beginScope();
+        int base = allocReg();
+        allocReg();
+        allocReg();
+        expr(n.a, base);
+        expr(n.b, base + 1);
+        if (n.c != kNoNode) {
+            expr(n.c, base + 2);
+        } else {
+            emit(encodeAsBx(OpCode::LOADI, base + 2, 1));
+        }
+        line_ = n.line;
+        // La variable de control es el propio contador: no se puede asignar en el cuerpo
+        declareLocal(arena_.str(n.v.str), base, true);
+        declareLocal("", base + 1, true);
+        declareLocal("", base + 2, true);
+        bool typedLoop = beginTypedLoop(node, base);
+
+        size_t prep = emitJump(OpCode::FORPREP, base);
+        size_t body = label();
+        fs_->loops.emplace_back();
+        block(n.d);
+        Loop loop = std::move(fs_->loops.back());
+        fs_->loops.pop_back();
+        if (typedLoop) fs_->typedLoops.pop_back();
+
+        size_t next = label();
+        for (size_t jump : loop.continues) patchJumpTo(jump, next);
+        line_ = n.line;
+        emitJumpBack(OpCode::FORLOOP, base, body);
+        patchJump(prep);
+        for (size_t jump : loop.breaks) patchJump(jump);
+        endScope();
+    }
+
+    void CodeGenerator::forEach(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        beginScope();
+        int base = allocReg();
+        allocReg();
+        allocReg();
+        expr(n.a, base);
+        emit(encodeAsBx(OpCode::LOADI, base + 1, 0));
+        declareLocal("", base, true);
+        declareLocal("", base + 1, true);
+        declareLocal(arena_.str(n.v.str), base + 2, false);
+
+        size_t start = label();
+        line_ = n.line;
+        size_t exit = emitJump(OpCode::FOREACH, base);
+        fs_->loops.emplace_back();
+        block(n.d);
+        Loop loop = std::move(fs_->loops.back());
+        fs_->loops.pop_back();
+
+        for (size_t jump : loop.continues) patchJumpTo(jump, start);
+        emitJumpBack(OpCode::JMP, 0, start);
+        patchJump(exit);
+        for (size_t jump : loop.breaks) patchJump(jump);
+        endScope();
+    }
+
+    /**
+     * PARA PARALELO i DESDE a HASTA b [REDUCIR op x, ...]. El cuerpo se compila como
+     * una función aparte que recorre un trozo del rango, y PARFOR la ejecuta sobre
+     * todos los trozos en los hilos del VM. Las locales visibles se le pasan por valor
+     * y son de sólo lectura, igual que las globales; cada variable de REDUCIR tiene un
+     * acumulador propio por trozo. Al volver, los acumuladores se combinan aquí en el
+     * orden de los trozos, así que el resultado no depende de cuántos hilos hubo.
+     */
+    void CodeGenerator::parallelFor(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        const AstNode& range = arena_.node(n.a);
+        const NodeId* reductions = arena_.children(node);
+        uint32_t count = arena_.childCount(node);
+        std::vector<VarRef> targets;
+        for (uint32_t i = 0; i < count; ++i) {
+            const AstNode& reduction = arena_.node(reductions[i]);
+            std::string_view target = arena_.str(reduction.v.str);
+            line_ = reduction.line;
+            for (uint32_t j = 0; j < i; ++j) {
+                if (arena_.str(arena_.node(reductions[j]).v.str) == target) {
+                    error("'" + std::string(target) + "' aparece más de una vez en REDUCIR");
+                }
+            }
+            VarRef ref = resolve(target, reduction.line);
+            if (ref.kind != RefKind::LOCAL && ref.kind != RefKind::GLOBAL) {
+                error("REDUCIR solo admite variables locales o globales, no '" + std::string(target) + "'");
+            }
+            if (fs_->parallelBody && (ref.kind == RefKind::GLOBAL || static_cast<int>(ref.index) < fs_->captureCount)) {
+                parallelWriteError(target);
+            }
+            if (ref.isConst) error("no se puede modificar '" + std::string(target) + "': es una constante");
+            if (ref.element >= 0) error("REDUCIR no admite el ARRAY tipado '" + std::string(target) + "'");
+            targets.push_back(ref);
+        }
+
+        // Sólo la declaración visible de cada nombre; `este` sigue siendo R[0]
+        std::vector<Local> captures;
+        for (const Local& local : fs_->locals) {
+            if (local.name.empty()) continue;
+            captures.erase(std::remove_if(captures.begin(), captures.end(),
+                                          [&](const Local& c) { return c.name == local.name; }),
+                           captures.end());
+            captures.push_back(local);
+        }
+        FunctionProto* proto = compileParallelBody(node, captures);
+
+        line_ = n.line;
+        int base = allocReg();
+        emit(encodeABx(OpCode::LOADK, base, constant(Value::object(vm_.heap().allocate<ObjFunction>(proto)))));
+        for (const Local& capture : captures) {
+            emit(encodeABC(OpCode::MOVE, allocReg(), capture.reg, 0));
+        }
+        int accumulators = fs_->freeReg;
+        for (const VarRef& ref : targets) {
+            if (ref.kind == RefKind::LOCAL) {
+                emit(encodeABC(OpCode::MOVE, allocReg(), ref.index, 0));
+            } else {
+                emit(encodeABx(OpCode::GETGLOBAL, allocReg(), ref.index));
+            }
+        }
+        expr(range.a, allocReg());
+        expr(range.b, allocReg());
+        if (range.c != kNoNode) {
+            expr(range.c, allocReg());
+        } else {
+            emit(encodeAsBx(OpCode::LOADI, allocReg(), 1));
+        }
+        line_ = n.line;
+        emit(encodeABC(OpCode::PARFOR, base, fs_->freeReg - base - 1, 0));
+        if (count == 0) {
+            freeTo(base);
+            return;
+        }
+
+        // R[base] = [resultado del trozo 0, ...]: con una sola reducción cada resultado es
+        // su acumulador; con varias, un ARRAY con uno por variable
+        int loop = allocReg();
+        allocReg();
+        allocReg();
+        int temp = allocReg();
+        emit(encodeABC(OpCode::MOVE, loop, base, 0));
+        emit(encodeAsBx(OpCode::LOADI, loop + 1, 0));
+        size_t start = label();
+        size_t exit = emitJump(OpCode::FOREACH, loop);
+        for (uint32_t i = 0; i < count; ++i) {
+            int acc = accumulators + static_cast<int>(i);
+            int value = loop + 2;
+            if (count > 1) {
+                emit(encodeAsBx(OpCode::LOADI, temp, static_cast<int32_t>(i)));
+                emit(encodeABC(OpCode::GETINDEX, temp, loop + 2, temp));
+                value = temp;
+            }
+            OpKind op = arena_.node(reductions[i]).op;
+            if (op == OpKind::ADD || op == OpKind::MUL) {
+                emit(encodeABC(op == OpKind::ADD ? OpCode::ADD : OpCode::MUL, acc, acc, value));
+                continue;
+            }
+            // MIN: se queda con el valor si value < acc; MAX: si acc < value
+            int test = allocReg();
+            emit(encodeABC(OpCode::LT, test, op == OpKind::LT ? value : acc, op == OpKind::LT ? acc : value));
+            size_t skip = emitJump(OpCode::JMPIFNOT, test);
+            emit(encodeABC(OpCode::MOVE, acc, value, 0));
+            patchJump(skip);
+            freeTo(test);
+        }
+        emitJumpBack(OpCode::JMP, 0, start);
+        patchJump(exit);
+        for (uint32_t i = 0; i < count; ++i) {
+            int acc = accumulators + static_cast<int>(i);
+            if (targets[i].kind == RefKind::LOCAL) {
+                emit(encodeABC(OpCode::MOVE, targets[i].index, acc, 0));
+            } else {
+                emit(encodeABx(OpCode::SETGLOBAL, acc, targets[i].index));
+            }
+        }
+        freeTo(base);
+    }
+
+    FunctionProto* CodeGenerator::compileParallelBody(NodeId node, const std::vector<Local>& captures) {
+        const AstNode& n = arena_.node(node);
+        const AstNode& range = arena_.node(n.a);
+        const NodeId* reductions = arena_.children(node);
+        uint32_t count = arena_.childCount(node);
+
+        // Parámetros: locales capturadas, valores iniciales de REDUCIR y el trozo (desde, hasta, paso)
+        FuncState state;
+        state.proto = vm_.newProto(fs_->proto->name);
+        state.klass = fs_->klass;
+        state.prefix = fs_->prefix;
+        state.parallelBody = true;
+        state.captureCount = static_cast<int>(captures.size());
+        FuncState* enclosing = fs_;
+        fs_ = &state;
+        line_ = n.line;
+        for (const Local& capture : captures) {
+            declareLocal(capture.name, allocReg(), true, capture.element);
+        }
+        int initial = fs_->freeReg;
+        for (uint32_t i = 0; i < count; ++i) {
+            declareLocal("", allocReg(), true);
+        }
+        int base = allocReg();
+        allocReg();
+        allocReg();
+        state.proto->numParams = static_cast<uint8_t>(fs_->freeReg);
+
+        beginScope();
+        declareLocal(arena_.str(range.v.str), base, true);
+        declareLocal("", base + 1, true);
+        declareLocal("", base + 2, true);
+        // SUMA y PRODUCTO parten del neutro; MIN y MAX, del valor que ya tenía la variable
+        int accumulators = fs_->freeReg;
+        for (uint32_t i = 0; i < count; ++i) {
+            const AstNode& reduction = arena_.node(reductions[i]);
+            line_ = reduction.line;
+            int acc = allocReg();
+            if (reduction.op == OpKind::ADD || reduction.op == OpKind::MUL) {
+                emit(encodeAsBx(OpCode::LOADI, acc, reduction.op == OpKind::ADD ? 0 : 1));
+            } else {
+                emit(encodeABC(OpCode::MOVE, acc, initial + static_cast<int>(i), 0));
+            }
+            declareLocal(arena_.str(reduction.v.str), acc, false);
+        }
+        line_ = range.line;
+        bool typedLoop = beginTypedLoop(n.a, base);
+
+        size_t prep = emitJump(OpCode::FORPREP, base);
+        size_t body = label();
+        fs_->loops.emplace_back();
+        fs_->loops.back().parallel = true;
+        block(range.d);
+        Loop loop = std::move(fs_->loops.back());
+        fs_->loops.pop_back();
+        if (typedLoop) fs_->typedLoops.pop_back();
+
+        size_t next = label();
+        for (size_t jump : loop.continues) patchJumpTo(jump, next);
+        line_ = range.line;
+        emitJumpBack(OpCode::FORLOOP, base, body);
+        patchJump(prep);
+        if (count == 0) {
+            emit(encodeABC(OpCode::RETURN, 0, 0, 0));
+        } else if (count == 1) {
+            emit(encodeABC(OpCode::RETURN, accumulators, 1, 0));
+        } else {
+            int list = allocReg();
+            emit(encodeABC(OpCode::NEWARRAY, list, accumulators, count));
+            emit(encodeABC(OpCode::RETURN, list, 1, 0));
+        }
+
+        fs_ = enclosing;
+        return state.proto;
+    }
+
+    void CodeGenerator::parallelWriteError(std::string_view target) const {
+        error("no se puede modificar '" + std::string(target) +
+              "' dentro de PARA PARALELO: las variables externas son de solo lectura (usa REDUCIR)");
+    }
+
+    bool CodeGenerator::switchTable(NodeId node, int subject) {
+        const NodeId* cases = arena_.children(node);
+        uint32_t count = arena_.childCount(node);
+        // Sólo CASO con un literal INT (o su negación) o STRING y como mucho un DEFECTO
+        NodeId defaultCase = kNoNode;
+        for (uint32_t i = 0; i < count; ++i) {
+            const AstNode& c = arena_.node(cases[i]);
+            if (c.a == kNoNode) {
+                if (defaultCase != kNoNode) return false;
+                defaultCase = cases[i];
+                continue;
+            }
+            const AstNode& label = arena_.node(c.a);
+            bool literal = label.kind == NodeKind::INT_LIT || label.kind == NodeKind::STRING_LIT ||
+                           (label.kind == NodeKind::UNARY && label.op == OpKind::NEG &&
+                            arena_.node(label.a).kind == NodeKind::INT_LIT);
+            if ((c.flags & FLAG_GUARD) || !literal) return false;
+        }
+        std::vector<SwitchTable>& tables = fs_->proto->switchTables;
+        uint32_t labels = count - (defaultCase != kNoNode ? 1 : 0);
+        if (labels < kMinSwitchTableCases || tables.size() > static_cast<size_t>(kMaxBx)) return false;
+
+        SwitchTable table;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (cases[i] == defaultCase) continue;
+            const AstNode& label = arena_.node(arena_.node(cases[i]).a);
+            if (label.kind == NodeKind::STRING_LIT) {
+                table.keys.push_back(stringConstant(arena_.str(label.v.str)));
+            } else if (label.kind == NodeKind::INT_LIT) {
+                table.keys.push_back(constant(Value::integer(label.v.i)));
+            } else {
+                table.keys.push_back(constant(Value::integer(-arena_.node(label.a).v.i)));
+            }
+        }
+        table.build(fs_->proto->constants);
+        emit(encodeABx(OpCode::SWITCH, subject, static_cast<uint32_t>(tables.size())));
+        tables.push_back(std::move(table));
+
+        // Un JMP por CASO y el del DEFECTO; cada bloque sale al final de la SELECCION
+        std::vector<size_t> jumps;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (cases[i] != defaultCase) jumps.push_back(emitJump(OpCode::JMP, 0));
+        }
+        size_t otherwise = emitJump(OpCode::JMP, 0);
+        std::vector<size_t> exits;
+        size_t next = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (cases[i] == defaultCase) continue;
+            line_ = arena_.node(cases[i]).line;
+            patchJump(jumps[next++]);
+            block(cases[i]);
+            // Sin DEFECTO, el último CASO sigue directamente hasta el final
+            if (defaultCase != kNoNode || next < jumps.size()) exits.push_back(emitJump(OpCode::JMP, 0));
+        }
+        patchJump(otherwise);
+        if (defaultCase != kNoNode) block(defaultCase);
+        for (size_t jump : exits) patchJump(jump);
+        return true;
+    }
+
+    void CodeGenerator::switchStatement(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        beginScope();
+        int subject = allocReg();
+        expr(n.a, subject);
+        declareLocal("", subject, true);
+        if (switchTable(node, subject)) {
+            endScope();
+            return;
+        }
+
+        std::vector<size_t> exits;
+        NodeId defaultCase = kNoNode;
+        const NodeId* cases = arena_.children(node);
+        for (uint32_t i = 0; i < arena_.childCount(node); ++i) {
+            const AstNode& c = arena_.node(cases[i]);
+            line_ = c.line;
+            if (c.a == kNoNode) {
+                if (defaultCase != kNoNode) error("SELECCION con más de un DEFECTO");
+                defaultCase = cases[i];
+                continue;
+            }
+            // CASO con condición: se evalúa como guarda; si no, se compara con el sujeto
+            int test = allocReg();
+            expr(c.a, test);
+            if (!(c.flags & FLAG_GUARD)) {
+                emit(encodeABC(OpCode::EQ, test, subject, test));
+            }
+            size_t next = emitJump(OpCode::JMPIFNOT, test);
+            freeTo(localTop());
+            block(cases[i]);
+            exits.push_back(emitJump(OpCode::JMP, 0));
+            patchJump(next);
+        }
+        if (defaultCase != kNoNode) block(defaultCase);
+        for (size_t jump : exits) patchJump(jump);
+        endScope();
+    }
+
+    void CodeGenerator::returnStatement(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        if (fs_->parallelBody) error("RETORNAR no se admite dentro de PARA PARALELO");
+        if (fs_->isConstructor) {
+            if (n.a != kNoNode) error("un CONSTRUCTOR no puede retornar un valor");
+            emit(encodeABC(OpCode::RETURN, 0, 1, 0));
+            return;
+        }
+        if (n.a == kNoNode) {
+            emit(encodeABC(OpCode::RETURN, 0, 0, 0));
+            return;
+        }
+        int value = exprAnyReg(n.a);
+        // RETORNAR f(...): llamada final, que reutiliza el marco de esta función
+        std::vector<Instr>& code = fs_->proto->code;
+        if (!code.empty() && opOf(code.back()) == OpCode::CALL && argA(code.back()) == static_cast<uint32_t>(value)) {
+            code.back() = (code.back() & ~Instr(0xFF)) | static_cast<Instr>(OpCode::TAILCALL);
+        }
+        line_ = n.line;
+        emit(encodeABC(OpCode::RETURN, value, 1, 0));
+    }
+
+    void CodeGenerator::importStatement(NodeId node) {
+        std::string module = name(node);
+        if (symbols_.modules.count(fs_->prefix + module) || symbols_.modules.count(module)) return;
+        // Las bibliotecas nativas registran su módulo en el VM; si no existe queda vacío
+        ObjModule* object = vm_.findModule(module);
+        if (object == nullptr) object = vm_.defineModule(module);
+        defineGlobal(vm_.globalSlot(module), Value::object(object));
+    }
+
+    void CodeGenerator::jumpOutOfLoop(NodeId node, bool isBreak) {
+        (void)node;
+        if (fs_->loops.empty()) {
+            error(isBreak ? "ROMPER fuera de un bucle" : "CONTINUAR fuera de un bucle");
+        }
+        if (isBreak && fs_->loops.back().parallel) error("ROMPER no se admite en PARA PARALELO");
+        size_t jump = emitJump(OpCode::JMP, 0);
+        Loop& loop = fs_->loops.back();
+        (isBreak ? loop.breaks : loop.continues).push_back(jump);
+    }
+
+    // -------------------------------------
+    // Expresiones
+    // -------------------------------------
+
+    void CodeGenerator::expr(NodeId node, int dst) {
+        const AstNode& n = arena_.node(node);
+        int mark = fs_->freeReg;
+        line_ = n.line;
+        switch (n.kind) {
+            case NodeKind::INT_LIT:
+                if (n.v.i >= -kSBxBias && n.v.i <= kMaxBx - kSBxBias) {
+                    emit(encodeAsBx(OpCode::LOADI, dst, static_cast<int32_t>(n.v.i)));
+                } else {
+                    emit(encodeABx(OpCode::LOADK, dst, constant(Value::integer(n.v.i))));
+                }
+                break;
+            case NodeKind::FLOAT_LIT:
+                emit(encodeABx(OpCode::LOADK, dst, constant(Value::number(n.v.f))));
+                break;
+            case NodeKind::STRING_LIT:
+                emit(encodeABx(OpCode::LOADK, dst, stringConstant(arena_.str(n.v.str))));
+                break;
+            case NodeKind::BOOL_LIT:
+                emit(encodeABC(OpCode::LOADBOOL, dst, n.v.i != 0 ? 1 : 0, 0));
+                break;
+            case NodeKind::NULL_LIT:
+                emit(encodeABC(OpCode::LOADNIL, dst, 0, 0));
+                break;
+            case NodeKind::IDENT: {
+                if (!moduleName(node).empty()) error("el MODULO '" + name(node) + "' no es un valor");
+                VarRef ref = resolve(arena_.str(n.v.str), n.line);
+                switch (ref.kind) {
+                    case RefKind::LOCAL:
+                        if (static_cast<int>(ref.index) != dst) emit(encodeABC(OpCode::MOVE, dst, ref.index, 0));
+                        break;
+                    case RefKind::FIELD:
+                    case RefKind::METHOD:
+                        emit(encodeABC(OpCode::GETFIELD, dst, 0, ref.index));
+                        break;
+                    case RefKind::GLOBAL:
+                        emit(encodeABx(OpCode::GETGLOBAL, dst, ref.index));
+                        break;
+                }
+                break;
+            }
+            case NodeKind::UNARY: {
+                const AstNode& operand = arena_.node(n.a);
+                if (n.op == OpKind::NEG && operand.kind == NodeKind::INT_LIT) {
+                    int64_t value = -operand.v.i;
+                    if (value >= -kSBxBias && value <= kMaxBx - kSBxBias) {
+                        emit(encodeAsBx(OpCode::LOADI, dst, static_cast<int32_t>(value)));
+                    } else {
+                        emit(encodeABx(OpCode::LOADK, dst, constant(Value::integer(value))));
+                    }
+                    break;
+                }
+                if (n.op == OpKind::NEG && operand.kind == NodeKind::FLOAT_LIT) {
+                    emit(encodeABx(OpCode::LOADK, dst, constant(Value::number(-operand.v.f))));
+                    break;
+                }
+                int value = exprAnyReg(n.a);
+                line_ = n.line;
+                emit(encodeABC(n.op == OpKind::NEG ? OpCode::NEG : OpCode::NOT, dst, value, 0));
+                break;
+            }
+            case NodeKind::BINARY:
+                binary(node, dst);
+                break;
+            case NodeKind::ASSIGN: {
+                int value = assign(node);
+                if (value != dst) emit(encodeABC(OpCode::MOVE, dst, value, 0));
+                break;
+            }
+            case NodeKind::CALL:
+                call(node, dst);
+                break;
+            case NodeKind::INDEX: {
+                if (const TypedLoop* loop = typedAccess(node)) {
+                    emit(encodeABC(OpCode::GETTYPED, dst, loop->arrayReg, loop->counter));
+                    break;
+                }
+                int object = exprAnyReg(n.a);
+                int key = exprAnyReg(n.b);
+                line_ = n.line;
+                emit(encodeABC(OpCode::GETINDEX, dst, object, key));
+                break;
+            }
+            case NodeKind::MEMBER: {
+                if (!moduleName(n.a).empty()) {
+                    emit(encodeABx(OpCode::GETGLOBAL, dst, moduleMemberSlot(node)));
+                    break;
+                }
+                int object = exprAnyReg(n.a);
+                line_ = n.line;
+                emit(encodeABC(OpCode::GETFIELD, dst, object, fieldConstant(arena_.str(n.v.str))));
+                break;
+            }
+            case NodeKind::ARRAY_LIT:
+            case NodeKind::MAP_LIT: {
+                const NodeId* items = arena_.children(node);
+                uint32_t count = arena_.childCount(node);
+                bool isMap = n.kind == NodeKind::MAP_LIT;
+                if ((isMap ? count / 2 : count) > 255) error("literal con demasiados elementos");
+                int first = fs_->freeReg;
+                for (uint32_t i = 0; i < count; ++i) {
+                    expr(items[i], allocReg());
+                }
+                line_ = n.line;
+                emit(encodeABC(isMap ? OpCode::NEWMAP : OpCode::NEWARRAY, dst, first, isMap ? count / 2 : count));
+                break;
+            }
+            case NodeKind::COND_EXPR: {
+                int cond = exprAnyReg(n.a);
+                size_t skipThen = emitJump(OpCode::JMPIFNOT, cond);
+                freeTo(mark);
+                expr(n.b, dst);
+                size_t skipElse = emitJump(OpCode::JMP, 0);
+                patchJump(skipThen);
+                expr(n.d, dst);
+                patchJump(skipElse);
+                break;
+            }
+            default:
+                error("expresión no válida");
+        }
+        freeTo(mark);
+    }
+
+    int CodeGenerator::exprAnyReg(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        if (n.kind == NodeKind::IDENT && moduleName(node).empty()) {
+            VarRef ref = resolve(arena_.str(n.v.str), n.line);
+            if (ref.kind == RefKind::LOCAL) return static_cast<int>(ref.index);
+        }
+        int reg = allocReg();
+        expr(node, reg);
+        return reg;
+    }
+
+    void CodeGenerator::exprInto(NodeId node, int target) {
+        // Evalúa en un temporal para no pisar el destino mientras se lee, y luego
+        // redirige la última instrucción al destino cuando es seguro hacerlo
+        int temp = allocReg();
+        expr(node, temp);
+        std::vector<Instr>& code = fs_->proto->code;
+        // Un EXTRAARG es el operando de la instrucción que lo precede
+        size_t last = code.size() - (!code.empty() && opOf(code.back()) == OpCode::EXTRAARG ? 2 : 1);
+        if (!code.empty() && fs_->lastTarget != code.size() && argA(code[last]) == static_cast<uint32_t>(temp) &&
+            isRetargetable(opOf(code[last]))) {
+            code[last] = (code[last] & ~0xFF00u) | (static_cast<uint32_t>(target) << 8);
+        } else {
+            emit(encodeABC(OpCode::MOVE, target, temp, 0));
+        }
+        freeTo(temp);
+    }
+
+    void CodeGenerator::binary(NodeId node, int dst) {
+        const AstNode& n = arena_.node(node);
+        if (n.op == OpKind::AND || n.op == OpKind::OR) {
+            expr(n.a, dst);
+            size_t shortCircuit = emitJump(n.op == OpKind::AND ? OpCode::JMPIFNOT : OpCode::JMPIF, dst);
+            expr(n.b, dst);
+            patchJump(shortCircuit);
+            return;
+        }
+        int left = exprAnyReg(n.a);
+        int right = exprAnyReg(n.b);
+        line_ = n.line;
+        OpCode op;
+        switch (n.op) {
+            case OpKind::EQ: op = OpCode::EQ; break;
+            case OpKind::NE: op = OpCode::NE; break;
+            case OpKind::LT: op = OpCode::LT; break;
+            case OpKind::LE: op = OpCode::LE; break;
+            // a > b se emite como b < a
+            case OpKind::GT: op = OpCode::LT; std::swap(left, right); break;
+            case OpKind::GE: op = OpCode::LE; std::swap(left, right); break;
+            default: op = arithOp(n.op); break;
+        }
+        if (op == OpCode::NOP) error("operador binario no válido");
+        emit(encodeABC(op, dst, left, right));
+    }
+
+    void CodeGenerator::call(NodeId node, int dst) {
+        const AstNode& n = arena_.node(node);
+        int mark = fs_->freeReg;
+        // El resultado queda en la base de la llamada: si dst es el último registro
+        // reservado se usa como base directamente y se evita un MOVE
+        int base = (dst == fs_->freeReg - 1 && dst >= localTop()) ? dst : allocReg();
+        uint32_t receiver = 0;
+
+        const AstNode& callee = arena_.node(n.a);
+        if (callee.kind == NodeKind::MEMBER && !moduleName(callee.a).empty()) {
+            line_ = callee.line;
+            emit(encodeABx(OpCode::GETGLOBAL, base, moduleMemberSlot(n.a)));
+        } else if (callee.kind == NodeKind::MEMBER) {
+            int object = exprAnyReg(callee.a);
+            line_ = callee.line;
+            emit(encodeABC(OpCode::SELF, base, object, fieldConstant(arena_.str(callee.v.str))));
+            freeTo(base + 1);
+            allocReg();
+            receiver = 1;
+        } else if (callee.kind == NodeKind::IDENT && moduleName(n.a).empty() &&
+                   resolve(arena_.str(callee.v.str), callee.line).kind == RefKind::METHOD) {
+            // Llamada a un método de la propia clase: receptor implícito R[0]
+            emit(encodeABC(OpCode::SELF, base, 0, fieldConstant(arena_.str(callee.v.str))));
+            allocReg();
+            receiver = 1;
+        } else {
+            expr(n.a, base);
+        }
+
+        const NodeId* args = arena_.children(node);
+        uint32_t argc = arena_.childCount(node);
+        std::vector<NodeId> ordered;
+        if (namedArguments(node, ordered)) {
+            args = ordered.data();
+            argc = static_cast<uint32_t>(ordered.size());
+        }
+        if (argc + receiver > 255) error("demasiados argumentos en la llamada");
+        for (uint32_t i = 0; i < argc; ++i) {
+            int reg = allocReg();
+            if (args[i] == kNoNode) {
+                emit(encodeABC(OpCode::LOADNIL, reg, 0, 0));
+            } else {
+                expr(args[i], reg);
+            }
+        }
+        line_ = n.line;
+        emit(encodeABC(OpCode::CALL, base, argc + receiver, receiver));
+        if (base != dst) emit(encodeABC(OpCode::MOVE, dst, base, 0));
+        freeTo(mark);
+    }
+
+    // Argumentos con nombre al construir una clase conocida: Persona(nombre="Ana", edad=30).
+    // Se reordenan según los parámetros del constructor; los que faltan valen NULO.
+    bool CodeGenerator::namedArguments(NodeId node, std::vector<NodeId>& ordered) {
+        const NodeId* args = arena_.children(node);
+        uint32_t argc = arena_.childCount(node);
+        auto isNamed = [&](NodeId arg) {
+            const AstNode& a = arena_.node(arg);
+            return a.kind == NodeKind::ASSIGN && a.op == OpKind::NONE && arena_.kind(a.a) == NodeKind::IDENT;
+        };
+        if (argc == 0 || !isNamed(args[0])) return false;
+
+        const AstNode& callee = arena_.node(arena_.node(node).a);
+        ClassInfo* info = nullptr;
+        if (callee.kind == NodeKind::IDENT) {
+            std::string calleeName(arena_.str(callee.v.str));
+            bool shadowed = false;
+            for (const Local& local : fs_->locals) shadowed = shadowed || local.name == calleeName;
+            if (!shadowed) info = findClass(calleeName, fs_->prefix);
+        }
+        if (info == nullptr) error("los argumentos con nombre solo se admiten al construir una CLASE o STRUCT");
+
+        std::vector<std::string_view> params;
+        const NodeId* members = arena_.children(info->node);
+        bool hasCtor = false;
+        for (uint32_t i = 0; i < arena_.childCount(info->node); ++i) {
+            if (arena_.kind(members[i]) != NodeKind::CTOR_DECL) continue;
+            hasCtor = true;
+            const NodeId* ctorParams = arena_.children(members[i]);
+            for (uint32_t p = 0; p < arena_.childCount(members[i]); ++p) {
+                params.push_back(arena_.str(arena_.node(ctorParams[p]).v.str));
+            }
+        }
+        if (!hasCtor && arena_.kind(info->node) == NodeKind::STRUCT_DECL) {
+            for (const std::string& field : info->klass->fields) params.push_back(field);
+        }
+
+        ordered.assign(params.size(), kNoNode);
+        for (uint32_t i = 0; i < argc; ++i) {
+            if (!isNamed(args[i])) error("no se pueden mezclar argumentos posicionales y con nombre");
+            const AstNode& arg = arena_.node(args[i]);
+            std::string_view argName = arena_.str(arena_.node(arg.a).v.str);
+            auto it = std::find(params.begin(), params.end(), argName);
+            if (it == params.end()) {
+                error(info->klass->name + " no tiene ningún parámetro llamado '" + std::string(argName) + "'");
+            }
+            ordered[static_cast<size_t>(it - params.begin())] = arg.b;
+        }
+        return true;
+    }
+
+    int CodeGenerator::assign(NodeId node) {
+        const AstNode& n = arena_.node(node);
+        const AstNode& target = arena_.node(n.a);
+        OpCode compound = arithOp(n.op);
+
+        if (target.kind == NodeKind::IDENT && moduleName(n.a).empty()) {
+            std::string_view targetName = arena_.str(target.v.str);
+            VarRef ref = resolve(targetName, target.line);
+            if (fs_->parallelBody && ref.kind != RefKind::METHOD &&
+                (ref.kind != RefKind::LOCAL || static_cast<int>(ref.index) < fs_->captureCount)) {
+                parallelWriteError(targetName);
+            }
+            if (ref.isConst) {
+                error("no se puede modificar '" + std::string(targetName) +
+                      "': es una constante o la variable de control de PARA");
+            }
+            if (ref.kind == RefKind::METHOD) error("no se puede asignar al método '" + std::string(targetName) + "'");
+            if (ref.kind == RefKind::LOCAL) {
+                if (compound == OpCode::NOP) {
+                    exprInto(n.b, static_cast<int>(ref.index));
+                } else {
+                    int value = exprAnyReg(n.b);
+                    line_ = n.line;
+                    emit(encodeABC(compound, ref.index, ref.index, value));
+                }
+                line_ = n.line;
+                if (ref.element >= 0) emit(encodeABC(OpCode::TOTYPED, ref.index, ref.element, 0));
+                return static_cast<int>(ref.index);
+            }
+            int value = allocReg();
+            if (compound == OpCode::NOP) {
+                expr(n.b, value);
+            } else {
+                if (ref.kind == RefKind::FIELD) {
+                    emit(encodeABC(OpCode::GETFIELD, value, 0, ref.index));
+                } else {
+                    emit(encodeABx(OpCode::GETGLOBAL, value, ref.index));
+                }
+                int operand = exprAnyReg(n.b);
+                emit(encodeABC(compound, value, value, operand));
+            }
+            line_ = n.line;
+            if (ref.element >= 0) emit(encodeABC(OpCode::TOTYPED, value, ref.element, 0));
+            if (ref.kind == RefKind::FIELD) {
+                emit(encodeABC(OpCode::SETFIELD, 0, ref.index, value));
+            } else {
+                emit(encodeABx(OpCode::SETGLOBAL, value, ref.index));
+            }
+            freeTo(value + 1);
+            return value;
+        }
+
+        if (target.kind == NodeKind::MEMBER && !moduleName(target.a).empty()) {
+            uint32_t slot = moduleMemberSlot(n.a);
+            if (fs_->parallelBody) parallelWriteError(vm_.globalName(slot));
+            if (symbols_.constGlobals.count(vm_.globalName(slot))) {
+                error("no se puede modificar '" + vm_.globalName(slot) + "': es una constante");
+            }
+            int value = allocReg();
+            if (compound == OpCode::NOP) {
+                expr(n.b, value);
+            } else {
+                emit(encodeABx(OpCode::GETGLOBAL, value, slot));
+                int operand = exprAnyReg(n.b);
+                emit(encodeABC(compound, value, value, operand));
+            }
+            line_ = n.line;
+            emit(encodeABx(OpCode::SETGLOBAL, value, slot));
+            freeTo(value + 1);
+            return value;
+        }
+
+        if (target.kind == NodeKind::INDEX) {
+            const TypedLoop* loop = typedAccess(n.a);
+            int object = loop != nullptr ? loop->arrayReg : exprAnyReg(target.a);
+            int key = loop != nullptr ? loop->counter : exprAnyReg(target.b);
+            int value = allocReg();
+            if (compound == OpCode::NOP) {
+                expr(n.b, value);
+            } else {
+                line_ = target.line;
+                emit(encodeABC(loop != nullptr ? OpCode::GETTYPED : OpCode::GETINDEX, value, object, key));
+                int operand = exprAnyReg(n.b);
+                emit(encodeABC(compound, value, value, operand));
+            }
+            line_ = n.line;
+            emit(encodeABC(loop != nullptr ? OpCode::SETTYPED : OpCode::SETINDEX, object, key, value));
+            freeTo(value + 1);
+            return value;
+        }
+
+        if (target.kind == NodeKind::MEMBER) {
+            int object = exprAnyReg(target.a);
+            uint32_t field = fieldConstant(arena_.str(target.v.str));
+            int value = allocReg();
+            if (compound == OpCode::NOP) {
+                expr(n.b, value);
+            } else {
+                line_ = target.line;
+                emit(encodeABC(OpCode::GETFIELD, value, object, field));
+                int operand = exprAnyReg(n.b);
+                emit(encodeABC(compound, value, value, operand));
+            }
+            line_ = n.line;
+            emit(encodeABC(OpCode::SETFIELD, object, field, value));
+            freeTo(value + 1);
+            return value;
+        }
+
+        error("destino de asignación no válido");
+    }
+
+    std::string CodeGenerator::moduleName(NodeId node) const {
+        const AstNode& n = arena_.node(node);
+        if (n.kind != NodeKind::IDENT) return "";
+        std::string_view identifier = arena_.str(n.v.str);
+        for (auto it = fs_->locals.rbegin(); it != fs_->locals.rend(); ++it) {
+            if (it->name == identifier) return "";
+        }
+        std::string qualified = fs_->prefix + std::string(identifier);
+        if (symbols_.modules.count(qualified)) return qualified;
+        if (symbols_.modules.count(std::string(identifier))) return std::string(identifier);
+        return "";
+    }
+
+    uint32_t CodeGenerator::moduleMemberSlot(NodeId member) {
+        const AstNode& n = arena_.node(member);
+        std::string module = moduleName(n.a);
+        std::string qualified = module + "." + std::string(arena_.str(n.v.str));
+        int slot = vm_.findGlobal(qualified);
+        if (slot < 0) {
+            line_ = n.line;
+            error("el MODULO " + module + " no define '" + std::string(arena_.str(n.v.str)) + "'");
+        }
+        return static_cast<uint32_t>(slot);
+    }
+
+    // -------------------------------------
+    // Resolución de nombres
+    // -------------------------------------
+
+    CodeGenerator::VarRef CodeGenerator::resolve(std::string_view identifier, uint32_t line) {
+        for (auto it = fs_->locals.rbegin(); it != fs_->locals.rend(); ++it) {
+            if (it->name == identifier) return VarRef{RefKind::LOCAL, it->reg, it->isConst, it->element};
+        }
+        std::string text(identifier);
+        if (fs_->klass != nullptr) {
+            if (fs_->klass->fieldIndex.count(text)) {
+                return VarRef{RefKind::FIELD, fieldConstant(identifier), false};
+            }
+            if (classInfo(fs_->klass).methodNames.count(text)) {
+                return VarRef{RefKind::METHOD, fieldConstant(identifier), false};
+            }
+        }
+        if (!fs_->prefix.empty()) {
+            std::string qualified = fs_->prefix + text;
+            int slot = vm_.findGlobal(qualified);
+            if (slot >= 0) {
+                auto typed = symbols_.typedGlobals.find(qualified);
+                return VarRef{RefKind::GLOBAL, static_cast<uint32_t>(slot), symbols_.constGlobals.count(qualified) > 0,
+                              typed != symbols_.typedGlobals.end() ? typed->second : -1};
+            }
+        }
+        int slot = vm_.findGlobal(text);
+        if (slot < 0) {
+            line_ = line;
+            error("identificador no declarado: " + text);
+        }
+        auto typed = symbols_.typedGlobals.find(text);
+        return VarRef{RefKind::GLOBAL, static_cast<uint32_t>(slot), symbols_.constGlobals.count(text) > 0,
+                      typed != symbols_.typedGlobals.end() ? typed->second : -1};
+    }
+
+    void CodeGenerator::declareLocal(std::string_view localName, int reg, bool isConst, int element) {
+        if (!localName.empty()) {
+            size_t scopeStart = fs_->scopes.empty() ? 0 : fs_->scopes.back();
+            for (size_t i = scopeStart; i < fs_->locals.size(); ++i) {
+                if (fs_->locals[i].name == localName) {
+                    error("'" + std::string(localName) + "' ya está declarado en este ámbito");
+                }
+            }
+        }
+        fs_->locals.push_back(Local{localName, static_cast<uint8_t>(reg), isConst, element});
+    }
+
+    int CodeGenerator::typedElement(NodeId type) const {
+        if (type == kNoNode || arena_.str(arena_.node(type).v.str) != "ARRAY" || arena_.childCount(type) != 1) return -1;
+        std::string_view element = arena_.str(arena_.node(arena_.children(type)[0]).v.str);
+        if (element == "INT") return static_cast<int>(ElementType::INT);
+        if (element == "FLOAT") return static_cast<int>(ElementType::FLOAT);
+        return -1;
+    }
+
+    void CodeGenerator::addModule(const std::string& name) {
+        if (symbols_.modules.insert(name).second && symbols_.added != nullptr) symbols_.added->modules.push_back(name);
+    }
+
+    void CodeGenerator::addConstGlobal(const std::string& name) {
+        if (symbols_.constGlobals.insert(name).second && symbols_.added != nullptr) {
+            symbols_.added->constGlobals.push_back(name);
+        }
+    }
+
+    void CodeGenerator::setTypedGlobal(const std::string& name, int element) {
+        auto it = symbols_.typedGlobals.find(name);
+        if (symbols_.added != nullptr) {
+            symbols_.added->typedGlobals.emplace_back(name, it == symbols_.typedGlobals.end() ? -1 : it->second);
+        }
+        symbols_.typedGlobals[name] = element;
+    }
+
+    // Suma delta a las declaraciones y asignaciones de cada nombre del AST
+    void CodeGenerator::countBindings(int delta) {
+        auto count = [&](std::string_view name) {
+            int& bindings = symbols_.bindingCounts[name];
+            bindings += delta;
+            if (bindings == 0) symbols_.bindingCounts.erase(name);
+        };
+        for (NodeId id = 1; id <= arena_.nodeCount(); ++id) {
+            const AstNode& n = arena_.node(id);
+            switch (n.kind) {
+                case NodeKind::VAR_DECL:
+                case NodeKind::FOR_RANGE:
+                case NodeKind::FOR_EACH:
+                case NodeKind::FUNC_DECL:
+                case NodeKind::PARAM:
+                case NodeKind::STRUCT_DECL:
+                case NodeKind::CLASS_DECL:
+                case NodeKind::FIELD:
+                case NodeKind::IMPORT:
+                case NodeKind::MODULE_DECL:
+                case NodeKind::REDUCTION:
+                    count(arena_.str(n.v.str));
+                    break;
+                case NodeKind::ASSIGN: {
+                    // Un MODULO.miembro = ... también reasigna una global
+                    const AstNode& target = arena_.node(n.a);
+                    if (target.kind == NodeKind::IDENT || target.kind == NodeKind::MEMBER) {
+                        count(arena_.str(target.v.str));
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    bool CodeGenerator::beginTypedLoop(NodeId node, int counter) {
+        // Sólo PARA i DESDE <entero >= 0> HASTA LONGITUD(a) [INCREMENTO <entero > 0>], con
+        // `a` un ARRAY<INT> / ARRAY<FLOAT> que se declara una vez y nunca se reasigna y
+        // LONGITUD la función integrada. Como un array no encoge nunca, i < LONGITUD(a)
+        // se mantiene durante todo el bucle.
+        const AstNode& n = arena_.node(node);
+        const AstNode& start = arena_.node(n.a);
+        const AstNode& limit = arena_.node(n.b);
+        if (start.kind != NodeKind::INT_LIT || start.v.i < 0) return false;
+        if (n.c != kNoNode && (arena_.kind(n.c) != NodeKind::INT_LIT || arena_.node(n.c).v.i <= 0)) return false;
+        if (limit.kind != NodeKind::CALL || arena_.childCount(n.b) != 1) return false;
+        const AstNode& callee = arena_.node(limit.a);
+        NodeId argument = arena_.children(n.b)[0];
+        const AstNode& array = arena_.node(argument);
+        if (callee.kind != NodeKind::IDENT || arena_.str(callee.v.str) != "LONGITUD" ||
+            symbols_.bindingCounts.count("LONGITUD") || array.kind != NodeKind::IDENT || !moduleName(argument).empty()) {
+            return false;
+        }
+        auto bindings = symbols_.bindingCounts.find(arena_.str(array.v.str));
+        if (bindings == symbols_.bindingCounts.end() || bindings->second != 1) return false;
+        VarRef ref = resolve(arena_.str(array.v.str), array.line);
+        if (ref.element < 0 || (ref.kind != RefKind::LOCAL && ref.kind != RefKind::GLOBAL)) return false;
+
+        int arrayReg = static_cast<int>(ref.index);
+        if (ref.kind == RefKind::GLOBAL) {
+            arrayReg = allocReg();
+            emit(encodeABx(OpCode::GETGLOBAL, arrayReg, ref.index));
+            declareLocal("", arrayReg, true);
+        }
+        fs_->typedLoops.push_back(TypedLoop{ref, arrayReg, counter});
+        return true;
+    }
+
+    const CodeGenerator::TypedLoop* CodeGenerator::typedAccess(NodeId index) {
+        const AstNode& n = arena_.node(index);
+        if (fs_->typedLoops.empty() || arena_.kind(n.a) != NodeKind::IDENT || arena_.kind(n.b) != NodeKind::IDENT ||
+            !moduleName(n.a).empty()) {
+            return nullptr;
+        }
+        VarRef key = resolve(arena_.str(arena_.node(n.b).v.str), n.line);
+        if (key.kind != RefKind::LOCAL) return nullptr;
+        VarRef array = resolve(arena_.str(arena_.node(n.a).v.str), n.line);
+        for (auto it = fs_->typedLoops.rbegin(); it != fs_->typedLoops.rend(); ++it) {
+            if (it->array.kind == array.kind && it->array.index == array.index &&
+                static_cast<int>(key.index) == it->counter) {
+                return &*it;
+            }
+        }
+        return nullptr;
+    }
+
+    int CodeGenerator::localTop() const {
+        return fs_->locals.empty() ? 0 : fs_->locals.back().reg + 1;
+    }
+
+    void CodeGenerator::beginScope() {
+        fs_->scopes.push_back(fs_->locals.size());
+    }
+
+    void CodeGenerator::endScope() {
+        fs_->locals.resize(fs_->scopes.back());
+        fs_->scopes.pop_back();
+        freeTo(localTop());
+    }
+
+    // -------------------------------------
+    // Registros, constantes y emisión
+    // -------------------------------------
+
+    int CodeGenerator::allocReg() {
+        int reg = fs_->freeReg++;
+        if (fs_->freeReg > kMaxRegisters) {
+            error("la función " + fs_->proto->name + " necesita demasiados registros");
+        }
+        if (fs_->freeReg > fs_->proto->numRegs) {
+            fs_->proto->numRegs = static_cast<uint8_t>(fs_->freeReg);
+        }
+        return reg;
+    }
+
+    uint32_t CodeGenerator::constant(Value value) {
+        std::vector<Value>& constants = fs_->proto->constants;
+        uint32_t index = static_cast<uint32_t>(constants.size());
+        if (value.isInt() || value.isFloat()) {
+            uint64_t bits;
+            if (value.isInt()) {
+                int64_t i = value.asInt();
+                std::memcpy(&bits, &i, sizeof(bits));
+            } else {
+                double f = value.asFloat();
+                std::memcpy(&bits, &f, sizeof(bits));
+            }
+            auto& cache = value.isInt() ? fs_->intConstants : fs_->floatConstants;
+            auto inserted = cache.emplace(bits, index);
+            if (!inserted.second) return inserted.first->second;
+        }
+        if (index > static_cast<uint32_t>(kMaxBx)) error("demasiadas constantes en " + fs_->proto->name);
+        constants.push_back(value);
+        return index;
+    }
+
+    uint32_t CodeGenerator::stringConstant(std::string_view text) {
+        auto it = fs_->stringConstants.find(std::string(text));
+        if (it != fs_->stringConstants.end()) return it->second;
+        uint32_t index = constant(vm_.intern(text));
+        fs_->stringConstants.emplace(std::string(text), index);
+        return index;
+    }
+
+    uint32_t CodeGenerator::fieldConstant(std::string_view fieldName) {
+        uint32_t index = stringConstant(fieldName);
+        if (index > 255) error("demasiados nombres de campo distintos en " + fs_->proto->name);
+        return index;
+    }
+
+    void CodeGenerator::emit(Instr instr) {
+        fs_->proto->code.push_back(instr);
+        fs_->proto->lines.push_back(line_);
+        if (hasInlineCache(opOf(instr))) {
+            std::vector<InlineCache>& caches = fs_->proto->inlineCaches;
+            if (caches.size() > kMaxAx) error("demasiados accesos a campos en " + fs_->proto->name);
+            caches.emplace_back();
+            emit(encodeAx(OpCode::EXTRAARG, static_cast<uint32_t>(caches.size() - 1)));
+        }
+    }
+
+    size_t CodeGenerator::emitJump(OpCode op, int a) {
+        emit(encodeAsBx(op, a, 0));
+        return fs_->proto->code.size() - 1;
+    }
+
+    void CodeGenerator::patchJumpTo(size_t at, size_t target) {
+        int64_t offset = static_cast<int64_t>(target) - static_cast<int64_t>(at + 1);
+        if (offset < -kSBxBias || offset > kMaxBx - kSBxBias) error("salto demasiado largo");
+        Instr& instr = fs_->proto->code[at];
+        instr = encodeAsBx(opOf(instr), argA(instr), static_cast<int32_t>(offset));
+    }
+
+    void CodeGenerator::emitJumpBack(OpCode op, int a, size_t target) {
+        size_t at = emitJump(op, a);
+        patchJumpTo(at, target);
+    }
+
+    void CodeGenerator::defineGlobal(uint32_t slot, Value value) {
+        int reg = allocReg();
+        emit(encodeABx(OpCode::LOADK, reg, constant(value)));
+        emit(encodeABx(OpCode::SETGLOBAL, reg, slot));
+        freeTo(reg);
+    }
+
+    size_t CodeGenerator::label() {
+        fs_->lastTarget = fs_->proto->code.size();
+        return fs_->lastTarget;
+    }
+
+    void CodeGenerator::error(const std::string& message) const {
+        throw CompileError(message, line_);
+    }
+
+} // namespace mc_core
@@ -0,0 +1,248 @@
+#ifndef CODEGEN_H
+#define CODEGEN_H
+
+#include "ast.h"
+#include "bytecode.h"
+#include "vm.h"
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mc_core {
+
+    // Error semántico detectado al generar bytecode
+    class CompileError : public std::runtime_error {
+    public:
+        CompileError(const std::string& message, uint32_t line)
+            : std::runtime_error("Error de compilación (línea " + std::to_string(line) + "): " + message),
+              line_(line) {}
+
+        uint32_t line() const { return line_; }
+
+    private:
+        uint32_t line_;
+    };
+
+    /**
+     * Generador de bytecode: recorre el AST de un programa y produce prototipos de
+     * función para la máquina virtual de registros.
+     *
+     * Los identificadores se resuelven en tiempo de compilación: variables locales a
+     * registros, campos de la clase en curso a GETFIELD/SETFIELD sobre R[0] y globales
+     * (incluidos los miembros de MODULO, con nombre "Modulo.miembro") a ranuras de la
+     * tabla global del VM. Las declaraciones de nivel superior se registran antes de
+     * compilar ningún cuerpo, por lo que el orden de declaración no importa.
+     */
+    class CodeGenerator {
+    public:
+        CodeGenerator(VM& vm, const AstArena& arena);
+        CodeGenerator(const CodeGenerator&) = delete;
+        CodeGenerator& operator=(const CodeGenerator&) = delete;
+
+        // Compila un nodo PROGRAM y devuelve el prototipo del script de nivel superior
+        FunctionProto* compileProgram(NodeId program);
+
+        // Compila el PROGRAM de un archivo importado como si fuera MODULO moduleName { ... }
+        FunctionProto* compileModule(NodeId program, const std::string& moduleName);
+
+    private:
+        struct Local {
+            std::string_view name;
+            uint8_t reg;
+            bool isConst;
+            int element = -1;  // ElementType de una variable ARRAY<INT> / ARRAY<FLOAT>, o -1
+        };
+
+        struct Loop {
+            std::vector<size_t> breaks;
+            std::vector<size_t> continues;
+            bool parallel = false;  // Recorrido de un trozo de PARA PARALELO: sin ROMPER
+        };
+
+        enum class RefKind { LOCAL, FIELD, METHOD, GLOBAL };
+
+        struct VarRef {
+            RefKind kind;
+            uint32_t index;  // Registro, constante del nombre o ranura global
+            bool isConst;
+            int element = -1;  // Como Local::element (locales y globales)
+        };
+
+        // PARA i DESDE 0 HASTA LONGITUD(a) sobre un array tipado: dentro del cuerpo a[i]
+        // está siempre en rango y se compila sin comprobaciones (GETTYPED / SETTYPED)
+        struct TypedLoop {
+            VarRef array;
+            int arrayReg;    // Copia de `a` tomada al entrar en el bucle
+            int counter;     // Registro de `i`
+        };
+
+        struct FuncState {
+            FunctionProto* proto = nullptr;
+            std::vector<Local> locals;
+            std::vector<size_t> scopes;  // Número de locales al abrir cada ámbito
+            std::vector<Loop> loops;
+            std::vector<TypedLoop> typedLoops;
+            int freeReg = 0;
+            size_t lastTarget = 0;       // Último pc que es destino de un salto
+            ObjClass* klass = nullptr;   // Clase del método en compilación
+            bool isScript = false;
+            bool isConstructor = false;
+            bool parallelBody = false;   // Cuerpo de PARA PARALELO compilado como función
+            int captureCount = 0;        // Sus primeros registros: copias de las locales externas
+            std::string prefix;          // "Modulo." dentro de un MODULO
+            std::unordered_map<std::string, uint32_t> stringConstants;
+            std::unordered_map<uint64_t, uint32_t> intConstants;
+            std::unordered_map<uint64_t, uint32_t> floatConstants;
+        };
+
+        struct ClassInfo {
+            NodeId node;
+            ObjClass* klass = nullptr;
+            std::string prefix;
+            std::unordered_set<std::string> methodNames;  // Propios y heredados
+            bool laidOut = false;
+            bool compiled = false;
+        };
+
+        // Lo que las declaraciones de nivel superior dejan para el resto de la compilación
+        // (y, en una CompilerSession, para las unidades siguientes)
+        struct Symbols {
+            std::unordered_set<std::string> modules;
+            std::unordered_set<std::string> constGlobals;
+            std::vector<ClassInfo> classInfos;
+            std::unordered_map<std::string, size_t> classByName;
+            std::unordered_map<const ObjClass*, size_t> classByObject;
+            std::unordered_map<std::string, int> typedGlobals;
+            // Veces que cada nombre se declara o es destino de una asignación en todo el programa
+            std::unordered_map<std::string_view, int> bindingCounts;
+
+            // Nombres que añade la unidad en curso, para que CompilerSession la deshaga si
+            // no compila; los arrays tipados guardan su elemento anterior (-1: no lo eran)
+            struct Added {
+                std::vector<std::string> modules;
+                std::vector<std::string> constGlobals;
+                std::vector<std::pair<std::string, int>> typedGlobals;
+            };
+            Added* added = nullptr;
+        };
+
+        friend class CompilerSession;
+        CodeGenerator(VM& vm, const AstArena& arena, Symbols& symbols);
+
+        VM& vm_;
+        const AstArena& arena_;
+        FuncState* fs_ = nullptr;
+        uint32_t line_ = 0;
+        Symbols ownSymbols_;
+        Symbols& symbols_;
+        NodeId resultStatement_ = kNoNode;  // Expresión cuyo valor retorna el script (REPL)
+
+        // Declaraciones de nivel superior
+        FunctionProto* compileUnit(NodeId program, const std::string& prefix, const std::string& unitName);
+        void declareGlobals(NodeId owner, const std::string& prefix);
+        void layoutClass(ClassInfo& info);
+        void compileClass(ClassInfo& info);
+        void defineFunctions(NodeId owner, const std::string& prefix);
+        void compileTopLevel(NodeId owner, const std::string& prefix);
+        FunctionProto* compileFunction(NodeId node, const std::string& qualifiedName, ObjClass* klass,
+                                       const std::string& prefix);
+        FunctionProto* compileConstructor(ClassInfo& info);
+
+        // Sentencias
+        void statement(NodeId node);
+        void block(NodeId node);
+        void varDecl(NodeId node);
+        void ifStatement(NodeId node);
+        void whileStatement(NodeId node);
+        void forRange(NodeId node);
+        void forEach(NodeId node);
+        void parallelFor(NodeId node);
+        FunctionProto* compileParallelBody(NodeId node, const std::vector<Local>& captures);
+        [[noreturn]] void parallelWriteError(std::string_view name) const;
+        void switchStatement(NodeId node);
+        bool switchTable(NodeId node, int subject);
+        void returnStatement(NodeId node);
+        void importStatement(NodeId node);
+        void jumpOutOfLoop(NodeId node, bool isBreak);
+        bool beginTypedLoop(NodeId node, int counter);
+        const TypedLoop* typedAccess(NodeId index);
+
+        // Expresiones
+        void expr(NodeId node, int dst);
+        int exprAnyReg(NodeId node);
+        void exprInto(NodeId node, int target);
+        void binary(NodeId node, int dst);
+        void call(NodeId node, int dst);
+        bool namedArguments(NodeId node, std::vector<NodeId>& ordered);
+        int assign(NodeId node);
+        std::string moduleName(NodeId node) const;
+        uint32_t moduleMemberSlot(NodeId member);
+
+        // Resolución de nombres
+        VarRef resolve(std::string_view name, uint32_t line);
+        ClassInfo& classInfo(const ObjClass* klass);
+        ClassInfo* findClass(const std::string& name, const std::string& prefix);
+        void declareLocal(std::string_view name, int reg, bool isConst, int element = -1);
+        int typedElement(NodeId type) const;
+        void countBindings(int delta);
+        void addModule(const std::string& name);
+        void addConstGlobal(const std::string& name);
+        void setTypedGlobal(const std::string& name, int element);
+        int localTop() const;
+        void beginScope();
+        void endScope();
+
+        // Registros, constantes y emisión
+        int allocReg();
+        void freeTo(int reg) { fs_->freeReg = reg; }
+        uint32_t constant(Value value);
+        uint32_t stringConstant(std::string_view text);
+        uint32_t fieldConstant(std::string_view name);
+        void emit(Instr instr);
+        size_t emitJump(OpCode op, int a);
+        void patchJump(size_t at) { patchJumpTo(at, label()); }
+        void patchJumpTo(size_t at, size_t target);
+        void emitJumpBack(OpCode op, int a, size_t target);
+        void defineGlobal(uint32_t slot, Value value);
+        size_t label();
+        std::string name(NodeId node) const { return std::string(arena_.str(arena_.node(node).v.str)); }
+        [[noreturn]] void error(const std::string& message) const;
+    };
+
+    // Compila un programa ya analizado en el VM indicado
+    FunctionProto* compileProgram(VM& vm, const AstArena& arena, NodeId program);
+
+    /**
+     * Compila un módulo de fuente (archivo importado con IMPORTAR) en el VM. Sus
+     * declaraciones quedan como globales "modulo.nombre" y el prototipo devuelto es su
+     * nivel superior, que hay que registrar con VM::addSourceModule para que el
+     * programa (y los módulos compilados después) lo importe e inicialice.
+     */
+    FunctionProto* compileModule(VM& vm, const AstArena& arena, NodeId program, const std::string& moduleName);
+
+    /**
+     * Compilación incremental para el REPL: cada unidad se compila en el mismo VM
+     * contra lo que declararon las anteriores. Las globales ya persisten en la tabla
+     * del VM; la sesión conserva además los MODULO, las clases (para heredar de ellas),
+     * las constantes y los arrays tipados. Si una unidad no compila, la sesión queda
+     * como antes de intentarlo. Los AST compilados deben vivir tanto como la sesión.
+     */
+    class CompilerSession {
+    public:
+        explicit CompilerSession(VM& vm) : vm_(vm) {}
+
+        // Como compileProgram; si la última sentencia es una expresión (que no sea una
+        // asignación), el script retorna su valor
+        FunctionProto* compile(const AstArena& arena, NodeId program);
+
+    private:
+        VM& vm_;
+        CodeGenerator::Symbols symbols_;
+    };
+
+} // namespace mc_core
+
+#endif // CODEGEN_H
@@ -1,11 +1,122 @@
-#include "compiler.h"
-#include <iostream>
-
-/**
- * Clase Compiler: Compila el código fuente de MC++ en un formato ejecutable.
- */
-void Compiler::run() {
-    std::cout << "Compilando el código de MC++..." << std::endl;
-    // Aquí se incluirá la lógica de compilación: análisis, optimización
-    // y generación del código ejecutable o de bytecode.
-}
+#include "compiler.h"
+#include "ast.h"
+#include "builtins.h"
+#include "bytecode_cache.h"
+#include "codegen.h"
+#include "cpp_emitter.h"
+#include "module_loader.h"
+#include "parser.h"
+#include "source_file.h"
+#include "vm.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+// Carpeta de src/libraries que enlazan los ejecutables de --emit=cpp (se puede fijar al compilar mc++)
+#ifndef MCPP_LIBRARY_DIR
+#define MCPP_LIBRARY_DIR "src/libraries"
+#endif
+
+namespace {
+
+    // Argumento entre comillas simples para la shell
+    std::string shellQuote(const std::string& text) {
+        std::string out = "'";
+        for (char c : text) {
+            if (c == '\'') {
+                out += "'\\''";
+            } else {
+                out += c;
+            }
+        }
+        return out + "'";
+    }
+
+} // namespace
+
+Compiler::Compiler(const std::string& sourcePath, bool dumpBytecode, int optimizationLevel, bool emitCpp)
+    : sourcePath_(sourcePath), dumpBytecode_(dumpBytecode), optimizationLevel_(optimizationLevel), emitCpp_(emitCpp) {}
+
+/**
+ * Clase Compiler: Compila el código fuente de MC++ en bytecode para la máquina virtual.
+ */
+void Compiler::run() {
+    std::string source = mc_core::readSourceFile(sourcePath_);
+    if (emitCpp_) {
+        runEmitCpp(source);
+        return;
+    }
+
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+
+    // Las funciones integradas deben existir para resolver sus nombres
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::ModuleLoader modules(vm, sourcePath_);
+    modules.load(arena, program);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+
+    mc_core::OptimizationStats stats = mc_core::optimizeProgram(vm, optimizationLevel_);
+    if (optimizationLevel_ > 0) {
+        std::cout << "Optimización -O" << optimizationLevel_ << ": " << stats.instructionsBefore << " -> "
+                  << stats.instructionsAfter << " instrucciones (" << stats.inlinedCalls << " llamadas expandidas, "
+                  << stats.foldedInstructions << " constantes plegadas, " << stats.foldedBranches
+                  << " saltos resueltos, " << stats.removedInstructions << " eliminadas, "
+                  << stats.hoistedInstructions << " extraídas de bucles, " << stats.fusedInstructions
+                  << " superinstrucciones)" << std::endl;
+    }
+
+    size_t instructions = 0;
+    for (const auto& proto : vm.protos()) {
+        instructions += proto->codeSize();
+        if (dumpBytecode_) {
+            std::cout << mc_core::disassemble(*proto) << std::endl;
+        }
+    }
+    std::cout << "Compilación completada: " << vm.protos().size() << " funciones, " << instructions
+              << " instrucciones en " << sourcePath_ << std::endl;
+
+    // El resultado queda en la caché .mcc que usa el modo interpret con el mismo -O
+    std::string cachePath = mc_core::cachePathFor(sourcePath_);
+    if (mc_core::writeBytecodeCache(vm, script, modules.programHash(source), optimizationLevel_, cachePath)) {
+        std::cout << "Bytecode guardado en " << cachePath << std::endl;
+    } else {
+        std::cerr << "Advertencia: no se pudo escribir la caché de bytecode en " << cachePath << std::endl;
+    }
+}
+
+void Compiler::runEmitCpp(const std::string& source) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    std::filesystem::path sourceFile(sourcePath_);
+    mc_core::CppProgram translated = mc_core::emitCpp(arena, program, sourceFile.filename().string());
+
+    std::filesystem::path cppPath = std::filesystem::path(sourceFile).replace_extension(".cpp");
+    std::filesystem::path binaryPath = std::filesystem::path(sourceFile).replace_extension("");
+    if (binaryPath == sourceFile) binaryPath += ".out";
+    {
+        std::ofstream out(cppPath, std::ios::binary);
+        out << translated.source;
+        if (!out) throw std::runtime_error("no se pudo escribir " + cppPath.string());
+    }
+    std::cout << "C++ generado en " << cppPath.string() << std::endl;
+
+    const char* libraryDir = std::getenv("MCPP_LIBRARY_DIR");
+    std::string libraries = libraryDir != nullptr && *libraryDir != '\0' ? libraryDir : MCPP_LIBRARY_DIR;
+    const char* cxx = std::getenv("CXX");
+    std::string command = std::string(cxx != nullptr && *cxx != '\0' ? cxx : "g++") + " -std=c++17 -O" +
+                          std::to_string(optimizationLevel_) + " -I" + shellQuote(libraries) + " " +
+                          shellQuote(cppPath.string());
+    // Sólo las fuentes de la biblioteca que usa el programa
+    for (const std::string& library : translated.libraries) {
+        command += " " + shellQuote((std::filesystem::path(libraries) / library).string());
+    }
+    command += " -o " + shellQuote(binaryPath.string());
+    if (std::system(command.c_str()) != 0) {
+        throw std::runtime_error("el compilador de C++ terminó con error: " + command);
+    }
+    std::cout << "Ejecutable generado en " << binaryPath.string() << std::endl;
+}
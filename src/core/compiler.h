@@ -1,14 +1,34 @@
-#ifndef CONFIG_H
-#define CONFIG_H
-
-/**
- * Clase Config: Maneja las configuraciones globales de MC++.
- */
-class Config {
-public:
-    // Inicializa las configuraciones globales
-    static void initialize();
-    // Aquí puedes añadir otros métodos o constantes globales en el futuro
-};
-
-#endif // CONFIG_H
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "optimizer.h"
+#include <string>
+
+/**
+ * Clase Compiler: Compila el código fuente de MC++ a bytecode y lo verifica sin ejecutarlo,
+ * o lo traduce a C++ y genera un ejecutable nativo (--emit=cpp).
+ */
+class Compiler {
+public:
+    // Crea un compilador para el archivo indicado; dumpBytecode muestra el listado generado
+    // y optimizationLevel es el nivel de -O (0 a mc_core::kMaxOptimizationLevel). Con
+    // emitCpp se escribe <fuente>.cpp y se compila a un ejecutable <fuente> con el -O
+    // equivalente
+    explicit Compiler(const std::string& sourcePath, bool dumpBytecode = false,
+                      int optimizationLevel = mc_core::kDefaultOptimizationLevel, bool emitCpp = false);
+
+    // Analiza y compila el archivo fuente
+    void run();
+
+private:
+    std::string sourcePath_;
+    bool dumpBytecode_;
+    int optimizationLevel_;
+    bool emitCpp_;
+
+    // Traduce a C++ y llama al compilador de C++ ($CXX, o g++) con src/libraries
+    // ($MCPP_LIBRARY_DIR, o la ruta fijada al compilar mc++)
+    void runEmitCpp(const std::string& source);
+};
+
+#endif // COMPILER_H
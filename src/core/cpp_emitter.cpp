@@ -0,0 +1,1442 @@
+#include "cpp_emitter.h"
+#include "codegen.h"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+namespace mc_core {
+
+    namespace {
+
+        // Tipos estáticos del subconjunto que se traduce a C++
+        enum class CType : uint8_t { VOID, BOOL, INT, FLOAT, STRING, INT_ARRAY, FLOAT_ARRAY };
+
+        const char* typeLabel(CType type) {
+            switch (type) {
+                case CType::VOID: return "VOID";
+                case CType::BOOL: return "BOOL";
+                case CType::INT: return "INT";
+                case CType::FLOAT: return "FLOAT";
+                case CType::STRING: return "STRING";
+                case CType::INT_ARRAY: return "ARRAY<INT>";
+                case CType::FLOAT_ARRAY: return "ARRAY<FLOAT>";
+            }
+            return "?";
+        }
+
+        const char* cppType(CType type) {
+            switch (type) {
+                case CType::VOID: return "void";
+                case CType::BOOL: return "bool";
+                case CType::INT: return "int64_t";
+                case CType::FLOAT: return "double";
+                case CType::STRING: return "std::string";
+                case CType::INT_ARRAY: return "rt::IntArray";
+                case CType::FLOAT_ARRAY: return "rt::FloatArray";
+            }
+            return "void";
+        }
+
+        bool isNumeric(CType type) { return type == CType::INT || type == CType::FLOAT; }
+        bool isArray(CType type) { return type == CType::INT_ARRAY || type == CType::FLOAT_ARRAY; }
+        CType elementOf(CType array) { return array == CType::INT_ARRAY ? CType::INT : CType::FLOAT; }
+
+        // Expresión traducida: código C++, tipo y si puede tener efectos (llama a algo)
+        struct Expr {
+            std::string code;
+            CType type = CType::VOID;
+            bool effects = false;
+        };
+
+        // Valor como double (un INT se convierte)
+        std::string real(const Expr& e) {
+            return e.type == CType::INT ? "static_cast<double>(" + e.code + ")" : e.code;
+        }
+
+        std::string asString(const Expr& e) {
+            return e.type == CType::STRING ? e.code : "rt::str(" + e.code + ")";
+        }
+
+        std::string quoted(std::string_view text) {
+            static const char* digits = "01234567";
+            std::string out = "\"";
+            for (unsigned char c : text) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += static_cast<char>(c);
+                } else if (c == '\n') {
+                    out += "\\n";
+                } else if (c == '\t') {
+                    out += "\\t";
+                } else if (c >= 0x20 && c < 0x7F) {
+                    out += static_cast<char>(c);
+                } else {
+                    // Octal de tres cifras: no se mezcla con los caracteres siguientes
+                    out += '\\';
+                    out += digits[c >> 6];
+                    out += digits[(c >> 3) & 7];
+                    out += digits[c & 7];
+                }
+            }
+            return out + "\"";
+        }
+
+        std::string floatLiteral(double f) {
+            if (std::isnan(f)) return "NAN";
+            if (std::isinf(f)) return f > 0 ? "HUGE_VAL" : "(-HUGE_VAL)";
+            char buffer[64];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), f);
+            std::string text(buffer, result.ptr);
+            if (text.find_first_of(".eE") == std::string::npos) text += ".0";
+            return text;
+        }
+
+        // Nombre de C++ para un identificador de MC++ (que puede llevar tildes)
+        std::string mangle(const char* prefix, std::string_view name) {
+            static const char* hex = "0123456789abcdef";
+            std::string out = prefix;
+            for (unsigned char c : name) {
+                if (std::isalnum(c) && c < 0x80) {
+                    out += static_cast<char>(c);
+                } else if (c == '_') {
+                    out += "__";
+                } else {
+                    out += '_';
+                    out += hex[c >> 4];
+                    out += hex[c & 15];
+                }
+            }
+            return out;
+        }
+
+        /**
+         * Soporte de ejecución que se copia al principio de cada programa generado:
+         * aritmética INT de 51 bits con los mismos errores que el VM, conversión a
+         * texto idéntica a valueToString y la salida con búfer de MOSTRAR.
+         */
+        const char* kRuntime = R"runtime(#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace rt {
+
+    // Línea y función de MC++ de cada operación que puede fallar
+    struct Site {
+        uint32_t line;
+        const char* function;
+    };
+
+    struct Error : std::runtime_error {
+        Error(const std::string& message, uint32_t site) : std::runtime_error(message), site(site) {}
+        uint32_t site;
+    };
+
+    [[noreturn]] inline void fail(const std::string& message, uint32_t site) { throw Error(message, site); }
+
+    using IntArray = std::shared_ptr<std::vector<int64_t>>;
+    using FloatArray = std::shared_ptr<std::vector<double>>;
+
+    constexpr int64_t kIntMax = (INT64_C(1) << 50) - 1;
+    constexpr int64_t kIntMin = -(INT64_C(1) << 50);
+
+    // El intérprete pasaría a FLOAT un INT que no cabe en 51 bits; aquí es un error
+    [[noreturn]] inline void overflow(uint32_t site) { fail("desbordamiento de INT: el resultado no cabe en 51 bits", site); }
+
+    inline int64_t checked(int64_t x, uint32_t site) {
+        if (x < kIntMin || x > kIntMax) overflow(site);
+        return x;
+    }
+
+    inline int64_t add(int64_t a, int64_t b, uint32_t site) { return checked(a + b, site); }
+    inline int64_t sub(int64_t a, int64_t b, uint32_t site) { return checked(a - b, site); }
+
+    inline int64_t mul(int64_t a, int64_t b, uint32_t site) {
+        int64_t result;
+        if (__builtin_mul_overflow(a, b, &result)) overflow(site);
+        return checked(result, site);
+    }
+
+    inline int64_t div(int64_t a, int64_t b, uint32_t site) {
+        if (b == 0) fail("división por cero", site);
+        return checked(a / b, site);
+    }
+
+    inline int64_t mod(int64_t a, int64_t b, uint32_t site) {
+        if (b == 0) fail("división por cero", site);
+        return b == -1 ? 0 : a % b;
+    }
+
+    inline int64_t neg(int64_t a, uint32_t site) { return checked(-a, site); }
+
+    inline double fdiv(double a, double b, uint32_t site) {
+        if (b == 0.0) fail("división por cero", site);
+        return a / b;
+    }
+
+    inline double fmod(double a, double b, uint32_t site) {
+        if (b == 0.0) fail("división por cero", site);
+        return std::fmod(a, b);
+    }
+
+    inline int64_t ipow(int64_t base, int64_t exponent, uint32_t site) {
+        int64_t result = 1;
+        while (exponent > 0) {
+            if (exponent & 1) result = mul(result, base, site);
+            exponent >>= 1;
+            if (exponent > 0) base = mul(base, base, site);
+        }
+        return result;
+    }
+
+    inline int64_t abs(int64_t x) { return x < 0 ? -x : x; }
+    inline double abs(double x) { return std::fabs(x); }
+
+    inline double notNegative(double x, uint32_t site) {
+        if (x < 0) fail("RAIZ de un número negativo", site);
+        return x;
+    }
+
+    // Límite FLOAT de un PARA con inicio y paso INT (i < 3.5 equivale a i < 4)
+    inline int64_t intLimit(double limit, int64_t step) {
+        double bound = step > 0 ? std::ceil(limit) : std::floor(limit);
+        if (!(bound > static_cast<double>(kIntMin))) return step > 0 ? kIntMin : kIntMin - 1;
+        if (!(bound < static_cast<double>(kIntMax))) return step > 0 ? kIntMax + 1 : kIntMax;
+        return static_cast<int64_t>(bound);
+    }
+
+    inline int64_t entero(double x, uint32_t site) {
+        if (!(std::fabs(x) < 1125899906842624.0)) overflow(site);
+        return static_cast<int64_t>(x);
+    }
+
+    inline int64_t entero(const std::string& text, uint32_t site) {
+        try {
+            size_t used = 0;
+            long long result = std::stoll(text, &used);
+            if (used == text.size()) return checked(result, site);
+        } catch (const std::exception&) {
+        }
+        fail("no se puede convertir \"" + text + "\" a INT", site);
+    }
+
+    inline double decimal(const std::string& text, uint32_t site) {
+        try {
+            size_t used = 0;
+            double result = std::stod(text, &used);
+            if (used == text.size()) return result;
+        } catch (const std::exception&) {
+        }
+        fail("no se puede convertir \"" + text + "\" a FLOAT", site);
+    }
+
+    inline std::string str(const std::string& text) { return text; }
+    inline std::string str(int64_t x) { return std::to_string(x); }
+    inline std::string str(bool b) { return b ? "VERDADERO" : "FALSO"; }
+
+    inline std::string str(double f) {
+        if (std::isnan(f)) return "NaN";
+        if (std::isinf(f)) return f > 0 ? "Infinito" : "-Infinito";
+        // Como valueToString: formato de %.17g con los dígitos más cortos que vuelven a dar f
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), f, std::chars_format::scientific);
+        *result.ptr = '\0';  // para atoi
+        int exponent = std::atoi(std::find(buffer, result.ptr, 'e') + 1);
+        if (exponent < -4 || exponent >= 17) return std::string(buffer, result.ptr);
+        result = std::to_chars(buffer, buffer + sizeof(buffer), f, std::chars_format::fixed);
+        std::string text(buffer, result.ptr);
+        if (text.find('.') == std::string::npos) text += ".0";
+        return text;
+    }
+
+    template <typename T>
+    std::string str(const std::shared_ptr<std::vector<T>>& array) {
+        std::string out = "[";
+        for (size_t i = 0; i < array->size(); ++i) {
+            if (i > 0) out += ", ";
+            out += str((*array)[i]);
+        }
+        return out + "]";
+    }
+
+    // Longitud en caracteres (no en bytes) de una cadena UTF-8
+    inline int64_t length(const std::string& text) {
+        int64_t count = 0;
+        for (unsigned char c : text) {
+            if ((c & 0xC0) != 0x80) ++count;
+        }
+        return count;
+    }
+
+    template <typename T>
+    int64_t length(const std::shared_ptr<std::vector<T>>& array) {
+        return static_cast<int64_t>(array->size());
+    }
+
+    template <typename T>
+    T& at(const std::shared_ptr<std::vector<T>>& array, int64_t index, uint32_t site) {
+        if (index < 0 || index >= static_cast<int64_t>(array->size())) {
+            fail("índice " + std::to_string(index) + " fuera de rango (longitud " + std::to_string(array->size()) + ")",
+                 site);
+        }
+        return (*array)[static_cast<size_t>(index)];
+    }
+
+    inline IntArray ints(std::initializer_list<int64_t> items) { return std::make_shared<std::vector<int64_t>>(items); }
+    inline FloatArray floats(std::initializer_list<double> items) { return std::make_shared<std::vector<double>>(items); }
+
+    template <typename T>
+    std::shared_ptr<std::vector<T>> push(const std::shared_ptr<std::vector<T>>& array, T item) {
+        array->push_back(item);
+        return array;
+    }
+
+    inline bool contains(const IntArray& array, int64_t x) {
+        for (int64_t item : *array) {
+            if (item == x) return true;
+        }
+        return false;
+    }
+
+    // 2.0 es igual a 2: sólo un FLOAT entero puede estar en un ARRAY<INT>
+    inline bool contains(const IntArray& array, double x) {
+        if (x != std::trunc(x) || std::fabs(x) > static_cast<double>(kIntMax)) return false;
+        return contains(array, static_cast<int64_t>(x));
+    }
+
+    inline bool contains(const FloatArray& array, double x) {
+        for (double item : *array) {
+            if (item == x) return true;
+        }
+        return false;
+    }
+
+    inline int64_t sum(const IntArray& array, uint32_t site) {
+        int64_t total = 0;
+        for (int64_t item : *array) {
+            if (__builtin_add_overflow(total, item, &total)) overflow(site);
+        }
+        return checked(total, site);
+    }
+
+    inline int64_t extreme(const IntArray& array, bool isMax, uint32_t site) {
+        if (array->empty()) fail(std::string(isMax ? "MAXIMO" : "MINIMO") + " de un ARRAY vacío", site);
+        int64_t best = array->front();
+        for (int64_t item : *array) best = isMax ? std::max(best, item) : std::min(best, item);
+        return best;
+    }
+
+    // Salida de MOSTRAR: se acumula y se escribe en bloques grandes, como OutputBuffer
+    inline std::string& output() {
+        static std::string buffer;
+        return buffer;
+    }
+
+    inline void flush() {
+        std::string& out = output();
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        std::fflush(stdout);
+        out.clear();
+    }
+
+    inline void append(std::string& out, const std::string& text) { out += text; }
+
+    template <typename T>
+    void append(std::string& out, const T& value) {
+        out += str(value);
+    }
+
+    template <typename... Args>
+    void show(const Args&... args) {
+        std::string& out = output();
+        bool first = true;
+        ((out += first ? "" : " ", first = false, append(out, args)), ...);
+        out += '\n';
+        if (out.size() >= 64 * 1024) flush();
+    }
+
+} // namespace rt
+)runtime";
+
+        class CppEmitter {
+        public:
+            explicit CppEmitter(const AstArena& arena) : arena_(arena) {}
+
+            CppProgram run(NodeId program, const std::string& sourceName);
+
+        private:
+            struct Variable {
+                CType type;
+                std::string cpp;
+                bool isConst;
+            };
+
+            struct Function {
+                std::string name;
+                std::string cpp;
+                std::vector<CType> params;
+                CType result = CType::VOID;
+                NodeId node = kNoNode;
+            };
+
+            const AstArena& arena_;
+            std::unordered_map<std::string_view, Function> functions_;
+            std::unordered_map<std::string_view, Variable> globals_;
+            std::vector<std::unordered_map<std::string_view, Variable>> scopes_;
+            std::unordered_map<std::string, int> names_;  // Nombres de C++ ya usados
+            std::map<std::pair<uint32_t, std::string>, size_t> siteIndex_;
+            std::vector<std::pair<uint32_t, std::string>> sites_;
+            const Function* function_ = nullptr;  // Función en curso; nullptr en el nivel superior
+            std::string out_;
+            std::string globalDecls_;
+            int depth_ = 0;
+            int loops_ = 0;
+            int temps_ = 0;
+            uint32_t line_ = 0;
+            bool usesMath_ = false;
+            bool usesString_ = false;
+
+            [[noreturn]] void error(const std::string& message) const { throw CompileError(message, line_); }
+            [[noreturn]] void unsupported(const std::string& what) const { error("--emit=cpp no admite " + what); }
+
+            void line(const std::string& code) {
+                out_.append(static_cast<size_t>(depth_) * 4, ' ');
+                out_ += code;
+                out_ += '\n';
+            }
+
+            std::string name(NodeId node) const { return std::string(arena_.str(arena_.node(node).v.str)); }
+            std::string site(uint32_t line);
+            std::string fresh(std::string_view name);
+            std::string temp(const char* prefix) { return prefix + std::to_string(++temps_) + "_"; }
+            CType declaredType(NodeId type);
+            std::optional<Variable> lookup(std::string_view name) const;
+
+            // Código que evalúa `args` de izquierda a derecha, como el VM, y les aplica `format`
+            template <typename Format>
+            std::string ordered(const std::vector<Expr>& args, Format format) const;
+
+            void collectFunction(NodeId node);
+            void function(const Function& fn);
+            void statement(NodeId node);
+            void block(NodeId node);
+            void varDecl(NodeId node);
+            void assign(NodeId node);
+            void ifStatement(NodeId node);
+            void whileStatement(NodeId node);
+            void forRange(NodeId node);
+            void forEach(NodeId node);
+            void switchStatement(NodeId node);
+            void returnStatement(NodeId node);
+
+            Expr expr(NodeId node);
+            Expr exprAs(NodeId node, CType expected, const std::string& what);
+            std::string condition(NodeId node);
+            Expr unary(NodeId node);
+            Expr binary(OpKind op, const Expr& left, const Expr& right, uint32_t line);
+            Expr arrayLiteral(NodeId node, CType type);
+            Expr call(NodeId node);
+            Expr builtin(const std::string& name, std::vector<NodeId> args, uint32_t line);
+            Expr method(const Expr& object, const std::string& name, std::vector<NodeId> args, uint32_t line);
+            Expr value(NodeId node);
+        };
+
+        std::string CppEmitter::site(uint32_t line) {
+            std::pair<uint32_t, std::string> key(line, function_ != nullptr ? function_->name : "<script>");
+            auto it = siteIndex_.find(key);
+            if (it == siteIndex_.end()) {
+                it = siteIndex_.emplace(key, sites_.size()).first;
+                sites_.push_back(key);
+            }
+            return std::to_string(it->second);
+        }
+
+        // Nombre de C++ único: una VAR que oculta otra no puede compartir su nombre
+        // (en C++, `int64_t x = x + 1` leería la nueva)
+        std::string CppEmitter::fresh(std::string_view name) {
+            std::string base = mangle("v_", name);
+            int uses = names_[base]++;
+            return uses == 0 ? base : base + "_" + std::to_string(uses);
+        }
+
+        CType CppEmitter::declaredType(NodeId type) {
+            const AstNode& n = arena_.node(type);
+            std::string_view typeName = arena_.str(n.v.str);
+            if (arena_.childCount(type) == 0) {
+                if (typeName == "INT") return CType::INT;
+                if (typeName == "FLOAT") return CType::FLOAT;
+                if (typeName == "BOOL") return CType::BOOL;
+                if (typeName == "STRING") return CType::STRING;
+                if (typeName == "VOID") return CType::VOID;
+            } else if (typeName == "ARRAY" && arena_.childCount(type) == 1) {
+                std::string_view element = arena_.str(arena_.node(arena_.children(type)[0]).v.str);
+                if (element == "INT") return CType::INT_ARRAY;
+                if (element == "FLOAT") return CType::FLOAT_ARRAY;
+            }
+            line_ = n.line;
+            unsupported("el tipo " + std::string(typeName));
+        }
+
+        std::optional<CppEmitter::Variable> CppEmitter::lookup(std::string_view name) const {
+            for (auto scope = scopes_.rbegin(); scope != scopes_.rend(); ++scope) {
+                auto it = scope->find(name);
+                if (it != scope->end()) return it->second;
+            }
+            auto it = globals_.find(name);
+            if (it != globals_.end()) return it->second;
+            return std::nullopt;
+        }
+
+        /**
+         * El orden de evaluación de los argumentos de una llamada de C++ no está
+         * definido. Si alguno tiene efectos, los valores se evalúan antes en el
+         * inicializador entre llaves de una tupla, que sí va de izquierda a derecha.
+         */
+        template <typename Format>
+        std::string CppEmitter::ordered(const std::vector<Expr>& args, Format format) const {
+            std::vector<std::string> codes;
+            bool effects = false;
+            for (const Expr& arg : args) effects = effects || arg.effects;
+            if (!effects || args.size() < 2) {
+                for (const Expr& arg : args) codes.push_back(arg.code);
+                return format(codes);
+            }
+            std::string params;
+            std::string types;
+            std::string values;
+            for (size_t i = 0; i < args.size(); ++i) {
+                std::string param = "o" + std::to_string(i) + "_";
+                std::string separator = i > 0 ? ", " : "";
+                params += separator + cppType(args[i].type) + " " + param;
+                types += separator + cppType(args[i].type);
+                values += separator + args[i].code;
+                codes.push_back(param);
+            }
+            return "std::apply([](" + params + ") { return " + format(codes) + "; }, std::tuple<" + types + ">{" +
+                   values + "})";
+        }
+
+        CppProgram CppEmitter::run(NodeId program, const std::string& sourceName) {
+            const NodeId* items = arena_.children(program);
+            uint32_t count = arena_.childCount(program);
+            // Las firmas primero: una función puede llamar a otra declarada más abajo
+            for (uint32_t i = 0; i < count; ++i) {
+                if (arena_.kind(items[i]) == NodeKind::FUNC_DECL) collectFunction(items[i]);
+            }
+
+            // El nivel superior, en orden; sus VAR son las globales
+            depth_ = 2;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (arena_.kind(items[i]) != NodeKind::FUNC_DECL) statement(items[i]);
+            }
+            std::string script = std::move(out_);
+
+            std::string prototypes;
+            std::string definitions;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (arena_.kind(items[i]) != NodeKind::FUNC_DECL) continue;
+                const Function& fn = functions_.at(arena_.str(arena_.node(items[i]).v.str));
+                out_.clear();
+                function(fn);
+                definitions += "\n" + out_;
+                prototypes += out_.substr(0, out_.find(" {\n")) + ";\n";
+            }
+
+            CppProgram result;
+            std::string& src = result.source;
+            src = "// Generado por mc++ compile --emit=cpp a partir de " + sourceName + "; no editar a mano.\n";
+            src += kRuntime;
+            if (usesMath_ || usesString_) src += "\n";
+            if (usesMath_) {
+                src += "#include \"math/advanced_operations.h\"\n";
+                result.libraries.push_back("math/advanced_operations.cpp");
+            }
+            if (usesString_) {
+                src += "#include \"string/text_transformation.h\"\n";
+                result.libraries.push_back("string/text_transformation.cpp");
+            }
+            src += "\nnamespace mcpp {\n\n    const rt::Site kSites[] = {\n";
+            if (sites_.empty()) sites_.emplace_back(0, "<script>");
+            for (const auto& entry : sites_) {
+                src += "        {" + std::to_string(entry.first) + ", " + quoted(entry.second) + "},\n";
+            }
+            src += "    };\n";
+            if (!globalDecls_.empty()) src += "\n" + globalDecls_;
+            if (!prototypes.empty()) src += "\n" + prototypes;
+            src += definitions;
+            src += "\n    static void script() {\n" + script + "    }\n\n} // namespace mcpp\n\n";
+
+            // Como el intérprete: tras el nivel superior se llama a main() si existe
+            auto entry = functions_.find("main");
+            src += "int main() {\n"
+                   "    try {\n"
+                   "        mcpp::script();\n";
+            if (entry != functions_.end()) src += "        mcpp::" + entry->second.cpp + "();\n";
+            src += "    } catch (const rt::Error& e) {\n"
+                   "        rt::flush();\n"
+                   "        std::fprintf(stderr, \"Excepción capturada: Error de ejecución (línea %u, en %s): %s\\n\",\n"
+                   "                     mcpp::kSites[e.site].line, mcpp::kSites[e.site].function, e.what());\n"
+                   "        return 1;\n"
+                   "    } catch (const std::exception& e) {\n"
+                   "        rt::flush();\n"
+                   "        std::fprintf(stderr, \"Excepción capturada: %s\\n\", e.what());\n"
+                   "        return 1;\n"
+                   "    }\n"
+                   "    rt::flush();\n"
+                   "    return 0;\n"
+                   "}\n";
+            return result;
+        }
+
+        void CppEmitter::collectFunction(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            line_ = n.line;
+            Function fn;
+            fn.name = name(node);
+            fn.cpp = mangle("f_", fn.name);
+            fn.node = node;
+            fn.result = n.a != kNoNode ? declaredType(n.a) : CType::VOID;
+            const NodeId* params = arena_.children(node);
+            for (uint32_t i = 0; i < arena_.childCount(node); ++i) {
+                const AstNode& param = arena_.node(params[i]);
+                line_ = param.line;
+                if (param.a == kNoNode) {
+                    error("el parámetro '" + name(params[i]) + "' de " + fn.name + " necesita un tipo en --emit=cpp");
+                }
+                CType type = declaredType(param.a);
+                if (type == CType::VOID) error("un parámetro no puede ser VOID");
+                fn.params.push_back(type);
+            }
+            line_ = n.line;
+            if (fn.name == "main" && !fn.params.empty()) error("main() no puede tener parámetros");
+            if (!functions_.emplace(arena_.str(n.v.str), std::move(fn)).second) {
+                error("la función '" + name(node) + "' ya está declarada");
+            }
+        }
+
+        void CppEmitter::function(const Function& fn) {
+            const AstNode& n = arena_.node(fn.node);
+            function_ = &fn;
+            scopes_.emplace_back();
+            std::string params;
+            const NodeId* items = arena_.children(fn.node);
+            for (uint32_t i = 0; i < arena_.childCount(fn.node); ++i) {
+                std::string cpp = fresh(arena_.str(arena_.node(items[i]).v.str));
+                if (i > 0) params += ", ";
+                params += std::string(cppType(fn.params[i])) + " " + cpp;
+                scopes_.back()[arena_.str(arena_.node(items[i]).v.str)] = {fn.params[i], cpp, false};
+            }
+            depth_ = 1;
+            line("static " + std::string(cppType(fn.result)) + " " + fn.cpp + "(" + params + ") {");
+            block(n.d);
+            uint32_t statements = arena_.childCount(n.d);
+            bool returns = statements > 0 && arena_.kind(arena_.children(n.d)[statements - 1]) == NodeKind::RETURN;
+            if (fn.result != CType::VOID && !returns) {
+                // El VM devolvería NULO, que no es un valor del tipo declarado
+                depth_ = 2;
+                line_ = n.line;
+                line("rt::fail(\"" + fn.name + " termina sin RETORNAR un " + typeLabel(fn.result) + "\", " +
+                     site(n.line) + ");");
+                depth_ = 1;
+            }
+            line("}");
+            scopes_.pop_back();
+            function_ = nullptr;
+        }
+
+        void CppEmitter::statement(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            line_ = n.line;
+            switch (n.kind) {
+                case NodeKind::VAR_DECL: varDecl(node); break;
+                case NodeKind::EXPR_STMT: {
+                    const AstNode& e = arena_.node(n.a);
+                    if (e.kind == NodeKind::ASSIGN) {
+                        assign(n.a);
+                    } else if (e.kind == NodeKind::CALL) {
+                        line(call(n.a).code + ";");
+                    } else {
+                        line("static_cast<void>(" + value(n.a).code + ");");
+                    }
+                    break;
+                }
+                case NodeKind::IF: ifStatement(node); break;
+                case NodeKind::WHILE: whileStatement(node); break;
+                case NodeKind::FOR_RANGE: forRange(node); break;
+                case NodeKind::FOR_EACH: forEach(node); break;
+                case NodeKind::RETURN: returnStatement(node); break;
+                case NodeKind::BREAK:
+                case NodeKind::CONTINUE:
+                    if (loops_ == 0) {
+                        error(std::string(n.kind == NodeKind::BREAK ? "ROMPER" : "CONTINUAR") + " fuera de un bucle");
+                    }
+                    line(n.kind == NodeKind::BREAK ? "break;" : "continue;");
+                    break;
+                case NodeKind::BLOCK:
+                    line("{");
+                    block(node);
+                    line("}");
+                    break;
+                case NodeKind::FUNC_DECL:
+                    error("las declaraciones de FUNC solo se admiten en el nivel superior");
+                case NodeKind::PARALLEL_FOR: unsupported("PARA PARALELO");
+                case NodeKind::SWITCH: switchStatement(node); break;
+                case NodeKind::STRUCT_DECL:
+                case NodeKind::CLASS_DECL: unsupported("CLASE y STRUCT");
+                case NodeKind::MODULE_DECL:
+                case NodeKind::IMPORT: unsupported("MODULO e IMPORTAR");
+                default: unsupported("esta sentencia");
+            }
+        }
+
+        void CppEmitter::block(NodeId node) {
+            scopes_.emplace_back();
+            ++depth_;
+            const NodeId* items = arena_.children(node);
+            for (uint32_t i = 0; i < arena_.childCount(node); ++i) statement(items[i]);
+            --depth_;
+            scopes_.pop_back();
+        }
+
+        void CppEmitter::varDecl(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            std::string_view varName = arena_.str(n.v.str);
+            std::string what = "'" + std::string(varName) + "'";
+            CType type;
+            std::string init;
+            if (n.a != kNoNode) {
+                type = declaredType(n.a);
+                if (type == CType::VOID) error(what + " no puede ser VOID");
+                if (n.d != kNoNode) {
+                    init = exprAs(n.d, type, what).code;
+                } else if (isArray(type)) {
+                    init = type == CType::INT_ARRAY ? "rt::ints({})" : "rt::floats({})";
+                } else {
+                    init = type == CType::STRING ? "std::string()" : type == CType::BOOL ? "false" : "0";
+                }
+            } else {
+                if (n.d == kNoNode) error(what + " necesita un tipo o un valor inicial en --emit=cpp");
+                Expr e = value(n.d);
+                type = e.type;
+                init = e.code;
+            }
+            line_ = n.line;
+            Variable var{type, "", (n.flags & FLAG_CONST) != 0};
+            if (function_ == nullptr && scopes_.empty()) {
+                // Global: declarada en el espacio de nombres, inicializada en su sitio del script
+                auto it = globals_.find(varName);
+                if (it != globals_.end()) {
+                    if (it->second.type != type) error(what + " ya está declarada como " + typeLabel(it->second.type));
+                    line(it->second.cpp + " = " + init + ";");
+                    return;
+                }
+                var.cpp = fresh(varName);
+                globalDecls_ += "    static " + std::string(cppType(type)) + " " + var.cpp + ";\n";
+                line(var.cpp + " = " + init + ";");
+                globals_.emplace(varName, var);
+                return;
+            }
+            var.cpp = fresh(varName);
+            line(std::string(cppType(type)) + " " + var.cpp + " = " + init + ";");
+            scopes_.back()[varName] = var;
+        }
+
+        void CppEmitter::assign(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            const AstNode& target = arena_.node(n.a);
+            line_ = n.line;
+            if (target.kind == NodeKind::IDENT) {
+                std::string targetName = name(n.a);
+                std::optional<Variable> var = lookup(targetName);
+                if (!var) error("'" + targetName + "' no está declarada");
+                if (var->isConst) error("no se puede asignar a la constante '" + targetName + "'");
+                Expr current{var->cpp, var->type, false};
+                const AstNode& rhs = arena_.node(n.b);
+                // s = s + x (o s += x) sobre un STRING: se añade en el sitio sin copiar la cadena
+                bool selfAppend = n.op == OpKind::ADD ||
+                                  (n.op == OpKind::NONE && rhs.kind == NodeKind::BINARY && rhs.op == OpKind::ADD &&
+                                   arena_.kind(rhs.a) == NodeKind::IDENT && name(rhs.a) == targetName);
+                if (var->type == CType::STRING && selfAppend) {
+                    Expr tail = value(n.op == OpKind::ADD ? n.b : rhs.b);
+                    if (!tail.effects) {
+                        line(var->cpp + " += " + asString(tail) + ";");
+                        return;
+                    }
+                }
+                Expr result = n.op == OpKind::NONE ? exprAs(n.b, var->type, "'" + targetName + "'")
+                                                   : binary(n.op, current, value(n.b), n.line);
+                if (result.type != var->type) {
+                    error("'" + targetName + "' es " + typeLabel(var->type) + " y el valor es " + typeLabel(result.type));
+                }
+                line(var->cpp + " = " + result.code + ";");
+                return;
+            }
+            if (target.kind != NodeKind::INDEX) unsupported("asignar a un campo");
+
+            Expr array = value(target.a);
+            if (!isArray(array.type)) unsupported("asignar por índice en un " + std::string(typeLabel(array.type)));
+            Expr index = value(target.b);
+            if (index.type != CType::INT) error(std::string("índice de tipo ") + typeLabel(index.type) + " no válido para ARRAY");
+            CType element = elementOf(array.type);
+            std::string s = site(n.line);
+            std::string ref = ordered({array, index}, [&](const std::vector<std::string>& c) {
+                return "rt::at(" + c[0] + ", " + c[1] + ", " + s + ")";
+            });
+            auto store = [&](const Expr& e) {
+                if (e.type == element || (element == CType::FLOAT && e.type == CType::INT)) return real(e);
+                error("no se puede guardar un " + std::string(typeLabel(e.type)) + " en un " + typeLabel(array.type));
+            };
+            if (n.op == OpKind::NONE) {
+                // En C++17 el valor se evalúa antes que la referencia: sigue siendo válida
+                // aunque el valor añada elementos al mismo ARRAY
+                line(ref + " = " + store(value(n.b)) + ";");
+                return;
+            }
+            Expr rhs = value(n.b);
+            line("{");
+            ++depth_;
+            if (rhs.effects) {
+                std::string held = temp("t");
+                line("const " + std::string(cppType(rhs.type)) + " " + held + " = " + rhs.code + ";");
+                rhs = Expr{held, rhs.type, false};
+            }
+            std::string slot = temp("r");
+            line("auto& " + slot + " = " + ref + ";");
+            line(slot + " = " + store(binary(n.op, Expr{slot, element, false}, rhs, n.line)) + ";");
+            --depth_;
+            line("}");
+        }
+
+        void CppEmitter::ifStatement(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            line("if (" + condition(n.a) + ") {");
+            block(n.b);
+            NodeId alternative = n.d;
+            while (alternative != kNoNode) {
+                const AstNode& alt = arena_.node(alternative);
+                line_ = alt.line;
+                if (alt.kind == NodeKind::IF) {
+                    line("} else if (" + condition(alt.a) + ") {");
+                    block(alt.b);
+                    alternative = alt.d;
+                } else {
+                    line("} else {");
+                    block(alternative);
+                    alternative = kNoNode;
+                }
+            }
+            line("}");
+        }
+
+        void CppEmitter::whileStatement(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            line("while (" + condition(n.a) + ") {");
+            ++loops_;
+            block(n.d);
+            --loops_;
+            line("}");
+        }
+
+        // Signo de un paso literal (1, -3, 0.25...); 0 si no es literal
+        int literalSign(const AstArena& arena, NodeId node) {
+            const AstNode& n = arena.node(node);
+            if (n.kind == NodeKind::INT_LIT) return n.v.i > 0 ? 1 : n.v.i < 0 ? -1 : 2;
+            if (n.kind == NodeKind::FLOAT_LIT) return n.v.f > 0 ? 1 : n.v.f < 0 ? -1 : 2;
+            if (n.kind == NodeKind::UNARY && n.op == OpKind::NEG) {
+                int sign = literalSign(arena, n.a);
+                return sign == 2 ? 2 : -sign;
+            }
+            return 0;
+        }
+
+        /**
+         * PARA con la semántica de FORPREP/FORLOOP: límite y paso se evalúan una vez;
+         * con inicio y paso INT el contador es INT (un límite FLOAT se redondea hacia
+         * el lado del paso) y en otro caso todo el bucle trabaja en FLOAT. Con un paso
+         * literal la dirección se conoce y la condición es una sola comparación.
+         */
+        void CppEmitter::forRange(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            Expr from = value(n.a);
+            Expr to = value(n.b);
+            Expr step = n.c != kNoNode ? value(n.c) : Expr{"INT64_C(1)", CType::INT, false};
+            line_ = n.line;
+            for (const Expr* bound : {&from, &to, &step}) {
+                if (!isNumeric(bound->type)) {
+                    error(std::string("los límites de PARA deben ser numéricos, no ") + typeLabel(bound->type));
+                }
+            }
+            int sign = n.c != kNoNode ? literalSign(arena_, n.c) : 1;
+            if (sign == 2) error("el INCREMENTO de PARA no puede ser 0");
+            bool integral = from.type == CType::INT && step.type == CType::INT;
+            CType counter = integral ? CType::INT : CType::FLOAT;
+            std::string var = fresh(arena_.str(n.v.str));
+            std::string limit = temp("lim");
+            std::string increment = sign != 0 ? (integral ? step.code : real(step)) : temp("step");
+
+            line("{");
+            ++depth_;
+            line(std::string(cppType(counter)) + " " + var + " = " + (integral ? from.code : real(from)) + ";");
+            if (integral && to.type == CType::FLOAT) {
+                std::string raw = temp("to");
+                line("const double " + raw + " = " + to.code + ";");
+                if (sign == 0) line("const int64_t " + increment + " = " + step.code + ";");
+                line("const int64_t " + limit + " = rt::intLimit(" + raw + ", " + increment + ");");
+            } else {
+                line("const " + std::string(cppType(counter)) + " " + limit + " = " + (integral ? to.code : real(to)) +
+                     ";");
+                if (sign == 0) {
+                    line("const " + std::string(cppType(counter)) + " " + increment + " = " +
+                         (integral ? step.code : real(step)) + ";");
+                }
+            }
+            if (sign == 0) {
+                line("if (" + increment + " == 0) rt::fail(\"el INCREMENTO de PARA no puede ser 0\", " + site(n.line) +
+                     ");");
+            }
+            std::string test = sign > 0   ? var + " < " + limit
+                               : sign < 0 ? var + " > " + limit
+                                          : increment + " > 0 ? " + var + " < " + limit + " : " + var + " > " + limit;
+            line("for (; " + test + "; " + var + " += " + increment + ") {");
+            scopes_.emplace_back();
+            scopes_.back()[arena_.str(n.v.str)] = {counter, var, true};
+            ++loops_;
+            block(n.d);
+            --loops_;
+            scopes_.pop_back();
+            line("}");
+            --depth_;
+            line("}");
+        }
+
+        void CppEmitter::forEach(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            Expr collection = value(n.a);
+            line_ = n.line;
+            if (!isArray(collection.type)) unsupported("PARA CADA sobre un " + std::string(typeLabel(collection.type)));
+            CType element = elementOf(collection.type);
+            std::string items = temp("each");
+            std::string index = temp("k");
+            std::string var = fresh(arena_.str(n.v.str));
+            line("{");
+            ++depth_;
+            line("const " + std::string(cppType(collection.type)) + " " + items + " = " + collection.code + ";");
+            // Por índice y con la longitud actual, como FOREACH: el cuerpo puede añadir elementos
+            line("for (size_t " + index + " = 0; " + index + " < " + items + "->size(); ++" + index + ") {");
+            ++depth_;
+            line("const " + std::string(cppType(element)) + " " + var + " = (*" + items + ")[" + index + "];");
+            --depth_;
+            scopes_.emplace_back();
+            scopes_.back()[arena_.str(n.v.str)] = {element, var, true};
+            ++loops_;
+            block(n.d);
+            --loops_;
+            scopes_.pop_back();
+            line("}");
+            --depth_;
+            line("}");
+        }
+
+        // SELECCION como cadena de if: cada CASO compara con el sujeto (o es una guarda)
+        // y DEFECTO, esté donde esté, sólo se ejecuta si no encaja ninguno
+        void CppEmitter::switchStatement(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            Expr subject = value(n.a);
+            line_ = n.line;
+            std::string held = temp("sw");
+            line("{");
+            ++depth_;
+            line("const " + std::string(cppType(subject.type)) + " " + held + " = " + subject.code + ";");
+            NodeId defaultCase = kNoNode;
+            bool first = true;
+            const NodeId* cases = arena_.children(node);
+            for (uint32_t i = 0; i < arena_.childCount(node); ++i) {
+                const AstNode& c = arena_.node(cases[i]);
+                line_ = c.line;
+                if (c.a == kNoNode) {
+                    if (defaultCase != kNoNode) error("SELECCION con más de un DEFECTO");
+                    defaultCase = cases[i];
+                    continue;
+                }
+                std::string test = (c.flags & FLAG_GUARD)
+                                       ? condition(c.a)
+                                       : binary(OpKind::EQ, Expr{held, subject.type}, value(c.a), c.line).code;
+                line((first ? "if (" : "} else if (") + test + ") {");
+                block(cases[i]);
+                first = false;
+            }
+            if (defaultCase != kNoNode) {
+                line(first ? "{" : "} else {");
+                block(defaultCase);
+            }
+            if (!first || defaultCase != kNoNode) line("}");
+            --depth_;
+            line("}");
+        }
+
+        void CppEmitter::returnStatement(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            if (function_ == nullptr) unsupported("RETORNAR en el nivel superior");
+            if (n.a == kNoNode) {
+                if (function_->result != CType::VOID) {
+                    error(function_->name + " debe RETORNAR un " + typeLabel(function_->result));
+                }
+                line("return;");
+                return;
+            }
+            if (function_->result == CType::VOID) {
+                error("RETORNAR con valor en " + function_->name + ", que no declara su tipo de retorno");
+            }
+            line("return " + exprAs(n.a, function_->result, "el valor de RETORNAR").code + ";");
+        }
+
+        // Una expresión usada como valor (no puede ser una llamada sin resultado)
+        Expr CppEmitter::value(NodeId node) {
+            Expr e = expr(node);
+            if (e.type == CType::VOID) {
+                line_ = arena_.node(node).line;
+                error("una llamada sin valor de retorno no puede usarse como valor");
+            }
+            return e;
+        }
+
+        Expr CppEmitter::exprAs(NodeId node, CType expected, const std::string& what) {
+            Expr e = arena_.kind(node) == NodeKind::ARRAY_LIT && isArray(expected) ? arrayLiteral(node, expected)
+                                                                                      : value(node);
+            if (e.type != expected) {
+                // El VM no convierte: `VAR x: FLOAT = 1` guardaría (y mostraría) un INT
+                line_ = arena_.node(node).line;
+                error(what + " es " + typeLabel(expected) + " pero recibe un " + typeLabel(e.type));
+            }
+            return e;
+        }
+
+        std::string CppEmitter::condition(NodeId node) {
+            Expr e = value(node);
+            if (e.type == CType::BOOL) return e.code;
+            // Sólo NULO y FALSO son falsos, y ninguno de los dos tiene otro tipo aquí
+            return "(static_cast<void>(" + e.code + "), true)";
+        }
+
+        Expr CppEmitter::expr(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            line_ = n.line;
+            switch (n.kind) {
+                case NodeKind::INT_LIT:
+                    if (n.v.i < -(INT64_C(1) << 50) || n.v.i >= (INT64_C(1) << 50)) {
+                        error("el literal " + std::to_string(n.v.i) + " no cabe en un INT de 51 bits");
+                    }
+                    return {"INT64_C(" + std::to_string(n.v.i) + ")", CType::INT};
+                case NodeKind::FLOAT_LIT: return {floatLiteral(n.v.f), CType::FLOAT};
+                case NodeKind::BOOL_LIT: return {n.v.i != 0 ? "true" : "false", CType::BOOL};
+                case NodeKind::STRING_LIT: return {"std::string(" + quoted(arena_.str(n.v.str)) + ")", CType::STRING};
+                case NodeKind::NULL_LIT: unsupported("NULO");
+                case NodeKind::IDENT: {
+                    std::string identName = name(node);
+                    std::optional<Variable> var = lookup(identName);
+                    if (var) return {var->cpp, var->type};
+                    if (functions_.count(identName)) unsupported("usar una función como valor");
+                    error("'" + identName + "' no está declarada");
+                }
+                case NodeKind::UNARY: return unary(node);
+                case NodeKind::BINARY: {
+                    if (n.op == OpKind::AND || n.op == OpKind::OR) {
+                        // && y || conservan el cortocircuito y el orden de Y / O
+                        Expr left = value(n.a);
+                        Expr right = value(n.b);
+                        line_ = n.line;
+                        if (left.type != CType::BOOL || right.type != CType::BOOL) {
+                            unsupported(std::string(n.op == OpKind::AND ? "Y" : "O") + " entre " +
+                                        typeLabel(left.type) + " y " + typeLabel(right.type));
+                        }
+                        return {"(" + left.code + (n.op == OpKind::AND ? " && " : " || ") + right.code + ")",
+                                CType::BOOL, left.effects || right.effects};
+                    }
+                    Expr left = value(n.a);
+                    Expr right = value(n.b);
+                    return binary(n.op, left, right, n.line);
+                }
+                case NodeKind::COND_EXPR: {
+                    std::string cond = condition(n.a);
+                    Expr then = value(n.b);
+                    Expr otherwise = value(n.d);
+                    line_ = n.line;
+                    if (then.type != otherwise.type) {
+                        error(std::string("las dos ramas de SI ... ENTONCES ... SINO deben tener el mismo tipo (") +
+                              typeLabel(then.type) + " y " + typeLabel(otherwise.type) + ")");
+                    }
+                    return {"(" + cond + " ? " + then.code + " : " + otherwise.code + ")", then.type,
+                            then.effects || otherwise.effects};
+                }
+                case NodeKind::CALL: return call(node);
+                case NodeKind::INDEX: {
+                    Expr array = value(n.a);
+                    Expr index = value(n.b);
+                    line_ = n.line;
+                    if (!isArray(array.type)) unsupported("indexar un " + std::string(typeLabel(array.type)));
+                    if (index.type != CType::INT) {
+                        error(std::string("índice de tipo ") + typeLabel(index.type) + " no válido para ARRAY");
+                    }
+                    std::string s = site(n.line);
+                    return {ordered({array, index},
+                                    [&](const std::vector<std::string>& c) {
+                                        return "rt::at(" + c[0] + ", " + c[1] + ", " + s + ")";
+                                    }),
+                            elementOf(array.type), array.effects || index.effects};
+                }
+                case NodeKind::ARRAY_LIT: {
+                    // Sin tipo declarado, el ARRAY toma el de sus elementos (todos iguales)
+                    const NodeId* items = arena_.children(node);
+                    if (arena_.childCount(node) == 0) error("un ARRAY vacío necesita un tipo declarado (ARRAY<INT>)");
+                    CType element = value(items[0]).type;
+                    for (uint32_t i = 1; i < arena_.childCount(node); ++i) {
+                        if (value(items[i]).type != element) element = CType::VOID;
+                    }
+                    line_ = n.line;
+                    if (!isNumeric(element)) {
+                        unsupported("un ARRAY sin tipo cuyos elementos no son todos INT o todos FLOAT");
+                    }
+                    return arrayLiteral(node, element == CType::INT ? CType::INT_ARRAY : CType::FLOAT_ARRAY);
+                }
+                case NodeKind::ASSIGN: unsupported("una asignación dentro de una expresión");
+                case NodeKind::MAP_LIT: unsupported("MAP");
+                case NodeKind::MEMBER: unsupported("acceder a un campo");
+                default: unsupported("esta expresión");
+            }
+        }
+
+        Expr CppEmitter::unary(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            const AstNode& operand = arena_.node(n.a);
+            if (n.op == OpKind::NEG && operand.kind == NodeKind::INT_LIT) {
+                return {"INT64_C(" + std::to_string(-operand.v.i) + ")", CType::INT};
+            }
+            if (n.op == OpKind::NEG && operand.kind == NodeKind::FLOAT_LIT) {
+                return {floatLiteral(-operand.v.f), CType::FLOAT};
+            }
+            Expr e = value(n.a);
+            line_ = n.line;
+            if (n.op == OpKind::NOT) {
+                if (e.type == CType::BOOL) return {"(!" + e.code + ")", CType::BOOL, e.effects};
+                return {"(static_cast<void>(" + e.code + "), false)", CType::BOOL, e.effects};
+            }
+            if (e.type == CType::INT) return {"rt::neg(" + e.code + ", " + site(n.line) + ")", CType::INT, e.effects};
+            if (e.type == CType::FLOAT) return {"(-" + e.code + ")", CType::FLOAT, e.effects};
+            error(std::string("no se puede negar un valor de tipo ") + typeLabel(e.type));
+        }
+
+        Expr CppEmitter::binary(OpKind op, const Expr& left, const Expr& right, uint32_t line) {
+            line_ = line;
+            bool effects = left.effects || right.effects;
+            auto infix = [&](const char* symbol, bool toReal) {
+                Expr l = left;
+                Expr r = right;
+                return ordered({l, r}, [&](const std::vector<std::string>& c) {
+                    Expr a{c[0], l.type};
+                    Expr b{c[1], r.type};
+                    return "(" + (toReal ? real(a) : a.code) + " " + symbol + " " + (toReal ? real(b) : b.code) + ")";
+                });
+            };
+            auto helper = [&](const std::string& function, bool toReal) {
+                std::string s = site(line);
+                return ordered({left, right}, [&](const std::vector<std::string>& c) {
+                    Expr a{c[0], left.type};
+                    Expr b{c[1], right.type};
+                    return function + "(" + (toReal ? real(a) : a.code) + ", " + (toReal ? real(b) : b.code) + ", " + s +
+                           ")";
+                });
+            };
+            bool numeric = isNumeric(left.type) && isNumeric(right.type);
+            bool integral = left.type == CType::INT && right.type == CType::INT;
+            switch (op) {
+                case OpKind::ADD:
+                    if (left.type == CType::STRING || right.type == CType::STRING) {
+                        return {ordered({left, right},
+                                        [&](const std::vector<std::string>& c) {
+                                            return "(" + asString(Expr{c[0], left.type}) + " + " +
+                                                   asString(Expr{c[1], right.type}) + ")";
+                                        }),
+                                CType::STRING, effects};
+                    }
+                    [[fallthrough]];
+                case OpKind::SUB:
+                case OpKind::MUL:
+                case OpKind::DIV:
+                case OpKind::MOD: {
+                    static const char* symbols[] = {"", "+", "-", "*", "/", "%"};
+                    const char* symbol = symbols[static_cast<int>(op)];
+                    if (!numeric) {
+                        error(std::string("operación '") + symbol + "' no válida entre " + typeLabel(left.type) +
+                              " y " + typeLabel(right.type));
+                    }
+                    if (integral) {
+                        static const char* functions[] = {"", "rt::add", "rt::sub", "rt::mul", "rt::div", "rt::mod"};
+                        return {helper(functions[static_cast<int>(op)], false), CType::INT, effects};
+                    }
+                    if (op == OpKind::DIV) return {helper("rt::fdiv", true), CType::FLOAT, effects};
+                    if (op == OpKind::MOD) return {helper("rt::fmod", true), CType::FLOAT, effects};
+                    return {infix(symbol, true), CType::FLOAT, effects};
+                }
+                case OpKind::EQ:
+                case OpKind::NE: {
+                    const char* symbol = op == OpKind::EQ ? "==" : "!=";
+                    if (numeric) return {infix(symbol, !integral), CType::BOOL, effects};
+                    if (left.type == right.type) return {infix(symbol, false), CType::BOOL, effects};
+                    // Valores de tipos distintos nunca son iguales (ARRAY: se compara la identidad)
+                    return {ordered({left, right},
+                                    [&](const std::vector<std::string>& c) {
+                                        return "(static_cast<void>(" + c[0] + "), static_cast<void>(" + c[1] + "), " +
+                                               (op == OpKind::EQ ? "false" : "true") + ")";
+                                    }),
+                            CType::BOOL, effects};
+                }
+                case OpKind::LT:
+                case OpKind::LE:
+                case OpKind::GT:
+                case OpKind::GE: {
+                    const char* symbol = op == OpKind::LT ? "<" : op == OpKind::LE ? "<=" : op == OpKind::GT ? ">" : ">=";
+                    if (numeric) return {infix(symbol, !integral), CType::BOOL, effects};
+                    if (left.type == CType::STRING && right.type == CType::STRING) {
+                        return {infix(symbol, false), CType::BOOL, effects};
+                    }
+                    error(std::string("no se pueden comparar ") + typeLabel(left.type) + " y " + typeLabel(right.type));
+                }
+                default: unsupported("este operador");
+            }
+        }
+
+        Expr CppEmitter::arrayLiteral(NodeId node, CType type) {
+            const NodeId* items = arena_.children(node);
+            CType element = elementOf(type);
+            std::string code = type == CType::INT_ARRAY ? "rt::ints({" : "rt::floats({";
+            bool effects = false;
+            for (uint32_t i = 0; i < arena_.childCount(node); ++i) {
+                // Entre llaves los elementos se evalúan en orden
+                Expr item = value(items[i]);
+                if (item.type != element && !(element == CType::FLOAT && item.type == CType::INT)) {
+                    line_ = arena_.node(items[i]).line;
+                    error("no se puede guardar un " + std::string(typeLabel(item.type)) + " en un " + typeLabel(type));
+                }
+                if (i > 0) code += ", ";
+                code += element == CType::FLOAT ? real(item) : item.code;
+                effects = effects || item.effects;
+            }
+            return {code + "})", type, effects};
+        }
+
+        Expr CppEmitter::call(NodeId node) {
+            const AstNode& n = arena_.node(node);
+            std::vector<NodeId> args(arena_.children(node), arena_.children(node) + arena_.childCount(node));
+            const AstNode& callee = arena_.node(n.a);
+            if (callee.kind == NodeKind::MEMBER) {
+                Expr object = value(callee.a);
+                return method(object, name(n.a), args, n.line);
+            }
+            if (callee.kind != NodeKind::IDENT) unsupported("llamar al resultado de una expresión");
+            std::string calleeName = name(n.a);
+            if (lookup(calleeName)) unsupported("llamar a una variable");
+            auto it = functions_.find(calleeName);
+            if (it == functions_.end()) return builtin(calleeName, args, n.line);
+
+            const Function& fn = it->second;
+            if (args.size() != fn.params.size()) {
+                error(fn.name + " espera " + std::to_string(fn.params.size()) + " argumentos y recibe " +
+                      std::to_string(args.size()));
+            }
+            std::vector<Expr> values;
+            for (size_t i = 0; i < args.size(); ++i) {
+                values.push_back(exprAs(args[i], fn.params[i], "el argumento " + std::to_string(i + 1) + " de " + fn.name));
+            }
+            line_ = n.line;
+            std::string code = ordered(values, [&](const std::vector<std::string>& c) {
+                std::string list;
+                for (size_t i = 0; i < c.size(); ++i) list += (i > 0 ? ", " : "") + c[i];
+                return fn.cpp + "(" + list + ")";
+            });
+            return {code, fn.result, true};
+        }
+
+        Expr CppEmitter::builtin(const std::string& function, std::vector<NodeId> args, uint32_t line) {
+            auto arity = [&](size_t count) {
+                if (args.size() != count) {
+                    line_ = line;
+                    error(function + " espera " + std::to_string(count) + (count == 1 ? " argumento" : " argumentos"));
+                }
+            };
+            std::vector<Expr> values;
+            if (function == "MOSTRAR") {
+                for (NodeId arg : args) values.push_back(value(arg));
+                line_ = line;
+                return {ordered(values,
+                                [&](const std::vector<std::string>& c) {
+                                    std::string list;
+                                    for (size_t i = 0; i < c.size(); ++i) list += (i > 0 ? ", " : "") + c[i];
+                                    return "rt::show(" + list + ")";
+                                }),
+                        CType::VOID, true};
+            }
+            if (function == "AGREGAR") {
+                arity(2);
+                Expr object = value(args[0]);
+                return method(object, function, {args[1]}, line);
+            }
+            if (function == "LONGITUD" || function == "RAIZ" || function == "ABS" || function == "CADENA" ||
+                function == "ENTERO" || function == "DECIMAL" || function == "TIPO") {
+                arity(1);
+                Expr x = value(args[0]);
+                line_ = line;
+                std::string s = site(line);
+                if (function == "LONGITUD") {
+                    if (x.type != CType::STRING && !isArray(x.type)) {
+                        error(std::string("LONGITUD no admite valores de tipo ") + typeLabel(x.type));
+                    }
+                    return {"rt::length(" + x.code + ")", CType::INT, x.effects};
+                }
+                if (function == "CADENA") return {asString(x), CType::STRING, x.effects};
+                if (function == "TIPO") {
+                    std::string label = isArray(x.type) ? "ARRAY" : typeLabel(x.type);
+                    std::string literal = "std::string(\"" + label + "\")";
+                    if (x.effects) literal = "(static_cast<void>(" + x.code + "), " + literal + ")";
+                    return {literal, CType::STRING, x.effects};
+                }
+                if (function == "ENTERO") {
+                    if (x.type == CType::INT) return x;
+                    if (x.type == CType::BOOL) return {"static_cast<int64_t>(" + x.code + ")", CType::INT, x.effects};
+                    if (x.type == CType::FLOAT || x.type == CType::STRING) {
+                        return {"rt::entero(" + x.code + ", " + s + ")", CType::INT, x.effects};
+                    }
+                    error("no se puede convertir ARRAY a INT");
+                }
+                if (function == "DECIMAL") {
+                    if (isNumeric(x.type)) return {real(x), CType::FLOAT, x.effects};
+                    if (x.type == CType::STRING) return {"rt::decimal(" + x.code + ", " + s + ")", CType::FLOAT, x.effects};
+                    error(std::string("no se puede convertir ") + (isArray(x.type) ? "ARRAY" : typeLabel(x.type)) +
+                          " a FLOAT");
+                }
+                if (!isNumeric(x.type)) error(function + " espera un número, no " + typeLabel(x.type));
+                if (function == "ABS") return {"rt::abs(" + x.code + ")", x.type, x.effects};
+                // RAIZ: la comprobación da el mensaje del VM; la raíz la calcula la biblioteca math
+                usesMath_ = true;
+                return {"AdvancedOperations::sqrt(rt::notNegative(" + real(x) + ", " + s + "))", CType::FLOAT,
+                        x.effects};
+            }
+            if (function == "POTENCIA") {
+                arity(2);
+                Expr base = value(args[0]);
+                Expr exponent = value(args[1]);
+                line_ = line;
+                if (!isNumeric(base.type) || !isNumeric(exponent.type)) {
+                    error(std::string("POTENCIA espera un número, no ") +
+                          typeLabel(isNumeric(base.type) ? exponent.type : base.type));
+                }
+                bool effects = base.effects || exponent.effects;
+                if (base.type == CType::INT && exponent.type == CType::INT) {
+                    // El tipo del resultado depende del signo del exponente: sólo se admite uno literal
+                    if (literalSign(arena_, args[1]) != 1 && literalSign(arena_, args[1]) != 2) {
+                        unsupported("POTENCIA entre INT sin un exponente literal no negativo (usa un FLOAT)");
+                    }
+                    std::string s = site(line);
+                    return {"rt::ipow(" + base.code + ", " + exponent.code + ", " + s + ")", CType::INT, effects};
+                }
+                return {ordered({base, exponent},
+                                [&](const std::vector<std::string>& c) {
+                                    return "std::pow(" + real(Expr{c[0], base.type}) + ", " +
+                                           real(Expr{c[1], exponent.type}) + ")";
+                                }),
+                        CType::FLOAT, effects};
+            }
+            line_ = line;
+            if (function == "ESPERAR" || function == "LANZAR") unsupported(function);
+            error("'" + function + "' no está declarada");
+        }
+
+        Expr CppEmitter::method(const Expr& object, const std::string& methodName, std::vector<NodeId> args,
+                                uint32_t line) {
+            std::vector<Expr> values;
+            for (NodeId arg : args) values.push_back(value(arg));
+            line_ = line;
+            auto noArgs = [&]() {
+                if (!values.empty()) error(methodName + " no recibe argumentos");
+            };
+            bool effects = object.effects;
+            for (const Expr& v : values) effects = effects || v.effects;
+            if (object.type == CType::STRING || isArray(object.type)) {
+                if (methodName == "LONGITUD") {
+                    noArgs();
+                    return {"rt::length(" + object.code + ")", CType::INT, effects};
+                }
+                if (methodName == "ES_VACIO" || methodName == "NO_ES_VACIO") {
+                    noArgs();
+                    return {"(rt::length(" + object.code + ")" + (methodName == "ES_VACIO" ? " == 0)" : " != 0)"),
+                            CType::BOOL, effects};
+                }
+            }
+            if (object.type == CType::STRING && (methodName == "MAYUSCULAS" || methodName == "MINUSCULAS")) {
+                noArgs();
+                usesString_ = true;
+                return {std::string("TextTransformation::") + (methodName == "MAYUSCULAS" ? "toUpper(" : "toLower(") +
+                            object.code + ")",
+                        CType::STRING, effects};
+            }
+            if (isArray(object.type)) {
+                CType element = elementOf(object.type);
+                if (methodName == "AGREGAR" || methodName == "CONTIENE") {
+                    if (values.size() != 1) error(methodName + " espera 1 argumento");
+                    Expr item = values[0];
+                    if (methodName == "CONTIENE") {
+                        if (!isNumeric(item.type)) {
+                            return {"(static_cast<void>(" + object.code + "), static_cast<void>(" + item.code +
+                                        "), false)",
+                                    CType::BOOL, effects};
+                        }
+                        return {ordered({object, item},
+                                        [&](const std::vector<std::string>& c) {
+                                            Expr x{c[1], item.type};
+                                            return "rt::contains(" + c[0] + ", " +
+                                                   (element == CType::FLOAT ? real(x) : x.code) + ")";
+                                        }),
+                                CType::BOOL, effects};
+                    }
+                    if (item.type != element && !(element == CType::FLOAT && item.type == CType::INT)) {
+                        error("no se puede guardar un " + std::string(typeLabel(item.type)) + " en un " +
+                              typeLabel(object.type));
+                    }
+                    return {ordered({object, item},
+                                    [&](const std::vector<std::string>& c) {
+                                        Expr x{c[1], item.type};
+                                        return "rt::push(" + c[0] + ", " + (element == CType::FLOAT ? real(x) : x.code) +
+                                               ")";
+                                    }),
+                            object.type, true};
+                }
+                if (object.type == CType::INT_ARRAY &&
+                    (methodName == "SUMA" || methodName == "MINIMO" || methodName == "MAXIMO")) {
+                    noArgs();
+                    std::string s = site(line);
+                    if (methodName == "SUMA") return {"rt::sum(" + object.code + ", " + s + ")", CType::INT, effects};
+                    return {"rt::extreme(" + object.code + ", " + (methodName == "MAXIMO" ? "true" : "false") + ", " +
+                                s + ")",
+                            CType::INT, effects};
+                }
+            }
+            unsupported("el método " + methodName + " de " + typeLabel(object.type));
+        }
+
+    } // namespace
+
+    CppProgram emitCpp(const AstArena& arena, NodeId program, const std::string& sourceName) {
+        CppEmitter emitter(arena);
+        return emitter.run(program, sourceName);
+    }
+
+} // namespace mc_core
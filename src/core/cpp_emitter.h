@@ -0,0 +1,41 @@
+#ifndef CPP_EMITTER_H
+#define CPP_EMITTER_H
+
+#include "ast.h"
+#include <string>
+#include <vector>
+
+namespace mc_core {
+
+    // Programa de MC++ traducido a C++ por emitCpp
+    struct CppProgram {
+        std::string source;                  // Unidad de traducción completa, con su main()
+        std::vector<std::string> libraries;  // Fuentes a enlazar, relativas a src/libraries
+    };
+
+    /**
+     * Traduce a C++ un programa de MC++ con tipos estáticos (modo compile --emit=cpp).
+     *
+     * Cada variable, parámetro y resultado tiene un tipo fijo: el declarado o, en una
+     * VAR sin tipo, el de su valor inicial. Se admiten INT (int64_t), FLOAT (double),
+     * BOOL, STRING (std::string) y ARRAY<INT> / ARRAY<FLOAT> (compartidos por
+     * referencia, como en el VM); las sentencias SI, MIENTRAS, PARA, PARA CADA,
+     * ROMPER, CONTINUAR y RETORNAR; las funciones de nivel superior con parámetros
+     * tipados; y las integradas numéricas y de cadena. RAIZ, MAYUSCULAS y MINUSCULAS
+     * llaman directamente a src/libraries (math y string) en lugar de pasar por el
+     * despacho dinámico del intérprete.
+     *
+     * El programa compilado da la misma salida y los mismos errores (con su línea)
+     * que el intérprete, salvo en dos casos: un INT que no cabe en 51 bits es un error
+     * en lugar de pasar a FLOAT, y una VAR declarada sin valor empieza en 0, 0.0,
+     * FALSO, "" o un ARRAY vacío en lugar de NULO. Todo lo que no se puede tipar
+     * estáticamente (CLASE, MAP, NULO, valores que cambian de tipo...) se rechaza con
+     * un CompileError que indica la línea.
+     *
+     * @param sourceName Nombre del fuente, sólo para el comentario de cabecera.
+     */
+    CppProgram emitCpp(const AstArena& arena, NodeId program, const std::string& sourceName);
+
+} // namespace mc_core
+
+#endif // CPP_EMITTER_H
@@ -0,0 +1,492 @@
+#include "heap.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace mc_core {
+
+    // Cabecera de bloque; ocupa las primeras líneas del propio bloque
+    struct Heap::Block {
+        Heap* heap;
+        uint32_t freeLines;
+        bool dirty;                                      // Está en dirtyBlocks_
+        uint16_t lineObjects[kLinesPerBlock];            // Objetos que ocupan cada línea
+        uint8_t cards[kLinesPerBlock];                   // Tarjeta sucia por línea
+        uint64_t starts[kBlockSize / kGranuleSize / 64]; // Inicio de objeto por gránulo
+    };
+
+    namespace {
+
+        constexpr size_t kHeaderLines = (sizeof(Heap::Block) + Heap::kLineSize - 1) / Heap::kLineSize;
+
+        // Bloques vacíos que se conservan tras una recolección completa en vez de liberarse
+        constexpr size_t kSpareBlocks = 8;
+
+        // Protege las tarjetas y dirtyBlocks_ cuando varios hilos ejecutan PARA PARALELO
+        std::mutex rememberMutex;
+
+        uint64_t nowNanoseconds() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        size_t alignToGranule(size_t size) {
+            return (size + Heap::kGranuleSize - 1) & ~(Heap::kGranuleSize - 1);
+        }
+
+        // Tamaño de la cabecera del objeto dentro del bloque
+        size_t objectSize(ObjType type) {
+            switch (type) {
+                case ObjType::STRING: return alignToGranule(sizeof(ObjString));
+                case ObjType::ARRAY: return alignToGranule(sizeof(ObjArray));
+                case ObjType::MAP: return alignToGranule(sizeof(ObjMap));
+                case ObjType::FUNCTION: return alignToGranule(sizeof(ObjFunction));
+                case ObjType::NATIVE: return alignToGranule(sizeof(ObjNative));
+                case ObjType::CLASS: return alignToGranule(sizeof(ObjClass));
+                case ObjType::INSTANCE: return alignToGranule(sizeof(ObjInstance));
+                case ObjType::MODULE: return alignToGranule(sizeof(ObjModule));
+                case ObjType::TYPED_ARRAY: return alignToGranule(sizeof(ObjTypedArray));
+            }
+            return 0;
+        }
+
+        // Bytes que se contabilizan para el objeto: cabecera más el texto de las cadenas
+        // y el búfer de los arreglos tipados. Una cuerda cuenta sólo su nodo: el búfer
+        // que reserva al aplanarse no se conoce al crearla
+        size_t objectBytes(const Obj* object) {
+            size_t size = objectSize(object->type);
+            if (object->type == ObjType::STRING) {
+                const ObjString* string = static_cast<const ObjString*>(object);
+                ObjString::Shape shape = string->shape();
+                if (shape != ObjString::Shape::ROPE && shape != ObjString::Shape::FLATTENED) size += string->length();
+            }
+            if (object->type == ObjType::TYPED_ARRAY) size += static_cast<const ObjTypedArray*>(object)->size() * 8;
+            return size;
+        }
+
+        void destruct(Obj* object) {
+            switch (object->type) {
+                case ObjType::STRING: static_cast<ObjString*>(object)->~ObjString(); break;
+                case ObjType::ARRAY: static_cast<ObjArray*>(object)->~ObjArray(); break;
+                case ObjType::MAP: static_cast<ObjMap*>(object)->~ObjMap(); break;
+                case ObjType::FUNCTION: static_cast<ObjFunction*>(object)->~ObjFunction(); break;
+                case ObjType::NATIVE: static_cast<ObjNative*>(object)->~ObjNative(); break;
+                case ObjType::CLASS: static_cast<ObjClass*>(object)->~ObjClass(); break;
+                case ObjType::INSTANCE: static_cast<ObjInstance*>(object)->~ObjInstance(); break;
+                case ObjType::MODULE: static_cast<ObjModule*>(object)->~ObjModule(); break;
+                case ObjType::TYPED_ARRAY: static_cast<ObjTypedArray*>(object)->~ObjTypedArray(); break;
+            }
+        }
+
+        Heap::Block* blockOf(const void* address) {
+            return reinterpret_cast<Heap::Block*>(reinterpret_cast<uintptr_t>(address) &
+                                                  ~static_cast<uintptr_t>(Heap::kBlockSize - 1));
+        }
+
+        size_t offsetInBlock(const void* address) {
+            return reinterpret_cast<uintptr_t>(address) & (Heap::kBlockSize - 1);
+        }
+
+        // Recorre los objetos que empiezan en los gránulos [first, last) de un bloque
+        template <typename Fn>
+        void forEachObject(Heap::Block* block, const uint64_t* starts, size_t first, size_t last, Fn fn) {
+            char* base = reinterpret_cast<char*>(block);
+            for (size_t word = first / 64; word * 64 < last; ++word) {
+                uint64_t bits = starts[word];
+                while (bits != 0) {
+                    size_t granule = word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+                    bits &= bits - 1;
+                    if (granule < first || granule >= last) continue;
+                    fn(reinterpret_cast<Obj*>(base + granule * Heap::kGranuleSize));
+                }
+            }
+        }
+
+        // Llama a fn con cada objeto al que apunta `object`
+        template <typename Fn>
+        void forEachChild(Obj* object, Fn fn) {
+            auto value = [&fn](Value v) {
+                if (v.isObj()) fn(v.asObj());
+            };
+            switch (object->type) {
+                case ObjType::ARRAY:
+                    for (Value item : static_cast<ObjArray*>(object)->items) value(item);
+                    break;
+                case ObjType::MAP:
+                    for (const auto& entry : static_cast<ObjMap*>(object)->entries) {
+                        value(entry.first);
+                        value(entry.second);
+                    }
+                    break;
+                case ObjType::CLASS: {
+                    ObjClass* klass = static_cast<ObjClass*>(object);
+                    if (klass->base != nullptr) fn(klass->base);
+                    for (const auto& method : klass->methods) value(method.second);
+                    value(klass->constructor);
+                    break;
+                }
+                case ObjType::INSTANCE: {
+                    ObjInstance* instance = static_cast<ObjInstance*>(object);
+                    fn(instance->klass);
+                    for (Value field : instance->fields) value(field);
+                    break;
+                }
+                case ObjType::MODULE:
+                    for (const auto& member : static_cast<ObjModule*>(object)->members) value(member.second);
+                    break;
+                case ObjType::STRING: {
+                    ObjString* string = static_cast<ObjString*>(object);
+                    if (string->isRope()) {
+                        fn(string->left());
+                        fn(string->right());
+                    }
+                    break;
+                }
+                case ObjType::FUNCTION:   // Las constantes de los prototipos son raíces del VM
+                case ObjType::NATIVE:
+                case ObjType::TYPED_ARRAY:  // Sólo números sin etiquetar
+                    break;
+            }
+        }
+
+    } // namespace
+
+    Heap::~Heap() {
+        for (Block* block : blocks_) {
+            forEachObject(block, block->starts, 0, kBlockSize / kGranuleSize, destruct);
+            std::free(block);
+        }
+    }
+
+    GcStats Heap::stats() const {
+        return stats_;
+    }
+
+    // -------------------------------------
+    // Asignación
+    // -------------------------------------
+
+    void* Heap::allocateRaw(size_t size) {
+        size = alignToGranule(size);
+        char* memory = cursor_;
+        if (static_cast<size_t>(limit_ - cursor_) < size) memory = static_cast<char*>(allocateSlow(size));
+        cursor_ = memory + size;
+        occupy(memory, size, 1);
+        return memory;
+    }
+
+    void* Heap::allocateSlow(size_t size) {
+        // Busca el siguiente hueco de líneas libres donde quepa el objeto
+        for (;;) {
+            if (current_ == nullptr) {
+                current_ = nextRecyclable_ < recyclable_.size() ? recyclable_[nextRecyclable_++] : newBlock();
+                nextLine_ = kHeaderLines;
+            }
+            size_t line = nextLine_;
+            while (line < kLinesPerBlock && current_->lineObjects[line] != 0) ++line;
+            size_t end = line;
+            while (end < kLinesPerBlock && current_->lineObjects[end] == 0) ++end;
+            nextLine_ = end;
+            if ((end - line) * kLineSize >= size) {
+                char* base = reinterpret_cast<char*>(current_);
+                cursor_ = base + line * kLineSize;
+                limit_ = base + end * kLineSize;
+                return cursor_;
+            }
+            if (end >= kLinesPerBlock) current_ = nullptr;
+        }
+    }
+
+    void Heap::releaseRaw(void* memory, size_t size) {
+        occupy(memory, alignToGranule(size), -1);
+    }
+
+    void Heap::track(Obj* object) {
+        size_t bytes = objectBytes(object);
+        young_.push_back(object);
+        ++stats_.objectCount;
+        stats_.liveBytes += bytes;
+        stats_.allocatedBytes += bytes;
+        nurseryBytes_ += bytes;
+        if (nurseryBytes_ >= nurseryLimit_) collectionRequested_ = true;
+    }
+
+    Heap::Block* Heap::newBlock() {
+        void* memory = std::aligned_alloc(kBlockSize, kBlockSize);
+        if (memory == nullptr) throw std::bad_alloc();
+        Block* block = new (memory) Block();
+        block->heap = this;
+        for (size_t line = 0; line < kHeaderLines; ++line) block->lineObjects[line] = 1;
+        block->freeLines = static_cast<uint32_t>(kLinesPerBlock - kHeaderLines);
+        blocks_.push_back(block);
+        stats_.heapBytes += kBlockSize;
+        return block;
+    }
+
+    void Heap::occupy(void* memory, size_t size, int delta) {
+        Block* block = blockOf(memory);
+        size_t offset = offsetInBlock(memory);
+        for (size_t line = offset / kLineSize; line <= (offset + size - 1) / kLineSize; ++line) {
+            if (delta > 0) {
+                if (block->lineObjects[line]++ == 0) --block->freeLines;
+            } else if (--block->lineObjects[line] == 0) {
+                ++block->freeLines;
+            }
+        }
+        size_t granule = offset / kGranuleSize;
+        uint64_t bit = uint64_t(1) << (granule % 64);
+        if (delta > 0) {
+            block->starts[granule / 64] |= bit;
+        } else {
+            block->starts[granule / 64] &= ~bit;
+        }
+    }
+
+    // -------------------------------------
+    // Cadenas
+    // -------------------------------------
+
+    ObjString* Heap::intern(std::string_view text) {
+        const Heap* table = symbolSource_ != nullptr ? symbolSource_ : this;
+        auto it = table->symbols_.find(text);
+        if (it != table->symbols_.end()) return it->second;
+        ObjString* string = newString(text);
+        if (symbolSource_ == nullptr) {
+            string->interned = true;
+            symbols_.emplace(string->view(), string);
+        }
+        return string;
+    }
+
+    ObjString* Heap::intern(ObjString* string) {
+        if (string->interned) return string;
+        const Heap* table = symbolSource_ != nullptr ? symbolSource_ : this;
+        auto it = table->symbols_.find(string->view());
+        if (it != table->symbols_.end()) return it->second;
+        if (symbolSource_ == nullptr) {
+            string->interned = true;
+            symbols_.emplace(string->view(), string);
+        }
+        return string;
+    }
+
+    ObjString* Heap::concat(ObjString* a, ObjString* b) {
+        if (a->length() == 0) return b;
+        if (b->length() == 0) return a;
+        size_t length = a->length() + b->length();
+        if (length <= kRopeLeafBytes) {
+            char text[kRopeLeafBytes];
+            std::string_view left = a->view();
+            std::string_view right = b->view();
+            std::memcpy(text, left.data(), left.size());
+            std::memcpy(text + left.size(), right.data(), right.size());
+            return newString(std::string_view(text, length));
+        }
+        if (a->isRope() && b->length() < kRopeLeafBytes) {
+            ObjString* tail = a->right();
+            if (!tail->isRope() && tail->length() + b->length() <= kRopeLeafBytes) {
+                return allocate<ObjString>(a->left(), concat(tail, b));
+            }
+        }
+        return allocate<ObjString>(a, b);
+    }
+
+    // -------------------------------------
+    // Recolección
+    // -------------------------------------
+
+    void Heap::rememberWrite(Obj* owner, Obj* value) {
+        Block* block = blockOf(owner);
+        // Las recolecciones de un heap de hilo no recorren los objetos de otros heaps
+        Heap* source = blockOf(value)->heap;
+        if (source->threadLocal_ && source != block->heap) {
+            publish(value);
+            return;
+        }
+        size_t line = offsetInBlock(owner) / kLineSize;
+        if (__atomic_load_n(&block->cards[line], __ATOMIC_RELAXED) != 0) return;
+        std::lock_guard<std::mutex> lock(rememberMutex);
+        __atomic_store_n(&block->cards[line], uint8_t(1), __ATOMIC_RELAXED);
+        if (!block->dirty) {
+            block->dirty = true;
+            block->heap->dirtyBlocks_.push_back(block);
+        }
+    }
+
+    void Heap::publish(Obj* object) {
+        if (object->old) return;
+        thread_local std::vector<Obj*> pending;
+        object->old = true;
+        pending.push_back(object);
+        while (!pending.empty()) {
+            Obj* next = pending.back();
+            pending.pop_back();
+            forEachChild(next, [](Obj* child) {
+                if (child->old) return;
+                child->old = true;
+                pending.push_back(child);
+            });
+        }
+    }
+
+    void Heap::adopt(Heap& other) {
+        for (Block* block : other.blocks_) {
+            block->heap = this;
+            blocks_.push_back(block);
+        }
+        young_.insert(young_.end(), other.young_.begin(), other.young_.end());
+        dirtyBlocks_.insert(dirtyBlocks_.end(), other.dirtyBlocks_.begin(), other.dirtyBlocks_.end());
+        stats_.heapBytes += other.stats_.heapBytes;
+        stats_.liveBytes += other.stats_.liveBytes;
+        stats_.objectCount += other.stats_.objectCount;
+        stats_.allocatedBytes += other.stats_.allocatedBytes;
+        stats_.promotedBytes += other.stats_.promotedBytes;
+        stats_.minorCollections += other.stats_.minorCollections;
+        stats_.totalPauseMs += other.stats_.totalPauseMs;
+        stats_.maxPauseMs = std::max(stats_.maxPauseMs, other.stats_.maxPauseMs);
+        nurseryBytes_ += other.nurseryBytes_;
+        oldBytes_ += other.oldBytes_;
+        if (nurseryBytes_ >= nurseryLimit_) collectionRequested_ = true;
+        if (oldBytes_ >= majorThreshold_) collectionRequested_ = fullRequested_ = true;
+
+        other.blocks_.clear();
+        other.young_.clear();
+        other.dirtyBlocks_.clear();
+        other.stats_ = GcStats{};
+        other.oldBytes_ = 0;
+        other.resetAllocator();
+    }
+
+    void Heap::beginCollection(bool full) {
+        collectionStart_ = nowNanoseconds();
+        fullCollection_ = full;
+        gray_.clear();
+    }
+
+    void Heap::finishCollection() {
+        // En una recolección menor los objetos viejos de las tarjetas sucias son raíces
+        if (!fullCollection_) scanDirtyCards();
+        for (Block* block : dirtyBlocks_) {
+            std::fill(block->cards, block->cards + kLinesPerBlock, 0);
+            block->dirty = false;
+        }
+        dirtyBlocks_.clear();
+
+        while (!gray_.empty()) {
+            Obj* object = gray_.back();
+            gray_.pop_back();
+            traceChildren(object);
+        }
+
+        if (fullCollection_) {
+            sweepAll();
+            ++stats_.majorCollections;
+        } else {
+            sweepYoung();
+            ++stats_.minorCollections;
+        }
+        resetAllocator();
+
+        double pause = static_cast<double>(nowNanoseconds() - collectionStart_) / 1e6;
+        stats_.lastPauseMs = pause;
+        stats_.maxPauseMs = std::max(stats_.maxPauseMs, pause);
+        stats_.totalPauseMs += pause;
+    }
+
+    void Heap::traceChildren(Obj* object) {
+        forEachChild(object, [this](Obj* child) { markObject(child); });
+    }
+
+    void Heap::scanDirtyCards() {
+        constexpr size_t kGranulesPerLine = kLineSize / kGranuleSize;
+        for (Block* block : dirtyBlocks_) {
+            for (size_t line = kHeaderLines; line < kLinesPerBlock; ++line) {
+                if (block->cards[line] == 0) continue;
+                forEachObject(block, block->starts, line * kGranulesPerLine, (line + 1) * kGranulesPerLine,
+                              [this](Obj* object) {
+                                  if (object->old) traceChildren(object);
+                              });
+            }
+        }
+    }
+
+    void Heap::sweepYoung() {
+        for (Obj* object : young_) {
+            // Los viejos de young_ son los publicados desde la última recolección
+            if (object->marked || object->old) {
+                size_t bytes = objectBytes(object);
+                object->marked = false;
+                object->old = true;
+                stats_.promotedBytes += bytes;
+                oldBytes_ += bytes;
+            } else {
+                destroy(object);
+            }
+        }
+        young_.clear();
+        // Un heap de hilo pasa su generación vieja al principal (adopt), que la recolecta
+        if (oldBytes_ >= majorThreshold_ && !threadLocal_) fullRequested_ = true;
+    }
+
+    void Heap::sweepAll() {
+        for (Block* block : blocks_) {
+            forEachObject(block, block->starts, 0, kBlockSize / kGranuleSize, [this](Obj* object) {
+                if (!object->marked) {
+                    destroy(object);
+                    return;
+                }
+                object->marked = false;
+                if (!object->old) {
+                    object->old = true;
+                    stats_.promotedBytes += objectBytes(object);
+                }
+            });
+        }
+        young_.clear();
+
+        // Se devuelven al sistema los bloques vacíos que sobran
+        size_t spare = 0;
+        auto empty = [&spare](Block* block) {
+            if (block->freeLines != kLinesPerBlock - kHeaderLines || ++spare <= kSpareBlocks) return false;
+            std::free(block);
+            return true;
+        };
+        size_t before = blocks_.size();
+        blocks_.erase(std::remove_if(blocks_.begin(), blocks_.end(), empty), blocks_.end());
+        stats_.heapBytes -= (before - blocks_.size()) * kBlockSize;
+
+        oldBytes_ = stats_.liveBytes;
+        majorThreshold_ = std::max(kMinMajorBytes, oldBytes_ * 2);
+        fullRequested_ = false;
+    }
+
+    void Heap::destroy(Obj* object) {
+        size_t bytes = objectBytes(object);
+        size_t size = objectSize(object->type);
+        if (object->type == ObjType::STRING && static_cast<ObjString*>(object)->interned) {
+            symbols_.erase(static_cast<ObjString*>(object)->view());
+        }
+        destruct(object);
+        occupy(object, size, -1);
+        stats_.liveBytes -= bytes;
+        --stats_.objectCount;
+    }
+
+    void Heap::resetAllocator() {
+        // Tras recolectar se vuelve a asignar desde los huecos de todos los bloques
+        recyclable_.clear();
+        for (Block* block : blocks_) {
+            if (block->freeLines > 0) recyclable_.push_back(block);
+        }
+        nextRecyclable_ = 0;
+        current_ = nullptr;
+        cursor_ = nullptr;
+        limit_ = nullptr;
+        nurseryBytes_ = 0;
+        collectionRequested_ = fullRequested_;
+    }
+
+} // namespace mc_core
@@ -0,0 +1,204 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "object.h"
+#include "value.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mc_core {
+
+    // Estadísticas del recolector de basura
+    struct GcStats {
+        size_t heapBytes = 0;            // Memoria reservada en bloques
+        size_t liveBytes = 0;            // Bytes ocupados por objetos (cabeceras + cadenas al crearse)
+        size_t objectCount = 0;
+        uint64_t minorCollections = 0;
+        uint64_t majorCollections = 0;
+        double lastPauseMs = 0.0;
+        double maxPauseMs = 0.0;
+        double totalPauseMs = 0.0;
+        uint64_t allocatedBytes = 0;     // Total asignado en la generación joven
+        uint64_t promotedBytes = 0;      // Total que sobrevivió y pasó a la generación vieja
+
+        // Fracción de lo asignado que llega a la generación vieja
+        double promotionRate() const {
+            return allocatedBytes == 0 ? 0.0 : static_cast<double>(promotedBytes) / static_cast<double>(allocatedBytes);
+        }
+    };
+
+    /**
+     * Heap de objetos de MC++ con recolección de basura generacional y precisa.
+     *
+     * Los objetos se asignan con un puntero de avance ("bump") dentro de bloques de
+     * 32 KB divididos en líneas de 128 bytes. Cada línea cuenta los objetos que la
+     * ocupan; los huecos de líneas libres se reutilizan tras cada recolección (estilo
+     * "mark-region"). Los objetos no se mueven nunca, así que los punteros que guarda
+     * el VM (registros, constantes, marcos) siguen siendo válidos.
+     *
+     *  - Generación joven: los objetos creados desde la última recolección. Una
+     *    recolección menor marca sólo los jóvenes alcanzables desde las raíces y desde
+     *    las tarjetas sucias; los supervivientes pasan a la generación vieja en su sitio.
+     *  - Generación vieja: se recorre sólo en una recolección completa, que se lanza
+     *    cuando su tamaño duplica el que quedó vivo tras la anterior.
+     *  - Barrera de escritura: guardar un objeto joven dentro de uno viejo marca la
+     *    tarjeta (línea) donde empieza el objeto viejo; véase writeBarrier().
+     *  - Heaps de hilo (setThreadLocal): los de PARA PARALELO sólo hacen recolecciones
+     *    menores. Un objeto joven suyo que se guarda en un objeto de otro heap pasa a
+     *    la generación vieja con todo lo joven que alcanza (publish), porque sus
+     *    recolecciones no verían esa referencia.
+     *
+     * El heap no conoce las raíces: el VM llama a beginCollection(), marca sus raíces
+     * con markValue() y termina con finishCollection(). Allocate() nunca recolecta;
+     * sólo activa collectionRequested() para que el VM lo haga en un punto seguro.
+     */
+    class Heap {
+    public:
+        static constexpr size_t kBlockSize = 32 * 1024;
+        static constexpr size_t kLineSize = 128;
+        static constexpr size_t kLinesPerBlock = kBlockSize / kLineSize;
+        static constexpr size_t kGranuleSize = 16;
+        static constexpr size_t kDefaultNurseryBytes = 4 * 1024 * 1024;
+        static constexpr size_t kMinMajorBytes = 16 * 1024 * 1024;
+        static constexpr size_t kRopeLeafBytes = 256;
+
+        struct Block;  // Bloque de kBlockSize bytes (definido en heap.cpp)
+
+        Heap() = default;
+        Heap(const Heap&) = delete;
+        Heap& operator=(const Heap&) = delete;
+        ~Heap();
+
+        template <typename T, typename... Args>
+        T* allocate(Args&&... args) {
+            void* memory = allocateRaw(sizeof(T));
+            T* object;
+            try {
+                object = new (memory) T(std::forward<Args>(args)...);
+            } catch (...) {
+                releaseRaw(memory, sizeof(T));
+                throw;
+            }
+            track(object);
+            return object;
+        }
+
+        ObjString* newString(std::string_view text) { return allocate<ObjString>(text); }
+
+        /**
+         * Tabla de símbolos: intern() devuelve la única cadena internada con ese texto,
+         * creándola si hace falta; con una cadena ya existente, la registra en su sitio
+         * si no había otra igual. La tabla no mantiene vivas las cadenas: las que
+         * recolecta el GC salen de ella. Un heap que consulta los símbolos de otro
+         * (shareSymbols, hilos de PARA PARALELO) sólo los lee y nunca interna.
+         */
+        ObjString* intern(std::string_view text);
+        ObjString* intern(ObjString* string);
+        void shareSymbols(const Heap* owner) { symbolSource_ = owner; }
+        size_t symbolCount() const { return symbols_.size(); }
+
+        /**
+         * `a + b`. Los resultados cortos se copian; los largos son cuerdas que no copian
+         * nada hasta que se lee su texto. Si `a` es una cuerda que termina en un trozo
+         * corto, ese trozo se copia junto con `b`: un bucle de `s = s + x` crea un nodo
+         * cada kRopeLeafBytes bytes añadidos y el total es lineal.
+         */
+        ObjString* concat(ObjString* a, ObjString* b);
+
+        size_t bytesAllocated() const { return stats_.liveBytes; }
+        size_t objectCount() const { return stats_.objectCount; }
+        GcStats stats() const;
+
+        // Tamaño de la generación joven que dispara una recolección menor
+        void setNurserySize(size_t bytes) { nurseryLimit_ = bytes; }
+
+        // Heap de un hilo de PARA PARALELO: nunca pide recolecciones completas
+        void setThreadLocal(bool local) { threadLocal_ = local; }
+        bool hasYoungObjects() const { return !young_.empty(); }
+
+        bool collectionRequested() const { return collectionRequested_; }
+        bool fullCollectionRequested() const { return fullRequested_; }
+
+        // Protocolo de recolección (lo dirige el VM)
+        void beginCollection(bool full);
+        void markValue(Value value) {
+            if (value.isObj()) markObject(value.asObj());
+        }
+        void markObject(Obj* object) {
+            if (object->marked || (object->old && !fullCollection_)) return;
+            object->marked = true;
+            gray_.push_back(object);
+        }
+        void finishCollection();
+
+        // Parte lenta de writeBarrier(): ensucia la tarjeta de `owner`, o publica `value`
+        // si viene de otro heap de hilo. Admite llamadas simultáneas desde los hilos de
+        // PARA PARALELO
+        static void rememberWrite(Obj* owner, Obj* value);
+
+        // Pasa `object` y los objetos jóvenes que alcanza a la generación vieja, en su
+        // sitio. Siguen en young_ y sweepYoung los cuenta como promovidos
+        static void publish(Obj* object);
+
+        // Pasa a este heap todos los bloques y objetos de `other`, que queda vacío. Los
+        // objetos de `other` conservan su generación; ninguno se mueve
+        void adopt(Heap& other);
+
+    private:
+        std::vector<Block*> blocks_;
+        std::vector<Block*> recyclable_;     // Bloques con líneas libres tras la última recolección
+        std::vector<Block*> dirtyBlocks_;    // Bloques con alguna tarjeta sucia
+        std::vector<Obj*> young_;            // Objetos creados desde la última recolección
+        std::vector<Obj*> gray_;             // Pendientes de recorrer durante el marcado
+        std::unordered_map<std::string_view, ObjString*> symbols_;  // Clave: texto de la propia cadena
+        const Heap* symbolSource_ = nullptr;
+
+        Block* current_ = nullptr;
+        size_t nextLine_ = 0;
+        size_t nextRecyclable_ = 0;
+        char* cursor_ = nullptr;
+        char* limit_ = nullptr;
+
+        GcStats stats_;
+        size_t nurseryBytes_ = 0;
+        size_t nurseryLimit_ = kDefaultNurseryBytes;
+        size_t oldBytes_ = 0;
+        size_t majorThreshold_ = kMinMajorBytes;
+        bool collectionRequested_ = false;
+        bool fullRequested_ = false;
+        bool fullCollection_ = false;
+        bool threadLocal_ = false;
+        uint64_t collectionStart_ = 0;
+
+        void* allocateRaw(size_t size);
+        void* allocateSlow(size_t size);
+        void releaseRaw(void* memory, size_t size);
+        void track(Obj* object);
+        Block* newBlock();
+        void occupy(void* memory, size_t size, int delta);
+
+        void traceChildren(Obj* object);
+        void scanDirtyCards();
+        void sweepYoung();
+        void sweepAll();
+        void destroy(Obj* object);
+        void resetAllocator();
+    };
+
+    /**
+     * Barrera de escritura. Debe llamarse siempre que se guarda `value` dentro de un
+     * objeto ya existente `owner` (elementos de ARRAY, entradas de MAP, campos...).
+     */
+    inline void writeBarrier(Obj* owner, Value value) {
+        if (owner->old && value.isObj() && !value.asObj()->old) Heap::rememberWrite(owner, value.asObj());
+    }
+
+} // namespace mc_core
+
+#endif // HEAP_H
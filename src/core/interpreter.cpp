@@ -1,12 +1,103 @@
-#include "interpreter.h"
-#include <iostream>
-
-/**
- * Clase Interpreter: Ejecuta código en tiempo real en el entorno MC++.
- */
-void Interpreter::run() {
-    std::cout << "Ejecutando el intérprete de MC++..." << std::endl;
-    // Aquí se implementará la lógica de interpretación, incluyendo
-    // el análisis sintáctico y la ejecución de instrucciones.
-    // Por ahora, este es un ejemplo básico.
-}
+#include "interpreter.h"
+#include "ast.h"
+#include "builtins.h"
+#include "bytecode_cache.h"
+#include "codegen.h"
+#include "module_loader.h"
+#include "object.h"
+#include "optimizer.h"
+#include "output.h"
+#include "parser.h"
+#include "profiler.h"
+#include "source_file.h"
+#include "vm.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+Interpreter::Interpreter(const std::string& sourcePath, bool useCache, const std::string& profilePath,
+                         int optimizationLevel)
+    : sourcePath_(sourcePath), useCache_(useCache), profilePath_(profilePath), optimizationLevel_(optimizationLevel) {}
+
+namespace {
+
+    // Escribe el perfil aunque el programa haya fallado: también interesa dónde se fue el tiempo
+    void writeProfile(mc_core::Profiler& profiler, const std::string& path) {
+        profiler.stop();
+        profiler.writeSummary(std::cerr);
+        std::ofstream out(path);
+        if (!out) {
+            // Sin excepción: no debe tapar el error del programa, si lo hubo
+            std::cerr << "Error: No se pudo escribir el perfil en " << path << std::endl;
+            return;
+        }
+        profiler.writeFolded(out);
+        std::cerr << "Pilas colapsadas en " << path << std::endl;
+    }
+
+} // namespace
+
+/**
+ * Clase Interpreter: Ejecuta código en tiempo real en el entorno MC++.
+ */
+void Interpreter::run() {
+    std::string source = mc_core::readSourceFile(sourcePath_);
+    std::string cachePath = mc_core::cachePathFor(sourcePath_);
+
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    // Los IMPORTAR de archivos .mc se buscan junto al programa; cambiar uno invalida la caché
+    mc_core::ModuleLoader modules(vm, sourcePath_);
+    uint64_t sourceHash = modules.programHash(source);
+    // Hilos de PARA PARALELO; por defecto, uno por núcleo
+    const char* threads = std::getenv("MCPP_THREADS");
+    if (threads != nullptr && std::atoi(threads) > 0) vm.setThreadCount(static_cast<size_t>(std::atoi(threads)));
+    // Trazas nativas para los bucles calientes, salvo con MCPP_JIT=0 o al perfilar
+    // (el perfil debe ver cada línea del bucle)
+    const char* jit = std::getenv("MCPP_JIT");
+    vm.setJitEnabled(profilePath_.empty() && !(jit != nullptr && std::string(jit) == "0"));
+
+    // Si hay una caché .mcc válida para este fuente y este -O se evita el análisis y la compilación
+    mc_core::FunctionProto* script =
+        useCache_ ? mc_core::loadBytecodeCache(vm, sourceHash, optimizationLevel_, cachePath) : nullptr;
+    if (script == nullptr) {
+        // Análisis léxico y sintáctico: el AST completo vive en una única arena
+        mc_core::AstArena arena;
+        mc_core::NodeId program = mc_core::parseSource(source, arena);
+
+        // Generación de bytecode para la máquina virtual de registros, tras la de los módulos importados
+        modules.load(arena, program);
+        script = mc_core::compileProgram(vm, arena, program);
+        mc_core::optimizeProgram(vm, optimizationLevel_);
+        if (useCache_) mc_core::writeBytecodeCache(vm, script, sourceHash, optimizationLevel_, cachePath);
+    }
+
+    // El perfilado empieza con el programa ya compilado
+    std::unique_ptr<mc_core::Profiler> profiler;
+    if (!profilePath_.empty()) {
+        profiler = std::make_unique<mc_core::Profiler>();
+        vm.setProfiler(profiler.get());
+        profiler->start();
+    }
+
+    try {
+        vm.run(script);
+
+        // Si el programa define main(), se invoca tras ejecutar el nivel superior
+        mc_core::Value entry = vm.getGlobal("main");
+        if (mc_core::isObjType(entry, mc_core::ObjType::FUNCTION)) {
+            vm.call(entry, {});
+        }
+
+        // Las corrutinas lanzadas con LANZAR que aún no han terminado
+        vm.runCoroutines();
+    } catch (...) {
+        // Lo ya mostrado sale antes que el mensaje de error
+        mc_core::OutputBuffer::flushAll();
+        if (profiler) writeProfile(*profiler, profilePath_);
+        throw;
+    }
+    mc_core::OutputBuffer::flushAll();
+    if (profiler) writeProfile(*profiler, profilePath_);
+}
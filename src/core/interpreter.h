@@ -1,13 +1,29 @@
-#ifndef INTERPRETER_H
-#define INTERPRETER_H
-
-/**
- * Clase Interpreter: Encargada de ejecutar código en MC++ en modo interpretación.
- */
-class Interpreter {
-public:
-    // Ejecuta el código en tiempo real
-    void run();
-};
-
-#endif // INTERPRETER_H
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "optimizer.h"
+#include <string>
+
+/**
+ * Clase Interpreter: Encargada de ejecutar código en MC++ en modo interpretación.
+ */
+class Interpreter {
+public:
+    // Crea un intérprete para el archivo fuente indicado; useCache activa la caché .mcc.
+    // Con profilePath no vacío se perfila la ejecución y se escriben allí las pilas
+    // colapsadas (el resumen sale por stderr). optimizationLevel es el -O con el que se
+    // optimiza el programa; una caché .mcc de otro nivel no se usa
+    explicit Interpreter(const std::string& sourcePath, bool useCache = true, const std::string& profilePath = "",
+                         int optimizationLevel = mc_core::kDefaultOptimizationLevel);
+
+    // Ejecuta el código en tiempo real
+    void run();
+
+private:
+    std::string sourcePath_;
+    bool useCache_;
+    std::string profilePath_;
+    int optimizationLevel_;
+};
+
+#endif // INTERPRETER_H
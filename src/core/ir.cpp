@@ -0,0 +1,395 @@
+#include "ir.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace mc_core {
+
+    bool isBranch(OpCode op) {
+        switch (op) {
+            case OpCode::JMPIF:
+            case OpCode::JMPIFNOT:
+            case OpCode::FORPREP:
+            case OpCode::FORLOOP:
+            case OpCode::FOREACH:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void instrRegisters(const IrInstr& instr, uint32_t numRegs, std::vector<uint32_t>& uses,
+                        std::vector<uint32_t>& defs) {
+        uses.clear();
+        defs.clear();
+        uint32_t a = argA(instr.instr);
+        uint32_t b = argB(instr.instr);
+        uint32_t c = argC(instr.instr);
+        switch (instr.op()) {
+            case OpCode::MOVE:
+            case OpCode::NEG:
+            case OpCode::NOT:
+            case OpCode::GETFIELD:
+                defs.push_back(a);
+                uses.push_back(b);
+                break;
+            case OpCode::LOADK:
+            case OpCode::LOADI:
+            case OpCode::LOADBOOL:
+            case OpCode::LOADNIL:
+            case OpCode::GETGLOBAL:
+                defs.push_back(a);
+                break;
+            case OpCode::SETGLOBAL:
+            case OpCode::JMPIF:
+            case OpCode::JMPIFNOT:
+            case OpCode::SWITCH:
+                uses.push_back(a);
+                break;
+            case OpCode::ADD:
+            case OpCode::SUB:
+            case OpCode::MUL:
+            case OpCode::DIV:
+            case OpCode::MOD:
+            case OpCode::EQ:
+            case OpCode::NE:
+            case OpCode::LT:
+            case OpCode::LE:
+            case OpCode::GETINDEX:
+            case OpCode::GETTYPED:
+                defs.push_back(a);
+                uses.push_back(b);
+                uses.push_back(c);
+                break;
+            case OpCode::SETINDEX:
+            case OpCode::SETTYPED:
+                uses.push_back(a);
+                uses.push_back(b);
+                uses.push_back(c);
+                break;
+            case OpCode::SETFIELD:
+                uses.push_back(a);
+                uses.push_back(c);
+                break;
+            case OpCode::TOTYPED:
+                uses.push_back(a);
+                defs.push_back(a);
+                break;
+            case OpCode::FORPREP:
+                for (uint32_t i = 0; i < 3; ++i) {
+                    uses.push_back(a + i);
+                    defs.push_back(a + i);
+                }
+                break;
+            case OpCode::FORLOOP:
+                uses.push_back(a);
+                uses.push_back(a + 1);
+                uses.push_back(a + 2);
+                defs.push_back(a);
+                break;
+            case OpCode::FOREACH:
+                uses.push_back(a);
+                uses.push_back(a + 1);
+                defs.push_back(a + 1);
+                defs.push_back(a + 2);
+                break;
+            case OpCode::CALL:
+                for (uint32_t i = a; i <= a + b; ++i) uses.push_back(i);
+                for (uint32_t i = a; i < std::max(numRegs, a + 1); ++i) defs.push_back(i);
+                break;
+            case OpCode::PARFOR:
+                // El cuerpo corre en otros marcos: sólo escribe el arreglo de resultados
+                for (uint32_t i = a; i <= a + b; ++i) uses.push_back(i);
+                defs.push_back(a);
+                break;
+            case OpCode::SELF:
+                uses.push_back(b);
+                defs.push_back(a);
+                defs.push_back(a + 1);
+                break;
+            case OpCode::RETURN:
+                if (b != 0) uses.push_back(a);
+                break;
+            case OpCode::NEWARRAY:
+                for (uint32_t i = b; i < b + c; ++i) uses.push_back(i);
+                defs.push_back(a);
+                break;
+            case OpCode::NEWMAP:
+                for (uint32_t i = b; i < b + 2 * c; ++i) uses.push_back(i);
+                defs.push_back(a);
+                break;
+            default:
+                break;
+        }
+    }
+
+    IrFunction buildIr(FunctionProto& proto) {
+        IrFunction function;
+        function.proto = &proto;
+        function.numRegs = proto.numRegs;
+
+        // Instrucciones sin los EXTRAARG; `index` traduce un pc a su instrucción
+        const std::vector<Instr>& code = proto.code;
+        std::vector<IrInstr> instrs;
+        std::vector<size_t> pcs;
+        std::vector<size_t> index(code.size() + 1, 0);
+        for (size_t pc = 0; pc < code.size(); ++pc) {
+            index[pc] = instrs.size();
+            pcs.push_back(pc);
+            IrInstr instr{unfuse(code[pc]), proto.lines[pc]};
+            if (hasInlineCache(opOf(code[pc])) && pc + 1 < code.size()) {
+                instr.cache = argAx(code[++pc]);
+            }
+            instrs.push_back(instr);
+        }
+        index[code.size()] = instrs.size();
+        auto jumpTarget = [&](size_t i) { return index[pcs[i] + 1 + argSBx(instrs[i].instr)]; };
+
+        // Los JMP que siguen a un SWITCH (uno por CASO y el del DEFECTO) son aristas de su
+        // bloque: 1 en los de los CASO y 2 en el último
+        std::vector<char> switchJump(instrs.size(), 0);
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            if (instrs[i].op() != OpCode::SWITCH) continue;
+            size_t cases = proto.switchTables[argBx(instrs[i].instr)].keys.size();
+            for (size_t j = i + 1; j <= i + cases; ++j) switchJump[j] = 1;
+            switchJump[i + cases + 1] = 2;
+        }
+
+        std::vector<bool> leader(instrs.size() + 1, false);
+        leader[0] = true;
+        bool fallsOffEnd = false;
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            OpCode op = instrs[i].op();
+            if (op == OpCode::JMP || isBranch(op)) {
+                leader[jumpTarget(i)] = true;
+                fallsOffEnd = fallsOffEnd || jumpTarget(i) == instrs.size();
+            }
+            if (op == OpCode::SWITCH || switchJump[i] == 1) continue;
+            if (op == OpCode::JMP || isBranch(op) || op == OpCode::RETURN) leader[i + 1] = true;
+        }
+        // Si algún salto vuelve al pc 0, la entrada es un bloque vacío aparte: así
+        // blocks[0] nunca tiene predecesores
+        bool entryTargeted = false;
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            OpCode op = instrs[i].op();
+            if ((op == OpCode::JMP || isBranch(op)) && jumpTarget(i) == 0) entryTargeted = true;
+        }
+        std::vector<int> blockOf(instrs.size() + 1, kNoBlock);
+        int count = entryTargeted ? 1 : 0;
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            if (leader[i]) ++count;
+            blockOf[i] = count - 1;
+        }
+        // Un salto al final del código se convierte en un bloque con RETURN
+        blockOf[instrs.size()] = count;
+        function.blocks.resize(static_cast<size_t>(count) + (fallsOffEnd ? 1 : 0));
+        if (fallsOffEnd) {
+            function.blocks.back().code.push_back(IrInstr{encodeABC(OpCode::RETURN, 0, 0, 0), 0});
+        }
+
+        if (entryTargeted) function.blocks[0].next = 1;
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            IrBlock& block = function.blocks[static_cast<size_t>(blockOf[i])];
+            OpCode op = instrs[i].op();
+            if (op == OpCode::JMP) {
+                if (switchJump[i] == 1) {
+                    block.cases.push_back(blockOf[jumpTarget(i)]);
+                } else {
+                    block.next = blockOf[jumpTarget(i)];
+                }
+                continue;
+            }
+            block.code.push_back(instrs[i]);
+            if (isBranch(op)) {
+                block.target = blockOf[jumpTarget(i)];
+                block.next = i + 1 < instrs.size() ? blockOf[i + 1] : kNoBlock;
+            } else if (op != OpCode::RETURN && i + 1 < instrs.size() && leader[i + 1]) {
+                block.next = blockOf[i + 1];
+            }
+        }
+        for (size_t b = 0; b < function.blocks.size(); ++b) function.layout.push_back(static_cast<int>(b));
+        return function;
+    }
+
+    void lowerIr(IrFunction& function) {
+        std::vector<int> order;
+        for (int b : function.layout) {
+            if (!function.blocks[static_cast<size_t>(b)].removed) order.push_back(b);
+        }
+        std::vector<Instr> code;
+        std::vector<uint32_t> lines;
+        std::vector<size_t> start(function.blocks.size(), 0);
+        std::vector<std::pair<size_t, int>> fixups;
+        uint32_t line = 0;
+        for (size_t k = 0; k < order.size(); ++k) {
+            const IrBlock& block = function.blocks[static_cast<size_t>(order[k])];
+            start[static_cast<size_t>(order[k])] = code.size();
+            for (const IrInstr& instr : block.code) {
+                line = instr.line;
+                if (isBranch(instr.op())) fixups.emplace_back(code.size(), block.target);
+                code.push_back(instr.instr);
+                lines.push_back(instr.line);
+                if (instr.cache != kNoCache) {
+                    code.push_back(encodeAx(OpCode::EXTRAARG, instr.cache));
+                    lines.push_back(instr.line);
+                }
+            }
+            // La tabla del SWITCH se coloca siempre completa, con el JMP del DEFECTO al final
+            for (int target : block.cases) {
+                fixups.emplace_back(code.size(), target);
+                code.push_back(encodeAsBx(OpCode::JMP, 0, 0));
+                lines.push_back(line);
+            }
+            int following = k + 1 < order.size() ? order[k + 1] : kNoBlock;
+            if (block.next != kNoBlock && (block.next != following || !block.cases.empty())) {
+                fixups.emplace_back(code.size(), block.next);
+                code.push_back(encodeAsBx(OpCode::JMP, 0, 0));
+                lines.push_back(line);
+            }
+        }
+        for (const auto& fixup : fixups) {
+            int64_t offset = static_cast<int64_t>(start[static_cast<size_t>(fixup.second)]) -
+                             static_cast<int64_t>(fixup.first + 1);
+            if (offset < -kSBxBias || offset > kMaxBx - kSBxBias) {
+                throw std::runtime_error("salto demasiado largo en " + function.proto->name);
+            }
+            Instr& instr = code[fixup.first];
+            instr = encodeAsBx(opOf(instr), argA(instr), static_cast<int32_t>(offset));
+        }
+        function.proto->code = std::move(code);
+        function.proto->lines = std::move(lines);
+        function.proto->numRegs = static_cast<uint8_t>(function.numRegs);
+    }
+
+    std::vector<int> IrFunction::successors(int block) const {
+        const IrBlock& b = blocks[static_cast<size_t>(block)];
+        std::vector<int> result;
+        if (b.next != kNoBlock) result.push_back(b.next);
+        if (b.target != kNoBlock && b.target != b.next) result.push_back(b.target);
+        for (int c : b.cases) {
+            if (std::find(result.begin(), result.end(), c) == result.end()) result.push_back(c);
+        }
+        return result;
+    }
+
+    std::vector<std::vector<int>> IrFunction::predecessors() const {
+        std::vector<std::vector<int>> preds(blocks.size());
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            if (blocks[b].removed) continue;
+            for (int s : successors(static_cast<int>(b))) preds[static_cast<size_t>(s)].push_back(static_cast<int>(b));
+        }
+        return preds;
+    }
+
+    std::vector<int> IrFunction::reversePostorder() const {
+        std::vector<int> postorder;
+        std::vector<char> visited(blocks.size(), 0);
+        // DFS iterativo: (bloque, siguiente sucesor por visitar)
+        std::vector<std::pair<int, size_t>> stack{{0, 0}};
+        visited[0] = 1;
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            std::vector<int> succs = successors(top.first);
+            if (top.second < succs.size()) {
+                int s = succs[top.second++];
+                if (!visited[static_cast<size_t>(s)]) {
+                    visited[static_cast<size_t>(s)] = 1;
+                    stack.emplace_back(s, 0);
+                }
+            } else {
+                postorder.push_back(top.first);
+                stack.pop_back();
+            }
+        }
+        return std::vector<int>(postorder.rbegin(), postorder.rend());
+    }
+
+    std::vector<int> IrFunction::dominators(const std::vector<int>& rpo,
+                                            const std::vector<std::vector<int>>& preds) const {
+        // Algoritmo iterativo de Cooper, Harvey y Kennedy sobre el orden posterior inverso
+        std::vector<int> order(blocks.size(), -1);
+        for (size_t i = 0; i < rpo.size(); ++i) order[static_cast<size_t>(rpo[i])] = static_cast<int>(i);
+        std::vector<int> idom(blocks.size(), kNoBlock);
+        idom[0] = 0;
+        auto intersect = [&](int x, int y) {
+            while (x != y) {
+                while (order[static_cast<size_t>(x)] > order[static_cast<size_t>(y)]) x = idom[static_cast<size_t>(x)];
+                while (order[static_cast<size_t>(y)] > order[static_cast<size_t>(x)]) y = idom[static_cast<size_t>(y)];
+            }
+            return x;
+        };
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t i = 1; i < rpo.size(); ++i) {
+                int b = rpo[i];
+                int dom = kNoBlock;
+                for (int p : preds[static_cast<size_t>(b)]) {
+                    if (order[static_cast<size_t>(p)] < 0 || idom[static_cast<size_t>(p)] == kNoBlock) continue;
+                    dom = dom == kNoBlock ? p : intersect(p, dom);
+                }
+                if (dom != idom[static_cast<size_t>(b)]) {
+                    idom[static_cast<size_t>(b)] = dom;
+                    changed = true;
+                }
+            }
+        }
+        return idom;
+    }
+
+    std::vector<RegSet> IrFunction::liveIn() const {
+        std::vector<RegSet> gen(blocks.size());
+        std::vector<RegSet> kill(blocks.size());
+        std::vector<uint32_t> uses;
+        std::vector<uint32_t> defs;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            if (blocks[b].removed) continue;
+            for (auto it = blocks[b].code.rbegin(); it != blocks[b].code.rend(); ++it) {
+                instrRegisters(*it, numRegs, uses, defs);
+                for (uint32_t r : defs) {
+                    gen[b].reset(r);
+                    kill[b].set(r);
+                }
+                for (uint32_t r : uses) gen[b].set(r);
+            }
+        }
+        std::vector<int> rpo = reversePostorder();
+        std::vector<RegSet> in(blocks.size());
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (auto it = rpo.rbegin(); it != rpo.rend(); ++it) {
+                size_t b = static_cast<size_t>(*it);
+                RegSet out;
+                for (int s : successors(*it)) out |= in[static_cast<size_t>(s)];
+                RegSet live = gen[b] | (out & ~kill[b]);
+                if (live != in[b]) {
+                    in[b] = live;
+                    changed = true;
+                }
+            }
+        }
+        return in;
+    }
+
+    void IrFunction::removeUnreachable() {
+        std::vector<char> reachable(blocks.size(), 0);
+        for (int b : reversePostorder()) reachable[static_cast<size_t>(b)] = 1;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            if (reachable[b]) continue;
+            blocks[b].removed = true;
+            blocks[b].code.clear();
+            blocks[b].cases.clear();
+            blocks[b].next = blocks[b].target = kNoBlock;
+        }
+    }
+
+    size_t IrFunction::instructionCount() const {
+        size_t count = 0;
+        for (const IrBlock& block : blocks) {
+            if (!block.removed) count += block.code.size();
+        }
+        return count;
+    }
+
+} // namespace mc_core
@@ -0,0 +1,90 @@
+#ifndef IR_H
+#define IR_H
+
+#include "bytecode.h"
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace mc_core {
+
+    constexpr uint32_t kNoCache = 0xFFFFFFFF;
+    constexpr int kNoBlock = -1;
+
+    // Instrucción de la IR: la instrucción de bytecode tal cual, con su línea y su caché
+    struct IrInstr {
+        Instr instr;
+        uint32_t line;
+        uint32_t cache = kNoCache;  // Operando EXTRAARG de GETFIELD / SETFIELD / SELF
+        bool noThrow = false;       // Un análisis demostró que no puede lanzar un error
+
+        OpCode op() const { return opOf(instr); }
+    };
+
+    /**
+     * Bloque básico. Los saltos incondicionales no aparecen como instrucciones: se
+     * expresan con `next`. La última instrucción puede ser un salto condicional o de
+     * bucle (JMPIF, JMPIFNOT, FORPREP, FORLOOP, FOREACH), que continúa en `target` al
+     * saltar y en `next` si no, un SWITCH, que continúa en el bloque de `cases` de su
+     * CASO o en `next` (el DEFECTO), o un RETURN, sin sucesores.
+     */
+    struct IrBlock {
+        std::vector<IrInstr> code;
+        int next = kNoBlock;
+        int target = kNoBlock;
+        std::vector<int> cases;
+        bool removed = false;
+
+        bool hasBranch() const { return target != kNoBlock || !cases.empty(); }
+    };
+
+    using RegSet = std::bitset<256>;
+
+    /**
+     * Representación intermedia del optimizador: el bytecode de un prototipo como
+     * grafo de control de flujo de bloques básicos.
+     *
+     * Las instrucciones conservan sus registros y su codificación, así que la IR se
+     * puede volver a bajar a bytecode en cualquier momento (lowerIr). Sólo los saltos
+     * cambian de forma: pasan a ser aristas entre bloques y lowerIr() recalcula los
+     * desplazamientos tras colocar los bloques en el orden de `layout`.
+     */
+    struct IrFunction {
+        FunctionProto* proto = nullptr;
+        std::vector<IrBlock> blocks;   // blocks[0] es la entrada y no tiene predecesores
+        std::vector<int> layout;       // Orden de colocación de los bloques
+        uint32_t numRegs = 0;
+
+        std::vector<int> successors(int block) const;
+        std::vector<std::vector<int>> predecessors() const;
+        // Bloques alcanzables desde la entrada en orden posterior inverso
+        std::vector<int> reversePostorder() const;
+        // Dominador inmediato de cada bloque alcanzable (kNoBlock para el resto)
+        std::vector<int> dominators(const std::vector<int>& rpo, const std::vector<std::vector<int>>& preds) const;
+        // Registros vivos a la entrada de cada bloque
+        std::vector<RegSet> liveIn() const;
+        // Marca como eliminados los bloques inalcanzables
+        void removeUnreachable();
+        size_t instructionCount() const;
+    };
+
+    // Salto que termina un bloque con dos sucesores
+    bool isBranch(OpCode op);
+
+    /**
+     * Registros que lee (uses) y escribe (defs) una instrucción. CALL escribe R[A] y
+     * deja indefinidos todos los registros por encima, que ocupa el marco llamado.
+     */
+    void instrRegisters(const IrInstr& instr, uint32_t numRegs, std::vector<uint32_t>& uses,
+                        std::vector<uint32_t>& defs);
+
+    // Construye la IR de un prototipo generado en memoria (no cargado de la caché). Las
+    // superinstrucciones vuelven a ser el par de instrucciones original
+    IrFunction buildIr(FunctionProto& proto);
+
+    // Vuelve a generar el código, la tabla de líneas y el número de registros del prototipo
+    void lowerIr(IrFunction& function);
+
+} // namespace mc_core
+
+#endif // IR_H
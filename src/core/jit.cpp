@@ -0,0 +1,987 @@
+#include "jit.h"
+#include "object.h"
+#include "vm.h"
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__unix__)
+#define MC_JIT_X64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace mc_core {
+
+    // Código nativo de una traza y el destino de cada una de sus salidas
+    struct Trace {
+        using Entry = uint32_t (*)(Value* regs, Value* globals);
+
+        struct Exit {
+            const Instr* pc;   // Instrucción en la que sigue el intérprete
+            bool side;         // Guarda dentro del bucle (no el final normal del bucle)
+        };
+
+        const Instr* header = nullptr;
+        Entry entry = nullptr;
+        void* memory = nullptr;
+        size_t size = 0;
+        std::vector<Exit> exits;
+        uint64_t iterations = 0;   // El código nativo lo incrementa en cada vuelta
+        uint64_t sideExits = 0;
+
+        Trace() = default;
+        Trace(const Trace&) = delete;
+        Trace& operator=(const Trace&) = delete;
+        ~Trace() {
+#if defined(MC_JIT_X64)
+            if (memory != nullptr) ::munmap(memory, size);
+#endif
+        }
+    };
+
+    namespace {
+
+        // Salidas por guardas toleradas antes de mirar la proporción por iteración
+        constexpr uint64_t kSideExitGrace = 64;
+
+        // Tipo observado o demostrado de un registro
+        enum class Kind : uint8_t {
+            UNKNOWN,
+            INT,
+            FLOAT,
+            BOOL,
+            OTHER
+        };
+
+        Kind kindOf(Value value) {
+            if (value.isInt()) return Kind::INT;
+            if (value.isFloat()) return Kind::FLOAT;
+            return value.isBool() ? Kind::BOOL : Kind::OTHER;
+        }
+
+        // Instrucción grabada con lo observado al ejecutarla
+        struct TraceStep {
+            const Instr* pc;
+            Instr instr;
+            Kind b = Kind::UNKNOWN;   // Operandos (FORLOOP: el contador; SETTYPED: el valor)
+            Kind c = Kind::UNKNOWN;
+            bool taken = false;       // Saltos: se tomó; FORLOOP: paso positivo
+            ElementType element = ElementType::INT;
+            Value constant;           // LOADK: el valor cargado
+        };
+
+        /**
+         * Disposición de ObjTypedArray para leer sus elementos desde el código nativo:
+         * el desplazamiento del tipo de elemento y de cada std::vector, cuyo primer
+         * campo debe ser el puntero a los datos (se comprueba con un objeto de prueba;
+         * si no, GETTYPED/SETTYPED no se compilan).
+         */
+        struct TypedLayout {
+            bool valid = false;
+            int32_t element = 0;
+            int32_t ints = 0;
+            int32_t floats = 0;
+        };
+
+        const TypedLayout& typedLayout() {
+            static const TypedLayout layout = [] {
+                TypedLayout result;
+                ObjTypedArray probe(ElementType::FLOAT);
+                probe.ints.push_back(1);
+                probe.floats.push_back(2.0);
+                const char* base = reinterpret_cast<const char*>(&probe);
+                result.element = static_cast<int32_t>(reinterpret_cast<const char*>(&probe.elementType) - base);
+                result.ints = static_cast<int32_t>(reinterpret_cast<const char*>(&probe.ints) - base);
+                result.floats = static_cast<int32_t>(reinterpret_cast<const char*>(&probe.floats) - base);
+                const void* intsData;
+                const void* floatsData;
+                std::memcpy(&intsData, &probe.ints, sizeof(intsData));
+                std::memcpy(&floatsData, &probe.floats, sizeof(floatsData));
+                result.valid = sizeof(ElementType) == 1 && intsData == probe.ints.data() &&
+                               floatsData == probe.floats.data();
+                return result;
+            }();
+            return layout;
+        }
+
+#if defined(MC_JIT_X64)
+
+        enum Gp : uint8_t { RAX = 0, RCX = 1, RDX = 2, RSI = 6, RDI = 7, R10 = 10, R11 = 11 };
+        enum Xmm : uint8_t { XMM0 = 0, XMM1 = 1 };
+        constexpr int kNoIndex = -1;
+
+        // Códigos de condición de Jcc/SETcc
+        enum Cond : uint8_t {
+            OVERFLOW = 0x0, BELOW = 0x2, EQUAL = 0x4, NOT_EQUAL = 0x5, BELOW_EQUAL = 0x6, ABOVE = 0x7,
+            SIGN = 0x8, NOT_SIGN = 0x9, PARITY = 0xA, LESS = 0xC, GREATER_EQUAL = 0xD, LESS_EQUAL = 0xE,
+            GREATER = 0xF
+        };
+
+        // Codificador mínimo de x86-64: sólo las formas que usan las trazas
+        class Assembler {
+        public:
+            const std::vector<uint8_t>& code() const { return code_; }
+            size_t offset() const { return code_.size(); }
+
+            // mov dst, [base + index*8 + disp]
+            void load(Gp dst, Gp base, int32_t disp, int index = kNoIndex) {
+                rex(true, dst, index, base);
+                byte(0x8B);
+                memory(dst, base, index, disp);
+            }
+            // mov [base + index*8 + disp], src
+            void store(Gp base, int32_t disp, Gp src, int index = kNoIndex) {
+                rex(true, src, index, base);
+                byte(0x89);
+                memory(src, base, index, disp);
+            }
+            // movzx dst32, byte [base + disp]
+            void loadByte(Gp dst, Gp base, int32_t disp) {
+                rex(false, dst, kNoIndex, base);
+                byte(0x0F);
+                byte(0xB6);
+                memory(dst, base, kNoIndex, disp);
+            }
+            void moveImm(Gp dst, uint64_t imm) {
+                rex(true, 0, kNoIndex, dst);
+                byte(static_cast<uint8_t>(0xB8 + (dst & 7)));
+                for (int i = 0; i < 8; ++i) byte(static_cast<uint8_t>(imm >> (8 * i)));
+            }
+            void move(Gp dst, Gp src) { aluRR(0x89, dst, src); }
+            void add(Gp dst, Gp src) { aluRR(0x01, dst, src); }
+            void sub(Gp dst, Gp src) { aluRR(0x29, dst, src); }
+            void andR(Gp dst, Gp src) { aluRR(0x21, dst, src); }
+            void orR(Gp dst, Gp src) { aluRR(0x09, dst, src); }
+            void xorR(Gp dst, Gp src) { aluRR(0x31, dst, src); }
+            void cmp(Gp a, Gp b) { aluRR(0x39, a, b); }
+            void test(Gp a, Gp b) { aluRR(0x85, a, b); }
+            void imul(Gp dst, Gp src) {
+                rex(true, dst, kNoIndex, src);
+                byte(0x0F);
+                byte(0xAF);
+                byte(modrm(dst, src));
+            }
+            // cmp reg, imm8 (con extensión de signo)
+            void cmpImm8(Gp reg, int8_t imm) {
+                rex(true, 0, kNoIndex, reg);
+                byte(0x83);
+                byte(modrm(7, reg));
+                byte(static_cast<uint8_t>(imm));
+            }
+            // add qword [base], 1
+            void incrementMemory(Gp base) {
+                rex(true, 0, kNoIndex, base);
+                byte(0x83);
+                memory(0, base, kNoIndex, 0);
+                byte(1);
+            }
+            void shl(Gp reg, uint8_t bits) { shift(4, reg, bits); }
+            void sar(Gp reg, uint8_t bits) { shift(7, reg, bits); }
+            void neg(Gp reg) { unary(3, reg); }
+            void idiv(Gp reg) { unary(7, reg); }
+            void cqo() {
+                byte(0x48);
+                byte(0x99);
+            }
+            // setcc al; movzx eax, al
+            void setAl(Cond cond) {
+                byte(0x0F);
+                byte(static_cast<uint8_t>(0x90 + cond));
+                byte(0xC0);
+                byte(0x0F);
+                byte(0xB6);
+                byte(0xC0);
+            }
+
+            // movq xmm, [base + index*8 + disp] / movq [base + index*8 + disp], xmm
+            void loadXmm(Xmm dst, Gp base, int32_t disp, int index = kNoIndex) {
+                byte(0xF3);
+                rex(false, dst, index, base);
+                byte(0x0F);
+                byte(0x7E);
+                memory(dst, base, index, disp);
+            }
+            void storeXmm(Gp base, int32_t disp, Xmm src, int index = kNoIndex) {
+                byte(0x66);
+                rex(false, src, index, base);
+                byte(0x0F);
+                byte(0xD6);
+                memory(src, base, index, disp);
+            }
+            void cvtsi2sd(Xmm dst, Gp src) {
+                byte(0xF2);
+                rex(true, dst, kNoIndex, src);
+                byte(0x0F);
+                byte(0x2A);
+                byte(modrm(dst, src));
+            }
+            void addsd(Xmm dst, Xmm src) { sse(0x58, dst, src); }
+            void subsd(Xmm dst, Xmm src) { sse(0x5C, dst, src); }
+            void mulsd(Xmm dst, Xmm src) { sse(0x59, dst, src); }
+            void divsd(Xmm dst, Xmm src) { sse(0x5E, dst, src); }
+            void ucomisd(Xmm a, Xmm b) {
+                byte(0x66);
+                byte(0x0F);
+                byte(0x2E);
+                byte(modrm(a, b));
+            }
+
+            // Saltos con desplazamiento de 32 bits; devuelven la posición a enlazar
+            size_t jcc(Cond cond) {
+                byte(0x0F);
+                byte(static_cast<uint8_t>(0x80 + cond));
+                return placeholder();
+            }
+            size_t jmp() {
+                byte(0xE9);
+                return placeholder();
+            }
+            void bind(size_t at, size_t target) {
+                int32_t rel = static_cast<int32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(at + 4));
+                std::memcpy(&code_[at], &rel, sizeof(rel));
+            }
+            // mov eax, imm32; ret
+            void returnImm(uint32_t value) {
+                byte(0xB8);
+                for (int i = 0; i < 4; ++i) byte(static_cast<uint8_t>(value >> (8 * i)));
+                byte(0xC3);
+            }
+
+        private:
+            std::vector<uint8_t> code_;
+
+            void byte(uint8_t value) { code_.push_back(value); }
+            static uint8_t modrm(int reg, int rm) { return static_cast<uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7)); }
+            void rex(bool wide, int reg, int index, int base) {
+                uint8_t prefix = static_cast<uint8_t>(0x40 | (wide ? 8 : 0) | ((reg & 8) >> 1) |
+                                                      (index != kNoIndex ? (index & 8) >> 2 : 0) | ((base & 8) >> 3));
+                if (prefix != 0x40) byte(prefix);
+            }
+            // [base + index*8 + disp32]; con rsp/r12 como base o con índice hace falta SIB
+            void memory(int reg, int base, int index, int32_t disp) {
+                if (index == kNoIndex && (base & 7) != 4) {
+                    byte(static_cast<uint8_t>(0x80 | ((reg & 7) << 3) | (base & 7)));
+                } else {
+                    byte(static_cast<uint8_t>(0x80 | ((reg & 7) << 3) | 4));
+                    int sibIndex = index == kNoIndex ? 4 : (index & 7);
+                    byte(static_cast<uint8_t>(0xC0 | (sibIndex << 3) | (base & 7)));
+                }
+                for (int i = 0; i < 4; ++i) byte(static_cast<uint8_t>(static_cast<uint32_t>(disp) >> (8 * i)));
+            }
+            void aluRR(uint8_t opcode, Gp dst, Gp src) {
+                rex(true, src, kNoIndex, dst);
+                byte(opcode);
+                byte(modrm(src, dst));
+            }
+            void shift(int extension, Gp reg, uint8_t bits) {
+                rex(true, 0, kNoIndex, reg);
+                byte(0xC1);
+                byte(modrm(extension, reg));
+                byte(bits);
+            }
+            void unary(int extension, Gp reg) {
+                rex(true, 0, kNoIndex, reg);
+                byte(0xF7);
+                byte(modrm(extension, reg));
+            }
+            void sse(uint8_t opcode, Xmm dst, Xmm src) {
+                byte(0xF2);
+                byte(0x0F);
+                byte(opcode);
+                byte(modrm(dst, src));
+            }
+            size_t placeholder() {
+                size_t at = code_.size();
+                for (int i = 0; i < 4; ++i) byte(0);
+                return at;
+            }
+        };
+
+        constexpr uint64_t kIntTagBits = 0xFFF8000000000000ull;
+        constexpr uint64_t kQuietNaNBits = 0x7FF8000000000000ull;
+        constexpr uint64_t kPointerMask = 0x0000FFFFFFFFFFFFull;
+        constexpr uint64_t kSignBit = 0x8000000000000000ull;
+
+        /**
+         * Traduce una traza grabada. Convención: uint32_t traza(Value* regs, Value* globals)
+         * devuelve el índice de la salida. rdi = registros del marco, rsi = globales,
+         * r11 = etiqueta de INT; rax, rcx, rdx, r10, xmm0 y xmm1 son temporales. Ningún
+         * valor vive en registros de la máquina entre dos instrucciones de bytecode.
+         */
+        class TraceCompiler {
+        public:
+            TraceCompiler(const std::vector<TraceStep>& steps, Trace& trace)
+                : steps_(steps), trace_(trace), header_(trace.header), closing_(steps.back().pc) {}
+
+            bool compile() {
+                const TypedLayout& layout = typedLayout();
+                as_.moveImm(R11, kIntTagBits);
+                size_t loop = as_.offset();
+                as_.moveImm(R10, reinterpret_cast<uint64_t>(&trace_.iterations));
+                as_.incrementMemory(R10);
+                for (Kind& kind : known_) kind = Kind::UNKNOWN;
+
+                for (const TraceStep& step : steps_) {
+                    Instr instr = step.instr;
+                    uint32_t a = argA(instr);
+                    const Instr* at = step.pc;
+                    switch (opOf(instr)) {
+                        case OpCode::MOVE:
+                            as_.load(RAX, RDI, slot(argB(instr)));
+                            as_.store(RDI, slot(a), RAX);
+                            known_[a] = known_[argB(instr)];
+                            break;
+                        case OpCode::LOADK:
+                            setConstant(a, step.constant);
+                            break;
+                        case OpCode::LOADI:
+                            setConstant(a, Value::integer(argSBx(instr)));
+                            break;
+                        case OpCode::LOADBOOL:
+                            setConstant(a, Value::boolean(argB(instr) != 0));
+                            break;
+                        case OpCode::LOADNIL:
+                            setConstant(a, Value::nil());
+                            break;
+                        case OpCode::GETGLOBAL:
+                            as_.load(RAX, RSI, slot(argBx(instr)));
+                            as_.store(RDI, slot(a), RAX);
+                            known_[a] = Kind::UNKNOWN;
+                            break;
+                        case OpCode::SETGLOBAL:
+                            as_.load(RAX, RDI, slot(a));
+                            as_.store(RSI, slot(argBx(instr)), RAX);
+                            break;
+                        case OpCode::ADD:
+                        case OpCode::SUB:
+                        case OpCode::MUL:
+                        case OpCode::DIV:
+                        case OpCode::MOD:
+                            arithmetic(step);
+                            break;
+                        case OpCode::NEG:
+                            negate(step);
+                            break;
+                        case OpCode::NOT:
+                            as_.load(RAX, RDI, slot(argB(instr)));
+                            truthiness(argB(instr));
+                            as_.setAl(EQUAL);  // ZF = 1 si el valor es falso
+                            storeBool(a);
+                            break;
+                        case OpCode::EQ:
+                        case OpCode::NE:
+                        case OpCode::LT:
+                        case OpCode::LE:
+                            compare(step);
+                            break;
+                        case OpCode::JMP:
+                            // Los saltos hacia delante ya están resueltos en el camino grabado
+                            if (at == closing_) loopJump(as_.jmp(), loop);
+                            break;
+                        case OpCode::JMPIF:
+                        case OpCode::JMPIFNOT:
+                            branch(step);
+                            break;
+                        case OpCode::FORLOOP:
+                            forLoop(step, loop);
+                            break;
+                        case OpCode::GETTYPED:
+                        case OpCode::SETTYPED:
+                            if (!layout.valid) return false;
+                            typedAccess(step, layout);
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+
+                // Resguardos de salida: mov eax, salida; ret
+                for (size_t i = 0; i < trace_.exits.size(); ++i) {
+                    size_t stub = as_.offset();
+                    for (const auto& [offset, exit] : pendingExits_) {
+                        if (exit == i) as_.bind(offset, stub);
+                    }
+                    as_.returnImm(static_cast<uint32_t>(i));
+                }
+                for (const auto& [offset, target] : loopJumps_) as_.bind(offset, target);
+                return install();
+            }
+
+        private:
+            const std::vector<TraceStep>& steps_;
+            Trace& trace_;
+            const Instr* header_;
+            const Instr* closing_;
+            Assembler as_;
+            Kind known_[256];
+            std::vector<std::pair<size_t, size_t>> pendingExits_;   // (salto, salida)
+            std::vector<std::pair<size_t, size_t>> loopJumps_;      // (salto, cabecera)
+
+            static int32_t slot(uint32_t index) { return static_cast<int32_t>(index * sizeof(Value)); }
+
+            size_t exitIndex(const Instr* pc, bool side) {
+                for (size_t i = 0; i < trace_.exits.size(); ++i) {
+                    if (trace_.exits[i].pc == pc && trace_.exits[i].side == side) return i;
+                }
+                trace_.exits.push_back(Trace::Exit{pc, side});
+                return trace_.exits.size() - 1;
+            }
+
+            // Una guarda sale a la instrucción que la provocó, que el intérprete repite
+            void guardExit(size_t jump, const Instr* pc) { pendingExits_.emplace_back(jump, exitIndex(pc, true)); }
+
+            // Salida hacia `pc`: guarda si sigue dentro del bucle, final normal si no
+            void leaveTo(size_t jump, const Instr* pc) {
+                bool inside = pc >= header_ && pc <= closing_;
+                pendingExits_.emplace_back(jump, exitIndex(pc, inside));
+            }
+
+            void loopJump(size_t jump, size_t loop) { loopJumps_.emplace_back(jump, loop); }
+
+            void setConstant(uint32_t reg, Value value) {
+                as_.moveImm(RAX, value.bits());
+                as_.store(RDI, slot(reg), RAX);
+                known_[reg] = kindOf(value);
+            }
+
+            void guardInt(uint32_t reg, const Instr* at) {
+                if (known_[reg] == Kind::INT) return;
+                as_.load(RAX, RDI, slot(reg));
+                as_.sar(RAX, 51);
+                as_.cmpImm8(RAX, -1);
+                guardExit(as_.jcc(NOT_EQUAL), at);
+                known_[reg] = Kind::INT;
+            }
+
+            // FLOAT que no es NaN (el NaN canónico sale al intérprete)
+            void guardFloat(uint32_t reg, const Instr* at) {
+                if (known_[reg] == Kind::FLOAT) return;
+                as_.load(RAX, RDI, slot(reg));
+                as_.moveImm(R10, kQuietNaNBits);
+                as_.andR(RAX, R10);
+                as_.cmp(RAX, R10);
+                guardExit(as_.jcc(EQUAL), at);
+                known_[reg] = Kind::FLOAT;
+            }
+
+            void loadInt(Gp dst, uint32_t reg, const Instr* at) {
+                guardInt(reg, at);
+                as_.load(dst, RDI, slot(reg));
+                as_.shl(dst, 13);
+                as_.sar(dst, 13);
+            }
+
+            void loadNumber(Xmm dst, uint32_t reg, Kind kind, const Instr* at) {
+                if (kind == Kind::INT) {
+                    loadInt(RAX, reg, at);
+                    as_.cvtsi2sd(dst, RAX);
+                } else {
+                    guardFloat(reg, at);
+                    as_.loadXmm(dst, RDI, slot(reg));
+                }
+            }
+
+            // rax debe caber en el INT de 51 bits; si no, el intérprete lo convierte en FLOAT
+            void storeInt(uint32_t reg, const Instr* at) {
+                as_.move(RCX, RAX);
+                as_.shl(RCX, 13);
+                as_.sar(RCX, 13);
+                as_.cmp(RCX, RAX);
+                guardExit(as_.jcc(NOT_EQUAL), at);
+                as_.orR(RAX, R11);
+                as_.store(RDI, slot(reg), RAX);
+                known_[reg] = Kind::INT;
+            }
+
+            // Un resultado NaN se deja al intérprete, que lo normaliza
+            void storeFloat(uint32_t reg, const Instr* at) {
+                as_.ucomisd(XMM0, XMM0);
+                guardExit(as_.jcc(PARITY), at);
+                as_.storeXmm(RDI, slot(reg), XMM0);
+                known_[reg] = Kind::FLOAT;
+            }
+
+            // al = 0/1 -> BOOL
+            void storeBool(uint32_t reg) {
+                as_.moveImm(RCX, Value::boolean(false).bits());
+                as_.orR(RAX, RCX);
+                as_.store(RDI, slot(reg), RAX);
+                known_[reg] = Kind::BOOL;
+            }
+
+            // Compara rax con NULO y FALSO: ZF = 1 si el valor es falso (usa rcx)
+            void truthiness(uint32_t reg) {
+                as_.moveImm(RCX, Value::boolean(false).bits());
+                if (known_[reg] == Kind::BOOL) {
+                    as_.cmp(RAX, RCX);
+                    return;
+                }
+                // Si es NULO se salta a la salida con ZF = 1; si no, decide la comparación con FALSO
+                as_.moveImm(RDX, Value::nil().bits());
+                as_.cmp(RAX, RDX);
+                size_t isNil = as_.jcc(EQUAL);
+                as_.cmp(RAX, RCX);
+                as_.bind(isNil, as_.offset());
+            }
+
+            void arithmetic(const TraceStep& step) {
+                Instr instr = step.instr;
+                OpCode op = opOf(instr);
+                uint32_t a = argA(instr);
+                uint32_t b = argB(instr);
+                uint32_t c = argC(instr);
+                if (step.b == Kind::INT && step.c == Kind::INT) {
+                    loadInt(RDX, b, step.pc);
+                    loadInt(RCX, c, step.pc);
+                    as_.move(RAX, RDX);
+                    switch (op) {
+                        case OpCode::ADD:
+                            as_.add(RAX, RCX);
+                            break;
+                        case OpCode::SUB:
+                            as_.sub(RAX, RCX);
+                            break;
+                        case OpCode::MUL:
+                            as_.imul(RAX, RCX);
+                            guardExit(as_.jcc(OVERFLOW), step.pc);
+                            break;
+                        default:
+                            // DIV y MOD: el divisor 0 lanza el error desde el intérprete
+                            as_.test(RCX, RCX);
+                            guardExit(as_.jcc(EQUAL), step.pc);
+                            as_.cqo();
+                            as_.idiv(RCX);
+                            if (op == OpCode::MOD) as_.move(RAX, RDX);
+                            break;
+                    }
+                    storeInt(a, step.pc);
+                    return;
+                }
+                loadNumber(XMM1, c, step.c, step.pc);
+                loadNumber(XMM0, b, step.b, step.pc);
+                switch (op) {
+                    case OpCode::ADD:
+                        as_.addsd(XMM0, XMM1);
+                        break;
+                    case OpCode::SUB:
+                        as_.subsd(XMM0, XMM1);
+                        break;
+                    case OpCode::MUL:
+                        as_.mulsd(XMM0, XMM1);
+                        break;
+                    default: {
+                        // DIV: divisor 0.0 (o -0.0) al intérprete
+                        as_.load(RAX, RDI, slot(c));
+                        if (step.c == Kind::INT) {
+                            as_.shl(RAX, 13);
+                        } else {
+                            as_.shl(RAX, 1);
+                        }
+                        guardExit(as_.jcc(EQUAL), step.pc);
+                        as_.divsd(XMM0, XMM1);
+                        break;
+                    }
+                }
+                storeFloat(a, step.pc);
+            }
+
+            void negate(const TraceStep& step) {
+                uint32_t a = argA(step.instr);
+                uint32_t b = argB(step.instr);
+                if (step.b == Kind::INT) {
+                    loadInt(RAX, b, step.pc);
+                    as_.neg(RAX);
+                    storeInt(a, step.pc);
+                    return;
+                }
+                guardFloat(b, step.pc);
+                as_.load(RAX, RDI, slot(b));
+                as_.moveImm(RCX, kSignBit);
+                as_.xorR(RAX, RCX);
+                as_.store(RDI, slot(a), RAX);
+                known_[a] = Kind::FLOAT;
+            }
+
+            void compare(const TraceStep& step) {
+                Instr instr = step.instr;
+                OpCode op = opOf(instr);
+                uint32_t a = argA(instr);
+                uint32_t b = argB(instr);
+                uint32_t c = argC(instr);
+                if (step.b == Kind::INT && step.c == Kind::INT) {
+                    loadInt(RDX, b, step.pc);
+                    loadInt(RCX, c, step.pc);
+                    as_.cmp(RDX, RCX);
+                    as_.setAl(op == OpCode::EQ ? EQUAL : op == OpCode::NE ? NOT_EQUAL : op == OpCode::LT ? LESS : LESS_EQUAL);
+                } else {
+                    // Sin NaN (las guardas lo excluyen) ucomisd ordena como la comparación de C++
+                    loadNumber(XMM1, c, step.c, step.pc);
+                    loadNumber(XMM0, b, step.b, step.pc);
+                    as_.ucomisd(XMM0, XMM1);
+                    as_.setAl(op == OpCode::EQ ? EQUAL : op == OpCode::NE ? NOT_EQUAL : op == OpCode::LT ? BELOW : BELOW_EQUAL);
+                }
+                storeBool(a);
+            }
+
+            void branch(const TraceStep& step) {
+                uint32_t a = argA(step.instr);
+                const Instr* fallthrough = step.pc + 1;
+                const Instr* target = fallthrough + argSBx(step.instr);
+                // Camino grabado: con el valor verdadero en JMPIF tomado o JMPIFNOT no tomado
+                bool truthyRecorded = (opOf(step.instr) == OpCode::JMPIF) == step.taken;
+                as_.load(RAX, RDI, slot(a));
+                truthiness(a);
+                leaveTo(as_.jcc(truthyRecorded ? EQUAL : NOT_EQUAL), step.taken ? fallthrough : target);
+            }
+
+            void forLoop(const TraceStep& step, size_t loop) {
+                uint32_t a = argA(step.instr);
+                const Instr* after = step.pc + 1;
+                if (step.b == Kind::INT) {
+                    guardInt(a + 1, step.pc);
+                    guardInt(a + 2, step.pc);
+                    loadInt(RCX, a + 2, step.pc);
+                    as_.test(RCX, RCX);
+                    guardExit(as_.jcc(step.taken ? LESS_EQUAL : GREATER_EQUAL), step.pc);
+                    loadInt(RAX, a, step.pc);
+                    as_.add(RAX, RCX);
+                    storeInt(a, step.pc);
+                    as_.shl(RAX, 13);
+                    as_.sar(RAX, 13);
+                    loadInt(RDX, a + 1, step.pc);
+                    as_.cmp(RAX, RDX);
+                    loopJump(as_.jcc(step.taken ? LESS : GREATER), loop);
+                } else {
+                    guardFloat(a + 1, step.pc);
+                    guardFloat(a + 2, step.pc);
+                    as_.load(RAX, RDI, slot(a + 2));
+                    as_.test(RAX, RAX);
+                    guardExit(as_.jcc(step.taken ? SIGN : NOT_SIGN), step.pc);
+                    guardFloat(a, step.pc);
+                    as_.loadXmm(XMM0, RDI, slot(a));
+                    as_.loadXmm(XMM1, RDI, slot(a + 2));
+                    as_.addsd(XMM0, XMM1);
+                    storeFloat(a, step.pc);
+                    as_.loadXmm(XMM1, RDI, slot(a + 1));
+                    as_.ucomisd(XMM0, XMM1);
+                    loopJump(as_.jcc(step.taken ? BELOW : ABOVE), loop);
+                }
+                leaveTo(as_.jmp(), after);
+            }
+
+            // rax = datos del ARRAY tipado de R[reg] con el tipo de elemento grabado
+            void typedData(uint32_t reg, ElementType element, const TypedLayout& layout, const Instr* at) {
+                as_.load(RAX, RDI, slot(reg));
+                as_.moveImm(R10, kPointerMask);
+                as_.andR(RAX, R10);
+                as_.loadByte(RCX, RAX, layout.element);
+                as_.cmpImm8(RCX, static_cast<int8_t>(element));
+                guardExit(as_.jcc(NOT_EQUAL), at);
+                as_.load(RAX, RAX, element == ElementType::INT ? layout.ints : layout.floats);
+            }
+
+            void typedAccess(const TraceStep& step, const TypedLayout& layout) {
+                Instr instr = step.instr;
+                uint32_t a = argA(instr);
+                uint32_t b = argB(instr);
+                uint32_t c = argC(instr);
+                if (opOf(instr) == OpCode::GETTYPED) {
+                    // R[A] = R[B][R[C]]: el generador de código ya comprobó los límites
+                    guardInt(c, step.pc);
+                    typedData(b, step.element, layout, step.pc);
+                    as_.load(RCX, RDI, slot(c));
+                    as_.shl(RCX, 13);
+                    as_.sar(RCX, 13);
+                    if (step.element == ElementType::INT) {
+                        as_.load(RAX, RAX, 0, RCX);
+                        storeInt(a, step.pc);
+                    } else {
+                        as_.loadXmm(XMM0, RAX, 0, RCX);
+                        storeFloat(a, step.pc);
+                    }
+                    return;
+                }
+                // R[A][R[B]] = R[C]; un INT se guarda en un ARRAY<FLOAT> convertido
+                guardInt(b, step.pc);
+                if (step.c == Kind::INT) {
+                    guardInt(c, step.pc);
+                } else {
+                    guardFloat(c, step.pc);
+                }
+                typedData(a, step.element, layout, step.pc);
+                as_.load(RCX, RDI, slot(b));
+                as_.shl(RCX, 13);
+                as_.sar(RCX, 13);
+                if (step.c == Kind::INT) {
+                    as_.load(RDX, RDI, slot(c));
+                    as_.shl(RDX, 13);
+                    as_.sar(RDX, 13);
+                    if (step.element == ElementType::INT) {
+                        as_.store(RAX, 0, RDX, RCX);
+                    } else {
+                        as_.cvtsi2sd(XMM0, RDX);
+                        as_.storeXmm(RAX, 0, XMM0, RCX);
+                    }
+                } else {
+                    as_.load(RDX, RDI, slot(c));
+                    as_.store(RAX, 0, RDX, RCX);
+                }
+            }
+
+            bool install() {
+                const std::vector<uint8_t>& code = as_.code();
+                size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+                size_t size = (code.size() + page - 1) / page * page;
+                void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (memory == MAP_FAILED) return false;
+                std::memcpy(memory, code.data(), code.size());
+                if (::mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+                    ::munmap(memory, size);
+                    return false;
+                }
+                trace_.memory = memory;
+                trace_.size = size;
+                trace_.entry = reinterpret_cast<Trace::Entry>(memory);
+                return true;
+            }
+        };
+
+#endif // MC_JIT_X64
+
+        bool compileTrace(const std::vector<TraceStep>& steps, Trace& trace) {
+#if defined(MC_JIT_X64)
+            return TraceCompiler(steps, trace).compile();
+#else
+            (void)steps;
+            (void)trace;
+            return false;
+#endif
+        }
+
+    } // namespace
+
+    bool Jit::supported() {
+#if defined(MC_JIT_X64)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    Jit::Jit(VM& vm) : vm_(vm) {}
+
+    Jit::~Jit() = default;
+
+    const Instr* Jit::hot(const FunctionProto* proto, const Instr* header, Value* regs, Value* globals) {
+        HotSlot& slot = slots_[(reinterpret_cast<uintptr_t>(header) >> 2) & (kSlots - 1)];
+        auto found = loops_.find(header);
+        if (slot.header != header) {
+            // La entrada era de otro bucle: se recupera lo que ya se sabe de éste
+            slot.header = header;
+            slot.trace = nullptr;
+            slot.countdown = kHotLoop;
+            if (found == loops_.end()) return header;
+            if (found->second.trace != nullptr) {
+                slot.trace = found->second.trace.get();
+                return run(*slot.trace, regs, globals);
+            }
+            if (found->second.blacklisted) slot.countdown = INT32_MAX;
+            return header;
+        }
+        LoopState& state = found != loops_.end() ? found->second : loops_[header];
+        if (state.blacklisted) {
+            slot.countdown = INT32_MAX;
+            return header;
+        }
+        slot.countdown = kHotLoop;
+        return record(proto, header, regs, globals, state);
+    }
+
+    const Instr* Jit::run(Trace& trace, Value* regs, Value* globals) {
+        ++stats_.entries;
+        const Trace::Exit& exit = trace.exits[trace.entry(regs, globals)];
+        const Instr* pc = exit.pc;
+        if (exit.side) {
+            ++stats_.sideExits;
+            // El bucle ya no sigue el camino grabado: se vuelve a grabar más adelante
+            if (++trace.sideExits > kSideExitGrace && trace.sideExits * kSideExitRatio > trace.iterations) {
+                discard(trace.header, loops_[trace.header]);
+            }
+        }
+        return pc;
+    }
+
+    void Jit::discard(const Instr* header, LoopState& state) {
+        HotSlot& slot = slots_[(reinterpret_cast<uintptr_t>(header) >> 2) & (kSlots - 1)];
+        if (slot.header == header) {
+            slot.trace = nullptr;
+            slot.countdown = kHotLoop;
+        }
+        state.trace.reset();
+        if (state.recordings >= kMaxRecordings) {
+            state.blacklisted = true;
+            ++stats_.blacklisted;
+            if (slot.header == header) slot.countdown = INT32_MAX;
+        }
+    }
+
+    const Instr* Jit::record(const FunctionProto* proto, const Instr* header, Value* regs, Value* globals,
+                             LoopState& state) {
+        ++state.recordings;
+        // Cada instrucción se ejecuta aquí mismo, con la semántica del intérprete, antes
+        // de pasar a la siguiente: al abandonar en `at` el intérprete sigue desde allí
+        auto abandon = [&](const Instr* at) {
+            ++stats_.aborts;
+            if (state.recordings >= kMaxRecordings) {
+                state.blacklisted = true;
+                ++stats_.blacklisted;
+            }
+            return at;
+        };
+
+        const TypedLayout& layout = typedLayout();
+        const Value* K = proto->constants.data();
+        const Instr* begin = proto->codeBegin();
+        const Instr* end = begin + proto->codeSize();
+        Value* R = regs;
+        std::vector<TraceStep> steps;
+        const Instr* pc = header;
+        for (bool closed = false; !closed;) {
+            if (steps.size() >= kMaxTraceLength || pc < begin || pc >= end) return abandon(pc);
+            const Instr* at = pc;
+            // Una superinstrucción se graba como su primera instrucción; la segunda sigue detrás
+            Instr instr = unfuse(*pc++);
+            TraceStep step;
+            step.pc = at;
+            step.instr = instr;
+            uint32_t a = argA(instr);
+            OpCode op = opOf(instr);
+            switch (op) {
+                case OpCode::NOP:
+                    continue;
+                case OpCode::MOVE:
+                    R[a] = R[argB(instr)];
+                    break;
+                case OpCode::LOADK:
+                    step.constant = K[argBx(instr)];
+                    R[a] = step.constant;
+                    break;
+                case OpCode::LOADI:
+                    R[a] = Value::integer(argSBx(instr));
+                    break;
+                case OpCode::LOADBOOL:
+                    R[a] = Value::boolean(argB(instr) != 0);
+                    break;
+                case OpCode::LOADNIL:
+                    R[a] = Value::nil();
+                    break;
+                case OpCode::GETGLOBAL:
+                    R[a] = globals[argBx(instr)];
+                    break;
+                case OpCode::SETGLOBAL:
+                    globals[argBx(instr)] = R[a];
+                    break;
+                case OpCode::ADD:
+                case OpCode::SUB:
+                case OpCode::MUL:
+                case OpCode::DIV:
+                case OpCode::MOD:
+                case OpCode::EQ:
+                case OpCode::NE:
+                case OpCode::LT:
+                case OpCode::LE: {
+                    // Sólo números; la división por cero y el MOD de FLOAT (fmod) se interpretan
+                    Value b = R[argB(instr)];
+                    Value c = R[argC(instr)];
+                    if (!b.isNumber() || !c.isNumber()) return abandon(at);
+                    if ((op == OpCode::DIV || op == OpCode::MOD) && c.asNumber() == 0.0) return abandon(at);
+                    if (op == OpCode::MOD && (!b.isInt() || !c.isInt())) return abandon(at);
+                    step.b = kindOf(b);
+                    step.c = kindOf(c);
+                    R[a] = vm_.evaluate(op, b, c);
+                    break;
+                }
+                case OpCode::NEG: {
+                    Value b = R[argB(instr)];
+                    if (!b.isNumber()) return abandon(at);
+                    step.b = kindOf(b);
+                    R[a] = vm_.evaluate(op, b, Value::nil());
+                    break;
+                }
+                case OpCode::NOT:
+                    R[a] = Value::boolean(!R[argB(instr)].isTruthy());
+                    break;
+                case OpCode::JMP:
+                    if (argSBx(instr) >= 0) {
+                        pc += argSBx(instr);
+                        continue;
+                    }
+                    // Sólo el salto que cierra este bucle; un bucle interno no se graba
+                    if (pc + argSBx(instr) != header) return abandon(at);
+                    pc = header;
+                    closed = true;
+                    break;
+                case OpCode::JMPIF:
+                case OpCode::JMPIFNOT:
+                    step.taken = R[a].isTruthy() == (op == OpCode::JMPIF);
+                    if (step.taken) pc += argSBx(instr);
+                    break;
+                case OpCode::FORLOOP: {
+                    if (pc + argSBx(instr) != header) return abandon(at);
+                    Value* r = R + a;
+                    bool more;
+                    if (r[0].isInt()) {
+                        if (!r[1].isInt() || !r[2].isInt()) return abandon(at);
+                        int64_t i = r[0].asInt() + r[2].asInt();
+                        if (!Value::fitsInt(i)) return abandon(at);
+                        r[0] = Value::integer(i);
+                        more = r[2].asInt() > 0 ? i < r[1].asInt() : i > r[1].asInt();
+                    } else {
+                        if (!r[1].isFloat() || !r[2].isFloat()) return abandon(at);
+                        double i = r[0].asFloat() + r[2].asFloat();
+                        r[0] = Value::number(i);
+                        more = r[2].asFloat() > 0 ? i < r[1].asFloat() : i > r[1].asFloat();
+                    }
+                    step.b = kindOf(r[0]);
+                    step.taken = r[2].isInt() ? r[2].asInt() > 0 : r[2].asFloat() > 0;
+                    // El bucle terminó mientras se grababa: no hay iteración que repetir
+                    if (!more) return abandon(pc);
+                    pc = header;
+                    closed = true;
+                    break;
+                }
+                case OpCode::GETTYPED: {
+                    if (!layout.valid || !R[argC(instr)].isInt()) return abandon(at);
+                    const ObjTypedArray* array = asTypedArray(R[argB(instr)]);
+                    size_t index = static_cast<size_t>(R[argC(instr)].asInt());
+                    step.element = array->elementType;
+                    R[a] = array->get(index);
+                    break;
+                }
+                case OpCode::SETTYPED: {
+                    ObjTypedArray* array = asTypedArray(R[a]);
+                    Value value = R[argC(instr)];
+                    bool fits = array->elementType == ElementType::INT ? value.isInt() : value.isNumber();
+                    if (!layout.valid || !R[argB(instr)].isInt() || !fits) return abandon(at);
+                    step.element = array->elementType;
+                    step.c = kindOf(value);
+                    array->set(static_cast<size_t>(R[argB(instr)].asInt()), value);
+                    break;
+                }
+                default:
+                    return abandon(at);
+            }
+            steps.push_back(step);
+        }
+
+        // La iteración grabada ya se ejecutó: el intérprete está de nuevo en la cabecera
+        auto trace = std::make_unique<Trace>();
+        trace->header = header;
+        if (!compileTrace(steps, *trace)) return abandon(header);
+        ++stats_.traces;
+        state.trace = std::move(trace);
+        HotSlot& slot = slots_[(reinterpret_cast<uintptr_t>(header) >> 2) & (kSlots - 1)];
+        slot.trace = state.trace.get();
+        return run(*slot.trace, regs, globals);
+    }
+
+} // namespace mc_core
@@ -0,0 +1,109 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "bytecode.h"
+#include "value.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mc_core {
+
+    class VM;
+    struct Trace;
+
+    /**
+     * Compilador de trazas a x86-64 para los bucles calientes (PARA y MIENTRAS).
+     *
+     * El bucle de despacho avisa en cada salto hacia atrás. Tras kHotLoop vueltas el
+     * bucle se graba: el grabador ejecuta una iteración completa anotando el camino
+     * seguido y el tipo (INT o FLOAT) de cada operando. Si toda la iteración cae en el
+     * subconjunto admitido (movimientos, constantes, globales, aritmética y
+     * comparaciones numéricas, saltos, FORLOOP y accesos a ARRAY tipados), el camino se
+     * traduce a código nativo en páginas obtenidas con mmap, que sólo pasan a
+     * ejecutables una vez escritas.
+     *
+     * La traza trabaja directamente sobre los registros del marco en memoria, así que
+     * salir de ella no exige reconstruir nada: cada guarda (tipo de un operando,
+     * desbordamiento del INT de 51 bits, división por cero, NaN, dirección de un
+     * salto) devuelve la instrucción en la que sigue el intérprete, que la ejecuta
+     * con su semántica completa. Una traza que sale por guardas en más de una de cada
+     * kSideExitRatio iteraciones se descarta y el bucle se vuelve a grabar; tras
+     * kMaxRecordings intentos fallidos queda en el intérprete.
+     *
+     * Sólo el hilo principal usa el compilador: los VM de PARA PARALELO, COUNTING y
+     * PROFILING interpretan siempre.
+     */
+    class Jit {
+    public:
+        static constexpr int32_t kHotLoop = 56;
+        static constexpr uint32_t kMaxRecordings = 4;
+        static constexpr size_t kMaxTraceLength = 400;
+        static constexpr uint64_t kSideExitRatio = 8;
+
+        struct Stats {
+            uint64_t traces = 0;        // Trazas compiladas
+            uint64_t aborts = 0;        // Grabaciones abandonadas
+            uint64_t blacklisted = 0;   // Bucles que se quedan en el intérprete
+            uint64_t entries = 0;       // Entradas en código nativo
+            uint64_t sideExits = 0;     // Salidas por una guarda (no por el final del bucle)
+        };
+
+        // true si esta compilación genera código nativo (x86-64 con mmap)
+        static bool supported();
+
+        explicit Jit(VM& vm);
+        ~Jit();
+        Jit(const Jit&) = delete;
+        Jit& operator=(const Jit&) = delete;
+
+        /**
+         * Salto hacia atrás a `header` en un marco de `proto` con registros `regs`.
+         * Devuelve la instrucción en la que sigue el intérprete: `header` si el bucle
+         * sigue interpretado, o la salida de la traza tras ejecutarla.
+         */
+        const Instr* loop(const FunctionProto* proto, const Instr* header, Value* regs, Value* globals) {
+            HotSlot& slot = slots_[(reinterpret_cast<uintptr_t>(header) >> 2) & (kSlots - 1)];
+            if (slot.header == header) {
+                if (slot.trace != nullptr) return run(*slot.trace, regs, globals);
+                if (--slot.countdown > 0) return header;
+            }
+            return hot(proto, header, regs, globals);
+        }
+
+        const Stats& stats() const { return stats_; }
+
+    private:
+        // Contadores de vueltas por cabecera de bucle (tabla directa; las colisiones
+        // sólo retrasan la detección)
+        static constexpr size_t kSlots = 256;
+        struct HotSlot {
+            const Instr* header = nullptr;
+            Trace* trace = nullptr;
+            int32_t countdown = 0;
+        };
+
+        struct LoopState {
+            std::unique_ptr<Trace> trace;
+            uint32_t recordings = 0;
+            bool blacklisted = false;
+        };
+
+        VM& vm_;
+        HotSlot slots_[kSlots];
+        std::unordered_map<const Instr*, LoopState> loops_;
+        Stats stats_;
+
+        const Instr* hot(const FunctionProto* proto, const Instr* header, Value* regs, Value* globals);
+        const Instr* run(Trace& trace, Value* regs, Value* globals);
+        const Instr* record(const FunctionProto* proto, const Instr* header, Value* regs, Value* globals,
+                            LoopState& state);
+        void discard(const Instr* header, LoopState& state);
+    };
+
+} // namespace mc_core
+
+#endif // JIT_H
@@ -0,0 +1,285 @@
+#include "lexer.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace mc_core {
+
+    namespace {
+
+        struct Keyword {
+            std::string_view text;
+            TokenKind kind;
+        };
+
+        // Tabla de palabras clave. Las variantes con tilde y los alias en inglés
+        // presentes en los ejemplos se asignan al mismo token.
+        const Keyword kKeywords[] = {
+            {"FUNC", TokenKind::KW_FUNC},
+            {"VAR", TokenKind::KW_VAR},
+            {"CONST", TokenKind::KW_CONST},
+            {"SI", TokenKind::KW_SI},
+            {"SINO", TokenKind::KW_SINO},
+            {"MAS", TokenKind::KW_MAS},
+            {"MÁS", TokenKind::KW_MAS},
+            {"MAS_SI", TokenKind::KW_MAS_SI},
+            {"MÁS_SI", TokenKind::KW_MAS_SI},
+            {"ENTONCES", TokenKind::KW_ENTONCES},
+            {"PARA", TokenKind::KW_PARA},
+            {"CADA", TokenKind::KW_CADA},
+            {"EN", TokenKind::KW_EN},
+            {"DESDE", TokenKind::KW_DESDE},
+            {"HASTA", TokenKind::KW_HASTA},
+            {"INCREMENTO", TokenKind::KW_INCREMENTO},
+            {"HACER", TokenKind::KW_HACER},
+            {"MIENTRAS", TokenKind::KW_MIENTRAS},
+            {"RETORNAR", TokenKind::KW_RETORNAR},
+            {"ROMPER", TokenKind::KW_ROMPER},
+            {"CONTINUAR", TokenKind::KW_CONTINUAR},
+            {"SELECCION", TokenKind::KW_SELECCION},
+            {"SELECCIÓN", TokenKind::KW_SELECCION},
+            {"SWITCH", TokenKind::KW_SELECCION},
+            {"CASO", TokenKind::KW_CASO},
+            {"DEFECTO", TokenKind::KW_DEFECTO},
+            {"STRUCT", TokenKind::KW_STRUCT},
+            {"CLASE", TokenKind::KW_CLASE},
+            {"CONSTRUCTOR", TokenKind::KW_CONSTRUCTOR},
+            {"PUBLICO", TokenKind::KW_PUBLICO},
+            {"PÚBLICO", TokenKind::KW_PUBLICO},
+            {"PRIVADO", TokenKind::KW_PRIVADO},
+            {"IMPORTAR", TokenKind::KW_IMPORTAR},
+            {"MODULO", TokenKind::KW_MODULO},
+            {"MÓDULO", TokenKind::KW_MODULO},
+            {"VERDADERO", TokenKind::KW_VERDADERO},
+            {"TRUE", TokenKind::KW_VERDADERO},
+            {"FALSO", TokenKind::KW_FALSO},
+            {"FALSE", TokenKind::KW_FALSO},
+            {"NULO", TokenKind::KW_NULO},
+            {"Y", TokenKind::KW_Y},
+            {"O", TokenKind::KW_O},
+            {"NO", TokenKind::KW_NO},
+        };
+
+        inline bool isDigit(unsigned char c) { return c >= '0' && c <= '9'; }
+
+        inline bool isIdentStart(unsigned char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+        }
+
+        inline bool isIdentChar(unsigned char c) { return isIdentStart(c) || isDigit(c); }
+
+        // Las palabras clave empiezan siempre por mayúscula (o por un byte UTF-8 inicial)
+        TokenKind lookupKeyword(std::string_view word) {
+            unsigned char first = static_cast<unsigned char>(word[0]);
+            if (!(first >= 'A' && first <= 'Z') || word.size() > 12) {
+                return TokenKind::IDENT;
+            }
+            for (const Keyword& kw : kKeywords) {
+                if (kw.text == word) {
+                    return kw.kind;
+                }
+            }
+            return TokenKind::IDENT;
+        }
+
+    } // namespace
+
+    Lexer::Lexer(std::string_view source)
+        : source_(source), cur_(source.data()), end_(source.data() + source.size()) {
+        // Omitir BOM UTF-8 si existe
+        if (source_.size() >= 3 && std::memcmp(cur_, "\xEF\xBB\xBF", 3) == 0) {
+            cur_ += 3;
+        }
+    }
+
+    bool Lexer::skipTrivia() {
+        bool newline = false;
+        while (cur_ < end_) {
+            char c = *cur_;
+            if (c == '\n') {
+                newline = true;
+                ++line_;
+                ++cur_;
+            } else if (c == ' ' || c == '\t' || c == '\r') {
+                ++cur_;
+            } else if (c == '/' && cur_ + 1 < end_ && cur_[1] == '/') {
+                const void* nl = std::memchr(cur_, '\n', end_ - cur_);
+                cur_ = nl ? static_cast<const char*>(nl) : end_;
+            } else if (c == '/' && cur_ + 1 < end_ && cur_[1] == '*') {
+                uint32_t startLine = line_;
+                cur_ += 2;
+                while (cur_ < end_ && !(cur_[0] == '*' && cur_ + 1 < end_ && cur_[1] == '/')) {
+                    if (*cur_ == '\n') {
+                        newline = true;
+                        ++line_;
+                    }
+                    ++cur_;
+                }
+                if (cur_ >= end_) {
+                    throw SyntaxError("comentario de bloque sin cerrar", startLine);
+                }
+                cur_ += 2;
+            } else {
+                break;
+            }
+        }
+        return newline;
+    }
+
+    Token Lexer::next() {
+        Token token;
+        token.newlineBefore = skipTrivia();
+        token.line = line_;
+        token.offset = static_cast<uint32_t>(cur_ - source_.data());
+
+        if (cur_ >= end_) {
+            token.kind = TokenKind::END;
+            return token;
+        }
+
+        unsigned char c = static_cast<unsigned char>(*cur_);
+        if (isDigit(c)) return lexNumber(token);
+        if (c == '"' || c == '\'') return lexString(token);
+        if (isIdentStart(c)) return lexIdentifier(token);
+
+        auto match = [this](char expected) {
+            if (cur_ < end_ && *cur_ == expected) {
+                ++cur_;
+                return true;
+            }
+            return false;
+        };
+
+        ++cur_;
+        switch (c) {
+            case '(': token.kind = TokenKind::LPAREN; break;
+            case ')': token.kind = TokenKind::RPAREN; break;
+            case '{': token.kind = TokenKind::LBRACE; break;
+            case '}': token.kind = TokenKind::RBRACE; break;
+            case '[': token.kind = TokenKind::LBRACKET; break;
+            case ']': token.kind = TokenKind::RBRACKET; break;
+            case ',': token.kind = TokenKind::COMMA; break;
+            case ':': token.kind = TokenKind::COLON; break;
+            case ';': token.kind = TokenKind::SEMICOLON; break;
+            case '.': token.kind = TokenKind::DOT; break;
+            case '%': token.kind = TokenKind::PERCENT; break;
+            case '+': token.kind = match('=') ? TokenKind::PLUS_ASSIGN : TokenKind::PLUS; break;
+            case '-': token.kind = match('=') ? TokenKind::MINUS_ASSIGN : TokenKind::MINUS; break;
+            case '*': token.kind = match('=') ? TokenKind::STAR_ASSIGN : TokenKind::STAR; break;
+            case '/': token.kind = match('=') ? TokenKind::SLASH_ASSIGN : TokenKind::SLASH; break;
+            case '=': token.kind = match('=') ? TokenKind::EQ : TokenKind::ASSIGN; break;
+            case '!': token.kind = match('=') ? TokenKind::NE : TokenKind::BANG; break;
+            case '<': token.kind = match('=') ? TokenKind::LE : TokenKind::LT; break;
+            case '>': token.kind = match('=') ? TokenKind::GE : TokenKind::GT; break;
+            case '&':
+                if (!match('&')) throw SyntaxError("se esperaba '&&'", line_);
+                token.kind = TokenKind::AND_AND;
+                break;
+            case '|':
+                if (!match('|')) throw SyntaxError("se esperaba '||'", line_);
+                token.kind = TokenKind::OR_OR;
+                break;
+            default:
+                throw SyntaxError(std::string("carácter inesperado '") + static_cast<char>(c) + "'", line_);
+        }
+        token.length = static_cast<uint32_t>(cur_ - source_.data()) - token.offset;
+        return token;
+    }
+
+    Token Lexer::lexNumber(Token token) {
+        const char* start = cur_;
+        bool isFloat = false;
+        while (cur_ < end_ && isDigit(*cur_)) ++cur_;
+        if (cur_ + 1 < end_ && *cur_ == '.' && isDigit(cur_[1])) {
+            isFloat = true;
+            ++cur_;
+            while (cur_ < end_ && isDigit(*cur_)) ++cur_;
+        }
+        if (cur_ < end_ && (*cur_ == 'e' || *cur_ == 'E')) {
+            const char* save = cur_;
+            ++cur_;
+            if (cur_ < end_ && (*cur_ == '+' || *cur_ == '-')) ++cur_;
+            if (cur_ < end_ && isDigit(*cur_)) {
+                isFloat = true;
+                while (cur_ < end_ && isDigit(*cur_)) ++cur_;
+            } else {
+                cur_ = save;
+            }
+        }
+
+        token.length = static_cast<uint32_t>(cur_ - start);
+        if (isFloat) {
+            token.kind = TokenKind::FLOAT_LIT;
+            // strtod necesita un buffer terminado en nulo
+            std::string text(start, cur_);
+            token.floatValue = std::strtod(text.c_str(), nullptr);
+        } else {
+            token.kind = TokenKind::INT_LIT;
+            uint64_t value = 0;
+            for (const char* p = start; p < cur_; ++p) {
+                uint64_t digit = static_cast<uint64_t>(*p - '0');
+                if (value > (static_cast<uint64_t>(INT64_MAX) - digit) / 10) {
+                    throw SyntaxError("literal entero fuera de rango", token.line);
+                }
+                value = value * 10 + digit;
+            }
+            token.intValue = static_cast<int64_t>(value);
+        }
+        return token;
+    }
+
+    Token Lexer::lexString(Token token) {
+        char quote = *cur_++;  // comilla de apertura (doble o simple)
+        while (cur_ < end_ && *cur_ != quote) {
+            if (*cur_ == '\\' && cur_ + 1 < end_) {
+                ++cur_;
+            }
+            if (*cur_ == '\n') {
+                throw SyntaxError("cadena sin cerrar", token.line);
+            }
+            ++cur_;
+        }
+        if (cur_ >= end_) {
+            throw SyntaxError("cadena sin cerrar", token.line);
+        }
+        ++cur_;  // comilla de cierre
+        token.kind = TokenKind::STRING_LIT;
+        token.length = static_cast<uint32_t>(cur_ - source_.data()) - token.offset;
+        return token;
+    }
+
+    Token Lexer::lexIdentifier(Token token) {
+        const char* start = cur_;
+        while (cur_ < end_ && isIdentChar(static_cast<unsigned char>(*cur_))) ++cur_;
+        token.length = static_cast<uint32_t>(cur_ - start);
+        token.kind = lookupKeyword(std::string_view(start, token.length));
+        return token;
+    }
+
+    const char* Lexer::kindName(TokenKind kind) {
+        switch (kind) {
+            case TokenKind::END: return "fin de archivo";
+            case TokenKind::IDENT: return "identificador";
+            case TokenKind::INT_LIT: return "entero";
+            case TokenKind::FLOAT_LIT: return "decimal";
+            case TokenKind::STRING_LIT: return "cadena";
+            case TokenKind::LPAREN: return "'('";
+            case TokenKind::RPAREN: return "')'";
+            case TokenKind::LBRACE: return "'{'";
+            case TokenKind::RBRACE: return "'}'";
+            case TokenKind::LBRACKET: return "'['";
+            case TokenKind::RBRACKET: return "']'";
+            case TokenKind::COMMA: return "','";
+            case TokenKind::COLON: return "':'";
+            case TokenKind::DOT: return "'.'";
+            case TokenKind::ASSIGN: return "'='";
+            case TokenKind::LT: return "'<'";
+            case TokenKind::GT: return "'>'";
+            default: break;
+        }
+        for (const Keyword& kw : kKeywords) {
+            if (kw.kind == kind) return kw.text.data();
+        }
+        return "operador";
+    }
+
+} // namespace mc_core
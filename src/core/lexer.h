@@ -0,0 +1,156 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace mc_core {
+
+    // Categorías de tokens reconocidas por el analizador léxico de MC++
+    enum class TokenKind : uint8_t {
+        // Fin de entrada
+        END,
+
+        // Literales e identificadores
+        IDENT,
+        INT_LIT,
+        FLOAT_LIT,
+        STRING_LIT,
+
+        // Palabras clave
+        KW_FUNC,
+        KW_VAR,
+        KW_CONST,
+        KW_SI,
+        KW_SINO,
+        KW_MAS,          // MAS / MÁS (rama alternativa)
+        KW_MAS_SI,       // MÁS_SI
+        KW_ENTONCES,
+        KW_PARA,
+        KW_CADA,
+        KW_EN,
+        KW_DESDE,
+        KW_HASTA,
+        KW_INCREMENTO,
+        KW_HACER,
+        KW_MIENTRAS,
+        KW_RETORNAR,
+        KW_ROMPER,
+        KW_CONTINUAR,
+        KW_SELECCION,    // SELECCION / SELECCIÓN / SWITCH
+        KW_CASO,
+        KW_DEFECTO,
+        KW_STRUCT,
+        KW_CLASE,
+        KW_CONSTRUCTOR,
+        KW_PUBLICO,
+        KW_PRIVADO,
+        KW_IMPORTAR,
+        KW_MODULO,
+        KW_VERDADERO,    // VERDADERO / TRUE
+        KW_FALSO,        // FALSO / FALSE
+        KW_NULO,
+        KW_Y,
+        KW_O,
+        KW_NO,
+
+        // Puntuación
+        LPAREN,
+        RPAREN,
+        LBRACE,
+        RBRACE,
+        LBRACKET,
+        RBRACKET,
+        COMMA,
+        COLON,
+        SEMICOLON,
+        DOT,
+
+        // Operadores
+        PLUS,
+        MINUS,
+        STAR,
+        SLASH,
+        PERCENT,
+        ASSIGN,
+        PLUS_ASSIGN,
+        MINUS_ASSIGN,
+        STAR_ASSIGN,
+        SLASH_ASSIGN,
+        EQ,
+        NE,
+        LT,
+        LE,
+        GT,
+        GE,
+        AND_AND,
+        OR_OR,
+        BANG
+    };
+
+    // Token producido por el lexer. No copia texto: referencia el buffer fuente.
+    struct Token {
+        TokenKind kind = TokenKind::END;
+        bool newlineBefore = false;  // Hubo un salto de línea entre este token y el anterior
+        uint32_t line = 1;
+        uint32_t offset = 0;         // Desplazamiento en bytes dentro del buffer fuente
+        uint32_t length = 0;
+        int64_t intValue = 0;
+        double floatValue = 0.0;
+    };
+
+    // Error de análisis léxico o sintáctico con la línea de origen
+    class SyntaxError : public std::runtime_error {
+    public:
+        SyntaxError(const std::string& message, uint32_t line)
+            : std::runtime_error("Error de sintaxis (línea " + std::to_string(line) + "): " + message),
+              line_(line) {}
+
+        uint32_t line() const { return line_; }
+
+    private:
+        uint32_t line_;
+    };
+
+    /**
+     * Analizador léxico de MC++.
+     *
+     * Funciona bajo demanda (pull): el parser solicita un token cada vez, de modo que
+     * nunca se materializa un vector de tokens para todo el archivo. Los identificadores
+     * admiten UTF-8 (PÚBLICO, SELECCIÓN, etc.).
+     */
+    class Lexer {
+    public:
+        explicit Lexer(std::string_view source);
+
+        // Devuelve el siguiente token de la entrada
+        Token next();
+
+        // Texto del token dentro del buffer fuente
+        std::string_view text(const Token& token) const {
+            return source_.substr(token.offset, token.length);
+        }
+
+        std::string_view source() const { return source_; }
+
+        // Nombre legible de un tipo de token (para mensajes de error)
+        static const char* kindName(TokenKind kind);
+
+    private:
+        std::string_view source_;
+        const char* cur_;
+        const char* end_;
+        uint32_t line_ = 1;
+
+        // Omite espacios y comentarios; devuelve true si cruzó un salto de línea
+        bool skipTrivia();
+        Token lexNumber(Token token);
+        Token lexString(Token token);
+        Token lexIdentifier(Token token);
+    };
+
+} // namespace mc_core
+
+#endif // LEXER_H
@@ -0,0 +1,58 @@
+#include "library_bindings.h"
+#include "native_binding.h"
+#include "../libraries/math/advanced_operations.h"
+#include "../libraries/math/combinatorics.h"
+#include "../libraries/string/basic_operations.h"
+#include "../libraries/string/text_transformation.h"
+#include <string>
+#include <vector>
+
+namespace mc_core {
+
+    namespace {
+
+        // Las funciones con parámetros por defecto se enlazan con la aridad que usan los scripts
+
+        std::string replaceAll(const std::string& text, const std::string& oldSub, const std::string& newSub) {
+            return BasicOperations::replace(text, oldSub, newSub);
+        }
+
+        std::vector<std::string> split(const std::string& text, const std::string& delimiter) {
+            return BasicOperations::split(text, delimiter);
+        }
+
+        // La biblioteca rechaza el inicio 0 en un texto vacío; en él no se encuentra nada
+        int indexOf(const std::string& text, const std::string& target) {
+            return text.empty() ? -1 : BasicOperations::indexOf(text, target);
+        }
+
+    } // namespace
+
+    void registerLibraryBindings(VM& vm) {
+        ObjModule* math = vm.findModule("math");
+        NativeBinding<&AdvancedOperations::log_base_n<double>>::define(vm, math, "logaritmo");
+        NativeBinding<&Combinatorics::factorial>::define(vm, math, "factorial");
+        NativeBinding<&Combinatorics::combination>::define(vm, math, "combinaciones");
+        NativeBinding<&Combinatorics::permutation>::define(vm, math, "permutaciones");
+
+        ObjModule* text = vm.defineModule("string_utils");
+        NativeBinding<&TextTransformation::toUpper>::define(vm, text, "toUpper");
+        NativeBinding<&TextTransformation::toLower>::define(vm, text, "toLower");
+        NativeBinding<&TextTransformation::capitalize>::define(vm, text, "capitalize");
+        NativeBinding<&TextTransformation::trim>::define(vm, text, "trim");
+        NativeBinding<&TextTransformation::removeWhitespace>::define(vm, text, "removeWhitespace");
+        NativeBinding<&TextTransformation::replaceChar>::define(vm, text, "replaceChar");
+        NativeBinding<&TextTransformation::toTitleCase>::define(vm, text, "toTitleCase");
+        NativeBinding<&TextTransformation::toSnakeCase>::define(vm, text, "toSnakeCase");
+        NativeBinding<&TextTransformation::toKebabCase>::define(vm, text, "toKebabCase");
+        NativeBinding<&BasicOperations::concatenate>::define(vm, text, "concatenate");
+        NativeBinding<&BasicOperations::substring>::define(vm, text, "substring");
+        NativeBinding<&indexOf>::define(vm, text, "indexOf");
+        NativeBinding<&replaceAll>::define(vm, text, "replaceAll");
+        NativeBinding<&split>::define(vm, text, "split");
+        NativeBinding<&BasicOperations::join>::define(vm, text, "join");
+        NativeBinding<&BasicOperations::reverse>::define(vm, text, "reverse");
+        NativeBinding<&BasicOperations::countChar>::define(vm, text, "countChar");
+    }
+
+} // namespace mc_core
@@ -0,0 +1,20 @@
+#ifndef LIBRARY_BINDINGS_H
+#define LIBRARY_BINDINGS_H
+
+#include "vm.h"
+
+namespace mc_core {
+
+    /**
+     * Registra en el VM las funciones de las bibliotecas de C++ (src/libraries) que se
+     * pueden llamar desde MC++, enlazadas con NativeBinding (native_binding.h):
+     *  - en el módulo "math", logaritmo y las de combinatoria;
+     *  - el módulo "string_utils", con las operaciones y transformaciones de la
+     *    biblioteca string bajo sus nombres de C++ (toUpper, split, replaceAll...).
+     * Requiere que el módulo "math" ya exista (lo llama registerBuiltins).
+     */
+    void registerLibraryBindings(VM& vm);
+
+} // namespace mc_core
+
+#endif // LIBRARY_BINDINGS_H
@@ -1,34 +1,85 @@
-#include "interpreter.h"
-#include "compiler.h"
-#include "config.h"
-#include <iostream>
-#include <stdexcept>
-
-int main(int argc, char* argv[]) {
-    // Inicialización de configuración global
-    Config::initialize();
-    
-    try {
-        if (argc > 1) {
-            std::string mode = argv[1];
-            if (mode == "interpret") {
-                Interpreter interpreter;
-                interpreter.run();
-            } else if (mode == "compile") {
-                Compiler compiler;
-                compiler.run();
-            } else {
-                std::cerr << "Error: Modo desconocido: " << mode << std::endl;
-                return 1;
-            }
-        } else {
-            std::cerr << "Uso: mc++ [interpret|compile]" << std::endl;
-            return 1;
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "Excepción capturada: " << e.what() << std::endl;
-        return 1;
-    }
-
-    return 0;
-}
+#include "interpreter.h"
+#include "compiler.h"
+#include "config.h"
+#include "repl.h"
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+int main(int argc, char* argv[]) {
+    // Inicialización de configuración global
+    Config::initialize();
+    
+    try {
+        if (argc > 1) {
+            std::string mode = argv[1];
+            if (mode == "interpret") {
+                if (argc < 3) {
+                    std::cerr << "Uso: mc++ interpret <archivo.mc> [-O0|-O1|-O2] [--no-cache] [--profile=salida.folded]" << std::endl;
+                    return 1;
+                }
+                bool useCache = true;
+                std::string profilePath;
+                int level = mc_core::kDefaultOptimizationLevel;
+                for (int i = 3; i < argc; ++i) {
+                    std::string option = argv[i];
+                    if (option == "--no-cache") {
+                        useCache = false;
+                    } else if (option.size() == 3 && option.compare(0, 2, "-O") == 0 && option[2] >= '0' &&
+                               option[2] <= '0' + mc_core::kMaxOptimizationLevel) {
+                        level = option[2] - '0';
+                    } else if (option.compare(0, 10, "--profile=") == 0 && option.size() > 10) {
+                        profilePath = option.substr(10);
+                    } else {
+                        std::cerr << "Error: Opción desconocida: " << option << std::endl;
+                        return 1;
+                    }
+                }
+                Interpreter interpreter(argv[2], useCache, profilePath, level);
+                interpreter.run();
+            } else if (mode == "compile") {
+                if (argc < 3) {
+                    std::cerr << "Uso: mc++ compile <archivo.mc> [-O0|-O1|-O2] [--dump] [--emit=cpp]" << std::endl;
+                    return 1;
+                }
+                bool dump = false;
+                bool emitCpp = false;
+                int level = mc_core::kDefaultOptimizationLevel;
+                for (int i = 3; i < argc; ++i) {
+                    std::string option = argv[i];
+                    if (option == "--dump") {
+                        dump = true;
+                    } else if (option == "--emit=cpp") {
+                        emitCpp = true;
+                    } else if (option.size() == 3 && option.compare(0, 2, "-O") == 0 && option[2] >= '0' &&
+                               option[2] <= '0' + mc_core::kMaxOptimizationLevel) {
+                        level = option[2] - '0';
+                    } else {
+                        std::cerr << "Error: Opción desconocida: " << option << std::endl;
+                        return 1;
+                    }
+                }
+                Compiler compiler(argv[2], dump, level, emitCpp);
+                compiler.run();
+            } else if (mode == "repl") {
+                if (argc > 2) {
+                    std::cerr << "Uso: mc++ repl" << std::endl;
+                    return 1;
+                }
+                mc_core::ReplSession session;
+                session.run(std::cin, std::cout, isatty(STDIN_FILENO) != 0);
+            } else {
+                std::cerr << "Error: Modo desconocido: " << mode << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Uso: mc++ [interpret <archivo.mc> [-O0|-O1|-O2] [--no-cache] [--profile=salida.folded]|compile <archivo.mc> [-O0|-O1|-O2] [--dump] [--emit=cpp]|repl]" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Excepción capturada: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
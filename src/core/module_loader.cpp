@@ -0,0 +1,326 @@
+#include "module_loader.h"
+#include "bytecode_cache.h"
+#include "codegen.h"
+#include "lexer.h"
+#include "parser.h"
+#include "source_file.h"
+#include "../utils/work_stealing_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mc_core {
+
+    namespace {
+
+        namespace fs = std::filesystem;
+
+        constexpr uint64_t kHashPrime = 0x100000001b3ULL;
+
+        // Hilos para analizar módulos: más no acelera la carga de un programa típico
+        constexpr size_t kMaxParseThreads = 8;
+
+        // IMPORTAR de un archivo y los MODULO que declara (esos nombres no son archivos)
+        struct ImportList {
+            std::vector<std::string> imports;
+            std::unordered_set<std::string> localModules;
+        };
+
+        // Módulo analizado; inmutable una vez publicado en la caché
+        struct ParsedModule {
+            AstArena arena;
+            NodeId root = kNoNode;
+            ImportList imports;
+        };
+
+        using ParsedFuture = std::shared_future<std::shared_ptr<const ParsedModule>>;
+
+        struct CacheEntry {
+            uintmax_t size;
+            fs::file_time_type modified;
+            ParsedFuture parsed;  // Quien llega mientras otro lo analiza espera el mismo resultado
+        };
+
+        struct ModuleCache {
+            std::mutex mutex;
+            std::unordered_map<std::string, CacheEntry> entries;  // Por ruta canónica
+            std::atomic<size_t> parses{0};
+        };
+
+        ModuleCache& moduleCache() {
+            static ModuleCache cache;
+            return cache;
+        }
+
+        struct ParsePool {
+            std::mutex mutex;  // run() admite un solo llamador a la vez
+            mc_utils::WorkStealingPool pool{
+                std::min(kMaxParseThreads, std::max<size_t>(1, std::thread::hardware_concurrency()))};
+        };
+
+        ParsePool& parsePool() {
+            static ParsePool pool;
+            return pool;
+        }
+
+        void collectImports(const AstArena& arena, NodeId owner, ImportList& list) {
+            const NodeId* items = arena.children(owner);
+            for (uint32_t i = 0; i < arena.childCount(owner); ++i) {
+                const AstNode& n = arena.node(items[i]);
+                if (n.kind == NodeKind::IMPORT) {
+                    list.imports.emplace_back(arena.str(n.v.str));
+                } else if (n.kind == NodeKind::MODULE_DECL) {
+                    list.localModules.emplace(arena.str(n.v.str));
+                    collectImports(arena, items[i], list);
+                }
+            }
+        }
+
+        // Lo mismo que collectImports, pero sólo con el lexer
+        ImportList scanImports(const std::string& source) {
+            ImportList list;
+            try {
+                Lexer lexer(source);
+                for (Token token = lexer.next(); token.kind != TokenKind::END; token = lexer.next()) {
+                    if (token.kind != TokenKind::KW_IMPORTAR && token.kind != TokenKind::KW_MODULO) continue;
+                    Token name = lexer.next();
+                    std::string_view text = lexer.text(name);
+                    if (name.kind == TokenKind::STRING_LIT && text.size() >= 2) {
+                        text = text.substr(1, text.size() - 2);
+                    } else if (name.kind == TokenKind::END) {
+                        break;
+                    } else if (name.kind != TokenKind::IDENT) {
+                        continue;
+                    }
+                    if (token.kind == TokenKind::KW_IMPORTAR) {
+                        list.imports.emplace_back(text);
+                    } else {
+                        list.localModules.emplace(text);
+                    }
+                }
+            } catch (const SyntaxError&) {
+                // El error se informa al analizar el programa
+            }
+            return list;
+        }
+
+        // nombre.mc en el directorio del importador o en MCPP_PATH; "" si no existe
+        std::string findModuleFile(const std::string& name, const fs::path& importerDir) {
+            std::vector<fs::path> dirs{importerDir};
+            const char* searchPath = std::getenv("MCPP_PATH");
+            if (searchPath != nullptr) {
+                std::string entries = searchPath;
+                size_t start = 0;
+                while (start <= entries.size()) {
+                    size_t end = entries.find(':', start);
+                    if (end == std::string::npos) end = entries.size();
+                    if (end > start) dirs.emplace_back(entries.substr(start, end - start));
+                    start = end + 1;
+                }
+            }
+            std::error_code error;
+            for (const fs::path& dir : dirs) {
+                fs::path candidate = dir / (name + ".mc");
+                if (fs::is_regular_file(candidate, error)) {
+                    fs::path canonical = fs::canonical(candidate, error);
+                    return error ? candidate.string() : canonical.string();
+                }
+            }
+            return "";
+        }
+
+        std::string canonicalPath(const std::string& path) {
+            std::error_code error;
+            fs::path canonical = fs::weakly_canonical(path, error);
+            return error ? path : canonical.string();
+        }
+
+        // Archivo del módulo que importa `importer`, o "" si el nombre no es un módulo de fuente
+        std::string moduleFile(const VM& vm, const std::string& name, const std::string& importer,
+                               const ImportList& list) {
+            if (list.localModules.count(name) || vm.findModule(name) != nullptr) return "";
+            std::string path = findModuleFile(name, fs::path(importer).parent_path());
+            return path == importer ? "" : path;
+        }
+
+        // Módulos analizados de `paths`: los que faltan en la caché o cambiaron se analizan en paralelo
+        std::vector<ParsedFuture> fetchModules(const std::vector<std::string>& paths) {
+            ModuleCache& cache = moduleCache();
+            std::vector<ParsedFuture> futures(paths.size());
+            std::vector<std::pair<size_t, std::promise<std::shared_ptr<const ParsedModule>>>> work;
+            {
+                std::lock_guard<std::mutex> lock(cache.mutex);
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    std::error_code error;
+                    uintmax_t size = fs::file_size(paths[i], error);
+                    fs::file_time_type modified = fs::last_write_time(paths[i], error);
+                    auto it = cache.entries.find(paths[i]);
+                    if (it != cache.entries.end() && it->second.size == size && it->second.modified == modified) {
+                        futures[i] = it->second.parsed;
+                        continue;
+                    }
+                    std::promise<std::shared_ptr<const ParsedModule>> promise;
+                    futures[i] = promise.get_future().share();
+                    cache.entries[paths[i]] = CacheEntry{size, modified, futures[i]};
+                    work.emplace_back(i, std::move(promise));
+                }
+            }
+
+            auto parse = [&](size_t k) {
+                auto& item = work[k];
+                try {
+                    auto module = std::make_shared<ParsedModule>();
+                    std::string source = readSourceFile(paths[item.first]);
+                    module->root = parseSource(source, module->arena);
+                    collectImports(module->arena, module->root, module->imports);
+                    cache.parses.fetch_add(1, std::memory_order_relaxed);
+                    item.second.set_value(std::move(module));
+                } catch (...) {
+                    item.second.set_exception(std::current_exception());
+                }
+            };
+            if (work.size() == 1) {
+                parse(0);
+            } else if (work.size() > 1) {
+                ParsePool& pool = parsePool();
+                std::lock_guard<std::mutex> lock(pool.mutex);
+                pool.pool.run(work.size(), [&](size_t, size_t k) { parse(k); });
+            }
+            return futures;
+        }
+
+        std::runtime_error moduleError(const std::string& name, const std::string& path, const std::string& what) {
+            return std::runtime_error("Error en el módulo " + name + " (" + path + "): " + what);
+        }
+
+    } // namespace
+
+    ModuleLoader::ModuleLoader(VM& vm, const std::string& programPath)
+        : vm_(vm), programPath_(canonicalPath(programPath)) {}
+
+    void ModuleLoader::load(const AstArena& arena, NodeId program) {
+        struct GraphNode {
+            std::string path;
+            std::shared_ptr<const ParsedModule> parsed;
+            std::vector<std::string> deps;
+        };
+        std::unordered_map<std::string, GraphNode> graph;
+        std::vector<std::string> level;
+
+        // Añade a `deps` los módulos de fuente de `list`; los que aún no están en el grafo van al siguiente nivel
+        auto resolveImports = [&](const ImportList& list, const std::string& importer, std::vector<std::string>& deps) {
+            for (const std::string& name : list.imports) {
+                // Ya compilado en este VM por un load() anterior
+                if (vm_.isSourceModule(name)) continue;
+                std::string path = moduleFile(vm_, name, importer, list);
+                if (path.empty()) continue;
+                auto inserted = graph.emplace(name, GraphNode{path, nullptr, {}});
+                if (inserted.second) {
+                    level.push_back(name);
+                } else if (inserted.first->second.path != path) {
+                    throw std::runtime_error("Error de importación: el módulo " + name + " corresponde a dos archivos: " +
+                                             inserted.first->second.path + " y " + path);
+                }
+                deps.push_back(name);
+            }
+        };
+
+        ImportList rootImports;
+        collectImports(arena, program, rootImports);
+        std::vector<std::string> roots;
+        resolveImports(rootImports, programPath_, roots);
+
+        // Cada nivel del grafo se analiza en paralelo
+        while (!level.empty()) {
+            std::vector<std::string> current;
+            current.swap(level);
+            std::vector<std::string> paths;
+            for (const std::string& name : current) paths.push_back(graph.at(name).path);
+            std::vector<ParsedFuture> parsed = fetchModules(paths);
+            for (size_t i = 0; i < current.size(); ++i) {
+                GraphNode& node = graph.at(current[i]);
+                try {
+                    node.parsed = parsed[i].get();
+                } catch (const std::exception& e) {
+                    throw moduleError(current[i], node.path, e.what());
+                }
+                resolveImports(node.parsed->imports, node.path, node.deps);
+            }
+        }
+
+        // Orden topológico: cada módulo después de los que importa
+        std::vector<std::string> order;
+        std::unordered_map<std::string, int> state;  // 1 = en la pila de visita, 2 = ordenado
+        std::vector<std::string> stack;
+        std::function<void(const std::string&)> visit = [&](const std::string& name) {
+            int current = state[name];
+            if (current == 2) return;
+            if (current == 1) {
+                std::string cycle;
+                for (auto it = std::find(stack.begin(), stack.end(), name); it != stack.end(); ++it) {
+                    cycle += *it + " -> ";
+                }
+                throw std::runtime_error("Error de importación: importación circular " + cycle + name);
+            }
+            state[name] = 1;
+            stack.push_back(name);
+            for (const std::string& dep : graph.at(name).deps) visit(dep);
+            stack.pop_back();
+            state[name] = 2;
+            order.push_back(name);
+        };
+        for (const std::string& name : roots) visit(name);
+
+        for (const std::string& name : order) {
+            const GraphNode& node = graph.at(name);
+            try {
+                vm_.addSourceModule(name, compileModule(vm_, node.parsed->arena, node.parsed->root, name));
+            } catch (const std::exception& e) {
+                throw moduleError(name, node.path, e.what());
+            }
+        }
+    }
+
+    uint64_t ModuleLoader::programHash(const std::string& source) const {
+        uint64_t hash = hashSource(source);
+        std::unordered_set<std::string> seen;
+        std::vector<std::pair<std::string, ImportList>> pending;
+        pending.emplace_back(programPath_, scanImports(source));
+        while (!pending.empty()) {
+            std::pair<std::string, ImportList> file = std::move(pending.back());
+            pending.pop_back();
+            for (const std::string& name : file.second.imports) {
+                std::string path = moduleFile(vm_, name, file.first, file.second);
+                if (path.empty() || !seen.insert(path).second) continue;
+                std::string text = readSourceFile(path);
+                hash = (hash ^ hashSource(path)) * kHashPrime;
+                hash = (hash ^ hashSource(text)) * kHashPrime;
+                pending.emplace_back(path, scanImports(text));
+            }
+        }
+        return hash;
+    }
+
+    size_t ModuleLoader::parsedModules() {
+        return moduleCache().parses.load(std::memory_order_relaxed);
+    }
+
+    void ModuleLoader::clearCache() {
+        ModuleCache& cache = moduleCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.entries.clear();
+    }
+
+} // namespace mc_core
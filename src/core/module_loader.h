@@ -0,0 +1,66 @@
+#ifndef MODULE_LOADER_H
+#define MODULE_LOADER_H
+
+#include "ast.h"
+#include "vm.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mc_core {
+
+    /**
+     * Cargador de módulos de fuente para IMPORTAR.
+     *
+     * Un IMPORTAR "nombre" que no es un módulo nativo del VM (math, gc...) ni un MODULO
+     * del propio archivo busca nombre.mc en el directorio del archivo que lo importa y
+     * después en cada directorio de MCPP_PATH (separados por ':'). El archivo se compila
+     * como si fuera MODULO nombre { ... }: sus declaraciones son globales "nombre.x".
+     * Un IMPORTAR sin archivo (o del propio archivo) sigue creando un módulo vacío.
+     *
+     * load() recorre el grafo de importaciones por niveles y analiza en paralelo, en un
+     * grupo de hilos, los módulos de cada nivel. Después los compila en el VM en orden
+     * topológico (una importación circular es un error). Cada módulo se compila una vez
+     * por VM aunque lo importen varios archivos, y su nivel superior se ejecuta una sola
+     * vez, al principio del programa.
+     *
+     * Los AST analizados viven en una caché de todo el proceso que comparten todos los
+     * VM (cada intérprete, cada prueba): un módulo sólo se vuelve a leer y analizar si
+     * su archivo cambia de tamaño o de fecha de modificación. Lo que no se comparte es
+     * el bytecode, porque sus constantes viven en el heap de cada VM.
+     */
+    class ModuleLoader {
+    public:
+        // programPath: ruta del programa principal (sus IMPORTAR se buscan junto a él)
+        ModuleLoader(VM& vm, const std::string& programPath);
+
+        /**
+         * Compila en el VM los módulos de fuente que importa `program`, directa o
+         * indirectamente, y los registra con VM::addSourceModule. Debe llamarse antes
+         * de compileProgram, que los inicializa al principio del script.
+         * @throw std::runtime_error Con el nombre y la ruta del módulo si no se puede
+         *        analizar o compilar, o si hay una importación circular.
+         */
+        void load(const AstArena& arena, NodeId program);
+
+        /**
+         * Hash del programa para la caché .mcc: el de `source` combinado con el de cada
+         * módulo de fuente que importa. Sólo lee los archivos y busca sus IMPORTAR con
+         * el lexer, sin analizarlos. Sin módulos de fuente es hashSource(source).
+         */
+        uint64_t programHash(const std::string& source) const;
+
+        // Análisis de módulos realizados en el proceso (los que no salieron de la caché)
+        static size_t parsedModules();
+
+        // Vacía la caché de AST del proceso
+        static void clearCache();
+
+    private:
+        VM& vm_;
+        std::string programPath_;
+    };
+
+} // namespace mc_core
+
+#endif // MODULE_LOADER_H
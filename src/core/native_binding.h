@@ -0,0 +1,350 @@
+#ifndef NATIVE_BINDING_H
+#define NATIVE_BINDING_H
+
+#include "vm.h"
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mc_core {
+
+    /**
+     * Puente entre las funciones de C++ de las bibliotecas y el VM, generado en tiempo
+     * de compilación a partir de la firma de cada función.
+     *
+     *     NativeBinding<&TextTransformation::toUpper>::define(vm, module, "mayusculas");
+     *
+     * registra una ObjNative cuya aridad es la de la función y cuyo NativeFn convierte
+     * cada argumento directamente del registro del VM al tipo del parámetro (sin pasar
+     * por cadenas ni por un map<string,string> intermedio) y el resultado de vuelta a
+     * un Value. Un STRING llega como std::string_view sin copia; un ARRAY<FLOAT> llega
+     * como const std::vector<double>& apuntando a su búfer. Las conversiones que sí
+     * copian son las que pide el tipo de C++ (std::string, std::list, std::map).
+     *
+     * Un argumento de otro tipo es un RuntimeError con el nombre de la función y la
+     * posición; una excepción de la biblioteca se convierte en RuntimeError con su
+     * mensaje. El nombre es el de la ObjNative llamada (una misma función puede
+     * registrarse con varios), así que lo antepone el VM, que añade también la línea
+     * y la función de MC++ que llamó.
+     */
+
+    // Argumento i de una llamada (base 0)
+    struct NativeArgument {
+        Value value;
+        int index;
+    };
+
+    // Argumento que no se puede convertir al tipo del parámetro
+    struct NativeArgumentError {
+        int index;
+        const char* expected;  // "un número", "un STRING"...
+        Value value;
+    };
+
+    template <typename T, typename = void>
+    struct NativeArg;
+
+    // Números: un INT vale donde se espera un FLOAT
+    template <typename T>
+    struct NativeArg<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+        T value;
+        explicit NativeArg(NativeArgument arg) {
+            if (!arg.value.isNumber()) throw NativeArgumentError{arg.index, "un número", arg.value};
+            value = static_cast<T>(arg.value.asNumber());
+        }
+        T get() const { return value; }
+    };
+
+    template <typename T>
+    struct NativeArg<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                         !std::is_same_v<T, char>>> {
+        T value;
+        explicit NativeArg(NativeArgument arg) {
+            if (!arg.value.isInt()) throw NativeArgumentError{arg.index, "un INT", arg.value};
+            int64_t i = arg.value.asInt();
+            if (i < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+                (i > 0 && static_cast<uint64_t>(i) > static_cast<uint64_t>(std::numeric_limits<T>::max()))) {
+                throw NativeArgumentError{arg.index, "un INT dentro del rango del parámetro", arg.value};
+            }
+            value = static_cast<T>(i);
+        }
+        T get() const { return value; }
+    };
+
+    template <>
+    struct NativeArg<bool> {
+        bool value;
+        explicit NativeArg(NativeArgument arg) {
+            if (!arg.value.isBool()) throw NativeArgumentError{arg.index, "un BOOL", arg.value};
+            value = arg.value.asBool();
+        }
+        bool get() const { return value; }
+    };
+
+    // Un carácter es un STRING de longitud 1
+    template <>
+    struct NativeArg<char> {
+        char value;
+        explicit NativeArg(NativeArgument arg) {
+            if (!isString(arg.value) || asString(arg.value)->length() != 1) {
+                throw NativeArgumentError{arg.index, "un STRING de un carácter", arg.value};
+            }
+            value = asString(arg.value)->view()[0];
+        }
+        char get() const { return value; }
+    };
+
+    template <>
+    struct NativeArg<std::string_view> {
+        std::string_view value;
+        explicit NativeArg(NativeArgument arg) {
+            if (!isString(arg.value)) throw NativeArgumentError{arg.index, "un STRING", arg.value};
+            value = asString(arg.value)->view();
+        }
+        std::string_view get() const { return value; }
+    };
+
+    template <>
+    struct NativeArg<std::string> {
+        std::string value;
+        explicit NativeArg(NativeArgument arg) {
+            if (!isString(arg.value)) throw NativeArgumentError{arg.index, "un STRING", arg.value};
+            value = asString(arg.value)->view();
+        }
+        const std::string& get() const { return value; }
+    };
+
+    // ARRAY<FLOAT> sin copia; ARRAY<INT> y ARRAY de números se copian
+    template <>
+    struct NativeArg<std::vector<double>> {
+        const std::vector<double>* ref;
+        std::vector<double> copy;
+        explicit NativeArg(NativeArgument arg) : ref(&copy) {
+            if (isObjType(arg.value, ObjType::TYPED_ARRAY)) {
+                const ObjTypedArray* array = asTypedArray(arg.value);
+                if (array->elementType == ElementType::FLOAT) {
+                    ref = &array->floats;
+                } else {
+                    copy.assign(array->ints.begin(), array->ints.end());
+                }
+                return;
+            }
+            if (!isObjType(arg.value, ObjType::ARRAY)) {
+                throw NativeArgumentError{arg.index, "un ARRAY de números", arg.value};
+            }
+            for (Value item : asArray(arg.value)->items) {
+                if (!item.isNumber()) throw NativeArgumentError{arg.index, "un ARRAY de números", arg.value};
+                copy.push_back(item.asNumber());
+            }
+        }
+        NativeArg(const NativeArg&) = delete;
+        const std::vector<double>& get() const { return *ref; }
+    };
+
+    // ARRAY<INT> sin copia; un ARRAY de INT se copia
+    template <>
+    struct NativeArg<std::vector<int64_t>> {
+        const std::vector<int64_t>* ref;
+        std::vector<int64_t> copy;
+        explicit NativeArg(NativeArgument arg) : ref(&copy) {
+            if (isObjType(arg.value, ObjType::TYPED_ARRAY) &&
+                asTypedArray(arg.value)->elementType == ElementType::INT) {
+                ref = &asTypedArray(arg.value)->ints;
+                return;
+            }
+            if (!isObjType(arg.value, ObjType::ARRAY)) {
+                throw NativeArgumentError{arg.index, "un ARRAY de INT", arg.value};
+            }
+            for (Value item : asArray(arg.value)->items) {
+                if (!item.isInt()) throw NativeArgumentError{arg.index, "un ARRAY de INT", arg.value};
+                copy.push_back(item.asInt());
+            }
+        }
+        NativeArg(const NativeArg&) = delete;
+        const std::vector<int64_t>& get() const { return *ref; }
+    };
+
+    // Secuencias de C++ (std::vector / std::list) de otro tipo de elemento: una copia
+    // convertida elemento a elemento con el NativeArg del elemento
+    template <typename Sequence>
+    struct NativeSequenceArg {
+        Sequence value;
+        explicit NativeSequenceArg(NativeArgument arg) {
+            using Element = typename Sequence::value_type;
+            if (isObjType(arg.value, ObjType::TYPED_ARRAY)) {
+                const ObjTypedArray* array = asTypedArray(arg.value);
+                for (size_t i = 0; i < array->size(); ++i) {
+                    value.push_back(NativeArg<Element>(NativeArgument{array->get(i), arg.index}).get());
+                }
+                return;
+            }
+            if (!isObjType(arg.value, ObjType::ARRAY)) throw NativeArgumentError{arg.index, "un ARRAY", arg.value};
+            for (Value item : asArray(arg.value)->items) {
+                value.push_back(NativeArg<Element>(NativeArgument{item, arg.index}).get());
+            }
+        }
+        const Sequence& get() const { return value; }
+    };
+
+    template <>
+    struct NativeArg<std::vector<std::string>> : NativeSequenceArg<std::vector<std::string>> {
+        using NativeSequenceArg::NativeSequenceArg;
+    };
+
+    template <typename T>
+    struct NativeArg<std::list<T>> : NativeSequenceArg<std::list<T>> {
+        using NativeSequenceArg<std::list<T>>::NativeSequenceArg;
+    };
+
+    // MAP con claves STRING
+    template <typename T>
+    struct NativeArg<std::map<std::string, T>> {
+        std::map<std::string, T> value;
+        explicit NativeArg(NativeArgument arg) {
+            if (!isObjType(arg.value, ObjType::MAP)) throw NativeArgumentError{arg.index, "un MAP", arg.value};
+            for (const auto& entry : asMap(arg.value)->entries) {
+                if (!isString(entry.first)) {
+                    throw NativeArgumentError{arg.index, "un MAP con claves STRING", arg.value};
+                }
+                value.emplace(asString(entry.first)->str(),
+                              NativeArg<T>(NativeArgument{entry.second, arg.index}).get());
+            }
+        }
+        const std::map<std::string, T>& get() const { return value; }
+    };
+
+    // -------------------------------------
+    // Resultados
+    // -------------------------------------
+
+    inline Value nativeResult(VM&, bool result) { return Value::boolean(result); }
+    inline Value nativeResult(VM& vm, char result) { return vm.newString(std::string_view(&result, 1)); }
+    inline Value nativeResult(VM& vm, std::string_view result) { return vm.newString(result); }
+    inline Value nativeResult(VM& vm, const std::string& result) { return vm.newString(result); }
+    inline Value nativeResult(VM& vm, const char* result) { return vm.newString(result); }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T>, Value> nativeResult(VM&, T result) {
+        if constexpr (std::is_unsigned_v<T>) {
+            if (result > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                return Value::number(static_cast<double>(result));
+            }
+        }
+        return Value::integer(static_cast<int64_t>(result));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>, Value> nativeResult(VM&, T result) {
+        return Value::number(static_cast<double>(result));
+    }
+
+    // std::vector<double> / std::vector<int64_t> pasan a ser el búfer de un ARRAY<FLOAT> / ARRAY<INT>
+    inline Value nativeResult(VM& vm, std::vector<double> result) {
+        ObjTypedArray* array = vm.heap().allocate<ObjTypedArray>(ElementType::FLOAT);
+        array->floats = std::move(result);
+        return Value::object(array);
+    }
+
+    inline Value nativeResult(VM& vm, std::vector<int64_t> result) {
+        ObjTypedArray* array = vm.heap().allocate<ObjTypedArray>(ElementType::INT);
+        array->ints = std::move(result);
+        return Value::object(array);
+    }
+
+    // El resto de secuencias, un ARRAY (el heap sólo recolecta en puntos seguros del bucle de despacho)
+    template <typename Sequence>
+    auto nativeResult(VM& vm, const Sequence& result)
+        -> decltype(result.begin(), result.end(), typename Sequence::value_type(), Value()) {
+        ObjArray* array = vm.heap().allocate<ObjArray>();
+        array->items.reserve(result.size());
+        for (const auto& item : result) array->items.push_back(nativeResult(vm, item));
+        return Value::object(array);
+    }
+
+    template <typename T>
+    Value nativeResult(VM& vm, const std::map<std::string, T>& result) {
+        ObjMap* map = vm.heap().allocate<ObjMap>();
+        for (const auto& entry : result) map->set(vm.intern(entry.first), nativeResult(vm, entry.second));
+        return Value::object(map);
+    }
+
+    // -------------------------------------
+    // Enlace
+    // -------------------------------------
+
+    template <typename F>
+    struct NativeSignature;
+
+    template <typename R, typename... Args>
+    struct NativeSignature<R (*)(Args...)> {
+        using Result = R;
+        using Converters = std::tuple<NativeArg<std::remove_cv_t<std::remove_reference_t<Args>>>...>;
+        static constexpr int arity = static_cast<int>(sizeof...(Args));
+    };
+
+    template <typename R, typename... Args>
+    struct NativeSignature<R (*)(Args...) noexcept> : NativeSignature<R (*)(Args...)> {};
+
+    /**
+     * Enlace de la función (o método estático) Fn. Para elegir una sobrecarga o
+     * instanciar una plantilla, Fn se escribe con su tipo concreto:
+     *     NativeBinding<static_cast<double (*)(double)>(&Hyperbolic::sinh)>
+     *     NativeBinding<&AdvancedOperations::log_base_n<double>>
+     */
+    template <auto Fn>
+    class NativeBinding {
+    public:
+        using Signature = NativeSignature<decltype(Fn)>;
+        static constexpr int arity = Signature::arity;
+
+        // Registra la función como `module.name`
+        static void define(VM& vm, ObjModule* module, const std::string& name) {
+            Value native = Value::object(vm.heap().allocate<ObjNative>(call, module->name + "." + name, arity));
+            module->members[name] = native;
+            writeBarrier(module, native);
+        }
+
+        // NativeFn: el VM ya comprobó que argc == arity. Los errores son NativeCallError
+        // con el texto que sigue al nombre de la nativa
+        static Value call(VM& vm, Value* args, int) {
+            try {
+                return invoke(vm, args, std::make_index_sequence<arity>());
+            } catch (const NativeArgumentError& e) {
+                throw NativeCallError(std::string(" espera ") + e.expected + " en el argumento " +
+                                      std::to_string(e.index + 1) + ", no " + typeName(e.value));
+            } catch (const RuntimeError&) {
+                throw;
+            } catch (const std::exception& e) {
+                // Las bibliotecas empiezan sus mensajes con "Error: "
+                std::string_view message = e.what();
+                if (message.substr(0, 7) == "Error: ") message.remove_prefix(7);
+                throw NativeCallError(": " + std::string(message));
+            }
+        }
+
+    private:
+        template <size_t... I>
+        static Value invoke(VM& vm, Value* args, std::index_sequence<I...>) {
+            // Cada conversión se construye en su sitio: las que apuntan a su propia copia no se mueven
+            typename Signature::Converters converted(NativeArgument{args[I], static_cast<int>(I)}...);
+            (void)converted;
+            if constexpr (std::is_void_v<typename Signature::Result>) {
+                Fn(std::get<I>(converted).get()...);
+                return Value::nil();
+            } else {
+                return nativeResult(vm, Fn(std::get<I>(converted).get()...));
+            }
+        }
+    };
+
+} // namespace mc_core
+
+#endif // NATIVE_BINDING_H
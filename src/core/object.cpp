@@ -0,0 +1,122 @@
+#include "object.h"
+#include "heap.h"
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mc_core {
+
+    namespace {
+
+        // Serializa el aplanado de cuerdas compartidas entre los hilos de PARA PARALELO
+        std::mutex flattenMutex;
+
+    } // namespace
+
+    ObjString::ObjString(std::string_view text) : Obj(ObjType::STRING), length_(text.size()) {
+        if (length_ <= kInlineCapacity) {
+            shape_.store(Shape::INLINE, std::memory_order_relaxed);
+            std::memcpy(inline_, text.data(), length_);
+            inline_[length_] = '\0';
+            return;
+        }
+        shape_.store(Shape::BUFFER, std::memory_order_relaxed);
+        storage_.data = new char[length_ + 1];
+        std::memcpy(storage_.data, text.data(), length_);
+        storage_.data[length_] = '\0';
+        storage_.left = nullptr;
+        storage_.right = nullptr;
+    }
+
+    ObjString::ObjString(ObjString* left, ObjString* right)
+        : Obj(ObjType::STRING), length_(left->length() + right->length()) {
+        shape_.store(Shape::ROPE, std::memory_order_relaxed);
+        storage_.data = nullptr;
+        storage_.left = left;
+        storage_.right = right;
+    }
+
+    ObjString::~ObjString() {
+        Shape current = shape_.load(std::memory_order_relaxed);
+        if (current == Shape::BUFFER || current == Shape::FLATTENED) delete[] storage_.data;
+    }
+
+    size_t ObjString::hash() const {
+        size_t cached = hash_.load(std::memory_order_relaxed);
+        if (cached != 0) return cached;
+        size_t computed = std::hash<std::string_view>()(view());
+        if (computed == 0) computed = 1;
+        hash_.store(computed, std::memory_order_relaxed);
+        return computed;
+    }
+
+    void ObjString::flatten() const {
+        std::lock_guard<std::mutex> lock(flattenMutex);
+        if (shape_.load(std::memory_order_relaxed) != Shape::ROPE) return;
+        // Recorrido iterativo: `s = s + x` en un bucle produce cuerdas tan profundas como
+        // iteraciones. Los trozos se copian de derecha a izquierda desde el final del búfer
+        char* data = new char[length_ + 1];
+        data[length_] = '\0';
+        std::vector<std::pair<const ObjString*, char*>> pending{{this, data + length_}};
+        while (!pending.empty()) {
+            auto [piece, end] = pending.back();
+            pending.pop_back();
+            while (piece->shape_.load(std::memory_order_relaxed) == Shape::ROPE) {
+                pending.emplace_back(piece->storage_.left, end - piece->storage_.right->length_);
+                piece = piece->storage_.right;
+            }
+            std::string_view text = piece->view();
+            std::memcpy(end - text.size(), text.data(), text.size());
+        }
+        storage_.data = data;
+        shape_.store(Shape::FLATTENED, std::memory_order_release);
+    }
+
+    bool stringsEqual(const ObjString* a, const ObjString* b) {
+        if (a == b) return true;
+        if ((a->interned && b->interned) || a->length() != b->length()) return false;
+        return a->view() == b->view();
+    }
+
+    const Value* ObjMap::find(Value key) const {
+        auto it = index.find(key);
+        return it == index.end() ? nullptr : &entries[it->second].second;
+    }
+
+    void ObjMap::set(Value key, Value value) {
+        writeBarrier(this, key);
+        writeBarrier(this, value);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entries[it->second].second = value;
+            return;
+        }
+        index.emplace(key, entries.size());
+        entries.emplace_back(key, value);
+    }
+
+    bool ObjTypedArray::set(size_t index, Value value) {
+        if (elementType == ElementType::INT) {
+            if (!value.isInt()) return false;
+            ints[index] = value.asInt();
+        } else {
+            if (!value.isNumber()) return false;
+            floats[index] = value.asNumber();
+        }
+        return true;
+    }
+
+    bool ObjTypedArray::push(Value value) {
+        if (elementType == ElementType::INT) {
+            if (!value.isInt()) return false;
+            ints.push_back(value.asInt());
+        } else {
+            if (!value.isNumber()) return false;
+            floats.push_back(value.asNumber());
+        }
+        return true;
+    }
+
+} // namespace mc_core
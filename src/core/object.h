@@ -0,0 +1,217 @@
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include "value.h"
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mc_core {
+
+    class VM;
+    struct FunctionProto;
+
+    // Tipos de objeto del heap de MC++
+    enum class ObjType : uint8_t {
+        STRING,
+        ARRAY,
+        MAP,
+        FUNCTION,
+        NATIVE,
+        CLASS,
+        INSTANCE,
+        MODULE,
+        TYPED_ARRAY
+    };
+
+    // Cabecera común de todos los objetos del heap
+    struct Obj {
+        ObjType type;
+        bool marked = false;  // Alcanzable en la recolección en curso
+        bool old = false;     // Sobrevivió a una recolección (generación vieja)
+
+        explicit Obj(ObjType t) : type(t) {}
+    };
+
+    /**
+     * STRING inmutable. Según su longitud y su origen se guarda de tres formas:
+     *  - INLINE: hasta kInlineCapacity bytes dentro del propio objeto, sin memoria aparte.
+     *  - BUFFER: búfer propio reservado con new[].
+     *  - ROPE: concatenación pendiente de `left` y `right` (véase Heap::concat). La
+     *    primera lectura del texto la aplana en un búfer propio (FLATTENED); los hijos
+     *    dejan de ser alcanzables desde ella.
+     *
+     * El texto y el hash se calculan bajo demanda, así que leer una cadena puede
+     * modificarla; view() admite llamadas simultáneas desde los hilos de PARA PARALELO.
+     * Una cadena `interned` es la única de la tabla de símbolos del heap con su texto:
+     * dos cadenas internadas distintas nunca son iguales.
+     */
+    struct ObjString : Obj {
+        static constexpr size_t kInlineCapacity = 22;
+
+        enum class Shape : uint8_t {
+            INLINE,
+            BUFFER,
+            ROPE,
+            FLATTENED
+        };
+
+        bool interned = false;
+
+        explicit ObjString(std::string_view text);
+        ObjString(ObjString* left, ObjString* right);
+        ~ObjString();
+        ObjString(const ObjString&) = delete;
+        ObjString& operator=(const ObjString&) = delete;
+
+        size_t length() const { return length_; }
+        Shape shape() const { return shape_.load(std::memory_order_acquire); }
+        bool isRope() const { return shape() == Shape::ROPE; }
+        ObjString* left() const { return storage_.left; }
+        ObjString* right() const { return storage_.right; }
+
+        std::string_view view() const {
+            Shape current = shape();
+            if (current == Shape::INLINE) return std::string_view(inline_, length_);
+            if (current == Shape::ROPE) flatten();
+            return std::string_view(storage_.data, length_);
+        }
+        std::string str() const { return std::string(view()); }
+        size_t hash() const;
+
+    private:
+        mutable std::atomic<Shape> shape_;
+        size_t length_;
+        mutable std::atomic<size_t> hash_{0};  // 0 = aún no calculado
+        union {
+            char inline_[kInlineCapacity + 1];
+            mutable struct {
+                char* data;        // BUFFER y FLATTENED (nullptr en una ROPE sin aplanar)
+                ObjString* left;   // ROPE y FLATTENED
+                ObjString* right;
+            } storage_;
+        };
+
+        void flatten() const;
+    };
+
+    // Igualdad de contenido con atajos por identidad, internado y longitud
+    bool stringsEqual(const ObjString* a, const ObjString* b);
+
+    // ARRAY / LIST: secuencia de valores
+    struct ObjArray : Obj {
+        std::vector<Value> items;
+
+        ObjArray() : Obj(ObjType::ARRAY) {}
+    };
+
+    // Tipo de elemento de un ARRAY<INT> / ARRAY<FLOAT>
+    enum class ElementType : uint8_t {
+        INT,
+        FLOAT
+    };
+
+    /**
+     * ARRAY con tipo de elemento declarado: guarda los números sin etiquetar en un
+     * búfer contiguo (int64_t o double; sólo se usa el vector del tipo del arreglo).
+     * Para el programa sigue siendo un ARRAY: admite los mismos métodos e índices.
+     */
+    struct ObjTypedArray : Obj {
+        ElementType elementType;
+        std::vector<int64_t> ints;
+        std::vector<double> floats;
+
+        explicit ObjTypedArray(ElementType type) : Obj(ObjType::TYPED_ARRAY), elementType(type) {}
+
+        size_t size() const { return elementType == ElementType::INT ? ints.size() : floats.size(); }
+        Value get(size_t index) const {
+            return elementType == ElementType::INT ? Value::integer(ints[index]) : Value::number(floats[index]);
+        }
+        // Devuelve false si el valor no es del tipo de elemento (un INT vale como FLOAT)
+        bool set(size_t index, Value value);
+        bool push(Value value);
+    };
+
+    // MAP: conserva el orden de inserción para MOSTRAR
+    struct ObjMap : Obj {
+        std::vector<std::pair<Value, Value>> entries;
+        std::unordered_map<Value, size_t, ValueHash, ValueEq> index;
+
+        ObjMap() : Obj(ObjType::MAP) {}
+
+        const Value* find(Value key) const;
+        void set(Value key, Value value);
+    };
+
+    // Función MC++ compilada (el prototipo pertenece al VM)
+    struct ObjFunction : Obj {
+        FunctionProto* proto;
+
+        explicit ObjFunction(FunctionProto* p) : Obj(ObjType::FUNCTION), proto(p) {}
+    };
+
+    // Función nativa: recibe los argumentos en un rango contiguo de registros
+    using NativeFn = Value (*)(VM& vm, Value* args, int argc);
+
+    struct ObjNative : Obj {
+        NativeFn fn;
+        std::string name;
+        int arity;              // -1 = variádica (sin contar el receptor)
+        bool isMethod = false;  // args[0] es el receptor
+
+        ObjNative(NativeFn f, std::string n, int a) : Obj(ObjType::NATIVE), fn(f), name(std::move(n)), arity(a) {}
+    };
+
+    // CLASE / STRUCT: campos en orden (incluidos los heredados) y métodos por nombre
+    struct ObjClass : Obj {
+        std::string name;
+        ObjClass* base = nullptr;
+        std::vector<std::string> fields;
+        std::unordered_map<std::string, uint32_t> fieldIndex;
+        std::unordered_map<std::string, Value> methods;
+        Value constructor;
+
+        explicit ObjClass(std::string n) : Obj(ObjType::CLASS), name(std::move(n)) {}
+    };
+
+    struct ObjInstance : Obj {
+        ObjClass* klass;
+        std::vector<Value> fields;
+
+        explicit ObjInstance(ObjClass* k) : Obj(ObjType::INSTANCE), klass(k), fields(k->fields.size()) {}
+    };
+
+    // Módulo importado o declarado con MODULO
+    struct ObjModule : Obj {
+        std::string name;
+        std::unordered_map<std::string, Value> members;
+
+        explicit ObjModule(std::string n) : Obj(ObjType::MODULE), name(std::move(n)) {}
+    };
+
+    inline bool isObjType(Value v, ObjType type) {
+        return v.isObj() && v.asObj()->type == type;
+    }
+
+    inline bool isString(Value v) { return isObjType(v, ObjType::STRING); }
+    inline ObjString* asString(Value v) { return static_cast<ObjString*>(v.asObj()); }
+    inline ObjArray* asArray(Value v) { return static_cast<ObjArray*>(v.asObj()); }
+    inline ObjMap* asMap(Value v) { return static_cast<ObjMap*>(v.asObj()); }
+    inline ObjFunction* asFunction(Value v) { return static_cast<ObjFunction*>(v.asObj()); }
+    inline ObjNative* asNative(Value v) { return static_cast<ObjNative*>(v.asObj()); }
+    inline ObjClass* asClass(Value v) { return static_cast<ObjClass*>(v.asObj()); }
+    inline ObjInstance* asInstance(Value v) { return static_cast<ObjInstance*>(v.asObj()); }
+    inline ObjModule* asModule(Value v) { return static_cast<ObjModule*>(v.asObj()); }
+    inline ObjTypedArray* asTypedArray(Value v) { return static_cast<ObjTypedArray*>(v.asObj()); }
+
+    // ARRAY con o sin tipo de elemento
+    inline bool isAnyArray(Value v) {
+        return v.isObj() && (v.asObj()->type == ObjType::ARRAY || v.asObj()->type == ObjType::TYPED_ARRAY);
+    }
+
+} // namespace mc_core
+
+#endif // OBJECT_H
@@ -0,0 +1,1353 @@
+#include "optimizer.h"
+#include "ir.h"
+#include "object.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mc_core {
+
+    namespace {
+
+        // Longitud máxima (sin el RETURN) de una FUNC que se expande en línea
+        constexpr size_t kMaxInlineInstructions = 12;
+
+        // Tipos que puede tener un valor, como máscara de bits
+        enum : uint8_t {
+            kKindNil = 1,
+            kKindBool = 2,
+            kKindInt = 4,
+            kKindFloat = 8,
+            kKindString = 16,
+            kKindObject = 32,
+            kKindNumber = kKindInt | kKindFloat,
+            kKindAny = 63
+        };
+
+        uint8_t kindOf(Value v) {
+            if (v.isInt()) return kKindInt;
+            if (v.isFloat()) return kKindFloat;
+            if (v.isNil()) return kKindNil;
+            if (v.isBool()) return kKindBool;
+            return isString(v) ? kKindString : kKindObject;
+        }
+
+        bool isArithmetic(OpCode op) {
+            return op == OpCode::ADD || op == OpCode::SUB || op == OpCode::MUL || op == OpCode::DIV ||
+                   op == OpCode::MOD;
+        }
+
+        bool isComparison(OpCode op) {
+            return op == OpCode::EQ || op == OpCode::NE || op == OpCode::LT || op == OpCode::LE;
+        }
+
+        // Operaciones que el plegado de constantes sabe evaluar (VM::evaluate y MOVE)
+        bool isFoldable(OpCode op) {
+            return op == OpCode::MOVE || isArithmetic(op) || isComparison(op) || op == OpCode::NEG ||
+                   op == OpCode::NOT;
+        }
+
+        bool contains(const std::vector<uint32_t>& regs, uint32_t reg) {
+            return std::find(regs.begin(), regs.end(), reg) != regs.end();
+        }
+
+        // Índice de `value` en las constantes del prototipo (añadiéndola si falta), o -1
+        // si no cabe en un operando de `limit` como máximo
+        int constantIndex(FunctionProto& proto, Value value, size_t limit) {
+            for (size_t i = 0; i < proto.constants.size() && i <= limit; ++i) {
+                if (proto.constants[i].bits() == value.bits()) return static_cast<int>(i);
+            }
+            if (proto.constants.size() > limit) return -1;
+            proto.constants.push_back(value);
+            return static_cast<int>(proto.constants.size() - 1);
+        }
+
+        // Instrucción que deja `value` en R[a]; false si la constante no cabe
+        bool loadConstant(FunctionProto& proto, uint32_t a, Value value, Instr& out) {
+            if (value.isInt() && value.asInt() >= -kSBxBias && value.asInt() <= kMaxBx - kSBxBias) {
+                out = encodeAsBx(OpCode::LOADI, a, static_cast<int32_t>(value.asInt()));
+            } else if (value.isBool()) {
+                out = encodeABC(OpCode::LOADBOOL, a, value.asBool() ? 1 : 0, 0);
+            } else if (value.isNil()) {
+                out = encodeABC(OpCode::LOADNIL, a, 0, 0);
+            } else {
+                int k = constantIndex(proto, value, kMaxBx);
+                if (k < 0) return false;
+                out = encodeABx(OpCode::LOADK, a, static_cast<uint32_t>(k));
+            }
+            return true;
+        }
+
+        // ---------------------------------------------------------------------------
+        // Forma SSA
+        // ---------------------------------------------------------------------------
+
+        /**
+         * Forma SSA superpuesta a la IR. Los registros no se renombran: cada definición
+         * (una instrucción, una phi o el valor inicial de un registro) recibe un número
+         * de valor y cada operando el número del valor que le llega. Las phis sólo se
+         * colocan donde el registro está vivo (SSA podada). Los valores 0..numRegs-1
+         * son los contenidos de los registros a la entrada de la función.
+         */
+        struct SsaForm {
+            struct Phi {
+                int block;
+                uint32_t reg;
+                int value;
+                std::vector<int> operands;   // Uno por predecesor, en el orden de preds[block]
+            };
+            struct User {
+                int block;
+                int index;   // Instrucción del bloque, o phi si `phi`
+                bool phi;
+            };
+
+            std::vector<int> rpo;
+            std::vector<std::vector<int>> preds;
+            std::vector<std::vector<std::vector<int>>> uses;   // [bloque][instrucción]
+            std::vector<std::vector<std::vector<int>>> defs;
+            std::vector<Phi> phis;
+            std::vector<std::vector<int>> blockPhis;
+            std::vector<std::vector<User>> users;
+            int valueCount = 0;
+        };
+
+        SsaForm buildSsa(IrFunction& function) {
+            SsaForm ssa;
+            function.removeUnreachable();
+            ssa.rpo = function.reversePostorder();
+            ssa.preds = function.predecessors();
+            std::vector<int> idom = function.dominators(ssa.rpo, ssa.preds);
+            size_t count = function.blocks.size();
+            uint32_t numRegs = function.numRegs;
+
+            std::vector<std::vector<int>> frontier(count);
+            for (int b : ssa.rpo) {
+                if (ssa.preds[b].size() < 2) continue;
+                for (int p : ssa.preds[b]) {
+                    for (int runner = p; runner != idom[b]; runner = idom[runner]) {
+                        if (frontier[runner].empty() || frontier[runner].back() != b) frontier[runner].push_back(b);
+                    }
+                }
+            }
+
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            std::vector<std::vector<int>> defBlocks(numRegs);
+            for (int b : ssa.rpo) {
+                for (const IrInstr& instr : function.blocks[b].code) {
+                    instrRegisters(instr, numRegs, uses, defs);
+                    for (uint32_t r : defs) {
+                        if (defBlocks[r].empty() || defBlocks[r].back() != b) defBlocks[r].push_back(b);
+                    }
+                }
+            }
+
+            // Phis en la frontera de dominancia iterada de las definiciones
+            std::vector<RegSet> live = function.liveIn();
+            std::vector<RegSet> hasPhi(count);
+            for (uint32_t r = 0; r < numRegs; ++r) {
+                std::vector<int> work = defBlocks[r];
+                std::vector<char> queued(count, 0);
+                for (int b : work) queued[b] = 1;
+                while (!work.empty()) {
+                    int x = work.back();
+                    work.pop_back();
+                    for (int y : frontier[x]) {
+                        if (hasPhi[y][r] || !live[y][r]) continue;
+                        hasPhi[y].set(r);
+                        ssa.phis.push_back(SsaForm::Phi{y, r, -1, {}});
+                        if (!queued[y]) {
+                            queued[y] = 1;
+                            work.push_back(y);
+                        }
+                    }
+                }
+            }
+
+            ssa.valueCount = static_cast<int>(numRegs);
+            ssa.blockPhis.assign(count, {});
+            for (size_t i = 0; i < ssa.phis.size(); ++i) {
+                ssa.phis[i].value = ssa.valueCount++;
+                ssa.blockPhis[ssa.phis[i].block].push_back(static_cast<int>(i));
+            }
+
+            // Renombrado en orden posterior inverso: sin phi, el valor que llega a un
+            // bloque es el que sale de su dominador inmediato
+            std::vector<std::vector<int>> out(count);
+            ssa.uses.assign(count, {});
+            ssa.defs.assign(count, {});
+            for (int b : ssa.rpo) {
+                std::vector<int> current;
+                if (b == 0) {
+                    for (uint32_t r = 0; r < numRegs; ++r) current.push_back(static_cast<int>(r));
+                } else {
+                    current = out[idom[b]];
+                }
+                for (int p : ssa.blockPhis[b]) current[ssa.phis[p].reg] = ssa.phis[p].value;
+                for (const IrInstr& instr : function.blocks[b].code) {
+                    instrRegisters(instr, numRegs, uses, defs);
+                    std::vector<int> useValues;
+                    std::vector<int> defValues;
+                    for (uint32_t r : uses) useValues.push_back(current[r]);
+                    for (uint32_t r : defs) {
+                        current[r] = ssa.valueCount++;
+                        defValues.push_back(current[r]);
+                    }
+                    ssa.uses[b].push_back(std::move(useValues));
+                    ssa.defs[b].push_back(std::move(defValues));
+                }
+                out[b] = std::move(current);
+            }
+            for (SsaForm::Phi& phi : ssa.phis) {
+                for (int p : ssa.preds[phi.block]) phi.operands.push_back(out[p][phi.reg]);
+            }
+
+            ssa.users.assign(static_cast<size_t>(ssa.valueCount), {});
+            for (int b : ssa.rpo) {
+                for (size_t i = 0; i < ssa.uses[b].size(); ++i) {
+                    for (int v : ssa.uses[b][i]) ssa.users[v].push_back(SsaForm::User{b, static_cast<int>(i), false});
+                }
+            }
+            for (size_t i = 0; i < ssa.phis.size(); ++i) {
+                for (int v : ssa.phis[i].operands) {
+                    ssa.users[v].push_back(SsaForm::User{ssa.phis[i].block, static_cast<int>(i), true});
+                }
+            }
+            return ssa;
+        }
+
+        // ---------------------------------------------------------------------------
+        // Propagación de constantes condicional (SCCP)
+        // ---------------------------------------------------------------------------
+
+        // Elemento del retículo: sin definir, constante conocida o variable (con sus tipos posibles)
+        struct LatticeValue {
+            enum State : uint8_t { UNDEF, CONST, VARYING };
+
+            State state = UNDEF;
+            uint8_t kinds = 0;
+            Value value;
+
+            static LatticeValue constant(Value v) { return LatticeValue{CONST, kindOf(v), v}; }
+            static LatticeValue varying(uint8_t kinds) { return LatticeValue{VARYING, kinds, Value()}; }
+
+            bool sameConstant(const LatticeValue& other) const {
+                if (value.bits() == other.value.bits()) return true;
+                // Cada evaluación de una concatenación crea una cadena nueva
+                return isString(value) && isString(other.value) && valuesEqual(value, other.value);
+            }
+
+            // Une `other` a este valor; true si ha cambiado
+            bool merge(const LatticeValue& other) {
+                if (other.state == UNDEF) return false;
+                if (state == UNDEF) {
+                    *this = other;
+                    return true;
+                }
+                if (state == CONST && other.state == CONST && sameConstant(other)) return false;
+                uint8_t merged = kinds | other.kinds;
+                if (state == VARYING && merged == kinds) return false;
+                *this = varying(merged);
+                return true;
+            }
+        };
+
+        /**
+         * Propagación de constantes condicional dispersa (Wegman-Zadeck) sobre SsaForm.
+         * Sólo sigue las aristas que pueden ejecutarse, así que un salto con condición
+         * constante deja fuera la rama que nunca se toma. Además de las constantes,
+         * calcula los tipos posibles de cada valor para saber qué operaciones no pueden
+         * lanzar errores (IrInstr::noThrow).
+         */
+        class ConstantPropagation {
+        public:
+            ConstantPropagation(VM& vm, IrFunction& function, const SsaForm& ssa)
+                : vm_(vm), function_(function), ssa_(ssa) {}
+
+            void run() {
+                const FunctionProto& proto = *function_.proto;
+                values_.assign(static_cast<size_t>(ssa_.valueCount), LatticeValue());
+                uint32_t params = proto.numParams + (proto.isMethod ? 1u : 0u);
+                // El marco empieza con los argumentos y el resto de registros a NULO
+                for (uint32_t r = 0; r < function_.numRegs; ++r) {
+                    values_[r] = r < params ? LatticeValue::varying(kKindAny) : LatticeValue::constant(Value::nil());
+                }
+                executable_.assign(function_.blocks.size(), 0);
+                edges_.assign(function_.blocks.size(), {});
+                for (size_t b = 0; b < function_.blocks.size(); ++b) edges_[b].assign(ssa_.preds[b].size(), 0);
+
+                flowWork_.emplace_back(-1, 0);
+                while (!flowWork_.empty() || !ssaWork_.empty()) {
+                    while (!flowWork_.empty()) {
+                        auto edge = flowWork_.back();
+                        flowWork_.pop_back();
+                        visitEdge(edge.second);
+                    }
+                    while (!ssaWork_.empty()) {
+                        int value = ssaWork_.back();
+                        ssaWork_.pop_back();
+                        for (const SsaForm::User& user : ssa_.users[value]) {
+                            if (!executable_[user.block]) continue;
+                            if (user.phi) {
+                                visitPhi(user.index);
+                            } else {
+                                visitInstr(user.block, static_cast<size_t>(user.index));
+                            }
+                        }
+                    }
+                }
+            }
+
+            /**
+             * Sustituye las operaciones de resultado constante por cargas, resuelve los
+             * saltos de condición constante, elimina los bloques que nunca se ejecutan y
+             * marca las operaciones que no pueden fallar.
+             */
+            void rewrite(OptimizationStats& stats) {
+                FunctionProto& proto = *function_.proto;
+                for (size_t b = 0; b < function_.blocks.size(); ++b) {
+                    IrBlock& block = function_.blocks[b];
+                    if (block.removed) continue;
+                    if (!executable_[b]) {
+                        block.removed = true;
+                        block.code.clear();
+                        block.cases.clear();
+                        block.next = block.target = kNoBlock;
+                        continue;
+                    }
+                    std::vector<IrInstr> code;
+                    for (size_t i = 0; i < block.code.size(); ++i) {
+                        IrInstr instr = block.code[i];
+                        OpCode op = instr.op();
+                        const std::vector<int>& uses = ssa_.uses[b][i];
+                        const std::vector<int>& defs = ssa_.defs[b][i];
+                        if (isFoldable(op) && values_[defs[0]].state == LatticeValue::CONST) {
+                            Instr load;
+                            if (loadConstant(proto, argA(instr.instr), values_[defs[0]].value, load)) {
+                                instr.instr = load;
+                                code.push_back(instr);
+                                ++stats.foldedInstructions;
+                                continue;
+                            }
+                        }
+                        if ((op == OpCode::JMPIF || op == OpCode::JMPIFNOT) &&
+                            values_[uses[0]].state == LatticeValue::CONST) {
+                            if (values_[uses[0]].value.isTruthy() == (op == OpCode::JMPIF)) block.next = block.target;
+                            block.target = kNoBlock;
+                            ++stats.foldedBranches;
+                            continue;
+                        }
+                        if (op == OpCode::SWITCH && values_[uses[0]].state == LatticeValue::CONST) {
+                            block.next = chosenCase(block, instr, values_[uses[0]].value);
+                            block.cases.clear();
+                            ++stats.foldedBranches;
+                            continue;
+                        }
+                        instr.noThrow = cannotThrow(op, uses);
+                        code.push_back(instr);
+                    }
+                    block.code = std::move(code);
+                }
+            }
+
+        private:
+            VM& vm_;
+            IrFunction& function_;
+            const SsaForm& ssa_;
+            std::vector<LatticeValue> values_;
+            std::vector<char> executable_;
+            std::vector<std::vector<char>> edges_;   // [bloque][índice del predecesor]
+            std::vector<std::pair<int, int>> flowWork_;
+            std::vector<int> ssaWork_;
+
+            void markEdge(int from, int to) {
+                const std::vector<int>& preds = ssa_.preds[to];
+                for (size_t i = 0; i < preds.size(); ++i) {
+                    if (preds[i] != from) continue;
+                    if (edges_[to][i]) return;
+                    edges_[to][i] = 1;
+                    flowWork_.emplace_back(from, to);
+                    return;
+                }
+            }
+
+            void update(int value, const LatticeValue& lattice) {
+                if (values_[value].merge(lattice)) ssaWork_.push_back(value);
+            }
+
+            // Bloque al que salta el SWITCH que termina `block` cuando su sujeto vale `subject`
+            int chosenCase(const IrBlock& block, const IrInstr& instr, Value subject) const {
+                const FunctionProto& proto = *function_.proto;
+                uint32_t c = proto.switchTables[argBx(instr.instr)].find(subject, proto.constants.data());
+                return c < block.cases.size() ? block.cases[c] : block.next;
+            }
+
+            void visitEdge(int to) {
+                for (int phi : ssa_.blockPhis[to]) visitPhi(phi);
+                if (executable_[to]) return;
+                executable_[to] = 1;
+                const IrBlock& block = function_.blocks[to];
+                for (size_t i = 0; i < block.code.size(); ++i) visitInstr(to, i);
+                bool conditional = !block.code.empty() && (block.code.back().op() == OpCode::JMPIF ||
+                                                           block.code.back().op() == OpCode::JMPIFNOT ||
+                                                           block.code.back().op() == OpCode::SWITCH);
+                if (!conditional) {
+                    if (block.next != kNoBlock) markEdge(to, block.next);
+                    if (block.target != kNoBlock) markEdge(to, block.target);
+                }
+            }
+
+            void visitPhi(int index) {
+                const SsaForm::Phi& phi = ssa_.phis[index];
+                LatticeValue result;
+                for (size_t i = 0; i < phi.operands.size(); ++i) {
+                    if (edges_[phi.block][i]) result.merge(values_[phi.operands[i]]);
+                }
+                update(phi.value, result);
+            }
+
+            void visitInstr(int b, size_t i) {
+                const IrBlock& block = function_.blocks[b];
+                const IrInstr& instr = block.code[i];
+                const std::vector<int>& uses = ssa_.uses[b][i];
+                const std::vector<int>& defs = ssa_.defs[b][i];
+                OpCode op = instr.op();
+                switch (op) {
+                    case OpCode::LOADK:
+                        update(defs[0], LatticeValue::constant(function_.proto->constants[argBx(instr.instr)]));
+                        return;
+                    case OpCode::LOADI:
+                        update(defs[0], LatticeValue::constant(Value::integer(argSBx(instr.instr))));
+                        return;
+                    case OpCode::LOADBOOL:
+                        update(defs[0], LatticeValue::constant(Value::boolean(argB(instr.instr) != 0)));
+                        return;
+                    case OpCode::LOADNIL:
+                        update(defs[0], LatticeValue::constant(Value::nil()));
+                        return;
+                    case OpCode::MOVE:
+                        update(defs[0], values_[uses[0]]);
+                        return;
+                    case OpCode::JMPIF:
+                    case OpCode::JMPIFNOT: {
+                        const LatticeValue& condition = values_[uses[0]];
+                        if (condition.state == LatticeValue::CONST) {
+                            bool jumps = condition.value.isTruthy() == (op == OpCode::JMPIF);
+                            markEdge(b, jumps ? block.target : block.next);
+                        } else if (condition.state == LatticeValue::VARYING) {
+                            markEdge(b, block.target);
+                            markEdge(b, block.next);
+                        }
+                        return;
+                    }
+                    case OpCode::SWITCH: {
+                        const LatticeValue& subject = values_[uses[0]];
+                        if (subject.state == LatticeValue::CONST) {
+                            markEdge(b, chosenCase(block, instr, subject.value));
+                        } else if (subject.state == LatticeValue::VARYING) {
+                            for (int c : block.cases) markEdge(b, c);
+                            markEdge(b, block.next);
+                        }
+                        return;
+                    }
+                    default:
+                        break;
+                }
+                if (isFoldable(op)) {
+                    update(defs[0], fold(op, uses));
+                    return;
+                }
+                for (size_t d = 0; d < defs.size(); ++d) update(defs[d], LatticeValue::varying(resultKinds(op, d)));
+            }
+
+            LatticeValue fold(OpCode op, const std::vector<int>& uses) {
+                const LatticeValue& b = values_[uses[0]];
+                LatticeValue c = uses.size() > 1 ? values_[uses[1]] : LatticeValue::constant(Value::nil());
+                if (b.state == LatticeValue::UNDEF || c.state == LatticeValue::UNDEF) return LatticeValue();
+                if (b.state == LatticeValue::CONST && c.state == LatticeValue::CONST) {
+                    try {
+                        return LatticeValue::constant(vm_.evaluate(op, b.value, c.value));
+                    } catch (const RuntimeError&) {
+                        // La instrucción se queda y fallará al ejecutarse
+                        return LatticeValue::varying(kKindAny);
+                    }
+                }
+                // Si la operación termina, su resultado es de estos tipos
+                switch (op) {
+                    case OpCode::ADD: return LatticeValue::varying(kKindNumber | kKindString);
+                    case OpCode::SUB:
+                    case OpCode::MUL:
+                    case OpCode::DIV:
+                    case OpCode::MOD:
+                    case OpCode::NEG: return LatticeValue::varying(kKindNumber);
+                    default: return LatticeValue::varying(kKindBool);
+                }
+            }
+
+            static uint8_t resultKinds(OpCode op, size_t def) {
+                switch (op) {
+                    case OpCode::GETTYPED:
+                    case OpCode::FORPREP:
+                    case OpCode::FORLOOP:
+                        return kKindNumber;
+                    case OpCode::FOREACH:
+                        return def == 0 ? kKindInt : kKindAny;
+                    case OpCode::NEWARRAY:
+                    case OpCode::NEWMAP:
+                    case OpCode::TOTYPED:
+                    case OpCode::PARFOR:
+                        return kKindObject;
+                    default:
+                        return kKindAny;
+                }
+            }
+
+            bool cannotThrow(OpCode op, const std::vector<int>& uses) const {
+                auto known = [&](size_t k) { return values_[uses[k]].state != LatticeValue::UNDEF; };
+                auto numeric = [&](size_t k) { return known(k) && (values_[uses[k]].kinds & ~kKindNumber) == 0; };
+                auto string = [&](size_t k) { return known(k) && values_[uses[k]].kinds == kKindString; };
+                switch (op) {
+                    case OpCode::ADD:
+                        return (numeric(0) && numeric(1)) || string(0) || string(1);
+                    case OpCode::SUB:
+                    case OpCode::MUL:
+                        return numeric(0) && numeric(1);
+                    case OpCode::DIV:
+                    case OpCode::MOD:
+                        return numeric(0) && numeric(1) && values_[uses[1]].state == LatticeValue::CONST &&
+                               values_[uses[1]].value.asNumber() != 0.0;
+                    case OpCode::NEG:
+                        return numeric(0);
+                    case OpCode::LT:
+                    case OpCode::LE:
+                        return (numeric(0) && numeric(1)) || (string(0) && string(1));
+                    default:
+                        return false;
+                }
+            }
+        };
+
+        // ---------------------------------------------------------------------------
+        // Limpieza
+        // ---------------------------------------------------------------------------
+
+        // Cambia las lecturas de R[from] por R[to]; false si alguna es parte de un rango
+        bool replaceUse(Instr instr, uint32_t from, uint32_t to, Instr& out) {
+            OpCode op = opOf(instr);
+            uint32_t a = argA(instr);
+            uint32_t b = argB(instr);
+            uint32_t c = argC(instr);
+            auto swap = [&](uint32_t r) { return r == from ? to : r; };
+            switch (op) {
+                case OpCode::MOVE:
+                case OpCode::NEG:
+                case OpCode::NOT:
+                case OpCode::GETFIELD:
+                case OpCode::SELF:
+                    out = encodeABC(op, a, swap(b), c);
+                    return true;
+                case OpCode::ADD:
+                case OpCode::SUB:
+                case OpCode::MUL:
+                case OpCode::DIV:
+                case OpCode::MOD:
+                case OpCode::EQ:
+                case OpCode::NE:
+                case OpCode::LT:
+                case OpCode::LE:
+                case OpCode::GETINDEX:
+                case OpCode::GETTYPED:
+                    out = encodeABC(op, a, swap(b), swap(c));
+                    return true;
+                case OpCode::SETINDEX:
+                case OpCode::SETTYPED:
+                    out = encodeABC(op, swap(a), swap(b), swap(c));
+                    return true;
+                case OpCode::SETFIELD:
+                    out = encodeABC(op, swap(a), b, swap(c));
+                    return true;
+                case OpCode::RETURN:
+                    out = encodeABC(op, swap(a), b, c);
+                    return true;
+                case OpCode::SETGLOBAL:
+                case OpCode::SWITCH:
+                    out = encodeABx(op, swap(a), argBx(instr));
+                    return true;
+                case OpCode::JMPIF:
+                case OpCode::JMPIFNOT:
+                    out = encodeAsBx(op, swap(a), argSBx(instr));
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * Reenvío de globales dentro de cada bloque: tras SETGLOBAL o GETGLOBAL de una
+         * ranura, las lecturas siguientes se sustituyen por un MOVE del registro que ya
+         * tiene el valor, mientras ese registro no cambie. Una llamada puede modificar
+         * cualquier global y vacía lo conocido.
+         */
+        void forwardGlobals(IrFunction& function) {
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            for (IrBlock& block : function.blocks) {
+                if (block.removed) continue;
+                std::unordered_map<uint32_t, uint32_t> known;   // Ranura -> registro con su valor
+                std::vector<IrInstr> code;
+                for (IrInstr instr : block.code) {
+                    OpCode op = instr.op();
+                    uint32_t slot = argBx(instr.instr);
+                    if (op == OpCode::GETGLOBAL) {
+                        auto it = known.find(slot);
+                        if (it != known.end()) {
+                            if (it->second == argA(instr.instr)) continue;
+                            instr.instr = encodeABC(OpCode::MOVE, argA(instr.instr), it->second, 0);
+                        }
+                    }
+                    instrRegisters(instr, function.numRegs, uses, defs);
+                    for (auto it = known.begin(); it != known.end();) {
+                        it = contains(defs, it->second) ? known.erase(it) : std::next(it);
+                    }
+                    if (op == OpCode::CALL || op == OpCode::PARFOR) known.clear();
+                    if (op == OpCode::GETGLOBAL || op == OpCode::SETGLOBAL) known[slot] = argA(instr.instr);
+                    code.push_back(instr);
+                }
+                block.code = std::move(code);
+            }
+        }
+
+        bool removableIfDead(const IrInstr& instr) {
+            switch (instr.op()) {
+                case OpCode::MOVE:
+                case OpCode::LOADK:
+                case OpCode::LOADI:
+                case OpCode::LOADBOOL:
+                case OpCode::LOADNIL:
+                case OpCode::GETGLOBAL:
+                case OpCode::NOT:
+                case OpCode::EQ:
+                case OpCode::NE:
+                case OpCode::NEWARRAY:
+                case OpCode::GETTYPED:
+                    return true;
+                case OpCode::ADD:
+                case OpCode::SUB:
+                case OpCode::MUL:
+                case OpCode::DIV:
+                case OpCode::MOD:
+                case OpCode::NEG:
+                case OpCode::LT:
+                case OpCode::LE:
+                    return instr.noThrow;
+                default:
+                    return false;
+            }
+        }
+
+        // Elimina las instrucciones sin efectos cuyo resultado nadie lee
+        size_t eliminateDeadCode(IrFunction& function) {
+            size_t removed = 0;
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                std::vector<RegSet> liveIn = function.liveIn();
+                for (size_t b = 0; b < function.blocks.size(); ++b) {
+                    IrBlock& block = function.blocks[b];
+                    if (block.removed) continue;
+                    RegSet live;
+                    for (int s : function.successors(static_cast<int>(b))) live |= liveIn[s];
+                    std::vector<char> keep(block.code.size(), 1);
+                    for (size_t i = block.code.size(); i-- > 0;) {
+                        const IrInstr& instr = block.code[i];
+                        instrRegisters(instr, function.numRegs, uses, defs);
+                        bool selfMove = instr.op() == OpCode::MOVE && argA(instr.instr) == argB(instr.instr);
+                        bool dead = removableIfDead(instr) &&
+                                    std::none_of(defs.begin(), defs.end(), [&](uint32_t r) { return live[r]; });
+                        if (selfMove || dead) {
+                            keep[i] = 0;
+                            ++removed;
+                            changed = true;
+                            continue;
+                        }
+                        for (uint32_t r : defs) live.reset(r);
+                        for (uint32_t r : uses) live.set(r);
+                    }
+                    std::vector<IrInstr> code;
+                    for (size_t i = 0; i < block.code.size(); ++i) {
+                        if (keep[i]) code.push_back(block.code[i]);
+                    }
+                    block.code = std::move(code);
+                }
+            }
+            return removed;
+        }
+
+        /**
+         * Propagación de copias dentro de cada bloque: tras `MOVE d s`, las lecturas de
+         * R[d] pasan a leer R[s] mientras ninguno de los dos cambie. El MOVE suele
+         * quedar muerto después (los de los argumentos de una función expandida, por
+         * ejemplo). Las lecturas que forman parte de un rango de registros se respetan.
+         */
+        void propagateCopies(IrFunction& function) {
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            for (IrBlock& block : function.blocks) {
+                if (block.removed) continue;
+                std::vector<int> copyOf(256, -1);
+                for (IrInstr& instr : block.code) {
+                    instrRegisters(instr, function.numRegs, uses, defs);
+                    for (uint32_t r : uses) {
+                        Instr replaced;
+                        if (copyOf[r] >= 0 && replaceUse(instr.instr, r, static_cast<uint32_t>(copyOf[r]), replaced)) {
+                            instr.instr = replaced;
+                        }
+                    }
+                    for (uint32_t r : defs) {
+                        copyOf[r] = -1;
+                        std::replace(copyOf.begin(), copyOf.end(), static_cast<int>(r), -1);
+                    }
+                    if (instr.op() == OpCode::MOVE && argA(instr.instr) != argB(instr.instr)) {
+                        copyOf[argA(instr.instr)] = static_cast<int>(argB(instr.instr));
+                    }
+                }
+            }
+        }
+
+        // Instrucciones cuyo único efecto en los registros es escribir R[A]
+        bool definesOnlyA(OpCode op) {
+            switch (op) {
+                case OpCode::LOADK:
+                case OpCode::LOADI:
+                case OpCode::LOADBOOL:
+                case OpCode::LOADNIL:
+                case OpCode::GETGLOBAL:
+                case OpCode::GETINDEX:
+                case OpCode::GETTYPED:
+                case OpCode::GETFIELD:
+                case OpCode::NEWARRAY:
+                case OpCode::NEWMAP:
+                    return true;
+                default:
+                    return isFoldable(op);
+            }
+        }
+
+        /**
+         * Une `op t ..` seguido de `MOVE d t` en `op d ..` cuando t no se lee después.
+         * Todas estas operaciones leen sus operandos antes de escribir R[A], así que d
+         * puede ser también uno de ellos.
+         */
+        void coalesceMoves(IrFunction& function) {
+            std::vector<RegSet> liveIn = function.liveIn();
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            for (size_t b = 0; b < function.blocks.size(); ++b) {
+                IrBlock& block = function.blocks[b];
+                if (block.removed || block.code.size() < 2) continue;
+                // liveAfter[i]: registros vivos justo después de la instrucción i
+                std::vector<RegSet> liveAfter(block.code.size());
+                RegSet live;
+                for (int s : function.successors(static_cast<int>(b))) live |= liveIn[s];
+                for (size_t i = block.code.size(); i-- > 0;) {
+                    liveAfter[i] = live;
+                    instrRegisters(block.code[i], function.numRegs, uses, defs);
+                    for (uint32_t r : defs) live.reset(r);
+                    for (uint32_t r : uses) live.set(r);
+                }
+                std::vector<IrInstr> code;
+                for (size_t i = 0; i < block.code.size(); ++i) {
+                    IrInstr instr = block.code[i];
+                    if (i + 1 < block.code.size() && definesOnlyA(instr.op())) {
+                        const IrInstr& move = block.code[i + 1];
+                        uint32_t temp = argA(instr.instr);
+                        if (move.op() == OpCode::MOVE && argB(move.instr) == temp && argA(move.instr) != temp &&
+                            !liveAfter[i + 1][temp]) {
+                            instr.instr = (instr.instr & ~(Instr(0xFF) << 8)) | (argA(move.instr) << 8);
+                            code.push_back(instr);
+                            ++i;
+                            continue;
+                        }
+                    }
+                    code.push_back(instr);
+                }
+                block.code = std::move(code);
+            }
+        }
+
+        /**
+         * Simplifica el grafo: salta los bloques vacíos, quita los saltos condicionales
+         * cuyas dos salidas coinciden y une cada bloque con su único sucesor cuando éste
+         * no tiene otros predecesores.
+         */
+        void simplifyCfg(IrFunction& function) {
+            auto skipEmpty = [&](int block) {
+                for (size_t steps = 0; block != kNoBlock && steps < function.blocks.size(); ++steps) {
+                    const IrBlock& b = function.blocks[block];
+                    if (!b.code.empty() || b.hasBranch() || b.next == kNoBlock || b.next == block) break;
+                    block = b.next;
+                }
+                return block;
+            };
+            bool changed = true;
+            while (changed) {
+                changed = false;
+                function.removeUnreachable();
+                for (IrBlock& block : function.blocks) {
+                    if (block.removed) continue;
+                    int next = skipEmpty(block.next);
+                    int target = skipEmpty(block.target);
+                    if (next != block.next || target != block.target) {
+                        block.next = next;
+                        block.target = target;
+                        changed = true;
+                    }
+                    for (int& c : block.cases) {
+                        int skipped = skipEmpty(c);
+                        changed = changed || skipped != c;
+                        c = skipped;
+                    }
+                    if (block.target != kNoBlock && block.target == block.next &&
+                        (block.code.back().op() == OpCode::JMPIF || block.code.back().op() == OpCode::JMPIFNOT)) {
+                        block.code.pop_back();
+                        block.target = kNoBlock;
+                        changed = true;
+                    }
+                    if (!block.cases.empty() &&
+                        std::all_of(block.cases.begin(), block.cases.end(), [&](int c) { return c == block.next; })) {
+                        block.code.pop_back();
+                        block.cases.clear();
+                        changed = true;
+                    }
+                }
+                std::vector<std::vector<int>> preds = function.predecessors();
+                for (int b : function.layout) {
+                    IrBlock& block = function.blocks[b];
+                    if (block.removed) continue;
+                    while (!block.hasBranch() && block.next != kNoBlock && block.next != b && block.next != 0 &&
+                           preds[block.next].size() == 1) {
+                        int s = block.next;
+                        IrBlock& successor = function.blocks[s];
+                        block.code.insert(block.code.end(), successor.code.begin(), successor.code.end());
+                        block.next = successor.next;
+                        block.target = successor.target;
+                        block.cases = std::move(successor.cases);
+                        successor.removed = true;
+                        successor.code.clear();
+                        successor.cases.clear();
+                        successor.next = successor.target = kNoBlock;
+                        for (int t : function.successors(b)) std::replace(preds[t].begin(), preds[t].end(), s, b);
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        // ---------------------------------------------------------------------------
+        // Expansión en línea
+        // ---------------------------------------------------------------------------
+
+        // Operaciones que puede contener una FUNC expandida: ni saltos ni llamadas
+        bool inlinableOp(OpCode op) {
+            switch (op) {
+                case OpCode::JMP:
+                case OpCode::JMPIF:
+                case OpCode::JMPIFNOT:
+                case OpCode::FORPREP:
+                case OpCode::FORLOOP:
+                case OpCode::FOREACH:
+                case OpCode::SWITCH:
+                case OpCode::CALL:
+                case OpCode::PARFOR:
+                case OpCode::SELF:
+                case OpCode::RETURN:
+                case OpCode::NOP:
+                case OpCode::EXTRAARG:
+                    return false;
+                default:
+                    return true;
+            }
+        }
+
+        struct InlineBody {
+            const FunctionProto* proto;
+            std::vector<IrInstr> code;   // Termina en RETURN
+        };
+
+        /**
+         * Cuerpo de una FUNC expandible: un único bloque sin saltos terminado en RETURN
+         * que sólo lee registros ya escritos o parámetros (el resto empiezan a NULO en un
+         * marco nuevo y no se pueden suponer así dentro del marco de quien llama).
+         */
+        bool inlineBodyOf(FunctionProto& callee, InlineBody& body) {
+            if (callee.isMethod || callee.mappedCode != nullptr) return false;
+            IrFunction function = buildIr(callee);
+            const IrBlock& entry = function.blocks[0];
+            if (entry.hasBranch() || entry.code.empty() || entry.code.back().op() != OpCode::RETURN ||
+                entry.code.size() > kMaxInlineInstructions + 1) {
+                return false;
+            }
+            RegSet written;
+            for (uint32_t p = 0; p < callee.numParams; ++p) written.set(p);
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            for (const IrInstr& instr : entry.code) {
+                if (instr.op() != OpCode::RETURN && !inlinableOp(instr.op())) return false;
+                instrRegisters(instr, callee.numRegs, uses, defs);
+                for (uint32_t r : uses) {
+                    if (!written[r]) return false;
+                }
+                for (uint32_t r : defs) written.set(r);
+            }
+            body.proto = &callee;
+            body.code = entry.code;
+            return true;
+        }
+
+        /**
+         * FUNC globales que se pueden expandir, por ranura. La ranura debe escribirse una
+         * sola vez en todo el programa, con la carga de la función que hace el prólogo
+         * del script (LOADK + SETGLOBAL); así una llamada a través de ella siempre llega
+         * a esa función.
+         */
+        std::unordered_map<uint32_t, InlineBody> findInlineBodies(VM& vm) {
+            std::unordered_map<uint32_t, int> stores;
+            std::unordered_map<uint32_t, FunctionProto*> functions;
+            for (const auto& proto : vm.protos()) {
+                const Instr* code = proto->codeBegin();
+                for (size_t pc = 0; pc < proto->codeSize(); ++pc) {
+                    if (opOf(code[pc]) != OpCode::SETGLOBAL) continue;
+                    uint32_t slot = argBx(code[pc]);
+                    ++stores[slot];
+                    if (pc == 0 || opOf(code[pc - 1]) != OpCode::LOADK || argA(code[pc - 1]) != argA(code[pc])) continue;
+                    Value k = proto->constants[argBx(code[pc - 1])];
+                    if (isObjType(k, ObjType::FUNCTION)) functions[slot] = asFunction(k)->proto;
+                }
+            }
+            std::unordered_map<uint32_t, InlineBody> bodies;
+            for (const auto& entry : functions) {
+                InlineBody body;
+                if (stores[entry.first] == 1 && inlineBodyOf(*entry.second, body)) bodies.emplace(entry.first, body);
+            }
+            return bodies;
+        }
+
+        // Traslada una instrucción de la función expandida al marco de quien llama
+        bool remapInstr(Instr instr, uint32_t base, const FunctionProto& callee, FunctionProto& caller, Instr& out) {
+            OpCode op = opOf(instr);
+            uint32_t a = argA(instr);
+            uint32_t b = argB(instr);
+            uint32_t c = argC(instr);
+            int k = 0;
+            switch (op) {
+                case OpCode::LOADK:
+                    k = constantIndex(caller, callee.constants[argBx(instr)], kMaxBx);
+                    out = encodeABx(op, a + base, static_cast<uint32_t>(k));
+                    break;
+                case OpCode::LOADI:
+                    out = encodeAsBx(op, a + base, argSBx(instr));
+                    break;
+                case OpCode::LOADBOOL:
+                case OpCode::LOADNIL:
+                case OpCode::TOTYPED:
+                    out = encodeABC(op, a + base, b, c);
+                    break;
+                case OpCode::GETGLOBAL:
+                case OpCode::SETGLOBAL:
+                    out = encodeABx(op, a + base, argBx(instr));
+                    break;
+                case OpCode::MOVE:
+                case OpCode::NEG:
+                case OpCode::NOT:
+                    out = encodeABC(op, a + base, b + base, 0);
+                    break;
+                case OpCode::NEWARRAY:
+                case OpCode::NEWMAP:
+                    out = encodeABC(op, a + base, b + base, c);
+                    break;
+                case OpCode::GETFIELD:
+                    k = constantIndex(caller, callee.constants[c], 0xFF);
+                    out = encodeABC(op, a + base, b + base, static_cast<uint32_t>(k));
+                    break;
+                case OpCode::SETFIELD:
+                    k = constantIndex(caller, callee.constants[b], 0xFF);
+                    out = encodeABC(op, a + base, static_cast<uint32_t>(k), c + base);
+                    break;
+                default:
+                    out = encodeABC(op, a + base, b + base, c + base);
+                    break;
+            }
+            return k >= 0;
+        }
+
+        /**
+         * Sustituye `CALL A B 0` por el cuerpo de la función: sus registros pasan a
+         * R[A+1].., donde ya están los argumentos, y el RETURN por un MOVE a R[A]. Las
+         * instrucciones expandidas llevan la línea de la llamada.
+         */
+        bool expandCall(IrFunction& function, const IrInstr& call, const InlineBody& body, std::vector<IrInstr>& out) {
+            FunctionProto& caller = *function.proto;
+            const FunctionProto& callee = *body.proto;
+            uint32_t a = argA(call.instr);
+            uint32_t base = a + 1;
+            if (argB(call.instr) != callee.numParams || base + callee.numRegs > kMaxRegisters) return false;
+            std::vector<IrInstr> code;
+            for (const IrInstr& instr : body.code) {
+                IrInstr copy{instr.instr, call.line};
+                if (instr.op() == OpCode::RETURN) {
+                    copy.instr = argB(instr.instr) != 0 ? encodeABC(OpCode::MOVE, a, argA(instr.instr) + base, 0)
+                                                        : encodeABC(OpCode::LOADNIL, a, 0, 0);
+                } else if (!remapInstr(instr.instr, base, callee, caller, copy.instr)) {
+                    return false;
+                }
+                code.push_back(copy);
+            }
+            for (IrInstr& instr : code) {
+                if (!hasInlineCache(instr.op())) continue;
+                instr.cache = static_cast<uint32_t>(caller.inlineCaches.size());
+                caller.inlineCaches.emplace_back();
+            }
+            out.insert(out.end(), code.begin(), code.end());
+            function.numRegs = std::max(function.numRegs, base + callee.numRegs);
+            return true;
+        }
+
+        // Expande las llamadas a FUNC pequeñas cuyo destino se conoce (R[A] viene de un
+        // GETGLOBAL de la ranura en el mismo bloque)
+        size_t inlineCalls(IrFunction& function, const std::unordered_map<uint32_t, InlineBody>& bodies) {
+            size_t inlined = 0;
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            for (IrBlock& block : function.blocks) {
+                if (block.removed) continue;
+                std::vector<int64_t> loaded(256, -1);   // Ranura global cargada en cada registro
+                std::vector<IrInstr> code;
+                for (const IrInstr& instr : block.code) {
+                    OpCode op = instr.op();
+                    uint32_t a = argA(instr.instr);
+                    bool expanded = false;
+                    if (op == OpCode::CALL && argC(instr.instr) == 0 && loaded[a] >= 0) {
+                        auto it = bodies.find(static_cast<uint32_t>(loaded[a]));
+                        expanded = it != bodies.end() && expandCall(function, instr, it->second, code);
+                    }
+                    if (expanded) {
+                        ++inlined;
+                    } else {
+                        code.push_back(instr);
+                    }
+                    instrRegisters(instr, function.numRegs, uses, defs);
+                    for (uint32_t r : defs) loaded[r] = -1;
+                    if (op == OpCode::GETGLOBAL) loaded[a] = argBx(instr.instr);
+                }
+                block.code = std::move(code);
+            }
+            return inlined;
+        }
+
+        // ---------------------------------------------------------------------------
+        // Extracción de invariantes de bucle (LICM)
+        // ---------------------------------------------------------------------------
+
+        struct Loop {
+            int header;
+            int preheader = kNoBlock;
+            std::vector<char> members;   // Indexado por bloque
+            size_t size = 0;
+        };
+
+        // Instrucciones puras que no pueden fallar: se pueden ejecutar una vez antes del bucle
+        bool hoistableOp(const IrInstr& instr, bool hasCall, const std::unordered_set<uint32_t>& storedGlobals) {
+            switch (instr.op()) {
+                case OpCode::MOVE:
+                case OpCode::LOADK:
+                case OpCode::LOADI:
+                case OpCode::LOADBOOL:
+                case OpCode::LOADNIL:
+                case OpCode::NOT:
+                case OpCode::EQ:
+                case OpCode::NE:
+                    return true;
+                case OpCode::GETGLOBAL:
+                    return !hasCall && storedGlobals.count(argBx(instr.instr)) == 0;
+                case OpCode::ADD:
+                case OpCode::SUB:
+                case OpCode::MUL:
+                case OpCode::DIV:
+                case OpCode::MOD:
+                case OpCode::NEG:
+                case OpCode::LT:
+                case OpCode::LE:
+                    return instr.noThrow;
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * Da un registro nuevo a la definición `index` del bloque cuando su valor sólo se
+         * lee en el propio bloque antes de la siguiente escritura del registro. Así un
+         * temporal que el generador reutiliza en el bucle se puede sacar de él.
+         */
+        bool renameTemporary(IrFunction& function, int b, size_t index, const std::vector<RegSet>& liveIn) {
+            IrBlock& block = function.blocks[b];
+            uint32_t reg = argA(block.code[index].instr);
+            uint32_t fresh = function.numRegs;
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            std::vector<std::pair<size_t, Instr>> rewrites;
+            bool redefined = false;
+            for (size_t j = index + 1; j < block.code.size() && !redefined; ++j) {
+                instrRegisters(block.code[j], function.numRegs, uses, defs);
+                if (contains(uses, reg)) {
+                    Instr replaced;
+                    if (!replaceUse(block.code[j].instr, reg, fresh, replaced)) return false;
+                    rewrites.emplace_back(j, replaced);
+                }
+                redefined = contains(defs, reg);
+            }
+            if (!redefined) {
+                for (int s : function.successors(b)) {
+                    if (liveIn[s][reg]) return false;
+                }
+            }
+            for (const auto& rewrite : rewrites) block.code[rewrite.first].instr = rewrite.second;
+            Instr& def = block.code[index].instr;
+            def = (def & ~(Instr(0xFF) << 8)) | (fresh << 8);
+            ++function.numRegs;
+            return true;
+        }
+
+        size_t hoistLoopInvariants(IrFunction& function) {
+            function.removeUnreachable();
+            std::vector<int> rpo = function.reversePostorder();
+            std::vector<std::vector<int>> preds = function.predecessors();
+            std::vector<int> idom = function.dominators(rpo, preds);
+            auto dominates = [&](int a, int b) {
+                while (b != a) {
+                    if (b == 0) return false;
+                    b = idom[b];
+                }
+                return true;
+            };
+
+            // Bucles naturales, uno por cabecera, a partir de las aristas de retroceso
+            std::vector<Loop> loops;
+            std::unordered_map<int, size_t> loopOf;
+            for (int b : rpo) {
+                for (int header : function.successors(b)) {
+                    if (!dominates(header, b)) continue;
+                    auto found = loopOf.find(header);
+                    if (found == loopOf.end()) {
+                        found = loopOf.emplace(header, loops.size()).first;
+                        loops.push_back(Loop{header, kNoBlock, std::vector<char>(function.blocks.size(), 0), 1});
+                        loops.back().members[header] = 1;
+                    }
+                    Loop& loop = loops[found->second];
+                    std::vector<int> work;
+                    if (!loop.members[b]) {
+                        loop.members[b] = 1;
+                        work.push_back(b);
+                    }
+                    while (!work.empty()) {
+                        int x = work.back();
+                        work.pop_back();
+                        for (int p : preds[x]) {
+                            if (loop.members[p]) continue;
+                            loop.members[p] = 1;
+                            work.push_back(p);
+                        }
+                    }
+                }
+            }
+            if (loops.empty()) return 0;
+
+            // Un preencabezado por bucle, justo antes de la cabecera
+            for (Loop& loop : loops) {
+                loop.preheader = static_cast<int>(function.blocks.size());
+                function.blocks.emplace_back();
+                function.blocks.back().next = loop.header;
+                for (int p : preds[loop.header]) {
+                    if (loop.members[p]) continue;
+                    IrBlock& pred = function.blocks[p];
+                    if (pred.next == loop.header) pred.next = loop.preheader;
+                    if (pred.target == loop.header) pred.target = loop.preheader;
+                    std::replace(pred.cases.begin(), pred.cases.end(), loop.header, loop.preheader);
+                }
+                auto at = std::find(function.layout.begin(), function.layout.end(), loop.header);
+                function.layout.insert(at, loop.preheader);
+            }
+            for (Loop& loop : loops) {
+                loop.members.resize(function.blocks.size(), 0);
+                for (const Loop& inner : loops) {
+                    if (&inner != &loop && loop.members[inner.header]) loop.members[inner.preheader] = 1;
+                }
+                loop.size = static_cast<size_t>(std::count(loop.members.begin(), loop.members.end(), 1));
+            }
+            std::sort(loops.begin(), loops.end(), [](const Loop& x, const Loop& y) { return x.size < y.size; });
+
+            size_t hoisted = 0;
+            std::vector<uint32_t> uses;
+            std::vector<uint32_t> defs;
+            for (const Loop& loop : loops) {
+                std::vector<RegSet> liveIn = function.liveIn();
+                std::vector<int> body;
+                for (int b : function.layout) {
+                    if (loop.members[b] && !function.blocks[b].removed) body.push_back(b);
+                }
+                std::vector<int> defCount(256, 0);
+                bool hasCall = false;
+                std::unordered_set<uint32_t> storedGlobals;
+                RegSet liveOutside;
+                for (int b : body) {
+                    for (const IrInstr& instr : function.blocks[b].code) {
+                        instrRegisters(instr, function.numRegs, uses, defs);
+                        for (uint32_t r : defs) ++defCount[r];
+                        hasCall = hasCall || instr.op() == OpCode::CALL || instr.op() == OpCode::PARFOR;
+                        if (instr.op() == OpCode::SETGLOBAL) storedGlobals.insert(argBx(instr.instr));
+                    }
+                    for (int s : function.successors(b)) {
+                        if (!loop.members[s]) liveOutside |= liveIn[s];
+                    }
+                }
+                const RegSet& liveHeader = liveIn[loop.header];
+
+                std::vector<char> invariant(256, 0);   // Registros cuya única definición ya salió del bucle
+                bool changed = true;
+                while (changed) {
+                    changed = false;
+                    for (int b : body) {
+                        std::vector<IrInstr>& code = function.blocks[b].code;
+                        for (size_t i = 0; i < code.size();) {
+                            if (!hoistableOp(code[i], hasCall, storedGlobals)) {
+                                ++i;
+                                continue;
+                            }
+                            instrRegisters(code[i], function.numRegs, uses, defs);
+                            bool operandsInvariant = std::all_of(uses.begin(), uses.end(), [&](uint32_t r) {
+                                return defCount[r] == 0 || invariant[r];
+                            });
+                            uint32_t reg = defs[0];
+                            bool safe = defCount[reg] == 1 && !liveHeader[reg] && !liveOutside[reg];
+                            if (operandsInvariant && !safe && !hasCall && function.numRegs < kMaxRegisters &&
+                                renameTemporary(function, b, i, liveIn)) {
+                                --defCount[reg];
+                                reg = function.numRegs - 1;
+                                defCount[reg] = 1;
+                                safe = true;
+                            }
+                            if (!operandsInvariant || !safe) {
+                                ++i;
+                                continue;
+                            }
+                            function.blocks[loop.preheader].code.push_back(code[i]);
+                            code.erase(code.begin() + static_cast<std::ptrdiff_t>(i));
+                            invariant[reg] = 1;
+                            ++hoisted;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+            return hoisted;
+        }
+
+        // ---------------------------------------------------------------------------
+        // Superinstrucciones
+        // ---------------------------------------------------------------------------
+
+        /**
+         * Fusiona en el bytecode ya bajado los pares que más se ejecutan en los programas
+         * de examples/ con el modo COUNTING: comparación + JMPIF / JMPIFNOT (la condición
+         * de cada SI y MIENTRAS) y LOADI + ADD / SUB (i = i + 1 y similares). El par se
+         * despacha una sola vez; su segunda instrucción sigue en su sitio.
+         */
+        size_t fuseInstructions(FunctionProto& proto) {
+            std::vector<Instr>& code = proto.code;
+            size_t fused = 0;
+            for (size_t pc = 0; pc + 1 < code.size(); ++pc) {
+                OpCode op = opOf(code[pc]);
+                Instr second = code[pc + 1];
+                OpCode fusion = op;
+                switch (op) {
+                    case OpCode::EQ:
+                    case OpCode::NE:
+                    case OpCode::LT:
+                    case OpCode::LE:
+                        if ((opOf(second) == OpCode::JMPIF || opOf(second) == OpCode::JMPIFNOT) &&
+                            argA(second) == argA(code[pc])) {
+                            fusion = op == OpCode::EQ   ? OpCode::EQJMP
+                                     : op == OpCode::NE ? OpCode::NEJMP
+                                     : op == OpCode::LT ? OpCode::LTJMP
+                                                        : OpCode::LEJMP;
+                        }
+                        break;
+                    case OpCode::LOADI:
+                        if (opOf(second) == OpCode::ADD) fusion = OpCode::LOADIADD;
+                        if (opOf(second) == OpCode::SUB) fusion = OpCode::LOADISUB;
+                        break;
+                    case OpCode::CALL:
+                        if (opOf(second) == OpCode::RETURN && argB(second) != 0 && argA(second) == argA(code[pc])) {
+                            fusion = OpCode::TAILCALL;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                if (fusion == op) continue;
+                code[pc] = (code[pc] & ~Instr(0xFF)) | static_cast<Instr>(fusion);
+                ++fused;
+                ++pc;
+            }
+            return fused;
+        }
+
+    } // namespace
+
+    OptimizationStats optimizeProgram(VM& vm, int level, size_t firstProto) {
+        OptimizationStats stats;
+        std::vector<FunctionProto*> protos;
+        for (size_t i = firstProto; i < vm.protos().size(); ++i) {
+            FunctionProto* proto = vm.protos()[i].get();
+            if (proto->mappedCode != nullptr) continue;
+            protos.push_back(proto);
+            stats.instructionsBefore += proto->code.size();
+        }
+        stats.instructionsAfter = stats.instructionsBefore;
+        if (level <= 0) return stats;
+
+        std::unordered_map<uint32_t, InlineBody> bodies;
+        if (level >= 2) bodies = findInlineBodies(vm);
+
+        stats.instructionsAfter = 0;
+        for (FunctionProto* proto : protos) {
+            IrFunction function = buildIr(*proto);
+            if (level >= 2) stats.inlinedCalls += inlineCalls(function, bodies);
+            forwardGlobals(function);
+            propagateCopies(function);
+            {
+                SsaForm ssa = buildSsa(function);
+                ConstantPropagation propagation(vm, function, ssa);
+                propagation.run();
+                propagation.rewrite(stats);
+            }
+            coalesceMoves(function);
+            stats.removedInstructions += eliminateDeadCode(function);
+            simplifyCfg(function);
+            if (level >= 2) {
+                stats.hoistedInstructions += hoistLoopInvariants(function);
+                stats.removedInstructions += eliminateDeadCode(function);
+                simplifyCfg(function);
+            }
+            lowerIr(function);
+            stats.fusedInstructions += fuseInstructions(*proto);
+            stats.instructionsAfter += proto->code.size();
+        }
+        return stats;
+    }
+
+} // namespace mc_core
@@ -0,0 +1,48 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "vm.h"
+#include <cstddef>
+
+namespace mc_core {
+
+    // Nivel que usan el modo interpret y `mc++ compile` sin -O
+    constexpr int kDefaultOptimizationLevel = 1;
+    constexpr int kMaxOptimizationLevel = 2;
+
+    struct OptimizationStats {
+        size_t instructionsBefore = 0;
+        size_t instructionsAfter = 0;
+        size_t inlinedCalls = 0;
+        size_t foldedInstructions = 0;    // Instrucciones sustituidas por su constante
+        size_t foldedBranches = 0;        // Saltos condicionales resueltos en compilación
+        size_t removedInstructions = 0;   // Eliminadas como código muerto
+        size_t hoistedInstructions = 0;   // Sacadas de un bucle
+        size_t fusedInstructions = 0;     // Pares convertidos en superinstrucciones
+    };
+
+    /**
+     * Optimiza el bytecode de todos los prototipos generados por compileProgram() en
+     * el VM. Trabaja sobre la IR de ir.h y vuelve a bajarla a bytecode, así que el
+     * resultado se ejecuta y se guarda en la caché .mcc como cualquier otro.
+     *
+     *  -O0  sin cambios.
+     *  -O1  propagación de constantes condicional sobre SSA (incluido el plegado de
+     *       saltos y de SWITCH), reenvío de globales dentro de cada bloque, eliminación
+     *       de código muerto, simplificación del grafo de control de flujo y, ya en el
+     *       bytecode final, superinstrucciones para los pares de instrucciones más
+     *       frecuentes (comparación + salto, LOADI + ADD / SUB, CALL + RETURN
+     *       como llamada final).
+     *  -O2  además, expansión en línea de FUNC pequeñas sin saltos y extracción de
+     *       instrucciones invariantes de los bucles PARA / MIENTRAS (LICM).
+     *
+     * Ninguna transformación cambia la salida ni los errores de un programa; en -O2
+     * un error dentro de una función expandida se informa en la línea de la llamada.
+     * Los prototipos cargados de la caché no se tocan, ni los anteriores a firstProto
+     * (una sesión interactiva sólo optimiza los que añadió cada entrada).
+     */
+    OptimizationStats optimizeProgram(VM& vm, int level, size_t firstProto = 0);
+
+} // namespace mc_core
+
+#endif // OPTIMIZER_H
@@ -0,0 +1,123 @@
+#include "output.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace mc_core {
+
+    namespace {
+
+        // Búferes vivos de todos los hilos (para flushAll)
+        std::mutex& registryMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::vector<OutputBuffer*>& registry() {
+            static std::vector<OutputBuffer*> buffers;
+            return buffers;
+        }
+
+        // -1 = aún sin detectar; 0 = por bloques; 1 = por líneas
+        std::atomic<int> lineMode{-1};
+        std::atomic<uint64_t> writes{0};
+
+        // Escribe todos los trozos aunque el sistema acepte sólo una parte en cada llamada
+        void writeAll(iovec* pieces, int count) {
+            while (count > 0) {
+                ssize_t written = ::writev(STDOUT_FILENO, pieces, count);
+                writes.fetch_add(1, std::memory_order_relaxed);
+                if (written < 0) {
+                    if (errno == EINTR) continue;
+                    return;  // Como stdio: la salida cerrada o llena descarta el texto
+                }
+                size_t remaining = static_cast<size_t>(written);
+                while (count > 0 && remaining >= pieces->iov_len) {
+                    remaining -= pieces->iov_len;
+                    ++pieces;
+                    --count;
+                }
+                if (count > 0) {
+                    pieces->iov_base = static_cast<char*>(pieces->iov_base) + remaining;
+                    pieces->iov_len -= remaining;
+                }
+            }
+        }
+
+    } // namespace
+
+    OutputBuffer::OutputBuffer() : data_(new char[kCapacity]) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().push_back(this);
+    }
+
+    OutputBuffer::~OutputBuffer() {
+        {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            auto& buffers = registry();
+            buffers.erase(std::remove(buffers.begin(), buffers.end(), this), buffers.end());
+        }
+        flush();
+    }
+
+    OutputBuffer& OutputBuffer::local() {
+        thread_local OutputBuffer buffer;
+        return buffer;
+    }
+
+    void OutputBuffer::flushAll() {
+        local().flush();
+        std::lock_guard<std::mutex> lock(registryMutex());
+        for (OutputBuffer* buffer : registry()) buffer->flush();
+    }
+
+    void OutputBuffer::setLineBuffered(bool enabled) {
+        lineMode.store(enabled ? 1 : 0, std::memory_order_relaxed);
+    }
+
+    bool OutputBuffer::lineBuffered() {
+        int mode = lineMode.load(std::memory_order_relaxed);
+        if (mode < 0) {
+            mode = ::isatty(STDOUT_FILENO) ? 1 : 0;
+            lineMode.store(mode, std::memory_order_relaxed);
+        }
+        return mode == 1;
+    }
+
+    uint64_t OutputBuffer::writeCalls() {
+        return writes.load(std::memory_order_relaxed);
+    }
+
+    void OutputBuffer::write(std::string_view text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size_ + text.size() > kCapacity) {
+            flushLocked(text);
+            return;
+        }
+        std::memcpy(data_.get() + size_, text.data(), text.size());
+        size_ += text.size();
+        if (lineBuffered() && text.find('\n') != std::string_view::npos) flushLocked({});
+    }
+
+    void OutputBuffer::flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushLocked({});
+    }
+
+    void OutputBuffer::flushLocked(std::string_view extra) {
+        if (size_ == 0 && extra.empty()) return;
+        std::fflush(stdout);
+        iovec pieces[2];
+        int count = 0;
+        if (size_ > 0) pieces[count++] = iovec{data_.get(), size_};
+        if (!extra.empty()) pieces[count++] = iovec{const_cast<char*>(extra.data()), extra.size()};
+        writeAll(pieces, count);
+        size_ = 0;
+    }
+
+} // namespace mc_core
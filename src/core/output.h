@@ -0,0 +1,61 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace mc_core {
+
+    /**
+     * Salida estándar de los programas MC++ (MOSTRAR).
+     *
+     * Cada hilo escribe en su propio búfer, que se entrega al descriptor 1 junto con
+     * el texto pendiente en una sola llamada a writev:
+     *  - cuando lo siguiente no cabe (un texto mayor que el búfer se escribe sin copiarlo),
+     *  - tras cada fin de línea si la salida es un terminal,
+     *  - en los puntos de vaciado: flushAll() al terminar el programa o fallar, antes de
+     *    que el planificador duerma el hilo y al principio y al final de cada PARA PARALELO,
+     *  - al terminar el hilo.
+     * Redirigida a una tubería o a un archivo, un millón de líneas son unas cientos de
+     * escrituras en lugar de un millón. Antes de escribir se vacía stdout de C/C++ para
+     * no adelantarse a lo que el intérprete ya haya impreso por allí.
+     */
+    class OutputBuffer {
+    public:
+        static constexpr size_t kCapacity = 64 * 1024;
+
+        // Búfer del hilo actual
+        static OutputBuffer& local();
+
+        // Vacía los búferes de todos los hilos, empezando por el actual
+        static void flushAll();
+
+        // Vaciado por líneas: por defecto, si el descriptor 1 es un terminal
+        static void setLineBuffered(bool enabled);
+        static bool lineBuffered();
+
+        // Llamadas a writev hechas en todo el proceso
+        static uint64_t writeCalls();
+
+        OutputBuffer(const OutputBuffer&) = delete;
+        OutputBuffer& operator=(const OutputBuffer&) = delete;
+        ~OutputBuffer();
+
+        void write(std::string_view text);
+        void flush();
+
+    private:
+        std::mutex mutex_;  // Sólo lo disputa flushAll() desde otro hilo
+        std::unique_ptr<char[]> data_;
+        size_t size_ = 0;
+
+        OutputBuffer();
+        void flushLocked(std::string_view extra);
+    };
+
+} // namespace mc_core
+
+#endif // OUTPUT_H
@@ -0,0 +1,872 @@
+#include "parser.h"
+
+namespace mc_core {
+
+    namespace {
+
+        // Precedencia de los operadores binarios (0 = no es operador binario)
+        int binaryPrecedence(TokenKind kind) {
+            switch (kind) {
+                case TokenKind::KW_O:
+                case TokenKind::OR_OR: return 1;
+                case TokenKind::KW_Y:
+                case TokenKind::AND_AND: return 2;
+                case TokenKind::EQ:
+                case TokenKind::NE: return 3;
+                case TokenKind::LT:
+                case TokenKind::LE:
+                case TokenKind::GT:
+                case TokenKind::GE: return 4;
+                case TokenKind::PLUS:
+                case TokenKind::MINUS: return 5;
+                case TokenKind::STAR:
+                case TokenKind::SLASH:
+                case TokenKind::PERCENT: return 6;
+                default: return 0;
+            }
+        }
+
+        OpKind binaryOp(TokenKind kind) {
+            switch (kind) {
+                case TokenKind::KW_O:
+                case TokenKind::OR_OR: return OpKind::OR;
+                case TokenKind::KW_Y:
+                case TokenKind::AND_AND: return OpKind::AND;
+                case TokenKind::EQ: return OpKind::EQ;
+                case TokenKind::NE: return OpKind::NE;
+                case TokenKind::LT: return OpKind::LT;
+                case TokenKind::LE: return OpKind::LE;
+                case TokenKind::GT: return OpKind::GT;
+                case TokenKind::GE: return OpKind::GE;
+                case TokenKind::PLUS: return OpKind::ADD;
+                case TokenKind::MINUS: return OpKind::SUB;
+                case TokenKind::STAR: return OpKind::MUL;
+                case TokenKind::SLASH: return OpKind::DIV;
+                case TokenKind::PERCENT: return OpKind::MOD;
+                default: return OpKind::NONE;
+            }
+        }
+
+        OpKind assignOp(TokenKind kind) {
+            switch (kind) {
+                case TokenKind::PLUS_ASSIGN: return OpKind::ADD;
+                case TokenKind::MINUS_ASSIGN: return OpKind::SUB;
+                case TokenKind::STAR_ASSIGN: return OpKind::MUL;
+                case TokenKind::SLASH_ASSIGN: return OpKind::DIV;
+                default: return OpKind::NONE;
+            }
+        }
+
+        bool isAssignToken(TokenKind kind) {
+            return kind == TokenKind::ASSIGN || assignOp(kind) != OpKind::NONE;
+        }
+
+        // Las etiquetas CASO que son comparaciones se evalúan como condiciones
+        bool isConditionOp(OpKind op) {
+            return op == OpKind::EQ || op == OpKind::NE || op == OpKind::LT || op == OpKind::LE ||
+                   op == OpKind::GT || op == OpKind::GE || op == OpKind::AND || op == OpKind::OR ||
+                   op == OpKind::NOT;
+        }
+
+        // Tokens que pueden usarse como nombre tras '.' (incluye palabras clave)
+        bool isNameToken(TokenKind kind) {
+            return kind == TokenKind::IDENT ||
+                   (kind >= TokenKind::KW_FUNC && kind <= TokenKind::KW_NO);
+        }
+
+    } // namespace
+
+    Parser::Parser(std::string_view source, AstArena& arena) : lexer_(source), arena_(arena) {
+        arena_.reserveForSource(source.size());
+        scratch_.reserve(256);
+        advance();
+    }
+
+    // -------------------------------------
+    // Gestión de tokens
+    // -------------------------------------
+
+    void Parser::advance() {
+        current_ = lexer_.next();
+    }
+
+    bool Parser::match(TokenKind kind) {
+        if (current_.kind == kind) {
+            advance();
+            return true;
+        }
+        return false;
+    }
+
+    Token Parser::expect(TokenKind kind, const char* context) {
+        if (current_.kind != kind) {
+            error(std::string("se esperaba ") + Lexer::kindName(kind) + " " + context +
+                  ", se encontró " + describeCurrent());
+        }
+        Token token = current_;
+        advance();
+        return token;
+    }
+
+    void Parser::error(const std::string& message) const {
+        throw SyntaxError(message, current_.line);
+    }
+
+    std::string Parser::describeCurrent() const {
+        if (current_.kind == TokenKind::END) return "fin de archivo";
+        return "'" + std::string(lexer_.text(current_)) + "'";
+    }
+
+    void Parser::skipSeparators() {
+        while (current_.kind == TokenKind::SEMICOLON) advance();
+    }
+
+    bool Parser::atStatementEnd() const {
+        return current_.kind == TokenKind::END || current_.kind == TokenKind::RBRACE ||
+               current_.kind == TokenKind::SEMICOLON || current_.newlineBefore;
+    }
+
+    // -------------------------------------
+    // Construcción de nodos
+    // -------------------------------------
+
+    NodeId Parser::makeNode(NodeKind kind, uint32_t line) {
+        AstNode node;
+        node.kind = kind;
+        node.line = line;
+        return arena_.add(node);
+    }
+
+    NodeId Parser::finishList(NodeId id, size_t mark) {
+        uint32_t count = static_cast<uint32_t>(scratch_.size() - mark);
+        uint32_t start = arena_.addList(scratch_.data() + mark, count);
+        scratch_.resize(mark);
+        AstNode& node = arena_.node(id);
+        node.b = start;
+        node.c = count;
+        return id;
+    }
+
+    StrId Parser::internCurrent() {
+        if (!isNameToken(current_.kind)) {
+            error("se esperaba un identificador, se encontró " + describeCurrent());
+        }
+        StrId id = arena_.intern(lexer_.text(current_));
+        advance();
+        return id;
+    }
+
+    StrId Parser::decodeString(const Token& token) {
+        std::string_view raw = lexer_.text(token);
+        raw = raw.substr(1, raw.size() - 2);
+        if (raw.find('\\') == std::string_view::npos) {
+            return arena_.addString(raw);
+        }
+        std::string decoded;
+        decoded.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i) {
+            char c = raw[i];
+            if (c != '\\' || i + 1 == raw.size()) {
+                decoded.push_back(c);
+                continue;
+            }
+            char esc = raw[++i];
+            switch (esc) {
+                case 'n': decoded.push_back('\n'); break;
+                case 't': decoded.push_back('\t'); break;
+                case 'r': decoded.push_back('\r'); break;
+                case '0': decoded.push_back('\0'); break;
+                default: decoded.push_back(esc); break;
+            }
+        }
+        return arena_.addString(decoded);
+    }
+
+    // -------------------------------------
+    // Declaraciones
+    // -------------------------------------
+
+    NodeId Parser::parseProgram() {
+        NodeId program = makeNode(NodeKind::PROGRAM, current_.line);
+        size_t mark = scratch_.size();
+        skipSeparators();
+        while (!check(TokenKind::END)) {
+            NodeId item = parseTopLevel();
+            scratch_.push_back(item);
+            skipSeparators();
+        }
+        return finishList(program, mark);
+    }
+
+    NodeId Parser::parseTopLevel() {
+        switch (current_.kind) {
+            case TokenKind::KW_FUNC: return parseFunction(0);
+            case TokenKind::KW_STRUCT: return parseStruct();
+            case TokenKind::KW_CLASE: return parseClass();
+            case TokenKind::KW_MODULO: return parseModule();
+            default: return parseStatement();
+        }
+    }
+
+    NodeId Parser::parseFunction(uint16_t flags) {
+        uint32_t line = current_.line;
+        expect(TokenKind::KW_FUNC, "al inicio de la función");
+        NodeId fn = makeNode(NodeKind::FUNC_DECL, line);
+        StrId name = internCurrent();
+        expect(TokenKind::LPAREN, "tras el nombre de la función");
+        size_t mark = scratch_.size();
+        parseParams();
+        finishList(fn, mark);
+        NodeId returnType = kNoNode;
+        if (match(TokenKind::COLON)) {
+            returnType = parseType();
+        }
+        NodeId body = parseBlock();
+        AstNode& node = arena_.node(fn);
+        node.v.str = name;
+        node.flags = flags;
+        node.a = returnType;
+        node.d = body;
+        return fn;
+    }
+
+    // Lista de parámetros "nombre[: Tipo], ..." hasta ')' (ya consumido '(')
+    void Parser::parseParams() {
+        if (match(TokenKind::RPAREN)) return;
+        do {
+            uint32_t line = current_.line;
+            StrId name = internCurrent();
+            NodeId type = kNoNode;
+            if (match(TokenKind::COLON)) {
+                type = parseType();
+            }
+            NodeId param = makeNode(NodeKind::PARAM, line);
+            AstNode& node = arena_.node(param);
+            node.v.str = name;
+            node.a = type;
+            scratch_.push_back(param);
+        } while (match(TokenKind::COMMA));
+        expect(TokenKind::RPAREN, "al final de los parámetros");
+    }
+
+    NodeId Parser::parseType() {
+        uint32_t line = current_.line;
+        NodeId type = makeNode(NodeKind::TYPE, line);
+        StrId name = internCurrent();
+        size_t mark = scratch_.size();
+        if (match(TokenKind::LT)) {
+            do {
+                NodeId arg = parseType();
+                scratch_.push_back(arg);
+            } while (match(TokenKind::COMMA));
+            expect(TokenKind::GT, "al cerrar los argumentos de tipo");
+        }
+        finishList(type, mark);
+        arena_.node(type).v.str = name;
+        return type;
+    }
+
+    NodeId Parser::parseVarDecl(bool isConst) {
+        uint32_t line = current_.line;
+        advance();  // VAR / CONST
+        NodeId decl = makeNode(NodeKind::VAR_DECL, line);
+        StrId name = internCurrent();
+        NodeId type = kNoNode;
+        NodeId init = kNoNode;
+        if (match(TokenKind::COLON)) {
+            type = parseType();
+        }
+        if (match(TokenKind::ASSIGN)) {
+            init = parseExpression();
+        } else if (isConst) {
+            error("la constante debe inicializarse");
+        }
+        AstNode& node = arena_.node(decl);
+        node.v.str = name;
+        node.a = type;
+        node.d = init;
+        node.flags = isConst ? FLAG_CONST : 0;
+        return decl;
+    }
+
+    NodeId Parser::parseStruct() {
+        uint32_t line = current_.line;
+        advance();  // STRUCT
+        NodeId decl = makeNode(NodeKind::STRUCT_DECL, line);
+        StrId name = internCurrent();
+        expect(TokenKind::LBRACE, "tras el nombre de la estructura");
+        size_t mark = scratch_.size();
+        while (!check(TokenKind::RBRACE)) {
+            if (check(TokenKind::KW_FUNC)) {
+                NodeId method = parseFunction(FLAG_METHOD);
+                scratch_.push_back(method);
+                continue;
+            }
+            match(TokenKind::KW_VAR);
+            uint32_t fieldLine = current_.line;
+            NodeId field = makeNode(NodeKind::FIELD, fieldLine);
+            StrId fieldName = internCurrent();
+            expect(TokenKind::COLON, "tras el nombre del campo");
+            NodeId type = parseType();
+            AstNode& node = arena_.node(field);
+            node.v.str = fieldName;
+            node.a = type;
+            scratch_.push_back(field);
+            while (match(TokenKind::COMMA) || match(TokenKind::SEMICOLON)) {}
+        }
+        advance();  // '}'
+        finishList(decl, mark);
+        arena_.node(decl).v.str = name;
+        return decl;
+    }
+
+    NodeId Parser::parseClass() {
+        uint32_t line = current_.line;
+        advance();  // CLASE
+        NodeId decl = makeNode(NodeKind::CLASS_DECL, line);
+        StrId name = internCurrent();
+        NodeId base = kNoNode;
+        if (match(TokenKind::COLON)) {
+            base = makeNode(NodeKind::IDENT, current_.line);
+            StrId baseName = internCurrent();
+            arena_.node(base).v.str = baseName;
+        }
+        expect(TokenKind::LBRACE, "tras el nombre de la clase");
+
+        size_t mark = scratch_.size();
+        uint16_t access = 0;
+        skipSeparators();
+        while (!check(TokenKind::RBRACE)) {
+            if (check(TokenKind::KW_PRIVADO) || check(TokenKind::KW_PUBLICO)) {
+                access = check(TokenKind::KW_PRIVADO) ? FLAG_PRIVATE : 0;
+                advance();
+                expect(TokenKind::COLON, "tras el modificador de acceso");
+            } else if (check(TokenKind::KW_VAR) || check(TokenKind::KW_CONST)) {
+                NodeId field = parseVarDecl(check(TokenKind::KW_CONST));
+                AstNode& node = arena_.node(field);
+                node.kind = NodeKind::FIELD;
+                node.flags = access;
+                scratch_.push_back(field);
+            } else if (check(TokenKind::KW_FUNC)) {
+                NodeId method = parseFunction(static_cast<uint16_t>(FLAG_METHOD | access));
+                scratch_.push_back(method);
+            } else if (check(TokenKind::KW_CONSTRUCTOR)) {
+                NodeId ctor = parseConstructor();
+                scratch_.push_back(ctor);
+            } else {
+                error("miembro de clase inesperado: " + describeCurrent());
+            }
+            skipSeparators();
+        }
+        advance();  // '}'
+        finishList(decl, mark);
+        AstNode& node = arena_.node(decl);
+        node.v.str = name;
+        node.a = base;
+        return decl;
+    }
+
+    NodeId Parser::parseConstructor() {
+        uint32_t line = current_.line;
+        advance();  // CONSTRUCTOR
+        NodeId ctor = makeNode(NodeKind::CTOR_DECL, line);
+        expect(TokenKind::LPAREN, "tras CONSTRUCTOR");
+        size_t mark = scratch_.size();
+        parseParams();
+        finishList(ctor, mark);
+
+        // Llamada opcional al constructor base: ": Base(args)"
+        NodeId superCall = kNoNode;
+        if (match(TokenKind::COLON)) {
+            NodeId callee = makeNode(NodeKind::IDENT, current_.line);
+            StrId baseName = internCurrent();
+            arena_.node(callee).v.str = baseName;
+            expect(TokenKind::LPAREN, "en la llamada al constructor base");
+            superCall = makeNode(NodeKind::CALL, line);
+            size_t argMark = scratch_.size();
+            parseArguments();
+            finishList(superCall, argMark);
+            arena_.node(superCall).a = callee;
+        }
+        NodeId body = parseBlock();
+        AstNode& node = arena_.node(ctor);
+        node.a = superCall;
+        node.d = body;
+        return ctor;
+    }
+
+    NodeId Parser::parseImport() {
+        uint32_t line = current_.line;
+        advance();  // IMPORTAR
+        NodeId import = makeNode(NodeKind::IMPORT, line);
+        StrId name;
+        if (check(TokenKind::STRING_LIT)) {
+            name = decodeString(current_);
+            advance();
+        } else {
+            name = internCurrent();
+        }
+        arena_.node(import).v.str = name;
+        return import;
+    }
+
+    NodeId Parser::parseModule() {
+        uint32_t line = current_.line;
+        advance();  // MODULO
+        NodeId module = makeNode(NodeKind::MODULE_DECL, line);
+        StrId name = internCurrent();
+        expect(TokenKind::LBRACE, "tras el nombre del módulo");
+        size_t mark = scratch_.size();
+        skipSeparators();
+        while (!check(TokenKind::RBRACE)) {
+            if (check(TokenKind::END)) error("módulo sin cerrar");
+            NodeId item = parseTopLevel();
+            scratch_.push_back(item);
+            skipSeparators();
+        }
+        advance();  // '}'
+        finishList(module, mark);
+        arena_.node(module).v.str = name;
+        return module;
+    }
+
+    // -------------------------------------
+    // Sentencias
+    // -------------------------------------
+
+    NodeId Parser::parseStatement() {
+        uint32_t line = current_.line;
+        switch (current_.kind) {
+            case TokenKind::KW_VAR: return parseVarDecl(false);
+            case TokenKind::KW_CONST: return parseVarDecl(true);
+            case TokenKind::KW_SI: return parseIf();
+            case TokenKind::KW_MIENTRAS: return parseWhile();
+            case TokenKind::KW_PARA: return parseFor();
+            case TokenKind::KW_RETORNAR: return parseReturn();
+            case TokenKind::KW_SELECCION: return parseSwitch();
+            case TokenKind::KW_IMPORTAR: return parseImport();
+            case TokenKind::KW_FUNC: return parseFunction(0);
+            case TokenKind::KW_ROMPER:
+                advance();
+                return makeNode(NodeKind::BREAK, line);
+            case TokenKind::KW_CONTINUAR:
+                advance();
+                return makeNode(NodeKind::CONTINUE, line);
+            case TokenKind::LBRACE:
+                return parseBlock();
+            default: {
+                NodeId expr = parseExpression();
+                if (!atStatementEnd()) {
+                    error("se esperaba el final de la sentencia, se encontró " + describeCurrent());
+                }
+                NodeId stmt = makeNode(NodeKind::EXPR_STMT, line);
+                arena_.node(stmt).a = expr;
+                return stmt;
+            }
+        }
+    }
+
+    NodeId Parser::parseBlock() {
+        NodeId block = makeNode(NodeKind::BLOCK, current_.line);
+        expect(TokenKind::LBRACE, "al inicio del bloque");
+        size_t mark = scratch_.size();
+        skipSeparators();
+        while (!check(TokenKind::RBRACE)) {
+            if (check(TokenKind::END)) error("bloque sin cerrar, se esperaba '}'");
+            NodeId stmt = parseStatement();
+            scratch_.push_back(stmt);
+            skipSeparators();
+        }
+        advance();  // '}'
+        return finishList(block, mark);
+    }
+
+    NodeId Parser::parseIf() {
+        uint32_t line = current_.line;
+        advance();  // SI / MÁS_SI
+        NodeId node = makeNode(NodeKind::IF, line);
+        NodeId cond = parseExpression();
+        NodeId then = parseBlock();
+        NodeId otherwise = kNoNode;
+        if (check(TokenKind::KW_SINO)) {
+            advance();
+            otherwise = check(TokenKind::KW_SI) ? parseIf() : parseBlock();
+        } else if (check(TokenKind::KW_MAS_SI)) {
+            otherwise = parseIf();
+        } else if (match(TokenKind::KW_MAS)) {
+            otherwise = parseBlock();
+        }
+        AstNode& n = arena_.node(node);
+        n.a = cond;
+        n.b = then;
+        n.d = otherwise;
+        return node;
+    }
+
+    NodeId Parser::parseWhile() {
+        uint32_t line = current_.line;
+        advance();  // MIENTRAS
+        NodeId node = makeNode(NodeKind::WHILE, line);
+        NodeId cond = parseExpression();
+        match(TokenKind::KW_HACER);
+        NodeId body = parseBlock();
+        AstNode& n = arena_.node(node);
+        n.a = cond;
+        n.d = body;
+        return node;
+    }
+
+    // PARA [CADA] x EN lista | PARA i DESDE a HASTA b [INCREMENTO s] | PARA i = a HASTA b
+    // | PARA PARALELO i DESDE a HASTA b [INCREMENTO s] [REDUCIR op x, ...]
+    NodeId Parser::parseFor() {
+        uint32_t line = current_.line;
+        advance();  // PARA
+        bool each = match(TokenKind::KW_CADA);
+        StrId var = internCurrent();
+        // PARALELO no es palabra reservada: lo distingue el nombre de variable que le sigue
+        bool parallel = !each && arena_.str(var) == "PARALELO" && check(TokenKind::IDENT);
+        if (parallel) var = internCurrent();
+        NodeId node;
+        NodeId wrapper = kNoNode;
+        if (each || check(TokenKind::KW_EN)) {
+            if (parallel) error("PARA PARALELO solo admite rangos DESDE ... HASTA");
+            expect(TokenKind::KW_EN, "en el bucle PARA CADA");
+            node = makeNode(NodeKind::FOR_EACH, line);
+            NodeId iterable = parseExpression();
+            arena_.node(node).a = iterable;
+        } else {
+            if (!match(TokenKind::KW_DESDE) && !match(TokenKind::ASSIGN)) {
+                error("se esperaba DESDE o EN en el bucle PARA, se encontró " + describeCurrent());
+            }
+            node = makeNode(NodeKind::FOR_RANGE, line);
+            NodeId from = parseExpression();
+            expect(TokenKind::KW_HASTA, "en el bucle PARA");
+            NodeId to = parseExpression();
+            NodeId step = kNoNode;
+            if (match(TokenKind::KW_INCREMENTO)) {
+                step = parseExpression();
+            }
+            AstNode& n = arena_.node(node);
+            n.a = from;
+            n.b = to;
+            n.c = step;
+            if (parallel) wrapper = parseReductions(line);
+        }
+        match(TokenKind::KW_HACER);
+        NodeId body = parseBlock();
+        AstNode& n = arena_.node(node);
+        n.v.str = var;
+        n.d = body;
+        if (wrapper == kNoNode) return node;
+        arena_.node(wrapper).a = node;
+        return wrapper;
+    }
+
+    // Cláusula opcional REDUCIR de PARA PARALELO: SUMA x, PRODUCTO y, MIN z, MAX w
+    NodeId Parser::parseReductions(uint32_t line) {
+        NodeId node = makeNode(NodeKind::PARALLEL_FOR, line);
+        size_t mark = scratch_.size();
+        if (check(TokenKind::IDENT) && lexer_.text(current_) == "REDUCIR") {
+            advance();
+            do {
+                uint32_t reductionLine = current_.line;
+                std::string_view opName = check(TokenKind::IDENT) ? lexer_.text(current_) : std::string_view();
+                OpKind op = opName == "SUMA"       ? OpKind::ADD
+                            : opName == "PRODUCTO" ? OpKind::MUL
+                            : opName == "MIN"      ? OpKind::LT
+                            : opName == "MAX"      ? OpKind::GT
+                                                   : OpKind::NONE;
+                if (op == OpKind::NONE) {
+                    error("se esperaba SUMA, PRODUCTO, MIN o MAX en REDUCIR, se encontró " + describeCurrent());
+                }
+                advance();
+                StrId target = internCurrent();
+                NodeId reduction = makeNode(NodeKind::REDUCTION, reductionLine);
+                arena_.node(reduction).op = op;
+                arena_.node(reduction).v.str = target;
+                scratch_.push_back(reduction);
+            } while (match(TokenKind::COMMA));
+        }
+        return finishList(node, mark);
+    }
+
+    NodeId Parser::parseReturn() {
+        uint32_t line = current_.line;
+        advance();  // RETORNAR
+        NodeId node = makeNode(NodeKind::RETURN, line);
+        if (!atStatementEnd()) {
+            NodeId value = parseExpression();
+            arena_.node(node).a = value;
+        }
+        return node;
+    }
+
+    NodeId Parser::parseSwitch() {
+        uint32_t line = current_.line;
+        advance();  // SELECCION
+        NodeId node = makeNode(NodeKind::SWITCH, line);
+        NodeId subject = parseExpression();
+        expect(TokenKind::LBRACE, "tras el sujeto de SELECCION");
+        size_t mark = scratch_.size();
+        skipSeparators();
+        while (!check(TokenKind::RBRACE)) {
+            uint32_t caseLine = current_.line;
+            NodeId caseNode = makeNode(NodeKind::CASE, caseLine);
+            NodeId label = kNoNode;
+            if (match(TokenKind::KW_CASO)) {
+                label = parseExpression();
+                const AstNode& labelNode = arena_.node(label);
+                if ((labelNode.kind == NodeKind::BINARY || labelNode.kind == NodeKind::UNARY) &&
+                    isConditionOp(labelNode.op)) {
+                    arena_.node(caseNode).flags = FLAG_GUARD;
+                }
+            } else if (!match(TokenKind::KW_DEFECTO)) {
+                error("se esperaba CASO o DEFECTO, se encontró " + describeCurrent());
+            }
+            expect(TokenKind::COLON, "tras la etiqueta del caso");
+            size_t bodyMark = scratch_.size();
+            skipSeparators();
+            while (!check(TokenKind::KW_CASO) && !check(TokenKind::KW_DEFECTO) &&
+                   !check(TokenKind::RBRACE)) {
+                if (check(TokenKind::END)) error("SELECCION sin cerrar");
+                NodeId stmt = parseStatement();
+                scratch_.push_back(stmt);
+                skipSeparators();
+            }
+            finishList(caseNode, bodyMark);
+            arena_.node(caseNode).a = label;
+            scratch_.push_back(caseNode);
+        }
+        advance();  // '}'
+        finishList(node, mark);
+        arena_.node(node).a = subject;
+        return node;
+    }
+
+    // -------------------------------------
+    // Expresiones
+    // -------------------------------------
+
+    NodeId Parser::parseExpression() {
+        return parseAssignment();
+    }
+
+    NodeId Parser::parseAssignment() {
+        NodeId target = parseBinary(1);
+        if (!isAssignToken(current_.kind)) {
+            return target;
+        }
+        NodeKind targetKind = arena_.kind(target);
+        if (targetKind != NodeKind::IDENT && targetKind != NodeKind::INDEX &&
+            targetKind != NodeKind::MEMBER) {
+            error("destino de asignación no válido");
+        }
+        uint32_t line = current_.line;
+        OpKind op = assignOp(current_.kind);
+        advance();
+        NodeId value = parseAssignment();
+        NodeId node = makeNode(NodeKind::ASSIGN, line);
+        AstNode& n = arena_.node(node);
+        n.op = op;
+        n.a = target;
+        n.b = value;
+        return node;
+    }
+
+    NodeId Parser::parseBinary(int minPrecedence) {
+        NodeId left = parseUnary();
+        for (;;) {
+            int precedence = binaryPrecedence(current_.kind);
+            if (precedence < minPrecedence || precedence == 0) {
+                return left;
+            }
+            // Un '+' o '-' al inicio de una línea comienza una nueva sentencia
+            if (current_.newlineBefore &&
+                (current_.kind == TokenKind::PLUS || current_.kind == TokenKind::MINUS)) {
+                return left;
+            }
+            uint32_t line = current_.line;
+            OpKind op = binaryOp(current_.kind);
+            advance();
+            NodeId right = parseBinary(precedence + 1);
+            NodeId node = makeNode(NodeKind::BINARY, line);
+            AstNode& n = arena_.node(node);
+            n.op = op;
+            n.a = left;
+            n.b = right;
+            left = node;
+        }
+    }
+
+    NodeId Parser::parseUnary() {
+        if (check(TokenKind::MINUS) || check(TokenKind::KW_NO) || check(TokenKind::BANG)) {
+            uint32_t line = current_.line;
+            OpKind op = check(TokenKind::MINUS) ? OpKind::NEG : OpKind::NOT;
+            advance();
+            NodeId operand = parseUnary();
+            NodeId node = makeNode(NodeKind::UNARY, line);
+            AstNode& n = arena_.node(node);
+            n.op = op;
+            n.a = operand;
+            return node;
+        }
+        return parsePostfix(parsePrimary());
+    }
+
+    NodeId Parser::parsePostfix(NodeId expr) {
+        for (;;) {
+            uint32_t line = current_.line;
+            if (check(TokenKind::LPAREN) && !current_.newlineBefore) {
+                advance();
+                NodeId call = makeNode(NodeKind::CALL, line);
+                size_t mark = scratch_.size();
+                parseArguments();
+                finishList(call, mark);
+                arena_.node(call).a = expr;
+                expr = call;
+            } else if (check(TokenKind::LBRACKET) && !current_.newlineBefore) {
+                advance();
+                NodeId index = parseExpression();
+                expect(TokenKind::RBRACKET, "al cerrar el índice");
+                NodeId node = makeNode(NodeKind::INDEX, line);
+                AstNode& n = arena_.node(node);
+                n.a = expr;
+                n.b = index;
+                expr = node;
+            } else if (check(TokenKind::DOT)) {
+                advance();
+                NodeId node = makeNode(NodeKind::MEMBER, line);
+                StrId name = internCurrent();
+                AstNode& n = arena_.node(node);
+                n.a = expr;
+                n.v.str = name;
+                expr = node;
+            } else {
+                return expr;
+            }
+        }
+    }
+
+    // Argumentos de llamada hasta ')' (ya consumido '('), acumulados en scratch_
+    void Parser::parseArguments() {
+        if (match(TokenKind::RPAREN)) return;
+        do {
+            NodeId arg = parseExpression();
+            scratch_.push_back(arg);
+        } while (match(TokenKind::COMMA));
+        expect(TokenKind::RPAREN, "al final de los argumentos");
+    }
+
+    NodeId Parser::parsePrimary() {
+        uint32_t line = current_.line;
+        NodeId node;
+        switch (current_.kind) {
+            case TokenKind::INT_LIT:
+                node = makeNode(NodeKind::INT_LIT, line);
+                arena_.node(node).v.i = current_.intValue;
+                advance();
+                return node;
+            case TokenKind::FLOAT_LIT:
+                node = makeNode(NodeKind::FLOAT_LIT, line);
+                arena_.node(node).v.f = current_.floatValue;
+                advance();
+                return node;
+            case TokenKind::STRING_LIT: {
+                node = makeNode(NodeKind::STRING_LIT, line);
+                StrId str = decodeString(current_);
+                arena_.node(node).v.str = str;
+                advance();
+                return node;
+            }
+            case TokenKind::KW_VERDADERO:
+            case TokenKind::KW_FALSO:
+                node = makeNode(NodeKind::BOOL_LIT, line);
+                arena_.node(node).v.i = check(TokenKind::KW_VERDADERO) ? 1 : 0;
+                advance();
+                return node;
+            case TokenKind::KW_NULO:
+                advance();
+                return makeNode(NodeKind::NULL_LIT, line);
+            case TokenKind::IDENT: {
+                node = makeNode(NodeKind::IDENT, line);
+                StrId name = internCurrent();
+                arena_.node(node).v.str = name;
+                return node;
+            }
+            case TokenKind::LPAREN: {
+                advance();
+                NodeId inner = parseExpression();
+                expect(TokenKind::RPAREN, "al cerrar el paréntesis");
+                return inner;
+            }
+            case TokenKind::LBRACKET:
+                return parseArrayLiteral();
+            case TokenKind::LBRACE:
+                return parseMapLiteral();
+            case TokenKind::KW_SI:
+                return parseCondExpr();
+            default:
+                error("expresión inesperada: " + describeCurrent());
+        }
+    }
+
+    NodeId Parser::parseArrayLiteral() {
+        NodeId node = makeNode(NodeKind::ARRAY_LIT, current_.line);
+        advance();  // '['
+        size_t mark = scratch_.size();
+        if (!check(TokenKind::RBRACKET)) {
+            do {
+                if (check(TokenKind::RBRACKET)) break;  // coma final
+                NodeId element = parseExpression();
+                scratch_.push_back(element);
+            } while (match(TokenKind::COMMA));
+        }
+        expect(TokenKind::RBRACKET, "al cerrar el arreglo");
+        return finishList(node, mark);
+    }
+
+    NodeId Parser::parseMapLiteral() {
+        NodeId node = makeNode(NodeKind::MAP_LIT, current_.line);
+        advance();  // '{'
+        size_t mark = scratch_.size();
+        if (!check(TokenKind::RBRACE)) {
+            do {
+                if (check(TokenKind::RBRACE)) break;  // coma final
+                NodeId key = parseBinary(1);
+                // Una clave identificador se interpreta como cadena: {nombre: 1}
+                if (arena_.kind(key) == NodeKind::IDENT) {
+                    arena_.node(key).kind = NodeKind::STRING_LIT;
+                }
+                expect(TokenKind::COLON, "entre clave y valor");
+                NodeId value = parseExpression();
+                scratch_.push_back(key);
+                scratch_.push_back(value);
+            } while (match(TokenKind::COMMA));
+        }
+        expect(TokenKind::RBRACE, "al cerrar el mapa");
+        return finishList(node, mark);
+    }
+
+    // Expresión condicional: SI cond ENTONCES a SINO b
+    NodeId Parser::parseCondExpr() {
+        uint32_t line = current_.line;
+        advance();  // SI
+        NodeId node = makeNode(NodeKind::COND_EXPR, line);
+        NodeId cond = parseBinary(1);
+        expect(TokenKind::KW_ENTONCES, "en la expresión condicional");
+        NodeId then = parseBinary(1);
+        expect(TokenKind::KW_SINO, "en la expresión condicional");
+        NodeId otherwise = parseBinary(1);
+        AstNode& n = arena_.node(node);
+        n.a = cond;
+        n.b = then;
+        n.d = otherwise;
+        return node;
+    }
+
+    NodeId parseSource(std::string_view source, AstArena& arena) {
+        Parser parser(source, arena);
+        return parser.parseProgram();
+    }
+
+} // namespace mc_core
@@ -0,0 +1,88 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include "ast.h"
+#include "lexer.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mc_core {
+
+    /**
+     * Analizador sintáctico descendente recursivo de MC++.
+     *
+     * Produce un AST en una AstArena. Las sentencias se separan por saltos de línea
+     * (el punto y coma es opcional) y las expresiones se analizan por precedencia.
+     */
+    class Parser {
+    public:
+        Parser(std::string_view source, AstArena& arena);
+
+        // Analiza el archivo completo y devuelve el nodo PROGRAM
+        NodeId parseProgram();
+
+    private:
+        Lexer lexer_;
+        AstArena& arena_;
+        Token current_;
+        // Pila de trabajo compartida para acumular hijos sin asignaciones por lista
+        std::vector<NodeId> scratch_;
+
+        // Gestión de tokens
+        void advance();
+        bool check(TokenKind kind) const { return current_.kind == kind; }
+        bool match(TokenKind kind);
+        Token expect(TokenKind kind, const char* context);
+        [[noreturn]] void error(const std::string& message) const;
+        void skipSeparators();
+        bool atStatementEnd() const;
+        std::string describeCurrent() const;
+
+        // Construcción de nodos
+        NodeId makeNode(NodeKind kind, uint32_t line);
+        NodeId finishList(NodeId id, size_t mark);
+        StrId internCurrent();
+        StrId decodeString(const Token& token);
+
+        // Declaraciones
+        NodeId parseTopLevel();
+        NodeId parseFunction(uint16_t flags);
+        void parseParams();
+        NodeId parseType();
+        NodeId parseVarDecl(bool isConst);
+        NodeId parseStruct();
+        NodeId parseClass();
+        NodeId parseConstructor();
+        NodeId parseImport();
+        NodeId parseModule();
+
+        // Sentencias
+        NodeId parseStatement();
+        NodeId parseBlock();
+        NodeId parseIf();
+        NodeId parseWhile();
+        NodeId parseFor();
+        NodeId parseReductions(uint32_t line);
+        NodeId parseReturn();
+        NodeId parseSwitch();
+
+        // Expresiones
+        NodeId parseExpression();
+        NodeId parseAssignment();
+        NodeId parseBinary(int minPrecedence);
+        NodeId parseUnary();
+        NodeId parsePostfix(NodeId expr);
+        NodeId parsePrimary();
+        NodeId parseArrayLiteral();
+        NodeId parseMapLiteral();
+        NodeId parseCondExpr();
+        void parseArguments();
+    };
+
+    // Utilidad: analiza un archivo fuente completo en la arena dada
+    NodeId parseSource(std::string_view source, AstArena& arena);
+
+} // namespace mc_core
+
+#endif // PARSER_H
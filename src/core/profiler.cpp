@@ -0,0 +1,162 @@
+#include "profiler.h"
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <sys/time.h>
+#include <time.h>
+
+namespace mc_core {
+
+    std::atomic<uint32_t> Profiler::ticks_{0};
+    std::atomic<Profiler*> Profiler::active_{nullptr};
+
+    namespace {
+
+        struct sigaction previousAction;
+
+        double processCpuMs() {
+            timespec now{};
+            clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+            return static_cast<double>(now.tv_sec) * 1e3 + static_cast<double>(now.tv_nsec) / 1e6;
+        }
+
+        // Etiqueta "FUNC:línea" de la instrucción `at` de `proto`
+        void appendFrame(std::string& key, const FunctionProto* proto, const Instr* at) {
+            if (!key.empty()) key += ';';
+            key += proto->name;
+            size_t index = static_cast<size_t>(at - proto->codeBegin());
+            if (index < proto->codeSize()) {
+                key += ':';
+                key += std::to_string(proto->lineAt(index));
+            }
+        }
+
+        // Marcos de una pila colapsada
+        std::vector<std::string> splitStack(const std::string& stack) {
+            std::vector<std::string> frames;
+            size_t start = 0;
+            for (size_t end; (end = stack.find(';', start)) != std::string::npos; start = end + 1) {
+                frames.push_back(stack.substr(start, end - start));
+            }
+            frames.push_back(stack.substr(start));
+            return frames;
+        }
+
+    } // namespace
+
+    Profiler::Profiler(int intervalUs) : intervalUs_(intervalUs) {
+        if (intervalUs <= 0) throw std::invalid_argument("intervalo de muestreo no válido");
+    }
+
+    Profiler::~Profiler() {
+        stop();
+    }
+
+    void Profiler::onSignal(int) {
+        ticks_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Profiler::start() {
+        if (running_) return;
+        Profiler* expected = nullptr;
+        if (!active_.compare_exchange_strong(expected, this)) {
+            throw std::runtime_error("ya hay un perfilador activo");
+        }
+        ticks_.store(0, std::memory_order_relaxed);
+        struct sigaction action {};
+        action.sa_handler = &Profiler::onSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, &previousAction);
+
+        itimerval timer{};
+        timer.it_interval.tv_sec = intervalUs_ / 1000000;
+        timer.it_interval.tv_usec = intervalUs_ % 1000000;
+        timer.it_value = timer.it_interval;
+        cpuStart_ = processCpuMs();
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        running_ = true;
+    }
+
+    void Profiler::stop() {
+        if (!running_) return;
+        itimerval timer{};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        cpuMs_ += processCpuMs() - cpuStart_;
+        sigaction(SIGPROF, &previousAction, nullptr);
+        ticks_.store(0, std::memory_order_relaxed);
+        active_.store(nullptr);
+        running_ = false;
+    }
+
+    void Profiler::sample(const std::vector<CallFrame>& frames, const Instr* current, const std::string* native) {
+        uint32_t ticks = ticks_.exchange(0, std::memory_order_relaxed);
+        if (ticks == 0) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        scratch_.clear();
+        for (size_t i = 0; i < frames.size(); ++i) {
+            // Los marcos de abajo guardan la instrucción siguiente a su llamada
+            const Instr* at = i + 1 < frames.size() ? frames[i].pc - 1 : current;
+            appendFrame(scratch_, frames[i].proto, at);
+        }
+        if (native != nullptr) {
+            if (!scratch_.empty()) scratch_ += ';';
+            scratch_ += *native;
+        }
+        stacks_[scratch_] += ticks;
+        samples_ += ticks;
+    }
+
+    uint64_t Profiler::sampleCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return samples_;
+    }
+
+    double Profiler::cpuMilliseconds() const {
+        return running_ ? cpuMs_ + processCpuMs() - cpuStart_ : cpuMs_;
+    }
+
+    void Profiler::writeFolded(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, uint64_t> sorted(stacks_.begin(), stacks_.end());
+        for (const auto& [stack, count] : sorted) out << stack << ' ' << count << '\n';
+    }
+
+    void Profiler::writeSummary(std::ostream& out, size_t top) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Propias: la hoja de cada pila; totales: cada marco distinto de la pila, una
+        // sola vez aunque sea recursiva
+        std::map<std::string, std::pair<uint64_t, uint64_t>> lines;
+        for (const auto& [stack, count] : stacks_) {
+            std::vector<std::string> frames = splitStack(stack);
+            lines[frames.back()].first += count;
+            for (const std::string& frame : std::set<std::string>(frames.begin(), frames.end())) {
+                lines[frame].second += count;
+            }
+        }
+        std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>> ranked(lines.begin(), lines.end());
+        std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+            return a.second.first != b.second.first ? a.second.first > b.second.first
+                                                    : a.second.second > b.second.second;
+        });
+
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << std::fixed << std::setprecision(1);
+        out << "Perfil: " << samples_ << " muestras en " << cpuMilliseconds() << " ms de CPU\n";
+        auto percent = [&](uint64_t count) { return 100.0 * static_cast<double>(count) / static_cast<double>(samples_); };
+        if (samples_ > 0) out << "  propio    total  función:línea\n";
+        for (size_t i = 0; i < ranked.size() && i < top; ++i) {
+            const auto& [frame, counts] = ranked[i];
+            if (counts.first == 0) break;
+            out << std::setw(7) << percent(counts.first) << "%  " << std::setw(6) << percent(counts.second) << "%  "
+                << frame << '\n';
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+} // namespace mc_core
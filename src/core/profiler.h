@@ -0,0 +1,79 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "vm.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mc_core {
+
+    /**
+     * Perfilador por muestreo de `mc++ interpret --profile=salida.folded`.
+     *
+     * Un temporizador ITIMER_PROF envía SIGPROF cada `intervalUs` microsegundos de CPU
+     * del proceso; el manejador sólo cuenta el tick. El VM, en modo de despacho
+     * PROFILING, comprueba el contador antes de cada instrucción y al volver de cada
+     * nativa, y atribuye los ticks pendientes a su pila de llamadas MC++: cada marco
+     * como "FUNC:línea" (la de la instrucción en curso o la de la llamada) y, si la
+     * muestra se toma al volver de una nativa, ésta como hoja. Las esperas de ESPERAR
+     * no consumen CPU y no aparecen.
+     *
+     * El resultado es el formato de pilas colapsadas de flamegraph.pl / speedscope
+     * ("<script>:3;suma:12 57") y un resumen de las líneas con más muestras.
+     */
+    class Profiler {
+    public:
+        static constexpr int kDefaultIntervalUs = 1000;
+
+        explicit Profiler(int intervalUs = kDefaultIntervalUs);
+        ~Profiler();
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        // Arma y desarma el temporizador; sólo puede haber un perfilador activo a la vez
+        void start();
+        void stop();
+
+        // Hay ticks de SIGPROF sin atribuir
+        static bool pending() { return ticks_.load(std::memory_order_relaxed) != 0; }
+
+        // Atribuye los ticks pendientes a `frames`; `current` es la instrucción en curso
+        // del último marco y `native`, si no es nulo, la nativa de la que se vuelve
+        void sample(const std::vector<CallFrame>& frames, const Instr* current, const std::string* native = nullptr);
+
+        uint64_t sampleCount() const;
+        int intervalUs() const { return intervalUs_; }
+        // CPU consumido por el proceso mientras el temporizador estuvo armado; el núcleo
+        // puede entregar SIGPROF con menos frecuencia que la pedida
+        double cpuMilliseconds() const;
+
+        // Una línea "marco;marco;... muestras" por pila distinta, ordenadas
+        void writeFolded(std::ostream& out) const;
+
+        // Las `top` líneas con más muestras propias, con su porcentaje propio y total
+        void writeSummary(std::ostream& out, size_t top = 10) const;
+
+    private:
+        static std::atomic<uint32_t> ticks_;
+        static std::atomic<Profiler*> active_;
+
+        int intervalUs_;
+        bool running_ = false;
+        double cpuStart_ = 0;
+        double cpuMs_ = 0;
+        mutable std::mutex mutex_;  // Los hilos de PARA PARALELO muestrean a la vez
+        std::unordered_map<std::string, uint64_t> stacks_;
+        uint64_t samples_ = 0;
+        std::string scratch_;
+
+        static void onSignal(int);
+    };
+
+} // namespace mc_core
+
+#endif // PROFILER_H
@@ -0,0 +1,97 @@
+#include "repl.h"
+#include "builtins.h"
+#include "lexer.h"
+#include "optimizer.h"
+#include "output.h"
+#include "parser.h"
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+
+namespace mc_core {
+
+    ReplSession::ReplSession(const std::string& directory)
+        // El nombre del "programa" no termina en .mc: ningún IMPORTAR lo confunde con un módulo
+        : modules_(vm_, (std::filesystem::path(directory) / "<repl>").string()), compiler_(vm_) {
+        registerBuiltins(vm_);
+    }
+
+    std::string ReplSession::eval(const std::string& source) {
+        arenas_.push_back(std::make_unique<AstArena>());
+        AstArena& arena = *arenas_.back();
+        NodeId program = parseSource(source, arena);
+
+        // Los módulos nuevos se inicializan ya, aunque después la entrada no compile
+        size_t first = vm_.protos().size();
+        modules_.load(arena, program);
+        optimizeProgram(vm_, kDefaultOptimizationLevel, first);
+        for (FunctionProto* init : vm_.takeModuleInits()) vm_.run(init);
+
+        first = vm_.protos().size();
+        FunctionProto* script = compiler_.compile(arena, program);
+        optimizeProgram(vm_, kDefaultOptimizationLevel, first);
+        Value result;
+        try {
+            result = vm_.run(script);
+        } catch (...) {
+            OutputBuffer::flushAll();
+            throw;
+        }
+        OutputBuffer::flushAll();
+        return result.isNil() ? "" : valueToString(result);
+    }
+
+    bool ReplSession::isComplete(const std::string& source) {
+        int depth = 0;
+        try {
+            Lexer lexer(source);
+            for (Token token = lexer.next(); token.kind != TokenKind::END; token = lexer.next()) {
+                switch (token.kind) {
+                    case TokenKind::LBRACE:
+                    case TokenKind::LPAREN:
+                    case TokenKind::LBRACKET: ++depth; break;
+                    case TokenKind::RBRACE:
+                    case TokenKind::RPAREN:
+                    case TokenKind::RBRACKET: --depth; break;
+                    default: break;
+                }
+            }
+        } catch (const SyntaxError&) {
+            // El error se informa al evaluar la entrada
+            return true;
+        }
+        return depth <= 0;
+    }
+
+    void ReplSession::run(std::istream& in, std::ostream& out, bool prompt) {
+        // Los mismos ajustes de entorno que el modo interpret
+        const char* threads = std::getenv("MCPP_THREADS");
+        if (threads != nullptr && std::atoi(threads) > 0) vm_.setThreadCount(static_cast<size_t>(std::atoi(threads)));
+        const char* jit = std::getenv("MCPP_JIT");
+        vm_.setJitEnabled(!(jit != nullptr && std::string(jit) == "0"));
+
+        std::string pending;
+        std::string line;
+        while (true) {
+            if (prompt) out << (pending.empty() ? "mc> " : "... ") << std::flush;
+            if (!std::getline(in, line)) break;
+            if (pending.empty() && line == ":salir") break;
+            pending += line;
+            pending += '\n';
+            if (!isComplete(pending)) continue;
+
+            std::string source;
+            source.swap(pending);
+            if (source.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+            try {
+                std::string shown = eval(source);
+                if (!shown.empty()) out << shown << std::endl;
+            } catch (const std::exception& e) {
+                out << "Error: " << e.what() << std::endl;
+            }
+        }
+        if (prompt) out << std::endl;
+    }
+
+} // namespace mc_core
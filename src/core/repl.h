@@ -0,0 +1,59 @@
+#ifndef REPL_H
+#define REPL_H
+
+#include "ast.h"
+#include "codegen.h"
+#include "module_loader.h"
+#include "vm.h"
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mc_core {
+
+    /**
+     * Sesión interactiva de MC++ (mc++ repl).
+     *
+     * Un único VM vive toda la sesión. Cada entrada se analiza y se compila con una
+     * CompilerSession contra las globales, clases y MODULO de las anteriores. Después
+     * se optimizan sólo sus prototipos nuevos y se ejecuta. Los IMPORTAR de archivos .mc
+     * pasan por el ModuleLoader de la sesión: un módulo se compila e inicializa una sola
+     * vez y su AST sale de la caché del proceso. Así, evaluar una línea cuesta lo que
+     * cuesta compilar esa línea, no el programa entero.
+     *
+     * Un error de sintaxis, de compilación o de ejecución sólo descarta su entrada; lo
+     * que ya se había ejecutado (globales, módulos) se conserva. Las corrutinas de LANZAR
+     * avanzan cuando una entrada espera (ESPERAR), no entre entradas.
+     */
+    class ReplSession {
+    public:
+        // directory: donde se buscan los IMPORTAR, además de MCPP_PATH
+        explicit ReplSession(const std::string& directory = ".");
+
+        /**
+         * Ejecuta una entrada completa (una o más líneas). Devuelve el valor de la
+         * expresión final como texto, o "" si la entrada no termina en una expresión o
+         * su valor es NULO.
+         * @throw SyntaxError, CompileError, RuntimeError, std::runtime_error (módulos)
+         */
+        std::string eval(const std::string& source);
+
+        // Falso si quedan llaves, paréntesis o corchetes abiertos: la entrada sigue en otra línea
+        static bool isComplete(const std::string& source);
+
+        // Lee entradas de `in` hasta el final o ":salir"; con prompt muestra "mc> " / "... "
+        void run(std::istream& in, std::ostream& out, bool prompt);
+
+        VM& vm() { return vm_; }
+
+    private:
+        VM vm_;
+        ModuleLoader modules_;
+        CompilerSession compiler_;
+        std::vector<std::unique_ptr<AstArena>> arenas_;  // La sesión guarda vistas de sus nombres
+    };
+
+} // namespace mc_core
+
+#endif // REPL_H
@@ -0,0 +1,69 @@
+#include "scheduler.h"
+#include "output.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace mc_core {
+
+    void TimerWheel::schedule(uint32_t id, uint64_t tick) {
+        tick = std::max(tick, current_ + 1);
+        slots_[tick & (kSlots - 1)].push_back(Timer{tick, id});
+        ++count_;
+    }
+
+    void TimerWheel::advance(uint64_t tick, std::vector<uint32_t>& expired) {
+        if (tick <= current_) return;
+        uint64_t steps = std::min<uint64_t>(tick - current_, kSlots);
+        for (uint64_t step = 1; step <= steps && count_ > 0; ++step) {
+            std::vector<Timer>& slot = slots_[(current_ + step) & (kSlots - 1)];
+            // Los de vueltas posteriores se quedan en la ranura, en su orden
+            auto kept = std::stable_partition(slot.begin(), slot.end(),
+                                              [tick](const Timer& timer) { return timer.tick > tick; });
+            for (auto it = kept; it != slot.end(); ++it) expired.push_back(it->id);
+            count_ -= static_cast<size_t>(slot.end() - kept);
+            slot.erase(kept, slot.end());
+        }
+        current_ = tick;
+    }
+
+    uint64_t TimerWheel::nextTick() const {
+        for (uint64_t step = 1; step <= kSlots; ++step) {
+            if (!slots_[(current_ + step) & (kSlots - 1)].empty()) return current_ + step;
+        }
+        return current_ + kSlots;
+    }
+
+    Scheduler::Scheduler() : origin_(std::chrono::steady_clock::now()) {}
+
+    double Scheduler::now() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin_).count();
+    }
+
+    void Scheduler::sleepUntil(uint32_t id, double deadline) {
+        timers_.schedule(id, static_cast<uint64_t>(std::ceil(std::max(deadline, 0.0))));
+    }
+
+    void Scheduler::pollTimers() {
+        if (timers_.empty()) return;
+        timers_.advance(static_cast<uint64_t>(now()), expired_);
+        for (uint32_t id : expired_) ready_.push_back(id);
+        expired_.clear();
+    }
+
+    void Scheduler::waitForTimers(double limit) {
+        double until = timers_.empty() ? limit : std::min(limit, static_cast<double>(timers_.nextTick()));
+        double remaining = until - now();
+        if (remaining <= 0) return;
+        // El hilo va a quedar ocioso: buen momento para entregar la salida pendiente
+        OutputBuffer::flushAll();
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(remaining));
+    }
+
+    uint32_t Scheduler::nextReady() {
+        uint32_t id = ready_.front();
+        ready_.pop_front();
+        return id;
+    }
+
+} // namespace mc_core
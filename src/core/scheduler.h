@@ -0,0 +1,82 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace mc_core {
+
+    /**
+     * Rueda de temporizadores con resolución de 1 ms (esquema "hashed timing wheel").
+     *
+     * Cada temporizador cae en la ranura tick % kSlots; los que vencen en una vuelta
+     * posterior esperan en la misma ranura hasta su tick. Programar es O(1) y avanzar
+     * visita sólo las ranuras de los ticks transcurridos (como mucho una vuelta).
+     */
+    class TimerWheel {
+    public:
+        static constexpr size_t kSlots = 1024;
+
+        // Programa `id` para el tick indicado; un tick ya pasado vence en el siguiente avance
+        void schedule(uint32_t id, uint64_t tick);
+
+        // Avanza hasta `tick` y añade a `expired` los identificadores vencidos, por orden
+        void advance(uint64_t tick, std::vector<uint32_t>& expired);
+
+        // Primer tick con una ranura ocupada (el temporizador puede ser de una vuelta posterior)
+        uint64_t nextTick() const;
+
+        uint64_t currentTick() const { return current_; }
+        size_t size() const { return count_; }
+        bool empty() const { return count_ == 0; }
+
+    private:
+        struct Timer {
+            uint64_t tick;
+            uint32_t id;
+        };
+
+        std::vector<std::vector<Timer>> slots_ = std::vector<std::vector<Timer>>(kSlots);
+        uint64_t current_ = 0;
+        size_t count_ = 0;
+    };
+
+    /**
+     * Planificador cooperativo de corrutinas: cola de listas para ejecutar y rueda de
+     * temporizadores para las dormidas. Sólo maneja identificadores; el VM guarda el
+     * estado de cada corrutina y decide cuándo reanudarla.
+     */
+    class Scheduler {
+    public:
+        Scheduler();
+
+        // Milisegundos transcurridos desde la creación del planificador
+        double now() const;
+
+        void makeReady(uint32_t id) { ready_.push_back(id); }
+        // Duerme `id` hasta el instante `deadline` (en milisegundos de now())
+        void sleepUntil(uint32_t id, double deadline);
+
+        // Mueve a la cola de listas las corrutinas cuyo plazo ya venció
+        void pollTimers();
+        // Bloquea el hilo hasta el próximo temporizador, sin pasar de `limit`
+        void waitForTimers(double limit);
+
+        bool hasReady() const { return !ready_.empty(); }
+        uint32_t nextReady();
+        bool hasTimers() const { return !timers_.empty(); }
+        size_t sleeping() const { return timers_.size(); }
+
+    private:
+        std::chrono::steady_clock::time_point origin_;
+        std::deque<uint32_t> ready_;
+        TimerWheel timers_;
+        std::vector<uint32_t> expired_;
+    };
+
+} // namespace mc_core
+
+#endif // SCHEDULER_H
@@ -0,0 +1,18 @@
+#include "source_file.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace mc_core {
+
+    std::string readSourceFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Error: No se pudo abrir el archivo fuente: " + path);
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+} // namespace mc_core
@@ -0,0 +1,18 @@
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include <string>
+
+namespace mc_core {
+
+    /**
+     * Lee un archivo fuente de MC++ completo en memoria.
+     * @param path Ruta del archivo.
+     * @return Contenido del archivo.
+     * @throw std::runtime_error Si el archivo no puede abrirse.
+     */
+    std::string readSourceFile(const std::string& path);
+
+} // namespace mc_core
+
+#endif // SOURCE_FILE_H
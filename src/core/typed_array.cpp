@@ -0,0 +1,250 @@
+#include "typed_array.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define MC_TYPED_X86 1
+#endif
+
+namespace mc_core {
+
+    namespace {
+
+        // Los elementos de un ARRAY<INT> son INT de MC++ (|x| <= 2^50): la suma de un
+        // bloque de kSumChunk elementos no puede desbordar un int64_t
+        constexpr size_t kSumChunk = 4096;
+
+        // Núcleo en uso (TypedKernel); -1 hasta la primera llamada
+        std::atomic<int> activeKernel{-1};
+
+        int64_t chunkSumScalar(const int64_t* data, size_t count) {
+            int64_t sum = 0;
+            for (size_t i = 0; i < count; ++i) sum += data[i];
+            return sum;
+        }
+
+        double sumFloatsScalar(const double* data, size_t count) {
+            double sum = 0.0;
+            for (size_t i = 0; i < count; ++i) sum += data[i];
+            return sum;
+        }
+
+        // Cuatro acumuladores independientes para no encadenar las comparaciones
+        template <bool Max>
+        int64_t extremeIntsScalar(const int64_t* data, size_t count) {
+            size_t i = 0;
+            int64_t result = data[0];
+            if (count >= 4) {
+                int64_t acc[4] = {data[0], data[1], data[2], data[3]};
+                for (i = 4; i + 4 <= count; i += 4) {
+                    for (int k = 0; k < 4; ++k) {
+                        acc[k] = Max ? std::max(acc[k], data[i + k]) : std::min(acc[k], data[i + k]);
+                    }
+                }
+                for (int64_t lane : acc) result = Max ? std::max(result, lane) : std::min(result, lane);
+            }
+            for (; i < count; ++i) result = Max ? std::max(result, data[i]) : std::min(result, data[i]);
+            return result;
+        }
+
+        template <bool Max>
+        double extremeFloatsScalar(const double* data, size_t count) {
+            double result = data[0];
+            for (size_t i = 1; i < count; ++i) result = Max ? std::max(result, data[i]) : std::min(result, data[i]);
+            return result;
+        }
+
+#ifdef MC_TYPED_X86
+        // SSE2 forma parte de x86-64: estos núcleos no necesitan atributo
+        int64_t chunkSumSse2(const int64_t* data, size_t count) {
+            size_t i = 0;
+            __m128i acc = _mm_setzero_si128();
+            for (; i + 2 <= count; i += 2) {
+                acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+            }
+            alignas(16) int64_t lanes[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+            int64_t sum = lanes[0] + lanes[1];
+            for (; i < count; ++i) sum += data[i];
+            return sum;
+        }
+
+        double sumFloatsSse2(const double* data, size_t count) {
+            size_t i = 0;
+            __m128d acc = _mm_setzero_pd();
+            for (; i + 2 <= count; i += 2) acc = _mm_add_pd(acc, _mm_loadu_pd(data + i));
+            alignas(16) double lanes[2];
+            _mm_store_pd(lanes, acc);
+            double sum = lanes[0] + lanes[1];
+            for (; i < count; ++i) sum += data[i];
+            return sum;
+        }
+
+        template <bool Max>
+        double extremeFloatsSse2(const double* data, size_t count) {
+            size_t i = 0;
+            double result = data[0];
+            if (count >= 2) {
+                __m128d acc = _mm_loadu_pd(data);
+                for (i = 2; i + 2 <= count; i += 2) {
+                    __m128d x = _mm_loadu_pd(data + i);
+                    acc = Max ? _mm_max_pd(x, acc) : _mm_min_pd(x, acc);
+                }
+                alignas(16) double lanes[2];
+                _mm_store_pd(lanes, acc);
+                for (double lane : lanes) result = Max ? std::max(result, lane) : std::min(result, lane);
+            }
+            for (; i < count; ++i) result = Max ? std::max(result, data[i]) : std::min(result, data[i]);
+            return result;
+        }
+
+        // AVX2 se compila aparte con target("avx2") y sólo se usa si la CPU lo admite
+        __attribute__((target("avx2"))) int64_t chunkSumAvx2(const int64_t* data, size_t count) {
+            size_t i = 0;
+            __m256i acc = _mm256_setzero_si256();
+            for (; i + 4 <= count; i += 4) {
+                acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+            }
+            alignas(32) int64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+            int64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            for (; i < count; ++i) sum += data[i];
+            return sum;
+        }
+
+        __attribute__((target("avx2"))) double sumFloatsAvx2(const double* data, size_t count) {
+            size_t i = 0;
+            __m256d acc = _mm256_setzero_pd();
+            for (; i + 4 <= count; i += 4) acc = _mm256_add_pd(acc, _mm256_loadu_pd(data + i));
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, acc);
+            double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; i < count; ++i) sum += data[i];
+            return sum;
+        }
+
+        template <bool Max>
+        __attribute__((target("avx2"))) int64_t extremeIntsAvx2(const int64_t* data, size_t count) {
+            size_t i = 0;
+            int64_t result = data[0];
+            if (count >= 4) {
+                __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+                for (i = 4; i + 4 <= count; i += 4) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    __m256i greater = _mm256_cmpgt_epi64(x, acc);
+                    acc = Max ? _mm256_blendv_epi8(acc, x, greater) : _mm256_blendv_epi8(x, acc, greater);
+                }
+                alignas(32) int64_t lanes[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+                for (int64_t lane : lanes) result = Max ? std::max(result, lane) : std::min(result, lane);
+            }
+            for (; i < count; ++i) result = Max ? std::max(result, data[i]) : std::min(result, data[i]);
+            return result;
+        }
+
+        template <bool Max>
+        __attribute__((target("avx2"))) double extremeFloatsAvx2(const double* data, size_t count) {
+            size_t i = 0;
+            double result = data[0];
+            if (count >= 4) {
+                __m256d acc = _mm256_loadu_pd(data);
+                for (i = 4; i + 4 <= count; i += 4) {
+                    __m256d x = _mm256_loadu_pd(data + i);
+                    acc = Max ? _mm256_max_pd(x, acc) : _mm256_min_pd(x, acc);
+                }
+                alignas(32) double lanes[4];
+                _mm256_store_pd(lanes, acc);
+                for (double lane : lanes) result = Max ? std::max(result, lane) : std::min(result, lane);
+            }
+            for (; i < count; ++i) result = Max ? std::max(result, data[i]) : std::min(result, data[i]);
+            return result;
+        }
+#endif
+
+        int64_t chunkSum(const int64_t* data, size_t count) {
+            switch (typedKernel()) {
+#ifdef MC_TYPED_X86
+                case TypedKernel::AVX2: return chunkSumAvx2(data, count);
+                case TypedKernel::SSE2: return chunkSumSse2(data, count);
+#endif
+                default: return chunkSumScalar(data, count);
+            }
+        }
+
+        // SSE2 no compara enteros de 64 bits: el mínimo y el máximo de enteros usan el
+        // bucle escalar salvo con AVX2
+        template <bool Max>
+        int64_t extremeInts(const int64_t* data, size_t count) {
+#ifdef MC_TYPED_X86
+            if (typedKernel() == TypedKernel::AVX2) return extremeIntsAvx2<Max>(data, count);
+#endif
+            return extremeIntsScalar<Max>(data, count);
+        }
+
+        template <bool Max>
+        double extremeFloats(const double* data, size_t count) {
+            switch (typedKernel()) {
+#ifdef MC_TYPED_X86
+                case TypedKernel::AVX2: return extremeFloatsAvx2<Max>(data, count);
+                case TypedKernel::SSE2: return extremeFloatsSse2<Max>(data, count);
+#endif
+                default: return extremeFloatsScalar<Max>(data, count);
+            }
+        }
+
+    } // namespace
+
+    TypedKernel detectTypedKernel() {
+#ifdef MC_TYPED_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return TypedKernel::AVX2;
+        return TypedKernel::SSE2;
+#else
+        return TypedKernel::SCALAR;
+#endif
+    }
+
+    TypedKernel typedKernel() {
+        int current = activeKernel.load(std::memory_order_relaxed);
+        if (current < 0) {
+            current = static_cast<int>(detectTypedKernel());
+            activeKernel.store(current, std::memory_order_relaxed);
+        }
+        return static_cast<TypedKernel>(current);
+    }
+
+    void setTypedKernel(TypedKernel kernel) {
+        if (static_cast<int>(kernel) > static_cast<int>(detectTypedKernel())) {
+            throw std::invalid_argument("la CPU no admite el núcleo vectorial solicitado");
+        }
+        activeKernel.store(static_cast<int>(kernel), std::memory_order_relaxed);
+    }
+
+    bool sumInts(const int64_t* data, size_t count, int64_t& result) {
+        result = 0;
+        for (size_t i = 0; i < count; i += kSumChunk) {
+            if (__builtin_add_overflow(result, chunkSum(data + i, std::min(kSumChunk, count - i)), &result)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double sumFloats(const double* data, size_t count) {
+        switch (typedKernel()) {
+#ifdef MC_TYPED_X86
+            case TypedKernel::AVX2: return sumFloatsAvx2(data, count);
+            case TypedKernel::SSE2: return sumFloatsSse2(data, count);
+#endif
+            default: return sumFloatsScalar(data, count);
+        }
+    }
+
+    int64_t minInts(const int64_t* data, size_t count) { return extremeInts<false>(data, count); }
+    int64_t maxInts(const int64_t* data, size_t count) { return extremeInts<true>(data, count); }
+    double minFloats(const double* data, size_t count) { return extremeFloats<false>(data, count); }
+    double maxFloats(const double* data, size_t count) { return extremeFloats<true>(data, count); }
+
+} // namespace mc_core
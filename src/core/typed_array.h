@@ -0,0 +1,39 @@
+#ifndef TYPED_ARRAY_H
+#define TYPED_ARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mc_core {
+
+    /**
+     * Núcleos vectoriales sobre el almacenamiento contiguo de ARRAY<INT> y
+     * ARRAY<FLOAT> (SUMA, MINIMO, MAXIMO).
+     *
+     * El núcleo se elige una vez según la CPU (CPUID), sin depender de las opciones
+     * de compilación: con AVX2 se procesan 4 elementos por instrucción y con SSE2
+     * (siempre disponible en x86-64) 2, salvo el mínimo y el máximo de enteros, que
+     * SSE2 no sabe comparar en 64 bits. En otras plataformas se usa un bucle escalar
+     * que el compilador puede vectorizar por su cuenta. Mínimo y máximo exigen count > 0.
+     */
+    enum class TypedKernel { SCALAR, SSE2, AVX2 };
+
+    // El mejor núcleo que admite la CPU
+    TypedKernel detectTypedKernel();
+    // Núcleo en uso; por defecto, detectTypedKernel()
+    TypedKernel typedKernel();
+    // Fuerza un núcleo (pruebas y mediciones); std::invalid_argument si la CPU no lo admite
+    void setTypedKernel(TypedKernel kernel);
+
+    // Suma exacta; devuelve false si el resultado no cabe en int64_t
+    bool sumInts(const int64_t* data, size_t count, int64_t& result);
+    double sumFloats(const double* data, size_t count);
+
+    int64_t minInts(const int64_t* data, size_t count);
+    int64_t maxInts(const int64_t* data, size_t count);
+    double minFloats(const double* data, size_t count);
+    double maxFloats(const double* data, size_t count);
+
+} // namespace mc_core
+
+#endif // TYPED_ARRAY_H
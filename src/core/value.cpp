@@ -0,0 +1,174 @@
+#include "value.h"
+#include "object.h"
+#include "bytecode.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+namespace mc_core {
+
+    bool valuesEqual(Value a, Value b) {
+        if (a.isNumber() && b.isNumber()) {
+            if (a.isInt() && b.isInt()) return a.asInt() == b.asInt();
+            return a.asNumber() == b.asNumber();
+        }
+        if (a.type() != b.type()) return false;
+        switch (a.type()) {
+            case ValueType::NIL: return true;
+            case ValueType::BOOL: return a.asBool() == b.asBool();
+            case ValueType::OBJ:
+                if (a.asObj() == b.asObj()) return true;
+                return isString(a) && isString(b) && stringsEqual(asString(a), asString(b));
+            default: return false;
+        }
+    }
+
+    size_t hashValue(Value v) {
+        switch (v.type()) {
+            case ValueType::NIL: return 0;
+            case ValueType::BOOL: return v.asBool() ? 1 : 2;
+            case ValueType::INT: return std::hash<int64_t>()(v.asInt());
+            case ValueType::FLOAT: {
+                // Los FLOAT con valor entero deben coincidir con su INT equivalente
+                double f = v.asFloat();
+                if (std::floor(f) == f && std::fabs(f) < 9.2e18) {
+                    return std::hash<int64_t>()(static_cast<int64_t>(f));
+                }
+                return std::hash<double>()(f);
+            }
+            case ValueType::OBJ:
+                if (isString(v)) return asString(v)->hash();
+                return std::hash<const void*>()(v.asObj());
+        }
+        return 0;
+    }
+
+    namespace {
+
+        std::string formatFloat(double f) {
+            if (std::isnan(f)) return "NaN";
+            if (std::isinf(f)) return f > 0 ? "Infinito" : "-Infinito";
+            // Los dígitos más cortos que vuelven a dar f, en el formato de %.17g para
+            // todos los valores: notación científica sólo si el exponente es < -4 o >= 17
+            char buffer[64];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), f, std::chars_format::scientific);
+            *result.ptr = '\0';  // para atoi
+            int exponent = std::atoi(std::find(buffer, result.ptr, 'e') + 1);
+            if (exponent < -4 || exponent >= 17) return std::string(buffer, result.ptr);
+            result = std::to_chars(buffer, buffer + sizeof(buffer), f, std::chars_format::fixed);
+            std::string text(buffer, result.ptr);
+            // Un FLOAT siempre se muestra con parte decimal: 10.0 y no 10
+            if (text.find('.') == std::string::npos) {
+                text += ".0";
+            }
+            return text;
+        }
+
+        void appendValue(std::string& out, Value v, bool quoteStrings) {
+            if (!v.isObj()) {
+                out += valueToString(v);
+                return;
+            }
+            Obj* object = v.asObj();
+            switch (object->type) {
+                case ObjType::STRING:
+                    if (quoteStrings) {
+                        out += '"';
+                        out += asString(v)->view();
+                        out += '"';
+                    } else {
+                        out += asString(v)->view();
+                    }
+                    break;
+                case ObjType::ARRAY: {
+                    out += '[';
+                    const auto& items = asArray(v)->items;
+                    for (size_t i = 0; i < items.size(); ++i) {
+                        if (i > 0) out += ", ";
+                        appendValue(out, items[i], true);
+                    }
+                    out += ']';
+                    break;
+                }
+                case ObjType::TYPED_ARRAY: {
+                    out += '[';
+                    const ObjTypedArray* array = asTypedArray(v);
+                    for (size_t i = 0; i < array->size(); ++i) {
+                        if (i > 0) out += ", ";
+                        out += valueToString(array->get(i));
+                    }
+                    out += ']';
+                    break;
+                }
+                case ObjType::MAP: {
+                    out += '{';
+                    const auto& entries = asMap(v)->entries;
+                    for (size_t i = 0; i < entries.size(); ++i) {
+                        if (i > 0) out += ", ";
+                        appendValue(out, entries[i].first, true);
+                        out += ": ";
+                        appendValue(out, entries[i].second, true);
+                    }
+                    out += '}';
+                    break;
+                }
+                case ObjType::FUNCTION:
+                    out += "<función " + asFunction(v)->proto->name + ">";
+                    break;
+                case ObjType::NATIVE:
+                    out += "<nativa " + asNative(v)->name + ">";
+                    break;
+                case ObjType::CLASS:
+                    out += "<clase " + asClass(v)->name + ">";
+                    break;
+                case ObjType::INSTANCE:
+                    out += "<" + asInstance(v)->klass->name + ">";
+                    break;
+                case ObjType::MODULE:
+                    out += "<módulo " + asModule(v)->name + ">";
+                    break;
+            }
+        }
+
+    } // namespace
+
+    std::string valueToString(Value v) {
+        switch (v.type()) {
+            case ValueType::NIL: return "NULO";
+            case ValueType::BOOL: return v.asBool() ? "VERDADERO" : "FALSO";
+            case ValueType::INT: return std::to_string(v.asInt());
+            case ValueType::FLOAT: return formatFloat(v.asFloat());
+            case ValueType::OBJ: {
+                std::string out;
+                appendValue(out, v, false);
+                return out;
+            }
+        }
+        return "";
+    }
+
+    const char* typeName(Value v) {
+        switch (v.type()) {
+            case ValueType::NIL: return "NULO";
+            case ValueType::BOOL: return "BOOL";
+            case ValueType::INT: return "INT";
+            case ValueType::FLOAT: return "FLOAT";
+            case ValueType::OBJ: break;
+        }
+        switch (v.asObj()->type) {
+            case ObjType::STRING: return "STRING";
+            case ObjType::ARRAY:
+            case ObjType::TYPED_ARRAY: return "ARRAY";
+            case ObjType::MAP: return "MAP";
+            case ObjType::FUNCTION:
+            case ObjType::NATIVE: return "FUNC";
+            case ObjType::CLASS: return "CLASE";
+            case ObjType::INSTANCE: return "OBJETO";
+            case ObjType::MODULE: return "MODULO";
+        }
+        return "?";
+    }
+
+} // namespace mc_core
@@ -0,0 +1,134 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace mc_core {
+
+    struct Obj;
+
+    // Tipos de valor del runtime de MC++
+    enum class ValueType : uint8_t {
+        NIL,
+        BOOL,
+        INT,
+        FLOAT,
+        OBJ
+    };
+
+    /**
+     * Valor del runtime de MC++ en 8 bytes ("NaN-boxing").
+     *
+     * Un FLOAT se guarda tal cual como double IEEE-754. El resto de tipos se codifica
+     * en el espacio de NaN silenciosos, que ningún cálculo produce porque todo NaN se
+     * normaliza a kCanonicalNaN:
+     *
+     *   1111 1111 1111 1xxx ...   INT inmediato de 51 bits con signo
+     *   0111 1111 1111 1001 ...   NULO
+     *   0111 1111 1111 1010 ...   BOOL (bit 0 = valor)
+     *   0111 1111 1111 1011 ...   OBJ (puntero de 48 bits)
+     *
+     * Un INT fuera de [-2^50, 2^50) pasa a FLOAT, igual que un desbordamiento.
+     * Copiar un valor nunca asigna memoria.
+     */
+    class Value {
+    public:
+        static constexpr int64_t kIntMax = (int64_t(1) << 50) - 1;
+        static constexpr int64_t kIntMin = -(int64_t(1) << 50);
+
+        Value() : bits_(kNilBits) {}
+
+        static Value nil() { return Value(); }
+        static Value boolean(bool b) { return fromBits(kFalseBits | (b ? 1u : 0u)); }
+        static Value integer(int64_t i) {
+            if (!fitsInt(i)) return number(static_cast<double>(i));
+            return fromBits(kIntTag | (static_cast<uint64_t>(i) & kIntPayload));
+        }
+        static Value number(double f) {
+            if (f != f) return fromBits(kCanonicalNaN);
+            uint64_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            return fromBits(bits);
+        }
+        static Value object(Obj* o) { return fromBits(kObjTag | reinterpret_cast<uintptr_t>(o)); }
+
+        // true si el entero cabe en un INT inmediato
+        static bool fitsInt(int64_t i) { return i >= kIntMin && i <= kIntMax; }
+
+        ValueType type() const {
+            if (isFloat()) return ValueType::FLOAT;
+            if (isInt()) return ValueType::INT;
+            if (isObj()) return ValueType::OBJ;
+            return isBool() ? ValueType::BOOL : ValueType::NIL;
+        }
+        bool isNil() const { return bits_ == kNilBits; }
+        bool isBool() const { return (bits_ & ~uint64_t(1)) == kFalseBits; }
+        bool isInt() const { return (bits_ & kIntTag) == kIntTag; }
+        bool isFloat() const { return (bits_ & kQNaN) != kQNaN || bits_ == kCanonicalNaN; }
+        bool isNumber() const { return isInt() || isFloat(); }
+        bool isObj() const { return (bits_ & kTagMask) == kObjTag; }
+
+        bool asBool() const { return (bits_ & 1) != 0; }
+        int64_t asInt() const { return static_cast<int64_t>(bits_ << 13) >> 13; }
+        double asFloat() const {
+            double f;
+            std::memcpy(&f, &bits_, sizeof(f));
+            return f;
+        }
+        Obj* asObj() const { return reinterpret_cast<Obj*>(static_cast<uintptr_t>(bits_ & kPointerMask)); }
+
+        // Valor numérico como double (INT o FLOAT)
+        double asNumber() const { return isInt() ? static_cast<double>(asInt()) : asFloat(); }
+
+        // NULO y FALSO son falsos; todo lo demás es verdadero
+        bool isTruthy() const { return bits_ != kNilBits && bits_ != kFalseBits; }
+
+        // Representación binaria: dos valores con los mismos bits son idénticos
+        uint64_t bits() const { return bits_; }
+        static Value fromBits(uint64_t bits) {
+            Value v;
+            v.bits_ = bits;
+            return v;
+        }
+
+    private:
+        static constexpr uint64_t kQNaN = 0x7FF8000000000000ull;
+        static constexpr uint64_t kCanonicalNaN = kQNaN;
+        static constexpr uint64_t kTagMask = 0xFFFF000000000000ull;
+        static constexpr uint64_t kNilBits = 0x7FF9000000000000ull;
+        static constexpr uint64_t kFalseBits = 0x7FFA000000000000ull;
+        static constexpr uint64_t kObjTag = 0x7FFB000000000000ull;
+        static constexpr uint64_t kIntTag = 0xFFF8000000000000ull;
+        static constexpr uint64_t kIntPayload = 0x0007FFFFFFFFFFFFull;
+        static constexpr uint64_t kPointerMask = 0x0000FFFFFFFFFFFFull;
+
+        uint64_t bits_;
+    };
+
+    static_assert(sizeof(Value) == 8, "Value debe ocupar 8 bytes");
+
+    // Igualdad de valores: numérica entre INT/FLOAT y por contenido en cadenas
+    bool valuesEqual(Value a, Value b);
+
+    // Hash coherente con valuesEqual (para claves de MAP)
+    size_t hashValue(Value v);
+
+    // Representación textual usada por MOSTRAR y la concatenación de cadenas
+    std::string valueToString(Value v);
+
+    // Nombre del tipo para mensajes de error ("INT", "STRING", ...)
+    const char* typeName(Value v);
+
+    struct ValueHash {
+        size_t operator()(Value v) const { return hashValue(v); }
+    };
+
+    struct ValueEq {
+        bool operator()(Value a, Value b) const { return valuesEqual(a, b); }
+    };
+
+} // namespace mc_core
+
+#endif // VALUE_H
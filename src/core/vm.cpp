@@ -0,0 +1,937 @@
+#include "vm.h"
+#include "output.h"
+#include "jit.h"
+#include "profiler.h"
+#include "../utils/work_stealing_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <thread>
+
+namespace mc_core {
+
+    namespace {
+
+        constexpr size_t kInitialStackSlots = 1 << 14;
+        constexpr size_t kMaxStackSlots = 1 << 24;
+        constexpr size_t kMaxFrames = 200000;
+        // Pila inicial de una corrutina; crece como la principal si hace falta
+        constexpr size_t kCoroutineStackSlots = 64;
+        // Reparto de PARA PARALELO: hasta 256 trozos de al menos 16 iteraciones
+        constexpr uint64_t kMaxParallelChunks = 256;
+        constexpr uint64_t kMinChunkIterations = 16;
+
+        // Aritmética entera con detección de desbordamiento (el resultado pasa a FLOAT)
+        inline bool addOverflow(int64_t a, int64_t b, int64_t* result) {
+            return __builtin_add_overflow(a, b, result);
+        }
+
+        inline bool subOverflow(int64_t a, int64_t b, int64_t* result) {
+            return __builtin_sub_overflow(a, b, result);
+        }
+
+        inline bool mulOverflow(int64_t a, int64_t b, int64_t* result) {
+            return __builtin_mul_overflow(a, b, result);
+        }
+
+        const char* operatorSymbol(OpCode op) {
+            switch (op) {
+                case OpCode::ADD: return "+";
+                case OpCode::SUB: return "-";
+                case OpCode::MUL: return "*";
+                case OpCode::DIV: return "/";
+                case OpCode::MOD: return "%";
+                default: return "?";
+            }
+        }
+
+        void checkArguments(const FunctionProto* proto, uint32_t argc) {
+            uint32_t expected = proto->numParams + (proto->isMethod ? 1u : 0u);
+            if (argc != expected) {
+                uint32_t shown = proto->isMethod ? argc - 1 : argc;
+                throw RuntimeError(proto->name + " espera " + std::to_string(proto->numParams) +
+                                   " argumento(s) y recibió " + std::to_string(shown));
+            }
+        }
+
+        // Longitud en bytes del carácter UTF-8 que empieza en c
+        size_t utf8Length(unsigned char c) {
+            if (c < 0x80) return 1;
+            if ((c >> 5) == 0x6) return 2;
+            if ((c >> 4) == 0xE) return 3;
+            if ((c >> 3) == 0x1E) return 4;
+            return 1;
+        }
+
+    } // namespace
+
+    VM::VM() {
+        stack_.resize(kInitialStackSlots);
+        megamorphicCache_.resize(2 * kMegamorphicEntries);
+        frames_.reserve(64);
+        threadCount_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    VM::~VM() = default;
+
+    uint32_t VM::globalSlot(const std::string& name) {
+        auto it = globalIndex_.find(name);
+        if (it != globalIndex_.end()) return it->second;
+        if (globals_.size() > static_cast<size_t>(kMaxBx)) {
+            throw RuntimeError("demasiadas variables globales");
+        }
+        uint32_t slot = static_cast<uint32_t>(globals_.size());
+        globals_.push_back(Value::nil());
+        globalNames_.push_back(name);
+        globalIndex_.emplace(name, slot);
+        return slot;
+    }
+
+    void VM::truncateGlobals(size_t count) {
+        for (size_t slot = count; slot < globalNames_.size(); ++slot) globalIndex_.erase(globalNames_[slot]);
+        globals_.resize(count);
+        globalNames_.resize(count);
+        // syncWorkers copia los nombres cuando cambia su número: otros con el mismo número
+        // pasarían desapercibidos
+        for (const auto& worker : workers_) worker->globalNames_.clear();
+    }
+
+    int VM::findGlobal(const std::string& name) const {
+        auto it = globalIndex_.find(name);
+        return it == globalIndex_.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    Value VM::getGlobal(const std::string& name) const {
+        int slot = findGlobal(name);
+        return slot < 0 ? Value::nil() : globals_[static_cast<size_t>(slot)];
+    }
+
+    void VM::defineNative(const std::string& name, NativeFn fn, int arity) {
+        ObjNative* native = heap_.allocate<ObjNative>(fn, name, arity);
+        globals_[globalSlot(name)] = Value::object(native);
+    }
+
+    ObjModule* VM::defineModule(const std::string& name) {
+        ObjModule*& module = modules_[name];
+        if (module == nullptr) module = heap_.allocate<ObjModule>(name);
+        return module;
+    }
+
+    ObjModule* VM::findModule(const std::string& name) const {
+        auto it = modules_.find(name);
+        return it == modules_.end() ? nullptr : it->second;
+    }
+
+    bool VM::isSourceModule(const std::string& name) const {
+        for (const SourceModule& module : sourceModules_) {
+            if (module.name == name) return true;
+        }
+        return false;
+    }
+
+    std::vector<FunctionProto*> VM::takeModuleInits() {
+        std::vector<FunctionProto*> inits;
+        for (; initializedModules_ < sourceModules_.size(); ++initializedModules_) {
+            inits.push_back(sourceModules_[initializedModules_].init);
+        }
+        return inits;
+    }
+
+    void VM::defineMethod(ObjType type, const std::string& name, NativeFn fn, int arity) {
+        ObjNative* native = heap_.allocate<ObjNative>(fn, name, arity);
+        native->isMethod = true;
+        methods_[static_cast<size_t>(type)][name] = Value::object(native);
+    }
+
+    Value VM::findMethod(Value receiver, const std::string& name) const {
+        if (!receiver.isObj()) return Value::nil();
+        // Los ARRAY tipados comparten los métodos de ARRAY
+        size_t kind = static_cast<size_t>(isAnyArray(receiver) ? ObjType::ARRAY : receiver.asObj()->type);
+        if (kind >= 3) return Value::nil();
+        auto it = methods_[kind].find(name);
+        return it == methods_[kind].end() ? Value::nil() : it->second;
+    }
+
+    FunctionProto* VM::newProto(const std::string& name) {
+        protos_.push_back(std::make_unique<FunctionProto>());
+        protos_.back()->name = name;
+        return protos_.back().get();
+    }
+
+    Value VM::run(const FunctionProto* script) {
+        uint32_t slot = frames_.empty() ? 0 : frames_.back().base + frames_.back().proto->numRegs;
+        ensureStack(slot + 1);
+        stack_[slot] = Value::nil();
+        size_t depth = frames_.size();
+        pushFrame(script, slot + 1, slot, 0);
+        return execute(depth);
+    }
+
+    Value VM::call(Value callee, const std::vector<Value>& args) {
+        // El marco nuevo se coloca por encima de los registros del marco en curso
+        uint32_t slot = frames_.empty() ? 0 : frames_.back().base + frames_.back().proto->numRegs;
+        ensureStack(slot + args.size() + 2);
+        stack_[slot] = callee;
+        for (size_t i = 0; i < args.size(); ++i) {
+            stack_[slot + 1 + i] = args[i];
+        }
+        size_t depth = frames_.size();
+        // Mientras dure la llamada la corrutina en curso no puede suspenderse: la
+        // nativa que llamó sigue en la pila nativa
+        ++nestedCalls_;
+        try {
+            Value result = callValue(slot, static_cast<uint32_t>(args.size()), false) ? execute(depth) : stack_[slot];
+            --nestedCalls_;
+            return result;
+        } catch (...) {
+            --nestedCalls_;
+            throw;
+        }
+    }
+
+    uint32_t VM::spawn(Value callee, const std::vector<Value>& args) {
+        if (worker_) throw RuntimeError("LANZAR no se admite dentro de PARA PARALELO");
+        auto coroutine = std::make_unique<Coroutine>();
+        coroutine->stack.resize(std::max(kCoroutineStackSlots, args.size() + 2));
+        coroutine->stack[0] = callee;
+        std::copy(args.begin(), args.end(), coroutine->stack.begin() + 1);
+        coroutine->argc = static_cast<uint32_t>(args.size());
+        uint32_t id;
+        if (freeCoroutines_.empty()) {
+            id = static_cast<uint32_t>(coroutines_.size());
+            coroutines_.push_back(std::move(coroutine));
+        } else {
+            id = freeCoroutines_.back();
+            freeCoroutines_.pop_back();
+            coroutines_[id] = std::move(coroutine);
+        }
+        scheduler_.makeReady(id);
+        return id;
+    }
+
+    void VM::wait(double milliseconds) {
+        double deadline = scheduler_.now() + std::max(milliseconds, 0.0);
+        if (running_ != kNoCoroutine && nestedCalls_ == 0) {
+            if (milliseconds > 0) {
+                scheduler_.sleepUntil(running_, deadline);
+            } else {
+                scheduler_.makeReady(running_);
+            }
+            suspendRequested_ = true;
+            return;
+        }
+        runEventLoop(deadline);
+    }
+
+    void VM::runCoroutines() {
+        runEventLoop(std::numeric_limits<double>::infinity());
+    }
+
+    void VM::runEventLoop(double deadline) {
+        for (;;) {
+            scheduler_.pollTimers();
+            bool expired = scheduler_.now() >= deadline;
+            if (scheduler_.hasReady() && !expired) {
+                resume(scheduler_.nextReady());
+            } else if (expired || (!scheduler_.hasTimers() && std::isinf(deadline))) {
+                return;
+            } else {
+                scheduler_.waitForTimers(deadline);
+            }
+        }
+    }
+
+    void VM::resume(uint32_t id) {
+        // La corrutina pasa a ocupar stack_/frames_ y el contexto actual queda guardado
+        // en su lugar hasta que se suspenda o termine
+        Coroutine* coroutine = coroutines_[id].get();
+        uint32_t outerRunning = running_;
+        size_t outerCalls = nestedCalls_;
+        std::swap(stack_, coroutine->stack);
+        std::swap(frames_, coroutine->frames);
+        coroutine->running = true;
+        running_ = id;
+        nestedCalls_ = 0;
+        auto restore = [&]() {
+            std::swap(stack_, coroutine->stack);
+            std::swap(frames_, coroutine->frames);
+            coroutine->running = false;
+            running_ = outerRunning;
+            nestedCalls_ = outerCalls;
+        };
+        bool finished;
+        try {
+            if (!coroutine->started) {
+                coroutine->started = true;
+                if (callValue(0, coroutine->argc, false)) execute(0);
+            } else if (!frames_.empty()) {
+                execute(0);
+            }
+            finished = !suspendRequested_;
+        } catch (...) {
+            suspendRequested_ = false;
+            restore();
+            coroutines_[id].reset();
+            freeCoroutines_.push_back(id);
+            throw;
+        }
+        suspendRequested_ = false;
+        restore();
+        if (finished) {
+            coroutines_[id].reset();
+            freeCoroutines_.push_back(id);
+        }
+    }
+
+    void VM::collectGarbage(bool full) {
+        // Un VM de PARA PARALELO sólo recolecta su generación joven: lo que comparte con el
+        // principal y con los demás hilos es viejo hasta que el principal adopta su heap
+        if (worker_) full = false;
+        heap_.beginCollection(full);
+        for (Value global : globals_) heap_.markValue(global);
+        markStack(stack_, frames_);
+        for (const auto& coroutine : coroutines_) {
+            if (coroutine == nullptr) continue;
+            if (coroutine->started || coroutine->running) {
+                markStack(coroutine->stack, coroutine->frames);
+            } else {
+                for (size_t i = 0; i <= coroutine->argc; ++i) heap_.markValue(coroutine->stack[i]);
+            }
+        }
+        for (const auto& proto : protos_) {
+            for (Value constant : proto->constants) heap_.markValue(constant);
+            for (const InlineCache& cache : proto->inlineCaches) {
+                for (uint8_t i = 0; i < cache.count; ++i) {
+                    heap_.markObject(cache.entries[i].klass);
+                    heap_.markValue(cache.entries[i].method);
+                }
+            }
+        }
+        for (Value root : nativeRoots_) heap_.markValue(root);
+        for (const auto& module : modules_) heap_.markObject(module.second);
+        for (const auto& table : methods_) {
+            for (const auto& method : table) heap_.markValue(method.second);
+        }
+        heap_.finishCollection();
+        // Sus claves son punteros sin marcar: una dirección liberada podría reutilizarse
+        std::fill(megamorphicCache_.begin(), megamorphicCache_.end(), MegamorphicEntry{});
+    }
+
+    void VM::setThreadCount(size_t threads) {
+        threadCount_ = std::max<size_t>(threads, 1);
+    }
+
+    void VM::syncWorkers() {
+        if (pool_ == nullptr || pool_->size() != threadCount_) pool_ = std::make_unique<mc_utils::WorkStealingPool>(threadCount_);
+        while (workers_.size() < threadCount_) {
+            auto worker = std::make_unique<VM>();
+            worker->worker_ = true;
+            worker->heap_.setThreadLocal(true);
+            worker->heap_.shareSymbols(&heap_);
+            workers_.push_back(std::move(worker));
+        }
+        for (const auto& worker : workers_) {
+            // Los valores de las globales cambian entre bucles; los nombres y las tablas
+            // de métodos sólo crecen
+            worker->globals_ = globals_;
+            if (worker->globalNames_.size() != globalNames_.size()) {
+                worker->globalNames_ = globalNames_;
+                worker->globalIndex_ = globalIndex_;
+            }
+            if (worker->modules_.size() != modules_.size()) worker->modules_ = modules_;
+            for (size_t i = 0; i < 3; ++i) {
+                if (worker->methods_[i].size() != methods_[i].size()) worker->methods_[i] = methods_[i];
+            }
+            worker->dispatchMode_ = dispatchMode_;
+            worker->profiler_ = profiler_;
+            worker->instructionCount_ = 0;
+        }
+    }
+
+    Value VM::runParallel(uint32_t slot, uint32_t argc) {
+        Value body = stack_[slot];
+        std::vector<Value> args(stack_.begin() + slot + 1, stack_.begin() + slot + 1 + argc);
+        Value* range = args.data() + argc - 3;
+        // Misma validación y normalización que FORPREP; un rango no entero va en un solo trozo
+        uint64_t iterations = forPrepare(range) ? 1 : 0;
+        bool integral = range[0].isInt();
+        if (iterations != 0 && integral) {
+            int64_t step = range[2].asInt();
+            uint64_t span = step > 0 ? static_cast<uint64_t>(range[1].asInt()) - static_cast<uint64_t>(range[0].asInt())
+                                     : static_cast<uint64_t>(range[0].asInt()) - static_cast<uint64_t>(range[1].asInt());
+            uint64_t stride = step > 0 ? static_cast<uint64_t>(step) : static_cast<uint64_t>(-(step + 1)) + 1;
+            iterations = span / stride + (span % stride != 0 ? 1 : 0);
+        }
+        size_t chunks = !integral ? static_cast<size_t>(iterations)
+                                  : static_cast<size_t>(std::min(kMaxParallelChunks,
+                                                                 std::max<uint64_t>(iterations / kMinChunkIterations,
+                                                                                    iterations != 0 ? 1 : 0)));
+
+        std::vector<Value> values(chunks);
+        std::vector<std::exception_ptr> errors(chunks);
+        std::atomic<size_t> firstError{chunks};
+        auto runChunk = [&](VM& vm, size_t k) {
+            // Si ya falló un trozo anterior, su error es el que se informará
+            if (k > firstError.load(std::memory_order_relaxed)) return;
+            std::vector<Value> chunkArgs(args);
+            if (integral) {
+                uint64_t start = range[0].asInt();
+                uint64_t step = static_cast<uint64_t>(range[2].asInt());
+                uint64_t first = static_cast<uint64_t>(static_cast<unsigned __int128>(iterations) * k / chunks);
+                uint64_t last = static_cast<uint64_t>(static_cast<unsigned __int128>(iterations) * (k + 1) / chunks);
+                chunkArgs[argc - 3] = Value::integer(static_cast<int64_t>(start + first * step));
+                if (k + 1 < chunks) chunkArgs[argc - 2] = Value::integer(static_cast<int64_t>(start + last * step));
+            }
+            try {
+                values[k] = vm.call(body, chunkArgs);
+                // Fuera de su pila: el hilo puede recolectar mientras ejecuta otros trozos
+                if (vm.worker_ && values[k].isObj()) Heap::publish(values[k].asObj());
+            } catch (...) {
+                errors[k] = std::current_exception();
+                size_t seen = firstError.load();
+                while (k < seen && !firstError.compare_exchange_weak(seen, k)) {
+                }
+            }
+        };
+
+        if (worker_) {
+            // Un PARA PARALELO anidado recorre sus trozos en el hilo que ya lo ejecuta
+            for (size_t k = 0; k < chunks; ++k) runChunk(*this, k);
+        } else if (chunks > 0) {
+            // Los hilos no recorren la generación vieja del heap principal: todo lo que
+            // pueden alcanzar de él tiene que estar ya en ella
+            if (heap_.hasYoungObjects()) collectGarbage(heap_.fullCollectionRequested());
+            syncWorkers();
+            // Lo que este hilo mostró antes del bucle tiene que salir antes que lo que escriban
+            // los demás al llenar sus búferes
+            OutputBuffer::flushAll();
+            pool_->run(chunks, [&](size_t worker, size_t k) { runChunk(*workers_[worker], k); });
+            for (const auto& worker : workers_) {
+                heap_.adopt(worker->heap_);
+                instructionCount_ += worker->instructionCount_;
+            }
+            // Lo que mostraron los demás hilos no espera a que se llenen sus búferes
+            OutputBuffer::flushAll();
+        }
+        if (firstError.load() < chunks) std::rethrow_exception(errors[firstError.load()]);
+
+        ObjArray* results = heap_.allocate<ObjArray>();
+        results->items = std::move(values);
+        return Value::object(results);
+    }
+
+    void VM::markStack(const std::vector<Value>& stack, const std::vector<CallFrame>& frames) {
+        // Sólo la ventana de los marcos activos: por encima hay registros ya muertos
+        size_t top = frames.empty() ? 0 : frames.back().base + frames.back().proto->numRegs;
+        for (size_t i = 0; i < top; ++i) heap_.markValue(stack[i]);
+    }
+
+    Value VM::execute(size_t entryDepth) {
+        switch (dispatchMode_) {
+            case DispatchMode::THREADED: return executeThreaded(entryDepth);
+            case DispatchMode::SWITCH: return executeSwitch(entryDepth);
+            case DispatchMode::COUNTING: return executeCounting(entryDepth);
+            case DispatchMode::PROFILING: return executeProfiling(entryDepth);
+        }
+        return executeSwitch(entryDepth);
+    }
+
+#if defined(__GNUC__)
+    Value VM::executeThreaded(size_t entryDepth) {
+#define VM_DISPATCH_THREADED
+#include "vm_dispatch.h"
+#undef VM_DISPATCH_THREADED
+    }
+#else
+    // Sin "computed goto" se usa el despacho por switch
+    Value VM::executeThreaded(size_t entryDepth) {
+        return executeSwitch(entryDepth);
+    }
+#endif
+
+    Value VM::executeSwitch(size_t entryDepth) {
+#include "vm_dispatch.h"
+    }
+
+    Value VM::executeCounting(size_t entryDepth) {
+#define VM_DISPATCH_COUNTING
+#include "vm_dispatch.h"
+#undef VM_DISPATCH_COUNTING
+    }
+
+    Value VM::executeProfiling(size_t entryDepth) {
+#define VM_DISPATCH_PROFILING
+#include "vm_dispatch.h"
+#undef VM_DISPATCH_PROFILING
+    }
+
+    void VM::setJitEnabled(bool enabled) {
+        if (enabled && !worker_ && Jit::supported()) {
+            if (jit_ == nullptr) jit_ = std::make_unique<Jit>(*this);
+        } else {
+            jit_.reset();
+        }
+    }
+
+    void VM::setProfiler(Profiler* profiler) {
+        profiler_ = profiler;
+        if (profiler != nullptr) {
+            dispatchMode_ = DispatchMode::PROFILING;
+        } else if (dispatchMode_ == DispatchMode::PROFILING) {
+            dispatchMode_ = DispatchMode::THREADED;
+        }
+    }
+
+    void VM::ensureStack(size_t slots) {
+        if (slots <= stack_.size()) return;
+        if (slots > kMaxStackSlots) {
+            throw RuntimeError("desbordamiento de pila");
+        }
+        stack_.resize(std::min(kMaxStackSlots, std::max(slots, stack_.size() * 2)));
+    }
+
+    void VM::pushFrame(const FunctionProto* proto, uint32_t base, uint32_t retSlot, uint32_t argc) {
+        checkArguments(proto, argc);
+        if (frames_.size() >= kMaxFrames) {
+            throw RuntimeError("desbordamiento de pila (recursión demasiado profunda)");
+        }
+        ensureStack(static_cast<size_t>(base) + proto->numRegs);
+        Value* regs = stack_.data() + base;
+        for (uint32_t i = argc; i < proto->numRegs; ++i) {
+            regs[i] = Value::nil();
+        }
+        frames_.push_back(CallFrame{proto, proto->codeBegin(), base, retSlot});
+    }
+
+    void VM::replaceFrame(const FunctionProto* proto, uint32_t first, uint32_t argc) {
+        checkArguments(proto, argc);
+        CallFrame& frame = frames_.back();
+        ensureStack(static_cast<size_t>(frame.base) + proto->numRegs);
+        Value* regs = stack_.data() + frame.base;
+        std::memmove(regs, stack_.data() + first, argc * sizeof(Value));
+        for (uint32_t i = argc; i < proto->numRegs; ++i) {
+            regs[i] = Value::nil();
+        }
+        frame.proto = proto;
+        frame.pc = proto->codeBegin();
+    }
+
+    bool VM::callValue(uint32_t calleeSlot, uint32_t argc, bool hasReceiver) {
+        Value callee = stack_[calleeSlot];
+        if (!callee.isObj()) {
+            throw RuntimeError(std::string("no se puede llamar a un valor de tipo ") + typeName(callee));
+        }
+        switch (callee.asObj()->type) {
+            case ObjType::FUNCTION: {
+                const FunctionProto* proto = asFunction(callee)->proto;
+                uint32_t base = calleeSlot + 1;
+                if (hasReceiver && !proto->isMethod) {
+                    ++base;
+                    --argc;
+                }
+                pushFrame(proto, base, calleeSlot, argc);
+                return true;
+            }
+            case ObjType::NATIVE: {
+                ObjNative* native = asNative(callee);
+                uint32_t first = calleeSlot + 1;
+                if (hasReceiver && !native->isMethod) {
+                    ++first;
+                    --argc;
+                }
+                int given = static_cast<int>(argc) - (native->isMethod ? 1 : 0);
+                if (native->arity >= 0 && given != native->arity) {
+                    throw RuntimeError(native->name + " espera " + std::to_string(native->arity) +
+                                       " argumento(s) y recibió " + std::to_string(given));
+                }
+                Value result;
+                try {
+                    result = native->fn(*this, stack_.data() + first, static_cast<int>(argc));
+                } catch (const NativeCallError& e) {
+                    throw RuntimeError(native->name + e.what());
+                }
+                stack_[calleeSlot] = result;
+                // El tiempo de la nativa es de su llamada, no de la instrucción siguiente
+                if (profiler_ != nullptr && Profiler::pending()) {
+                    profiler_->sample(frames_, frames_.empty() ? nullptr : frames_.back().pc - 1, &native->name);
+                }
+                return false;
+            }
+            case ObjType::CLASS: {
+                ObjClass* klass = asClass(callee);
+                Value* args = stack_.data() + calleeSlot + 1;
+                if (hasReceiver) {
+                    --argc;
+                    std::memmove(args, args + 1, argc * sizeof(Value));
+                }
+                // La instancia ocupa R[A+1] y los argumentos se desplazan una posición
+                ensureStack(static_cast<size_t>(calleeSlot) + argc + 2);
+                args = stack_.data() + calleeSlot + 1;
+                std::memmove(args + 1, args, argc * sizeof(Value));
+                args[0] = Value::object(heap_.allocate<ObjInstance>(klass));
+                pushFrame(asFunction(klass->constructor)->proto, calleeSlot + 1, calleeSlot, argc + 1);
+                return true;
+            }
+            default:
+                throw RuntimeError(std::string("no se puede llamar a un valor de tipo ") + typeName(callee));
+        }
+    }
+
+    Value VM::arith(OpCode op, Value a, Value b) {
+        if (op == OpCode::ADD && (isString(a) || isString(b))) {
+            // Sin aplanar los operandos: `s = s + x` en un bucle sólo enlaza cuerdas
+            ObjString* left = isString(a) ? asString(a) : heap_.newString(valueToString(a));
+            ObjString* right = isString(b) ? asString(b) : heap_.newString(valueToString(b));
+            return Value::object(heap_.concat(left, right));
+        }
+        if (!a.isNumber() || !b.isNumber()) {
+            throw RuntimeError(std::string("operación '") + operatorSymbol(op) + "' no válida entre " +
+                               typeName(a) + " y " + typeName(b));
+        }
+        if (a.isInt() && b.isInt()) {
+            int64_t x = a.asInt();
+            int64_t y = b.asInt();
+            int64_t result;
+            switch (op) {
+                case OpCode::ADD:
+                    if (!addOverflow(x, y, &result)) return Value::integer(result);
+                    break;
+                case OpCode::SUB:
+                    if (!subOverflow(x, y, &result)) return Value::integer(result);
+                    break;
+                case OpCode::MUL:
+                    if (!mulOverflow(x, y, &result)) return Value::integer(result);
+                    break;
+                case OpCode::DIV:
+                    if (y == 0) throw RuntimeError("división por cero");
+                    if (!(x == INT64_MIN && y == -1)) return Value::integer(x / y);
+                    break;
+                case OpCode::MOD:
+                    if (y == 0) throw RuntimeError("división por cero");
+                    return Value::integer(y == -1 ? 0 : x % y);
+                default:
+                    break;
+            }
+        }
+        double x = a.asNumber();
+        double y = b.asNumber();
+        switch (op) {
+            case OpCode::ADD: return Value::number(x + y);
+            case OpCode::SUB: return Value::number(x - y);
+            case OpCode::MUL: return Value::number(x * y);
+            case OpCode::DIV:
+                if (y == 0.0) throw RuntimeError("división por cero");
+                return Value::number(x / y);
+            case OpCode::MOD:
+                if (y == 0.0) throw RuntimeError("división por cero");
+                return Value::number(std::fmod(x, y));
+            default:
+                throw RuntimeError("operación aritmética desconocida");
+        }
+    }
+
+    Value VM::evaluate(OpCode op, Value b, Value c) {
+        switch (op) {
+            case OpCode::NEG:
+                if (b.isInt() && b.asInt() != INT64_MIN) return Value::integer(-b.asInt());
+                if (b.isNumber()) return Value::number(-b.asNumber());
+                throw RuntimeError(std::string("no se puede negar un valor de tipo ") + typeName(b));
+            case OpCode::NOT:
+                return Value::boolean(!b.isTruthy());
+            case OpCode::EQ:
+                return Value::boolean(valuesEqual(b, c));
+            case OpCode::NE:
+                return Value::boolean(!valuesEqual(b, c));
+            case OpCode::LT:
+                return Value::boolean(lessThan(b, c, false));
+            case OpCode::LE:
+                return Value::boolean(lessThan(b, c, true));
+            default:
+                return arith(op, b, c);
+        }
+    }
+
+    bool VM::lessThan(Value a, Value b, bool orEqual) {
+        if (a.isNumber() && b.isNumber()) {
+            double x = a.asNumber();
+            double y = b.asNumber();
+            return orEqual ? x <= y : x < y;
+        }
+        if (isString(a) && isString(b)) {
+            int order = asString(a)->view().compare(asString(b)->view());
+            return orEqual ? order <= 0 : order < 0;
+        }
+        throw RuntimeError(std::string("no se pueden comparar ") + typeName(a) + " y " + typeName(b));
+    }
+
+    Value VM::getIndex(Value object, Value key) {
+        if (isObjType(object, ObjType::TYPED_ARRAY)) {
+            const ObjTypedArray* array = asTypedArray(object);
+            if (!key.isInt()) {
+                throw RuntimeError(std::string("índice de tipo ") + typeName(key) + " no válido para ARRAY");
+            }
+            if (key.asInt() < 0 || key.asInt() >= static_cast<int64_t>(array->size())) {
+                throw RuntimeError("índice " + std::to_string(key.asInt()) + " fuera de rango (longitud " +
+                                   std::to_string(array->size()) + ")");
+            }
+            return array->get(static_cast<size_t>(key.asInt()));
+        }
+        if (isObjType(object, ObjType::ARRAY)) {
+            if (!key.isInt()) {
+                throw RuntimeError(std::string("índice de tipo ") + typeName(key) + " no válido para ARRAY");
+            }
+            const std::vector<Value>& items = asArray(object)->items;
+            int64_t index = key.asInt();
+            if (index < 0 || index >= static_cast<int64_t>(items.size())) {
+                throw RuntimeError("índice " + std::to_string(index) + " fuera de rango (longitud " +
+                                   std::to_string(items.size()) + ")");
+            }
+            return items[static_cast<size_t>(index)];
+        }
+        if (isObjType(object, ObjType::MAP)) {
+            const Value* value = asMap(object)->find(key);
+            return value == nullptr ? Value::nil() : *value;
+        }
+        if (isString(object) && key.isInt()) {
+            std::string_view chars = asString(object)->view();
+            int64_t index = key.asInt();
+            if (index < 0 || index >= static_cast<int64_t>(chars.size())) {
+                throw RuntimeError("índice " + std::to_string(index) + " fuera de rango (longitud " +
+                                   std::to_string(chars.size()) + ")");
+            }
+            return newString(chars.substr(static_cast<size_t>(index), 1));
+        }
+        if (isString(key) && (isObjType(object, ObjType::INSTANCE) || isObjType(object, ObjType::MODULE))) {
+            return getField(object, key);
+        }
+        throw RuntimeError(std::string("no se puede indexar un valor de tipo ") + typeName(object));
+    }
+
+    void VM::setIndex(Value object, Value key, Value value) {
+        if (isObjType(object, ObjType::TYPED_ARRAY)) {
+            ObjTypedArray* array = asTypedArray(object);
+            if (!key.isInt() || key.asInt() < 0 || key.asInt() >= static_cast<int64_t>(array->size())) {
+                throw RuntimeError("índice " + valueToString(key) + " fuera de rango (longitud " +
+                                   std::to_string(array->size()) + ")");
+            }
+            if (!array->set(static_cast<size_t>(key.asInt()), value)) throw typedElementError(array, value);
+            return;
+        }
+        if (isObjType(object, ObjType::ARRAY)) {
+            std::vector<Value>& items = asArray(object)->items;
+            if (!key.isInt() || key.asInt() < 0 || key.asInt() >= static_cast<int64_t>(items.size())) {
+                throw RuntimeError("índice " + valueToString(key) + " fuera de rango (longitud " +
+                                   std::to_string(items.size()) + ")");
+            }
+            items[static_cast<size_t>(key.asInt())] = value;
+            writeBarrier(object.asObj(), value);
+            return;
+        }
+        if (isObjType(object, ObjType::MAP)) {
+            asMap(object)->set(mapKey(key), value);
+            return;
+        }
+        if (isString(key) && isObjType(object, ObjType::INSTANCE)) {
+            setField(object, key, value);
+            return;
+        }
+        throw RuntimeError(std::string("no se puede asignar por índice en un valor de tipo ") + typeName(object));
+    }
+
+    bool VM::resolveMember(ObjClass* klass, Value name, bool methodFirst, InlineCache* cache,
+                           InlineCache::Entry& entry) {
+        // Un sitio megamórfico consulta antes la tabla global (clase, nombre)
+        MegamorphicEntry* slot = nullptr;
+        if (cache != nullptr && cache->megamorphic) {
+            size_t hash = (reinterpret_cast<uintptr_t>(klass) >> 4) ^ (reinterpret_cast<uintptr_t>(name.asObj()) >> 4) * 31;
+            slot = &megamorphicCache_[(methodFirst ? kMegamorphicEntries : 0) + (hash & (kMegamorphicEntries - 1))];
+            if (slot->entry.klass == klass && slot->name == name.asObj()) {
+                entry = slot->entry;
+                return true;
+            }
+        }
+        std::string member = asString(name)->str();
+        auto method = klass->methods.find(member);
+        auto field = klass->fieldIndex.find(member);
+        if (field != klass->fieldIndex.end() && !(methodFirst && method != klass->methods.end())) {
+            entry = InlineCache::Entry{klass, field->second, Value::nil()};
+        } else if (method != klass->methods.end()) {
+            entry = InlineCache::Entry{klass, InlineCache::kMethod, method->second};
+        } else {
+            return false;
+        }
+        if (slot != nullptr) {
+            *slot = MegamorphicEntry{name.asObj(), entry};
+        } else if (cache != nullptr && !worker_) {
+            // Los hilos de PARA PARALELO comparten los prototipos: sólo leen sus cachés
+            cache->add(klass, entry.field, entry.method);
+        }
+        return true;
+    }
+
+    Value VM::toTypedArray(Value value, ElementType type) {
+        if (isObjType(value, ObjType::TYPED_ARRAY) && asTypedArray(value)->elementType == type) return value;
+        if (!isAnyArray(value)) {
+            throw RuntimeError(std::string("se esperaba un ARRAY<") + (type == ElementType::INT ? "INT" : "FLOAT") +
+                               ">, no " + typeName(value));
+        }
+        ObjTypedArray* array = heap_.allocate<ObjTypedArray>(type);
+        size_t count = isObjType(value, ObjType::ARRAY) ? asArray(value)->items.size() : asTypedArray(value)->size();
+        if (type == ElementType::INT) {
+            array->ints.reserve(count);
+        } else {
+            array->floats.reserve(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Value item = isObjType(value, ObjType::ARRAY) ? asArray(value)->items[i] : asTypedArray(value)->get(i);
+            if (!array->push(item)) throw typedElementError(array, item);
+        }
+        return Value::object(array);
+    }
+
+    RuntimeError typedElementError(const ObjTypedArray* array, Value value) {
+        return RuntimeError(std::string("un ARRAY<") + (array->elementType == ElementType::INT ? "INT" : "FLOAT") +
+                            "> no admite valores de tipo " + typeName(value));
+    }
+
+    Value VM::getField(Value object, Value name, InlineCache* cache) {
+        std::string_view field = asString(name)->view();
+        if (isObjType(object, ObjType::INSTANCE)) {
+            ObjInstance* instance = asInstance(object);
+            InlineCache::Entry entry;
+            if (!resolveMember(instance->klass, name, false, cache, entry)) {
+                throw RuntimeError("el campo '" + std::string(field) + "' no existe en " + instance->klass->name);
+            }
+            return entry.field == InlineCache::kMethod ? entry.method : instance->fields[entry.field];
+        }
+        if (isObjType(object, ObjType::MODULE)) {
+            ObjModule* module = asModule(object);
+            auto it = module->members.find(std::string(field));
+            if (it == module->members.end()) {
+                throw RuntimeError("el módulo " + module->name + " no define '" + std::string(field) + "'");
+            }
+            return it->second;
+        }
+        if (isObjType(object, ObjType::MAP)) {
+            const Value* value = asMap(object)->find(name);
+            return value == nullptr ? Value::nil() : *value;
+        }
+        throw RuntimeError("no se puede leer el campo '" + std::string(field) + "' de un valor de tipo " +
+                           typeName(object));
+    }
+
+    void VM::setField(Value object, Value name, Value value, InlineCache* cache) {
+        std::string_view field = asString(name)->view();
+        if (isObjType(object, ObjType::INSTANCE)) {
+            ObjInstance* instance = asInstance(object);
+            InlineCache::Entry entry;
+            if (!resolveMember(instance->klass, name, false, cache, entry) || entry.field == InlineCache::kMethod) {
+                throw RuntimeError("el campo '" + std::string(field) + "' no existe en " + instance->klass->name);
+            }
+            instance->fields[entry.field] = value;
+            writeBarrier(instance, value);
+            return;
+        }
+        if (isObjType(object, ObjType::MAP)) {
+            asMap(object)->set(mapKey(name), value);
+            return;
+        }
+        throw RuntimeError("no se puede asignar el campo '" + std::string(field) + "' en un valor de tipo " +
+                           typeName(object));
+    }
+
+    Value VM::lookupMethod(Value receiver, Value name, InlineCache* cache) {
+        std::string method = asString(name)->str();
+        if (isObjType(receiver, ObjType::INSTANCE)) {
+            // Un campo que contiene una función también se puede invocar
+            InlineCache::Entry entry;
+            if (resolveMember(asInstance(receiver)->klass, name, true, cache, entry)) {
+                return entry.field == InlineCache::kMethod ? entry.method : asInstance(receiver)->fields[entry.field];
+            }
+        } else if (isObjType(receiver, ObjType::MODULE)) {
+            return getField(receiver, name);
+        } else {
+            Value builtin = findMethod(receiver, method);
+            if (!builtin.isNil()) return builtin;
+            if (isObjType(receiver, ObjType::MAP)) {
+                const Value* value = asMap(receiver)->find(name);
+                if (value != nullptr) return *value;
+            }
+        }
+        throw RuntimeError(std::string("un valor de tipo ") + typeName(receiver) + " no tiene el método '" +
+                           method + "'");
+    }
+
+    bool VM::forPrepare(Value* regs) {
+        if (regs[0].isInt() && regs[2].isInt() && regs[1].isFloat() && std::fabs(regs[1].asFloat()) < 9.0e18) {
+            // Inicio y paso enteros con límite FLOAT: el contador sigue siendo INT
+            // (i < 3.5 equivale a i < 4; i > 3.5 equivale a i > 3)
+            double limit = regs[1].asFloat();
+            regs[1] = Value::integer(static_cast<int64_t>(regs[2].asInt() > 0 ? std::ceil(limit) : std::floor(limit)));
+        }
+        if (regs[0].isInt() && regs[1].isInt() && regs[2].isInt()) {
+            int64_t step = regs[2].asInt();
+            if (step == 0) throw RuntimeError("el INCREMENTO de PARA no puede ser 0");
+            return step > 0 ? regs[0].asInt() < regs[1].asInt() : regs[0].asInt() > regs[1].asInt();
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (!regs[i].isNumber()) {
+                throw RuntimeError(std::string("los límites de PARA deben ser numéricos, no ") + typeName(regs[i]));
+            }
+        }
+        // Con algún límite FLOAT el bucle entero trabaja en FLOAT
+        double step = regs[2].asNumber();
+        if (step == 0.0) throw RuntimeError("el INCREMENTO de PARA no puede ser 0");
+        regs[0] = Value::number(regs[0].asNumber());
+        regs[1] = Value::number(regs[1].asNumber());
+        regs[2] = Value::number(step);
+        return step > 0 ? regs[0].asFloat() < regs[1].asFloat() : regs[0].asFloat() > regs[1].asFloat();
+    }
+
+    bool VM::forEachStep(Value* regs) {
+        Value collection = regs[0];
+        size_t index = static_cast<size_t>(regs[1].asInt());
+        if (isObjType(collection, ObjType::TYPED_ARRAY)) {
+            const ObjTypedArray* array = asTypedArray(collection);
+            if (index >= array->size()) return false;
+            regs[2] = array->get(index);
+            regs[1] = Value::integer(static_cast<int64_t>(index + 1));
+            return true;
+        }
+        if (isObjType(collection, ObjType::MAP)) {
+            const auto& entries = asMap(collection)->entries;
+            if (index >= entries.size()) return false;
+            regs[2] = entries[index].first;
+            regs[1] = Value::integer(static_cast<int64_t>(index + 1));
+            return true;
+        }
+        if (isString(collection)) {
+            // Recorre la cadena carácter a carácter (UTF-8); el índice es un desplazamiento en bytes
+            std::string_view chars = asString(collection)->view();
+            if (index >= chars.size()) return false;
+            size_t length = std::min(utf8Length(static_cast<unsigned char>(chars[index])), chars.size() - index);
+            regs[2] = newString(chars.substr(index, length));
+            regs[1] = Value::integer(static_cast<int64_t>(index + length));
+            return true;
+        }
+        throw RuntimeError(std::string("no se puede recorrer un valor de tipo ") + typeName(collection));
+    }
+
+    void VM::raise(const RuntimeError& error, const Instr* pc, size_t entryDepth) {
+        // Un error ya ubicado proviene de una ejecución anidada (llamada desde una nativa)
+        if (error.line() != 0) {
+            frames_.resize(entryDepth);
+            throw error;
+        }
+        const FunctionProto* proto = frames_.back().proto;
+        size_t index = static_cast<size_t>(pc - proto->codeBegin());
+        uint32_t line = index > 0 && index <= proto->codeSize() ? proto->lineAt(index - 1) : 0;
+        std::string function = proto->name;
+        frames_.resize(entryDepth);
+        throw RuntimeError(error.what(), line, function);
+    }
+
+} // namespace mc_core
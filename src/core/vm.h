@@ -0,0 +1,290 @@
+#ifndef VM_H
+#define VM_H
+
+#include "bytecode.h"
+#include "heap.h"
+#include "object.h"
+#include "scheduler.h"
+#include "value.h"
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mc_utils {
+    class WorkStealingPool;
+}
+
+namespace mc_core {
+
+    class Jit;
+    class Profiler;
+
+    // Error de ejecución de un programa MC++; line() es 0 hasta que el VM lo ubica
+    class RuntimeError : public std::runtime_error {
+    public:
+        explicit RuntimeError(const std::string& message) : std::runtime_error(message), line_(0) {}
+        RuntimeError(const std::string& message, uint32_t line, const std::string& function)
+            : std::runtime_error("Error de ejecución (línea " + std::to_string(line) + ", en " + function +
+                                 "): " + message),
+              line_(line) {}
+
+        uint32_t line() const { return line_; }
+
+    private:
+        uint32_t line_;
+    };
+
+    // Error de una nativa que no conoce el nombre con el que se registró (NativeBinding):
+    // el VM lo convierte en RuntimeError anteponiendo el nombre de la ObjNative llamada
+    class NativeCallError : public RuntimeError {
+    public:
+        using RuntimeError::RuntimeError;
+    };
+
+    // Error al guardar en un ARRAY<INT> / ARRAY<FLOAT> un valor de otro tipo
+    RuntimeError typedElementError(const ObjTypedArray* array, Value value);
+
+    /**
+     * Estrategia de despacho del bucle principal.
+     *  - THREADED: direct threading con "computed goto" (GCC/Clang); cada manejador
+     *    salta directamente al siguiente sin volver a un switch central.
+     *  - SWITCH: bucle con switch central, usado como referencia en los benchmarks.
+     *  - COUNTING: como SWITCH pero contando instrucciones ejecutadas.
+     *  - PROFILING: como SWITCH pero entregando al perfilador las muestras pendientes.
+     */
+    enum class DispatchMode {
+        THREADED,
+        SWITCH,
+        COUNTING,
+        PROFILING
+    };
+
+    // Marco de activación; los registros viven en la pila de valores contigua
+    struct CallFrame {
+        const FunctionProto* proto;
+        const Instr* pc;     // Siguiente instrucción (guardada al llamar)
+        uint32_t base;       // Índice de R[0] en la pila
+        uint32_t retSlot;    // Índice donde se deposita el resultado
+    };
+
+    // Corrutina (hilo verde) creada con LANZAR: su propia pila de valores y sus marcos
+    struct Coroutine {
+        std::vector<Value> stack;
+        std::vector<CallFrame> frames;
+        uint32_t argc = 0;     // Argumentos de la llamada inicial, en stack[1..argc]
+        bool started = false;
+        bool running = false;  // Mientras corre, stack/frames guardan el contexto que la reanudó
+    };
+
+    // Módulo de fuente (archivo .mc importado) ya compilado en el VM
+    struct SourceModule {
+        std::string name;
+        FunctionProto* init;  // Su nivel superior, que el programa ejecuta antes que el suyo
+    };
+
+    /**
+     * Máquina virtual de registros de MC++.
+     *
+     * Los marcos no se asignan en el heap: todos los registros viven en una única pila
+     * de valores y las llamadas entre funciones MC++ no recursan en la pila nativa.
+     * Una llamada final (TAILCALL) reutiliza el marco de quien llama, así que la
+     * recursión final no tiene límite de profundidad.
+     */
+    class VM {
+    public:
+        VM();
+        ~VM();
+        VM(const VM&) = delete;
+        VM& operator=(const VM&) = delete;
+
+        Heap& heap() { return heap_; }
+
+        // Tabla de globales (resuelta por nombre en tiempo de compilación)
+        uint32_t globalSlot(const std::string& name);
+        int findGlobal(const std::string& name) const;
+        Value getGlobal(const std::string& name) const;
+        void setGlobal(uint32_t slot, Value value) { globals_[slot] = value; }
+        const std::string& globalName(uint32_t slot) const { return globalNames_[slot]; }
+        size_t globalCount() const { return globals_.size(); }
+        // Olvida las globales registradas después de las `count` primeras (una entrada
+        // del REPL que no compiló)
+        void truncateGlobals(size_t count);
+
+        // Registro de funciones nativas, módulos y métodos integrados
+        void defineNative(const std::string& name, NativeFn fn, int arity);
+        ObjModule* defineModule(const std::string& name);
+        ObjModule* findModule(const std::string& name) const;
+        // Módulos de fuente en orden de dependencias (cada uno después de los que importa)
+        void addSourceModule(const std::string& name, FunctionProto* init) { sourceModules_.push_back({name, init}); }
+        const std::vector<SourceModule>& sourceModules() const { return sourceModules_; }
+        bool isSourceModule(const std::string& name) const;
+        // Niveles superiores de los módulos añadidos desde la última llamada: los ejecuta
+        // el siguiente programa compilado, así que cada uno se inicializa una sola vez
+        std::vector<FunctionProto*> takeModuleInits();
+        void defineMethod(ObjType type, const std::string& name, NativeFn fn, int arity);
+        Value findMethod(Value receiver, const std::string& name) const;
+
+        FunctionProto* newProto(const std::string& name);
+        const std::vector<std::unique_ptr<FunctionProto>>& protos() const { return protos_; }
+        Value newString(std::string_view text) { return Value::object(heap_.newString(text)); }
+
+        // Cadena de la tabla de símbolos (nombres y claves de MAP: se comparan por puntero)
+        Value intern(std::string_view text) { return Value::object(heap_.intern(text)); }
+
+        // Convierte un ARRAY en ARRAY<INT> / ARRAY<FLOAT> (copia salvo que ya lo sea)
+        Value toTypedArray(Value value, ElementType type);
+
+        // Resultado de ADD..MOD, NEG, NOT o EQ..LE sobre valores dados, igual que en el
+        // bucle de despacho (el optimizador lo usa para plegar constantes)
+        Value evaluate(OpCode op, Value b, Value c);
+
+        // Ejecuta un prototipo sin argumentos (el script de nivel superior)
+        Value run(const FunctionProto* script);
+
+        // Invoca un valor invocable desde C++ (funciones nativas, intérprete)
+        Value call(Value callee, const std::vector<Value>& args);
+
+        /**
+         * Corrutinas sin pila nativa propia. spawn() prepara callee(args) en una
+         * corrutina nueva y la deja lista; el planificador las reanuda por turnos
+         * mientras el programa espera y en runCoroutines(), que vuelve cuando todas
+         * han terminado.
+         *
+         * wait() es el punto de suspensión de ESPERAR y de las nativas que bloquean.
+         * Dentro de una corrutina, si ninguna nativa intermedia ha vuelto a entrar en
+         * el VM con call(), la corrutina se suspende: sus marcos ya están en su pila
+         * de valores y el bucle de despacho simplemente vuelve al planificador. En el
+         * programa principal o en una llamada anidada, el bucle de eventos ejecuta las
+         * demás corrutinas hasta que vence el plazo.
+         */
+        uint32_t spawn(Value callee, const std::vector<Value>& args);
+        void wait(double milliseconds);
+        void runCoroutines();
+        size_t coroutineCount() const { return coroutines_.size() - freeCoroutines_.size(); }
+
+        /**
+         * Recolecta la basura del heap. Las raíces son las globales, los registros de
+         * los marcos activos, las constantes y cachés en línea de los prototipos, los
+         * módulos y los métodos integrados. El bucle de despacho la invoca por sí mismo
+         * en puntos seguros; una función nativa que guarde valores en variables de C++
+         * y llame de nuevo al VM (call) debe mantenerlos en sus argumentos o
+         * registrarlos con pushRoot() mientras tanto.
+         */
+        void collectGarbage(bool full = false);
+        void pushRoot(Value value) { nativeRoots_.push_back(value); }
+        void popRoot() { nativeRoots_.pop_back(); }
+
+        /**
+         * Hilos de PARA PARALELO (por defecto, los núcleos de la máquina). Cada hilo
+         * ejecuta los trozos del rango en un VM propio que comparte los prototipos y
+         * lee las globales de este, y asigna en un heap propio, con sus propias
+         * recolecciones menores, que este adopta al terminar el bucle. El reparto en trozos depende sólo del número de
+         * iteraciones, así que el resultado es el mismo con cualquier número de hilos.
+         */
+        void setThreadCount(size_t threads);
+        size_t threadCount() const { return threadCount_; }
+
+        void setDispatchMode(DispatchMode mode) { dispatchMode_ = mode; }
+        DispatchMode dispatchMode() const { return dispatchMode_; }
+        uint64_t instructionCount() const { return instructionCount_; }
+
+        /**
+         * Compilador de trazas para los bucles calientes (véase jit.h). Sólo actúa con
+         * los despachos THREADED y SWITCH, y nunca en los hilos de PARA PARALELO; si la
+         * plataforma no lo admite, activarlo no tiene efecto.
+         */
+        void setJitEnabled(bool enabled);
+        Jit* jit() const { return jit_.get(); }
+
+        // Con un perfilador el despacho pasa a PROFILING; con nullptr vuelve a THREADED
+        void setProfiler(Profiler* profiler);
+        Profiler* profiler() const { return profiler_; }
+
+    private:
+        Heap heap_;
+        std::vector<Value> globals_;
+        std::vector<std::string> globalNames_;
+        std::unordered_map<std::string, uint32_t> globalIndex_;
+        std::unordered_map<std::string, ObjModule*> modules_;
+        std::vector<SourceModule> sourceModules_;
+        size_t initializedModules_ = 0;
+        std::unordered_map<std::string, Value> methods_[3];  // STRING, ARRAY, MAP
+        std::vector<std::unique_ptr<FunctionProto>> protos_;
+        std::vector<Value> nativeRoots_;
+
+        // Resoluciones de los sitios megamórficos: una tabla de acceso directo por
+        // (clase, nombre) para campos y otra para llamadas (SELF)
+        struct MegamorphicEntry {
+            Obj* name = nullptr;
+            InlineCache::Entry entry;
+        };
+        static constexpr size_t kMegamorphicEntries = 1024;
+        std::vector<MegamorphicEntry> megamorphicCache_;
+
+        std::vector<Value> stack_;
+        std::vector<CallFrame> frames_;
+
+        // Corrutinas por identificador (nullptr = libre) y la que ocupa stack_/frames_
+        static constexpr uint32_t kNoCoroutine = UINT32_MAX;
+        std::vector<std::unique_ptr<Coroutine>> coroutines_;
+        std::vector<uint32_t> freeCoroutines_;
+        Scheduler scheduler_;
+        uint32_t running_ = kNoCoroutine;
+        size_t nestedCalls_ = 0;        // call() activos en el contexto actual
+        bool suspendRequested_ = false;
+        DispatchMode dispatchMode_ = DispatchMode::THREADED;
+        uint64_t instructionCount_ = 0;
+        Profiler* profiler_ = nullptr;
+        std::unique_ptr<Jit> jit_;
+
+        // PARA PARALELO: grupo de hilos y un VM auxiliar por hilo (el hilo 0 es el que llama)
+        size_t threadCount_;
+        std::unique_ptr<mc_utils::WorkStealingPool> pool_;
+        std::vector<std::unique_ptr<VM>> workers_;
+        bool worker_ = false;   // VM auxiliar: sólo recolecciones menores y sin escrituras en globales
+
+        Value execute(size_t entryDepth);
+        Value executeThreaded(size_t entryDepth);
+        Value executeSwitch(size_t entryDepth);
+        Value executeCounting(size_t entryDepth);
+        Value executeProfiling(size_t entryDepth);
+
+        void resume(uint32_t id);
+        void runEventLoop(double deadline);
+        void markStack(const std::vector<Value>& stack, const std::vector<CallFrame>& frames);
+
+        // PARFOR: ejecuta el cuerpo R[slot](R[slot+1] .. R[slot+argc]) por trozos y
+        // devuelve el ARRAY de resultados en el orden de los trozos
+        Value runParallel(uint32_t slot, uint32_t argc);
+        void syncWorkers();
+
+        // Rutas lentas invocadas desde el bucle de despacho
+        void ensureStack(size_t slots);
+        void pushFrame(const FunctionProto* proto, uint32_t base, uint32_t retSlot, uint32_t argc);
+        // Llamada final: el marco actual pasa a ser el de `proto` con los argumentos de stack_[first..]
+        void replaceFrame(const FunctionProto* proto, uint32_t first, uint32_t argc);
+        bool callValue(uint32_t calleeSlot, uint32_t argc, bool hasReceiver);
+        Value arith(OpCode op, Value a, Value b);
+        bool lessThan(Value a, Value b, bool orEqual);
+        Value getIndex(Value object, Value key);
+        void setIndex(Value object, Value key, Value value);
+        // Las claves STRING de un MAP se internan al guardarlas
+        Value mapKey(Value key) { return isString(key) ? Value::object(heap_.intern(asString(key))) : key; }
+        // Con `cache`, una resolución sobre una instancia se registra en la caché del sitio
+        Value getField(Value object, Value name, InlineCache* cache = nullptr);
+        void setField(Value object, Value name, Value value, InlineCache* cache = nullptr);
+        Value lookupMethod(Value receiver, Value name, InlineCache* cache = nullptr);
+        bool resolveMember(ObjClass* klass, Value name, bool methodFirst, InlineCache* cache,
+                           InlineCache::Entry& entry);
+        bool forPrepare(Value* regs);
+        bool forEachStep(Value* regs);
+        [[noreturn]] void raise(const RuntimeError& error, const Instr* pc, size_t entryDepth);
+    };
+
+} // namespace mc_core
+
+#endif // VM_H
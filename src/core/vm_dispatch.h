@@ -0,0 +1,558 @@
+// Cuerpo del bucle de despacho del VM de MC++.
+//
+// vm.cpp lo incluye una vez por estrategia de despacho, dentro de la función miembro
+// correspondiente. Con VM_DISPATCH_THREADED cada manejador salta directamente al
+// siguiente a través de una tabla de etiquetas ("computed goto"); sin él se genera un
+// switch central, que con VM_DISPATCH_COUNTING además cuenta instrucciones y con
+// VM_DISPATCH_PROFILING entrega al perfilador los ticks de SIGPROF pendientes. Sólo
+// THREADED y SWITCH ofrecen los saltos hacia atrás al compilador de trazas.
+// No lleva guardas de inclusión a propósito.
+
+    CallFrame* frame = &frames_.back();
+    const Instr* pc = frame->pc;
+    Value* R = stack_.data() + frame->base;
+    const Value* K = frame->proto->constants.data();
+    InlineCache* IC = frame->proto->inlineCaches.data();
+    Instr instr;
+
+#define VM_LOAD_FRAME()                          \
+    do {                                         \
+        frame = &frames_.back();                 \
+        pc = frame->pc;                          \
+        R = stack_.data() + frame->base;         \
+        K = frame->proto->constants.data();      \
+        IC = frame->proto->inlineCaches.data();  \
+    } while (0)
+
+// Punto seguro: todos los valores vivos están en registros, globales o constantes
+#define VM_SAFEPOINT()                                                                    \
+    do {                                                                                  \
+        if (heap_.collectionRequested()) collectGarbage(heap_.fullCollectionRequested()); \
+    } while (0)
+
+#if defined(VM_DISPATCH_COUNTING) || defined(VM_DISPATCH_PROFILING)
+#define VM_LOOP_BACK() ((void)0)
+#else
+// Salto hacia atrás a `pc`: el bucle puede seguir en una traza nativa
+#define VM_LOOP_BACK()                                                                   \
+    do {                                                                                 \
+        if (jit_ != nullptr) pc = jit_->loop(frame->proto, pc, R, globals_.data());      \
+    } while (0)
+#endif
+
+#define VM_A() argA(instr)
+#define VM_RB() R[argB(instr)]
+#define VM_RC() R[argC(instr)]
+// Superinstrucción de comparación: guarda el resultado y aplica el JMPIF / JMPIFNOT que
+// la sigue. El salto se lee después de comparar para que un error señale la comparación
+#define VM_COMPARE_JUMP(result)                                             \
+    do {                                                                    \
+        bool holds = (result);                                              \
+        R[VM_A()] = Value::boolean(holds);                                  \
+        Instr jump = *pc++;                                                 \
+        if (holds == (opOf(jump) == OpCode::JMPIF)) pc += argSBx(jump);     \
+    } while (0)
+// Caché en línea de la instrucción actual (consume su EXTRAARG)
+#define VM_CACHE() IC[argAx(*pc++)]
+
+#if defined(VM_DISPATCH_THREADED)
+    static void* const kTargets[] = {
+#define MC_OPCODE_LABEL(name) &&op_##name,
+        MC_OPCODES(MC_OPCODE_LABEL)
+#undef MC_OPCODE_LABEL
+    };
+#define VM_CASE(name) op_##name:
+#define VM_NEXT()                            \
+    do {                                     \
+        instr = *pc++;                       \
+        goto* kTargets[instr & 0xFF];        \
+    } while (0)
+#define VM_LOOP_BEGIN VM_NEXT();
+#define VM_LOOP_END
+#else
+#if defined(VM_DISPATCH_COUNTING)
+#define VM_COUNT() ++instructionCount_
+#elif defined(VM_DISPATCH_PROFILING)
+// frame->pc sólo se actualiza al llamar: la instrucción en curso se pasa aparte
+#define VM_COUNT()                                                   \
+    do {                                                             \
+        if (Profiler::pending()) profiler_->sample(frames_, pc - 1); \
+    } while (0)
+#else
+#define VM_COUNT() ((void)0)
+#endif
+#define VM_CASE(name) case OpCode::name:
+#define VM_NEXT() continue
+#define VM_LOOP_BEGIN        \
+    for (;;) {               \
+        instr = *pc++;       \
+        VM_COUNT();          \
+        switch (opOf(instr)) {
+#define VM_LOOP_END                                          \
+            default:                                         \
+                throw RuntimeError("instrucción inválida");  \
+        }                                                    \
+    }
+#endif
+
+    try {
+        VM_LOOP_BEGIN
+
+        VM_CASE(NOP) {
+            VM_NEXT();
+        }
+        VM_CASE(MOVE) {
+            R[VM_A()] = VM_RB();
+            VM_NEXT();
+        }
+        VM_CASE(LOADK) {
+            R[VM_A()] = K[argBx(instr)];
+            VM_NEXT();
+        }
+        VM_CASE(LOADI) {
+            R[VM_A()] = Value::integer(argSBx(instr));
+            VM_NEXT();
+        }
+        VM_CASE(LOADBOOL) {
+            R[VM_A()] = Value::boolean(argB(instr) != 0);
+            VM_NEXT();
+        }
+        VM_CASE(LOADNIL) {
+            R[VM_A()] = Value::nil();
+            VM_NEXT();
+        }
+        VM_CASE(GETGLOBAL) {
+            R[VM_A()] = globals_[argBx(instr)];
+            VM_NEXT();
+        }
+        VM_CASE(SETGLOBAL) {
+            // Las globales son de sólo lectura para los hilos de PARA PARALELO
+            if (worker_) {
+                throw RuntimeError("no se puede modificar la global '" + globalNames_[argBx(instr)] +
+                                   "' dentro de PARA PARALELO");
+            }
+            globals_[argBx(instr)] = R[VM_A()];
+            VM_NEXT();
+        }
+        VM_CASE(ADD) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            int64_t result;
+            if (b.isInt() && c.isInt() && !addOverflow(b.asInt(), c.asInt(), &result)) {
+                R[VM_A()] = Value::integer(result);
+            } else if (b.isFloat() && c.isFloat()) {
+                R[VM_A()] = Value::number(b.asFloat() + c.asFloat());
+            } else {
+                R[VM_A()] = arith(OpCode::ADD, b, c);
+                VM_SAFEPOINT();
+            }
+            VM_NEXT();
+        }
+        VM_CASE(SUB) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            int64_t result;
+            if (b.isInt() && c.isInt() && !subOverflow(b.asInt(), c.asInt(), &result)) {
+                R[VM_A()] = Value::integer(result);
+            } else if (b.isFloat() && c.isFloat()) {
+                R[VM_A()] = Value::number(b.asFloat() - c.asFloat());
+            } else {
+                R[VM_A()] = arith(OpCode::SUB, b, c);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(MUL) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            int64_t result;
+            if (b.isInt() && c.isInt() && !mulOverflow(b.asInt(), c.asInt(), &result)) {
+                R[VM_A()] = Value::integer(result);
+            } else if (b.isFloat() && c.isFloat()) {
+                R[VM_A()] = Value::number(b.asFloat() * c.asFloat());
+            } else {
+                R[VM_A()] = arith(OpCode::MUL, b, c);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(DIV) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            if (b.isFloat() && c.isFloat() && c.asFloat() != 0.0) {
+                R[VM_A()] = Value::number(b.asFloat() / c.asFloat());
+            } else {
+                R[VM_A()] = arith(OpCode::DIV, b, c);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(MOD) {
+            R[VM_A()] = arith(OpCode::MOD, VM_RB(), VM_RC());
+            VM_NEXT();
+        }
+        VM_CASE(NEG) {
+            Value b = VM_RB();
+            if (b.isInt() && b.asInt() != INT64_MIN) {
+                R[VM_A()] = Value::integer(-b.asInt());
+            } else if (b.isNumber()) {
+                R[VM_A()] = Value::number(-b.asNumber());
+            } else {
+                throw RuntimeError(std::string("no se puede negar un valor de tipo ") + typeName(b));
+            }
+            VM_NEXT();
+        }
+        VM_CASE(NOT) {
+            R[VM_A()] = Value::boolean(!VM_RB().isTruthy());
+            VM_NEXT();
+        }
+        VM_CASE(EQ) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            R[VM_A()] = Value::boolean(b.isInt() && c.isInt() ? b.asInt() == c.asInt() : valuesEqual(b, c));
+            VM_NEXT();
+        }
+        VM_CASE(NE) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            R[VM_A()] = Value::boolean(b.isInt() && c.isInt() ? b.asInt() != c.asInt() : !valuesEqual(b, c));
+            VM_NEXT();
+        }
+        VM_CASE(LT) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            R[VM_A()] = Value::boolean(b.isInt() && c.isInt() ? b.asInt() < c.asInt() : lessThan(b, c, false));
+            VM_NEXT();
+        }
+        VM_CASE(LE) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            R[VM_A()] = Value::boolean(b.isInt() && c.isInt() ? b.asInt() <= c.asInt() : lessThan(b, c, true));
+            VM_NEXT();
+        }
+        VM_CASE(JMP) {
+            pc += argSBx(instr);
+            if (argSBx(instr) < 0) VM_LOOP_BACK();
+            VM_NEXT();
+        }
+        VM_CASE(JMPIF) {
+            if (R[VM_A()].isTruthy()) pc += argSBx(instr);
+            VM_NEXT();
+        }
+        VM_CASE(JMPIFNOT) {
+            if (!R[VM_A()].isTruthy()) pc += argSBx(instr);
+            VM_NEXT();
+        }
+        VM_CASE(FORPREP) {
+            if (!forPrepare(R + VM_A())) pc += argSBx(instr);
+            VM_NEXT();
+        }
+        VM_CASE(FORLOOP) {
+            Value* r = R + VM_A();
+            if (r[0].isInt()) {
+                int64_t step = r[2].asInt();
+                int64_t i;
+                if (!addOverflow(r[0].asInt(), step, &i)) {
+                    r[0] = Value::integer(i);
+                    if (step > 0 ? i < r[1].asInt() : i > r[1].asInt()) {
+                        pc += argSBx(instr);
+                        VM_LOOP_BACK();
+                    }
+                }
+            } else {
+                double step = r[2].asFloat();
+                double i = r[0].asFloat() + step;
+                r[0] = Value::number(i);
+                if (step > 0 ? i < r[1].asFloat() : i > r[1].asFloat()) {
+                    pc += argSBx(instr);
+                    VM_LOOP_BACK();
+                }
+            }
+            VM_NEXT();
+        }
+        VM_CASE(FOREACH) {
+            Value* r = R + VM_A();
+            if (isObjType(r[0], ObjType::TYPED_ARRAY)) {
+                const ObjTypedArray* array = asTypedArray(r[0]);
+                int64_t i = r[1].asInt();
+                if (i < static_cast<int64_t>(array->size())) {
+                    r[2] = array->get(static_cast<size_t>(i));
+                    r[1] = Value::integer(i + 1);
+                } else {
+                    pc += argSBx(instr);
+                }
+            } else if (isObjType(r[0], ObjType::ARRAY)) {
+                const std::vector<Value>& items = asArray(r[0])->items;
+                int64_t i = r[1].asInt();
+                if (i < static_cast<int64_t>(items.size())) {
+                    r[2] = items[static_cast<size_t>(i)];
+                    r[1] = Value::integer(i + 1);
+                } else {
+                    pc += argSBx(instr);
+                }
+            } else if (!forEachStep(r)) {
+                pc += argSBx(instr);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(SWITCH) {
+            // Se aplica directamente el JMP del CASO elegido, sin despacharlo
+            pc += frame->proto->switchTables[argBx(instr)].find(R[VM_A()], K);
+            Instr jump = *pc++;
+            pc += argSBx(jump);
+            if (argSBx(jump) < 0) VM_LOOP_BACK();
+            VM_NEXT();
+        }
+        VM_CASE(CALL) {
+            uint32_t a = VM_A();
+            uint32_t argc = argB(instr);
+            bool hasReceiver = argC(instr) != 0;
+            Value callee = R[a];
+            frame->pc = pc;
+            if (isObjType(callee, ObjType::FUNCTION)) {
+                // Ruta rápida: llamada entre funciones MC++ sin pasar por callValue
+                const FunctionProto* proto = asFunction(callee)->proto;
+                uint32_t base = frame->base + a + 1;
+                if (hasReceiver && !proto->isMethod) {
+                    ++base;
+                    --argc;
+                }
+                pushFrame(proto, base, frame->base + a, argc);
+            } else {
+                callValue(frame->base + a, argc, hasReceiver);
+                // Una nativa suspendió la corrutina: el marco ya guarda dónde continuar
+                if (suspendRequested_) return Value::nil();
+            }
+            // La pila o la lista de marcos pueden haberse reubicado
+            VM_LOAD_FRAME();
+            VM_SAFEPOINT();
+            VM_NEXT();
+        }
+        VM_CASE(TAILCALL) {
+            uint32_t a = VM_A();
+            uint32_t argc = argB(instr);
+            Value callee = R[a];
+            frame->pc = pc;
+            if (isObjType(callee, ObjType::FUNCTION)) {
+                const FunctionProto* proto = asFunction(callee)->proto;
+                uint32_t first = frame->base + a + 1;
+                if (argC(instr) != 0 && !proto->isMethod) {
+                    ++first;
+                    --argc;
+                }
+                replaceFrame(proto, first, argc);
+            } else {
+                // Nativas y clases: una llamada normal, y el RETURN que sigue devuelve su resultado
+                callValue(frame->base + a, argc, argC(instr) != 0);
+                if (suspendRequested_) return Value::nil();
+            }
+            VM_LOAD_FRAME();
+            VM_SAFEPOINT();
+            VM_NEXT();
+        }
+        VM_CASE(PARFOR) {
+            frame->pc = pc;
+            Value results = runParallel(frame->base + VM_A(), argB(instr));
+            // Un PARA PARALELO anidado corre en esta misma pila, que puede haberse reubicado
+            VM_LOAD_FRAME();
+            R[VM_A()] = results;
+            VM_SAFEPOINT();
+            VM_NEXT();
+        }
+        VM_CASE(SELF) {
+            InlineCache& cache = VM_CACHE();
+            Value receiver = VM_RB();
+            const InlineCache::Entry* entry;
+            Value method;
+            if (isObjType(receiver, ObjType::INSTANCE) && (entry = cache.find(asInstance(receiver)->klass)) != nullptr) {
+                method = entry->field == InlineCache::kMethod ? entry->method : asInstance(receiver)->fields[entry->field];
+            } else {
+                method = lookupMethod(receiver, K[argC(instr)], &cache);
+            }
+            R[VM_A() + 1] = receiver;
+            R[VM_A()] = method;
+            VM_NEXT();
+        }
+        VM_CASE(RETURN) {
+            Value result = argB(instr) != 0 ? R[VM_A()] : Value::nil();
+            uint32_t retSlot = frame->retSlot;
+            frames_.pop_back();
+            stack_[retSlot] = result;
+            if (frames_.size() == entryDepth) return result;
+            VM_LOAD_FRAME();
+            VM_NEXT();
+        }
+        VM_CASE(NEWARRAY) {
+            ObjArray* array = heap_.allocate<ObjArray>();
+            const Value* first = &VM_RB();
+            array->items.assign(first, first + argC(instr));
+            R[VM_A()] = Value::object(array);
+            VM_SAFEPOINT();
+            VM_NEXT();
+        }
+        VM_CASE(NEWMAP) {
+            ObjMap* map = heap_.allocate<ObjMap>();
+            const Value* pairs = &VM_RB();
+            for (uint32_t i = 0; i < argC(instr); ++i) {
+                map->set(mapKey(pairs[2 * i]), pairs[2 * i + 1]);
+            }
+            R[VM_A()] = Value::object(map);
+            VM_SAFEPOINT();
+            VM_NEXT();
+        }
+        VM_CASE(GETINDEX) {
+            Value object = VM_RB();
+            Value key = VM_RC();
+            if (isObjType(object, ObjType::ARRAY) && key.isInt() &&
+                static_cast<uint64_t>(key.asInt()) < asArray(object)->items.size()) {
+                R[VM_A()] = asArray(object)->items[static_cast<size_t>(key.asInt())];
+            } else if (isObjType(object, ObjType::TYPED_ARRAY) && key.isInt() &&
+                       static_cast<uint64_t>(key.asInt()) < asTypedArray(object)->size()) {
+                R[VM_A()] = asTypedArray(object)->get(static_cast<size_t>(key.asInt()));
+            } else {
+                R[VM_A()] = getIndex(object, key);
+                VM_SAFEPOINT();
+            }
+            VM_NEXT();
+        }
+        VM_CASE(SETINDEX) {
+            Value object = R[VM_A()];
+            Value key = VM_RB();
+            if (isObjType(object, ObjType::ARRAY) && key.isInt() &&
+                static_cast<uint64_t>(key.asInt()) < asArray(object)->items.size()) {
+                asArray(object)->items[static_cast<size_t>(key.asInt())] = VM_RC();
+                writeBarrier(object.asObj(), VM_RC());
+            } else if (!(isObjType(object, ObjType::TYPED_ARRAY) && key.isInt() &&
+                         static_cast<uint64_t>(key.asInt()) < asTypedArray(object)->size() &&
+                         asTypedArray(object)->set(static_cast<size_t>(key.asInt()), VM_RC()))) {
+                setIndex(object, key, VM_RC());
+            }
+            VM_NEXT();
+        }
+        VM_CASE(GETFIELD) {
+            InlineCache& cache = VM_CACHE();
+            Value object = VM_RB();
+            const InlineCache::Entry* entry;
+            if (isObjType(object, ObjType::INSTANCE) && (entry = cache.find(asInstance(object)->klass)) != nullptr) {
+                R[VM_A()] = entry->field == InlineCache::kMethod ? entry->method : asInstance(object)->fields[entry->field];
+            } else {
+                R[VM_A()] = getField(object, K[argC(instr)], &cache);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(SETFIELD) {
+            InlineCache& cache = VM_CACHE();
+            Value object = R[VM_A()];
+            const InlineCache::Entry* entry;
+            if (isObjType(object, ObjType::INSTANCE) && (entry = cache.find(asInstance(object)->klass)) != nullptr) {
+                asInstance(object)->fields[entry->field] = VM_RC();
+                writeBarrier(object.asObj(), VM_RC());
+            } else {
+                setField(object, K[argB(instr)], VM_RC(), &cache);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(TOTYPED) {
+            R[VM_A()] = toTypedArray(R[VM_A()], static_cast<ElementType>(argB(instr)));
+            VM_SAFEPOINT();
+            VM_NEXT();
+        }
+        VM_CASE(GETTYPED) {
+            // El generador de código ya demostró que el índice está en rango
+            const ObjTypedArray* array = asTypedArray(VM_RB());
+            size_t index = static_cast<size_t>(VM_RC().asInt());
+            R[VM_A()] = array->elementType == ElementType::INT ? Value::integer(array->ints[index])
+                                                               : Value::number(array->floats[index]);
+            VM_NEXT();
+        }
+        VM_CASE(SETTYPED) {
+            ObjTypedArray* array = asTypedArray(R[VM_A()]);
+            size_t index = static_cast<size_t>(VM_RB().asInt());
+            Value value = VM_RC();
+            if (array->elementType == ElementType::INT && value.isInt()) {
+                array->ints[index] = value.asInt();
+            } else if (array->elementType == ElementType::FLOAT && value.isFloat()) {
+                array->floats[index] = value.asFloat();
+            } else if (!array->set(index, value)) {
+                throw typedElementError(array, value);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(EQJMP) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            VM_COMPARE_JUMP(b.isInt() && c.isInt() ? b.asInt() == c.asInt() : valuesEqual(b, c));
+            VM_NEXT();
+        }
+        VM_CASE(NEJMP) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            VM_COMPARE_JUMP(b.isInt() && c.isInt() ? b.asInt() != c.asInt() : !valuesEqual(b, c));
+            VM_NEXT();
+        }
+        VM_CASE(LTJMP) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            VM_COMPARE_JUMP(b.isInt() && c.isInt() ? b.asInt() < c.asInt() : lessThan(b, c, false));
+            VM_NEXT();
+        }
+        VM_CASE(LEJMP) {
+            Value b = VM_RB();
+            Value c = VM_RC();
+            VM_COMPARE_JUMP(b.isInt() && c.isInt() ? b.asInt() <= c.asInt() : lessThan(b, c, true));
+            VM_NEXT();
+        }
+        VM_CASE(LOADIADD) {
+            // LOADI y después el ADD que sigue, que pasa a ser la instrucción en curso
+            R[VM_A()] = Value::integer(argSBx(instr));
+            instr = *pc++;
+            Value b = VM_RB();
+            Value c = VM_RC();
+            int64_t result;
+            if (b.isInt() && c.isInt() && !addOverflow(b.asInt(), c.asInt(), &result)) {
+                R[VM_A()] = Value::integer(result);
+            } else if (b.isFloat() && c.isFloat()) {
+                R[VM_A()] = Value::number(b.asFloat() + c.asFloat());
+            } else {
+                R[VM_A()] = arith(OpCode::ADD, b, c);
+                VM_SAFEPOINT();
+            }
+            VM_NEXT();
+        }
+        VM_CASE(LOADISUB) {
+            R[VM_A()] = Value::integer(argSBx(instr));
+            instr = *pc++;
+            Value b = VM_RB();
+            Value c = VM_RC();
+            int64_t result;
+            if (b.isInt() && c.isInt() && !subOverflow(b.asInt(), c.asInt(), &result)) {
+                R[VM_A()] = Value::integer(result);
+            } else if (b.isFloat() && c.isFloat()) {
+                R[VM_A()] = Value::number(b.asFloat() - c.asFloat());
+            } else {
+                R[VM_A()] = arith(OpCode::SUB, b, c);
+            }
+            VM_NEXT();
+        }
+        VM_CASE(EXTRAARG) {
+            throw RuntimeError("instrucción inválida");
+        }
+
+        VM_LOOP_END
+    } catch (const RuntimeError& error) {
+        raise(error, pc, entryDepth);
+    }
+    return Value::nil();
+
+#undef VM_LOAD_FRAME
+#undef VM_SAFEPOINT
+#undef VM_A
+#undef VM_RB
+#undef VM_RC
+#undef VM_COMPARE_JUMP
+#undef VM_CACHE
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_LOOP_BEGIN
+#undef VM_LOOP_END
+#undef VM_LOOP_BACK
+#ifdef VM_COUNT
+#undef VM_COUNT
+#endif
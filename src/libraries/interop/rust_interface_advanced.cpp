@@ -179,7 +179,7 @@ void RustInterfaceAdvanced::logOperation(const std::string& operation, const std
     for (const auto& [key, value] : params) {
         std::cout << ", " << key << ": " << value;
     }
-    std::cout << ", Result: " << result << std::endl;
+    std::cout << ", Result: " << result << "\n";
 }
 
 // Helper para unir strings
@@ -28,8 +28,8 @@ bool SendLogToCentral(const std::string& node_id, const std::string& log_data) {
     int retry_count = 0;
     while (retry_count < globalConfig.max_retry_attempts) {
         // Simula un envío al servidor central
-        std::cout << "[INFO] Enviando log al servidor central desde nodo: " << node_id << std::endl;
-        std::cout << log_data << std::endl;
+        std::cout << "[INFO] Enviando log al servidor central desde nodo: " << node_id << "\n";
+        std::cout << log_data << "\n";
 
         // Simular éxito en el envío
         return true;
@@ -45,7 +45,7 @@ bool SendLogToCentral(const std::string& node_id, const std::string& log_data) {
 std::vector<std::string> QueryCentralLogs(const std::map<std::string, std::string>& filters) {
     std::cout << "[INFO] Consultando logs del servidor central con filtros:" << std::endl;
     for (const auto& [key, value] : filters) {
-        std::cout << key << ": " << value << std::endl;
+        std::cout << key << ": " << value << "\n";
     }
 
     // Retorna una simulación de resultados
@@ -0,0 +1,299 @@
+#include "gemm.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MC_GEMM_X86 1
+#endif
+
+namespace {
+
+    // Un panel de A (MC x KC) cabe en L2, uno de B (KC x NR) en L1 y el bloque de B (KC x NC) en L3
+    constexpr std::size_t kKC = 256;
+    constexpr std::size_t kMC = 120;        // múltiplo de todos los MR
+    constexpr std::size_t kNC = 3072;
+    constexpr std::size_t kTaskCols = 192;  // columnas de C por tarea; múltiplo de todos los NR y divisor de kNC
+    constexpr std::size_t kMaxTile = 6 * 16;
+
+    // Por debajo de este número de multiplicaciones no compensa despertar a los hilos
+    constexpr std::size_t kParallelThreshold = std::size_t(1) << 21;
+
+    // Calcula la tesela MR x NR de A * B a partir de los paneles empaquetados; la escribe en c
+    // o, con accumulate, la suma a lo que ya hay
+    using MicroKernel = void (*)(std::size_t kc, const float* a, const float* b, float* c, std::size_t ldc,
+                                 bool accumulate);
+
+    struct KernelShape {
+        std::size_t mr;
+        std::size_t nr;
+        MicroKernel run;
+    };
+
+    template <std::size_t MR, std::size_t NR>
+    void micro_kernel_scalar(std::size_t kc, const float* a, const float* b, float* c, std::size_t ldc,
+                             bool accumulate) {
+        float acc[MR][NR] = {};
+        for (std::size_t k = 0; k < kc; k++) {
+            for (std::size_t i = 0; i < MR; i++) {
+                for (std::size_t j = 0; j < NR; j++) {
+                    acc[i][j] += a[i] * b[j];
+                }
+            }
+            a += MR;
+            b += NR;
+        }
+        for (std::size_t i = 0; i < MR; i++) {
+            for (std::size_t j = 0; j < NR; j++) {
+                c[i * ldc + j] = accumulate ? c[i * ldc + j] + acc[i][j] : acc[i][j];
+            }
+        }
+    }
+
+#ifdef MC_GEMM_X86
+    // 4 x 8: ocho acumuladores de 4 floats. Los acumuladores son variables sueltas (no un array)
+    // para que el compilador los mantenga en registros
+    __attribute__((target("sse"))) void micro_kernel_sse(std::size_t kc, const float* a, const float* b, float* c,
+                                                         std::size_t ldc, bool accumulate) {
+        __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps(), c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+        __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps(), c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+        for (std::size_t k = 0; k < kc; k++) {
+            __m128 b0 = _mm_loadu_ps(b);
+            __m128 b1 = _mm_loadu_ps(b + 4);
+            __m128 ai = _mm_set1_ps(a[0]);
+            c00 = _mm_add_ps(c00, _mm_mul_ps(ai, b0));
+            c01 = _mm_add_ps(c01, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[1]);
+            c10 = _mm_add_ps(c10, _mm_mul_ps(ai, b0));
+            c11 = _mm_add_ps(c11, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[2]);
+            c20 = _mm_add_ps(c20, _mm_mul_ps(ai, b0));
+            c21 = _mm_add_ps(c21, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[3]);
+            c30 = _mm_add_ps(c30, _mm_mul_ps(ai, b0));
+            c31 = _mm_add_ps(c31, _mm_mul_ps(ai, b1));
+            a += 4;
+            b += 8;
+        }
+        __m128 rows[4][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+        for (int i = 0; i < 4; i++) {
+            float* row = c + i * ldc;
+            if (accumulate) {
+                rows[i][0] = _mm_add_ps(rows[i][0], _mm_loadu_ps(row));
+                rows[i][1] = _mm_add_ps(rows[i][1], _mm_loadu_ps(row + 4));
+            }
+            _mm_storeu_ps(row, rows[i][0]);
+            _mm_storeu_ps(row + 4, rows[i][1]);
+        }
+    }
+
+    // 6 x 16: doce acumuladores de 8 floats más los dos vectores de B caben en los 16 registros ymm
+    __attribute__((target("avx2,fma"))) void micro_kernel_avx2(std::size_t kc, const float* a, const float* b,
+                                                               float* c, std::size_t ldc, bool accumulate) {
+        __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps(), c10 = _mm256_setzero_ps();
+        __m256 c11 = _mm256_setzero_ps(), c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+        __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps(), c40 = _mm256_setzero_ps();
+        __m256 c41 = _mm256_setzero_ps(), c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+        for (std::size_t k = 0; k < kc; k++) {
+            __m256 b0 = _mm256_loadu_ps(b);
+            __m256 b1 = _mm256_loadu_ps(b + 8);
+            __m256 ai = _mm256_broadcast_ss(a);
+            c00 = _mm256_fmadd_ps(ai, b0, c00);
+            c01 = _mm256_fmadd_ps(ai, b1, c01);
+            ai = _mm256_broadcast_ss(a + 1);
+            c10 = _mm256_fmadd_ps(ai, b0, c10);
+            c11 = _mm256_fmadd_ps(ai, b1, c11);
+            ai = _mm256_broadcast_ss(a + 2);
+            c20 = _mm256_fmadd_ps(ai, b0, c20);
+            c21 = _mm256_fmadd_ps(ai, b1, c21);
+            ai = _mm256_broadcast_ss(a + 3);
+            c30 = _mm256_fmadd_ps(ai, b0, c30);
+            c31 = _mm256_fmadd_ps(ai, b1, c31);
+            ai = _mm256_broadcast_ss(a + 4);
+            c40 = _mm256_fmadd_ps(ai, b0, c40);
+            c41 = _mm256_fmadd_ps(ai, b1, c41);
+            ai = _mm256_broadcast_ss(a + 5);
+            c50 = _mm256_fmadd_ps(ai, b0, c50);
+            c51 = _mm256_fmadd_ps(ai, b1, c51);
+            a += 6;
+            b += 16;
+        }
+        __m256 rows[6][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+        for (int i = 0; i < 6; i++) {
+            float* row = c + i * ldc;
+            if (accumulate) {
+                rows[i][0] = _mm256_add_ps(rows[i][0], _mm256_loadu_ps(row));
+                rows[i][1] = _mm256_add_ps(rows[i][1], _mm256_loadu_ps(row + 8));
+            }
+            _mm256_storeu_ps(row, rows[i][0]);
+            _mm256_storeu_ps(row + 8, rows[i][1]);
+        }
+    }
+#endif
+
+    KernelShape shape_for(GemmKernel kernel) {
+        switch (kernel) {
+#ifdef MC_GEMM_X86
+            case GemmKernel::AVX2: return {6, 16, micro_kernel_avx2};
+            case GemmKernel::SSE: return {4, 8, micro_kernel_sse};
+#endif
+            default: return {4, 4, micro_kernel_scalar<4, 4>};
+        }
+    }
+
+    // Panel de A: mr filas x kc, guardado columna a columna (k, luego i), multiplicado por scale
+    // y relleno con ceros
+    void pack_a_panel(MatrixView<const float> a, std::size_t row0, std::size_t k0, std::size_t kc, std::size_t mr,
+                      float scale, float* out) {
+        std::size_t rows = std::min(mr, a.rows() - row0);
+        for (std::size_t i = 0; i < rows; i++) {
+            for (std::size_t k = 0; k < kc; k++) {
+                out[k * mr + i] = scale * a(row0 + i, k0 + k);
+            }
+        }
+        for (std::size_t i = rows; i < mr; i++) {
+            for (std::size_t k = 0; k < kc; k++) {
+                out[k * mr + i] = 0.0f;
+            }
+        }
+    }
+
+    // Panel de B: kc x nr, guardado fila a fila y relleno con ceros
+    void pack_b_panel(MatrixView<const float> b, std::size_t k0, std::size_t kc, std::size_t col0, std::size_t nr,
+                      float* out) {
+        std::size_t cols = std::min(nr, b.cols() - col0);
+        for (std::size_t k = 0; k < kc; k++) {
+            for (std::size_t j = 0; j < cols; j++) {
+                out[k * nr + j] = b(k0 + k, col0 + j);
+            }
+            for (std::size_t j = cols; j < nr; j++) {
+                out[k * nr + j] = 0.0f;
+            }
+        }
+    }
+
+    std::atomic<int> active_kernel{-1};
+
+    // C = A * B o, con subtract, C -= A * B (A se empaqueta cambiada de signo y se acumula siempre)
+    void run_gemm(MatrixView<const float> a, MatrixView<const float> b, MatrixView<float> c, bool subtract) {
+        if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+            throw std::invalid_argument("Error: Las dimensiones de las matrices no permiten la multiplicación.");
+        }
+        if (!c.has_contiguous_rows()) {
+            throw std::invalid_argument("Error: La matriz de salida debe tener filas contiguas.");
+        }
+
+        std::size_t m = a.rows();
+        std::size_t n = b.cols();
+        std::size_t inner = a.cols();
+        if (m == 0 || n == 0 || (inner == 0 && subtract)) return;
+        if (inner == 0) {
+            for (std::size_t i = 0; i < m; i++) std::fill(c.row(i), c.row(i) + n, 0.0f);
+            return;
+        }
+
+        KernelShape shape = shape_for(Gemm::kernel());
+        std::size_t ldc = static_cast<std::size_t>(c.row_stride());
+        std::size_t a_panels = (m + shape.mr - 1) / shape.mr;
+        std::size_t max_kc = std::min(inner, kKC);
+        std::size_t max_nc = std::min(n, kNC);
+        std::vector<float> packed_a(a_panels * shape.mr * max_kc);
+        std::vector<float> packed_b((max_nc + shape.nr - 1) / shape.nr * shape.nr * max_kc);
+
+        MathThreadPool::Lease lease(MathThreadPool::thread_count() > 1 && m * n * inner >= kParallelThreshold);
+        for (std::size_t jc = 0; jc < n; jc += kNC) {
+            std::size_t nc = std::min(kNC, n - jc);
+            std::size_t b_panels = (nc + shape.nr - 1) / shape.nr;
+            for (std::size_t pc = 0; pc < inner; pc += kKC) {
+                std::size_t kc = std::min(kKC, inner - pc);
+                bool accumulate = subtract || pc > 0;
+
+                lease.for_each(b_panels, [&](std::size_t q) {
+                    pack_b_panel(b, pc, kc, jc + q * shape.nr, shape.nr, packed_b.data() + q * shape.nr * kc);
+                });
+                lease.for_each(a_panels, [&](std::size_t p) {
+                    pack_a_panel(a, p * shape.mr, pc, kc, shape.mr, subtract ? -1.0f : 1.0f,
+                                 packed_a.data() + p * shape.mr * kc);
+                });
+
+                // Cada tarea es un bloque de kMC filas x kTaskCols columnas de C; dentro, el panel de B
+                // se queda en L1 mientras se recorren los de A
+                std::size_t row_blocks = (m + kMC - 1) / kMC;
+                std::size_t col_blocks = (nc + kTaskCols - 1) / kTaskCols;
+                lease.for_each(row_blocks * col_blocks, [&](std::size_t task) {
+                    std::size_t row_begin = task / col_blocks * kMC;
+                    std::size_t row_end = std::min(m, row_begin + kMC);
+                    std::size_t col_begin = task % col_blocks * kTaskCols;
+                    std::size_t col_end = std::min(nc, col_begin + kTaskCols);
+                    float tile[kMaxTile];
+                    for (std::size_t jr = col_begin; jr < col_end; jr += shape.nr) {
+                        const float* b_panel = packed_b.data() + jr / shape.nr * shape.nr * kc;
+                        std::size_t cols = std::min(shape.nr, col_end - jr);
+                        for (std::size_t ir = row_begin; ir < row_end; ir += shape.mr) {
+                            const float* a_panel = packed_a.data() + ir / shape.mr * shape.mr * kc;
+                            std::size_t rows = std::min(shape.mr, row_end - ir);
+                            float* out = c.row(ir) + jc + jr;
+                            if (rows == shape.mr && cols == shape.nr) {
+                                shape.run(kc, a_panel, b_panel, out, ldc, accumulate);
+                                continue;
+                            }
+                            // Tesela del borde: se calcula completa aparte y se copia la parte válida
+                            shape.run(kc, a_panel, b_panel, tile, shape.nr, false);
+                            for (std::size_t i = 0; i < rows; i++) {
+                                for (std::size_t j = 0; j < cols; j++) {
+                                    float value = tile[i * shape.nr + j];
+                                    out[i * ldc + j] = accumulate ? out[i * ldc + j] + value : value;
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+} // namespace
+
+void Gemm::multiply(MatrixView<const float> a, MatrixView<const float> b, MatrixView<float> c) {
+    run_gemm(a, b, c, false);
+}
+
+void Gemm::multiply_subtract(MatrixView<const float> a, MatrixView<const float> b, MatrixView<float> c) {
+    run_gemm(a, b, c, true);
+}
+
+GemmKernel Gemm::detect_kernel() {
+#ifdef MC_GEMM_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return GemmKernel::AVX2;
+    if (__builtin_cpu_supports("sse")) return GemmKernel::SSE;
+#endif
+    return GemmKernel::SCALAR;
+}
+
+GemmKernel Gemm::kernel() {
+    int current = active_kernel.load(std::memory_order_relaxed);
+    if (current < 0) {
+        current = static_cast<int>(detect_kernel());
+        active_kernel.store(current, std::memory_order_relaxed);
+    }
+    return static_cast<GemmKernel>(current);
+}
+
+void Gemm::set_kernel(GemmKernel kernel) {
+    if (static_cast<int>(kernel) > static_cast<int>(detect_kernel())) {
+        throw std::invalid_argument("Error: La CPU no admite el micro-núcleo GEMM solicitado.");
+    }
+    active_kernel.store(static_cast<int>(kernel), std::memory_order_relaxed);
+}
+
+void Gemm::set_thread_count(std::size_t threads) {
+    MathThreadPool::set_thread_count(threads);
+}
+
+std::size_t Gemm::thread_count() {
+    return MathThreadPool::thread_count();
+}
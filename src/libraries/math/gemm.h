@@ -0,0 +1,63 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "matrix.h"
+#include <cstddef>
+
+/**
+ * @file gemm.h
+ * @brief Multiplicación de matrices de precisión simple (GEMM) para LinearAlgebraAdvanced.
+ *
+ * Sigue el esquema por bloques clásico: B se empaqueta en paneles de KC x NR y A en paneles
+ * de MC x KC, de forma que el micro-núcleo lee ambos operandos de forma consecutiva desde la
+ * caché, y cada tesela MR x NR de C se acumula en registros. El empaquetado lee a través de
+ * los pasos de la vista, así que un operando transpuesto o un sub-bloque no se copia antes.
+ *
+ * El micro-núcleo se elige en tiempo de ejecución según CPUID: AVX2 + FMA (6 x 16), SSE (4 x 8)
+ * o escalar (4 x 4). Las teselas de cada bloque se reparten entre los hilos del grupo de la
+ * librería (MathThreadPool, thread_pool.h).
+ */
+
+/**
+ * @enum GemmKernel
+ * @brief Micro-núcleos disponibles, del más general al más rápido.
+ */
+enum class GemmKernel { SCALAR, SSE, AVX2 };
+
+class Gemm {
+public:
+    /**
+     * @brief Calcula C = A * B.
+     *
+     * @param a Matriz de rows x inner; admite cualquier paso.
+     * @param b Matriz de inner x cols; admite cualquier paso.
+     * @param c Matriz de salida de rows x cols con filas contiguas; no debe solaparse con a ni con b.
+     * @throws std::invalid_argument Si las dimensiones no coinciden o las filas de c no son contiguas.
+     */
+    static void multiply(MatrixView<const float> a, MatrixView<const float> b, MatrixView<float> c);
+
+    /**
+     * @brief Calcula C -= A * B (la actualización de la submatriz restante en la LU por bloques).
+     * @throws std::invalid_argument En los mismos casos que multiply.
+     */
+    static void multiply_subtract(MatrixView<const float> a, MatrixView<const float> b, MatrixView<float> c);
+
+    // El mejor micro-núcleo que admite la CPU (CPUID)
+    static GemmKernel detect_kernel();
+
+    // Micro-núcleo en uso; por defecto, detect_kernel()
+    static GemmKernel kernel();
+
+    /**
+     * @brief Fuerza un micro-núcleo (para pruebas y mediciones).
+     * @throws std::invalid_argument Si la CPU no lo admite.
+     */
+    static void set_kernel(GemmKernel kernel);
+
+    // Hilos que reparten las teselas; es el mismo valor que MathThreadPool::set_thread_count.
+    // 0 vuelve al valor por defecto (std::thread::hardware_concurrency)
+    static void set_thread_count(std::size_t threads);
+    static std::size_t thread_count();
+};
+
+#endif // GEMM_H
@@ -1,86 +1,214 @@
 #include "linear_algebra.h"
+#include "linear_algebra_advanced.h"
+#include "lu_factorization.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 // Adición de matrices
+void LinearAlgebra::matrix_add(MatrixView<const int> matrix1, MatrixView<const int> matrix2, Matrix<int>& result) {
+    std::size_t rows = matrix1.rows();
+    std::size_t cols = matrix1.cols();
+
+    if (rows != matrix2.rows() || cols != matrix2.cols()) {
+        throw std::invalid_argument("Error: Las dimensiones de las matrices no coinciden para la adición.");
+    }
+
+    // Se escribe en una matriz nueva: result puede ser una de las entradas
+    Matrix<int> sum(rows, cols);
+    for (std::size_t i = 0; i < rows; i++) {
+        int* out = sum.row(i);
+        for (std::size_t j = 0; j < cols; j++) {
+            out[j] = matrix1(i, j) + matrix2(i, j);
+        }
+    }
+    result = std::move(sum);
+}
+
 void LinearAlgebra::matrix_add(const std::vector<std::vector<int>>& matrix1,
                                const std::vector<std::vector<int>>& matrix2,
                                std::vector<std::vector<int>>& result) {
-    int rows = matrix1.size();
-    int cols = matrix1[0].size();
+    Matrix<int> sum;
+    matrix_add(Matrix<int>(matrix1), Matrix<int>(matrix2), sum);
+    result = sum.to_nested();
+}
 
-    if (rows != matrix2.size() || cols != matrix2[0].size()) {
-        throw std::invalid_argument("Error: Las dimensiones de las matrices no coinciden para la adición.");
-    }
+namespace {
+
+    // Eliminación de Bareiss sobre la copia m: tras el paso k, m(i, j) es el menor de orden k + 1
+    // formado por las filas 0..k, i y las columnas 0..k, j, así que la división entre el pivote
+    // anterior es exacta y los valores no crecen más que los menores de la matriz
+    std::int64_t bareiss_determinant(Matrix<std::int64_t>& m) {
+        std::size_t n = m.rows();
+        if (n == 0) return 1;
+
+        bool negate = false;
+        std::int64_t previous = 1;
+        for (std::size_t k = 0; k + 1 < n; k++) {
+            if (m(k, k) == 0) {
+                std::size_t pivot = k + 1;
+                while (pivot < n && m(pivot, k) == 0) pivot++;
+                if (pivot == n) return 0;
+                std::swap_ranges(m.row(k), m.row(k) + n, m.row(pivot));
+                negate = !negate;
+            }
+            std::int64_t pivot = m(k, k);
+            const std::int64_t* pivot_row = m.row(k);
+            for (std::size_t i = k + 1; i < n; i++) {
+                std::int64_t* row = m.row(i);
+                std::int64_t factor = row[k];
+                for (std::size_t j = k + 1; j < n; j++) {
+#ifdef __SIZEOF_INT128__
+                    __int128 value = (static_cast<__int128>(row[j]) * pivot -
+                                      static_cast<__int128>(factor) * pivot_row[j]) / previous;
+                    if (value > std::numeric_limits<std::int64_t>::max() ||
+                        value < std::numeric_limits<std::int64_t>::min()) {
+                        throw std::overflow_error("Error: El determinante excede el rango de int64_t.");
+                    }
+                    row[j] = static_cast<std::int64_t>(value);
+#else
+                    // Sin __int128 se exige que también los productos quepan en 64 bits
+                    std::int64_t a, b, difference;
+                    if (__builtin_mul_overflow(row[j], pivot, &a) || __builtin_mul_overflow(factor, pivot_row[j], &b) ||
+                        __builtin_sub_overflow(a, b, &difference)) {
+                        throw std::overflow_error("Error: El determinante excede el rango de int64_t.");
+                    }
+                    row[j] = difference / previous;
+#endif
+                }
+            }
+            previous = pivot;
+        }
 
-    result.resize(rows, std::vector<int>(cols));
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            result[i][j] = matrix1[i][j] + matrix2[i][j];
+        std::int64_t det = m(n - 1, n - 1);
+        if (negate) {
+            if (det == std::numeric_limits<std::int64_t>::min()) {
+                throw std::overflow_error("Error: El determinante excede el rango de int64_t.");
+            }
+            det = -det;
         }
+        return det;
     }
+
+} // namespace
+
+// Determinante de matriz cuadrada de enteros (Bareiss, exacto)
+int LinearAlgebra::matrix_determinant(MatrixView<const int> matrix) {
+    if (matrix.rows() != matrix.cols()) {
+        throw std::invalid_argument("Error: La matriz debe ser cuadrada para calcular el determinante.");
+    }
+
+    Matrix<std::int64_t> wide(matrix.rows(), matrix.cols());
+    for (std::size_t i = 0; i < matrix.rows(); i++) {
+        for (std::size_t j = 0; j < matrix.cols(); j++) wide(i, j) = matrix(i, j);
+    }
+    std::int64_t det = bareiss_determinant(wide);
+    if (det > std::numeric_limits<int>::max() || det < std::numeric_limits<int>::min()) {
+        throw std::overflow_error("Error: El determinante excede el rango de int.");
+    }
+    return static_cast<int>(det);
 }
 
-// Determinante de matriz cuadrada
-int LinearAlgebra::matrix_determinant(const std::vector<std::vector<int>>& matrix) {
-    int n = matrix.size();
-    if (n != matrix[0].size()) {
+std::int64_t LinearAlgebra::matrix_determinant(MatrixView<const std::int64_t> matrix) {
+    if (matrix.rows() != matrix.cols()) {
         throw std::invalid_argument("Error: La matriz debe ser cuadrada para calcular el determinante.");
     }
+    Matrix<std::int64_t> copy(matrix);
+    return bareiss_determinant(copy);
+}
 
-    if (n == 1) return matrix[0][0];
-    if (n == 2) return matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
-
-    // Implementación recursiva para determinantes pequeños
-    int det = 0;
-    for (int col = 0; col < n; col++) {
-        std::vector<std::vector<int>> submatrix(n - 1, std::vector<int>(n - 1));
-        for (int i = 1; i < n; i++) {
-            int sub_col = 0;
-            for (int j = 0; j < n; j++) {
-                if (j == col) continue;
-                submatrix[i - 1][sub_col] = matrix[i][j];
-                sub_col++;
-            }
-        }
-        det += ((col % 2 == 0) ? 1 : -1) * matrix[0][col] * matrix_determinant(submatrix);
+// Determinante en coma flotante: producto de la diagonal de U con el signo de la permutación
+float LinearAlgebra::matrix_determinant(MatrixView<const float> matrix) {
+    if (matrix.rows() != matrix.cols()) {
+        throw std::invalid_argument("Error: La matriz debe ser cuadrada para calcular el determinante.");
     }
-    return det;
+    return LUFactorization(matrix).determinant();
+}
+
+int LinearAlgebra::matrix_determinant(const std::vector<std::vector<int>>& matrix) {
+    return matrix_determinant(Matrix<int>(matrix));
 }
 
 // Multiplicación de matrices
-void LinearAlgebra::matrix_multiply(const std::vector<std::vector<int>>& matrix1,
-                                    const std::vector<std::vector<int>>& matrix2,
-                                    std::vector<std::vector<int>>& result) {
-    int rows1 = matrix1.size();
-    int cols1 = matrix1[0].size();
-    int rows2 = matrix2.size();
-    int cols2 = matrix2[0].size();
+void LinearAlgebra::matrix_multiply(MatrixView<const int> matrix1, MatrixView<const int> matrix2,
+                                    Matrix<int>& result) {
+    std::size_t rows1 = matrix1.rows();
+    std::size_t cols1 = matrix1.cols();
+    std::size_t cols2 = matrix2.cols();
 
-    if (cols1 != rows2) {
+    if (cols1 != matrix2.rows()) {
         throw std::invalid_argument("Error: Dimensiones incompatibles para multiplicación.");
     }
 
-    result.resize(rows1, std::vector<int>(cols2, 0));
-    for (int i = 0; i < rows1; i++) {
-        for (int j = 0; j < cols2; j++) {
-            for (int k = 0; k < cols1; k++) {
-                result[i][j] += matrix1[i][k] * matrix2[k][j];
+    // Orden i-k-j: la fila de salida y la fila k de matrix2 se recorren de forma consecutiva
+    Matrix<int> product(rows1, cols2, 0);
+    for (std::size_t i = 0; i < rows1; i++) {
+        int* out = product.row(i);
+        for (std::size_t k = 0; k < cols1; k++) {
+            int a = matrix1(i, k);
+            if (matrix2.has_contiguous_rows()) {
+                const int* b = matrix2.row(k);
+                for (std::size_t j = 0; j < cols2; j++) {
+                    out[j] += a * b[j];
+                }
+            } else {
+                for (std::size_t j = 0; j < cols2; j++) {
+                    out[j] += a * matrix2(k, j);
+                }
             }
         }
     }
+    result = std::move(product);
+}
+
+void LinearAlgebra::matrix_multiply(const std::vector<std::vector<int>>& matrix1,
+                                    const std::vector<std::vector<int>>& matrix2,
+                                    std::vector<std::vector<int>>& result) {
+    Matrix<int> product;
+    matrix_multiply(Matrix<int>(matrix1), Matrix<int>(matrix2), product);
+    result = product.to_nested();
 }
 
 // Transposición de matriz
+void LinearAlgebra::matrix_transpose(MatrixView<const int> matrix, Matrix<int>& result) {
+    Matrix<int> transposed(matrix.transposed());
+    result = std::move(transposed);
+}
+
 void LinearAlgebra::matrix_transpose(const std::vector<std::vector<int>>& matrix,
                                      std::vector<std::vector<int>>& result) {
-    int rows = matrix.size();
-    int cols = matrix[0].size();
+    Matrix<int> transposed;
+    matrix_transpose(Matrix<int>(matrix), transposed);
+    result = transposed.to_nested();
+}
 
-    result.resize(cols, std::vector<int>(rows));
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            result[j][i] = matrix[i][j];
-        }
+// Normalización de vectores
+std::vector<float> LinearAlgebra::normalize_vector(const std::vector<float>& vector) {
+    float magnitude = 0;
+    for (float value : vector) {
+        magnitude += value * value;
+    }
+    magnitude = std::sqrt(magnitude);
+    if (magnitude == 0) {
+        throw std::invalid_argument("Error: No se puede normalizar un vector de magnitud cero.");
     }
+
+    std::vector<float> normalized(vector.size());
+    for (std::size_t i = 0; i < vector.size(); i++) {
+        normalized[i] = vector[i] / magnitude;
+    }
+    return normalized;
+}
+
+// Inversa de matriz cuadrada (la calcula LinearAlgebraAdvanced)
+void LinearAlgebra::matrix_inverse(MatrixView<const float> matrix, Matrix<float>& result) {
+    LinearAlgebraAdvanced::matrix_inverse(matrix, result);
+}
+
+void LinearAlgebra::matrix_inverse(const std::vector<std::vector<float>>& matrix,
+                                   std::vector<std::vector<float>>& result) {
+    LinearAlgebraAdvanced::matrix_inverse(matrix, result);
 }
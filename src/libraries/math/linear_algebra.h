@@ -1,6 +1,8 @@
 #ifndef LINEAR_ALGEBRA_H
 #define LINEAR_ALGEBRA_H
 
+#include "matrix.h"
+#include <cstdint>
 #include <vector>
 
 /**
@@ -9,9 +11,77 @@
  * 
  * Este módulo proporciona operaciones comunes de álgebra lineal, como suma, multiplicación y determinantes,
  * además de utilidades como transposición y normalización de vectores.
+ *
+ * Las operaciones trabajan sobre MatrixView (matrix.h), así que aceptan una Matrix, un sub-bloque o una
+ * transpuesta sin copiarlos. Las firmas con std::vector<std::vector<T>> se conservan como adaptadores
+ * que copian a una Matrix contigua y devuelven el resultado en la forma anidada.
  */
 class LinearAlgebra {
 public:
+    /**
+     * Realiza la suma de dos matrices.
+     * @param matrix1 Primera matriz.
+     * @param matrix2 Segunda matriz.
+     * @param result Matriz donde se almacenará el resultado de la suma.
+     * @throw std::invalid_argument Si las dimensiones de las matrices no coinciden.
+     */
+    static void matrix_add(MatrixView<const int> matrix1, MatrixView<const int> matrix2, Matrix<int>& result);
+
+    /**
+     * Calcula el determinante exacto de una matriz cuadrada de enteros, en O(n³), por eliminación
+     * de Bareiss sin fracciones sobre int64_t.
+     * @param matrix Matriz de la cual se calculará el determinante.
+     * @return El determinante de la matriz.
+     * @throw std::invalid_argument Si la matriz no es cuadrada.
+     * @throw std::overflow_error Si el determinante no cabe en un int o algún paso intermedio en un int64_t.
+     */
+    static int matrix_determinant(MatrixView<const int> matrix);
+
+    /**
+     * Calcula el determinante exacto de una matriz cuadrada de enteros de 64 bits (Bareiss). Cada
+     * paso multiplica en __int128 y divide de forma exacta, así que sólo desborda si un menor de la
+     * matriz no cabe en int64_t.
+     * @param matrix Matriz de la cual se calculará el determinante.
+     * @return El determinante de la matriz.
+     * @throw std::invalid_argument Si la matriz no es cuadrada.
+     * @throw std::overflow_error Si el determinante o algún paso intermedio no cabe en un int64_t.
+     */
+    static std::int64_t matrix_determinant(MatrixView<const std::int64_t> matrix);
+
+    /**
+     * Calcula el determinante de una matriz cuadrada en coma flotante a partir de su
+     * factorización LU con pivoteo parcial (LUFactorization), en O(n³).
+     * @param matrix Matriz de la cual se calculará el determinante.
+     * @return El determinante de la matriz (0 si es singular).
+     * @throw std::invalid_argument Si la matriz no es cuadrada.
+     */
+    static float matrix_determinant(MatrixView<const float> matrix);
+
+    /**
+     * Realiza la multiplicación de dos matrices.
+     * @param matrix1 Primera matriz.
+     * @param matrix2 Segunda matriz.
+     * @param result Matriz donde se almacenará el resultado de la multiplicación.
+     * @throw std::invalid_argument Si las dimensiones de las matrices no son compatibles.
+     */
+    static void matrix_multiply(MatrixView<const int> matrix1, MatrixView<const int> matrix2, Matrix<int>& result);
+
+    /**
+     * Copia la transposición de una matriz. Para leerla sin copiar basta con matrix.transposed().
+     * @param matrix Matriz a transponer.
+     * @param result Matriz donde se almacenará la transposición.
+     */
+    static void matrix_transpose(MatrixView<const int> matrix, Matrix<int>& result);
+
+    /**
+     * Calcula la inversa de una matriz cuadrada.
+     * @param matrix Matriz cuadrada a invertir.
+     * @param result Matriz donde se almacenará la inversa.
+     * @throw std::invalid_argument Si la matriz no es cuadrada.
+     * @throw std::runtime_error Si la matriz no es invertible.
+     */
+    static void matrix_inverse(MatrixView<const float> matrix, Matrix<float>& result);
+
     /**
      * Realiza la suma de dos matrices.
      * @param matrix1 Primera matriz.
@@ -28,6 +98,7 @@ public:
      * @param matrix Matriz de la cual se calculará el determinante.
      * @return El determinante de la matriz.
      * @throw std::invalid_argument Si la matriz no es cuadrada.
+     * @throw std::overflow_error Si el determinante no cabe en un int.
      */
     static int matrix_determinant(const std::vector<std::vector<int>>& matrix);
 
@@ -62,7 +133,8 @@ public:
      * Calcula la inversa de una matriz cuadrada.
      * @param matrix Matriz cuadrada a invertir.
      * @param result Matriz donde se almacenará la inversa.
-     * @throw std::invalid_argument Si la matriz no es cuadrada o no es invertible.
+     * @throw std::invalid_argument Si la matriz no es cuadrada.
+     * @throw std::runtime_error Si la matriz no es invertible.
      */
     static void matrix_inverse(const std::vector<std::vector<float>>& matrix,
                                std::vector<std::vector<float>>& result);
@@ -1,6 +1,7 @@
 #ifndef LINEAR_ALGEBRA_ADVANCED_H
 #define LINEAR_ALGEBRA_ADVANCED_H
 
+#include "matrix.h"
 #include <vector>
 
 /**
@@ -9,10 +10,52 @@
  * 
  * Este módulo proporciona operaciones como multiplicación de matrices,
  * cálculo de inversas y descomposición LU, optimizadas para aplicaciones de alto rendimiento.
+ * Igual que en LinearAlgebra, las entradas son MatrixView y las firmas con std::vector<std::vector<float>>
+ * son adaptadores que copian a una Matrix contigua.
  */
 
 class LinearAlgebraAdvanced {
 public:
+    /**
+     * @brief Multiplica dos matrices.
+     *
+     * Usa Gemm::multiply (gemm.h): bloques empaquetados, micro-núcleo SIMD elegido por CPUID y
+     * teselas repartidas entre hilos.
+     *
+     * @param matrix1 Primer operando; puede ser un sub-bloque o una transpuesta.
+     * @param matrix2 Segundo operando; puede ser un sub-bloque o una transpuesta.
+     * @param result Matriz de salida donde se almacenará el resultado.
+     * @throws std::invalid_argument Si las dimensiones no permiten la multiplicación.
+     */
+    static void matrix_multiply(MatrixView<const float> matrix1, MatrixView<const float> matrix2,
+                                Matrix<float>& result);
+
+    /**
+     * @brief Calcula la inversa de una matriz cuadrada.
+     *
+     * @param matrix Matriz de entrada, debe ser cuadrada.
+     * @param result Matriz de salida donde se almacenará la inversa.
+     * @throws std::invalid_argument Si la matriz no es cuadrada.
+     * @throws std::runtime_error Si la matriz es singular y no tiene inversa.
+     */
+    static void matrix_inverse(MatrixView<const float> matrix, Matrix<float>& result);
+
+    /**
+     * @brief Realiza la descomposición LU de una matriz cuadrada, con pivoteo parcial.
+     *
+     * Para resolver varios sistemas con la misma matriz conviene usar LUFactorization
+     * (lu_factorization.h) directamente: se factoriza una vez y cada solve cuesta O(n²).
+     *
+     * @param matrix Matriz de entrada, debe ser cuadrada.
+     * @param P Matriz de permutación de salida, tal que P * matrix = L * U.
+     * @param L Matriz triangular inferior de salida, de diagonal unitaria.
+     * @param U Matriz triangular superior de salida.
+     * @throws std::invalid_argument Si la matriz no es cuadrada.
+     * @throws std::runtime_error Si la matriz es singular.
+     */
+    static void matrix_lu_decomposition(MatrixView<const float> matrix, Matrix<float>& P, Matrix<float>& L,
+                                        Matrix<float>& U);
+
     /**
      * @brief Multiplica dos matrices.
      * 
@@ -37,15 +80,17 @@ public:
                                 std::vector<std::vector<float>>& result);
 
     /**
-     * @brief Realiza la descomposición LU de una matriz cuadrada.
+     * @brief Realiza la descomposición LU de una matriz cuadrada, con pivoteo parcial.
      * 
      * @param matrix Matriz de entrada, debe ser cuadrada.
-     * @param L Matriz triangular inferior de salida.
+     * @param P Matriz de permutación de salida (P * matrix = L * U).
+     * @param L Matriz triangular inferior de salida, de diagonal unitaria.
      * @param U Matriz triangular superior de salida.
      * @throws std::invalid_argument Si la matriz no es cuadrada.
-     * @throws std::runtime_error Si se encuentra un pivote cero.
+     * @throws std::runtime_error Si la matriz es singular.
      */
     static void matrix_lu_decomposition(const std::vector<std::vector<float>>& matrix,
+                                        std::vector<std::vector<float>>& P,
                                         std::vector<std::vector<float>>& L,
                                         std::vector<std::vector<float>>& U);
 };
@@ -0,0 +1,224 @@
+#include "lu_factorization.h"
+#include "gemm.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+    // Filas por bloque en las sustituciones de solve_many
+    constexpr std::size_t kBlock = 64;
+
+    // Por debajo de este ancho las columnas se factorizan (y los triángulos se resuelven) fila a fila
+    constexpr std::size_t kLeafWidth = 16;
+
+    // Producto escalar con ocho sumas parciales independientes, para no encadenar cada suma con la anterior
+    float dot(const float* a, const float* b, std::size_t n) {
+        float partial[8] = {};
+        std::size_t k = 0;
+        for (; k + 8 <= n; k += 8) {
+            for (std::size_t lane = 0; lane < 8; lane++) partial[lane] += a[k + lane] * b[k + lane];
+        }
+        float sum = ((partial[0] + partial[1]) + (partial[2] + partial[3])) +
+                    ((partial[4] + partial[5]) + (partial[6] + partial[7]));
+        for (; k < n; k++) sum += a[k] * b[k];
+        return sum;
+    }
+
+} // namespace
+
+LUFactorization::LUFactorization(MatrixView<const float> matrix) : lu_(matrix), permutation_(matrix.rows()) {
+    if (matrix.rows() != matrix.cols()) {
+        throw std::invalid_argument("Error: La matriz debe ser cuadrada para la descomposición LU.");
+    }
+    std::iota(permutation_.begin(), permutation_.end(), std::size_t(0));
+    factor_columns(0, size());
+}
+
+// Factoriza las columnas [first, first + width) de las filas first..n, con las columnas anteriores
+// ya aplicadas. Divide las columnas en dos mitades: factoriza la izquierda, resuelve U12 = L11⁻¹ A12,
+// actualiza A22 -= L21 U12 con GEMM y factoriza la derecha. Los intercambios de filas se aplican
+// a las filas completas.
+void LUFactorization::factor_columns(std::size_t first, std::size_t width) {
+    std::size_t n = size();
+    std::size_t end = first + width;
+    if (width <= kLeafWidth) {
+        for (std::size_t j = first; j < end; j++) {
+            std::size_t pivot = j;
+            float best = std::abs(lu_(j, j));
+            for (std::size_t i = j + 1; i < n; i++) {
+                float value = std::abs(lu_(i, j));
+                if (value > best) {
+                    best = value;
+                    pivot = i;
+                }
+            }
+            if (best == 0) {
+                // Columna nula: no hay nada que eliminar, pero la matriz es singular
+                singular_ = true;
+                continue;
+            }
+            if (pivot != j) swap_rows(pivot, j);
+
+            const float* pivot_row = lu_.row(j);
+            for (std::size_t i = j + 1; i < n; i++) {
+                float* row = lu_.row(i);
+                float l = row[j] / pivot_row[j];
+                row[j] = l;
+                if (l == 0) continue;
+                for (std::size_t c = j + 1; c < end; c++) row[c] -= l * pivot_row[c];
+            }
+        }
+        return;
+    }
+
+    std::size_t half = width / 2;
+    std::size_t mid = first + half;
+    factor_columns(first, half);
+    solve_unit_lower(first, half, mid, end);
+    Gemm::multiply_subtract(lu_.block(mid, first, n - mid, half), lu_.block(first, mid, half, end - mid),
+                            lu_.block(mid, mid, n - mid, end - mid));
+    factor_columns(mid, width - half);
+}
+
+// Sustituye las columnas [col_begin, col_end) de las filas [first, first + count) por L⁻¹ de esas
+// filas, con L el triángulo inferior unitario del bloque diagonal (first, first)
+void LUFactorization::solve_unit_lower(std::size_t first, std::size_t count, std::size_t col_begin,
+                                       std::size_t col_end) {
+    if (count <= kLeafWidth) {
+        for (std::size_t j = first; j < first + count; j++) {
+            const float* pivot_row = lu_.row(j);
+            for (std::size_t i = j + 1; i < first + count; i++) {
+                float l = lu_(i, j);
+                if (l == 0) continue;
+                float* row = lu_.row(i);
+                for (std::size_t c = col_begin; c < col_end; c++) row[c] -= l * pivot_row[c];
+            }
+        }
+        return;
+    }
+    std::size_t half = count / 2;
+    std::size_t mid = first + half;
+    std::size_t cols = col_end - col_begin;
+    solve_unit_lower(first, half, col_begin, col_end);
+    Gemm::multiply_subtract(lu_.block(mid, first, count - half, half), lu_.block(first, col_begin, half, cols),
+                            lu_.block(mid, col_begin, count - half, cols));
+    solve_unit_lower(mid, count - half, col_begin, col_end);
+}
+
+void LUFactorization::swap_rows(std::size_t row1, std::size_t row2) {
+    std::swap_ranges(lu_.row(row1), lu_.row(row1) + size(), lu_.row(row2));
+    std::swap(permutation_[row1], permutation_[row2]);
+    odd_permutation_ = !odd_permutation_;
+}
+
+void LUFactorization::check_solvable() const {
+    if (singular_) {
+        throw std::runtime_error("Error: Matriz singular, el sistema no tiene solución única.");
+    }
+}
+
+std::vector<float> LUFactorization::solve(const std::vector<float>& b) const {
+    std::size_t n = size();
+    if (b.size() != n) {
+        throw std::invalid_argument("Error: El vector no tiene la dimensión de la matriz.");
+    }
+    check_solvable();
+
+    // Ly = Pb (hacia adelante), luego Ux = y (hacia atrás)
+    std::vector<float> x(n);
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] = b[permutation_[i]] - dot(lu_.row(i), x.data(), i);
+    }
+    for (std::size_t i = n; i-- > 0;) {
+        const float* row = lu_.row(i);
+        x[i] = (x[i] - dot(row + i + 1, x.data() + i + 1, n - i - 1)) / row[i];
+    }
+    return x;
+}
+
+Matrix<float> LUFactorization::solve_many(MatrixView<const float> B) const {
+    std::size_t n = size();
+    if (B.rows() != n) {
+        throw std::invalid_argument("Error: La matriz de términos independientes no tiene la dimensión del sistema.");
+    }
+    check_solvable();
+
+    std::size_t m = B.cols();
+    Matrix<float> X(n, m);
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < m; j++) X(i, j) = B(permutation_[i], j);
+    }
+
+    // Sustituciones por bloques de filas: la parte ya resuelta se resta con GEMM y dentro del
+    // bloque se opera fila a fila
+    for (std::size_t first = 0; first < n; first += kBlock) {
+        std::size_t end = std::min(n, first + kBlock);
+        if (first > 0) {
+            Gemm::multiply_subtract(lu_.block(first, 0, end - first, first), X.block(0, 0, first, m),
+                                    X.block(first, 0, end - first, m));
+        }
+        for (std::size_t i = first; i < end; i++) {
+            float* xi = X.row(i);
+            for (std::size_t k = first; k < i; k++) {
+                float l = lu_(i, k);
+                const float* xk = X.row(k);
+                for (std::size_t j = 0; j < m; j++) xi[j] -= l * xk[j];
+            }
+        }
+    }
+    std::size_t blocks = (n + kBlock - 1) / kBlock;
+    for (std::size_t block = blocks; block-- > 0;) {
+        std::size_t first = block * kBlock;
+        std::size_t end = std::min(n, first + kBlock);
+        if (end < n) {
+            Gemm::multiply_subtract(lu_.block(first, end, end - first, n - end), X.block(end, 0, n - end, m),
+                                    X.block(first, 0, end - first, m));
+        }
+        for (std::size_t i = end; i-- > first;) {
+            float* xi = X.row(i);
+            for (std::size_t k = i + 1; k < end; k++) {
+                float u = lu_(i, k);
+                const float* xk = X.row(k);
+                for (std::size_t j = 0; j < m; j++) xi[j] -= u * xk[j];
+            }
+            float pivot = lu_(i, i);
+            for (std::size_t j = 0; j < m; j++) xi[j] /= pivot;
+        }
+    }
+    return X;
+}
+
+float LUFactorization::determinant() const {
+    if (singular_) return 0.0f;
+    double det = odd_permutation_ ? -1.0 : 1.0;
+    for (std::size_t i = 0; i < size(); i++) det *= lu_(i, i);
+    return static_cast<float>(det);
+}
+
+Matrix<float> LUFactorization::inverse() const {
+    std::size_t n = size();
+    Matrix<float> identity(n, n, 0.0f);
+    for (std::size_t i = 0; i < n; i++) identity(i, i) = 1.0f;
+    return solve_many(identity);
+}
+
+Matrix<float> LUFactorization::lower() const {
+    std::size_t n = size();
+    Matrix<float> L(n, n, 0.0f);
+    for (std::size_t i = 0; i < n; i++) {
+        std::copy(lu_.row(i), lu_.row(i) + i, L.row(i));
+        L(i, i) = 1.0f;
+    }
+    return L;
+}
+
+Matrix<float> LUFactorization::upper() const {
+    std::size_t n = size();
+    Matrix<float> U(n, n, 0.0f);
+    for (std::size_t i = 0; i < n; i++) {
+        std::copy(lu_.row(i) + i, lu_.row(i) + n, U.row(i) + i);
+    }
+    return U;
+}
@@ -0,0 +1,80 @@
+#ifndef LU_FACTORIZATION_H
+#define LU_FACTORIZATION_H
+
+#include "matrix.h"
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file lu_factorization.h
+ * @brief Factorización LU con pivoteo parcial, calculada una vez y reutilizable.
+ *
+ * PA = LU, con L triangular inferior de diagonal unitaria y U triangular superior, guardadas
+ * juntas en una sola matriz. La factorización es recursiva por bloques: las columnas se dividen
+ * en dos mitades hasta paneles estrechos, que se factorizan con pivoteo parcial, y las submatrices
+ * se actualizan con Gemm::multiply_subtract, que es donde está casi todo el trabajo.
+ *
+ * Una vez calculada, cada solve(b) cuesta O(n²) (permutación y dos sustituciones), así que los
+ * sistemas repetidos con la misma matriz no vuelven a factorizarla.
+ */
+class LUFactorization {
+public:
+    /**
+     * @brief Factoriza una matriz cuadrada.
+     *
+     * Una matriz singular también se factoriza (U tiene algún cero en la diagonal); en ese caso
+     * determinant() es 0 y solve(), solve_many() e inverse() lanzan std::runtime_error.
+     *
+     * @param matrix Matriz de entrada; admite cualquier vista (sub-bloque, transpuesta).
+     * @throws std::invalid_argument Si la matriz no es cuadrada.
+     */
+    explicit LUFactorization(MatrixView<const float> matrix);
+
+    std::size_t size() const { return lu_.rows(); }
+    bool is_singular() const { return singular_; }
+
+    /**
+     * @brief Resuelve A x = b.
+     * @throws std::invalid_argument Si b no tiene size() elementos.
+     * @throws std::runtime_error Si la matriz es singular.
+     */
+    std::vector<float> solve(const std::vector<float>& b) const;
+
+    /**
+     * @brief Resuelve A X = B para todas las columnas de B a la vez.
+     * @throws std::invalid_argument Si B no tiene size() filas.
+     * @throws std::runtime_error Si la matriz es singular.
+     */
+    Matrix<float> solve_many(MatrixView<const float> B) const;
+
+    // Producto de la diagonal de U con el signo de la permutación; O(n)
+    float determinant() const;
+
+    /**
+     * @brief Inversa de A, resolviendo contra la identidad.
+     * @throws std::runtime_error Si la matriz es singular.
+     */
+    Matrix<float> inverse() const;
+
+    // L (sin la diagonal unitaria) y U en una sola matriz
+    const Matrix<float>& packed() const { return lu_; }
+
+    // La fila i de PA es la fila permutation()[i] de A
+    const std::vector<std::size_t>& permutation() const { return permutation_; }
+
+    Matrix<float> lower() const;
+    Matrix<float> upper() const;
+
+private:
+    Matrix<float> lu_;
+    std::vector<std::size_t> permutation_;
+    bool odd_permutation_ = false;
+    bool singular_ = false;
+
+    void factor_columns(std::size_t first, std::size_t width);
+    void solve_unit_lower(std::size_t first, std::size_t count, std::size_t col_begin, std::size_t col_end);
+    void swap_rows(std::size_t row1, std::size_t row2);
+    void check_solvable() const;
+};
+
+#endif // LU_FACTORIZATION_H
@@ -17,6 +17,11 @@
  * - **Advanced Operations**: Funciones avanzadas como exponenciación, raíces y logaritmos.
  * - **Linear Algebra**: Operaciones básicas de álgebra lineal, incluyendo suma de matrices y determinantes.
  * - **Linear Algebra Advanced**: Multiplicación de matrices, descomposición LU e inversión.
+ * - **LUFactorization**: LU por bloques con pivoteo parcial, reutilizable para resolver sistemas.
+ * - **Gemm**: Multiplicación de matrices por bloques con micro-núcleos SIMD y varios hilos.
+ * - **Sparse Matrix**: Matrices dispersas CSR/CSC con SpMV y SpMM en paralelo y gradiente conjugado.
+ * - **MathThreadPool**: Grupo de hilos compartido por Gemm y las operaciones dispersas.
+ * - **Matrix**: Matriz densa contigua Matrix<T> y vistas MatrixView<T> (sub-bloques y transpuestas sin copia).
  * - **Combinatorics**: Funciones de cálculo combinatorio como factorial, combinaciones y permutaciones.
  * - **Hyperbolic**: Funciones trigonométricas hiperbólicas avanzadas.
  * - **Trigonometry**: Funciones trigonométricas como seno, coseno y tangente.
@@ -30,8 +35,13 @@
 // Inclusión de módulos de operaciones matemáticas
 #include "basic_operations.h"
 #include "advanced_operations.h"
+#include "matrix.h"
 #include "linear_algebra.h"
 #include "linear_algebra_advanced.h"
+#include "gemm.h"
+#include "thread_pool.h"
+#include "lu_factorization.h"
+#include "sparse_matrix.h"
 #include "combinatorics.h"
 #include "hyperbolic.h"
 #include "trigonometry.h"
@@ -47,9 +47,9 @@ void test_linear_algebra_operations() {
     LinearAlgebraAdvanced::matrix_multiply(matrix1, matrix2, result);
     run_test("Matrix Multiplication (2x2)", result == std::vector<std::vector<int>>{{4, 4}, {10, 8}});
 
-    std::vector<std::vector<int>> L, U;
-    LinearAlgebraAdvanced::matrix_lu_decomposition(matrix1, L, U);
-    run_test("LU Decomposition", L.size() == 2 && U.size() == 2);
+    std::vector<std::vector<int>> P, L, U;
+    LinearAlgebraAdvanced::matrix_lu_decomposition(matrix1, P, L, U);
+    run_test("LU Decomposition", P.size() == 2 && L.size() == 2 && U.size() == 2);
 }
 
 // Pruebas de trigonometría
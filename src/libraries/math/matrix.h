@@ -0,0 +1,174 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file matrix.h
+ * @brief Matrices densas contiguas y vistas con paso (stride) para la librería math de MC++.
+ *
+ * Matrix<T> guarda sus elementos en un único bloque por filas: una sola reserva de memoria
+ * y filas consecutivas, que es lo que necesitan los bucles internos para aprovechar la caché
+ * y vectorizarse. MatrixView<T> no posee memoria: describe una matriz con un paso entre filas
+ * y otro entre columnas, así que un sub-bloque o una transpuesta se obtienen sin copiar.
+ * MatrixView<const T> es la vista de sólo lectura que aceptan las funciones de LinearAlgebra
+ * y LinearAlgebraAdvanced.
+ */
+
+/**
+ * @class MatrixView
+ * @brief Vista no propietaria de una matriz: el elemento (i, j) está en data[i * row_stride + j * col_stride].
+ *
+ * La vista no prolonga la vida de la memoria que mira; deja de ser válida si la Matrix de
+ * origen se destruye o cambia de tamaño.
+ */
+template <typename T>
+class MatrixView {
+public:
+    MatrixView() = default;
+
+    MatrixView(T* data, std::size_t rows, std::size_t cols, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride = 1)
+        : data_(data), rows_(rows), cols_(cols), row_stride_(row_stride), col_stride_(col_stride) {}
+
+    // Una vista de escritura se convierte en una de sólo lectura
+    template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value && !std::is_same<U, T>::value>>
+    MatrixView(const MatrixView<U>& other)
+        : data_(other.data()), rows_(other.rows()), cols_(other.cols()),
+          row_stride_(other.row_stride()), col_stride_(other.col_stride()) {}
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::ptrdiff_t row_stride() const { return row_stride_; }
+    std::ptrdiff_t col_stride() const { return col_stride_; }
+    T* data() const { return data_; }
+    bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+    T& operator()(std::size_t i, std::size_t j) const {
+        return data_[static_cast<std::ptrdiff_t>(i) * row_stride_ + static_cast<std::ptrdiff_t>(j) * col_stride_];
+    }
+
+    // Verdadero si los elementos de cada fila son consecutivos (se pueden recorrer con un puntero)
+    bool has_contiguous_rows() const { return col_stride_ == 1; }
+
+    // Puntero al inicio de la fila i; sus elementos están separados por col_stride()
+    T* row(std::size_t i) const { return data_ + static_cast<std::ptrdiff_t>(i) * row_stride_; }
+
+    /**
+     * Sub-bloque de rows x cols a partir de (row, col), sin copia.
+     * @throws std::out_of_range Si el bloque se sale de la vista.
+     */
+    MatrixView block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const {
+        if (row + rows > rows_ || col + cols > cols_) {
+            throw std::out_of_range("Error: El bloque se sale de los límites de la matriz.");
+        }
+        T* start = data_ + static_cast<std::ptrdiff_t>(row) * row_stride_ + static_cast<std::ptrdiff_t>(col) * col_stride_;
+        return MatrixView(start, rows, cols, row_stride_, col_stride_);
+    }
+
+    // Transpuesta sin copia: intercambia dimensiones y pasos
+    MatrixView transposed() const { return MatrixView(data_, cols_, rows_, col_stride_, row_stride_); }
+
+private:
+    T* data_ = nullptr;
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::ptrdiff_t row_stride_ = 0;
+    std::ptrdiff_t col_stride_ = 1;
+};
+
+/**
+ * @class Matrix
+ * @brief Matriz densa propietaria con almacenamiento contiguo por filas.
+ */
+template <typename T>
+class Matrix {
+public:
+    Matrix() = default;
+
+    Matrix(std::size_t rows, std::size_t cols, const T& value = T())
+        : rows_(rows), cols_(cols), data_(rows * cols, value) {}
+
+    /**
+     * Copia una matriz anidada; es la conversión que usan las firmas con std::vector<std::vector<T>>.
+     * @throws std::invalid_argument Si las filas no tienen todas la misma longitud.
+     */
+    explicit Matrix(const std::vector<std::vector<T>>& nested)
+        : rows_(nested.size()), cols_(nested.empty() ? 0 : nested[0].size()) {
+        data_.reserve(rows_ * cols_);
+        for (const std::vector<T>& row : nested) {
+            if (row.size() != cols_) {
+                throw std::invalid_argument("Error: Todas las filas de la matriz deben tener la misma longitud.");
+            }
+            data_.insert(data_.end(), row.begin(), row.end());
+        }
+    }
+
+    // Copia el contenido de cualquier vista (un bloque, una transpuesta) a una matriz contigua
+    explicit Matrix(MatrixView<const T> view) : rows_(view.rows()), cols_(view.cols()) {
+        data_.reserve(rows_ * cols_);
+        for (std::size_t i = 0; i < rows_; i++) {
+            for (std::size_t j = 0; j < cols_; j++) {
+                data_.push_back(view(i, j));
+            }
+        }
+    }
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    bool empty() const { return rows_ == 0 || cols_ == 0; }
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
+    T& operator()(std::size_t i, std::size_t j) { return data_[i * cols_ + j]; }
+    const T& operator()(std::size_t i, std::size_t j) const { return data_[i * cols_ + j]; }
+
+    T* row(std::size_t i) { return data_.data() + i * cols_; }
+    const T* row(std::size_t i) const { return data_.data() + i * cols_; }
+
+    // Cambia las dimensiones y rellena todos los elementos con value
+    void assign(std::size_t rows, std::size_t cols, const T& value = T()) {
+        rows_ = rows;
+        cols_ = cols;
+        data_.assign(rows * cols, value);
+    }
+
+    MatrixView<T> view() { return MatrixView<T>(data_.data(), rows_, cols_, static_cast<std::ptrdiff_t>(cols_)); }
+    MatrixView<const T> view() const {
+        return MatrixView<const T>(data_.data(), rows_, cols_, static_cast<std::ptrdiff_t>(cols_));
+    }
+    operator MatrixView<T>() { return view(); }
+    operator MatrixView<const T>() const { return view(); }
+
+    MatrixView<T> block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) {
+        return view().block(row, col, rows, cols);
+    }
+    MatrixView<const T> block(std::size_t row, std::size_t col, std::size_t rows, std::size_t cols) const {
+        return view().block(row, col, rows, cols);
+    }
+    MatrixView<T> transposed() { return view().transposed(); }
+    MatrixView<const T> transposed() const { return view().transposed(); }
+
+    // Copia a la representación anidada de las firmas antiguas
+    std::vector<std::vector<T>> to_nested() const {
+        std::vector<std::vector<T>> nested(rows_);
+        for (std::size_t i = 0; i < rows_; i++) {
+            nested[i].assign(row(i), row(i) + cols_);
+        }
+        return nested;
+    }
+
+    bool operator==(const Matrix& other) const {
+        return rows_ == other.rows_ && cols_ == other.cols_ && data_ == other.data_;
+    }
+    bool operator!=(const Matrix& other) const { return !(*this == other); }
+
+private:
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::vector<T> data_;
+};
+
+#endif // MATRIX_H
@@ -0,0 +1,379 @@
+#include "sparse_matrix.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+    // Por debajo de este número de elementos (más filas) no compensa despertar a los hilos
+    constexpr std::size_t kParallelThreshold = std::size_t(1) << 15;
+
+    // Trozos por hilo, para que el robo de trabajo reparta lo que un hilo deja atrás
+    constexpr std::size_t kChunksPerThread = 4;
+
+    // Reparto de las filas de A entre los hilos: se calcula una vez por operación (o por solve de CG)
+    class RowChunks {
+    public:
+        explicit RowChunks(const CsrMatrix& a)
+            : lease_(MathThreadPool::thread_count() > 1 && a.nonzeros() + a.rows() >= kParallelThreshold) {
+            // Trozos de filas consecutivas con el mismo número de elementos, buscando en offsets
+            // dónde empieza cada uno
+            std::size_t rows = a.rows();
+            const std::vector<std::size_t>& offsets = a.offsets();
+            std::size_t chunks = std::max<std::size_t>(1, std::min(rows, lease_.threads() * kChunksPerThread));
+            bounds_.assign(chunks + 1, rows);
+            bounds_[0] = 0;
+            for (std::size_t c = 1; c < chunks; c++) {
+                std::size_t target = a.nonzeros() / chunks * c;
+                bounds_[c] = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end() - 1, target) -
+                                                      offsets.begin()) - 1;
+                bounds_[c] = std::max(bounds_[c], bounds_[c - 1]);
+            }
+        }
+
+        // Ejecuta task(primera fila, fila final) sobre cada trozo no vacío
+        template <typename Task>
+        void for_each(const Task& task) {
+            lease_.for_each(bounds_.size() - 1, [&](std::size_t c) {
+                if (bounds_[c] < bounds_[c + 1]) task(bounds_[c], bounds_[c + 1]);
+            });
+        }
+
+    private:
+        MathThreadPool::Lease lease_;
+        std::vector<std::size_t> bounds_;
+    };
+
+    // y = A x sobre punteros y con el reparto ya hecho: CG no reserva nada en cada iteración
+    void spmv(const CsrMatrix& a, RowChunks& chunks, const float* x, float* y) {
+        const std::size_t* offsets = a.offsets().data();
+        const std::uint32_t* indices = a.indices().data();
+        const float* values = a.values().data();
+        chunks.for_each([&](std::size_t first, std::size_t end) {
+            for (std::size_t i = first; i < end; i++) {
+                // Dos sumas parciales: cada elemento depende de una lectura indirecta de x
+                float even = 0, odd = 0;
+                std::size_t k = offsets[i];
+                std::size_t row_end = offsets[i + 1];
+                for (; k + 2 <= row_end; k += 2) {
+                    even += values[k] * x[indices[k]];
+                    odd += values[k + 1] * x[indices[k + 1]];
+                }
+                if (k < row_end) even += values[k] * x[indices[k]];
+                y[i] = even + odd;
+            }
+        });
+    }
+
+    double dot(const std::vector<float>& a, const std::vector<float>& b) {
+        double sum = 0;
+        for (std::size_t i = 0; i < a.size(); i++) sum += double(a[i]) * b[i];
+        return sum;
+    }
+
+    struct Compressed {
+        std::vector<std::size_t> offsets;
+        std::vector<std::uint32_t> indices;
+        std::vector<float> values;
+    };
+
+    // Agrupa las tripletas por fila (o por columna, con by_column) con una ordenación por conteo,
+    // ordena cada fila por columna y suma las repetidas
+    Compressed compress(std::size_t rows, std::size_t cols, const std::vector<SparseEntry>& entries, bool by_column) {
+        std::size_t major = by_column ? cols : rows;
+        std::size_t minor = by_column ? rows : cols;
+        if (minor > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("Error: La dimensión de los índices dispersos no cabe en 32 bits.");
+        }
+        Compressed out;
+        out.offsets.assign(major + 1, 0);
+        for (const SparseEntry& entry : entries) {
+            if (entry.row >= rows || entry.col >= cols) {
+                throw std::invalid_argument("Error: La tripleta está fuera de las dimensiones de la matriz.");
+            }
+            out.offsets[(by_column ? entry.col : entry.row) + 1]++;
+        }
+        for (std::size_t k = 0; k < major; k++) out.offsets[k + 1] += out.offsets[k];
+
+        std::vector<std::pair<std::uint32_t, float>> sorted(entries.size());
+        std::vector<std::size_t> next(out.offsets.begin(), out.offsets.end() - 1);
+        for (const SparseEntry& entry : entries) {
+            std::size_t position = next[by_column ? entry.col : entry.row]++;
+            sorted[position] = {static_cast<std::uint32_t>(by_column ? entry.row : entry.col), entry.value};
+        }
+
+        // stable_sort: las repetidas se suman en el orden en que llegaron, así el resultado no
+        // depende de la implementación de la ordenación
+        out.indices.reserve(entries.size());
+        out.values.reserve(entries.size());
+        std::size_t begin = 0;
+        for (std::size_t k = 0; k < major; k++) {
+            std::size_t end = out.offsets[k + 1];
+            std::stable_sort(sorted.begin() + begin, sorted.begin() + end,
+                             [](const auto& a, const auto& b) { return a.first < b.first; });
+            for (std::size_t e = begin; e < end; e++) {
+                if (e > begin && sorted[e].first == sorted[e - 1].first) {
+                    out.values.back() += sorted[e].second;
+                } else {
+                    out.indices.push_back(sorted[e].first);
+                    out.values.push_back(sorted[e].second);
+                }
+            }
+            begin = end;
+            out.offsets[k + 1] = out.values.size();
+        }
+        return out;
+    }
+
+    // Cambia de CSR a CSC (o al revés): el mismo conteo, recorriendo las filas en orden para que
+    // cada columna quede ordenada sin ordenar
+    void transpose(std::size_t major, std::size_t minor, const std::vector<std::size_t>& offsets,
+                   const std::vector<std::uint32_t>& indices, const std::vector<float>& values,
+                   std::vector<std::size_t>& out_offsets, std::vector<std::uint32_t>& out_indices,
+                   std::vector<float>& out_values) {
+        if (major > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("Error: La dimensión de los índices dispersos no cabe en 32 bits.");
+        }
+        out_offsets.assign(minor + 1, 0);
+        for (std::uint32_t index : indices) out_offsets[index + 1]++;
+        for (std::size_t k = 0; k < minor; k++) out_offsets[k + 1] += out_offsets[k];
+        out_indices.resize(indices.size());
+        out_values.resize(values.size());
+        std::vector<std::size_t> next(out_offsets.begin(), out_offsets.end() - 1);
+        for (std::size_t k = 0; k < major; k++) {
+            for (std::size_t e = offsets[k]; e < offsets[k + 1]; e++) {
+                std::size_t position = next[indices[e]]++;
+                out_indices[position] = static_cast<std::uint32_t>(k);
+                out_values[position] = values[e];
+            }
+        }
+    }
+
+    float find(const std::vector<std::size_t>& offsets, const std::vector<std::uint32_t>& indices,
+               const std::vector<float>& values, std::size_t major, std::size_t minor) {
+        auto first = indices.begin() + static_cast<std::ptrdiff_t>(offsets[major]);
+        auto last = indices.begin() + static_cast<std::ptrdiff_t>(offsets[major + 1]);
+        auto it = std::lower_bound(first, last, minor);
+        if (it == last || *it != minor) return 0.0f;
+        return values[static_cast<std::size_t>(it - indices.begin())];
+    }
+
+} // namespace
+
+CsrMatrix CsrMatrix::from_triplets(std::size_t rows, std::size_t cols, const std::vector<SparseEntry>& entries) {
+    Compressed compressed = compress(rows, cols, entries, false);
+    CsrMatrix matrix;
+    matrix.rows_ = rows;
+    matrix.cols_ = cols;
+    matrix.offsets_ = std::move(compressed.offsets);
+    matrix.indices_ = std::move(compressed.indices);
+    matrix.values_ = std::move(compressed.values);
+    return matrix;
+}
+
+CsrMatrix CsrMatrix::from_dense(MatrixView<const float> matrix) {
+    std::vector<SparseEntry> entries;
+    for (std::size_t i = 0; i < matrix.rows(); i++) {
+        for (std::size_t j = 0; j < matrix.cols(); j++) {
+            if (matrix(i, j) != 0.0f) entries.push_back({i, j, matrix(i, j)});
+        }
+    }
+    return from_triplets(matrix.rows(), matrix.cols(), entries);
+}
+
+float CsrMatrix::at(std::size_t i, std::size_t j) const {
+    if (i >= rows_ || j >= cols_) {
+        throw std::out_of_range("Error: Índice fuera de la matriz dispersa.");
+    }
+    return find(offsets_, indices_, values_, i, j);
+}
+
+Matrix<float> CsrMatrix::to_dense() const {
+    Matrix<float> dense(rows_, cols_, 0.0f);
+    for (std::size_t i = 0; i < rows_; i++) {
+        for (std::size_t e = offsets_[i]; e < offsets_[i + 1]; e++) dense(i, indices_[e]) = values_[e];
+    }
+    return dense;
+}
+
+CscMatrix CsrMatrix::to_csc() const {
+    CscMatrix matrix;
+    matrix.rows_ = rows_;
+    matrix.cols_ = cols_;
+    transpose(rows_, cols_, offsets_, indices_, values_, matrix.offsets_, matrix.indices_, matrix.values_);
+    return matrix;
+}
+
+CscMatrix CscMatrix::from_triplets(std::size_t rows, std::size_t cols, const std::vector<SparseEntry>& entries) {
+    Compressed compressed = compress(rows, cols, entries, true);
+    CscMatrix matrix;
+    matrix.rows_ = rows;
+    matrix.cols_ = cols;
+    matrix.offsets_ = std::move(compressed.offsets);
+    matrix.indices_ = std::move(compressed.indices);
+    matrix.values_ = std::move(compressed.values);
+    return matrix;
+}
+
+float CscMatrix::at(std::size_t i, std::size_t j) const {
+    if (i >= rows_ || j >= cols_) {
+        throw std::out_of_range("Error: Índice fuera de la matriz dispersa.");
+    }
+    return find(offsets_, indices_, values_, j, i);
+}
+
+Matrix<float> CscMatrix::to_dense() const {
+    Matrix<float> dense(rows_, cols_, 0.0f);
+    for (std::size_t j = 0; j < cols_; j++) {
+        for (std::size_t e = offsets_[j]; e < offsets_[j + 1]; e++) dense(indices_[e], j) = values_[e];
+    }
+    return dense;
+}
+
+CsrMatrix CscMatrix::to_csr() const {
+    CsrMatrix matrix;
+    matrix.rows_ = rows_;
+    matrix.cols_ = cols_;
+    transpose(cols_, rows_, offsets_, indices_, values_, matrix.offsets_, matrix.indices_, matrix.values_);
+    return matrix;
+}
+
+std::vector<float> SparseLinearAlgebra::multiply(const CsrMatrix& a, const std::vector<float>& x) {
+    if (x.size() != a.cols()) {
+        throw std::invalid_argument("Error: El vector no tiene tantos elementos como columnas la matriz.");
+    }
+    std::vector<float> y(a.rows());
+    RowChunks chunks(a);
+    spmv(a, chunks, x.data(), y.data());
+    return y;
+}
+
+std::vector<float> SparseLinearAlgebra::multiply(const CscMatrix& a, const std::vector<float>& x) {
+    if (x.size() != a.cols()) {
+        throw std::invalid_argument("Error: El vector no tiene tantos elementos como columnas la matriz.");
+    }
+    std::vector<float> y(a.rows(), 0.0f);
+    const std::vector<std::size_t>& offsets = a.offsets();
+    const std::vector<std::uint32_t>& indices = a.indices();
+    const std::vector<float>& values = a.values();
+    for (std::size_t j = 0; j < a.cols(); j++) {
+        float xj = x[j];
+        if (xj == 0.0f) continue;
+        for (std::size_t e = offsets[j]; e < offsets[j + 1]; e++) y[indices[e]] += values[e] * xj;
+    }
+    return y;
+}
+
+void SparseLinearAlgebra::multiply(const CsrMatrix& a, MatrixView<const float> b, MatrixView<float> c) {
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::invalid_argument("Error: Las dimensiones de las matrices no permiten la multiplicación.");
+    }
+    if (!c.has_contiguous_rows()) {
+        throw std::invalid_argument("Error: La matriz de salida debe tener filas contiguas.");
+    }
+    std::size_t n = b.cols();
+    const std::vector<std::size_t>& offsets = a.offsets();
+    const std::vector<std::uint32_t>& indices = a.indices();
+    const std::vector<float>& values = a.values();
+    bool contiguous = b.has_contiguous_rows();
+    RowChunks chunks(a);
+    chunks.for_each([&](std::size_t first, std::size_t end) {
+        for (std::size_t i = first; i < end; i++) {
+            float* out = c.row(i);
+            std::fill(out, out + n, 0.0f);
+            for (std::size_t e = offsets[i]; e < offsets[i + 1]; e++) {
+                float value = values[e];
+                if (contiguous) {
+                    const float* source = b.row(indices[e]);
+                    for (std::size_t j = 0; j < n; j++) out[j] += value * source[j];
+                } else {
+                    for (std::size_t j = 0; j < n; j++) out[j] += value * b(indices[e], j);
+                }
+            }
+        }
+    });
+}
+
+ConjugateGradientResult SparseLinearAlgebra::conjugate_gradient(const CsrMatrix& a, const std::vector<float>& b,
+                                                                const ConjugateGradientOptions& options) {
+    return conjugate_gradient(a, b, std::vector<float>(b.size(), 0.0f), options);
+}
+
+ConjugateGradientResult SparseLinearAlgebra::conjugate_gradient(const CsrMatrix& a, const std::vector<float>& b,
+                                                                const std::vector<float>& initial_guess,
+                                                                const ConjugateGradientOptions& options) {
+    std::size_t n = a.rows();
+    if (a.cols() != n) {
+        throw std::invalid_argument("Error: La matriz debe ser cuadrada para el gradiente conjugado.");
+    }
+    if (b.size() != n || initial_guess.size() != n) {
+        throw std::invalid_argument("Error: El vector no tiene la dimensión de la matriz.");
+    }
+
+    // M⁻¹ del precondicionador de Jacobi: el inverso de la diagonal
+    std::vector<float> inverse_diagonal(n, 1.0f);
+    if (options.preconditioner == Preconditioner::JACOBI) {
+        for (std::size_t i = 0; i < n; i++) {
+            float diagonal = a.at(i, i);
+            if (!(diagonal > 0.0f)) {
+                throw std::invalid_argument(
+                    "Error: La diagonal debe ser positiva: la matriz no es simétrica definida positiva.");
+            }
+            inverse_diagonal[i] = 1.0f / diagonal;
+        }
+    }
+
+    ConjugateGradientResult result;
+    result.x = initial_guess;
+    std::size_t max_iterations = options.max_iterations == 0 ? n : options.max_iterations;
+    double b_norm = std::sqrt(dot(b, b));
+    if (b_norm == 0) {
+        std::fill(result.x.begin(), result.x.end(), 0.0f);
+        result.converged = true;
+        return result;
+    }
+
+    std::vector<float> r(n), z(n), p(n), ap(n);
+    RowChunks chunks(a);
+    spmv(a, chunks, result.x.data(), ap.data());
+    for (std::size_t i = 0; i < n; i++) {
+        r[i] = b[i] - ap[i];
+        z[i] = r[i] * inverse_diagonal[i];
+    }
+    p = z;
+    double rz = dot(r, z);
+    result.residual = static_cast<float>(std::sqrt(dot(r, r)) / b_norm);
+
+    while (result.residual > options.tolerance && result.iterations < max_iterations) {
+        spmv(a, chunks, p.data(), ap.data());
+        double p_ap = dot(p, ap);
+        if (!(p_ap > 0)) {
+            throw std::runtime_error("Error: La matriz no es definida positiva (p·Ap <= 0 en el gradiente conjugado).");
+        }
+        float alpha = static_cast<float>(rz / p_ap);
+        for (std::size_t i = 0; i < n; i++) {
+            result.x[i] += alpha * p[i];
+            r[i] -= alpha * ap[i];
+            z[i] = r[i] * inverse_diagonal[i];
+        }
+        double next_rz = dot(r, z);
+        float beta = static_cast<float>(next_rz / rz);
+        rz = next_rz;
+        for (std::size_t i = 0; i < n; i++) p[i] = z[i] + beta * p[i];
+        result.iterations++;
+        result.residual = static_cast<float>(std::sqrt(dot(r, r)) / b_norm);
+    }
+    result.converged = result.residual <= options.tolerance;
+    return result;
+}
+
+void SparseLinearAlgebra::set_thread_count(std::size_t threads) {
+    MathThreadPool::set_thread_count(threads);
+}
+
+std::size_t SparseLinearAlgebra::thread_count() {
+    return MathThreadPool::thread_count();
+}
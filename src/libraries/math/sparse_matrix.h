@@ -0,0 +1,206 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include "matrix.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file sparse_matrix.h
+ * @brief Matrices dispersas en CSR y CSC, con SpMV, SpMM y gradiente conjugado.
+ *
+ * Pensado para matrices con casi todo ceros (topologías de clúster, grafos de carga): solo se
+ * guardan los elementos distintos de cero, así que una multiplicación lee O(nnz) en lugar de
+ * O(filas * columnas). Ambos formatos comparten la misma disposición comprimida:
+ *
+ * - offsets(): major + 1 posiciones; los elementos de la fila (CSR) o columna (CSC) k ocupan
+ *   [offsets()[k], offsets()[k + 1]).
+ * - indices(): columna (CSR) o fila (CSC) de cada elemento, en orden creciente dentro de cada
+ *   fila o columna. Son de 32 bits para reducir el tráfico de memoria de SpMV.
+ * - values(): el valor de cada elemento.
+ *
+ * Las matrices se construyen a partir de tripletas COO (fila, columna, valor) en cualquier orden;
+ * las tripletas repetidas se suman.
+ */
+
+/**
+ * @struct SparseEntry
+ * @brief Tripleta COO: un elemento (row, col) de valor value.
+ */
+struct SparseEntry {
+    std::size_t row;
+    std::size_t col;
+    float value;
+};
+
+class CscMatrix;
+
+/**
+ * @class CsrMatrix
+ * @brief Matriz dispersa por filas (Compressed Sparse Row): el formato de SpMV, SpMM y CG.
+ */
+class CsrMatrix {
+public:
+    CsrMatrix() = default;
+
+    /**
+     * @brief Construye la matriz a partir de tripletas COO, en O(nnz + rows).
+     *
+     * @param rows Número de filas.
+     * @param cols Número de columnas; como mucho 2³² - 1.
+     * @param entries Tripletas en cualquier orden; las repetidas se suman.
+     * @throws std::invalid_argument Si alguna tripleta cae fuera de la matriz o cols no cabe en 32 bits.
+     */
+    static CsrMatrix from_triplets(std::size_t rows, std::size_t cols, const std::vector<SparseEntry>& entries);
+
+    // Guarda los elementos de la matriz densa distintos de cero
+    static CsrMatrix from_dense(MatrixView<const float> matrix);
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t nonzeros() const { return values_.size(); }
+
+    const std::vector<std::size_t>& offsets() const { return offsets_; }
+    const std::vector<std::uint32_t>& indices() const { return indices_; }
+    const std::vector<float>& values() const { return values_; }
+
+    // Elemento (i, j), con búsqueda binaria en la fila i; 0 si no está guardado
+    float at(std::size_t i, std::size_t j) const;
+
+    Matrix<float> to_dense() const;
+    CscMatrix to_csc() const;
+
+private:
+    friend class CscMatrix;
+
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::vector<std::size_t> offsets_ = {0};
+    std::vector<std::uint32_t> indices_;
+    std::vector<float> values_;
+};
+
+/**
+ * @class CscMatrix
+ * @brief Matriz dispersa por columnas (Compressed Sparse Column), para recorrer columnas.
+ */
+class CscMatrix {
+public:
+    CscMatrix() = default;
+
+    /**
+     * @brief Construye la matriz a partir de tripletas COO, en O(nnz + cols).
+     *
+     * @param rows Número de filas; como mucho 2³² - 1.
+     * @param cols Número de columnas.
+     * @param entries Tripletas en cualquier orden; las repetidas se suman.
+     * @throws std::invalid_argument Si alguna tripleta cae fuera de la matriz o rows no cabe en 32 bits.
+     */
+    static CscMatrix from_triplets(std::size_t rows, std::size_t cols, const std::vector<SparseEntry>& entries);
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t nonzeros() const { return values_.size(); }
+
+    const std::vector<std::size_t>& offsets() const { return offsets_; }
+    const std::vector<std::uint32_t>& indices() const { return indices_; }
+    const std::vector<float>& values() const { return values_; }
+
+    // Elemento (i, j), con búsqueda binaria en la columna j; 0 si no está guardado
+    float at(std::size_t i, std::size_t j) const;
+
+    Matrix<float> to_dense() const;
+    CsrMatrix to_csr() const;
+
+private:
+    friend class CsrMatrix;
+
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    std::vector<std::size_t> offsets_ = {0};
+    std::vector<std::uint32_t> indices_;
+    std::vector<float> values_;
+};
+
+/**
+ * @enum Preconditioner
+ * @brief Precondicionadores de conjugate_gradient.
+ */
+enum class Preconditioner {
+    NONE,   // gradiente conjugado sin precondicionar
+    JACOBI  // divide por la diagonal; no cuesta nada y ayuda cuando las filas tienen escalas distintas
+};
+
+struct ConjugateGradientOptions {
+    float tolerance = 1e-6f;            // se detiene cuando ||b - Ax|| <= tolerance * ||b||
+    std::size_t max_iterations = 0;     // 0: tantas como filas
+    Preconditioner preconditioner = Preconditioner::JACOBI;
+};
+
+struct ConjugateGradientResult {
+    std::vector<float> x;
+    std::size_t iterations = 0;
+    float residual = 0;                 // ||b - Ax|| / ||b|| al terminar
+    bool converged = false;
+};
+
+/**
+ * @class SparseLinearAlgebra
+ * @brief Operaciones sobre matrices dispersas.
+ *
+ * SpMV y SpMM con CSR reparten las filas entre los hilos del grupo de la librería
+ * (MathThreadPool, thread_pool.h) en trozos con el mismo número de elementos (no de filas), de forma que una fila muy cargada de un
+ * grafo no deja esperando al resto. Cada hilo escribe solo sus filas de la salida.
+ */
+class SparseLinearAlgebra {
+public:
+    /**
+     * @brief Calcula y = A x.
+     * @throws std::invalid_argument Si x no tiene a.cols() elementos.
+     */
+    static std::vector<float> multiply(const CsrMatrix& a, const std::vector<float>& x);
+
+    /**
+     * @brief Calcula y = A x sobre CSC, columna a columna (en un solo hilo: las columnas
+     *        escriben en las mismas filas de y). Para productos repetidos conviene CSR.
+     * @throws std::invalid_argument Si x no tiene a.cols() elementos.
+     */
+    static std::vector<float> multiply(const CscMatrix& a, const std::vector<float>& x);
+
+    /**
+     * @brief Calcula C = A * B, con A dispersa y B densa (SpMM).
+     *
+     * @param a Matriz dispersa de rows x inner.
+     * @param b Matriz densa de inner x cols; admite cualquier paso, pero con filas contiguas
+     *          cada elemento de A actualiza una fila de C con un bucle vectorizable.
+     * @param c Matriz de salida de rows x cols con filas contiguas; no debe solaparse con b.
+     * @throws std::invalid_argument Si las dimensiones no coinciden o las filas de c no son contiguas.
+     */
+    static void multiply(const CsrMatrix& a, MatrixView<const float> b, MatrixView<float> c);
+
+    /**
+     * @brief Resuelve A x = b con gradiente conjugado precondicionado, partiendo de x = 0.
+     *
+     * A debe ser simétrica definida positiva; la simetría no se comprueba. Si no converge en
+     * options.max_iterations iteraciones devuelve la última aproximación con converged = false.
+     *
+     * @throws std::invalid_argument Si A no es cuadrada, b no tiene a.rows() elementos o, con
+     *         Preconditioner::JACOBI, algún elemento de la diagonal no es positivo.
+     * @throws std::runtime_error Si una dirección de búsqueda da p·Ap <= 0 (A no es definida positiva).
+     */
+    static ConjugateGradientResult conjugate_gradient(const CsrMatrix& a, const std::vector<float>& b,
+                                                      const ConjugateGradientOptions& options = {});
+
+    // Igual, partiendo de initial_guess (por ejemplo, la solución de un sistema parecido)
+    static ConjugateGradientResult conjugate_gradient(const CsrMatrix& a, const std::vector<float>& b,
+                                                      const std::vector<float>& initial_guess,
+                                                      const ConjugateGradientOptions& options = {});
+
+    // Hilos de SpMV y SpMM; es el mismo valor que MathThreadPool::set_thread_count (y Gemm).
+    // 0 vuelve al valor por defecto (std::thread::hardware_concurrency)
+    static void set_thread_count(std::size_t threads);
+    static std::size_t thread_count();
+};
+
+#endif // SPARSE_MATRIX_H
@@ -0,0 +1,34 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace {
+
+    std::atomic<std::size_t> requested_threads{0};
+    std::unique_ptr<mc_utils::WorkStealingPool> pool;
+    std::atomic<bool> pool_busy{false};
+
+} // namespace
+
+void MathThreadPool::set_thread_count(std::size_t threads) {
+    requested_threads.store(threads, std::memory_order_relaxed);
+}
+
+std::size_t MathThreadPool::thread_count() {
+    std::size_t threads = requested_threads.load(std::memory_order_relaxed);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    return threads;
+}
+
+MathThreadPool::Lease::Lease(bool wanted) {
+    if (!wanted || pool_busy.exchange(true, std::memory_order_acquire)) return;
+    std::size_t threads = thread_count();
+    if (pool == nullptr || pool->size() != threads) pool = std::make_unique<mc_utils::WorkStealingPool>(threads);
+    pool_ = pool.get();
+}
+
+MathThreadPool::Lease::~Lease() {
+    if (pool_ != nullptr) pool_busy.store(false, std::memory_order_release);
+}
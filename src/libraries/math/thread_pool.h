@@ -0,0 +1,46 @@
+#ifndef MATH_THREAD_POOL_H
+#define MATH_THREAD_POOL_H
+
+#include "../../utils/work_stealing_pool.h"
+#include <cstddef>
+
+/**
+ * @file thread_pool.h
+ * @brief Grupo de hilos de la librería matemática, compartido por Gemm y SparseLinearAlgebra.
+ *
+ * El mc_utils::WorkStealingPool se crea una sola vez y se reutiliza entre llamadas. Cada operación
+ * lo toma con un Lease; una llamada concurrente (u otra hecha desde dentro de una tarea) no lo
+ * espera, se ejecuta en su propio hilo.
+ */
+class MathThreadPool {
+public:
+    // Hilos del grupo; 0 vuelve al valor por defecto (std::thread::hardware_concurrency)
+    static void set_thread_count(std::size_t threads);
+    static std::size_t thread_count();
+
+    class Lease {
+    public:
+        // Sin wanted (o con el grupo ocupado) for_each ejecuta las tareas en el hilo actual
+        explicit Lease(bool wanted);
+        ~Lease();
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        std::size_t threads() const { return pool_ == nullptr ? 1 : pool_->size(); }
+
+        // Ejecuta task(índice) para cada índice de [0, count), en el grupo si se obtuvo
+        template <typename Task>
+        void for_each(std::size_t count, const Task& task) {
+            if (pool_ == nullptr || count == 1) {
+                for (std::size_t i = 0; i < count; i++) task(i);
+                return;
+            }
+            pool_->run(count, [&task](std::size_t, std::size_t i) { task(i); });
+        }
+
+    private:
+        mc_utils::WorkStealingPool* pool_ = nullptr;
+    };
+};
+
+#endif // MATH_THREAD_POOL_H
@@ -7,7 +7,7 @@
 
 PerformanceMonitoring::PerformanceMonitoring() {
     // Inicialización de umbrales de alerta por tipo de métrica
-    alertThresholds = {{"cpu", 0.9}, {"memory", 0.85}, {"disk", 0.8}, {"network", 0.75}};
+    alertThresholds = {{"cpu", 0.9}, {"memory", 0.85}, {"disk", 0.8}, {"network", 0.75}, {"gc_pause_ms", 50.0}};
     stopMonitoringFlag = false; // Inicialización de la bandera de interrupción
 }
 
@@ -38,8 +38,19 @@ bool PerformanceMonitoring::updateMetricUsage(const std::string& id, float usage
     return false;
 }
 
+void PerformanceMonitoring::updateGarbageCollectionMetrics(const GarbageCollectionMetrics& metrics) {
+    gcMetrics = metrics;
+    hasGcMetrics = true;
+    logOperation("UPDATE_GC_METRICS", {{"live_bytes", std::to_string(metrics.live_bytes)},
+                                       {"last_pause_ms", std::to_string(metrics.last_pause_ms)}});
+}
+
 std::vector<std::map<std::string, std::string>> PerformanceMonitoring::checkAlertThresholds() {
     std::vector<std::map<std::string, std::string>> alerts;
+    if (hasGcMetrics && gcMetrics.last_pause_ms > alertThresholds["gc_pause_ms"]) {
+        alerts.push_back({{"id", "gc"}, {"type", "gc_pause_ms"}, {"usage", std::to_string(gcMetrics.last_pause_ms)}});
+        logOperation("ALERT_THRESHOLD_EXCEEDED", {{"id", "gc"}, {"type", "gc_pause_ms"}, {"usage", std::to_string(gcMetrics.last_pause_ms)}});
+    }
     for (const auto& metric : performanceMetrics) {
         if (metric.usage > alertThresholds[metric.type]) {
             alerts.push_back({{"id", metric.id}, {"type", metric.type}, {"usage", std::to_string(metric.usage)}});
@@ -80,6 +91,17 @@ std::map<std::string, std::map<std::string, float>> PerformanceMonitoring::gener
             {"last_timestamp", static_cast<float>(metric.timestamp)}
         };
     }
+    if (hasGcMetrics) {
+        report["gc"] = {
+            {"heap_bytes", static_cast<float>(gcMetrics.heap_bytes)},
+            {"live_bytes", static_cast<float>(gcMetrics.live_bytes)},
+            {"minor_collections", static_cast<float>(gcMetrics.minor_collections)},
+            {"major_collections", static_cast<float>(gcMetrics.major_collections)},
+            {"last_pause_ms", static_cast<float>(gcMetrics.last_pause_ms)},
+            {"max_pause_ms", static_cast<float>(gcMetrics.max_pause_ms)},
+            {"promotion_rate", static_cast<float>(gcMetrics.promotion_rate)}
+        };
+    }
     logOperation("GENERATE_PERFORMANCE_REPORT", {});
     return report;
 }
@@ -6,6 +6,8 @@
 #include <list>
 #include <vector>
 #include <ctime>
+#include <cstdint>
+#include <cstddef>
 
 // Estructura para representar una métrica de rendimiento
 struct PerformanceMetric {
@@ -18,6 +20,17 @@ struct PerformanceMetric {
     std::time_t timestamp;       // Marca de tiempo de la última actualización
 };
 
+// Estadísticas del recolector de basura del runtime de MC++ (copia de mc_core::GcStats)
+struct GarbageCollectionMetrics {
+    size_t heap_bytes;           // Memoria reservada por el heap
+    size_t live_bytes;           // Memoria ocupada por objetos vivos
+    uint64_t minor_collections;  // Recolecciones de la generación joven
+    uint64_t major_collections;  // Recolecciones completas
+    double last_pause_ms;        // Duración de la última pausa
+    double max_pause_ms;         // Pausa más larga observada
+    double promotion_rate;       // Fracción de lo asignado que pasa a la generación vieja
+};
+
 // Clase avanzada de monitoreo de rendimiento
 class PerformanceMonitoring {
 public:
@@ -30,6 +43,10 @@ public:
     // Actualiza el uso de una métrica específica
     bool updateMetricUsage(const std::string& id, float usage);
 
+    // Registra las estadísticas del recolector de basura; se incluyen en el reporte y
+    // generan una alerta si la última pausa supera el umbral "gc_pause_ms"
+    void updateGarbageCollectionMetrics(const GarbageCollectionMetrics& metrics);
+
     // Verifica si las métricas superan umbrales definidos y retorna alertas
     std::vector<std::map<std::string, std::string>> checkAlertThresholds();
 
@@ -60,6 +77,8 @@ public:
 private:
     std::list<PerformanceMetric> performanceMetrics;         // Lista de métricas de rendimiento
     std::map<std::string, float> alertThresholds;            // Umbrales de alerta para cada tipo de recurso
+    GarbageCollectionMetrics gcMetrics{};                    // Últimas estadísticas del recolector
+    bool hasGcMetrics = false;
     void logOperation(const std::string& operation, const std::map<std::string, std::string>& details); // Función de auditoría interna
 };
 
@@ -73,7 +73,7 @@ namespace mc_security {
         eventLog.push_back(formattedEvent);
 
         // Salida inmediata al log para visibilidad
-        std::cout << formattedEvent << std::endl;
+        std::cout << formattedEvent << "\n";
 
         // Escribir logs cifrados en archivo
         if (!logFile.empty()) {
@@ -81,7 +81,7 @@ namespace mc_security {
             if (outFile.is_open()) {
                 try {
                     std::string encryptedEvent = AESEncrypt(formattedEvent, encryptionKey, encryptionIV);
-                    outFile << encryptedEvent << std::endl;
+                    outFile << encryptedEvent << "\n";
                 } catch (const std::exception& e) {
                     std::cerr << "[ERROR] Falló el cifrado del log: " << e.what() << std::endl;
                 }
@@ -182,7 +182,7 @@ namespace mc_security {
             while (getline(inFile, encryptedLog)) {
                 try {
                     std::string decryptedLog = AESDecrypt(encryptedLog, encryptionKey, encryptionIV);
-                    std::cout << decryptedLog << std::endl;
+                    std::cout << decryptedLog << "\n";
                 } catch (const std::exception& e) {
                     std::cerr << "[ERROR] Falló el descifrado de un log: " << e.what() << std::endl;
                 }
@@ -144,8 +144,8 @@ std::vector<std::map<std::string, float>> OptimalConfigurationGeneration::genera
 
 // Registro de operaciones en el sistema
 void OptimalConfigurationGeneration::logOperation(const std::string& operation, const std::map<std::string, float>& parameters, bool success) const {
-    std::cout << "[LOG] Operation: " << operation << ", Status: " << (success ? "Success" : "Failure") << std::endl;
+    std::cout << "[LOG] Operation: " << operation << ", Status: " << (success ? "Success" : "Failure") << "\n";
     for (const auto& [key, value] : parameters) {
-        std::cout << "  " << key << ": " << value << std::endl;
+        std::cout << "  " << key << ": " << value << "\n";
     }
 }
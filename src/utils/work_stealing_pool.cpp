@@ -0,0 +1,88 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+namespace mc_utils {
+
+    WorkStealingPool::WorkStealingPool(size_t threads) {
+        threads = std::max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+        for (size_t i = 1; i < threads; ++i) threads_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& thread : threads_) thread.join();
+    }
+
+    void WorkStealingPool::run(size_t count, const std::function<void(size_t, size_t)>& task) {
+        if (count == 0) return;
+        // Rangos contiguos: el hilo i empieza por el trozo i-ésimo del espacio de índices
+        size_t threads = queues_.size();
+        for (size_t i = 0; i < threads; ++i) {
+            std::lock_guard<std::mutex> lock(queues_[i]->mutex);
+            for (size_t index = count * i / threads; index < count * (i + 1) / threads; ++index) {
+                queues_[i]->items.push_back(index);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            busy_ = threads_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [this] { return busy_ == 0; });
+        task_ = nullptr;
+    }
+
+    void WorkStealingPool::workerLoop(size_t worker) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) return;
+                seen = generation_;
+            }
+            work(worker);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_ == 0) finished_.notify_one();
+        }
+    }
+
+    void WorkStealingPool::work(size_t worker) {
+        size_t index;
+        while (take(worker, index)) (*task_)(worker, index);
+    }
+
+    bool WorkStealingPool::take(size_t worker, size_t& index) {
+        {
+            Queue& own = *queues_[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.items.empty()) {
+                index = own.items.front();
+                own.items.pop_front();
+                return true;
+            }
+        }
+        // Cola propia vacía: se roba el último índice de la siguiente cola con trabajo
+        for (size_t offset = 1; offset < queues_.size(); ++offset) {
+            Queue& victim = *queues_[(worker + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty()) {
+                index = victim.items.back();
+                victim.items.pop_back();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace mc_utils
@@ -0,0 +1,65 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mc_utils {
+
+    /**
+     * Grupo de hilos con robo de trabajo ("work stealing"). Lo usan PARA PARALELO y el
+     * análisis de módulos del núcleo y las operaciones en paralelo de la librería matemática.
+     *
+     * run() reparte los índices [0, count) en rangos contiguos, uno por hilo (el que
+     * llama es el hilo 0). Cada hilo consume su cola por el principio y, cuando se
+     * vacía, roba por el final de la cola de otro, así que los trozos lentos no dejan
+     * hilos ociosos. Los hilos se crean una vez y esperan entre ejecuciones.
+     */
+    class WorkStealingPool {
+    public:
+        explicit WorkStealingPool(size_t threads);
+        ~WorkStealingPool();
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        size_t size() const { return queues_.size(); }
+
+        // Ejecuta task(hilo, índice) para cada índice; task no debe lanzar excepciones
+        void run(size_t count, const std::function<void(size_t, size_t)>& task);
+
+        // Índices que un hilo tomó de la cola de otro desde la creación del grupo
+        uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<size_t> items;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable finished_;
+        const std::function<void(size_t, size_t)>* task_ = nullptr;
+        uint64_t generation_ = 0;
+        size_t busy_ = 0;
+        bool stopping_ = false;
+        std::atomic<uint64_t> steals_{0};
+
+        void workerLoop(size_t worker);
+        void work(size_t worker);
+        bool take(size_t worker, size_t& index);
+    };
+
+} // namespace mc_utils
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,264 @@
+#include "ast.h"
+#include "builtins.h"
+#include "bytecode_cache.h"
+#include "codegen.h"
+#include "object.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+const std::string kProgram =
+    "IMPORTAR math\n"
+    "CLASE Animal {\n"
+    "    VAR nombre: STRING\n"
+    "    CONSTRUCTOR(n: STRING) { nombre = n }\n"
+    "    FUNC sonido() { RETORNAR \"...\" }\n"
+    "    FUNC describir() { RETORNAR nombre + \" dice \" + sonido() }\n"
+    "}\n"
+    "CLASE Perro : Animal {\n"
+    "    CONSTRUCTOR(n: STRING) : Animal(n) {}\n"
+    "    FUNC sonido() { RETORNAR \"guau\" }\n"
+    "}\n"
+    "MODULO Util {\n"
+    "    FUNC doble(x) { RETORNAR x * 2 }\n"
+    "}\n"
+    "FUNC fallar(x) {\n"
+    "    RETORNAR x / 0\n"
+    "}\n"
+    "VAR r = Perro(\"Rex\").describir() + \" \" + Util.doble(21) + \" \" + math.sumar(1, 2.5)\n";
+
+std::string cacheFile(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("mcpp_cache_test_" + name + ".mcc")).string();
+}
+
+// Compila el programa en un VM nuevo y guarda la caché
+bool compileAndWrite(const std::string& source, const std::string& path) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    VM vm;
+    registerBuiltins(vm);
+    FunctionProto* script = compileProgram(vm, arena, program);
+    return writeBytecodeCache(vm, script, hashSource(source), 0, path);
+}
+
+void test_round_trip() {
+    std::string path = cacheFile("round_trip");
+    run_test("Caché: escritura", compileAndWrite(kProgram, path));
+
+    VM vm;
+    registerBuiltins(vm);
+    FunctionProto* script = loadBytecodeCache(vm, hashSource(kProgram), 0, path);
+    run_test("Caché: carga", script != nullptr);
+    if (script == nullptr) return;
+
+    vm.run(script);
+    Value r = vm.getGlobal("r");
+    run_test("Caché: clases, módulos y constantes", isString(r) && asString(r)->view() == "Rex dice guau 42 3.5");
+
+    std::string error;
+    try {
+        vm.call(vm.getGlobal("fallar"), {Value::integer(1)});
+    } catch (const RuntimeError& e) {
+        error = e.what();
+    }
+    run_test("Caché: las líneas de error se conservan", error.find("línea 16") != std::string::npos);
+    std::remove(path.c_str());
+}
+
+void test_invalidation() {
+    std::string path = cacheFile("invalidation");
+    compileAndWrite(kProgram, path);
+
+    VM stale;
+    registerBuiltins(stale);
+    size_t globals = stale.globalCount();
+    run_test("Caché: un fuente modificado la invalida",
+             loadBytecodeCache(stale, hashSource(kProgram + "\n"), 0, path) == nullptr &&
+                 stale.globalCount() == globals);
+
+    VM extra;
+    registerBuiltins(extra);
+    extra.globalSlot("otra");
+    run_test("Caché: globales distintas la invalidan",
+             loadBytecodeCache(extra, hashSource(kProgram), 0, path) == nullptr);
+
+    // Guardada sin optimizar: no sirve a quien pide -O1 o -O2
+    VM optimized;
+    registerBuiltins(optimized);
+    run_test("Caché: otro nivel de -O la invalida",
+             loadBytecodeCache(optimized, hashSource(kProgram), 1, path) == nullptr &&
+                 loadBytecodeCache(optimized, hashSource(kProgram), 2, path) == nullptr);
+
+    // Archivo truncado
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size() / 2));
+    }
+    VM truncated;
+    registerBuiltins(truncated);
+    globals = truncated.globalCount();
+    run_test("Caché: archivo truncado",
+             loadBytecodeCache(truncated, hashSource(kProgram), 0, path) == nullptr &&
+                 truncated.globalCount() == globals);
+
+    VM missing;
+    registerBuiltins(missing);
+    std::remove(path.c_str());
+    run_test("Caché: archivo inexistente", loadBytecodeCache(missing, hashSource(kProgram), 0, path) == nullptr);
+}
+
+// Un operando fuera de rango con la cabecera intacta: el VM lo usaría sin comprobar, así que la
+// carga debe fallar y el intérprete volver al fuente
+void test_corrupted_operand() {
+    std::string path = cacheFile("corrupted_operand");
+    AstArena arena;
+    NodeId program = parseSource(kProgram, arena);
+    VM writer;
+    registerBuiltins(writer);
+    FunctionProto* script = compileProgram(writer, arena, program);
+    writeBytecodeCache(writer, script, hashSource(kProgram), 0, path);
+
+    size_t loadk = 0;
+    while (loadk < script->codeSize() && opOf(script->codeBegin()[loadk]) != OpCode::LOADK) ++loadk;
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    // El código del script se guarda tal cual: se busca entero y se cambia sólo el Bx del LOADK
+    size_t at = contents.find(std::string(reinterpret_cast<const char*>(script->codeBegin()),
+                                          script->codeSize() * sizeof(Instr)));
+    if (loadk < script->codeSize() && at != std::string::npos) {
+        Instr corrupted = encodeABx(OpCode::LOADK, argA(script->codeBegin()[loadk]), 0xFFFF);
+        std::memcpy(&contents[at + loadk * sizeof(Instr)], &corrupted, sizeof(corrupted));
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    VM vm;
+    registerBuiltins(vm);
+    size_t globals = vm.globalCount();
+    run_test("Caché: un operando alterado la invalida",
+             loadk < script->codeSize() && at != std::string::npos &&
+                 loadBytecodeCache(vm, hashSource(kProgram), 0, path) == nullptr && vm.globalCount() == globals);
+    std::remove(path.c_str());
+}
+
+// Un archivo con su hash correcto pero operandos fuera de rango (como uno editado que
+// recalcula payloadHash) tampoco se carga
+void test_invalid_operands() {
+    std::string path = cacheFile("invalid_operands");
+    AstArena arena;
+    NodeId program = parseSource(kProgram, arena);
+    VM writer;
+    registerBuiltins(writer);
+    FunctionProto* script = compileProgram(writer, arena, program);
+    std::vector<Instr> original = script->code;
+    uint32_t last = static_cast<uint32_t>(original.size()) - 1;
+    const Instr invalid[] = {
+        encodeABx(OpCode::LOADK, 0, static_cast<uint32_t>(script->constants.size())),
+        encodeABC(OpCode::MOVE, script->numRegs, 0, 0),
+        encodeABC(OpCode::ADD, 0, 0, kMaxRegisters),
+        encodeABx(OpCode::GETGLOBAL, 0, static_cast<uint32_t>(writer.globalCount())),
+        encodeAsBx(OpCode::JMP, 0, static_cast<int32_t>(original.size())),
+        encodeAsBx(OpCode::JMPIF, 0, -2),
+        encodeABC(OpCode::CALL, script->numRegs - 1, 2, 0),
+        encodeABC(OpCode::NEWMAP, 0, script->numRegs - 1, 1),
+    };
+    bool rejected = true;
+    for (Instr instr : invalid) {
+        // Se sustituye la primera instrucción; el archivo se escribe con su hash correcto
+        script->code = original;
+        script->code[0] = instr;
+        bool written = writeBytecodeCache(writer, script, hashSource(kProgram), 0, path);
+        VM vm;
+        registerBuiltins(vm);
+        rejected = rejected && written && loadBytecodeCache(vm, hashSource(kProgram), 0, path) == nullptr;
+    }
+
+    // El código no puede seguir de largo más allá de la última instrucción
+    script->code = original;
+    script->code[last] = encodeABC(OpCode::LOADNIL, 0, 0, 0);
+    writeBytecodeCache(writer, script, hashSource(kProgram), 0, path);
+    VM fallsThrough;
+    registerBuiltins(fallsThrough);
+    rejected = rejected && loadBytecodeCache(fallsThrough, hashSource(kProgram), 0, path) == nullptr;
+
+    script->code = original;
+    writeBytecodeCache(writer, script, hashSource(kProgram), 0, path);
+    VM intact;
+    registerBuiltins(intact);
+    run_test("Caché: se rechazan registros, constantes, globales y saltos fuera de rango",
+             rejected && loadBytecodeCache(intact, hashSource(kProgram), 0, path) != nullptr);
+    std::remove(path.c_str());
+}
+
+// Las tablas de SELECCION y las superinstrucciones sobreviven a la caché
+void test_switch_tables() {
+    const std::string source = "FUNC clase(x) {\n    SELECCION x {\n        CASO \"a\": RETORNAR 1\n"
+                               "        CASO \"e\": RETORNAR 1\n        CASO 10: RETORNAR 2\n"
+                               "        CASO 20: RETORNAR 2\n        CASO 1000: RETORNAR 3\n"
+                               "        DEFECTO: RETORNAR 0\n    }\n}\n"
+                               "VAR r = 0\nVAR i = 0\nMIENTRAS i < 30 {\n    r = r * 2 + clase(i)\n    i = i + 10\n}\n"
+                               "r = [r, clase(\"e\"), clase(1000.0), clase(\"b\")]\n";
+    std::string path = cacheFile("switch");
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    VM compiled;
+    registerBuiltins(compiled);
+    FunctionProto* script = compileProgram(compiled, arena, program);
+    optimizeProgram(compiled, 1);
+    bool written = writeBytecodeCache(compiled, script, hashSource(source), 1, path);
+
+    VM vm;
+    registerBuiltins(vm);
+    FunctionProto* loaded = loadBytecodeCache(vm, hashSource(source), 1, path);
+    if (loaded != nullptr) vm.run(loaded);
+    Value clase = vm.getGlobal("clase");
+    run_test("Caché: tablas de SELECCION y superinstrucciones",
+             written && loaded != nullptr && valueToString(vm.getGlobal("r")) == "[6, 1, 3, 0]" &&
+                 isObjType(clase, ObjType::FUNCTION) && asFunction(clase)->proto->switchTables.size() == 1);
+    std::remove(path.c_str());
+}
+
+void test_cache_path() {
+    run_test("Caché: ruta junto al fuente", cachePathFor("examples/basic_syntax.mc") == "examples/basic_syntax.mcc");
+}
+
+int main() {
+    std::cout << "Iniciando pruebas de la caché de bytecode de MC++" << std::endl;
+
+    test_round_trip();
+    test_invalidation();
+    test_corrupted_operand();
+    test_invalid_operands();
+    test_switch_tables();
+    test_cache_path();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
@@ -0,0 +1,273 @@
+#include "ast.h"
+#include "codegen.h"
+#include "compiler.h"
+#include "cpp_emitter.h"
+#include "interpreter.h"
+#include "parser.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+const std::filesystem::path kWorkDir = std::filesystem::temp_directory_path() / "mcpp_emit_tests";
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+// Traduce el fuente y devuelve el C++ generado (o el error, si se rechaza)
+std::string emit(const std::string& source, CppProgram* program = nullptr) {
+    try {
+        AstArena arena;
+        NodeId root = parseSource(source, arena);
+        CppProgram result = emitCpp(arena, root, "prueba.mc");
+        if (program != nullptr) *program = result;
+        return result.source;
+    } catch (const std::exception& e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+// Salida del intérprete (stdout, y el error como lo muestra mc++)
+std::string interpret(const std::filesystem::path& path) {
+    std::fflush(stdout);
+    std::filesystem::path captured = kWorkDir / "interpretado.txt";
+    int saved = dup(1);
+    int fd = open(captured.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    dup2(fd, 1);
+    close(fd);
+    std::string error;
+    try {
+        Interpreter(path.string(), false).run();
+    } catch (const std::exception& e) {
+        error = std::string("Excepción capturada: ") + e.what() + "\n";
+    }
+    std::fflush(stdout);
+    dup2(saved, 1);
+    close(saved);
+    return readFile(captured) + error;
+}
+
+// Salida del ejecutable nativo generado con --emit=cpp (stdout y después stderr)
+std::string compileAndRun(const std::filesystem::path& path) {
+    std::filesystem::path binary = std::filesystem::path(path).replace_extension("");
+    std::filesystem::remove(binary);
+    try {
+        std::fflush(stdout);
+        Compiler(path.string(), false, 2, true).run();
+    } catch (const std::exception& e) {
+        return std::string("error: ") + e.what();
+    }
+    std::filesystem::path out = kWorkDir / "nativo.txt";
+    std::filesystem::path err = kWorkDir / "nativo_err.txt";
+    std::string command = "'" + binary.string() + "' > '" + out.string() + "' 2> '" + err.string() + "'";
+    int status = std::system(command.c_str());
+    (void)status;
+    return readFile(out) + readFile(err);
+}
+
+// El ejecutable nativo muestra exactamente lo mismo que el intérprete
+void expectSameOutput(const std::string& name, const std::string& source) {
+    std::filesystem::path path = kWorkDir / "programa.mc";
+    std::ofstream(path, std::ios::binary) << source;
+    std::string interpreted = interpret(path);
+    std::string native = compileAndRun(path);
+    bool same = interpreted == native && !interpreted.empty();
+    if (!same) std::cerr << "  interpretado:\n" << interpreted << "  nativo:\n" << native << std::endl;
+    run_test("--emit=cpp: " + name, same);
+}
+
+// Pruebas de la traducción (sin compilador de C++)
+void test_translation() {
+    CppProgram program;
+    std::string source = emit("FUNC hipotenusa(a: FLOAT, b: FLOAT): FLOAT {\n"
+                              "    RETORNAR RAIZ(a * a + b * b)\n"
+                              "}\n"
+                              "MOSTRAR(hipotenusa(3.0, 4.0), \"hola\".MAYUSCULAS())\n",
+                              &program);
+    run_test("--emit=cpp: RAIZ y MAYUSCULAS llaman directamente a src/libraries",
+             source.find("AdvancedOperations::sqrt(") != std::string::npos &&
+                 source.find("TextTransformation::toUpper(") != std::string::npos && program.libraries.size() == 2 &&
+                 program.libraries[0] == "math/advanced_operations.cpp" &&
+                 program.libraries[1] == "string/text_transformation.cpp");
+    run_test("--emit=cpp: las funciones tipadas pasan a funciones de C++",
+             source.find("static double f_hipotenusa(double v_a, double v_b)") != std::string::npos);
+
+    emit("MOSTRAR(1 + 2)\n", &program);
+    run_test("--emit=cpp: sin RAIZ ni métodos de cadena no se enlaza ninguna biblioteca", program.libraries.empty());
+
+    std::string loop = emit("VAR s = 0\n"
+                            "PARA i DESDE 0 HASTA 1000 {\n"
+                            "    s = s + i\n"
+                            "}\n");
+    run_test("--emit=cpp: un PARA con paso literal es un for con una comparación",
+             loop.find("for (; v_i < lim1_; v_i += INT64_C(1))") != std::string::npos);
+
+    run_test("--emit=cpp: un parámetro sin tipo se rechaza con su línea",
+             emit("VAR x = 1\nFUNC f(a) {\n    MOSTRAR(a)\n}\n")
+                     .find("(línea 2): el parámetro 'a' de f necesita un tipo") != std::string::npos);
+    run_test("--emit=cpp: una variable no puede cambiar de tipo",
+             emit("VAR x = 1\nx = 2.5\n").find("(línea 2): 'x' es INT pero recibe un FLOAT") != std::string::npos);
+    run_test("--emit=cpp: un FLOAT declarado no acepta un INT (el VM guardaría el INT)",
+             emit("VAR x: FLOAT = 1\n").find("'x' es FLOAT pero recibe un INT") != std::string::npos);
+    run_test("--emit=cpp: CLASE no se admite",
+             emit("CLASE A {\n}\n").find("--emit=cpp no admite CLASE y STRUCT") != std::string::npos);
+}
+
+// Pruebas de ejecución: la salida nativa coincide con la interpretada
+void test_native_output() {
+    expectSameOutput("aritmética INT/FLOAT y formato de FLOAT",
+                     "VAR a = 17\n"
+                     "VAR b = -5\n"
+                     "MOSTRAR(a / b, a % b, -a / 3, -a % 3, a * b - 2)\n"
+                     "MOSTRAR(a / 2.0, 0.1 + 0.2, 10.0, 1.5e21, 2.0 / 3, -0.0)\n"
+                     "MOSTRAR(7.5 % 2, a + 0.5, ABS(b), ABS(-2.5), POTENCIA(3, 4), POTENCIA(2, 0.5))\n"
+                     "MOSTRAR(\"suma: \" + a + \", \" + 2.5 + \" \" + VERDADERO + \" \" + (a > b))\n"
+                     "MOSTRAR(a == 17.0, a != b, \"abc\" < \"abd\", NO (a < b), a > 3 Y b < 0, a < 3 O b > 0)\n"
+                     "MOSTRAR(SI a > b ENTONCES \"mayor\" SINO \"menor\")\n");
+    expectSameOutput("bucles PARA, MIENTRAS, PARA CADA y SELECCION",
+                     "VAR s = 0\n"
+                     "PARA i DESDE 10 HASTA 0 INCREMENTO -3 {\n"
+                     "    s = s * 10 + i\n"
+                     "}\n"
+                     "VAR t = 0.0\n"
+                     "PARA f DESDE 0 HASTA 2 INCREMENTO 0.25 {\n"
+                     "    t = t + f\n"
+                     "}\n"
+                     "VAR u = 0\n"
+                     "PARA k DESDE 0 HASTA 3.5 {\n"
+                     "    u = u + k\n"
+                     "}\n"
+                     "VAR paso = -2\n"
+                     "PARA k DESDE 5 HASTA 0 INCREMENTO paso {\n"
+                     "    u = u + k\n"
+                     "}\n"
+                     "MOSTRAR(s, t, u)\n"
+                     "VAR n = 0\n"
+                     "MIENTRAS VERDADERO {\n"
+                     "    n = n + 1\n"
+                     "    SI n % 2 == 0 {\n"
+                     "        CONTINUAR\n"
+                     "    }\n"
+                     "    SI n > 9 {\n"
+                     "        ROMPER\n"
+                     "    }\n"
+                     "    MOSTRAR(\"impar\", n)\n"
+                     "}\n"
+                     "VAR v: ARRAY<INT> = [1, 2, 3]\n"
+                     "PARA CADA x EN v {\n"
+                     "    SI x < 3 {\n"
+                     "        v.AGREGAR(x * 10)\n"
+                     "    }\n"
+                     "    SELECCION x {\n"
+                     "        CASO 1:\n"
+                     "            MOSTRAR(\"uno\")\n"
+                     "        DEFECTO:\n"
+                     "            MOSTRAR(\"otro\", x)\n"
+                     "        CASO x > 15:\n"
+                     "            MOSTRAR(\"grande\", x)\n"
+                     "    }\n"
+                     "}\n"
+                     "MOSTRAR(v)\n");
+    expectSameOutput("ARRAY tipados, cadenas y conversiones",
+                     "VAR f: ARRAY<FLOAT> = [1, 2.5, 3]\n"
+                     "f[0] = 4\n"
+                     "f[1] += 0.25\n"
+                     "f.AGREGAR(7)\n"
+                     "VAR n = [5, 3, 9]\n"
+                     "VAR alias = n\n"
+                     "alias[1] = 30\n"
+                     "MOSTRAR(f, LONGITUD(f), n, n.SUMA(), n.MINIMO(), n.MAXIMO(), n.CONTIENE(9.0), f.CONTIENE(3))\n"
+                     "VAR texto = \"Año número\"\n"
+                     "MOSTRAR(LONGITUD(texto), texto.MAYUSCULAS(), texto.MINUSCULAS(), texto.ES_VACIO())\n"
+                     "MOSTRAR(ENTERO(\"42\") + 1, ENTERO(-3.9), DECIMAL(\"2.5\") * 2, DECIMAL(3), CADENA(12) + \"!\")\n"
+                     "MOSTRAR(TIPO(1), TIPO(1.0), TIPO(\"a\"), TIPO(f), TIPO(VERDADERO), RAIZ(2), RAIZ(16))\n"
+                     "VAR s = \"\"\n"
+                     "PARA i DESDE 0 HASTA 5 {\n"
+                     "    s = s + i + \",\"\n"
+                     "    s += \"-\"\n"
+                     "}\n"
+                     "MOSTRAR(s)\n");
+    expectSameOutput("funciones, recursión, globales y orden de evaluación",
+                     "VAR llamadas = 0\n"
+                     "FUNC fib(n: INT): INT {\n"
+                     "    llamadas = llamadas + 1\n"
+                     "    SI n < 2 {\n"
+                     "        RETORNAR n\n"
+                     "    }\n"
+                     "    RETORNAR fib(n - 1) + fib(n - 2)\n"
+                     "}\n"
+                     "FUNC eco(x: INT): INT {\n"
+                     "    MOSTRAR(\"eco\", x)\n"
+                     "    RETORNAR x\n"
+                     "}\n"
+                     "FUNC escala(v: ARRAY<FLOAT>, k: FLOAT) {\n"
+                     "    PARA i DESDE 0 HASTA LONGITUD(v) {\n"
+                     "        v[i] = v[i] * k\n"
+                     "    }\n"
+                     "}\n"
+                     "FUNC main() {\n"
+                     "    MOSTRAR(fib(20), llamadas)\n"
+                     "    MOSTRAR(eco(1) - eco(2) * eco(3), eco(4) < eco(5))\n"
+                     "    VAR datos: ARRAY<FLOAT> = [1.0, 2.0]\n"
+                     "    escala(datos, 1.5)\n"
+                     "    MOSTRAR(datos)\n"
+                     "}\n");
+    expectSameOutput("división por cero: mismo mensaje, línea y función",
+                     "FUNC divide(a: INT, b: INT): INT {\n"
+                     "    RETORNAR a / b\n"
+                     "}\n"
+                     "MOSTRAR(\"antes\")\n"
+                     "MOSTRAR(divide(10, 0))\n");
+    expectSameOutput("índice fuera de rango en el nivel superior",
+                     "VAR v = [1, 2, 3]\n"
+                     "PARA i DESDE 0 HASTA 5 {\n"
+                     "    MOSTRAR(v[i])\n"
+                     "}\n");
+    expectSameOutput("RAIZ de un negativo",
+                     "VAR x = 2.0\n"
+                     "MOSTRAR(RAIZ(x - 3))\n");
+
+    std::filesystem::path path = kWorkDir / "programa.mc";
+    std::ofstream(path, std::ios::binary) << "VAR x = 1\n"
+                                             "PARA i DESDE 0 HASTA 60 {\n"
+                                             "    x = x * 2\n"
+                                             "}\n";
+    run_test("--emit=cpp: un INT que no cabe en 51 bits es un error en lugar de pasar a FLOAT",
+             compileAndRun(path).find("(línea 3, en <script>): desbordamiento de INT") != std::string::npos);
+}
+
+int main() {
+    std::filesystem::create_directories(kWorkDir);
+    test_translation();
+    if (std::system("g++ --version > /dev/null 2>&1") == 0 || std::getenv("CXX") != nullptr) {
+        if (std::getenv("MCPP_LIBRARY_DIR") == nullptr) {
+            setenv("MCPP_LIBRARY_DIR", std::filesystem::absolute("src/libraries").c_str(), 1);
+        }
+        test_native_output();
+    } else {
+        std::cout << "Sin compilador de C++: se omiten las pruebas de ejecución." << std::endl;
+    }
+    std::filesystem::remove_all(kWorkDir);
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
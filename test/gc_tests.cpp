@@ -0,0 +1,122 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "heap.h"
+#include "object.h"
+#include "parser.h"
+#include "vm.h"
+#include <iostream>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Compila y ejecuta un programa con una generación joven pequeña para forzar muchas recolecciones
+void runSource(VM& vm, const std::string& source) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    vm.heap().setNurserySize(64 * 1024);
+    vm.run(compileProgram(vm, arena, program));
+}
+
+bool isIntValue(Value v, int64_t expected) {
+    return v.isInt() && v.asInt() == expected;
+}
+
+// Objetos jóvenes guardados en objetos viejos: sólo la barrera de escritura los mantiene vivos
+void test_write_barrier() {
+    VM vm;
+    runSource(vm,
+              "CLASE Caja { VAR contenido }\n"
+              "VAR lista = [0]\n"
+              "VAR mapa = {}\n"
+              "VAR caja = Caja()\n"
+              "PARA i DESDE 0 HASTA 20000 {\n"
+              "    VAR basura = [i, i + 1, \"texto\" + i]\n"
+              "    lista[0] = [i]\n"
+              "    mapa[\"clave\"] = [i * 2]\n"
+              "    caja.contenido = [i * 3]\n"
+              "    SI i % 1000 == 0 { lista.AGREGAR([\"guardado\" + i]) }\n"
+              "}\n"
+              "VAR r = lista[0][0] + mapa[\"clave\"][0] + caja.contenido[0] + LONGITUD(lista)\n");
+    GcStats stats = vm.heap().stats();
+    run_test("GC: hubo recolecciones menores", stats.minorCollections > 10);
+    run_test("GC: ARRAY, MAP y campos viejos conservan valores jóvenes",
+             isIntValue(vm.getGlobal("r"), 19999 * 6 + 21));
+    Value lista = vm.getGlobal("lista");
+    Value last = asArray(lista)->items.back();
+    run_test("GC: elementos añadidos con AGREGAR",
+             isString(asArray(last)->items[0]) && asString(asArray(last)->items[0])->view() == "guardado19000");
+}
+
+// La basura se libera y el heap no crece sin límite
+void test_reclamation() {
+    VM vm;
+    runSource(vm,
+              "VAR total = 0\n"
+              "PARA i DESDE 0 HASTA 200000 {\n"
+              "    VAR temporal = {\"a\": [i], \"b\": \"cadena \" + i}\n"
+              "    total += temporal[\"a\"][0]\n"
+              "}\n");
+    GcStats stats = vm.heap().stats();
+    run_test("GC: resultado correcto tras recolectar", isIntValue(vm.getGlobal("total"), 19999900000));
+    run_test("GC: la memoria viva se mantiene acotada", stats.liveBytes < 1024 * 1024);
+    run_test("GC: la tasa de promoción es baja", stats.promotionRate() < 0.1);
+    run_test("GC: se registran las pausas", stats.totalPauseMs > 0.0 && stats.maxPauseMs >= stats.lastPauseMs);
+}
+
+// Ciclos de referencias y recolección completa
+void test_cycles() {
+    VM vm;
+    runSource(vm,
+              "CLASE Nodo { VAR otro }\n"
+              "PARA i DESDE 0 HASTA 5000 {\n"
+              "    VAR a = Nodo()\n"
+              "    VAR b = Nodo()\n"
+              "    a.otro = b\n"
+              "    b.otro = a\n"
+              "}\n"
+              "VAR vivo = Nodo()\n"
+              "vivo.otro = vivo\n");
+    vm.collectGarbage(true);
+    size_t afterFirst = vm.heap().objectCount();
+    vm.collectGarbage(true);
+    GcStats stats = vm.heap().stats();
+    run_test("GC: los ciclos inalcanzables se liberan", afterFirst < 200 && stats.objectCount == afterFirst);
+    run_test("GC: recolección completa", stats.majorCollections == 2);
+    Value vivo = vm.getGlobal("vivo");
+    run_test("GC: los ciclos alcanzables sobreviven", asInstance(vivo)->fields[0].asObj() == vivo.asObj());
+}
+
+// El módulo "gc" expone las estadísticas al programa
+void test_runtime_stats() {
+    VM vm;
+    runSource(vm,
+              "IMPORTAR gc\n"
+              "PARA i DESDE 0 HASTA 50000 { VAR x = [i] }\n"
+              "gc.recolectar()\n"
+              "VAR e = gc.estadisticas()\n"
+              "VAR r = e[\"recolecciones_completas\"] >= 1 Y e[\"memoria_heap\"] > 0 Y e[\"tasa_promocion\"] < 1.0\n");
+    run_test("GC: gc.estadisticas() desde MC++", vm.getGlobal("r").isTruthy());
+}
+
+int main() {
+    std::cout << "Iniciando pruebas del recolector de basura de MC++" << std::endl;
+
+    test_write_barrier();
+    test_reclamation();
+    test_cycles();
+    test_runtime_stats();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
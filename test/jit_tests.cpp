@@ -0,0 +1,232 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "jit.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <iostream>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Ejecuta el programa y devuelve sus globales como texto (o el error, si falla)
+std::string runProgram(const std::string& source, bool jit, Jit::Stats* stats = nullptr, int level = 2) {
+    VM vm;
+    std::string result;
+    try {
+        AstArena arena;
+        NodeId program = parseSource(source, arena);
+        registerBuiltins(vm);
+        vm.setJitEnabled(jit);
+        FunctionProto* script = compileProgram(vm, arena, program);
+        optimizeProgram(vm, level);
+        vm.run(script);
+        for (size_t slot = 0; slot < vm.globalCount(); ++slot) {
+            Value value = vm.getGlobal(vm.globalName(static_cast<uint32_t>(slot)));
+            if (!isObjType(value, ObjType::FUNCTION) && !isObjType(value, ObjType::NATIVE)) {
+                result += vm.globalName(static_cast<uint32_t>(slot)) + "=" + valueToString(value) + ";";
+            }
+        }
+    } catch (const std::exception& e) {
+        result = std::string("error: ") + e.what();
+    }
+    if (stats != nullptr && vm.jit() != nullptr) *stats = vm.jit()->stats();
+    return result;
+}
+
+// El programa da lo mismo con trazas que interpretado, y con `traced` se compila alguna
+void expectSame(const std::string& name, const std::string& source, bool traced = true) {
+    Jit::Stats stats;
+    std::string interpreted = runProgram(source, false);
+    std::string compiled = runProgram(source, true, &stats);
+    bool same = interpreted == compiled;
+    if (!same) std::cerr << "  interpretado: " << interpreted << "\n  con trazas:   " << compiled << std::endl;
+    run_test("JIT: " + name, same && (!traced || stats.traces > 0));
+}
+
+// Pruebas de bucles numéricos
+void test_numeric_loops() {
+    expectSame("suma de INT en PARA",
+               "VAR s = 0\n"
+               "PARA i DESDE 0 HASTA 100000 {\n"
+               "    s = s + i * 3 - 1\n"
+               "}\n");
+    expectSame("FLOAT y mezcla INT/FLOAT",
+               "VAR x = 0.5\n"
+               "VAR y = 0\n"
+               "PARA i DESDE 0 HASTA 50000 {\n"
+               "    x = x * 1.0001 + i / 7.0\n"
+               "    y = y + i * 0.5 - x / 3\n"
+               "}\n");
+    expectSame("división y módulo enteros con signo",
+               "VAR q = 0\n"
+               "VAR m = 0\n"
+               "PARA i DESDE -5000 HASTA 5000 {\n"
+               "    q = q + i / 7 + (-i) / 3\n"
+               "    m = m + i % 7 + i % -3\n"
+               "}\n");
+    expectSame("paso negativo y límite FLOAT",
+               "VAR s = 0\n"
+               "PARA i DESDE 1000 HASTA 0 INCREMENTO -3 {\n"
+               "    s = s + i\n"
+               "}\n"
+               "VAR t = 0.0\n"
+               "PARA f DESDE 0.0 HASTA 100.0 INCREMENTO 0.25 {\n"
+               "    t = t + f\n"
+               "}\n");
+    expectSame("MIENTRAS con comparaciones y NO",
+               "VAR k = 0\n"
+               "VAR pares = 0\n"
+               "MIENTRAS (k < 200000) {\n"
+               "    SI (NO (k % 2 == 1)) {\n"
+               "        pares = pares + 1\n"
+               "    }\n"
+               "    k = k + 1\n"
+               "}\n");
+    expectSame("negación y comparaciones FLOAT",
+               "VAR a = 0.0\n"
+               "VAR menores = 0\n"
+               "PARA i DESDE 0 HASTA 20000 {\n"
+               "    a = -a + 0.5\n"
+               "    SI (a <= 0.25) {\n"
+               "        menores = menores + 1\n"
+               "    }\n"
+               "}\n");
+    expectSame("globales leídas y escritas dentro del bucle",
+               "VAR total = 0\n"
+               "VAR factor = 3\n"
+               "FUNC acumula(n) {\n"
+               "    PARA i DESDE 0 HASTA n {\n"
+               "        total = total + i * factor\n"
+               "    }\n"
+               "}\n"
+               "acumula(100000)\n");
+}
+
+// Pruebas de salidas de la traza hacia el intérprete
+void test_exits() {
+    expectSame("un INT que desborda pasa a FLOAT",
+               "VAR x = 1\n"
+               "PARA i DESDE 0 HASTA 200 {\n"
+               "    x = x * 3\n"
+               "}\n",
+               false);
+    expectSame("una rama alterna sigue siendo correcta",
+               "VAR a = 0\n"
+               "VAR b = 0\n"
+               "PARA i DESDE 0 HASTA 100000 {\n"
+               "    SI (i % 2 == 0) {\n"
+               "        a = a + 1\n"
+               "    } SINO {\n"
+               "        b = b + 2\n"
+               "    }\n"
+               "}\n",
+               false);
+    expectSame("un registro que cambia de tipo",
+               "VAR v = 0\n"
+               "VAR s = 0\n"
+               "PARA i DESDE 0 HASTA 30000 {\n"
+               "    SI (i == 15000) {\n"
+               "        v = 0.5\n"
+               "    }\n"
+               "    v = v + 1\n"
+               "    s = s + v\n"
+               "}\n",
+               false);
+    expectSame("ROMPER dentro del bucle",
+               "VAR s = 0\n"
+               "PARA i DESDE 0 HASTA 100000 {\n"
+               "    SI (i == 77777) {\n"
+               "        ROMPER\n"
+               "    }\n"
+               "    s = s + i\n"
+               "}\n",
+               false);
+    expectSame("bucles anidados",
+               "VAR s = 0\n"
+               "PARA i DESDE 0 HASTA 300 {\n"
+               "    PARA j DESDE 0 HASTA 300 {\n"
+               "        s = s + i * j % 11\n"
+               "    }\n"
+               "}\n");
+    expectSame("una llamada en el cuerpo queda en el intérprete",
+               "FUNC doble(x) {\n"
+               "    RETORNAR x * 2\n"
+               "}\n"
+               "VAR s = 0\n"
+               "PARA i DESDE 0 HASTA 5000 {\n"
+               "    s = s + doble(i)\n"
+               "}\n",
+               false);
+
+    std::string interpreted = runProgram("VAR s = 0\n"
+                                         "PARA i DESDE 0 HASTA 1000 {\n"
+                                         "    s = s + 100 / (500 - i)\n"
+                                         "}\n",
+                                         false);
+    std::string compiled = runProgram("VAR s = 0\n"
+                                      "PARA i DESDE 0 HASTA 1000 {\n"
+                                      "    s = s + 100 / (500 - i)\n"
+                                      "}\n",
+                                      true);
+    run_test("JIT: la división por cero da el mismo error y línea",
+             compiled == interpreted && compiled.find("línea 3") != std::string::npos &&
+                 compiled.find("división por cero") != std::string::npos);
+
+    Jit::Stats stats;
+    runProgram("VAR a = 0\n"
+               "PARA i DESDE 0 HASTA 100000 {\n"
+               "    SI (i % 2 == 0) {\n"
+               "        a = a + 1\n"
+               "    }\n"
+               "}\n",
+               true, &stats);
+    run_test("JIT: una traza que sale en cada vuelta acaba en el intérprete",
+             stats.blacklisted == 1 && stats.traces <= Jit::kMaxRecordings);
+}
+
+// Pruebas de ARRAY tipados
+void test_typed_arrays() {
+    expectSame("ARRAY<FLOAT> leído y escrito",
+               "VAR v: ARRAY<FLOAT> = [0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0]\n"
+               "VAR suma = 0.0\n"
+               "PARA vuelta DESDE 0 HASTA 5000 {\n"
+               "    PARA i DESDE 0 HASTA LONGITUD(v) {\n"
+               "        v[i] = v[i] * 0.5 + i\n"
+               "        suma = suma + v[i]\n"
+               "    }\n"
+               "}\n");
+    expectSame("ARRAY<INT> con un INT guardado en ARRAY<FLOAT>",
+               "VAR n: ARRAY<INT> = [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]\n"
+               "VAR f: ARRAY<FLOAT> = [0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0]\n"
+               "PARA vuelta DESDE 0 HASTA 3000 {\n"
+               "    PARA i DESDE 0 HASTA LONGITUD(n) {\n"
+               "        n[i] = (n[i] * 7 + vuelta) % 1000\n"
+               "    }\n"
+               "    PARA i DESDE 0 HASTA LONGITUD(f) {\n"
+               "        f[i] = i * vuelta\n"
+               "    }\n"
+               "}\n");
+}
+
+int main() {
+    if (!Jit::supported()) {
+        std::cout << "JIT no disponible en esta plataforma: pruebas omitidas." << std::endl;
+        return 0;
+    }
+    test_numeric_loops();
+    test_exits();
+    test_typed_arrays();
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
@@ -0,0 +1,398 @@
+#include "../src/libraries/math/gemm.h"
+#include "../src/libraries/math/linear_algebra.h"
+#include "../src/libraries/math/linear_algebra_advanced.h"
+#include "../src/libraries/math/lu_factorization.h"
+#include "../src/libraries/math/matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Diferencia máxima entre dos matrices de la misma forma
+float maxDifference(MatrixView<const float> a, MatrixView<const float> b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) return INFINITY;
+    float diff = 0;
+    for (std::size_t i = 0; i < a.rows(); i++) {
+        for (std::size_t j = 0; j < a.cols(); j++) {
+            diff = std::max(diff, std::abs(a(i, j) - b(i, j)));
+        }
+    }
+    return diff;
+}
+
+Matrix<float> randomMatrix(std::size_t rows, std::size_t cols, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    Matrix<float> m(rows, cols);
+    for (std::size_t i = 0; i < rows; i++) {
+        for (std::size_t j = 0; j < cols; j++) m(i, j) = distribution(generator);
+    }
+    return m;
+}
+
+// Producto de referencia en double, con el triple bucle directo
+Matrix<float> referenceProduct(MatrixView<const float> a, MatrixView<const float> b) {
+    Matrix<float> c(a.rows(), b.cols());
+    for (std::size_t i = 0; i < a.rows(); i++) {
+        for (std::size_t j = 0; j < b.cols(); j++) {
+            double sum = 0;
+            for (std::size_t k = 0; k < a.cols(); k++) sum += double(a(i, k)) * b(k, j);
+            c(i, j) = static_cast<float>(sum);
+        }
+    }
+    return c;
+}
+
+// Pruebas del almacenamiento contiguo y de las vistas
+void test_matrix_views() {
+    Matrix<int> m({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+    run_test("Matrix: filas consecutivas en un único bloque",
+             m.rows() == 3 && m.cols() == 3 && m.row(1) == m.data() + 3 && m(2, 1) == 8);
+
+    MatrixView<int> block = m.block(1, 1, 2, 2);
+    block(0, 0) = 50;
+    run_test("Matrix: un sub-bloque comparte la memoria de la matriz",
+             block.rows() == 2 && block(1, 1) == 9 && m(1, 1) == 50 && block.row_stride() == 3);
+
+    MatrixView<const int> transposed = m.transposed();
+    run_test("Matrix: la transpuesta es una vista con los pasos intercambiados",
+             transposed(0, 2) == 7 && transposed(2, 0) == 3 && !transposed.has_contiguous_rows() &&
+                 Matrix<int>(transposed) == Matrix<int>({{1, 4, 7}, {2, 50, 8}, {3, 6, 9}}));
+
+    run_test("Matrix: bloque de una transpuesta",
+             Matrix<int>(m.transposed().block(1, 0, 2, 2)) == Matrix<int>({{2, 50}, {3, 6}}));
+
+    bool outOfRange = false;
+    try {
+        m.block(2, 2, 2, 1);
+    } catch (const std::out_of_range&) {
+        outOfRange = true;
+    }
+    bool ragged = false;
+    try {
+        Matrix<int>(std::vector<std::vector<int>>{{1, 2}, {3}});
+    } catch (const std::invalid_argument&) {
+        ragged = true;
+    }
+    run_test("Matrix: bloques fuera de rango y filas de distinta longitud", outOfRange && ragged);
+
+    run_test("Matrix: ida y vuelta a la representación anidada",
+             Matrix<int>(m.to_nested()) == m && Matrix<int>(std::vector<std::vector<int>>{}).empty());
+}
+
+// Pruebas de LinearAlgebra con vistas y con los adaptadores anidados
+void test_linear_algebra() {
+    Matrix<int> a({{1, 2}, {3, 4}});
+    Matrix<int> b({{2, 0}, {1, 2}});
+    Matrix<int> product;
+    LinearAlgebra::matrix_multiply(a, b, product);
+    run_test("LinearAlgebra: multiplicación sobre Matrix", product == Matrix<int>({{4, 4}, {10, 8}}));
+
+    LinearAlgebra::matrix_multiply(a.transposed(), b, product);
+    run_test("LinearAlgebra: multiplicación por una transpuesta sin copiarla",
+             product == Matrix<int>({{5, 6}, {8, 8}}));
+
+    Matrix<int> big({{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}});
+    Matrix<int> sum;
+    LinearAlgebra::matrix_add(big.block(0, 0, 2, 2), big.block(1, 2, 2, 2), sum);
+    run_test("LinearAlgebra: suma de dos sub-bloques", sum == Matrix<int>({{8, 10}, {16, 18}}));
+
+    LinearAlgebra::matrix_add(a, a, a);
+    run_test("LinearAlgebra: el resultado puede ser una de las entradas", a == Matrix<int>({{2, 4}, {6, 8}}));
+
+    Matrix<int> transposed;
+    LinearAlgebra::matrix_transpose(big, transposed);
+    run_test("LinearAlgebra: transposición a una matriz nueva",
+             transposed.rows() == 4 && transposed.cols() == 3 && transposed(3, 0) == 4 && transposed(0, 2) == 9);
+
+    run_test("LinearAlgebra: determinante de una vista",
+             LinearAlgebra::matrix_determinant(Matrix<int>({{2, 0, 1}, {1, 3, 2}, {1, 1, 2}})) == 6 &&
+                 LinearAlgebra::matrix_determinant(big.block(0, 1, 3, 3)) == 0);
+
+    std::vector<std::vector<int>> nested;
+    LinearAlgebra::matrix_multiply({{1, 2}, {3, 4}}, {{2, 0}, {1, 2}}, nested);
+    std::vector<std::vector<int>> nestedSum = {{9, 9, 9}};
+    LinearAlgebra::matrix_add({{1, 2}, {3, 4}}, {{1, 1}, {1, 1}}, nestedSum);
+    std::vector<std::vector<int>> nestedTransposed;
+    LinearAlgebra::matrix_transpose({{1, 2, 3}}, nestedTransposed);
+    run_test("LinearAlgebra: las firmas anidadas se conservan",
+             nested == std::vector<std::vector<int>>{{4, 4}, {10, 8}} &&
+                 nestedSum == std::vector<std::vector<int>>{{2, 3}, {4, 5}} &&
+                 nestedTransposed == std::vector<std::vector<int>>{{1}, {2}, {3}} &&
+                 LinearAlgebra::matrix_determinant({{1, 2}, {3, 4}}) == -2);
+
+    bool mismatch = false;
+    try {
+        LinearAlgebra::matrix_multiply(big, big, product);
+    } catch (const std::invalid_argument&) {
+        mismatch = true;
+    }
+    std::vector<float> normalized = LinearAlgebra::normalize_vector({3, 4});
+    run_test("LinearAlgebra: dimensiones incompatibles y normalización",
+             mismatch && std::abs(normalized[0] - 0.6f) < 1e-6 && std::abs(normalized[1] - 0.8f) < 1e-6);
+}
+
+// Pruebas de LinearAlgebraAdvanced con vistas y con los adaptadores anidados
+void test_linear_algebra_advanced() {
+    Matrix<float> m({{4, 3, 2}, {2, 1, 3}, {3, 2, 1}});
+    Matrix<float> inverse, identity;
+    LinearAlgebraAdvanced::matrix_inverse(m, inverse);
+    LinearAlgebraAdvanced::matrix_multiply(m, inverse, identity);
+    run_test("LinearAlgebraAdvanced: A * inversa(A) = I",
+             maxDifference(identity, Matrix<float>({{1, 0, 0}, {0, 1, 0}, {0, 0, 1}})) < 1e-5);
+
+    Matrix<float> P, L, U, PA, LU;
+    LinearAlgebraAdvanced::matrix_lu_decomposition(m.transposed(), P, L, U);
+    LinearAlgebraAdvanced::matrix_multiply(P, m.transposed(), PA);
+    LinearAlgebraAdvanced::matrix_multiply(L, U, LU);
+    bool triangular = true;
+    for (std::size_t i = 0; i < 3; i++) {
+        triangular = triangular && L(i, i) == 1.0f;
+        for (std::size_t j = i + 1; j < 3; j++) triangular = triangular && L(i, j) == 0.0f && U(j, i) == 0.0f;
+    }
+    run_test("LinearAlgebraAdvanced: LU de una transpuesta, P * A = L * U con L y U triangulares",
+             triangular && maxDifference(LU, PA) < 1e-5);
+
+    Matrix<float> product;
+    LinearAlgebraAdvanced::matrix_multiply(m.block(0, 1, 3, 2).transposed(), m, product);
+    run_test("LinearAlgebraAdvanced: multiplicación de bloques transpuestos",
+             maxDifference(product, Matrix<float>({{20, 14, 11}, {17, 11, 14}})) < 1e-5);
+
+    std::vector<std::vector<float>> nestedInverse, linearInverse;
+    LinearAlgebraAdvanced::matrix_inverse({{2, 0}, {0, 4}}, nestedInverse);
+    LinearAlgebra::matrix_inverse({{2, 0}, {0, 4}}, linearInverse);
+    run_test("LinearAlgebraAdvanced: las firmas anidadas se conservan",
+             nestedInverse == std::vector<std::vector<float>>{{0.5f, 0}, {0, 0.25f}} && linearInverse == nestedInverse);
+}
+
+// Pruebas del GEMM por bloques con cada micro-núcleo que admite la CPU
+void test_gemm() {
+    // Formas que no son múltiplo de las teselas y un interior mayor que un bloque KC
+    Matrix<float> a = randomMatrix(37, 300, 1);
+    Matrix<float> b = randomMatrix(300, 53, 2);
+    Matrix<float> expected = referenceProduct(a, b);
+    Matrix<float> bt = randomMatrix(53, 300, 3);
+    Matrix<float> expectedTransposed = referenceProduct(a, bt.transposed());
+    GemmKernel best = Gemm::detect_kernel();
+    bool allKernels = true;
+    for (int kernel = 0; kernel <= static_cast<int>(best); kernel++) {
+        Gemm::set_kernel(static_cast<GemmKernel>(kernel));
+        Matrix<float> c(37, 53, 99.0f), ct(37, 53);
+        Gemm::multiply(a, b, c);
+        Gemm::multiply(a, bt.transposed(), ct);
+        allKernels = allKernels && maxDifference(c, expected) < 1e-4 && maxDifference(ct, expectedTransposed) < 1e-4;
+    }
+    Gemm::set_kernel(best);
+    run_test("Gemm: todos los micro-núcleos coinciden con la referencia, también con B transpuesta", allKernels);
+
+    // Más columnas que un bloque NC y un resultado escrito en un sub-bloque de otra matriz
+    Matrix<float> wide = randomMatrix(3, 3100, 4);
+    Matrix<float> left = randomMatrix(7, 3, 5);
+    Matrix<float> target(9, 3200, -1.0f);
+    Gemm::multiply(left, wide, target.block(1, 50, 7, 3100));
+    run_test("Gemm: varios bloques de columnas y salida en un sub-bloque",
+             maxDifference(target.block(1, 50, 7, 3100), referenceProduct(left, wide)) < 1e-5 &&
+                 target(0, 60) == -1.0f && target(8, 60) == -1.0f && target(1, 49) == -1.0f && target(1, 3150) == -1.0f);
+
+    Matrix<float> big1 = randomMatrix(150, 140, 6);
+    Matrix<float> big2 = randomMatrix(140, 130, 7);
+    Matrix<float> serial(150, 130), parallel(150, 130);
+    Gemm::set_thread_count(1);
+    Gemm::multiply(big1, big2, serial);
+    Gemm::set_thread_count(4);
+    Gemm::multiply(big1, big2, parallel);
+    Gemm::set_thread_count(0);
+    run_test("Gemm: el resultado con varios hilos es idéntico al de uno",
+             Gemm::thread_count() >= 1 && serial == parallel && maxDifference(serial, referenceProduct(big1, big2)) < 1e-4);
+
+    Matrix<float> empty(3, 0), emptyRight(0, 4), zeros(3, 4, 5.0f);
+    Gemm::multiply(empty, emptyRight, zeros);
+    bool mismatch = false;
+    try {
+        Gemm::multiply(a, a, zeros);
+    } catch (const std::invalid_argument&) {
+        mismatch = true;
+    }
+    run_test("Gemm: interior vacío y dimensiones incompatibles", zeros == Matrix<float>(3, 4, 0.0f) && mismatch);
+
+    Matrix<float> accumulated = randomMatrix(37, 53, 8);
+    Matrix<float> expectedDifference = accumulated;
+    for (std::size_t i = 0; i < 37; i++) {
+        for (std::size_t j = 0; j < 53; j++) expectedDifference(i, j) -= expected(i, j);
+    }
+    Gemm::multiply_subtract(a, b, accumulated);
+    run_test("Gemm: multiply_subtract resta el producto", maxDifference(accumulated, expectedDifference) < 1e-4);
+}
+
+// Pruebas de la factorización LU con pivoteo parcial
+void test_lu_factorization() {
+    // Sin pivoteo, el cero de la diagonal hacía fallar la factorización
+    LUFactorization swapped(Matrix<float>({{0, 1}, {1, 0}}));
+    std::vector<float> x = swapped.solve({3, 5});
+    run_test("LUFactorization: pivote cero en la diagonal",
+             !swapped.is_singular() && x == std::vector<float>{5, 3} && swapped.determinant() == -1.0f);
+
+    // Con un pivote diminuto, la eliminación sin pivoteo pierde toda la precisión
+    std::vector<float> tiny = LUFactorization(Matrix<float>({{1e-8f, 1}, {1, 1}})).solve({1, 2});
+    run_test("LUFactorization: el pivoteo parcial mantiene la precisión",
+             std::abs(tiny[0] - 1) < 1e-5 && std::abs(tiny[1] - 1) < 1e-5);
+
+    // Varias columnas de paneles, con la actualización por GEMM
+    std::size_t n = 200;
+    Matrix<float> a = randomMatrix(n, n, 9);
+    for (std::size_t i = 0; i < n; i++) a(i, i) += 4.0f;
+    LUFactorization lu(a);
+    Matrix<float> permuted(n, n), product;
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) permuted(i, j) = a(lu.permutation()[i], j);
+    }
+    LinearAlgebraAdvanced::matrix_multiply(lu.lower(), lu.upper(), product);
+    run_test("LUFactorization: PA = LU por bloques", maxDifference(product, permuted) < 1e-4);
+
+    std::vector<float> b(n);
+    for (std::size_t i = 0; i < n; i++) b[i] = static_cast<float>(i % 7) - 3.0f;
+    std::vector<float> solution = lu.solve(b);
+    float residual = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        float sum = 0;
+        for (std::size_t j = 0; j < n; j++) sum += a(i, j) * solution[j];
+        residual = std::max(residual, std::abs(sum - b[i]));
+    }
+    Matrix<float> rhs = randomMatrix(n, 3, 10);
+    for (std::size_t i = 0; i < n; i++) rhs(i, 1) = b[i];
+    Matrix<float> many = lu.solve_many(rhs);
+    Matrix<float> check;
+    LinearAlgebraAdvanced::matrix_multiply(a, many, check);
+    run_test("LUFactorization: solve y solve_many resuelven el sistema",
+             residual < 1e-3 && maxDifference(check, rhs) < 1e-3 && std::abs(many(17, 1) - solution[17]) < 1e-4);
+
+    Matrix<float> inverse = lu.inverse(), identity(n, n, 0.0f);
+    for (std::size_t i = 0; i < n; i++) identity(i, i) = 1.0f;
+    LinearAlgebraAdvanced::matrix_multiply(a, inverse, product);
+    run_test("LUFactorization: inversa y determinante",
+             maxDifference(product, identity) < 1e-4 &&
+                 std::abs(LUFactorization(Matrix<float>({{4, 3, 2}, {2, 1, 3}, {3, 2, 1}})).determinant() - 3) < 1e-5);
+
+    LUFactorization singular(Matrix<float>({{1, 2}, {2, 4}}));
+    bool solveThrows = false;
+    try {
+        singular.solve({1, 1});
+    } catch (const std::runtime_error&) {
+        solveThrows = true;
+    }
+    bool inverseThrows = false;
+    try {
+        std::vector<std::vector<float>> result;
+        LinearAlgebraAdvanced::matrix_inverse({{1, 2}, {2, 4}}, result);
+    } catch (const std::runtime_error&) {
+        inverseThrows = true;
+    }
+    run_test("LUFactorization: matrices singulares",
+             singular.is_singular() && singular.determinant() == 0 && solveThrows && inverseThrows);
+
+    std::vector<std::vector<float>> P, L, U;
+    LinearAlgebraAdvanced::matrix_lu_decomposition({{0, 2}, {3, 1}}, P, L, U);
+    run_test("LinearAlgebraAdvanced: LU con pivoteo, con la permutación aparte (P * A = L * U)",
+             P == std::vector<std::vector<float>>{{0, 1}, {1, 0}} &&
+                 L == std::vector<std::vector<float>>{{1, 0}, {0, 1}} &&
+                 U == std::vector<std::vector<float>>{{3, 1}, {0, 2}});
+}
+
+// Matriz entera L * U con L unitaria y U de diagonal dada: su determinante es el producto de la diagonal
+Matrix<int> integerWithDiagonal(const std::vector<int>& diagonal, unsigned seed) {
+    std::size_t n = diagonal.size();
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(-2, 2);
+    Matrix<int> lower(n, n, 0), upper(n, n, 0), product;
+    for (std::size_t i = 0; i < n; i++) {
+        lower(i, i) = 1;
+        upper(i, i) = diagonal[i];
+        for (std::size_t j = 0; j < i; j++) lower(i, j) = distribution(generator);
+        for (std::size_t j = i + 1; j < n; j++) upper(i, j) = distribution(generator);
+    }
+    LinearAlgebra::matrix_multiply(lower, upper, product);
+    return product;
+}
+
+// Pruebas del determinante exacto (Bareiss) y del de coma flotante (LU)
+void test_determinants() {
+    Matrix<int> twelve = integerWithDiagonal({1, -2, 3, 1, 2, -1, 1, 3, 2, 1, -1, 2}, 11);
+    run_test("Determinante: 12x12 exacto", LinearAlgebra::matrix_determinant(twelve) == -144);
+
+    // Intercambiar dos filas cambia el signo; una fila repetida lo anula
+    Matrix<int> swapped = twelve;
+    std::swap_ranges(swapped.row(0), swapped.row(0) + 12, swapped.row(5));
+    Matrix<int> repeated = twelve;
+    std::copy(repeated.row(2), repeated.row(2) + 12, repeated.row(9));
+    run_test("Determinante: intercambios de filas y matrices singulares",
+             LinearAlgebra::matrix_determinant(swapped) == 144 && LinearAlgebra::matrix_determinant(repeated) == 0 &&
+                 LinearAlgebra::matrix_determinant(Matrix<int>({{0, 0, 1}, {0, 2, 0}, {3, 0, 0}})) == -6);
+
+    std::vector<int> diagonal(60, 1);
+    diagonal[7] = 3;
+    diagonal[31] = -5;
+    diagonal[52] = 7;
+    run_test("Determinante: 60x60 en O(n³)",
+             LinearAlgebra::matrix_determinant(integerWithDiagonal(diagonal, 12)) == -105);
+
+    Matrix<int> large = integerWithDiagonal({100000, 100000}, 13);
+    Matrix<std::int64_t> large64(2, 2);
+    for (std::size_t i = 0; i < 2; i++) {
+        for (std::size_t j = 0; j < 2; j++) large64(i, j) = large(i, j);
+    }
+    bool intOverflow = false;
+    try {
+        LinearAlgebra::matrix_determinant(large);
+    } catch (const std::overflow_error&) {
+        intOverflow = true;
+    }
+    run_test("Determinante: un resultado fuera de int se detecta y cabe en int64_t",
+             intOverflow && LinearAlgebra::matrix_determinant(large64) == 10000000000LL);
+
+    Matrix<std::int64_t> huge({{3000000000LL, 1, 0}, {0, 3000000000LL, 1}, {1, 0, 3000000000LL}});
+    bool int64Overflow = false;
+    try {
+        LinearAlgebra::matrix_determinant(huge);
+    } catch (const std::overflow_error&) {
+        int64Overflow = true;
+    }
+    Matrix<std::int64_t> big({{3100000000LL, 3099999999LL}, {3100000001LL, 3100000000LL}});
+    run_test("Determinante: desbordamiento de int64_t, con productos intermedios en __int128",
+             int64Overflow && LinearAlgebra::matrix_determinant(big) == 1);
+
+    Matrix<float> real({{4, 3, 2}, {2, 1, 3}, {3, 2, 1}});
+    Matrix<float> twelveFloat(12, 12);
+    for (std::size_t i = 0; i < 12; i++) {
+        for (std::size_t j = 0; j < 12; j++) twelveFloat(i, j) = static_cast<float>(twelve(i, j));
+    }
+    run_test("Determinante: coma flotante por LU",
+             std::abs(LinearAlgebra::matrix_determinant(real) - 3) < 1e-5 &&
+                 std::abs(LinearAlgebra::matrix_determinant(twelveFloat) + 144) < 0.05 &&
+                 LinearAlgebra::matrix_determinant(Matrix<float>({{1, 2}, {2, 4}})) == 0);
+}
+
+int main() {
+    std::cout << "Iniciando pruebas de álgebra lineal de MC++" << std::endl;
+
+    test_matrix_views();
+    test_linear_algebra();
+    test_linear_algebra_advanced();
+    test_gemm();
+    test_lu_factorization();
+    test_determinants();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
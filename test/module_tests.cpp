@@ -0,0 +1,242 @@
+#include "ast.h"
+#include "builtins.h"
+#include "bytecode_cache.h"
+#include "codegen.h"
+#include "module_loader.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+const std::filesystem::path kWorkDir = std::filesystem::temp_directory_path() / "mcpp_module_tests";
+
+void writeModule(const std::string& name, const std::string& source, const std::filesystem::path& dir = kWorkDir) {
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / (name + ".mc"), std::ios::binary) << source;
+}
+
+// Ejecuta el programa (con sus módulos de kWorkDir) y devuelve las globales pedidas (o el error)
+std::string runProgram(const std::string& source, const std::string& globals, int level = 2) {
+    std::string result;
+    try {
+        VM vm;
+        registerBuiltins(vm);
+        AstArena arena;
+        NodeId program = parseSource(source, arena);
+        ModuleLoader(vm, (kWorkDir / "programa.mc").string()).load(arena, program);
+        FunctionProto* script = compileProgram(vm, arena, program);
+        optimizeProgram(vm, level);
+        vm.run(script);
+        size_t start = 0;
+        while (start < globals.size()) {
+            size_t end = globals.find(',', start);
+            if (end == std::string::npos) end = globals.size();
+            std::string name = globals.substr(start, end - start);
+            result += name + "=" + valueToString(vm.getGlobal(name)) + ";";
+            start = end + 1;
+        }
+    } catch (const std::exception& e) {
+        result = std::string("error: ") + e.what();
+    }
+    return result;
+}
+
+// Pruebas de importación y resolución
+void test_imports() {
+    writeModule("geometria", "VAR PI = 3.5\n"
+                             "FUNC area(r) {\n"
+                             "    RETORNAR PI * r * r\n"
+                             "}\n"
+                             "CLASE Punto {\n"
+                             "    PUBLICO:\n"
+                             "        VAR x\n"
+                             "        CONSTRUCTOR(valor) {\n"
+                             "            x = valor\n"
+                             "        }\n"
+                             "}\n");
+    run_test("Módulos: funciones, VAR y CLASE de un archivo importado",
+             runProgram("IMPORTAR \"geometria\"\n"
+                        "VAR a = geometria.area(2)\n"
+                        "VAR p = geometria.Punto(7)\n"
+                        "VAR x = p.x\n"
+                        "geometria.PI = 3\n"
+                        "VAR b = geometria.area(2)\n",
+                        "a,x,b") == "a=14.0;x=7;b=12;");
+
+    writeModule("base", "VAR cargas = 0\n"
+                        "cargas = cargas + 1\n"
+                        "FUNC doble(x) {\n"
+                        "    RETORNAR x * 2\n"
+                        "}\n");
+    writeModule("izquierda", "IMPORTAR \"base\"\n"
+                             "FUNC f(x) {\n"
+                             "    RETORNAR base.doble(x) + 1\n"
+                             "}\n");
+    writeModule("derecha", "IMPORTAR base\n"
+                           "FUNC g(x) {\n"
+                           "    RETORNAR base.doble(x) - 1\n"
+                           "}\n");
+    run_test("Módulos: un diamante carga e inicializa el módulo común una sola vez",
+             runProgram("IMPORTAR \"izquierda\"\n"
+                        "IMPORTAR \"derecha\"\n"
+                        "VAR r = izquierda.f(5) + derecha.g(5)\n"
+                        "VAR cargas = base.cargas\n",
+                        "r,cargas") == "r=20;cargas=1;");
+
+    writeModule("orden", "VAR valor = base.cargas * 10\n"
+                         "IMPORTAR \"base\"\n");
+    run_test("Módulos: un módulo se inicializa después de los que importa",
+             runProgram("IMPORTAR \"orden\"\n"
+                        "VAR v = orden.valor\n",
+                        "v") == "v=10;");
+
+    run_test("Módulos: los módulos nativos y los MODULO del programa no buscan archivos",
+             runProgram("IMPORTAR \"math\"\n"
+                        "IMPORTAR \"local\"\n"
+                        "MODULO local {\n"
+                        "    VAR k = 4\n"
+                        "}\n"
+                        "VAR s = math.sumar(1, 2) + local.k\n",
+                        "s") == "s=7;");
+
+    std::filesystem::path libs = kWorkDir / "bibliotecas";
+    writeModule("remoto", "FUNC uno() {\n"
+                          "    RETORNAR 1\n"
+                          "}\n",
+                libs);
+    std::string missing = runProgram("IMPORTAR \"remoto\"\n"
+                                     "VAR u = remoto.uno()\n",
+                                     "u");
+    setenv("MCPP_PATH", ("/no/existe:" + libs.string()).c_str(), 1);
+    std::string found = runProgram("IMPORTAR \"remoto\"\n"
+                                   "VAR u = remoto.uno()\n",
+                                   "u");
+    unsetenv("MCPP_PATH");
+    run_test("Módulos: MCPP_PATH añade directorios de búsqueda",
+             missing.find("no define 'uno'") != std::string::npos && found == "u=1;");
+}
+
+// Pruebas de errores
+void test_errors() {
+    writeModule("ciclo_a", "IMPORTAR \"ciclo_b\"\n");
+    writeModule("ciclo_b", "IMPORTAR \"ciclo_a\"\n");
+    run_test("Módulos: una importación circular es un error",
+             runProgram("IMPORTAR \"ciclo_a\"\n", "") ==
+                 "error: Error de importación: importación circular ciclo_a -> ciclo_b -> ciclo_a");
+
+    writeModule("roto", "FUNC f( {\n");
+    std::string syntax = runProgram("IMPORTAR \"roto\"\n", "");
+    run_test("Módulos: un error de sintaxis indica el módulo y su ruta",
+             syntax.find("error: Error en el módulo roto (") == 0 &&
+                 syntax.find("roto.mc): Error de sintaxis (línea 1)") != std::string::npos);
+
+    writeModule("indefinido", "FUNC f() {\n"
+                              "    RETORNAR 1\n"
+                              "}\n");
+    run_test("Módulos: un miembro que el módulo no declara es un error de compilación",
+             runProgram("IMPORTAR \"indefinido\"\nVAR x = indefinido.g()\n", "")
+                     .find("el MODULO indefinido no define 'g'") != std::string::npos);
+
+    writeModule("falla", "FUNC divide(a, b) {\n"
+                         "    RETORNAR a / b\n"
+                         "}\n");
+    // Sin optimizar: el inliner llevaría la división al script
+    run_test("Módulos: un error de ejecución indica la función del módulo",
+             runProgram("IMPORTAR \"falla\"\nVAR x = falla.divide(1, 0)\n", "", 0)
+                     .find("(línea 2, en falla.divide): división por cero") != std::string::npos);
+}
+
+// Pruebas de la caché de AST del proceso y de la caché .mcc
+void test_caches() {
+    writeModule("comun", "FUNC id(x) {\n"
+                         "    RETORNAR x\n"
+                         "}\n");
+    runProgram("IMPORTAR \"comun\"\nVAR x = comun.id(1)\n", "x");
+    size_t before = ModuleLoader::parsedModules();
+    std::string second = runProgram("IMPORTAR \"comun\"\nVAR x = comun.id(2)\n", "x");
+    run_test("Módulos: otro VM del proceso reutiliza el módulo ya analizado",
+             second == "x=2;" && ModuleLoader::parsedModules() == before);
+
+    writeModule("comun", "FUNC id(x) {\n"
+                         "    RETORNAR x + 100\n"
+                         "}\n");
+    std::filesystem::last_write_time(kWorkDir / "comun.mc",
+                                     std::filesystem::last_write_time(kWorkDir / "comun.mc") + std::chrono::seconds(5));
+    std::string changed = runProgram("IMPORTAR \"comun\"\nVAR x = comun.id(2)\n", "x");
+    run_test("Módulos: un archivo modificado se vuelve a analizar",
+             changed == "x=102;" && ModuleLoader::parsedModules() == before + 1);
+
+    for (int i = 0; i < 6; ++i) {
+        writeModule("paralelo" + std::to_string(i), "FUNC valor() {\n"
+                                                    "    RETORNAR " + std::to_string(i) + "\n"
+                                                    "}\n");
+    }
+    before = ModuleLoader::parsedModules();
+    std::string parallel = runProgram("IMPORTAR \"paralelo0\"\nIMPORTAR \"paralelo1\"\nIMPORTAR \"paralelo2\"\n"
+                                      "IMPORTAR \"paralelo3\"\nIMPORTAR \"paralelo4\"\nIMPORTAR \"paralelo5\"\n"
+                                      "VAR s = paralelo0.valor() + paralelo1.valor() + paralelo2.valor() + "
+                                      "paralelo3.valor() + paralelo4.valor() + paralelo5.valor()\n",
+                                      "s");
+    run_test("Módulos: los módulos de un mismo nivel se analizan juntos",
+             parallel == "s=15;" && ModuleLoader::parsedModules() == before + 6);
+
+    // La caché .mcc incluye los módulos y se invalida si uno cambia
+    std::string source = "IMPORTAR \"comun\"\nVAR x = comun.id(1)\n";
+    std::string cachePath = (kWorkDir / "programa.mcc").string();
+    uint64_t hash;
+    {
+        VM vm;
+        registerBuiltins(vm);
+        ModuleLoader modules(vm, (kWorkDir / "programa.mc").string());
+        AstArena arena;
+        NodeId program = parseSource(source, arena);
+        modules.load(arena, program);
+        FunctionProto* script = compileProgram(vm, arena, program);
+        hash = modules.programHash(source);
+        writeBytecodeCache(vm, script, hash, 0, cachePath);
+    }
+    std::string cached;
+    {
+        VM vm;
+        registerBuiltins(vm);
+        FunctionProto* script = loadBytecodeCache(vm, ModuleLoader(vm, (kWorkDir / "programa.mc").string()).programHash(source),
+                                                  0, cachePath);
+        if (script != nullptr) {
+            vm.run(script);
+            cached = valueToString(vm.getGlobal("x"));
+        }
+    }
+    writeModule("comun", "FUNC id(x) {\n"
+                         "    RETORNAR x + 200\n"
+                         "}\n");
+    VM vm;
+    registerBuiltins(vm);
+    run_test("Módulos: la caché .mcc ejecuta los módulos y depende de su contenido",
+             cached == "101" && hash != hashSource(source) &&
+                 ModuleLoader(vm, (kWorkDir / "programa.mc").string()).programHash(source) != hash);
+}
+
+int main() {
+    std::filesystem::remove_all(kWorkDir);
+    test_imports();
+    test_errors();
+    test_caches();
+    std::filesystem::remove_all(kWorkDir);
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
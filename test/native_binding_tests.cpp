@@ -0,0 +1,217 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "native_binding.h"
+#include "parser.h"
+#include "vm.h"
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Funciones de C++ con los tipos que usan las bibliotecas, para enlazarlas en el módulo "prueba"
+const void* lastData = nullptr;
+
+double sumVector(const std::vector<double>& values) {
+    lastData = values.data();
+    double total = 0.0;
+    for (double x : values) total += x;
+    return total;
+}
+
+int64_t sumInts(const std::vector<int64_t>& values) {
+    lastData = values.data();
+    int64_t total = 0;
+    for (int64_t x : values) total += x;
+    return total;
+}
+
+size_t viewLength(std::string_view text) {
+    lastData = text.data();
+    return text.size();
+}
+
+float averageList(std::list<float> values) {
+    float total = 0.0f;
+    for (float x : values) total += x;
+    return values.empty() ? 0.0f : total / static_cast<float>(values.size());
+}
+
+std::map<std::string, float> scale(const std::map<std::string, float>& weights, float factor) {
+    std::map<std::string, float> result;
+    for (const auto& entry : weights) result[entry.first] = entry.second * factor;
+    return result;
+}
+
+std::vector<double> ramp(int count) {
+    std::vector<double> result;
+    for (int i = 0; i < count; ++i) result.push_back(i * 0.5);
+    return result;
+}
+
+std::list<std::string> words(bool upper) {
+    return upper ? std::list<std::string>{"A", "B"} : std::list<std::string>{"a", "b"};
+}
+
+int calls = 0;
+void touch() { ++calls; }
+
+void registerTestModule(VM& vm) {
+    ObjModule* module = vm.defineModule("prueba");
+    NativeBinding<&sumVector>::define(vm, module, "sumar");
+    NativeBinding<&sumInts>::define(vm, module, "sumar_enteros");
+    NativeBinding<&viewLength>::define(vm, module, "longitud");
+    NativeBinding<&averageList>::define(vm, module, "promedio");
+    NativeBinding<&scale>::define(vm, module, "escalar");
+    NativeBinding<&ramp>::define(vm, module, "rampa");
+    NativeBinding<&words>::define(vm, module, "palabras");
+    NativeBinding<&touch>::define(vm, module, "tocar");
+    // La misma función con otro nombre: sus errores deben llevar el suyo
+    NativeBinding<&sumInts>::define(vm, module, "total");
+}
+
+// Ejecuta el programa y devuelve las globales pedidas (o el error)
+std::string runProgram(const std::string& source, const std::string& globals) {
+    std::string result;
+    try {
+        VM vm;
+        registerBuiltins(vm);
+        registerTestModule(vm);
+        AstArena arena;
+        NodeId program = parseSource(source, arena);
+        vm.run(compileProgram(vm, arena, program));
+        size_t start = 0;
+        while (start < globals.size()) {
+            size_t end = globals.find(',', start);
+            if (end == std::string::npos) end = globals.size();
+            std::string name = globals.substr(start, end - start);
+            result += name + "=" + valueToString(vm.getGlobal(name)) + ";";
+            start = end + 1;
+        }
+    } catch (const std::exception& e) {
+        result = std::string("error: ") + e.what();
+    }
+    return result;
+}
+
+// Pruebas de las bibliotecas enlazadas por registerBuiltins
+void test_library_bindings() {
+    run_test("Enlace: math.logaritmo y la combinatoria de la biblioteca math",
+             runProgram("IMPORTAR \"math\"\n"
+                        "VAR l = math.logaritmo(8, 2)\n"
+                        "VAR f = math.factorial(5)\n"
+                        "VAR c = math.combinaciones(5, 2)\n"
+                        "VAR p = math.permutaciones(5, 2)\n",
+                        "l,f,c,p") == "l=3.0;f=120;c=10;p=20;");
+
+    run_test("Enlace: transformaciones de texto de string_utils",
+             runProgram("IMPORTAR \"string_utils\"\n"
+                        "VAR a = string_utils.toUpper(\"hola\")\n"
+                        "VAR b = string_utils.trim(\"  x y  \")\n"
+                        "VAR c = string_utils.toTitleCase(\"hola mundo\")\n"
+                        "VAR d = string_utils.replaceChar(\"a-b-c\", \"-\", \"+\")\n",
+                        "a,b,c,d") == "a=HOLA;b=x y;c=Hola Mundo;d=a+b+c;");
+
+    run_test("Enlace: split devuelve un ARRAY y join lo recibe",
+             runProgram("IMPORTAR \"string_utils\"\n"
+                        "VAR partes = string_utils.split(\"uno dos tres\", \" \")\n"
+                        "VAR n = LONGITUD(partes)\n"
+                        "VAR unido = string_utils.join(partes, \"-\")\n"
+                        "VAR veces = string_utils.countChar(\"banana\", \"a\")\n"
+                        "VAR r = string_utils.replaceAll(\"a.b.c\", \".\", \"::\")\n",
+                        "n,unido,veces,r") == "n=3;unido=uno-dos-tres;veces=3;r=a::b::c;");
+}
+
+// Pruebas de las conversiones de argumentos y resultados
+void test_conversions() {
+    std::string typed = runProgram("IMPORTAR \"prueba\"\n"
+                                   "VAR a: ARRAY<FLOAT> = [1.5, 2.5, 3.0]\n"
+                                   "VAR s = prueba.sumar(a)\n"
+                                   "VAR t = prueba.sumar([1, 2.5])\n",
+                                   "s,t");
+    run_test("Enlace: ARRAY<FLOAT> y ARRAY de números a const vector<double>&", typed == "s=7.0;t=3.5;");
+
+    // Sin copia: la función recibe el búfer del ARRAY<INT> / el texto del STRING
+    {
+        VM vm;
+        registerBuiltins(vm);
+        ObjTypedArray* ints = vm.heap().allocate<ObjTypedArray>(ElementType::INT);
+        ints->ints = {1, 2, 3};
+        Value arg = Value::object(ints);
+        Value sum = NativeBinding<&sumInts>::call(vm, &arg, 1);
+        bool intsShared = lastData == ints->ints.data() && sum.isInt() && sum.asInt() == 6;
+        Value text = vm.newString("una cadena larga que no cabe en línea");
+        Value length = NativeBinding<&viewLength>::call(vm, &text, 1);
+        bool textShared = lastData == asString(text)->view().data() && length.asInt() == 38;
+        run_test("Enlace: ARRAY<INT> y STRING llegan sin copiar", intsShared && textShared);
+    }
+
+    run_test("Enlace: list<float>, map<string,float> y resultados MAP",
+             runProgram("IMPORTAR \"prueba\"\n"
+                        "VAR m = prueba.promedio([1, 2, 4.5])\n"
+                        "VAR e = prueba.escalar({\"a\": 1, \"b\": 0.5}, 2)\n"
+                        "VAR b = e[\"b\"]\n",
+                        "m,b") == "m=2.5;b=1.0;");
+
+    run_test("Enlace: vector<double> es un ARRAY<FLOAT>, list<string> un ARRAY y void NULO",
+             runProgram("IMPORTAR \"prueba\"\n"
+                        "VAR r = prueba.rampa(3)\n"
+                        "AGREGAR(r, 7)\n"
+                        "VAR p = prueba.palabras(VERDADERO)\n"
+                        "VAR n = prueba.tocar()\n",
+                        "r,p,n") == "r=[0.0, 0.5, 1.0, 7.0];p=[\"A\", \"B\"];n=NULO;" &&
+                 calls == 1);
+}
+
+// Pruebas de errores
+void test_errors() {
+    run_test("Enlace: un argumento de otro tipo indica la función y la posición",
+             runProgram("IMPORTAR \"math\"\nVAR x = math.combinaciones(5, \"dos\")\n", "")
+                     .find("math.combinaciones espera un INT en el argumento 2, no STRING") != std::string::npos);
+
+    run_test("Enlace: un INT fuera del rango de int es un error",
+             runProgram("IMPORTAR \"math\"\nVAR x = math.factorial(10000000000)\n", "")
+                     .find("math.factorial espera un INT dentro del rango del parámetro en el argumento 1") !=
+                 std::string::npos);
+
+    run_test("Enlace: la aridad sale de la firma de C++",
+             runProgram("IMPORTAR \"string_utils\"\nVAR x = string_utils.toUpper(\"a\", \"b\")\n", "")
+                     .find("string_utils.toUpper espera 1 argumento(s) y recibió 2") != std::string::npos);
+
+    std::string thrown = runProgram("IMPORTAR \"math\"\nVAR x = math.factorial(-1)\n", "");
+    run_test("Enlace: una excepción de la biblioteca es un error de ejecución con su línea",
+             thrown.find("Error de ejecución (línea 2") != std::string::npos &&
+                 thrown.find("math.factorial: factorial no definido para números negativos.") != std::string::npos);
+
+    std::string renamed = runProgram("IMPORTAR \"prueba\"\nVAR x = prueba.total(\"a\")\n", "");
+    std::string original = runProgram("IMPORTAR \"prueba\"\nVAR x = prueba.sumar_enteros(\"a\")\n", "");
+    run_test("Enlace: una función registrada con dos nombres indica el de la llamada",
+             renamed.find("prueba.total espera un ARRAY de INT") != std::string::npos &&
+                 original.find("prueba.sumar_enteros espera un ARRAY de INT") != std::string::npos &&
+                 runProgram("IMPORTAR \"prueba\"\nVAR x = prueba.total([1, 2])\n", "x") == "x=3;");
+
+    run_test("Enlace: un carácter es un STRING de longitud 1",
+             runProgram("IMPORTAR \"string_utils\"\nVAR x = string_utils.countChar(\"abc\", \"ab\")\n", "")
+                     .find("espera un STRING de un carácter en el argumento 2") != std::string::npos);
+}
+
+int main() {
+    test_library_bindings();
+    test_conversions();
+    test_errors();
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
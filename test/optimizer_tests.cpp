@@ -0,0 +1,315 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "ir.h"
+#include "object.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Compila el programa en el VM y lo optimiza al nivel indicado
+FunctionProto* compileAt(VM& vm, const std::string& source, int level, OptimizationStats* stats = nullptr) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    FunctionProto* script = compileProgram(vm, arena, program);
+    OptimizationStats result = optimizeProgram(vm, level);
+    if (stats != nullptr) *stats = result;
+    return script;
+}
+
+// Ejecuta el programa optimizado y devuelve la global `name` como texto (o el error)
+std::string resultAt(const std::string& source, int level, const std::string& name) {
+    VM vm;
+    try {
+        vm.run(compileAt(vm, source, level));
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+    return valueToString(vm.getGlobal(name));
+}
+
+size_t countOpcode(const FunctionProto& proto, OpCode op) {
+    size_t count = 0;
+    for (Instr instr : proto.code) {
+        if (opOf(instr) == op) ++count;
+    }
+    return count;
+}
+
+const FunctionProto* findProto(const VM& vm, const std::string& name) {
+    for (const auto& proto : vm.protos()) {
+        if (proto->name == name) return proto.get();
+    }
+    return nullptr;
+}
+
+// Todos los niveles deben calcular lo mismo
+void test_same_results() {
+    const std::vector<std::string> programs = {
+        "FUNC suma(a: INT, b: INT): INT {\n    RETORNAR a + b\n}\n"
+        "VAR r = 0\nPARA i DESDE 0 HASTA 100 { r = r + suma(i, 2 * 3) }\n",
+        "VAR r = \"\"\nVAR n = 3\nPARA i DESDE 0 HASTA 4 {\n"
+        "    SI i % 2 == 0 { r = r + \"par\" + i } SINO { r = r + \"impar\" }\n}\n",
+        "VAR r = 0\nVAR i = 0\nMIENTRAS VERDADERO {\n    i += 1\n    SI i > 10 { ROMPER }\n"
+        "    SI i % 2 == 0 { CONTINUAR }\n    r += i * (3 - 1)\n}\n",
+        "FUNC escala(x: FLOAT, k: FLOAT): FLOAT {\n    RETORNAR x * k + 0.5\n}\n"
+        "VAR datos: ARRAY<FLOAT> = [1.0, 2.0, 3.0]\nVAR r = 0.0\n"
+        "PARA i DESDE 0 HASTA LONGITUD(datos) { r = r + escala(datos[i], 2.0) }\n",
+        "CLASE Punto {\n    VAR x: INT\n    VAR y: INT\n"
+        "    CONSTRUCTOR(px: INT, py: INT) {\n        x = px\n        y = py\n    }\n}\n"
+        "FUNC norma(p) {\n    RETORNAR p.x * p.x + p.y * p.y\n}\n"
+        "VAR r = 0\nPARA i DESDE 0 HASTA 5 { r = r + norma(Punto(i, 1)) }\n",
+        "VAR r = 0\nPARA i DESDE 0 HASTA 3 {\n    PARA j DESDE 0 HASTA 4 {\n"
+        "        VAR k = 10 * 2\n        r = r + i * j + k\n    }\n}\n",
+        "FUNC nada(x) {\n    VAR y = x\n}\nVAR r = [nada(1), 1 == 1.0, \"a\" < \"b\", -(2 - 5), NO NULO]\n",
+        "VAR r = 0\nPARA i DESDE 0 HASTA 40 {\n    SELECCION i % 6 {\n        CASO 0: CONTINUAR\n"
+        "        CASO 1: r += 1\n        CASO 2: r += 10\n        CASO 3: SI i > 30 { ROMPER }\n"
+        "        DEFECTO: r -= 1\n    }\n    r += 100\n}\n",
+        "FUNC color(c) {\n    SELECCION c {\n        CASO \"rojo\": RETORNAR 1\n        CASO \"verde\": RETORNAR 2\n"
+        "        CASO \"azul\": RETORNAR 3\n        CASO 7: RETORNAR 4\n    }\n    RETORNAR 0\n}\n"
+        "VAR r = [color(\"rojo\"), color(\"azul\"), color(7.0), color(\"gris\"), color(\"ver\" + \"de\")]\n",
+    };
+    for (size_t i = 0; i < programs.size(); ++i) {
+        std::string expected = resultAt(programs[i], 0, "r");
+        run_test("Optimizador: mismo resultado en -O0/-O1/-O2 (programa " + std::to_string(i + 1) + ": " + expected + ")",
+                 resultAt(programs[i], 1, "r") == expected && resultAt(programs[i], 2, "r") == expected);
+    }
+}
+
+// Propagación y plegado de constantes, saltos incluidos
+void test_constant_folding() {
+    VM vm;
+    OptimizationStats stats;
+    FunctionProto* script = compileAt(vm, "VAR x = (2 * 3 + 4) / 5\nVAR s = \"a\" + 1\n", 1, &stats);
+    vm.run(script);
+    run_test("Plegado: expresiones constantes",
+             stats.foldedInstructions > 0 && countOpcode(*script, OpCode::MUL) == 0 &&
+             countOpcode(*script, OpCode::ADD) == 0 && countOpcode(*script, OpCode::DIV) == 0);
+    run_test("Plegado: valores correctos", valueToString(vm.getGlobal("x")) == "2" &&
+                                                 valueToString(vm.getGlobal("s")) == "a1");
+
+    VM vm2;
+    FunctionProto* branches = compileAt(vm2,
+                                        "VAR r = 0\nSI 1 < 2 { r = 1 } SINO { r = 2 }\n"
+                                        "MIENTRAS FALSO { r = 3 }\n",
+                                        1, &stats);
+    vm2.run(branches);
+    run_test("Plegado: saltos con condición constante",
+             stats.foldedBranches >= 2 && countOpcode(*branches, OpCode::JMPIFNOT) == 0 &&
+             valueToString(vm2.getGlobal("r")) == "1");
+
+    VM vm3;
+    FunctionProto* local = compileAt(vm3, "FUNC f(): INT {\n    VAR a = 6\n    VAR b = a * 7\n    RETORNAR b\n}\n", 1);
+    (void)local;
+    const FunctionProto* f = findProto(vm3, "f");
+    run_test("Plegado: locales propagados en SSA",
+             f != nullptr && countOpcode(*f, OpCode::MUL) == 0 && f->code.size() == 2);
+
+    VM vm4;
+    compileAt(vm4, "FUNC f(n) {\n    VAR a = n\n    SI n > 0 { a = 1 } SINO { a = 1 }\n    RETORNAR a + 1\n}\n", 1);
+    const FunctionProto* g = findProto(vm4, "f");
+    run_test("Plegado: phi con el mismo valor en ambas ramas", g != nullptr && countOpcode(*g, OpCode::ADD) == 0);
+
+    VM vm5;
+    OptimizationStats none;
+    FunctionProto* unchanged = compileAt(vm5, "VAR x = 2 * 3\n", 0, &none);
+    run_test("Plegado: -O0 no cambia nada",
+             none.instructionsBefore == none.instructionsAfter && countOpcode(*unchanged, OpCode::MUL) == 1);
+}
+
+// Expansión en línea de FUNC pequeñas
+void test_inlining() {
+    const std::string source = "FUNC suma(a: INT, b: INT): INT {\n    RETORNAR a + b\n}\n"
+                               "FUNC usar(x: INT): INT {\n    RETORNAR suma(x, 1) * 2\n}\n"
+                               "VAR r = suma(2, 3)\nVAR q = usar(4)\n";
+    VM vm;
+    OptimizationStats stats;
+    FunctionProto* script = compileAt(vm, source, 2, &stats);
+    vm.run(script);
+    const FunctionProto* usar = findProto(vm, "usar");
+    run_test("Inlining: llamadas a suma() expandidas",
+             stats.inlinedCalls == 2 && usar != nullptr && countOpcode(*usar, OpCode::CALL) == 0);
+    run_test("Inlining: los argumentos constantes se pliegan",
+             countOpcode(*script, OpCode::ADD) == 0 && valueToString(vm.getGlobal("r")) == "5" &&
+             valueToString(vm.getGlobal("q")) == "10");
+
+    VM vm2;
+    compileAt(vm2, source, 1, &stats);
+    run_test("Inlining: sólo en -O2", stats.inlinedCalls == 0);
+
+    VM vm3;
+    compileAt(vm3,
+              "FUNC f(a) {\n    RETORNAR a + 1\n}\nFUNC g(a) {\n    SI a > 0 { RETORNAR 1 }\n    RETORNAR 0\n}\n"
+              "VAR h = f\nVAR r = h(1) + g(2)\n",
+              2, &stats);
+    run_test("Inlining: ni funciones reasignadas ni con saltos", stats.inlinedCalls == 0);
+
+    std::string error = resultAt("FUNC divide(a, b) {\n    RETORNAR a / b\n}\n\nVAR r = divide(1, 0)\n", 2, "r");
+    run_test("Inlining: el error se informa en la llamada",
+             error.find("división por cero") != std::string::npos && error.find("línea 5") != std::string::npos);
+}
+
+// Extracción de invariantes de bucle
+void test_loop_invariants() {
+    // m es numérico (resultado de NEG), así que m * 3 no puede fallar y sale del bucle
+    const std::string source = "FUNC f(n: INT): INT {\n    VAR total = 0\n    VAR m = -n\n"
+                               "    PARA i DESDE 0 HASTA n {\n        total = total + i * 2 + m * 3\n    }\n"
+                               "    RETORNAR total\n}\nVAR r = f(10)\n";
+    VM vm;
+    OptimizationStats stats;
+    vm.run(compileAt(vm, source, 2, &stats));
+    const FunctionProto* f = findProto(vm, "f");
+    // En el cuerpo (del destino del FORLOOP al FORLOOP) sólo queda la multiplicación por el contador
+    bool bodyClean = f != nullptr;
+    size_t multiplies = 0;
+    if (f != nullptr) {
+        size_t loop = 0;
+        while (loop < f->code.size() && opOf(f->code[loop]) != OpCode::FORLOOP) ++loop;
+        size_t start = loop < f->code.size() ? loop + 1 + argSBx(f->code[loop]) : loop;
+        for (size_t pc = start; pc < loop; ++pc) {
+            OpCode op = opOf(f->code[pc]);
+            bodyClean = bodyClean && op != OpCode::LOADI;
+            if (op == OpCode::MUL) ++multiplies;
+        }
+    }
+    run_test("LICM: constantes y m * 3 fuera del bucle",
+             stats.hoistedInstructions >= 3 && bodyClean && multiplies == 1);
+    run_test("LICM: resultado correcto", valueToString(vm.getGlobal("r")) == "-210");
+
+    VM vm2;
+    vm2.run(compileAt(vm2, "VAR r = 0\nVAR i = 0\nMIENTRAS i < 5 {\n    i = i + 1\n    r = r + 3 * 4\n}\n", 2, &stats));
+    run_test("LICM: bucles MIENTRAS", stats.hoistedInstructions > 0 && valueToString(vm2.getGlobal("r")) == "60");
+
+    // Una división que puede fallar no se adelanta: el bucle vacío no debe lanzar error
+    std::string result = resultAt("FUNC f(d) {\n    VAR s = 0\n    PARA i DESDE 0 HASTA 0 { s = 1 / d }\n"
+                                  "    RETORNAR s\n}\nVAR r = f(0)\n",
+                                  2, "r");
+    run_test("LICM: no adelanta operaciones que pueden fallar", result == "0");
+}
+
+// Los errores de ejecución no cambian con el optimizador
+void test_errors_preserved() {
+    const std::string division = "VAR a = 1\n\nVAR b = a / 0\n";
+    std::string expected = resultAt(division, 0, "b");
+    run_test("Errores: división por cero con la misma línea",
+             expected.find("línea 3") != std::string::npos && resultAt(division, 1, "b") == expected &&
+             resultAt(division, 2, "b") == expected);
+    const std::string types = "FUNC f() {\n    VAR x = 1\n    VAR y = x - \"a\"\n}\nf()\nVAR r = 0\n";
+    expected = resultAt(types, 0, "r");
+    run_test("Errores: operación entre tipos incompatibles no se elimina",
+             expected.find("línea 3") != std::string::npos && resultAt(types, 1, "r") == expected);
+    // En -O2 f() se expande: el error es el mismo pero se ubica en la llamada
+    std::string inlined = resultAt(types, 2, "r");
+    run_test("Errores: operación fallida dentro de una función expandida",
+             inlined.find("no válida entre INT y STRING") != std::string::npos &&
+             inlined.find("línea 5") != std::string::npos);
+}
+
+// Tablas de saltos de SELECCION y superinstrucciones
+void test_switch_and_superinstructions() {
+    const std::string cases = "FUNC dia(n) {\n    SELECCION n {\n        CASO 1: RETORNAR \"lunes\"\n"
+                              "        CASO 2: RETORNAR \"martes\"\n        CASO 3: RETORNAR \"miércoles\"\n"
+                              "        CASO 4: RETORNAR \"jueves\"\n        DEFECTO: RETORNAR \"otro\"\n    }\n}\n";
+    VM vm;
+    FunctionProto* script = compileAt(vm, cases + "VAR r = dia(3)\n", 0);
+    vm.run(script);
+    const FunctionProto* dia = findProto(vm, "dia");
+    run_test("SWITCH: CASO literales compilados como tabla de saltos",
+             dia != nullptr && countOpcode(*dia, OpCode::SWITCH) == 1 && countOpcode(*dia, OpCode::EQ) == 0 &&
+                 dia->switchTables.size() == 1 && dia->switchTables[0].dense.size() == 4 &&
+                 valueToString(vm.getGlobal("r")) == "miércoles");
+
+    VM vm2;
+    OptimizationStats stats;
+    FunctionProto* folded = compileAt(vm2,
+                                      "VAR r = \"\"\nVAR n = 2\nSELECCION n + 1 {\n    CASO 1: r = \"a\"\n"
+                                      "    CASO 2: r = \"b\"\n    CASO 3: r = \"c\"\n    CASO 4: r = \"d\"\n}\n",
+                                      1, &stats);
+    vm2.run(folded);
+    run_test("SWITCH: sujeto constante resuelto en compilación",
+             countOpcode(*folded, OpCode::SWITCH) == 0 && stats.foldedBranches > 0 &&
+                 valueToString(vm2.getGlobal("r")) == "c");
+
+    // La condición del MIENTRAS (LE + JMPIFNOT) y el incremento (LOADI + ADD) se fusionan
+    const std::string loop = "FUNC suma(n) {\n    VAR s = 0\n    VAR i = 0\n    MIENTRAS i <= n {\n"
+                             "        SI i != 3 { s = s + i }\n        i = i + 1\n    }\n    RETORNAR s\n}\n"
+                             "VAR r = suma(100)\n";
+    VM vm3;
+    vm3.run(compileAt(vm3, loop, 1, &stats));
+    const FunctionProto* suma = findProto(vm3, "suma");
+    run_test("Superinstrucciones: comparación + salto y LOADI + ADD",
+             suma != nullptr && stats.fusedInstructions >= 3 && countOpcode(*suma, OpCode::LEJMP) == 1 &&
+                 countOpcode(*suma, OpCode::NEJMP) == 1 && countOpcode(*suma, OpCode::LOADIADD) == 1 &&
+                 countOpcode(*suma, OpCode::JMPIFNOT) == 2 && valueToString(vm3.getGlobal("r")) == "5047");
+
+    // Volver a optimizar deshace las fusiones al construir la IR y las rehace al final
+    VM vm4;
+    FunctionProto* twice = compileAt(vm4, loop, 1);
+    OptimizationStats again = optimizeProgram(vm4, 1);
+    vm4.run(twice);
+    run_test("Superinstrucciones: el bytecode fusionado se puede volver a optimizar",
+             again.fusedInstructions == stats.fusedInstructions && valueToString(vm4.getGlobal("r")) == "5047");
+}
+
+// Las llamadas finales del generador de código se conservan en todos los niveles
+void test_tail_calls() {
+    const std::string source = "FUNC suma(n, total) {\n    SI n == 0 { RETORNAR total }\n"
+                               "    RETORNAR suma(n - 1, total + n)\n}\nVAR r = suma(1000000, 0)\n";
+    bool kept = true;
+    for (int level = 0; level <= 2; ++level) {
+        VM vm;
+        vm.run(compileAt(vm, source, level));
+        const FunctionProto* suma = findProto(vm, "suma");
+        kept = kept && suma != nullptr && countOpcode(*suma, OpCode::TAILCALL) == 1 &&
+               countOpcode(*suma, OpCode::CALL) == 0 && valueToString(vm.getGlobal("r")) == "500000500000";
+    }
+    run_test("Llamadas finales: TAILCALL en -O0/-O1/-O2", kept);
+}
+
+// La IR reproduce el bytecode original sin transformaciones
+void test_ir_roundtrip() {
+    VM vm;
+    FunctionProto* script = compileAt(vm,
+                                      "VAR r = 0\nPARA i DESDE 0 HASTA 10 {\n    SI i % 3 == 0 { CONTINUAR }\n"
+                                      "    MIENTRAS r < i { r += 1 }\n"
+                                      "    SELECCION i {\n        CASO 1: r += 1\n        CASO 2: r += 2\n"
+                                      "        CASO 4: r -= 1\n        CASO 8: r += 5\n    }\n}\n",
+                                      0);
+    std::vector<Instr> before = script->code;
+    IrFunction function = buildIr(*script);
+    lowerIr(function);
+    bool same = script->code == before;
+    vm.run(script);
+    run_test("IR: construir y bajar reproduce el bytecode", same && valueToString(vm.getGlobal("r")) == "13");
+}
+
+int main() {
+    std::cout << "Iniciando pruebas del optimizador de MC++" << std::endl;
+
+    test_same_results();
+    test_constant_folding();
+    test_inlining();
+    test_loop_invariants();
+    test_errors_preserved();
+    test_switch_and_superinstructions();
+    test_tail_calls();
+    test_ir_roundtrip();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
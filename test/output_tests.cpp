@@ -0,0 +1,188 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "output.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace mc_core;
+
+// Los resultados van a stderr: stdout está redirigido a un archivo durante las pruebas
+void run_test(const std::string& test_name, bool result) {
+    std::cerr << (result ? "[PASSED] " : "[FAILED] ") << test_name << std::endl;
+}
+
+// Redirige el descriptor 1 a un archivo temporal mientras existe
+class CapturedStdout {
+public:
+    CapturedStdout() : path_("/tmp/mcpp_output_test_" + std::to_string(::getpid()) + "_" + std::to_string(++count_)) {
+        std::fflush(stdout);
+        saved_ = ::dup(STDOUT_FILENO);
+        std::FILE* file = std::fopen(path_.c_str(), "w");
+        ::dup2(::fileno(file), STDOUT_FILENO);
+        std::fclose(file);
+    }
+
+    ~CapturedStdout() {
+        OutputBuffer::flushAll();
+        ::dup2(saved_, STDOUT_FILENO);
+        ::close(saved_);
+        std::remove(path_.c_str());
+    }
+
+    std::string text() const {
+        std::ifstream in(path_);
+        std::stringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+
+private:
+    static inline int count_ = 0;
+    std::string path_;
+    int saved_;
+};
+
+void runSource(VM& vm, const std::string& source, size_t threads = 1) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    vm.setThreadCount(threads);
+    vm.run(compileProgram(vm, arena, program));
+}
+
+// Pruebas del búfer por bloques y por líneas
+void test_buffering() {
+    CapturedStdout captured;
+    OutputBuffer::setLineBuffered(false);
+    OutputBuffer& out = OutputBuffer::local();
+
+    std::string expected;
+    uint64_t before = OutputBuffer::writeCalls();
+    for (int i = 0; i < 10000; ++i) {
+        std::string line = "línea de registro " + std::to_string(i) + "\n";
+        expected += line;
+        out.write(line);
+    }
+    uint64_t during = OutputBuffer::writeCalls() - before;
+    out.flush();
+    run_test("Salida: por bloques, pocas escrituras", during <= expected.size() / OutputBuffer::kCapacity + 1);
+    run_test("Salida: el texto llega completo y en orden", captured.text() == expected);
+
+    std::string large(3 * OutputBuffer::kCapacity, 'x');
+    out.write("antes ");
+    before = OutputBuffer::writeCalls();
+    out.write(large);
+    run_test("Salida: un texto mayor que el búfer sale en una escritura con lo pendiente",
+             OutputBuffer::writeCalls() - before == 1 && captured.text() == expected + "antes " + large);
+
+    OutputBuffer::setLineBuffered(true);
+    before = OutputBuffer::writeCalls();
+    out.write("uno\n");
+    out.write("dos ");
+    out.write("tres\n");
+    run_test("Salida: por líneas en un terminal", OutputBuffer::writeCalls() - before == 2 &&
+                                                      captured.text() == expected + "antes " + large + "uno\ndos tres\n");
+    OutputBuffer::setLineBuffered(false);
+}
+
+// Pruebas de los búferes de otros hilos
+void test_threads() {
+    CapturedStdout captured;
+    std::thread finished([] { OutputBuffer::local().write("al terminar el hilo\n"); });
+    finished.join();
+    run_test("Salida: el búfer de un hilo se vacía al terminar", captured.text() == "al terminar el hilo\n");
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    int stage = 0;
+    std::thread idle([&] {
+        OutputBuffer::local().write("hilo ocioso\n");
+        std::unique_lock<std::mutex> lock(mutex);
+        stage = 1;
+        changed.notify_all();
+        changed.wait(lock, [&] { return stage == 2; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return stage == 1; });
+    }
+    OutputBuffer::flushAll();
+    bool delivered = captured.text() == "al terminar el hilo\nhilo ocioso\n";
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stage = 2;
+    }
+    changed.notify_all();
+    idle.join();
+    run_test("Salida: flushAll vacía los búferes de otros hilos", delivered);
+}
+
+// Pruebas de MOSTRAR
+void test_mostrar() {
+    CapturedStdout captured;
+    OutputBuffer::setLineBuffered(false);
+    uint64_t before = OutputBuffer::writeCalls();
+    VM vm;
+    runSource(vm, "PARA i DESDE 0 HASTA 100000 {\n"
+                  "    MOSTRAR(\"evento\", i, [i], VERDADERO)\n"
+                  "}\n");
+    OutputBuffer::flushAll();
+    std::string text = captured.text();
+    run_test("MOSTRAR: 100000 líneas en pocas escrituras", OutputBuffer::writeCalls() - before < 100);
+    run_test("MOSTRAR: formato de cada línea",
+             text.compare(0, 46, "evento 0 [0] VERDADERO\nevento 1 [1] VERDADERO\n") == 0 &&
+                 text.size() > 100000 * 23);
+
+    CapturedStdout parallel;
+    VM workers;
+    runSource(workers, "PARA PARALELO i DESDE 0 HASTA 64 {\n"
+                       "    MOSTRAR(\"trozo\")\n"
+                       "}\n",
+              4);
+    // Sin vaciado explícito: el bucle entrega lo que mostraron sus hilos al terminar
+    std::string lines = parallel.text();
+    size_t count = 0;
+    for (size_t at = lines.find("trozo\n"); at != std::string::npos; at = lines.find("trozo\n", at + 1)) ++count;
+    run_test("MOSTRAR: PARA PARALELO entrega la salida de todos los hilos", count == 64);
+
+    // El primer trozo lo recorre el hilo principal, que aún guarda "ANTES" en su búfer; mientras
+    // se detiene, los demás hilos llenan los suyos y escriben. Lo mostrado antes del bucle tiene
+    // que haber salido ya
+    CapturedStdout ordered;
+    VM ordering;
+    ordering.defineNative("PAUSA", [](VM&, Value*, int) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return Value::nil();
+    }, 0);
+    runSource(ordering, "MOSTRAR(\"ANTES\")\n"
+                        "PARA PARALELO i DESDE 0 HASTA 40000 {\n"
+                        "    SI i == 0 { PAUSA() }\n"
+                        "    MOSTRAR(\"una línea larga para llenar el búfer de cada hilo antes del final\", i)\n"
+                        "}\n"
+                        "MOSTRAR(\"DESPUES\")\n",
+              4);
+    OutputBuffer::flushAll();
+    std::string output = ordered.text();
+    run_test("MOSTRAR: lo mostrado antes de PARA PARALELO sale antes que sus hilos",
+             output.compare(0, 6, "ANTES\n") == 0 && output.size() > 8 &&
+                 output.compare(output.size() - 8, 8, "DESPUES\n") == 0);
+}
+
+int main() {
+    test_buffering();
+    test_threads();
+    test_mostrar();
+    std::cerr << "Pruebas completadas." << std::endl;
+    return 0;
+}
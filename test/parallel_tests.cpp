@@ -0,0 +1,346 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "object.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include "../src/utils/work_stealing_pool.h"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Compila y ejecuta el programa con el número de hilos y el nivel de optimización dados
+void runProgram(VM& vm, const std::string& source, size_t threads, int level = 0) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    vm.setThreadCount(threads);
+    FunctionProto* script = compileProgram(vm, arena, program);
+    optimizeProgram(vm, level);
+    vm.run(script);
+}
+
+std::string globalText(VM& vm, const std::string& name) {
+    return valueToString(vm.getGlobal(name));
+}
+
+// Mensaje del error al compilar o ejecutar el programa ("" si no falla)
+std::string errorOf(const std::string& source, size_t threads = 4) {
+    try {
+        VM vm;
+        runProgram(vm, source, threads);
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+    return "";
+}
+
+// Pruebas del grupo de hilos
+void test_pool() {
+    mc_utils::WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> seen(1000);
+    std::vector<std::atomic<int>> byWorker(4);
+    pool.run(seen.size(), [&](size_t worker, size_t index) {
+        seen[index].fetch_add(1);
+        byWorker[worker].fetch_add(1);
+    });
+    bool once = true;
+    for (const auto& count : seen) once = once && count.load() == 1;
+    run_test("Grupo: cada índice se ejecuta una vez", once);
+    int total = 0;
+    for (const auto& count : byWorker) total += count.load();
+    run_test("Grupo: todos los hilos registran su trabajo", total == 1000 && pool.size() == 4);
+
+    // Los trozos lentos del hilo 0 quedan para los demás
+    std::atomic<int> done{0};
+    pool.run(64, [&](size_t, size_t index) {
+        if (index < 16) {
+            volatile double x = 0;
+            for (int i = 0; i < 200000; ++i) x = x + i;
+        }
+        done.fetch_add(1);
+    });
+    run_test("Grupo: se reutiliza entre ejecuciones", done.load() == 64);
+
+    mc_utils::WorkStealingPool single(1);
+    int sum = 0;
+    single.run(10, [&](size_t, size_t index) { sum += static_cast<int>(index); });
+    run_test("Grupo: un solo hilo ejecuta en el que llama", sum == 45);
+}
+
+const char* kReductions = "VAR suma = 0\n"
+                          "VAR producto = 1\n"
+                          "VAR menor = 1000000\n"
+                          "VAR mayor = -1000000\n"
+                          "VAR flotante = 0.0\n"
+                          "PARA PARALELO i DESDE 0 HASTA 10000 REDUCIR SUMA suma, MIN menor, MAX mayor {\n"
+                          "    VAR x = (i * 7919) % 10007 - 5000\n"
+                          "    suma = suma + x\n"
+                          "    SI x < menor { menor = x }\n"
+                          "    SI x > mayor { mayor = x }\n"
+                          "}\n"
+                          "PARA PARALELO i DESDE 1 HASTA 16 REDUCIR PRODUCTO producto {\n"
+                          "    producto = producto * i\n"
+                          "}\n"
+                          "PARA PARALELO i DESDE 0 HASTA 5000 REDUCIR SUMA flotante {\n"
+                          "    flotante += 1.0 / (i + 1)\n"
+                          "}\n";
+
+// Pruebas de REDUCIR y del determinismo con distinto número de hilos
+void test_reductions() {
+    int64_t sum = 0;
+    int64_t low = 1000000;
+    int64_t high = -1000000;
+    for (int64_t i = 0; i < 10000; ++i) {
+        int64_t x = (i * 7919) % 10007 - 5000;
+        sum += x;
+        low = std::min(low, x);
+        high = std::max(high, x);
+    }
+    VM vm;
+    runProgram(vm, kReductions, 4);
+    run_test("Reducciones: SUMA", globalText(vm, "suma") == std::to_string(sum));
+    run_test("Reducciones: MIN y MAX",
+             globalText(vm, "menor") == std::to_string(low) && globalText(vm, "mayor") == std::to_string(high));
+    run_test("Reducciones: PRODUCTO", globalText(vm, "producto") == "1307674368000");
+
+    // La suma en coma flotante no es asociativa: sólo es estable si el reparto lo es
+    bool same = true;
+    std::string reference;
+    for (int level = 0; level <= 2; level += 2) {
+        for (size_t threads : {1, 2, 4, 8}) {
+            VM other;
+            runProgram(other, kReductions, threads, level);
+            std::string result = globalText(other, "suma") + " " + globalText(other, "menor") + " " +
+                                 globalText(other, "mayor") + " " + valueToString(other.getGlobal("flotante"));
+            if (reference.empty()) reference = result;
+            same = same && result == reference;
+        }
+    }
+    run_test("Reducciones: mismo resultado con 1, 2, 4 y 8 hilos y con -O2", same);
+
+    VM empty;
+    runProgram(empty, "VAR s = 5\nPARA PARALELO i DESDE 10 HASTA 0 REDUCIR SUMA s {\n    s = s + 1\n}\n", 4);
+    run_test("Reducciones: rango vacío no cambia la variable", globalText(empty, "s") == "5");
+
+    VM steps;
+    runProgram(steps, "VAR s = 0\nVAR f = 0\n"
+                      "PARA PARALELO i DESDE 100 HASTA 0 INCREMENTO -7 REDUCIR SUMA s {\n    s = s + i\n}\n"
+                      "PARA PARALELO x DESDE 0 HASTA 2.5 INCREMENTO 0.5 REDUCIR SUMA f {\n    f = f + x\n}\n",
+               3);
+    int64_t expected = 0;
+    for (int64_t i = 100; i > 0; i -= 7) expected += i;
+    run_test("Reducciones: INCREMENTO negativo", globalText(steps, "s") == std::to_string(expected));
+    run_test("Reducciones: rango FLOAT en un solo trozo", globalText(steps, "f") == "5.0");
+}
+
+// Pruebas de locales capturadas, arreglos compartidos y métodos
+void test_captures() {
+    VM vm;
+    runProgram(vm, "VAR salida = []\n"
+                   "VAR total = 0\n"
+                   "FUNC calcula(n, factor) {\n"
+                   "    VAR cuadrados = []\n"
+                   "    PARA i DESDE 0 HASTA n {\n"
+                   "        AGREGAR(cuadrados, 0)\n"
+                   "    }\n"
+                   "    VAR s = 0\n"
+                   "    PARA PARALELO i DESDE 0 HASTA n REDUCIR SUMA s {\n"
+                   "        cuadrados[i] = i * i * factor\n"
+                   "        s = s + cuadrados[i]\n"
+                   "    }\n"
+                   "    salida = cuadrados\n"
+                   "    RETORNAR s\n"
+                   "}\n"
+                   "total = calcula(3000, 2)\n",
+               4);
+    Value output = vm.getGlobal("salida");
+    bool filled = isObjType(output, ObjType::ARRAY) && asArray(output)->items.size() == 3000;
+    for (size_t i = 0; filled && i < 3000; ++i) {
+        filled = valueToString(asArray(output)->items[i]) == std::to_string(i * i * 2);
+    }
+    run_test("Capturas: escrituras disjuntas en un ARRAY compartido", filled);
+    run_test("Capturas: parámetros y REDUCIR en una función", globalText(vm, "total") == std::to_string(2 * 2999LL * 3000 * 5999 / 6));
+
+    VM typed;
+    runProgram(typed, "VAR a: ARRAY<FLOAT> = []\n"
+                      "VAR b: ARRAY<FLOAT> = []\n"
+                      "PARA i DESDE 0 HASTA 4096 {\n"
+                      "    a.AGREGAR(i * 0.5)\n"
+                      "    b.AGREGAR(2.0)\n"
+                      "}\n"
+                      "VAR producto = 0.0\n"
+                      "PARA PARALELO i DESDE 0 HASTA LONGITUD(a) REDUCIR SUMA producto {\n"
+                      "    producto = producto + a[i] * b[i]\n"
+                      "}\n",
+                  4);
+    run_test("Capturas: producto escalar sobre ARRAY<FLOAT>", globalText(typed, "producto") == "8386560.0");
+
+    VM methods;
+    runProgram(methods, "CLASE Acumulador {\n"
+                        "    VAR base = 10\n"
+                        "    FUNC escala(x) {\n"
+                        "        RETORNAR x * base\n"
+                        "    }\n"
+                        "    FUNC total(n) {\n"
+                        "        VAR s = 0\n"
+                        "        PARA PARALELO i DESDE 0 HASTA n REDUCIR SUMA s {\n"
+                        "            s = s + escala(i) + base\n"
+                        "        }\n"
+                        "        RETORNAR s\n"
+                        "    }\n"
+                        "}\n"
+                        "VAR r = Acumulador().total(100)\n",
+                    4);
+    run_test("Capturas: campos y métodos de `este`", globalText(methods, "r") == std::to_string(10 * 4950 + 1000));
+
+    VM nested;
+    runProgram(nested, "VAR s = 0\n"
+                       "PARA PARALELO i DESDE 0 HASTA 40 REDUCIR SUMA s {\n"
+                       "    VAR fila = 0\n"
+                       "    PARA PARALELO j DESDE 0 HASTA 40 REDUCIR SUMA fila {\n"
+                       "        fila = fila + i * j\n"
+                       "    }\n"
+                       "    s = s + fila\n"
+                       "}\n",
+                   4);
+    run_test("Capturas: PARA PARALELO anidado", globalText(nested, "s") == std::to_string(780 * 780));
+}
+
+// Pruebas de errores de compilación y de ejecución dentro del cuerpo
+void test_errors() {
+    std::string message = errorOf("VAR x = 0\nPARA PARALELO i DESDE 0 HASTA 10 {\n    x = x + i\n}\n");
+    run_test("Errores: las globales son de solo lectura", message.find("usa REDUCIR") != std::string::npos &&
+                                                               message.find("línea 3") != std::string::npos);
+    message = errorOf("FUNC f() {\n    VAR y = 0\n    PARA PARALELO i DESDE 0 HASTA 10 {\n        y += i\n    }\n}\n");
+    run_test("Errores: las locales externas son de solo lectura", message.find("'y' dentro de PARA PARALELO") != std::string::npos);
+    message = errorOf("PARA PARALELO i DESDE 0 HASTA 10 {\n    ROMPER\n}\n");
+    run_test("Errores: ROMPER no se admite", message.find("ROMPER no se admite") != std::string::npos);
+    message = errorOf("FUNC f() {\n    PARA PARALELO i DESDE 0 HASTA 10 {\n        RETORNAR i\n    }\n}\n");
+    run_test("Errores: RETORNAR no se admite", message.find("RETORNAR no se admite") != std::string::npos);
+    message = errorOf("VAR s = 0\nPARA PARALELO i DESDE 0 HASTA 10 REDUCIR MEDIA s {\n}\n");
+    run_test("Errores: operación de REDUCIR desconocida", message.find("SUMA, PRODUCTO, MIN o MAX") != std::string::npos);
+    message = errorOf("VAR s = 0\nPARA PARALELO i DESDE 0 HASTA 10 REDUCIR SUMA s, SUMA s {\n}\n");
+    run_test("Errores: variable repetida en REDUCIR", message.find("más de una vez") != std::string::npos);
+
+    // CONTINUAR y ROMPER dentro de un bucle interior siguen valiendo
+    VM vm;
+    runProgram(vm, "VAR s = 0\n"
+                   "PARA PARALELO i DESDE 0 HASTA 100 REDUCIR SUMA s {\n"
+                   "    SI i % 2 == 0 { CONTINUAR }\n"
+                   "    PARA j DESDE 0 HASTA 100 {\n"
+                   "        SI j == 3 { ROMPER }\n"
+                   "        s = s + 1\n"
+                   "    }\n"
+                   "}\n",
+               4);
+    run_test("Errores: CONTINUAR y ROMPER interior", globalText(vm, "s") == "150");
+
+    // Siempre se informa el error del primer trozo que falla, con su línea
+    bool stable = true;
+    for (size_t threads : {1, 2, 8}) {
+        message = errorOf("VAR datos = [1, 2, 3]\n"
+                          "FUNC f(i) {\n"
+                          "    SI i > 500 { RETORNAR datos[i % 3] - \"x\" }\n"
+                          "    RETORNAR datos[i % 3]\n"
+                          "}\n"
+                          "VAR s = 0\n"
+                          "PARA PARALELO i DESDE 0 HASTA 4000 REDUCIR SUMA s {\n"
+                          "    s = s + f(i)\n"
+                          "}\n",
+                          threads);
+        stable = stable && message.find("línea 3") != std::string::npos && message.find("en f") != std::string::npos;
+    }
+    run_test("Errores: el error llega con su línea y función", stable);
+    message = errorOf("FUNC g() {\n    x = 1\n}\nVAR x = 0\nPARA PARALELO i DESDE 0 HASTA 10 {\n    g()\n}\n");
+    run_test("Errores: una función llamada tampoco puede escribir globales",
+             message.find("no se puede modificar la global 'x'") != std::string::npos);
+    message = errorOf("FUNC g() {\n}\nPARA PARALELO i DESDE 0 HASTA 10 {\n    LANZAR(g)\n}\n");
+    run_test("Errores: LANZAR no se admite en los hilos", message.find("LANZAR no se admite") != std::string::npos);
+    message = errorOf("PARA PARALELO i DESDE 0 HASTA 10 INCREMENTO 0 {\n}\n");
+    run_test("Errores: INCREMENTO 0", message.find("no puede ser 0") != std::string::npos);
+}
+
+// Los objetos creados en los hilos pasan al heap principal y sobreviven a la recolección
+void test_worker_allocations() {
+    VM vm;
+    runProgram(vm, "VAR filas = []\n"
+                   "PARA i DESDE 0 HASTA 2000 {\n"
+                   "    AGREGAR(filas, NULO)\n"
+                   "}\n"
+                   "PARA PARALELO i DESDE 0 HASTA 2000 {\n"
+                   "    filas[i] = [\"fila\" + i, {\"id\": i}]\n"
+                   "}\n"
+                   "VAR basura = []\n"
+                   "PARA i DESDE 0 HASTA 50000 {\n"
+                   "    basura = [i, \"b\" + i]\n"
+                   "}\n"
+                   "VAR ok = VERDADERO\n"
+                   "PARA i DESDE 0 HASTA 2000 {\n"
+                   "    SI filas[i][0] != \"fila\" + i O filas[i][1][\"id\"] != i { ok = FALSO }\n"
+                   "}\n",
+               4);
+    vm.collectGarbage(true);
+    GcStats stats = vm.heap().stats();
+    run_test("Heap: lo asignado en los hilos sobrevive a la recolección",
+             globalText(vm, "ok") == "VERDADERO" && stats.minorCollections + stats.majorCollections > 0);
+}
+
+// Los hilos recolectan su basura durante el bucle sin perder lo que comparten
+void test_worker_collections() {
+    int64_t length = 0;
+    for (int64_t i = 0; i < 400000; ++i) length += 6 + static_cast<int64_t>(std::to_string(i).size());
+    VM vm;
+    runProgram(vm, "VAR filas = []\n"
+                   "PARA i DESDE 0 HASTA 4000 {\n"
+                   "    AGREGAR(filas, NULO)\n"
+                   "}\n"
+                   "VAR total = 0\n"
+                   "VAR mayor = 0\n"
+                   "PARA PARALELO i DESDE 0 HASTA 400000 REDUCIR SUMA total, MAX mayor {\n"
+                   "    VAR basura = [i, \"texto \" + i, {\"id\": i}]\n"
+                   "    SI i < 4000 { filas[i] = [\"fila\" + i, [i]] }\n"
+                   "    total = total + LONGITUD(basura[1])\n"
+                   "    SI basura[2][\"id\"] > mayor { mayor = basura[2][\"id\"] }\n"
+                   "}\n",
+               4);
+    GcStats stats = vm.heap().stats();
+    run_test("Heap: los hilos recolectan durante el bucle", stats.minorCollections > 4);
+    run_test("Heap: la memoria reservada no crece con lo asignado en los hilos",
+             stats.heapBytes * 4 < stats.allocatedBytes);
+    run_test("Heap: resultados de los trozos tras recolectar en los hilos",
+             globalText(vm, "total") == std::to_string(length) && globalText(vm, "mayor") == "399999");
+    vm.collectGarbage(true);
+    Value rows = vm.getGlobal("filas");
+    bool kept = true;
+    for (size_t i = 0; kept && i < 4000; ++i) {
+        Value row = asArray(rows)->items[i];
+        kept = isObjType(row, ObjType::ARRAY) && valueToString(asArray(row)->items[0]) == "fila" + std::to_string(i) &&
+               valueToString(asArray(asArray(row)->items[1])->items[0]) == std::to_string(i);
+    }
+    run_test("Heap: lo guardado en un ARRAY compartido sobrevive a las recolecciones de los hilos", kept);
+}
+
+int main() {
+    test_pool();
+    test_reductions();
+    test_captures();
+    test_errors();
+    test_worker_allocations();
+    test_worker_collections();
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
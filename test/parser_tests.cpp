@@ -0,0 +1,188 @@
+#include "ast.h"
+#include "lexer.h"
+#include "parser.h"
+#include <iostream>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Devuelve true si el código produce un error de sintaxis
+bool failsToParse(const std::string& source) {
+    AstArena arena;
+    try {
+        parseSource(source, arena);
+    } catch (const SyntaxError&) {
+        return true;
+    }
+    return false;
+}
+
+// Pruebas del analizador léxico
+void test_lexer() {
+    Lexer lexer("VAR x: INT = 42 // comentario\nSI x >= 3.5 { MOSTRAR(\"hola\") }");
+    run_test("Lexer: palabra clave VAR", lexer.next().kind == TokenKind::KW_VAR);
+    Token ident = lexer.next();
+    run_test("Lexer: identificador", ident.kind == TokenKind::IDENT && lexer.text(ident) == "x");
+    lexer.next();  // ':'
+    lexer.next();  // INT
+    run_test("Lexer: asignación", lexer.next().kind == TokenKind::ASSIGN);
+    Token number = lexer.next();
+    run_test("Lexer: literal entero", number.kind == TokenKind::INT_LIT && number.intValue == 42);
+    Token si = lexer.next();
+    run_test("Lexer: salto de línea tras comentario", si.kind == TokenKind::KW_SI && si.newlineBefore && si.line == 2);
+    lexer.next();  // x
+    run_test("Lexer: operador >=", lexer.next().kind == TokenKind::GE);
+    Token decimal = lexer.next();
+    run_test("Lexer: literal decimal", decimal.kind == TokenKind::FLOAT_LIT && decimal.floatValue == 3.5);
+
+    Lexer accents("PÚBLICO MÁS_SI SELECCIÓN");
+    run_test("Lexer: palabras clave con tilde",
+             accents.next().kind == TokenKind::KW_PUBLICO &&
+             accents.next().kind == TokenKind::KW_MAS_SI &&
+             accents.next().kind == TokenKind::KW_SELECCION);
+}
+
+// Pruebas de la estructura del AST
+void test_parser_structure() {
+    AstArena arena;
+    NodeId program = parseSource(
+        "FUNC suma(a: INT, b: INT): INT {\n"
+        "    RETORNAR a + b * 2\n"
+        "}\n"
+        "VAR numeros: ARRAY<INT> = [1, 2, 3]\n",
+        arena);
+
+    run_test("Parser: programa con dos declaraciones", arena.childCount(program) == 2);
+
+    NodeId fn = arena.children(program)[0];
+    const AstNode& fnNode = arena.node(fn);
+    run_test("Parser: declaración de función", fnNode.kind == NodeKind::FUNC_DECL && arena.str(fnNode.v.str) == "suma");
+    run_test("Parser: dos parámetros", arena.childCount(fn) == 2);
+
+    NodeId ret = arena.children(fnNode.d)[0];
+    const AstNode& sum = arena.node(arena.node(ret).a);
+    run_test("Parser: precedencia de operadores",
+             sum.kind == NodeKind::BINARY && sum.op == OpKind::ADD &&
+             arena.node(sum.b).op == OpKind::MUL);
+
+    NodeId decl = arena.children(program)[1];
+    const AstNode& type = arena.node(arena.node(decl).a);
+    run_test("Parser: tipo genérico ARRAY<INT>",
+             arena.str(type.v.str) == "ARRAY" && type.c == 1);
+    run_test("Parser: literal de arreglo", arena.childCount(arena.node(decl).d) == 3);
+}
+
+// Pruebas de estructuras de control
+void test_parser_control_flow() {
+    AstArena arena;
+    NodeId program = parseSource(
+        "SI x > 10 {\n"
+        "    MOSTRAR(\"mayor\")\n"
+        "} SINO SI x == 10 {\n"
+        "    MOSTRAR(\"igual\")\n"
+        "} SINO {\n"
+        "    MOSTRAR(\"menor\")\n"
+        "}\n"
+        "PARA i DESDE 0 HASTA LONGITUD(xs) INCREMENTO 2 { total += xs[i] }\n"
+        "PARA CADA x EN xs { MOSTRAR(x) }\n"
+        "MIENTRAS (VERDADERO) { ROMPER }\n"
+        "SELECCION edad {\n"
+        "    CASO edad <= 12:\n"
+        "        RETORNAR \"Niño\"\n"
+        "    CASO 30:\n"
+        "        RETORNAR \"Treinta\"\n"
+        "    DEFECTO:\n"
+        "        RETORNAR \"Mayor\"\n"
+        "}\n",
+        arena);
+
+    const NodeId* items = arena.children(program);
+    const AstNode& ifNode = arena.node(items[0]);
+    run_test("Parser: SI / SINO SI encadenado",
+             ifNode.kind == NodeKind::IF && arena.node(ifNode.d).kind == NodeKind::IF);
+    const AstNode& forNode = arena.node(items[1]);
+    run_test("Parser: PARA con INCREMENTO", forNode.kind == NodeKind::FOR_RANGE && forNode.c != kNoNode);
+    run_test("Parser: PARA CADA", arena.kind(items[2]) == NodeKind::FOR_EACH);
+    run_test("Parser: MIENTRAS", arena.kind(items[3]) == NodeKind::WHILE);
+
+    NodeId sw = items[4];
+    const NodeId* cases = arena.children(sw);
+    run_test("Parser: SELECCION con tres casos", arena.childCount(sw) == 3);
+    run_test("Parser: CASO condicional", (arena.node(cases[0]).flags & FLAG_GUARD) != 0);
+    run_test("Parser: CASO por valor", (arena.node(cases[1]).flags & FLAG_GUARD) == 0);
+    run_test("Parser: DEFECTO", arena.node(cases[2]).a == kNoNode);
+}
+
+// Pruebas de clases, estructuras y módulos
+void test_parser_declarations() {
+    AstArena arena;
+    NodeId program = parseSource(
+        "IMPORTAR \"utils\"\n"
+        "STRUCT Persona {\n"
+        "    nombre: STRING\n"
+        "    edad: INT\n"
+        "}\n"
+        "CLASE Estudiante : Persona {\n"
+        "    PRIVADO:\n"
+        "        VAR promedio: FLOAT\n"
+        "    PÚBLICO:\n"
+        "        CONSTRUCTOR(n: STRING, e: INT)\n"
+        "            : Persona(n, e) {\n"
+        "            promedio = 0.0\n"
+        "        }\n"
+        "        FUNC obtener(): FLOAT {\n"
+        "            RETORNAR promedio\n"
+        "        }\n"
+        "}\n"
+        "MODULO Conversor {\n"
+        "    CONST FACTOR = 3.28084\n"
+        "}\n",
+        arena);
+
+    const NodeId* items = arena.children(program);
+    run_test("Parser: IMPORTAR", arena.kind(items[0]) == NodeKind::IMPORT &&
+                                 arena.str(arena.node(items[0]).v.str) == "utils");
+    run_test("Parser: STRUCT con dos campos", arena.kind(items[1]) == NodeKind::STRUCT_DECL &&
+                                             arena.childCount(items[1]) == 2);
+
+    NodeId cls = items[2];
+    const NodeId* members = arena.children(cls);
+    run_test("Parser: CLASE con clase base", arena.node(cls).a != kNoNode);
+    run_test("Parser: campo privado", (arena.node(members[0]).flags & FLAG_PRIVATE) != 0);
+    run_test("Parser: constructor con llamada base",
+             arena.kind(members[1]) == NodeKind::CTOR_DECL && arena.node(members[1]).a != kNoNode);
+    run_test("Parser: método público",
+             arena.kind(members[2]) == NodeKind::FUNC_DECL && (arena.node(members[2]).flags & FLAG_PRIVATE) == 0);
+    run_test("Parser: MODULO", arena.kind(items[3]) == NodeKind::MODULE_DECL);
+}
+
+// Pruebas de errores de sintaxis
+void test_parser_errors() {
+    run_test("Error: bloque sin cerrar", failsToParse("FUNC f() {\n MOSTRAR(1)\n"));
+    run_test("Error: cadena sin cerrar", failsToParse("VAR s = \"abc\n"));
+    run_test("Error: asignación inválida", failsToParse("1 = 2\n"));
+    run_test("Error: CONST sin valor", failsToParse("CONST X\n"));
+    run_test("Código válido no produce error", !failsToParse("VAR x = -3 + (2 * 4)\n"));
+}
+
+int main() {
+    std::cout << "Iniciando pruebas del analizador de MC++" << std::endl;
+
+    test_lexer();
+    test_parser_structure();
+    test_parser_control_flow();
+    test_parser_declarations();
+    test_parser_errors();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "ast.h"
+#include "builtins.h"
+#include "bytecode_cache.h"
+#include "codegen.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+// Programa sintético con muchas funciones, similar a un script con varios módulos importados
+std::string generateProgram(int functions) {
+    std::string source;
+    for (int i = 0; i < functions; ++i) {
+        std::string n = std::to_string(i);
+        source += "FUNC tarea" + n + "(x) {\n"
+                  "    VAR total = 0\n"
+                  "    PARA i DESDE 0 HASTA x { total += i * " + n + " }\n"
+                  "    SI total > 100 { RETORNAR \"alta " + n + "\" }\n"
+                  "    RETORNAR total\n"
+                  "}\n";
+    }
+    source += "VAR r = tarea0(10)\n";
+    return source;
+}
+
+// Tiempo medio de arranque (hasta tener el prototipo listo para ejecutar) en microsegundos
+double startupTime(const std::string& source, const std::string& cachePath, bool useCache, int repetitions) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repetitions; ++i) {
+        mc_core::VM vm;
+        mc_core::registerBuiltins(vm);
+        uint64_t sourceHash = mc_core::hashSource(source);
+        mc_core::FunctionProto* script = useCache ? mc_core::loadBytecodeCache(vm, sourceHash, 0, cachePath) : nullptr;
+        if (script == nullptr) {
+            mc_core::AstArena arena;
+            mc_core::NodeId program = mc_core::parseSource(source, arena);
+            script = mc_core::compileProgram(vm, arena, program);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / repetitions;
+}
+
+void performanceTestStartup(int functions) {
+    std::string source = generateProgram(functions);
+    std::string cachePath = (std::filesystem::temp_directory_path() / "mcpp_performance_cache.mcc").string();
+
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::writeBytecodeCache(vm, mc_core::compileProgram(vm, arena, program), mc_core::hashSource(source), 0,
+                                cachePath);
+
+    double compiled = startupTime(source, cachePath, false, 50);
+    double cached = startupTime(source, cachePath, true, 50);
+    std::cout << functions << " funciones (" << source.size() << " bytes):" << std::endl;
+    std::cout << "  análisis + compilación: " << compiled << " us" << std::endl;
+    std::cout << "  caché .mcc:             " << cached << " us" << std::endl;
+    std::cout << "  aceleración:            " << compiled / cached << "x" << std::endl;
+    std::remove(cachePath.c_str());
+}
+
+int main() {
+    performanceTestStartup(10);
+    performanceTestStartup(100);
+    performanceTestStartup(1000);
+    return 0;
+}
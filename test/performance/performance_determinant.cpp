@@ -0,0 +1,79 @@
+#include "../../src/libraries/math/linear_algebra.h"
+#include "../../src/libraries/math/matrix.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// El matrix_determinant anterior: desarrollo por cofactores con una submatriz nueva en cada nivel
+int previousDeterminant(const std::vector<std::vector<int>>& matrix) {
+    int n = matrix.size();
+    if (n == 1) return matrix[0][0];
+    if (n == 2) return matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
+    int det = 0;
+    for (int col = 0; col < n; col++) {
+        std::vector<std::vector<int>> submatrix(n - 1, std::vector<int>(n - 1));
+        for (int i = 1; i < n; i++) {
+            int sub_col = 0;
+            for (int j = 0; j < n; j++) {
+                if (j == col) continue;
+                submatrix[i - 1][sub_col++] = matrix[i][j];
+            }
+        }
+        det += ((col % 2 == 0) ? 1 : -1) * matrix[0][col] * previousDeterminant(submatrix);
+    }
+    return det;
+}
+
+// Entradas en {-1, 0, 1}: los determinantes se mantienen pequeños y la comparación es exacta
+Matrix<int> randomSigns(std::size_t n, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(-1, 1);
+    Matrix<int> m(n, n);
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) m(i, j) = distribution(generator);
+    }
+    return m;
+}
+
+template <typename Fn>
+double seconds(const Fn& fn) {
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void performanceTestCofactors(std::size_t n) {
+    Matrix<int> m = randomSigns(n, static_cast<unsigned>(n));
+    std::vector<std::vector<int>> nested = m.to_nested();
+    int previous = 0, bareiss = 0;
+    double cofactors = seconds([&] { previous = previousDeterminant(nested); });
+    double exact = seconds([&] { bareiss = LinearAlgebra::matrix_determinant(m); });
+    std::cout << "Determinante " << n << "x" << n << ": cofactores " << cofactors * 1000.0 << " ms, Bareiss "
+              << exact * 1e6 << " us, aceleración: " << cofactors / exact << "x"
+              << (previous == bareiss ? "" : " (RESULTADOS DISTINTOS)") << std::endl;
+}
+
+void performanceTestLarge(std::size_t n) {
+    Matrix<int> m = randomSigns(n, 7);
+    // Sobre matrices aleatorias los menores crecen rápido: se usa una matriz con determinante pequeño
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < i; j++) m(i, j) = 0;
+        m(i, i) = 1;
+    }
+    Matrix<float> real(n, n);
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) real(i, j) = static_cast<float>(m(i, j));
+    }
+    double exact = seconds([&] { LinearAlgebra::matrix_determinant(m); });
+    double lu = seconds([&] { LinearAlgebra::matrix_determinant(real); });
+    std::cout << "Determinante " << n << "x" << n << ": Bareiss (int64) " << exact * 1000.0 << " ms, LU (float) "
+              << lu * 1000.0 << " ms" << std::endl;
+}
+
+int main() {
+    for (std::size_t n : {6, 8, 10, 11}) performanceTestCofactors(n);
+    for (std::size_t n : {100, 500, 1000}) performanceTestLarge(n);
+    return 0;
+}
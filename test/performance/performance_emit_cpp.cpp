@@ -0,0 +1,66 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "compiler.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Programa tipado con bucles, llamadas y RAIZ: todo lo que --emit=cpp traduce
+std::string numericProgram(int iterations) {
+    return "FUNC paso(x: FLOAT, i: INT): FLOAT {\n"
+           "    RETORNAR x * 0.999 + RAIZ(i % 100)\n"
+           "}\n"
+           "VAR s = 0\n"
+           "VAR x = 0.0\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+           "    s = (s + i * 7) % 1000003\n"
+           "    x = paso(x, i)\n"
+           "}\n"
+           "MOSTRAR(s, x)\n";
+}
+
+double interpretedMs(const std::string& source) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    mc_core::optimizeProgram(vm, 2);
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double nativeMs(const std::string& source) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "mcpp_emit_perf";
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "programa.mc") << source;
+    Compiler((dir / "programa.mc").string(), false, 2, true).run();
+    std::string command = "'" + (dir / "programa").string() + "' > /dev/null";
+    auto start = std::chrono::high_resolution_clock::now();
+    int status = std::system(command.c_str());
+    auto end = std::chrono::high_resolution_clock::now();
+    std::filesystem::remove_all(dir);
+    if (status != 0) std::cerr << "El ejecutable generado terminó con error" << std::endl;
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main() {
+    if (std::getenv("MCPP_LIBRARY_DIR") == nullptr) {
+        setenv("MCPP_LIBRARY_DIR", std::filesystem::absolute("src/libraries").c_str(), 1);
+    }
+    std::string source = numericProgram(10000000);
+    double interpreted = interpretedMs(source);
+    double native = nativeMs(source);
+    std::cout << "10M iteraciones: " << interpreted << " ms interpretado, " << native
+              << " ms con --emit=cpp (" << interpreted / native << "x, incluye arrancar el proceso)" << std::endl;
+    return 0;
+}
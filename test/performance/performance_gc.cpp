@@ -0,0 +1,51 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "heap.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Demonio de monitorización típico: conserva una ventana de muestras (viejas) y crea
+// muchos objetos de corta vida en cada iteración.
+std::string monitoringDaemon(int iterations) {
+    return "VAR ventana = []\n"
+           "PARA i DESDE 0 HASTA 1000 { ventana.AGREGAR({\"cpu\": 0, \"mem\": 0}) }\n"
+           "VAR alertas = 0\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+           "    VAR muestra = {\"cpu\": i % 100, \"mem\": (i * 7) % 100, \"host\": \"nodo-\" + (i % 16)}\n"
+           "    ventana[i % 1000] = muestra\n"
+           "    SI muestra[\"cpu\"] > 90 { alertas += 1 }\n"
+           "}\n";
+}
+
+void performanceTestGc(int iterations) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(monitoringDaemon(iterations), arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    mc_core::GcStats stats = vm.heap().stats();
+    double total = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cout << "Demonio x" << iterations << ": " << total << " ms" << std::endl;
+    std::cout << "  recolecciones: " << stats.minorCollections << " menores, " << stats.majorCollections
+              << " completas" << std::endl;
+    std::cout << "  pausas: máxima " << stats.maxPauseMs << " ms, total " << stats.totalPauseMs << " ms ("
+              << 100.0 * stats.totalPauseMs / total << "%)" << std::endl;
+    std::cout << "  heap: " << stats.heapBytes / 1024 << " KB reservados, " << stats.liveBytes / 1024
+              << " KB vivos, promoción " << 100.0 * stats.promotionRate() << "%" << std::endl;
+}
+
+int main() {
+    performanceTestGc(100000);
+    performanceTestGc(1000000);
+    performanceTestGc(5000000);
+    return 0;
+}
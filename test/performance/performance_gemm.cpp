@@ -0,0 +1,107 @@
+#include "../../src/libraries/math/gemm.h"
+#include "../../src/libraries/math/matrix.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+Matrix<float> randomMatrix(std::size_t rows, std::size_t cols, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    Matrix<float> m(rows, cols);
+    for (std::size_t i = 0; i < rows; i++) {
+        for (std::size_t j = 0; j < cols; j++) m(i, j) = distribution(generator);
+    }
+    return m;
+}
+
+// El matrix_multiply anterior: triple bucle i-j-k sobre vector<vector<float>>
+double naiveSeconds(const std::vector<std::vector<float>>& a, const std::vector<std::vector<float>>& b) {
+    auto start = std::chrono::high_resolution_clock::now();
+    std::size_t rows = a.size(), inner = b.size(), cols = b[0].size();
+    std::vector<std::vector<float>> result(rows, std::vector<float>(cols, 0));
+    for (std::size_t i = 0; i < rows; i++) {
+        for (std::size_t j = 0; j < cols; j++) {
+            for (std::size_t k = 0; k < inner; k++) result[i][j] += a[i][k] * b[k][j];
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    volatile float sink = result[rows / 2][cols / 2];
+    (void)sink;
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Mejor tiempo de varias repeticiones, para no medir la primera reserva de memoria
+double gemmSeconds(const Matrix<float>& a, const Matrix<float>& b, int repetitions) {
+    Matrix<float> c(a.rows(), b.cols());
+    double best = 1e30;
+    for (int r = 0; r < repetitions; r++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        Gemm::multiply(a, b, c);
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+double gflops(std::size_t m, std::size_t n, std::size_t k, double seconds) { return 2.0 * m * n * k / seconds * 1e-9; }
+
+void performanceTestGemm(std::size_t m, std::size_t n, std::size_t k, bool naive) {
+    Matrix<float> a = randomMatrix(m, k, 1);
+    Matrix<float> b = randomMatrix(k, n, 2);
+    int repetitions = m * n * k > (std::size_t(1) << 30) ? 1 : 3;
+    double seconds = gemmSeconds(a, b, repetitions);
+    std::cout << m << "x" << k << " * " << k << "x" << n << ": " << gflops(m, n, k, seconds) << " GFLOP/s ("
+              << seconds * 1000.0 << " ms)";
+    if (naive) {
+        double naiveTime = naiveSeconds(a.to_nested(), b.to_nested());
+        std::cout << ", i-j-k: " << gflops(m, n, k, naiveTime) << " GFLOP/s, aceleración: " << naiveTime / seconds
+                  << "x";
+    }
+    std::cout << std::endl;
+}
+
+void performanceTestKernels(std::size_t size) {
+    Matrix<float> a = randomMatrix(size, size, 3);
+    Matrix<float> b = randomMatrix(size, size, 4);
+    const char* names[] = {"escalar", "SSE", "AVX2+FMA"};
+    GemmKernel best = Gemm::detect_kernel();
+    for (int kernel = 0; kernel <= static_cast<int>(best); kernel++) {
+        Gemm::set_kernel(static_cast<GemmKernel>(kernel));
+        std::cout << "  micro-núcleo " << names[kernel] << ": "
+                  << gflops(size, size, size, gemmSeconds(a, b, 3)) << " GFLOP/s" << std::endl;
+    }
+    Gemm::set_kernel(best);
+}
+
+void performanceTestThreads(std::size_t size) {
+    Matrix<float> a = randomMatrix(size, size, 5);
+    Matrix<float> b = randomMatrix(size, size, 6);
+    std::size_t threads = Gemm::thread_count();
+    Gemm::set_thread_count(1);
+    double single = gemmSeconds(a, b, 2);
+    Gemm::set_thread_count(0);
+    double all = gemmSeconds(a, b, 2);
+    std::cout << "  1 hilo: " << gflops(size, size, size, single) << " GFLOP/s, " << threads
+              << " hilo(s) por defecto: " << gflops(size, size, size, all) << " GFLOP/s" << std::endl;
+}
+
+int main() {
+    std::cout << "GEMM cuadrado:" << std::endl;
+    for (std::size_t size : {64, 128, 256, 512}) performanceTestGemm(size, size, size, true);
+    for (std::size_t size : {1024, 2048, 4096}) performanceTestGemm(size, size, size, false);
+
+    std::cout << "GEMM alargado:" << std::endl;
+    performanceTestGemm(4096, 4096, 64, false);
+    performanceTestGemm(64, 64, 4096, false);
+    performanceTestGemm(2048, 16, 2048, false);
+    performanceTestGemm(16, 2048, 2048, false);
+
+    std::cout << "Micro-núcleos, 1024x1024:" << std::endl;
+    performanceTestKernels(1024);
+    std::cout << "Hilos, 2048x2048:" << std::endl;
+    performanceTestThreads(2048);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// `clases` clases distintas con los campos x, y en posiciones distintas; el bucle lee y
+// escribe los campos sobre todas ellas desde los mismos sitios
+std::string fieldProgram(int classes, int iterations) {
+    std::string source;
+    std::string objects = "VAR objetos = [";
+    for (int k = 0; k < classes; ++k) {
+        source += "STRUCT C" + std::to_string(k) + " {";
+        for (int f = 0; f < k; ++f) source += " r" + std::to_string(f) + ": INT,";
+        source += " x: INT, y: INT }\n";
+        objects += std::string(k > 0 ? ", " : "") + "C" + std::to_string(k) + "(";
+        for (int f = 0; f < k; ++f) objects += "0, ";
+        objects += "1, 2)";
+    }
+    source += objects + "]\n"
+              "VAR total = 0\n"
+              "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+              "    VAR o = objetos[i % " + std::to_string(classes) + "]\n"
+              "    o.x = o.x + o.y\n"
+              "    total += o.x - o.y\n"
+              "}\n";
+    return source;
+}
+
+// Lo mismo con MAP: cada acceso es una búsqueda por clave
+std::string mapProgram(int iterations) {
+    return "VAR o = {\"x\": 1, \"y\": 2}\n"
+           "VAR total = 0\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+           "    o[\"x\"] = o[\"x\"] + o[\"y\"]\n"
+           "    total += o[\"x\"] - o[\"y\"]\n"
+           "}\n";
+}
+
+double runProgram(const std::string& source) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void performanceTestInlineCaches(int iterations) {
+    std::cout << "Accesos a campos x" << iterations << " (4 lecturas y 1 escritura por iteración):" << std::endl;
+    std::cout << "  monomórfico (1 clase):    " << runProgram(fieldProgram(1, iterations)) << " ms" << std::endl;
+    std::cout << "  polimórfico (4 clases):   " << runProgram(fieldProgram(4, iterations)) << " ms" << std::endl;
+    std::cout << "  megamórfico (16 clases):  " << runProgram(fieldProgram(16, iterations)) << " ms" << std::endl;
+    std::cout << "  MAP con claves de cadena: " << runProgram(mapProgram(iterations)) << " ms" << std::endl;
+}
+
+int main() {
+    performanceTestInlineCaches(1000000);
+    performanceTestInlineCaches(10000000);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "jit.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Bucles numéricos sin llamadas: el caso para el que existen las trazas
+std::string integerProgram(int iterations) {
+    return "VAR s = 0\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+           "    s = (s + i * 7) % 1000003\n"
+           "}\n";
+}
+
+std::string floatProgram(int iterations) {
+    return "VAR v: ARRAY<FLOAT> = [0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0]\n"
+           "VAR suma = 0.0\n"
+           "PARA vuelta DESDE 0 HASTA " + std::to_string(iterations / 8) + " {\n"
+           "    PARA i DESDE 0 HASTA LONGITUD(v) {\n"
+           "        v[i] = v[i] * 0.5 + i\n"
+           "        suma = suma + v[i] / 3.0\n"
+           "    }\n"
+           "}\n";
+}
+
+double runProgram(const std::string& source, bool jit) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    vm.setJitEnabled(jit);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    mc_core::optimizeProgram(vm, 2);
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void performanceTestJit(const std::string& name, const std::string& source) {
+    double interpreted = runProgram(source, false);
+    double traced = runProgram(source, true);
+    std::cout << name << ": " << interpreted << " ms interpretado, " << traced << " ms con trazas ("
+              << interpreted / traced << "x)" << std::endl;
+}
+
+int main() {
+    if (!mc_core::Jit::supported()) {
+        std::cout << "JIT no disponible en esta plataforma." << std::endl;
+        return 0;
+    }
+    performanceTestJit("INT, 10M iteraciones", integerProgram(10000000));
+    performanceTestJit("ARRAY<FLOAT>, 10M accesos", floatProgram(10000000));
+    return 0;
+}
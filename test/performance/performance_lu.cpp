@@ -0,0 +1,104 @@
+#include "../../src/libraries/math/linear_algebra_advanced.h"
+#include "../../src/libraries/math/lu_factorization.h"
+#include "../../src/libraries/math/matrix.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Matriz aleatoria con la diagonal reforzada, para que la anterior LU sin pivoteo también termine
+Matrix<float> randomSystem(std::size_t n, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    Matrix<float> m(n, n);
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) m(i, j) = distribution(generator);
+        m(i, i) += static_cast<float>(n);
+    }
+    return m;
+}
+
+// La anterior matrix_lu_decomposition: Doolittle sin pivoteo sobre vector<vector<float>>
+void previousLu(const std::vector<std::vector<float>>& matrix, std::vector<std::vector<float>>& L,
+                std::vector<std::vector<float>>& U) {
+    std::size_t size = matrix.size();
+    L.assign(size, std::vector<float>(size, 0));
+    U.assign(size, std::vector<float>(size, 0));
+    for (std::size_t i = 0; i < size; i++) {
+        for (std::size_t k = i; k < size; k++) {
+            float sum = 0;
+            for (std::size_t j = 0; j < i; j++) sum += L[i][j] * U[j][k];
+            U[i][k] = matrix[i][k] - sum;
+        }
+        for (std::size_t k = i; k < size; k++) {
+            if (i == k) {
+                L[i][i] = 1.0f;
+                continue;
+            }
+            float sum = 0;
+            for (std::size_t j = 0; j < i; j++) sum += L[k][j] * U[j][i];
+            L[k][i] = (matrix[k][i] - sum) / U[i][i];
+        }
+    }
+}
+
+template <typename Fn>
+double seconds(const Fn& fn) {
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void performanceTestFactorization(std::size_t n, bool previous) {
+    Matrix<float> a = randomSystem(n, 1);
+    double blocked = seconds([&] { LUFactorization lu(a); });
+    double flops = 2.0 / 3.0 * n * n * n;
+    std::cout << "LU " << n << "x" << n << ": " << blocked * 1000.0 << " ms, " << flops / blocked * 1e-9
+              << " GFLOP/s";
+    if (previous) {
+        std::vector<std::vector<float>> nested = a.to_nested(), L, U;
+        double naive = seconds([&] { previousLu(nested, L, U); });
+        std::cout << ", sin pivoteo anterior: " << naive * 1000.0 << " ms, aceleración: " << naive / blocked << "x";
+    }
+    std::cout << std::endl;
+}
+
+// Muchos sistemas con la misma matriz: refactorizar en cada uno frente a reutilizar la factorización
+void performanceTestRepeatedSolves(std::size_t n, std::size_t systems) {
+    Matrix<float> a = randomSystem(n, 2);
+    std::vector<float> b(n, 1.0f);
+    double refactor = seconds([&] {
+        for (std::size_t s = 0; s < systems; s++) {
+            b[s % n] += 1.0f;
+            LUFactorization(a).solve(b);
+        }
+    });
+    double reuse = seconds([&] {
+        LUFactorization lu(a);
+        for (std::size_t s = 0; s < systems; s++) {
+            b[s % n] += 1.0f;
+            lu.solve(b);
+        }
+    });
+    std::cout << systems << " sistemas de " << n << "x" << n << ": refactorizando " << refactor * 1000.0
+              << " ms, reutilizando " << reuse * 1000.0 << " ms (" << reuse / systems * 1e6
+              << " us/solve), aceleración: " << refactor / reuse << "x" << std::endl;
+}
+
+void performanceTestInverse(std::size_t n) {
+    Matrix<float> a = randomSystem(n, 3);
+    Matrix<float> inverse;
+    double time = seconds([&] { LinearAlgebraAdvanced::matrix_inverse(a, inverse); });
+    std::cout << "Inversa " << n << "x" << n << ": " << time * 1000.0 << " ms" << std::endl;
+}
+
+int main() {
+    for (std::size_t n : {128, 256, 512, 1024}) performanceTestFactorization(n, true);
+    performanceTestFactorization(2048, false);
+    performanceTestRepeatedSolves(256, 1000);
+    performanceTestRepeatedSolves(1024, 100);
+    for (std::size_t n : {256, 1024}) performanceTestInverse(n);
+    return 0;
+}
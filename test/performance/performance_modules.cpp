@@ -0,0 +1,80 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "module_loader.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+const std::filesystem::path kWorkDir = std::filesystem::temp_directory_path() / "mcpp_module_perf";
+
+// Módulo de biblioteca sintético con `functions` funciones como las de los ejemplos
+std::string generateModule(int functions) {
+    std::string source = "VAR llamadas = 0\n";
+    for (int f = 0; f < functions; ++f) {
+        std::string n = std::to_string(f);
+        source += "FUNC calcular" + n + "(a, b) {\n";
+        source += "    llamadas = llamadas + 1\n";
+        source += "    VAR total = 0.0\n";
+        source += "    PARA i DESDE 0 HASTA a {\n";
+        source += "        SI i % 2 == 0 {\n";
+        source += "            total = total + b * i\n";
+        source += "        } SINO {\n";
+        source += "            total = total - (b / 2.0)\n";
+        source += "        }\n";
+        source += "    }\n";
+        source += "    RETORNAR total\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+struct Startup {
+    double loadMs;   // Hasta tener los módulos compilados en el VM
+    double totalMs;  // Hasta tener el programa listo para ejecutarse (con el optimizador)
+};
+
+Startup startup(const std::string& source) {
+    auto start = std::chrono::high_resolution_clock::now();
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::ModuleLoader(vm, (kWorkDir / "programa.mc").string()).load(arena, program);
+    auto loaded = std::chrono::high_resolution_clock::now();
+    mc_core::compileProgram(vm, arena, program);
+    mc_core::optimizeProgram(vm, mc_core::kDefaultOptimizationLevel);
+    auto end = std::chrono::high_resolution_clock::now();
+    return {std::chrono::duration<double, std::milli>(loaded - start).count(),
+            std::chrono::duration<double, std::milli>(end - start).count()};
+}
+
+void performanceTestModules(int modules, int functions) {
+    std::filesystem::create_directories(kWorkDir);
+    std::string source;
+    for (int m = 0; m < modules; ++m) {
+        std::string name = "biblioteca" + std::to_string(m);
+        std::ofstream(kWorkDir / (name + ".mc")) << generateModule(functions);
+        source += "IMPORTAR \"" + name + "\"\n";
+        source += "MOSTRAR(" + name + ".calcular0(3, 1.5))\n";
+    }
+
+    mc_core::ModuleLoader::clearCache();
+    Startup cold = startup(source);
+    Startup warm = startup(source);
+    std::cout << modules << " módulos de " << functions << " funciones: carga " << cold.loadMs << " ms en frío, "
+              << warm.loadMs << " ms con los AST de la caché del proceso (" << cold.totalMs << " / " << warm.totalMs
+              << " ms con el optimizador)" << std::endl;
+    std::filesystem::remove_all(kWorkDir);
+}
+
+int main() {
+    performanceTestModules(10, 50);
+    performanceTestModules(10, 500);
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "native_binding.h"
+#include "parser.h"
+#include "vm.h"
+#include "../../src/libraries/math/advanced_operations.h"
+#include "../../src/libraries/string/text_transformation.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+/**
+ * El puente anterior: los argumentos viajan en un map<string,string> con el formato
+ * de DataConversionAdvanced (numberToString / stringToNumber) y el resultado vuelve
+ * de la misma forma. Se reproduce aquí porque data_conversion_advanced.cpp necesita
+ * jsoncpp, pero las conversiones son las mismas.
+ */
+std::string numberToString(double number, int precision = 6) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << number;
+    return out.str();
+}
+
+mc_core::Value marshaledLogarithm(mc_core::VM&, mc_core::Value* args, int) {
+    std::map<std::string, std::string> request;
+    request["valor"] = numberToString(args[0].asNumber());
+    request["base"] = numberToString(args[1].asNumber());
+    double result = AdvancedOperations::log_base_n<double>(std::stod(request.at("valor")), std::stod(request.at("base")));
+    std::map<std::string, std::string> response{{"resultado", numberToString(result)}};
+    return mc_core::Value::number(std::stod(response.at("resultado")));
+}
+
+mc_core::Value marshaledUpper(mc_core::VM& vm, mc_core::Value* args, int) {
+    std::map<std::string, std::string> request{{"texto", mc_core::asString(args[0])->str()}};
+    std::map<std::string, std::string> response{{"resultado", TextTransformation::toUpper(request.at("texto"))}};
+    return vm.newString(response.at("resultado"));
+}
+
+double elapsedNs(std::chrono::high_resolution_clock::time_point start, int calls) {
+    return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / calls;
+}
+
+// Coste por llamada de la NativeFn, sin el bucle de despacho
+void performanceTestCallOverhead(int calls) {
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::Value numbers[2] = {mc_core::Value::number(1024.0), mc_core::Value::integer(2)};
+    mc_core::Value text[1] = {vm.newString("hola mundo")};
+    volatile double sink = 0.0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < calls; ++i) sink = sink + marshaledLogarithm(vm, numbers, 2).asNumber();
+    double marshaled = elapsedNs(start, calls);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        sink = sink + mc_core::NativeBinding<&AdvancedOperations::log_base_n<double>>::call(vm, numbers, 2).asNumber();
+    }
+    double bound = elapsedNs(start, calls);
+    std::cout << "math.logaritmo: " << marshaled << " ns por llamada con map<string,string>, " << bound
+              << " ns enlazada (" << marshaled / bound << "x)" << std::endl;
+
+    // Las cadenas resultado se quedan en el heap: se mide con pocas llamadas
+    int textCalls = calls / 10;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < textCalls; ++i) marshaledUpper(vm, text, 1);
+    marshaled = elapsedNs(start, textCalls);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < textCalls; ++i) mc_core::NativeBinding<&TextTransformation::toUpper>::call(vm, text, 1);
+    bound = elapsedNs(start, textCalls);
+    std::cout << "string_utils.toUpper: " << marshaled << " ns por llamada con map<string,string>, " << bound
+              << " ns enlazada (" << marshaled / bound << "x)" << std::endl;
+}
+
+// El mismo bucle de MC++ llamando a la versión enlazada y a la que pasa por el mapa
+void performanceTestScript(int iterations) {
+    std::string loop = "VAR total = 0.0\n"
+                       "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+                       "    total = total + math.FUNCION(i + 2, 2)\n"
+                       "}\n";
+    auto run = [&](const std::string& function) {
+        std::string source = "IMPORTAR \"math\"\n" + loop;
+        source.replace(source.find("FUNCION"), 7, function);
+        mc_core::VM vm;
+        mc_core::registerBuiltins(vm);
+        mc_core::ObjModule* math = vm.findModule("math");
+        math->members["logaritmo_mapa"] = mc_core::Value::object(
+            vm.heap().allocate<mc_core::ObjNative>(marshaledLogarithm, "math.logaritmo_mapa", 2));
+        mc_core::AstArena arena;
+        mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, mc_core::parseSource(source, arena));
+        auto start = std::chrono::high_resolution_clock::now();
+        vm.run(script);
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+    double marshaled = run("logaritmo_mapa");
+    double bound = run("logaritmo");
+    std::cout << iterations << " llamadas desde MC++: " << marshaled << " ms con map<string,string>, " << bound
+              << " ms enlazada" << std::endl;
+}
+
+int main() {
+    performanceTestCallOverhead(1000000);
+    performanceTestScript(1000000);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "object.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "source_file.h"
+#include "vm.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Desvía la salida de MOSTRAR a /dev/null mientras existe
+class SilencedOutput {
+public:
+    SilencedOutput() : saved_(dup(fileno(stdout))) {
+        std::fflush(stdout);
+        if (std::freopen("/dev/null", "w", stdout) == nullptr) saved_ = -1;
+    }
+    ~SilencedOutput() {
+        std::fflush(stdout);
+        if (saved_ >= 0) {
+            dup2(saved_, fileno(stdout));
+            close(saved_);
+        }
+    }
+
+private:
+    int saved_;
+};
+
+struct Measurement {
+    size_t staticInstructions = 0;
+    uint64_t executedInstructions = 0;
+    double milliseconds = 0.0;
+};
+
+// Ejecuta el programa como el modo interpret: el nivel superior y después main(), si existe
+double runProgram(mc_core::VM& vm, const mc_core::FunctionProto* script) {
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    mc_core::Value entry = vm.getGlobal("main");
+    if (mc_core::isObjType(entry, mc_core::ObjType::FUNCTION)) vm.call(entry, {});
+    std::fflush(stdout);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Compila y optimiza una vez; la primera ejecución cuenta instrucciones y calienta las
+// cachés, y el tiempo es la media de las siguientes
+Measurement measure(const std::string& source, int level, int repetitions) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+
+    Measurement measurement;
+    measurement.staticInstructions = mc_core::optimizeProgram(vm, level).instructionsAfter;
+    SilencedOutput silenced;
+    vm.setDispatchMode(mc_core::DispatchMode::COUNTING);
+    runProgram(vm, script);
+    measurement.executedInstructions = vm.instructionCount();
+    vm.setDispatchMode(mc_core::DispatchMode::THREADED);
+    double total = 0.0;
+    for (int i = 0; i < repetitions; ++i) total += runProgram(vm, script);
+    measurement.milliseconds = total / repetitions;
+    return measurement;
+}
+
+void report(const std::string& name, const std::string& source, int repetitions) {
+    std::cout << name << ":" << std::endl;
+    Measurement base;
+    for (int level = 0; level <= mc_core::kMaxOptimizationLevel; ++level) {
+        Measurement m = measure(source, level, repetitions);
+        if (level == 0) base = m;
+        std::cout << "  -O" << level << ": " << m.staticInstructions << " instrucciones, " << m.executedInstructions
+                  << " ejecutadas, " << m.milliseconds << " ms";
+        if (level > 0) std::cout << " (aceleración " << base.milliseconds / m.milliseconds << "x)";
+        std::cout << std::endl;
+    }
+}
+
+// Llamadas a FUNC pequeñas y expresiones constantes dentro de un bucle
+std::string callKernel(int iterations) {
+    return "FUNC cuadrado(x) {\n    RETORNAR x * x\n}\n"
+           "FUNC suma(a, b) {\n    RETORNAR a + b\n}\n"
+           "FUNC calcular(n) {\n"
+           "    VAR total = 0\n"
+           "    PARA i DESDE 0 HASTA n {\n"
+           "        VAR escala = 2 * 8 - 6\n"
+           "        total = suma(total, cuadrado(i % 100) * escala)\n"
+           "    }\n"
+           "    RETORNAR total\n"
+           "}\n"
+           "MOSTRAR(calcular(" + std::to_string(iterations) + "))\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string examples = argc > 1 ? argv[1] : "examples";
+    const std::vector<std::string> programs = {"basic_syntax", "classes_and_objects", "control_structures",
+                                               "data_types", "functions_and_modules", "math_operations"};
+    for (const std::string& name : programs) {
+        std::string source = mc_core::readSourceFile(examples + "/" + name + ".mc");
+        report(name + ".mc", source, 200);
+    }
+    report("llamadas en bucle x1000000", callKernel(1000000), 3);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "output.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+// Conecta stdout a una tubería que otro hilo vacía, como `mc++ interpret x.mc | cat`
+class PipedStdout {
+public:
+    PipedStdout() {
+        int fds[2];
+        if (::pipe(fds) != 0) throw std::runtime_error("pipe");
+        saved_ = ::dup(STDOUT_FILENO);
+        ::dup2(fds[1], STDOUT_FILENO);
+        ::close(fds[1]);
+        reader_ = std::thread([this, fd = fds[0]] {
+            char buffer[64 * 1024];
+            ssize_t n;
+            while ((n = ::read(fd, buffer, sizeof(buffer))) > 0) bytes_ += static_cast<size_t>(n);
+            ::close(fd);
+        });
+    }
+
+    ~PipedStdout() {
+        mc_core::OutputBuffer::flushAll();
+        std::fflush(stdout);
+        ::dup2(saved_, STDOUT_FILENO);  // Cierra el extremo de escritura: el lector termina
+        ::close(saved_);
+        reader_.join();
+    }
+
+private:
+    int saved_;
+    std::thread reader_;
+    size_t bytes_ = 0;
+};
+
+double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void performanceTestOutput(int lines) {
+    mc_core::OutputBuffer::setLineBuffered(false);
+    double flushed;
+    double buffered;
+    double mostrar;
+    uint64_t calls;
+    {
+        // Lo que hace `std::cout << ... << std::endl`: una escritura por línea
+        PipedStdout pipe;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < lines; ++i) {
+            std::fprintf(stdout, "[INFO] evento %d: servicio en línea\n", i);
+            std::fflush(stdout);
+        }
+        flushed = elapsedMs(start);
+    }
+    {
+        PipedStdout pipe;
+        mc_core::OutputBuffer& out = mc_core::OutputBuffer::local();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < lines; ++i) out.write("[INFO] evento " + std::to_string(i) + ": servicio en línea\n");
+        out.flush();
+        buffered = elapsedMs(start);
+    }
+    {
+        mc_core::AstArena arena;
+        mc_core::NodeId program = mc_core::parseSource(
+            "PARA i DESDE 0 HASTA " + std::to_string(lines) + " {\n"
+            "    MOSTRAR(\"[INFO] evento\", i, \": servicio en línea\")\n"
+            "}\n",
+            arena);
+        mc_core::VM vm;
+        mc_core::registerBuiltins(vm);
+        mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+        PipedStdout pipe;
+        uint64_t before = mc_core::OutputBuffer::writeCalls();
+        auto start = std::chrono::high_resolution_clock::now();
+        vm.run(script);
+        mc_core::OutputBuffer::flushAll();
+        mostrar = elapsedMs(start);
+        calls = mc_core::OutputBuffer::writeCalls() - before;
+    }
+    std::cerr << lines << " líneas a una tubería:" << std::endl;
+    std::cerr << "  vaciado por línea: " << flushed << " ms (" << lines << " escrituras)" << std::endl;
+    std::cerr << "  OutputBuffer:      " << buffered << " ms" << std::endl;
+    std::cerr << "  MOSTRAR:           " << mostrar << " ms (" << calls << " escrituras)" << std::endl;
+}
+
+int main() {
+    performanceTestOutput(100000);
+    performanceTestOutput(1000000);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Serie de Leibniz para pi: cálculo puro, sin memoria compartida
+std::string leibnizProgram(int terms) {
+    return "VAR pi = 0.0\n"
+           "PARA PARALELO k DESDE 0 HASTA " + std::to_string(terms) + " REDUCIR SUMA pi {\n"
+           "    VAR signo = 1.0\n"
+           "    SI k % 2 == 1 { signo = -1.0 }\n"
+           "    pi = pi + 4.0 * signo / (2 * k + 1)\n"
+           "}\n";
+}
+
+// Capa densa como en ai_ml_performance_tests: cada fila escribe sólo su salida
+std::string denseLayerProgram(int inputs, int outputs) {
+    return "VAR entrada: ARRAY<FLOAT> = []\n"
+           "VAR pesos: ARRAY<FLOAT> = []\n"
+           "VAR salida: ARRAY<FLOAT> = []\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(inputs) + " {\n"
+           "    entrada.AGREGAR((i % 17) * 0.1)\n"
+           "}\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(inputs * outputs) + " {\n"
+           "    pesos.AGREGAR(((i * 31) % 101) * 0.01 - 0.5)\n"
+           "}\n"
+           "PARA o DESDE 0 HASTA " + std::to_string(outputs) + " {\n"
+           "    salida.AGREGAR(0.0)\n"
+           "}\n"
+           "VAR activas = 0\n"
+           "PARA PARALELO o DESDE 0 HASTA " + std::to_string(outputs) + " REDUCIR SUMA activas {\n"
+           "    VAR acumulado = 0.0\n"
+           "    VAR fila = o * " + std::to_string(inputs) + "\n"
+           "    PARA i DESDE 0 HASTA " + std::to_string(inputs) + " {\n"
+           "        acumulado = acumulado + pesos[fila + i] * entrada[i]\n"
+           "    }\n"
+           "    SI acumulado > 0.0 {\n"
+           "        salida[o] = acumulado\n"
+           "        activas = activas + 1\n"
+           "    }\n"
+           "}\n";
+}
+
+void performanceTestParallel(const std::string& label, const std::string& source, const std::string& result) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    std::cout << label << std::endl;
+    double baseline = 0.0;
+    for (size_t threads : {1, 2, 4, 8, 16}) {
+        mc_core::VM vm;
+        mc_core::registerBuiltins(vm);
+        vm.setThreadCount(threads);
+        mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+        mc_core::optimizeProgram(vm, 2);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        vm.run(script);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double total = std::chrono::duration<double, std::milli>(end - start).count();
+        if (threads == 1) baseline = total;
+        std::cout << "  " << threads << " hilos: " << total << " ms (x" << baseline / total << "), " << result
+                  << " = " << mc_core::valueToString(vm.getGlobal(result)) << std::endl;
+    }
+}
+
+int main() {
+    performanceTestParallel("Serie de Leibniz, 2M términos", leibnizProgram(2000000), "pi");
+    performanceTestParallel("Capa densa 1024x4096", denseLayerProgram(1024, 4096), "activas");
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "ast.h"
+#include "parser.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Genera un script sintético de aproximadamente `lines` líneas con la mezcla de
+// construcciones habitual en los ejemplos (funciones, bucles, condicionales, llamadas).
+std::string generateScript(int lines) {
+    std::string source;
+    source.reserve(static_cast<size_t>(lines) * 32);
+    int written = 0;
+    for (int f = 0; written < lines; ++f) {
+        std::string n = std::to_string(f);
+        source += "FUNC calcular" + n + "(a: INT, b: FLOAT): FLOAT {\n";
+        source += "    VAR total: FLOAT = 0.0\n";
+        source += "    PARA i DESDE 0 HASTA a {\n";
+        source += "        SI i % 2 == 0 {\n";
+        source += "            total = total + b * i\n";
+        source += "        } SINO {\n";
+        source += "            total = total - (b / 2.0)\n";
+        source += "        }\n";
+        source += "    }\n";
+        source += "    MOSTRAR(\"resultado\", total, [1, 2, 3])\n";
+        source += "    RETORNAR total\n";
+        source += "}\n";
+        written += 12;
+    }
+    return source;
+}
+
+void performanceTestParser(int lines, int iterations) {
+    std::string source = generateScript(lines);
+    size_t nodes = 0;
+    size_t memory = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        mc_core::AstArena arena;
+        mc_core::parseSource(source, arena);
+        nodes = arena.nodeCount();
+        memory = arena.memoryUsage();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count() / iterations;
+    double megabytes = static_cast<double>(source.size()) / (1024.0 * 1024.0);
+    std::cout << "Parse de " << lines << " líneas (" << source.size() << " bytes): "
+              << seconds * 1000.0 << " ms, " << megabytes / seconds << " MB/s, "
+              << nodes << " nodos, " << memory / 1024 << " KB de arena" << std::endl;
+}
+
+int main() {
+    performanceTestParser(1000, 50);
+    performanceTestParser(10000, 10);
+    performanceTestParser(100000, 3);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "parser.h"
+#include "profiler.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Bucle numérico con llamadas: lo que más sufre una comprobación por instrucción
+std::string hotProgram(int iterations) {
+    return "FUNC paso(x) {\n"
+           "    RETORNAR (x * 31 + 7) % 1000003\n"
+           "}\n"
+           "VAR x = 1\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+           "    x = paso(x) + i % 3\n"
+           "}\n";
+}
+
+double runProgram(const std::string& source, mc_core::Profiler* profiler) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    if (profiler != nullptr) {
+        vm.setProfiler(profiler);
+        profiler->start();
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    if (profiler != nullptr) profiler->stop();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void performanceTestProfilerOverhead(int iterations) {
+    std::string source = hotProgram(iterations);
+    double plain = runProgram(source, nullptr);
+    mc_core::Profiler profiler;
+    double profiled = runProgram(source, &profiler);
+    std::cout << iterations << " iteraciones: " << plain << " ms sin perfilar, " << profiled << " ms perfilando ("
+              << (profiled / plain - 1) * 100 << "% más, " << profiler.sampleCount() << " muestras)" << std::endl;
+}
+
+int main() {
+    performanceTestProfilerOverhead(1000000);
+    performanceTestProfilerOverhead(5000000);
+    return 0;
+}
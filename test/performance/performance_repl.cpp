@@ -0,0 +1,84 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "repl.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Estado de monitorización que el operador consulta línea a línea
+const std::string kSetup = "CLASE Sensor {\n"
+                           "    VAR nombre: STRING\n"
+                           "    VAR lecturas: ARRAY<FLOAT> = []\n"
+                           "    CONSTRUCTOR(n: STRING) { nombre = n }\n"
+                           "    FUNC media() {\n"
+                           "        VAR s = 0.0\n"
+                           "        PARA i DESDE 0 HASTA LONGITUD(lecturas) { s += lecturas[i] }\n"
+                           "        RETORNAR s / LONGITUD(lecturas)\n"
+                           "    }\n"
+                           "}\n"
+                           "VAR sensores = []\n"
+                           "VAR umbral = 0.0\n"
+                           "VAR altos = 0\n"
+                           "PARA k DESDE 0 HASTA 50 {\n"
+                           "    VAR s = Sensor(\"s\" + k)\n"
+                           "    PARA j DESDE 0 HASTA 100 { AGREGAR(s.lecturas, k * 1.0 + j) }\n"
+                           "    AGREGAR(sensores, s)\n"
+                           "}\n";
+
+const std::vector<std::string> kCommands = {
+    "sensores[3].media()\n",
+    "LONGITUD(sensores)\n",
+    "sensores[10].nombre + \": \" + sensores[10].media()\n",
+    "umbral = 40.0\n",
+    "altos = 0\nPARA i DESDE 0 HASTA LONGITUD(sensores) { SI sensores[i].media() > umbral { altos += 1 } }\naltos\n",
+};
+
+// Sesión persistente: cada orden se compila contra lo ya declarado
+double sessionPerCommand(int rounds) {
+    mc_core::ReplSession session;
+    session.eval(kSetup);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const std::string& command : kCommands) session.eval(command);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / (rounds * kCommands.size());
+}
+
+// Lo que cuesta sin sesión: un VM nuevo que rehace el estado antes de cada orden
+double freshVmPerCommand(int rounds) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const std::string& command : kCommands) {
+            mc_core::AstArena arena;
+            mc_core::NodeId program = mc_core::parseSource(kSetup + command, arena);
+            mc_core::VM vm;
+            mc_core::registerBuiltins(vm);
+            mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+            mc_core::optimizeProgram(vm, mc_core::kDefaultOptimizationLevel);
+            vm.run(script);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / (rounds * kCommands.size());
+}
+
+void performanceTestRepl(int rounds) {
+    double fresh = freshVmPerCommand(rounds);
+    double session = sessionPerCommand(rounds);
+    std::cout << "REPL, " << rounds * kCommands.size() << " órdenes:" << std::endl;
+    std::cout << "  VM nuevo por orden: " << fresh * 1000.0 << " ms/orden" << std::endl;
+    std::cout << "  sesión persistente: " << session * 1000.0 << " ms/orden" << std::endl;
+    std::cout << "  aceleración:        " << fresh / session << "x" << std::endl;
+}
+
+int main() {
+    performanceTestRepl(20);
+    performanceTestRepl(200);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Bucles de monitorización como los de examples/: cada uno muestrea y espera su intervalo
+std::string monitoringLoops(int monitors, int cycles, int intervalMs) {
+    return "VAR muestras = 0\n"
+           "FUNC monitor(id) {\n"
+           "    VAR historial = []\n"
+           "    PARA i DESDE 0 HASTA " + std::to_string(cycles) + " {\n"
+           "        historial.AGREGAR({\"id\": id, \"cpu\": (id * 7 + i) % 100})\n"
+           "        muestras = muestras + 1\n"
+           "        ESPERAR(" + std::to_string(intervalMs) + " + id % 5)\n"
+           "    }\n"
+           "}\n"
+           "PARA id DESDE 0 HASTA " + std::to_string(monitors) + " {\n"
+           "    LANZAR(monitor, id)\n"
+           "}\n";
+}
+
+void performanceTestScheduler(int monitors, int cycles, int intervalMs) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(monitoringLoops(monitors, cycles, intervalMs), arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    vm.runCoroutines();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    double total = std::chrono::duration<double, std::milli>(end - start).count();
+    double waited = static_cast<double>(cycles) * (intervalMs + 2);
+    double blocking = static_cast<double>(monitors) * waited;
+    uint64_t switches = static_cast<uint64_t>(monitors) * static_cast<uint64_t>(cycles);
+    std::cout << monitors << " monitores x " << cycles << " ciclos de ~" << intervalMs << " ms: " << total << " ms"
+              << std::endl;
+    std::cout << "  espera media por monitor: " << waited << " ms (con ESPERAR bloqueante: " << blocking / 1000.0
+              << " s en un hilo)" << std::endl;
+    std::cout << "  " << static_cast<double>(switches) / (total / 1000.0) << " reanudaciones/s, muestras: "
+              << mc_core::valueToString(vm.getGlobal("muestras")) << std::endl;
+}
+
+int main() {
+    performanceTestScheduler(1000, 10, 10);
+    performanceTestScheduler(10000, 10, 10);
+    performanceTestScheduler(50000, 5, 50);
+    return 0;
+}
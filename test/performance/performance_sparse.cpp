@@ -0,0 +1,156 @@
+#include "../../src/libraries/math/gemm.h"
+#include "../../src/libraries/math/lu_factorization.h"
+#include "../../src/libraries/math/matrix.h"
+#include "../../src/libraries/math/sparse_matrix.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+template <typename Fn>
+double seconds(const Fn& fn) {
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Mejor tiempo de varias repeticiones, para no medir la primera reserva de memoria
+template <typename Fn>
+double bestSeconds(int repetitions, const Fn& fn) {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; r++) best = std::min(best, seconds(fn));
+    return best;
+}
+
+// Laplaciano de una malla de side x side (5 puntos): simétrico definido positivo, casi todo ceros
+CsrMatrix gridLaplacian(std::size_t side) {
+    std::vector<SparseEntry> entries;
+    for (std::size_t y = 0; y < side; y++) {
+        for (std::size_t x = 0; x < side; x++) {
+            std::size_t i = y * side + x;
+            entries.push_back({i, i, 4.01f});
+            if (x > 0) entries.push_back({i, i - 1, -1.0f});
+            if (x + 1 < side) entries.push_back({i, i + 1, -1.0f});
+            if (y > 0) entries.push_back({i, i - side, -1.0f});
+            if (y + 1 < side) entries.push_back({i, i + side, -1.0f});
+        }
+    }
+    return CsrMatrix::from_triplets(side * side, side * side, entries);
+}
+
+// Grafo de carga: degree aristas por nodo hacia destinos aleatorios
+CsrMatrix randomGraph(std::size_t nodes, std::size_t degree, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<std::size_t> node(0, nodes - 1);
+    std::vector<SparseEntry> entries;
+    for (std::size_t i = 0; i < nodes; i++) {
+        for (std::size_t e = 0; e < degree; e++) entries.push_back({i, node(generator), 1.0f});
+    }
+    return CsrMatrix::from_triplets(nodes, nodes, entries);
+}
+
+// Bytes que SpMV tiene que leer y escribir como mínimo: la matriz, x e y
+double spmvBytes(const CsrMatrix& a) {
+    return a.nonzeros() * (sizeof(float) + sizeof(std::uint32_t)) + (a.rows() + 1) * sizeof(std::size_t) +
+           (a.cols() + a.rows()) * sizeof(float);
+}
+
+// Producto denso matriz-vector: ocho sumas parciales por fila, limitado por el ancho de banda
+void denseMultiply(const Matrix<float>& a, const std::vector<float>& x, std::vector<float>& y) {
+    for (std::size_t i = 0; i < a.rows(); i++) {
+        const float* row = a.row(i);
+        float partial[8] = {};
+        std::size_t k = 0;
+        for (; k + 8 <= a.cols(); k += 8) {
+            for (std::size_t lane = 0; lane < 8; lane++) partial[lane] += row[k + lane] * x[k + lane];
+        }
+        float sum = 0;
+        for (float value : partial) sum += value;
+        for (; k < a.cols(); k++) sum += row[k] * x[k];
+        y[i] = sum;
+    }
+}
+
+// SpMV frente al producto denso sobre la misma matriz
+void performanceTestSpmv(const char* name, const CsrMatrix& a, bool dense) {
+    std::vector<float> x(a.cols(), 1.0f);
+    double sparse = bestSeconds(5, [&] { SparseLinearAlgebra::multiply(a, x); });
+    double zeros = 100.0 * (1.0 - double(a.nonzeros()) / (double(a.rows()) * a.cols()));
+    std::cout << name << " (" << a.rows() << " filas, " << a.nonzeros() << " elementos, " << zeros
+              << "% ceros): SpMV " << sparse * 1000.0 << " ms, " << spmvBytes(a) / sparse * 1e-9 << " GB/s";
+    if (dense) {
+        Matrix<float> matrix = a.to_dense();
+        std::vector<float> result(a.rows());
+        double denseTime = bestSeconds(3, [&] { denseMultiply(matrix, x, result); });
+        double denseBytes = (double(a.rows()) * a.cols() + a.cols() + a.rows()) * sizeof(float);
+        std::cout << ", denso " << denseTime * 1000.0 << " ms, " << denseBytes / denseTime * 1e-9
+                  << " GB/s, aceleración: " << denseTime / sparse << "x";
+    }
+    std::cout << std::endl;
+}
+
+// SpMM (dispersa por un bloque de columnas densas) frente a Gemm con la matriz densa
+void performanceTestSpmm(const CsrMatrix& a, std::size_t cols) {
+    Matrix<float> b(a.cols(), cols, 1.0f), c(a.rows(), cols);
+    double sparse = bestSeconds(3, [&] { SparseLinearAlgebra::multiply(a, b, c); });
+    Matrix<float> matrix = a.to_dense();
+    double dense = bestSeconds(2, [&] { Gemm::multiply(matrix, b, c); });
+    std::cout << "SpMM " << a.rows() << "x" << a.cols() << " * " << a.cols() << "x" << cols << ": disperso "
+              << sparse * 1000.0 << " ms, denso (GEMM) " << dense * 1000.0 << " ms, aceleración: " << dense / sparse
+              << "x" << std::endl;
+}
+
+// Un sistema con el laplaciano: CG (con y sin Jacobi) frente a factorizar con LU y resolver
+void performanceTestSolve(std::size_t side) {
+    CsrMatrix a = gridLaplacian(side);
+    std::vector<float> b(a.rows());
+    for (std::size_t i = 0; i < b.size(); i++) b[i] = static_cast<float>(i % 7) - 3.0f;
+
+    ConjugateGradientOptions plain;
+    plain.preconditioner = Preconditioner::NONE;
+    ConjugateGradientResult result;
+    double cg = seconds([&] { result = SparseLinearAlgebra::conjugate_gradient(a, b, plain); });
+    std::cout << "Sistema " << a.rows() << "x" << a.rows() << ": CG " << cg * 1000.0 << " ms (" << result.iterations
+              << " iteraciones)";
+    double jacobi = seconds([&] { result = SparseLinearAlgebra::conjugate_gradient(a, b); });
+    std::cout << ", CG + Jacobi " << jacobi * 1000.0 << " ms (" << result.iterations << " iteraciones)";
+    if (a.rows() <= 4096) {
+        Matrix<float> dense = a.to_dense();
+        double lu = seconds([&] { LUFactorization(dense).solve(b); });
+        std::cout << ", LU denso " << lu * 1000.0 << " ms, aceleración: " << lu / jacobi << "x";
+    }
+    std::cout << std::endl;
+}
+
+void performanceTestThreads(const CsrMatrix& a) {
+    std::vector<float> x(a.cols(), 1.0f);
+    std::size_t threads = SparseLinearAlgebra::thread_count();
+    SparseLinearAlgebra::set_thread_count(1);
+    double single = bestSeconds(5, [&] { SparseLinearAlgebra::multiply(a, x); });
+    SparseLinearAlgebra::set_thread_count(0);
+    double all = bestSeconds(5, [&] { SparseLinearAlgebra::multiply(a, x); });
+    std::cout << "  1 hilo: " << spmvBytes(a) / single * 1e-9 << " GB/s, " << threads
+              << " hilo(s) por defecto: " << spmvBytes(a) / all * 1e-9 << " GB/s" << std::endl;
+}
+
+int main() {
+    std::cout << "SpMV frente al producto denso:" << std::endl;
+    performanceTestSpmv("Malla 64x64", gridLaplacian(64), true);
+    performanceTestSpmv("Grafo de carga", randomGraph(8192, 16, 1), true);
+    performanceTestSpmv("Malla 1024x1024", gridLaplacian(1024), false);
+    performanceTestSpmv("Grafo de carga", randomGraph(1 << 20, 16, 2), false);
+
+    std::cout << "SpMM:" << std::endl;
+    performanceTestSpmm(gridLaplacian(64), 32);
+    performanceTestSpmm(randomGraph(4096, 16, 3), 64);
+
+    std::cout << "Gradiente conjugado:" << std::endl;
+    performanceTestSolve(64);
+    performanceTestSolve(512);
+
+    std::cout << "Hilos, grafo de 2^20 nodos:" << std::endl;
+    performanceTestThreads(randomGraph(1 << 20, 16, 4));
+    return 0;
+}
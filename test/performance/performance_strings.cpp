@@ -0,0 +1,63 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Registro construido con `+` repetido, como los bucles de log de examples/
+std::string logProgram(int lines) {
+    return "VAR registro = \"\"\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(lines) + " {\n"
+           "    registro = registro + \"[INFO] evento \" + i + \": servicio en línea\\n\"\n"
+           "}\n"
+           "VAR longitud = LONGITUD(registro)\n";
+}
+
+// Contadores por clave: literales y claves construidas sobre el mismo MAP
+std::string keysProgram(int iterations) {
+    return "VAR contadores = {\"cpu\": 0, \"memoria\": 0, \"disco\": 0, \"red\": 0}\n"
+           "VAR nombres = [\"cpu\", \"memoria\", \"disco\", \"red\"]\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(iterations) + " {\n"
+           "    contadores[\"cpu\"] = contadores[\"cpu\"] + 1\n"
+           "    VAR clave = nombres[i % 4]\n"
+           "    contadores[clave] = contadores[clave] + 1\n"
+           "}\n";
+}
+
+double runProgram(const std::string& source, mc_core::VM& vm) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Con concatenación lineal, duplicar las líneas duplica el tiempo (no lo cuadruplica)
+void performanceTestConcatenation(int lines) {
+    mc_core::VM vm;
+    double total = runProgram(logProgram(lines), vm);
+    std::cout << lines << " líneas de registro: " << total << " ms (" << total * 1e6 / lines << " ns/línea, "
+              << mc_core::valueToString(vm.getGlobal("longitud")) << " caracteres)" << std::endl;
+}
+
+void performanceTestMapKeys(int iterations) {
+    mc_core::VM vm;
+    double total = runProgram(keysProgram(iterations), vm);
+    std::cout << iterations << " actualizaciones de MAP: " << total << " ms, símbolos internados: "
+              << vm.heap().symbolCount() << std::endl;
+}
+
+int main() {
+    performanceTestConcatenation(25000);
+    performanceTestConcatenation(50000);
+    performanceTestConcatenation(100000);
+    performanceTestConcatenation(200000);
+    performanceTestMapKeys(1000000);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "ast.h"
+#include "builtins.h"
+#include "bytecode.h"
+#include "codegen.h"
+#include "optimizer.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Despachador de comandos: SELECCION sobre un código de 0 a cases - 1 en cada iteración.
+// Con guard = true cada CASO es una condición, así que se compila como cadena de comparaciones.
+std::string dispatcherLoop(int cases, int iterations, bool guard) {
+    std::string source = "FUNC despachar(codigo) {\n    SELECCION codigo {\n";
+    for (int c = 0; c < cases; ++c) {
+        std::string n = std::to_string(c);
+        source += guard ? "        CASO codigo == " + n + ":\n" : "        CASO " + n + ":\n";
+        source += "            RETORNAR " + std::to_string(c * 3 + 1) + "\n";
+    }
+    source += "        DEFECTO:\n            RETORNAR 0\n    }\n}\n";
+    source += "VAR total = 0\n"
+              "VAR i = 0\n"
+              "MIENTRAS i < " + std::to_string(iterations) + " {\n"
+              "    total = total + despachar((i * 7) % " + std::to_string(cases + 1) + ")\n"
+              "    i = i + 1\n"
+              "}\n";
+    return source;
+}
+
+// Bucle con contador y condición, donde más se repiten LE + JMPIFNOT y LOADI + ADD
+std::string counterLoop(int iterations) {
+    return "FUNC contar(n) {\n"
+           "    VAR s = 0\n"
+           "    VAR i = 0\n"
+           "    MIENTRAS i <= n {\n"
+           "        SI i % 3 == 0 {\n"
+           "            s = s + i\n"
+           "        }\n"
+           "        i = i + 1\n"
+           "    }\n"
+           "    RETORNAR s\n"
+           "}\n"
+           "VAR total = contar(" + std::to_string(iterations) + ")\n";
+}
+
+struct Run {
+    double seconds;
+    uint64_t instructions;
+};
+
+// Ejecuta el programa a -O1; con fused = false se deshacen las superinstrucciones antes de ejecutar
+Run runProgram(const std::string& source, mc_core::DispatchMode mode, bool fused) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    mc_core::optimizeProgram(vm, 1);
+    if (!fused) {
+        for (const auto& proto : vm.protos()) {
+            for (mc_core::Instr& instr : proto->code) instr = mc_core::unfuse(instr);
+        }
+    }
+    vm.setDispatchMode(mode);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    return {std::chrono::duration<double>(end - start).count(), vm.instructionCount()};
+}
+
+void performanceTestSwitch(int cases, int iterations) {
+    Run chain = runProgram(dispatcherLoop(cases, iterations, true), mc_core::DispatchMode::THREADED, true);
+    Run table = runProgram(dispatcherLoop(cases, iterations, false), mc_core::DispatchMode::THREADED, true);
+    std::cout << "SELECCION de " << cases << " CASO x" << iterations << ":" << std::endl;
+    std::cout << "  cadena de comparaciones: " << chain.seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "  tabla de saltos:         " << table.seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "  aceleración:             " << chain.seconds / table.seconds << "x" << std::endl;
+}
+
+void performanceTestSuperinstructions(int iterations) {
+    std::string source = counterLoop(iterations);
+    Run plain = runProgram(source, mc_core::DispatchMode::COUNTING, false);
+    Run fused = runProgram(source, mc_core::DispatchMode::COUNTING, true);
+    double plainTime = runProgram(source, mc_core::DispatchMode::THREADED, false).seconds;
+    double fusedTime = runProgram(source, mc_core::DispatchMode::THREADED, true).seconds;
+    std::cout << "Superinstrucciones, MIENTRAS x" << iterations << ":" << std::endl;
+    std::cout << "  instrucciones despachadas: " << plain.instructions << " -> " << fused.instructions << std::endl;
+    std::cout << "  sin fusionar: " << plainTime * 1000.0 << " ms" << std::endl;
+    std::cout << "  fusionadas:   " << fusedTime * 1000.0 << " ms" << std::endl;
+    std::cout << "  aceleración:  " << plainTime / fusedTime << "x" << std::endl;
+}
+
+int main() {
+    performanceTestSwitch(4, 1000000);
+    performanceTestSwitch(16, 1000000);
+    performanceTestSwitch(64, 1000000);
+    performanceTestSuperinstructions(1000000);
+    performanceTestSuperinstructions(10000000);
+    return 0;
+}
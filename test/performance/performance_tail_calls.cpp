@@ -0,0 +1,65 @@
+#include "ast.h"
+#include "builtins.h"
+#include "bytecode.h"
+#include "codegen.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Recursión final típica: acumulador en un parámetro
+std::string tailRecursion(int depth, int repetitions) {
+    return "FUNC suma(n, total) {\n"
+           "    SI n == 0 { RETORNAR total }\n"
+           "    RETORNAR suma(n - 1, total + n)\n"
+           "}\n"
+           "VAR r = 0\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(repetitions) + " {\n"
+           "    r = suma(" + std::to_string(depth) + ", 0)\n"
+           "}\n";
+}
+
+// Con tail = false las llamadas finales se ejecutan como CALL + RETURN, apilando un marco por nivel
+double runProgram(const std::string& source, bool tail) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    if (!tail) {
+        for (const auto& proto : vm.protos()) {
+            for (mc_core::Instr& instr : proto->code) {
+                if (mc_core::opOf(instr) == mc_core::OpCode::TAILCALL) instr = mc_core::unfuse(instr);
+            }
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void performanceTestTailCalls(int depth, int repetitions) {
+    std::string source = tailRecursion(depth, repetitions);
+    double frames = runProgram(source, false);
+    double tail = runProgram(source, true);
+    double calls = static_cast<double>(depth) * repetitions;
+    std::cout << "Recursión final de " << depth << " niveles x" << repetitions << ":" << std::endl;
+    std::cout << "  un marco por llamada: " << frames * 1000.0 << " ms, " << frames * 1e9 / calls << " ns/llamada"
+              << std::endl;
+    std::cout << "  llamada final:        " << tail * 1000.0 << " ms, " << tail * 1e9 / calls << " ns/llamada"
+              << std::endl;
+    std::cout << "  aceleración:          " << frames / tail << "x" << std::endl;
+}
+
+int main() {
+    performanceTestTailCalls(100, 10000);
+    performanceTestTailCalls(10000, 100);
+    performanceTestTailCalls(150000, 10);
+    // Sin llamadas finales superaría el límite de marcos: sólo se mide la versión final
+    std::cout << "Recursión final de 1000000 niveles: " << runProgram(tailRecursion(1000000, 1), true) * 1000.0
+              << " ms" << std::endl;
+    return 0;
+}
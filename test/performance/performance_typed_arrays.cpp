@@ -0,0 +1,46 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Mismo programa con y sin tipo de elemento declarado: relleno, un bucle de lectura
+// y escritura hasta LONGITUD y las reducciones integradas. `one` es el incremento,
+// del mismo tipo que los elementos para no medir la aritmética mixta INT/FLOAT.
+std::string numericProgram(const std::string& type, const std::string& one, int size, int passes) {
+    return "VAR datos" + type + " = []\n"
+           "PARA i DESDE 0 HASTA " + std::to_string(size) + " { datos.AGREGAR(i % 1000) }\n"
+           "VAR total = 0\n"
+           "PARA k DESDE 0 HASTA " + std::to_string(passes) + " {\n"
+           "    PARA i DESDE 0 HASTA LONGITUD(datos) { datos[i] = datos[i] + " + one + " }\n"
+           "    total += datos.SUMA() + datos.MAXIMO() - datos.MINIMO()\n"
+           "}\n";
+}
+
+double runProgram(const std::string& source) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void performanceTestTypedArrays(int size, int passes) {
+    std::cout << "ARRAY de " << size << " elementos x" << passes << " pasadas:" << std::endl;
+    std::cout << "  ARRAY:        " << runProgram(numericProgram("", "1", size, passes)) << " ms" << std::endl;
+    std::cout << "  ARRAY<INT>:   " << runProgram(numericProgram(": ARRAY<INT>", "1", size, passes)) << " ms" << std::endl;
+    std::cout << "  ARRAY<FLOAT>: " << runProgram(numericProgram(": ARRAY<FLOAT>", "1.0", size, passes)) << " ms" << std::endl;
+}
+
+int main() {
+    performanceTestTypedArrays(100000, 10);
+    performanceTestTypedArrays(1000000, 20);
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "parser.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Bucle MIENTRAS típico de los scripts de monitorización: aritmética, comparación,
+// condicional y acceso a un ARRAY en cada iteración.
+std::string monitoringLoop(int iterations) {
+    return "VAR muestras = [3, 1, 4, 1, 5, 9, 2, 6]\n"
+           "VAR total = 0\n"
+           "VAR alertas = 0\n"
+           "VAR i = 0\n"
+           "MIENTRAS i < " + std::to_string(iterations) + " {\n"
+           "    VAR carga = muestras[i % 8] * 10\n"
+           "    total = total + carga\n"
+           "    SI carga > 50 {\n"
+           "        alertas = alertas + 1\n"
+           "    }\n"
+           "    i = i + 1\n"
+           "}\n";
+}
+
+double runLoop(const std::string& source, mc_core::DispatchMode mode, uint64_t* instructions) {
+    mc_core::AstArena arena;
+    mc_core::NodeId program = mc_core::parseSource(source, arena);
+    mc_core::VM vm;
+    mc_core::registerBuiltins(vm);
+    mc_core::FunctionProto* script = mc_core::compileProgram(vm, arena, program);
+    vm.setDispatchMode(mode);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    vm.run(script);
+    auto end = std::chrono::high_resolution_clock::now();
+    if (instructions != nullptr) *instructions = vm.instructionCount();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void performanceTestDispatch(int iterations) {
+    std::string source = monitoringLoop(iterations);
+
+    // Primero se cuenta el número de instrucciones ejecutadas para obtener ns/op
+    uint64_t instructions = 0;
+    runLoop(source, mc_core::DispatchMode::COUNTING, &instructions);
+
+    double threaded = runLoop(source, mc_core::DispatchMode::THREADED, nullptr);
+    double naive = runLoop(source, mc_core::DispatchMode::SWITCH, nullptr);
+
+    double ops = static_cast<double>(instructions);
+    std::cout << "MIENTRAS x" << iterations << " (" << instructions << " instrucciones):" << std::endl;
+    std::cout << "  computed goto: " << threaded * 1000.0 << " ms, " << threaded * 1e9 / ops << " ns/op" << std::endl;
+    std::cout << "  switch:        " << naive * 1000.0 << " ms, " << naive * 1e9 / ops << " ns/op" << std::endl;
+    std::cout << "  aceleración:   " << naive / threaded << "x" << std::endl;
+}
+
+int main() {
+    performanceTestDispatch(100000);
+    performanceTestDispatch(1000000);
+    performanceTestDispatch(5000000);
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "parser.h"
+#include "profiler.h"
+#include "vm.h"
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+void runProgram(VM& vm, const std::string& source, size_t threads = 1) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    vm.setThreadCount(threads);
+    vm.run(compileProgram(vm, arena, program));
+}
+
+// Muestras de las pilas colapsadas que terminan en `leaf`
+uint64_t samplesEndingIn(const std::string& folded, const std::string& leaf) {
+    std::istringstream lines(folded);
+    std::string line;
+    uint64_t total = 0;
+    while (std::getline(lines, line)) {
+        size_t space = line.rfind(' ');
+        std::string stack = line.substr(0, space);
+        if (stack.size() >= leaf.size() && stack.compare(stack.size() - leaf.size(), leaf.size(), leaf) == 0 &&
+            (stack.size() == leaf.size() || stack[stack.size() - leaf.size() - 1] == ';')) {
+            total += std::stoull(line.substr(space + 1));
+        }
+    }
+    return total;
+}
+
+// Un bucle caliente en una función y una nativa costosa en otra
+const char* kHotProgram =
+    "FUNC caliente(n) {\n"
+    "    VAR total = 0\n"
+    "    PARA i DESDE 0 HASTA n {\n"
+    "        total = total + i * 3 % 7\n"
+    "    }\n"
+    "    RETORNAR total\n"
+    "}\n"
+    "FUNC busca(datos) {\n"
+    "    VAR veces = 0\n"
+    "    PARA j DESDE 0 HASTA 400 {\n"
+    "        SI (datos.CONTIENE(-1)) {\n"
+    "            veces = veces + 1\n"
+    "        }\n"
+    "    }\n"
+    "    RETORNAR veces\n"
+    "}\n"
+    "VAR datos = []\n"
+    "PARA k DESDE 0 HASTA 100000 {\n"
+    "    datos.AGREGAR(k)\n"
+    "}\n"
+    "VAR resultado = 0\n"
+    "PARA k DESDE 0 HASTA 40 {\n"
+    "    resultado = resultado + caliente(100000)\n"
+    "}\n"
+    "VAR encontrados = busca(datos)\n";
+
+// Pruebas de atribución de muestras
+void test_attribution() {
+    VM plain;
+    runProgram(plain, kHotProgram);
+
+    Profiler profiler(200);
+    VM vm;
+    vm.setProfiler(&profiler);
+    profiler.start();
+    runProgram(vm, kHotProgram);
+    profiler.stop();
+
+    std::ostringstream folded;
+    profiler.writeFolded(folded);
+    std::string text = folded.str();
+    uint64_t samples = profiler.sampleCount();
+    run_test("Perfilador: el modo de despacho pasa a PROFILING", vm.dispatchMode() == DispatchMode::PROFILING);
+    run_test("Perfilador: el resultado no cambia al perfilar",
+             valueToString(vm.getGlobal("resultado")) == valueToString(plain.getGlobal("resultado")));
+    run_test("Perfilador: se toman muestras", samples > 20);
+    run_test("Perfilador: las pilas parten del script y llevan FUNC:línea",
+             text.find("<script>:23;caliente:4 ") != std::string::npos);
+    run_test("Perfilador: la nativa aparece como hoja sobre la línea que la llama",
+             samplesEndingIn(text, "<script>:25;busca:11;CONTIENE") > 0);
+    uint64_t hot = samplesEndingIn(text, "caliente:3") + samplesEndingIn(text, "caliente:4");
+    uint64_t native = samplesEndingIn(text, "CONTIENE");
+    run_test("Perfilador: casi todo el tiempo se atribuye a las líneas calientes",
+             (hot + native) * 10 >= samples * 9);
+
+    std::ostringstream summary;
+    profiler.writeSummary(summary, 3);
+    std::string report = summary.str();
+    size_t rows = 0;
+    for (char c : report) rows += c == '\n';
+    run_test("Perfilador: el resumen muestra las N primeras líneas",
+             report.compare(0, 8, "Perfil: ") == 0 && rows == 5 && report.find("%  ") != std::string::npos);
+
+    vm.setProfiler(nullptr);
+    run_test("Perfilador: sin perfilador el despacho vuelve a THREADED", vm.dispatchMode() == DispatchMode::THREADED);
+}
+
+// Pruebas del temporizador y de los hilos
+void test_timer() {
+    Profiler first(500);
+    first.start();
+    bool rejected = false;
+    try {
+        Profiler second(500);
+        second.start();
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    first.stop();
+    run_test("Perfilador: sólo uno activo a la vez", rejected);
+
+    Profiler idle;
+    idle.start();
+    idle.stop();
+    std::ostringstream summary;
+    idle.writeSummary(summary);
+    run_test("Perfilador: sin muestras el resumen es sólo la cabecera",
+             summary.str().find("Perfil: 0 muestras") == 0 && summary.str().find("función") == std::string::npos);
+
+    Profiler profiler(200);
+    VM vm;
+    vm.setProfiler(&profiler);
+    profiler.start();
+    runProgram(vm,
+               "FUNC trabajo(i) {\n"
+               "    VAR s = 0\n"
+               "    PARA j DESDE 0 HASTA 20000 {\n"
+               "        s = s + (i + j) % 5\n"
+               "    }\n"
+               "    RETORNAR s\n"
+               "}\n"
+               "VAR total = 0\n"
+               "PARA PARALELO i DESDE 0 HASTA 400 REDUCIR SUMA total {\n"
+               "    total = total + trabajo(i)\n"
+               "}\n",
+               4);
+    profiler.stop();
+    std::ostringstream folded;
+    profiler.writeFolded(folded);
+    run_test("Perfilador: los hilos de PARA PARALELO también muestrean",
+             samplesEndingIn(folded.str(), "trabajo:4") > 0 && valueToString(vm.getGlobal("total")) == "16000000");
+}
+
+int main() {
+    test_attribution();
+    test_timer();
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include "repl.h"
+#include "vm.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+const std::filesystem::path kWorkDir = std::filesystem::temp_directory_path() / "mcpp_repl_tests";
+
+// Evalúa la entrada y devuelve lo que mostraría el REPL (el valor o el error)
+std::string evalText(ReplSession& session, const std::string& source) {
+    try {
+        return session.eval(source);
+    } catch (const std::exception& e) {
+        return std::string("error: ") + e.what();
+    }
+}
+
+// Pruebas de las declaraciones que persisten entre entradas
+void test_session_state() {
+    ReplSession session;
+    evalText(session, "VAR x = 40\n");
+    run_test("REPL: las globales persisten entre entradas", evalText(session, "x + 2\n") == "42");
+    run_test("REPL: una asignación o una llamada sin valor no muestran nada",
+             evalText(session, "x = x * 2\n") == "" && evalText(session, "FUNC nada() {\n}\n") == "" &&
+                 evalText(session, "nada()\n") == "");
+
+    evalText(session, "FUNC doble(n) {\n    RETORNAR n * 2\n}\n");
+    evalText(session, "CLASE Animal {\n    VAR nombre: STRING\n    CONSTRUCTOR(n: STRING) { nombre = n }\n"
+                      "    FUNC describir() { RETORNAR nombre + \" dice \" + sonido() }\n"
+                      "    FUNC sonido() { RETORNAR \"...\" }\n}\n");
+    evalText(session, "CLASE Perro : Animal {\n    CONSTRUCTOR(n: STRING) : Animal(n) {}\n"
+                      "    FUNC sonido() { RETORNAR \"guau\" }\n}\n");
+    run_test("REPL: FUNC y CLASE de entradas anteriores, incluida la herencia",
+             evalText(session, "doble(21)\n") == "42" && evalText(session, "Perro(\"Rex\").describir()\n") == "Rex dice guau");
+
+    evalText(session, "MODULO Util {\n    VAR base = 100\n    FUNC mas(n) { RETORNAR base + n }\n}\n");
+    run_test("REPL: MODULO de una entrada anterior", evalText(session, "Util.mas(5)\n") == "105");
+
+    evalText(session, "CONST LIMITE = 3\n");
+    run_test("REPL: las constantes siguen siéndolo en las entradas siguientes",
+             evalText(session, "LIMITE = 4\n").find("constante") != std::string::npos &&
+                 evalText(session, "LIMITE\n") == "3");
+
+    evalText(session, "VAR a: ARRAY<INT> = [1, 2, 3]\n");
+    evalText(session, "a = [4, 5]\n");
+    run_test("REPL: arrays tipados declarados en otra entrada",
+             evalText(session, "VAR s = 0\nPARA i DESDE 0 HASTA LONGITUD(a) {\n    s += a[i]\n}\ns\n") == "9");
+}
+
+// Pruebas de errores: sólo descartan su entrada
+void test_errors() {
+    ReplSession session;
+    std::string failed = evalText(session, "FUNC f() {\n    RETORNAR y\n}\n");
+    run_test("REPL: una entrada que no compila no deja declaraciones a medias",
+             failed.find("no declarado: y") != std::string::npos &&
+                 evalText(session, "FUNC f() {\n    RETORNAR 7\n}\n") == "" && evalText(session, "f()\n") == "7");
+
+    std::string undeclared = evalText(session, "VAR y = z\n");
+    run_test("REPL: una entrada que no compila no deja sus globales registradas",
+             undeclared.find("no declarado: z") != std::string::npos &&
+                 evalText(session, "y\n").find("no declarado: y") != std::string::npos &&
+                 evalText(session, "VAR y = 5\ny\n") == "5");
+
+    std::string typed = evalText(session, "VAR t: ARRAY<INT> = [1]\nCONST k = 2\nCLASE Punto {\n}\nt = w\n");
+    run_test("REPL: ni sus constantes, clases ni arrays tipados",
+             typed.find("no declarado: w") != std::string::npos && evalText(session, "CONST k = 3\nk\n") == "3" &&
+                 evalText(session, "CLASE Punto {\n    VAR x = 1\n}\nPunto().x\n") == "1" &&
+                 evalText(session, "VAR t = \"texto\"\nt\n") == "texto");
+
+    evalText(session, "VAR c = 1\n");
+    std::string division = evalText(session, "c = 2\nVAR z = 1 / 0\n");
+    run_test("REPL: un error de ejecución conserva lo ya ejecutado",
+             division.find("división por cero") != std::string::npos && evalText(session, "c\n") == "2");
+
+    run_test("REPL: un error de sintaxis no afecta a la sesión",
+             evalText(session, "VAR = 3\n").find("Error de sintaxis") != std::string::npos &&
+                 evalText(session, "c + f()\n") == "9");
+}
+
+// Pruebas de los módulos importados
+void test_modules() {
+    std::filesystem::create_directories(kWorkDir);
+    std::ofstream(kWorkDir / "contador.mc", std::ios::binary) << "VAR cargas = 0\n"
+                                                                  "cargas = cargas + 1\n"
+                                                                  "FUNC triple(x) {\n"
+                                                                  "    RETORNAR x * 3\n"
+                                                                  "}\n";
+    ReplSession session(kWorkDir.string());
+    std::string first = evalText(session, "IMPORTAR \"contador\"\ncontador.triple(contador.cargas)\n");
+    std::string again = evalText(session, "IMPORTAR \"contador\"\ncontador.cargas\n");
+    run_test("REPL: un módulo importado se compila e inicializa una sola vez",
+             first == "3" && again == "1" && session.vm().sourceModules().size() == 1);
+
+    std::string broken = evalText(session, "IMPORTAR \"contador\"\nVAR r = contador.no_existe()\n");
+    run_test("REPL: el módulo sigue disponible tras un error en la entrada que lo importa",
+             broken.find("no define 'no_existe'") != std::string::npos &&
+                 evalText(session, "contador.triple(5)\n") == "15");
+    std::filesystem::remove_all(kWorkDir);
+}
+
+// Pruebas de la lectura de entradas
+void test_input() {
+    run_test("REPL: entradas incompletas",
+             !ReplSession::isComplete("FUNC f(x) {\n") && !ReplSession::isComplete("VAR a = [1,\n") &&
+                 ReplSession::isComplete("FUNC f(x) {\n    RETORNAR x\n}\n") &&
+                 ReplSession::isComplete("VAR s = \"{\"\n"));
+
+    std::istringstream in("VAR total = 0\n"
+                          "FUNC sumar(n) {\n"
+                          "    total = total + n\n"
+                          "    RETORNAR total\n"
+                          "}\n"
+                          "sumar(40)\n"
+                          "\n"
+                          "sumar(2)\n"
+                          "sumar(\"x\" - 1)\n"
+                          ":salir\n"
+                          "sumar(1000)\n");
+    std::ostringstream out;
+    ReplSession session;
+    session.run(in, out, false);
+    std::string text = out.str();
+    run_test("REPL: bucle de lectura con entradas de varias líneas, errores y :salir",
+             text.find("40\n42\nError: ") == 0 && text.find("1042") == std::string::npos);
+}
+
+int main() {
+    std::cout << "Iniciando pruebas del REPL de MC++" << std::endl;
+
+    test_session_state();
+    test_errors();
+    test_modules();
+    test_input();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
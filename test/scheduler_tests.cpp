@@ -0,0 +1,236 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "object.h"
+#include "parser.h"
+#include "scheduler.h"
+#include "vm.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Ejecuta el programa como el modo interpret: nivel superior y después las corrutinas
+void runProgram(VM& vm, const std::string& source) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    vm.run(compileProgram(vm, arena, program));
+    vm.runCoroutines();
+}
+
+// Devuelve los elementos del ARRAY global `name` como texto separado por comas
+std::string arrayText(VM& vm, const std::string& name) {
+    Value value = vm.getGlobal(name);
+    if (!isObjType(value, ObjType::ARRAY)) return "?";
+    std::string text;
+    for (Value item : asArray(value)->items) {
+        if (!text.empty()) text += ",";
+        text += valueToString(item);
+    }
+    return text;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Pruebas de la rueda de temporizadores
+void test_timer_wheel() {
+    TimerWheel wheel;
+    std::vector<uint32_t> expired;
+    wheel.schedule(1, 5);
+    wheel.schedule(2, 3);
+    wheel.schedule(3, 5);
+    wheel.advance(4, expired);
+    run_test("Rueda: vence sólo lo programado hasta el tick", expired == std::vector<uint32_t>{2} && wheel.size() == 2);
+    expired.clear();
+    wheel.advance(5, expired);
+    run_test("Rueda: conserva el orden dentro de un tick", expired == (std::vector<uint32_t>{1, 3}) && wheel.empty());
+
+    // Un temporizador de una vuelta posterior comparte ranura sin vencer antes de tiempo
+    expired.clear();
+    wheel.schedule(4, 5 + TimerWheel::kSlots);
+    wheel.schedule(5, 6);
+    wheel.advance(6, expired);
+    run_test("Rueda: vueltas posteriores esperan", expired == std::vector<uint32_t>{5} && wheel.size() == 1);
+    run_test("Rueda: siguiente ranura ocupada", wheel.nextTick() == 5 + TimerWheel::kSlots);
+    expired.clear();
+    wheel.advance(100000, expired);
+    run_test("Rueda: un salto largo vence todo", expired == std::vector<uint32_t>{4} && wheel.empty());
+
+    expired.clear();
+    wheel.schedule(6, 10);
+    wheel.advance(100001, expired);
+    run_test("Rueda: un tick pasado vence en el siguiente avance", expired == std::vector<uint32_t>{6});
+}
+
+// Pruebas de intercalado de corrutinas
+void test_interleaving() {
+    VM vm;
+    runProgram(vm, "VAR traza = []\n"
+                   "FUNC tarea(nombre, pausa) {\n"
+                   "    PARA i DESDE 0 HASTA 3 {\n"
+                   "        AGREGAR(traza, nombre + i)\n"
+                   "        ESPERAR(pausa)\n"
+                   "    }\n"
+                   "}\n"
+                   "LANZAR(tarea, \"a\", 0)\n"
+                   "LANZAR(tarea, \"b\", 0)\n"
+                   "AGREGAR(traza, \"principal\")\n");
+    run_test("Corrutinas: LANZAR no ejecuta hasta que el programa cede",
+             arrayText(vm, "traza").rfind("principal,", 0) == 0);
+    run_test("Corrutinas: ESPERAR(0) alterna por turnos",
+             arrayText(vm, "traza") == "principal,a0,b0,a1,b1,a2,b2");
+    run_test("Corrutinas: terminadas se liberan", vm.coroutineCount() == 0);
+
+    VM timed;
+    runProgram(timed, "VAR traza = []\n"
+                      "FUNC tarea(nombre, pausa) {\n"
+                      "    ESPERAR(pausa)\n"
+                      "    AGREGAR(traza, nombre)\n"
+                      "}\n"
+                      "LANZAR(tarea, \"lenta\", 40)\n"
+                      "LANZAR(tarea, \"rapida\", 10)\n"
+                      "LANZAR(tarea, \"media\", 25)\n");
+    run_test("Corrutinas: despiertan por orden de plazo", arrayText(timed, "traza") == "rapida,media,lenta");
+
+    VM ids;
+    runProgram(ids, "FUNC nada() {\n}\nVAR a = LANZAR(nada)\nVAR b = LANZAR(nada)\n");
+    run_test("Corrutinas: LANZAR devuelve identificadores distintos",
+             ids.getGlobal("a").isInt() && ids.getGlobal("b").isInt() &&
+             ids.getGlobal("a").asInt() != ids.getGlobal("b").asInt());
+}
+
+// Pruebas de ESPERAR fuera de una corrutina y en llamadas anidadas
+void test_waiting_contexts() {
+    VM vm;
+    runProgram(vm, "VAR traza = []\n"
+                   "FUNC tarea() {\n"
+                   "    AGREGAR(traza, \"tarea\")\n"
+                   "}\n"
+                   "LANZAR(tarea)\n"
+                   "ESPERAR(5)\n"
+                   "AGREGAR(traza, \"principal\")\n");
+    run_test("Esperas: el programa principal deja correr a las corrutinas",
+             arrayText(vm, "traza") == "tarea,principal");
+
+    // ESPERAR dentro de una función llamada por una nativa no puede suspender la corrutina
+    VM nested;
+    runProgram(nested, "VAR traza = []\n"
+                       "FUNC paso(x) {\n"
+                       "    ESPERAR(1)\n"
+                       "    RETORNAR x * 2\n"
+                       "}\n"
+                       "FUNC mapea() {\n"
+                       "    traza = [1, 2, 3].MAPEAR(paso)\n"
+                       "}\n"
+                       "FUNC otra() {\n"
+                       "    ESPERAR(0)\n"
+                       "}\n"
+                       "LANZAR(mapea)\n"
+                       "LANZAR(otra)\n");
+    run_test("Esperas: anidada bajo una nativa completa la llamada", arrayText(nested, "traza") == "2,4,6");
+
+    // Una corrutina puede ser directamente una nativa
+    VM native;
+    runProgram(native, "LANZAR(ESPERAR, 1)\nLANZAR(TIPO, 1)\n");
+    run_test("Esperas: corrutina nativa", native.coroutineCount() == 0);
+
+    auto start = std::chrono::steady_clock::now();
+    VM timed;
+    runProgram(timed, "FUNC tarea() {\n    ESPERAR(30)\n}\n"
+                      "PARA i DESDE 0 HASTA 100 {\n    LANZAR(tarea)\n}\n");
+    double ms = elapsedMs(start);
+    run_test("Esperas: 100 esperas de 30 ms transcurren a la vez", ms >= 29.0 && ms < 500.0);
+}
+
+// Pruebas de errores y de recolección con corrutinas suspendidas
+void test_errors_and_gc() {
+    std::string message;
+    try {
+        VM vm;
+        runProgram(vm, "FUNC tarea() {\n"
+                       "    ESPERAR(1)\n"
+                       "    VAR x = 1 + \"a\" * 2\n"
+                       "}\n"
+                       "LANZAR(tarea)\n");
+    } catch (const std::exception& e) {
+        message = e.what();
+    }
+    run_test("Errores: se informa la línea dentro de la corrutina",
+             message.find("línea 3") != std::string::npos && message.find("tarea") != std::string::npos);
+
+    message.clear();
+    try {
+        VM vm;
+        runProgram(vm, "LANZAR(5)\n");
+    } catch (const std::exception& e) {
+        message = e.what();
+    }
+    run_test("Errores: LANZAR exige una función", message.find("LANZAR espera una función") != std::string::npos);
+
+    // Cada corrutina guarda un objeto sólo en sus registros mientras duerme
+    VM vm;
+    runProgram(vm, "VAR total = 0\n"
+                   "FUNC tarea(n) {\n"
+                   "    VAR datos = [n, n + 1, \"x\" + n]\n"
+                   "    PARA i DESDE 0 HASTA 3 {\n"
+                   "        VAR basura = []\n"
+                   "        PARA j DESDE 0 HASTA 200 {\n"
+                   "            AGREGAR(basura, \"b\" + j)\n"
+                   "        }\n"
+                   "        ESPERAR(1)\n"
+                   "    }\n"
+                   "    total = total + datos[0] + datos[1] + LONGITUD(datos[2])\n"
+                   "}\n"
+                   "PARA k DESDE 0 HASTA 300 {\n"
+                   "    LANZAR(tarea, k)\n"
+                   "}\n");
+    Value total = vm.getGlobal("total");
+    // suma de 2k + 1 para k < 300, más la longitud de "x" + k
+    int64_t expected = 300 * 299 + 300 + (10 * 2 + 90 * 3 + 200 * 4);
+    run_test("GC: los registros de las corrutinas suspendidas son raíces",
+             total.isInt() && total.asInt() == expected && vm.heap().stats().minorCollections > 0);
+}
+
+// Muchas corrutinas concurrentes en un solo hilo
+void test_many_coroutines() {
+    auto start = std::chrono::steady_clock::now();
+    VM vm;
+    runProgram(vm, "VAR ciclos = 0\n"
+                   "FUNC monitor(id) {\n"
+                   "    PARA i DESDE 0 HASTA 5 {\n"
+                   "        ciclos = ciclos + 1\n"
+                   "        ESPERAR(10 + id % 7)\n"
+                   "    }\n"
+                   "}\n"
+                   "PARA id DESDE 0 HASTA 20000 {\n"
+                   "    LANZAR(monitor, id)\n"
+                   "}\n");
+    double ms = elapsedMs(start);
+    Value cycles = vm.getGlobal("ciclos");
+    run_test("Escala: 20000 corrutinas completan sus ciclos", cycles.isInt() && cycles.asInt() == 100000);
+    run_test("Escala: el tiempo lo marcan las esperas, no su suma", ms < 5000.0);
+}
+
+int main() {
+    test_timer_wheel();
+    test_interleaving();
+    test_waiting_contexts();
+    test_errors_and_gc();
+    test_many_coroutines();
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
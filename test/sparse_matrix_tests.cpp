@@ -0,0 +1,236 @@
+#include "../src/libraries/math/gemm.h"
+#include "../src/libraries/math/matrix.h"
+#include "../src/libraries/math/sparse_matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+float maxDifference(MatrixView<const float> a, MatrixView<const float> b) {
+    if (a.rows() != b.rows() || a.cols() != b.cols()) return INFINITY;
+    float diff = 0;
+    for (std::size_t i = 0; i < a.rows(); i++) {
+        for (std::size_t j = 0; j < a.cols(); j++) diff = std::max(diff, std::abs(a(i, j) - b(i, j)));
+    }
+    return diff;
+}
+
+float maxDifference(const std::vector<float>& a, const std::vector<float>& b) {
+    if (a.size() != b.size()) return INFINITY;
+    float diff = 0;
+    for (std::size_t i = 0; i < a.size(); i++) diff = std::max(diff, std::abs(a[i] - b[i]));
+    return diff;
+}
+
+// Tripletas aleatorias en desorden y con repeticiones; unas pocas filas llevan la mayoría, como en un grafo
+std::vector<SparseEntry> randomEntries(std::size_t rows, std::size_t cols, std::size_t count, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<std::size_t> row(0, rows - 1), col(0, cols - 1);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::vector<SparseEntry> entries;
+    for (std::size_t e = 0; e < count; e++) {
+        std::size_t i = e % 3 == 0 ? row(generator) % 4 : row(generator);
+        entries.push_back({i, col(generator), value(generator)});
+    }
+    return entries;
+}
+
+// Laplaciano de una malla de side x side (5 puntos) más shift en la diagonal: simétrica definida positiva
+CsrMatrix gridLaplacian(std::size_t side, float shift) {
+    std::vector<SparseEntry> entries;
+    for (std::size_t y = 0; y < side; y++) {
+        for (std::size_t x = 0; x < side; x++) {
+            std::size_t i = y * side + x;
+            entries.push_back({i, i, 4.0f + shift});
+            if (x > 0) entries.push_back({i, i - 1, -1.0f});
+            if (x + 1 < side) entries.push_back({i, i + 1, -1.0f});
+            if (y > 0) entries.push_back({i, i - side, -1.0f});
+            if (y + 1 < side) entries.push_back({i, i + side, -1.0f});
+        }
+    }
+    return CsrMatrix::from_triplets(side * side, side * side, entries);
+}
+
+float relativeResidual(const CsrMatrix& a, const std::vector<float>& x, const std::vector<float>& b) {
+    std::vector<float> ax = SparseLinearAlgebra::multiply(a, x);
+    double r = 0, norm = 0;
+    for (std::size_t i = 0; i < b.size(); i++) {
+        r += double(b[i] - ax[i]) * (b[i] - ax[i]);
+        norm += double(b[i]) * b[i];
+    }
+    return static_cast<float>(std::sqrt(r / norm));
+}
+
+// Construcción desde tripletas COO y conversiones
+void test_builders() {
+    std::vector<SparseEntry> entries = {{2, 1, 5.0f}, {0, 3, 1.0f}, {0, 0, 2.0f}, {2, 1, -1.0f}, {1, 2, 3.0f},
+                                        {0, 3, 0.5f}};
+    CsrMatrix csr = CsrMatrix::from_triplets(3, 4, entries);
+    Matrix<float> expected({{2, 0, 0, 1.5f}, {0, 0, 3, 0}, {0, 4, 0, 0}});
+    run_test("CSR desde tripletas desordenadas, sumando repetidas",
+             csr.nonzeros() == 4 && csr.to_dense() == expected &&
+                 csr.offsets() == std::vector<std::size_t>({0, 2, 3, 4}) &&
+                 csr.indices() == std::vector<std::uint32_t>({0, 3, 2, 1}));
+    run_test("CSR: acceso por elemento", csr.at(0, 3) == 1.5f && csr.at(2, 1) == 4.0f && csr.at(1, 1) == 0.0f);
+
+    CscMatrix csc = CscMatrix::from_triplets(3, 4, entries);
+    run_test("CSC desde tripletas", csc.nonzeros() == 4 && csc.to_dense() == expected &&
+                                        csc.offsets() == std::vector<std::size_t>({0, 1, 2, 3, 4}) &&
+                                        csc.at(1, 2) == 3.0f);
+
+    CsrMatrix random = CsrMatrix::from_triplets(50, 70, randomEntries(50, 70, 600, 1));
+    CscMatrix randomCsc = CscMatrix::from_triplets(50, 70, randomEntries(50, 70, 600, 1));
+    CscMatrix converted = random.to_csc();
+    run_test("Conversión CSR <-> CSC", converted.offsets() == randomCsc.offsets() &&
+                                           converted.indices() == randomCsc.indices() &&
+                                           maxDifference(converted.to_dense(), random.to_dense()) < 1e-6f &&
+                                           converted.to_csr().to_dense() == random.to_dense());
+    run_test("CSR desde una matriz densa",
+             CsrMatrix::from_dense(expected).to_dense() == expected && CsrMatrix::from_dense(expected).nonzeros() == 4);
+
+    CsrMatrix empty = CsrMatrix::from_triplets(5, 5, {});
+    run_test("Matriz dispersa vacía", empty.nonzeros() == 0 && empty.offsets().size() == 6 &&
+                                          SparseLinearAlgebra::multiply(empty, std::vector<float>(5, 1.0f)) ==
+                                              std::vector<float>(5, 0.0f));
+
+    bool outOfRange = false;
+    try {
+        CsrMatrix::from_triplets(3, 3, {{3, 0, 1.0f}});
+    } catch (const std::invalid_argument&) {
+        outOfRange = true;
+    }
+    run_test("Tripleta fuera de la matriz lanza invalid_argument", outOfRange);
+}
+
+// SpMV y SpMM frente al producto denso
+void test_products() {
+    CsrMatrix a = CsrMatrix::from_triplets(300, 200, randomEntries(300, 200, 4000, 2));
+    Matrix<float> dense = a.to_dense();
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> x(200);
+    for (float& value : x) value = distribution(generator);
+    Matrix<float> column(200, 1);
+    for (std::size_t i = 0; i < 200; i++) column(i, 0) = x[i];
+    Matrix<float> expected(300, 1);
+    Gemm::multiply(dense, column, expected);
+    std::vector<float> expectedVector(expected.data(), expected.data() + 300);
+
+    run_test("SpMV con CSR", maxDifference(SparseLinearAlgebra::multiply(a, x), expectedVector) < 1e-4f);
+    run_test("SpMV con CSC", maxDifference(SparseLinearAlgebra::multiply(a.to_csc(), x), expectedVector) < 1e-4f);
+
+    // Con varios hilos las filas se reparten por número de elementos; las filas 0-3 llevan un tercio
+    std::size_t threads = SparseLinearAlgebra::thread_count();
+    SparseLinearAlgebra::set_thread_count(4);
+    run_test("Gemm y SpMV comparten el grupo de hilos", Gemm::thread_count() == 4);
+    CsrMatrix large = CsrMatrix::from_triplets(4000, 3000, randomEntries(4000, 3000, 60000, 4));
+    std::vector<float> ones(3000, 1.0f);
+    std::vector<float> parallel = SparseLinearAlgebra::multiply(large, ones);
+    SparseLinearAlgebra::set_thread_count(1);
+    std::vector<float> serial = SparseLinearAlgebra::multiply(large, ones);
+    run_test("SpMV en paralelo igual que en un hilo", parallel == serial);
+
+    Matrix<float> b(200, 24);
+    for (std::size_t i = 0; i < 200; i++) {
+        for (std::size_t j = 0; j < 24; j++) b(i, j) = distribution(generator);
+    }
+    Matrix<float> expectedProduct(300, 24), product(300, 24);
+    Gemm::multiply(dense, b, expectedProduct);
+    SparseLinearAlgebra::set_thread_count(4);
+    SparseLinearAlgebra::multiply(a, b, product);
+    run_test("SpMM: dispersa por densa", maxDifference(product, expectedProduct) < 1e-4f);
+
+    Matrix<float> bt(Matrix<float>(b.transposed()));
+    Matrix<float> strided(300, 24);
+    SparseLinearAlgebra::multiply(a, bt.transposed(), strided);
+    SparseLinearAlgebra::set_thread_count(threads);
+    run_test("SpMM con la densa transpuesta (sin filas contiguas)", maxDifference(strided, expectedProduct) < 1e-4f);
+
+    bool mismatch = false;
+    try {
+        SparseLinearAlgebra::multiply(a, std::vector<float>(199));
+    } catch (const std::invalid_argument&) {
+        mismatch = true;
+    }
+    run_test("SpMV con dimensiones incompatibles lanza invalid_argument", mismatch);
+}
+
+// Gradiente conjugado precondicionado
+void test_conjugate_gradient() {
+    CsrMatrix laplacian = gridLaplacian(30, 0.01f);
+    std::vector<float> b(laplacian.rows());
+    for (std::size_t i = 0; i < b.size(); i++) b[i] = static_cast<float>(i % 7) - 3.0f;
+
+    ConjugateGradientOptions options;
+    options.preconditioner = Preconditioner::NONE;
+    ConjugateGradientResult plain = SparseLinearAlgebra::conjugate_gradient(laplacian, b, options);
+    run_test("CG sin precondicionar converge", plain.converged && relativeResidual(laplacian, plain.x, b) < 1e-4f);
+
+    // Filas con escalas muy distintas: Jacobi las iguala y reduce las iteraciones
+    std::vector<SparseEntry> entries;
+    std::vector<float> scale(laplacian.rows());
+    for (std::size_t i = 0; i < scale.size(); i++) scale[i] = i % 2 == 0 ? 1.0f : 100.0f;
+    for (std::size_t i = 0; i < laplacian.rows(); i++) {
+        for (std::size_t e = laplacian.offsets()[i]; e < laplacian.offsets()[i + 1]; e++) {
+            std::size_t j = laplacian.indices()[e];
+            entries.push_back({i, j, laplacian.values()[e] * std::sqrt(scale[i] * scale[j])});
+        }
+    }
+    CsrMatrix scaled = CsrMatrix::from_triplets(laplacian.rows(), laplacian.cols(), entries);
+    ConjugateGradientResult unpreconditioned = SparseLinearAlgebra::conjugate_gradient(scaled, b, options);
+    ConjugateGradientResult jacobi = SparseLinearAlgebra::conjugate_gradient(scaled, b);
+    run_test("CG con Jacobi converge en menos iteraciones",
+             jacobi.converged && relativeResidual(scaled, jacobi.x, b) < 1e-4f &&
+                 jacobi.iterations < unpreconditioned.iterations);
+
+    ConjugateGradientResult warm = SparseLinearAlgebra::conjugate_gradient(scaled, b, jacobi.x);
+    run_test("CG partiendo de la solución no itera", warm.converged && warm.iterations <= 1);
+
+    ConjugateGradientOptions limited;
+    limited.max_iterations = 3;
+    ConjugateGradientResult stopped = SparseLinearAlgebra::conjugate_gradient(laplacian, b, limited);
+    run_test("CG sin converger devuelve converged = false", !stopped.converged && stopped.iterations == 3);
+
+    ConjugateGradientResult zero = SparseLinearAlgebra::conjugate_gradient(laplacian, std::vector<float>(b.size()));
+    run_test("CG con b = 0", zero.converged && zero.iterations == 0 &&
+                                 zero.x == std::vector<float>(b.size(), 0.0f));
+
+    bool indefinite = false;
+    try {
+        CsrMatrix negative = CsrMatrix::from_triplets(2, 2, {{0, 0, 1.0f}, {1, 1, -1.0f}});
+        SparseLinearAlgebra::conjugate_gradient(negative, {1.0f, 1.0f}, options);
+    } catch (const std::runtime_error&) {
+        indefinite = true;
+    }
+    bool badDiagonal = false;
+    try {
+        CsrMatrix missing = CsrMatrix::from_triplets(2, 2, {{0, 0, 1.0f}, {0, 1, 1.0f}});
+        SparseLinearAlgebra::conjugate_gradient(missing, {1.0f, 1.0f});
+    } catch (const std::invalid_argument&) {
+        badDiagonal = true;
+    }
+    run_test("CG rechaza matrices que no son definidas positivas", indefinite && badDiagonal);
+}
+
+int main() {
+    std::cout << "Iniciando pruebas de matrices dispersas de MC++" << std::endl;
+
+    test_builders();
+    test_products();
+    test_conjugate_gradient();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "heap.h"
+#include "object.h"
+#include "parser.h"
+#include "vm.h"
+#include <iostream>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+void runSource(VM& vm, const std::string& source, size_t threads = 1) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    vm.setThreadCount(threads);
+    vm.run(compileProgram(vm, arena, program));
+}
+
+bool hasText(Value v, const std::string& expected) {
+    return isString(v) && asString(v)->view() == expected;
+}
+
+// Pruebas de la representación de ObjString
+void test_representation() {
+    Heap heap;
+    ObjString* small = heap.newString("veintidós bytes: 1234");
+    ObjString* large = heap.newString("una cadena que ya no cabe dentro del objeto");
+    run_test("Cadena: el texto corto se guarda en el objeto",
+             small->shape() == ObjString::Shape::INLINE && small->view() == "veintidós bytes: 1234");
+    run_test("Cadena: el texto largo usa un búfer propio",
+             large->shape() == ObjString::Shape::BUFFER && large->view().size() == 43);
+    run_test("Cadena: ocupa lo mismo que antes", sizeof(ObjString) == 48);
+
+    std::string expected;
+    ObjString* rope = heap.newString("");
+    for (int i = 0; i < 200; ++i) {
+        std::string piece = "trozo " + std::to_string(i) + " de una cadena larga que supera el límite de copia;";
+        expected += piece;
+        rope = heap.concat(rope, heap.newString(piece));
+    }
+    run_test("Cuerda: la concatenación larga no copia", rope->isRope() && rope->length() == expected.size());
+    run_test("Cuerda: se aplana al leerla",
+             rope->view() == expected && rope->shape() == ObjString::Shape::FLATTENED);
+    ObjString* flat = heap.newString(expected);
+    run_test("Cuerda: igual a la cadena plana con el mismo texto",
+             stringsEqual(rope, flat) && rope->hash() == flat->hash());
+
+    ObjString* prefix = heap.newString("");
+    std::string reversed;
+    for (int i = 0; i < 100; ++i) {
+        std::string piece = std::string(300, static_cast<char>('a' + i % 26));
+        reversed = piece + reversed;
+        prefix = heap.concat(heap.newString(piece), prefix);
+    }
+    run_test("Cuerda: concatenación por la izquierda", prefix->view() == reversed);
+}
+
+// Pruebas de la tabla de símbolos
+void test_interning() {
+    Heap heap;
+    ObjString* a = heap.intern("nombre");
+    ObjString* b = heap.intern(std::string("nom") + "bre");
+    run_test("Símbolos: el mismo texto da la misma cadena", a == b && a->interned);
+
+    ObjString* built = heap.newString("otro nombre");
+    run_test("Símbolos: una cadena existente se registra en su sitio",
+             heap.intern(built) == built && heap.intern("otro nombre") == built);
+    ObjString* copy = heap.newString("nombre");
+    run_test("Símbolos: una copia devuelve la ya internada", heap.intern(copy) == a && !copy->interned);
+    run_test("Símbolos: distintas internadas nunca son iguales", !stringsEqual(a, built));
+
+    Heap worker;
+    worker.shareSymbols(&heap);
+    ObjString* shared = worker.intern("nombre");
+    ObjString* fresh = worker.intern("sólo en el hilo");
+    run_test("Símbolos: un heap auxiliar lee los símbolos del principal sin internar",
+             shared == a && !fresh->interned && heap.intern("sólo en el hilo") != fresh && worker.symbolCount() == 0);
+
+    VM vm;
+    runSource(vm, "PARA i DESDE 0 HASTA 5000 {\n"
+                  "    VAR temporal = {}\n"
+                  "    temporal[\"clave\" + i] = i\n"
+                  "}\n"
+                  "VAR mapa = {\"x\": 1}\n"
+                  "mapa[\"cla\" + \"ve\"] = 2\n"
+                  "VAR r = mapa[\"clave\"] + mapa[\"x\"]\n");
+    run_test("Símbolos: claves de MAP construidas y literales", vm.getGlobal("r").asInt() == 3);
+    size_t before = vm.heap().symbolCount();
+    vm.collectGarbage(true);
+    run_test("Símbolos: la tabla no retiene las claves muertas", vm.heap().symbolCount() + 4000 < before);
+    Value key = asMap(vm.getGlobal("mapa"))->entries[1].first;
+    run_test("Símbolos: la clave viva sigue internada",
+             asString(key)->interned && vm.heap().intern("clave") == asString(key));
+}
+
+// Pruebas de concatenación desde programas MC++
+void test_programs() {
+    VM vm;
+    vm.heap().setNurserySize(64 * 1024);
+    runSource(vm, "VAR registro = \"\"\n"
+                  "PARA i DESDE 0 HASTA 20000 {\n"
+                  "    registro = registro + \"línea \" + i + \"\\n\"\n"
+                  "}\n"
+                  "VAR longitud = LONGITUD(registro)\n"
+                  "VAR primera = registro[0]\n"
+                  "VAR igual = registro == registro + \"\"\n");
+    std::string expected;
+    for (int i = 0; i < 20000; ++i) expected += "línea " + std::to_string(i) + "\n";
+    Value registro = vm.getGlobal("registro");
+    run_test("Programa: registro construido con + y recolecciones", hasText(registro, expected));
+    run_test("Programa: LONGITUD, índice e igualdad sobre una cuerda",
+             vm.getGlobal("longitud").asInt() == 20000 * 7 + 88890 && hasText(vm.getGlobal("primera"), "l") &&
+                 vm.getGlobal("igual").asBool());
+    run_test("Programa: hubo recolecciones con cuerdas vivas", vm.heap().stats().minorCollections > 0);
+
+    // Varios hilos leen y aplanan la misma cuerda a la vez
+    VM parallel;
+    runSource(parallel, "VAR texto = \"\"\n"
+                        "PARA i DESDE 0 HASTA 3000 {\n"
+                        "    texto = texto + \"abcdefghij\"\n"
+                        "}\n"
+                        "VAR total = 0\n"
+                        "PARA PARALELO i DESDE 0 HASTA 64 REDUCIR SUMA total {\n"
+                        "    total = total + LONGITUD(texto + i)\n"
+                        "}\n",
+              4);
+    run_test("Programa: cuerda compartida por PARA PARALELO", parallel.getGlobal("total").asInt() == 64 * 30000 + 118);
+}
+
+int main() {
+    test_representation();
+    test_interning();
+    test_programs();
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}
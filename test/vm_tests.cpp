@@ -0,0 +1,574 @@
+#include "ast.h"
+#include "builtins.h"
+#include "codegen.h"
+#include "object.h"
+#include "parser.h"
+#include "typed_array.h"
+#include "vm.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <string>
+
+using namespace mc_core;
+
+// Función auxiliar para ejecutar pruebas unitarias
+void run_test(const std::string& test_name, bool result) {
+    if (result) {
+        std::cout << "[PASSED] " << test_name << std::endl;
+    } else {
+        std::cerr << "[FAILED] " << test_name << std::endl;
+    }
+}
+
+// Compila y ejecuta un programa en el VM indicado
+void runSource(VM& vm, const std::string& source) {
+    AstArena arena;
+    NodeId program = parseSource(source, arena);
+    registerBuiltins(vm);
+    vm.run(compileProgram(vm, arena, program));
+}
+
+// Ejecuta el programa y devuelve el valor final de la global `name`
+Value evalGlobal(VM& vm, const std::string& source, const std::string& name) {
+    runSource(vm, source);
+    return vm.getGlobal(name);
+}
+
+bool isIntValue(Value v, int64_t expected) {
+    return v.isInt() && v.asInt() == expected;
+}
+
+bool isStringValue(Value v, const std::string& expected) {
+    return isString(v) && asString(v)->view() == expected;
+}
+
+// Devuelve el mensaje de error producido al compilar o ejecutar, o "" si no hay error
+std::string errorOf(const std::string& source) {
+    VM vm;
+    try {
+        runSource(vm, source);
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+    return "";
+}
+
+// Pruebas de la representación de valores en 8 bytes
+void test_value_representation() {
+    run_test("Valor: ocupa 8 bytes", sizeof(Value) == 8);
+    run_test("Valor: NULO y BOOL",
+             Value::nil().isNil() && !Value::nil().isTruthy() && Value::boolean(true).asBool() &&
+             !Value::boolean(false).isTruthy() && Value::boolean(false).isBool() && !Value::integer(0).isBool());
+    run_test("Valor: extremos del INT inmediato",
+             isIntValue(Value::integer(Value::kIntMax), Value::kIntMax) &&
+             isIntValue(Value::integer(Value::kIntMin), Value::kIntMin) && isIntValue(Value::integer(-1), -1));
+    Value wide = Value::integer(Value::kIntMax + 1);
+    run_test("Valor: INT fuera de rango pasa a FLOAT",
+             wide.isFloat() && wide.asFloat() == static_cast<double>(Value::kIntMax + 1));
+    Value nan = Value::number(std::numeric_limits<double>::quiet_NaN());
+    Value negativeNan = Value::number(-std::numeric_limits<double>::quiet_NaN());
+    run_test("Valor: NaN sigue siendo FLOAT",
+             nan.isFloat() && negativeNan.isFloat() && !negativeNan.isInt() && std::isnan(negativeNan.asFloat()));
+    Value negativeZero = Value::number(-0.0);
+    run_test("Valor: -0.0 conserva el signo",
+             negativeZero.isFloat() && std::signbit(negativeZero.asFloat()) && valuesEqual(negativeZero, Value::integer(0)));
+    run_test("Valor: infinitos",
+             Value::number(-INFINITY).isFloat() && Value::number(INFINITY).asFloat() == INFINITY);
+    run_test("Valor: un solo formato para todos los FLOAT finitos",
+             valueToString(Value::number(10.0)) == "10.0" && valueToString(Value::number(0.1)) == "0.1" &&
+                 valueToString(Value::number(-0.0)) == "-0.0" && valueToString(Value::number(0.0001)) == "0.0001" &&
+                 valueToString(Value::number(0.00001)) == "1e-05" &&
+                 valueToString(Value::number(1e16)) == "10000000000000000.0" &&
+                 valueToString(Value::number(123456789012.5)) == "123456789012.5" &&
+                 valueToString(Value::number(4.99995e17)) == "4.99995e+17" &&
+                 valueToString(Value::number(1152921504606846976.0)) == "1.152921504606847e+18");
+    VM vm;
+    Value text = vm.newString("hola");
+    run_test("Valor: puntero a objeto", text.isObj() && isStringValue(Value::object(text.asObj()), "hola"));
+    VM vm2;
+    run_test("VM: aritmética cerca del límite del INT inmediato",
+             evalGlobal(vm2, "VAR r = 1125899906842623 + 1\n", "r").isFloat());
+}
+
+// Pruebas de aritmética y tipos
+void test_arithmetic() {
+    VM vm1;
+    run_test("VM: precedencia entera", isIntValue(evalGlobal(vm1, "VAR r = 2 + 3 * 4 - 6 / 2\n", "r"), 11));
+    VM vm2;
+    run_test("VM: división entera trunca", isIntValue(evalGlobal(vm2, "VAR r = -7 / 2\n", "r"), -3));
+    VM vm3;
+    Value mixed = evalGlobal(vm3, "VAR r = 1 + 0.5\n", "r");
+    run_test("VM: INT + FLOAT es FLOAT", mixed.isFloat() && mixed.asFloat() == 1.5);
+    VM vm4;
+    Value overflow = evalGlobal(vm4, "VAR r = 9223372036854775807 + 1\n", "r");
+    run_test("VM: desbordamiento entero pasa a FLOAT", overflow.isFloat());
+    VM vm5;
+    run_test("VM: concatenación de cadenas",
+             isStringValue(evalGlobal(vm5, "VAR r = \"n=\" + 3 + \" \" + 1.5\n", "r"), "n=3 1.5"));
+    VM vm6;
+    run_test("VM: comparación entre INT y FLOAT",
+             evalGlobal(vm6, "VAR r = 2 < 2.5 Y 3 >= 3.0 Y 1 == 1.0\n", "r").isTruthy());
+    VM vm7;
+    run_test("VM: operadores compuestos",
+             isIntValue(evalGlobal(vm7, "VAR r = 10\nr += 5\nr *= 2\nr -= 1\n", "r"), 29));
+}
+
+// Pruebas de estructuras de control
+void test_control_flow() {
+    VM vm1;
+    run_test("VM: SI / SINO SI / SINO",
+             isStringValue(evalGlobal(vm1,
+                                      "VAR x = 7\nVAR r = \"\"\n"
+                                      "SI x > 10 { r = \"grande\" } SINO SI x > 5 { r = \"medio\" } SINO { r = \"chico\" }\n",
+                                      "r"),
+                           "medio"));
+    VM vm2;
+    run_test("VM: PARA excluye el límite",
+             isIntValue(evalGlobal(vm2, "VAR s = 0\nPARA i DESDE 0 HASTA 5 { s += i }\n", "s"), 10));
+    VM vm3;
+    run_test("VM: PARA con INCREMENTO negativo",
+             isIntValue(evalGlobal(vm3, "VAR s = 0\nPARA i DESDE 10 HASTA 0 INCREMENTO -3 { s += i }\n", "s"), 22));
+    VM vm4;
+    run_test("VM: MIENTRAS con ROMPER y CONTINUAR",
+             isIntValue(evalGlobal(vm4,
+                                   "VAR s = 0\nVAR i = 0\n"
+                                   "MIENTRAS VERDADERO {\n"
+                                   "    i += 1\n"
+                                   "    SI i > 10 { ROMPER }\n"
+                                   "    SI i % 2 == 0 { CONTINUAR }\n"
+                                   "    s += i\n"
+                                   "}\n",
+                                   "s"),
+                        25));
+    VM vm5;
+    run_test("VM: PARA CADA sobre ARRAY",
+             isIntValue(evalGlobal(vm5, "VAR s = 0\nPARA CADA x EN [1, 2, 3, 4] { s += x }\n", "s"), 10));
+    VM vm6;
+    run_test("VM: PARA CADA sobre MAP recorre claves en orden",
+             isStringValue(evalGlobal(vm6, "VAR r = \"\"\nPARA k EN {\"a\": 1, \"b\": 2} { r = r + k }\n", "r"), "ab"));
+    VM vm7;
+    run_test("VM: SELECCION con guardas y DEFECTO",
+             isStringValue(evalGlobal(vm7,
+                                      "VAR edad = 40\nVAR r = \"\"\n"
+                                      "SELECCION edad {\n"
+                                      "    CASO 0: r = \"cero\"\n"
+                                      "    CASO edad < 18: r = \"menor\"\n"
+                                      "    DEFECTO: r = \"adulto\"\n"
+                                      "}\n",
+                                      "r"),
+                           "adulto"));
+    // Con cuatro o más CASO literales la SELECCION se compila como tabla de saltos (SWITCH)
+    VM vm9;
+    run_test("VM: SELECCION con tabla densa de INT",
+             valueToString(evalGlobal(vm9,
+                                      "FUNC nombre(x) {\n    VAR r = \"\"\n    SELECCION x {\n"
+                                      "        CASO 1: r = \"uno\"\n        CASO 2: r = \"dos\"\n"
+                                      "        DEFECTO: r = \"otro\"\n        CASO 3: r = \"tres\"\n"
+                                      "        CASO 2: r = \"repetido\"\n        CASO -4: r = \"menos cuatro\"\n"
+                                      "    }\n    RETORNAR r\n}\n"
+                                      "VAR r = [nombre(1), nombre(2), nombre(3), nombre(-4), nombre(5), nombre(3.0),\n"
+                                      "         nombre(2.5), nombre(\"1\"), nombre(NULO)]\n",
+                                      "r")) ==
+                 "[\"uno\", \"dos\", \"tres\", \"menos cuatro\", \"otro\", \"tres\", \"otro\", \"otro\", \"otro\"]");
+    VM vm10;
+    run_test("VM: SELECCION con hash perfecto de INT y STRING",
+             valueToString(evalGlobal(vm10,
+                                      "FUNC codigo(x) {\n    SELECCION x {\n"
+                                      "        CASO 100: RETORNAR 1\n        CASO 2000: RETORNAR 2\n"
+                                      "        CASO \"rojo\": RETORNAR 3\n        CASO 123456: RETORNAR 4\n"
+                                      "        CASO \"azul\": RETORNAR 5\n    }\n    RETORNAR 0\n}\n"
+                                      "VAR r = [codigo(100), codigo(2000), codigo(\"ro\" + \"jo\"), codigo(123456.0),\n"
+                                      "         codigo(\"azul\"), codigo(7), codigo(\"verde\")]\n",
+                                      "r")) == "[1, 2, 3, 4, 5, 0, 0]");
+    VM vm11;
+    run_test("VM: SELECCION con tabla dentro de un bucle con ROMPER y CONTINUAR",
+             isIntValue(evalGlobal(vm11,
+                                   "VAR s = 0\n"
+                                   "PARA i DESDE 0 HASTA 100 {\n"
+                                   "    SELECCION i % 5 {\n"
+                                   "        CASO 0: CONTINUAR\n"
+                                   "        CASO 1: s += 1\n"
+                                   "        CASO 2: s += 10\n"
+                                   "        CASO 3: SI i > 50 { ROMPER }\n"
+                                   "    }\n"
+                                   "    s += 100\n"
+                                   "}\n",
+                                   "s"),
+                        4321));
+    VM vm8;
+    run_test("VM: Y no evalúa el segundo operando",
+             isIntValue(evalGlobal(vm8,
+                                   "VAR n = 0\nFUNC tocar() { n += 1\n RETORNAR VERDADERO }\n"
+                                   "VAR r = FALSO Y tocar()\nVAR q = VERDADERO O tocar()\n",
+                                   "n"),
+                        0));
+}
+
+// Pruebas de funciones, clases y módulos
+void test_functions_and_classes() {
+    VM vm1;
+    run_test("VM: recursión",
+             isIntValue(evalGlobal(vm1,
+                                   "FUNC fib(n) { SI n < 2 { RETORNAR n }\n RETORNAR fib(n - 1) + fib(n - 2) }\n"
+                                   "VAR r = fib(20)\n",
+                                   "r"),
+                        6765));
+    VM vm2;
+    run_test("VM: llamada antes de la declaración",
+             isIntValue(evalGlobal(vm2, "VAR r = doble(21)\nFUNC doble(x) { RETORNAR x * 2 }\n", "r"), 42));
+    VM vm3;
+    run_test("VM: clase con herencia y métodos",
+             isStringValue(evalGlobal(vm3,
+                                      "CLASE Animal {\n"
+                                      "    VAR nombre: STRING\n"
+                                      "    CONSTRUCTOR(n: STRING) { nombre = n }\n"
+                                      "    FUNC sonido() { RETORNAR \"...\" }\n"
+                                      "    FUNC describir() { RETORNAR nombre + \" dice \" + sonido() }\n"
+                                      "}\n"
+                                      "CLASE Perro : Animal {\n"
+                                      "    CONSTRUCTOR(n: STRING) : Animal(n) {}\n"
+                                      "    FUNC sonido() { RETORNAR \"guau\" }\n"
+                                      "}\n"
+                                      "VAR r = Perro(\"Rex\").describir()\n",
+                                      "r"),
+                           "Rex dice guau"));
+    VM vm4;
+    run_test("VM: STRUCT con constructor posicional y campos",
+             isIntValue(evalGlobal(vm4,
+                                   "STRUCT Punto { x: INT, y: INT }\n"
+                                   "VAR p = Punto(3, 4)\np.y = p.y + 1\nVAR r = p.x * p.y\n",
+                                   "r"),
+                        15));
+    VM vm5;
+    run_test("VM: argumentos con nombre",
+             isIntValue(evalGlobal(vm5,
+                                   "STRUCT Punto { x: INT, y: INT }\n"
+                                   "VAR p = Punto(y = 2, x = 7)\nVAR r = p.x - p.y\n",
+                                   "r"),
+                        5));
+    VM vm6;
+    run_test("VM: funciones de MODULO",
+             isIntValue(evalGlobal(vm6,
+                                   "MODULO Util {\n"
+                                   "    VAR base = 100\n"
+                                   "    FUNC mas(x) { RETORNAR base + x }\n"
+                                   "}\n"
+                                   "VAR r = Util.mas(5)\n",
+                                   "r"),
+                        105));
+    VM vm7;
+    run_test("VM: métodos integrados",
+             isIntValue(evalGlobal(vm7,
+                                   "VAR a = [1, 2]\na.AGREGAR(3)\nVAR m = {\"k\": 1}\n"
+                                   "VAR r = LONGITUD(a) + a.LONGITUD()\nSI m.HAS_KEY(\"k\") { r += 10 }\n",
+                                   "r"),
+                        16));
+    VM vm8;
+    runSource(vm8, "FUNC cuadrado(x) { RETORNAR x * x }\n");
+    Value r = vm8.call(vm8.getGlobal("cuadrado"), {Value::integer(9)});
+    run_test("VM: llamada desde C++", isIntValue(r, 81));
+}
+
+// Llamadas finales: reutilizan el marco, así que la profundidad no está limitada
+void test_tail_calls() {
+    VM vm1;
+    run_test("VM: recursión final de un millón de niveles",
+             isIntValue(evalGlobal(vm1,
+                                   "FUNC suma(n, total) {\n    SI n == 0 { RETORNAR total }\n"
+                                   "    RETORNAR suma(n - 1, total + n)\n}\nVAR r = suma(1000000, 0)\n",
+                                   "r"),
+                        500000500000));
+    VM vm2;
+    run_test("VM: recursión final mutua",
+             valueToString(evalGlobal(vm2,
+                                      "FUNC par(n) {\n    SI n == 0 { RETORNAR VERDADERO }\n    RETORNAR impar(n - 1)\n}\n"
+                                      "FUNC impar(n) {\n    SI n == 0 { RETORNAR FALSO }\n    RETORNAR par(n - 1)\n}\n"
+                                      "VAR r = [par(1000000), impar(777777), par(3)]\n",
+                                      "r")) == "[VERDADERO, VERDADERO, FALSO]");
+    VM vm3;
+    run_test("VM: llamada final a un método, a una nativa y a una clase",
+             isStringValue(evalGlobal(vm3,
+                                      "CLASE Contador {\n"
+                                      "    VAR paso: INT\n"
+                                      "    CONSTRUCTOR(p: INT) { paso = p }\n"
+                                      "    FUNC contar(n, total) {\n"
+                                      "        SI n == 0 { RETORNAR total }\n"
+                                      "        RETORNAR contar(n - 1, total + paso)\n"
+                                      "    }\n"
+                                      "}\n"
+                                      "FUNC nuevo(p) { RETORNAR Contador(p) }\n"
+                                      "FUNC largo(a) { RETORNAR LONGITUD(a) }\n"
+                                      "VAR r = \"\" + nuevo(3).contar(300000, 0) + \" \" + largo([1, 2, 3])\n",
+                                      "r"),
+                           "900000 3"));
+    std::string deep = errorOf("FUNC f(n) {\n    RETORNAR 1 + f(n - 1)\n}\nVAR r = f(1000000)\n");
+    run_test("VM: la recursión que no es final sigue limitada", deep.find("desbordamiento de pila") != std::string::npos);
+    std::string inner = errorOf("FUNC g(x) {\n    RETORNAR x / 0\n}\nFUNC f(x) {\n    RETORNAR g(x)\n}\nVAR r = f(1)\n");
+    run_test("VM: un error tras una llamada final indica la función llamada",
+             inner.find("línea 2") != std::string::npos && inner.find("en g") != std::string::npos);
+    std::string arity = errorOf("FUNC g(a, b) {\n    RETORNAR a\n}\nFUNC f(x) {\n    RETORNAR g(x)\n}\nVAR r = f(1)\n");
+    run_test("VM: número de argumentos en una llamada final",
+             arity.find("espera 2") != std::string::npos && arity.find("línea 5") != std::string::npos);
+}
+
+// Cachés en línea de campos y métodos: el resultado no depende del estado del sitio
+void test_inline_caches() {
+    VM vm1;
+    run_test("IC: sitio monomórfico",
+             isIntValue(evalGlobal(vm1,
+                                   "STRUCT Punto { x: INT, y: INT }\n"
+                                   "VAR p = Punto(1, 2)\nVAR r = 0\n"
+                                   "PARA i DESDE 0 HASTA 100 { p.x = p.x + 1\n r += p.x * p.y }\n",
+                                   "r"),
+                        2 * (101 * 102 / 2 - 1)));
+    bool monomorphic = true;
+    for (const auto& proto : vm1.protos()) {
+        for (const InlineCache& cache : proto->inlineCaches) {
+            if (cache.count > 1 || cache.megamorphic) monomorphic = false;
+        }
+    }
+    run_test("IC: una clase por sitio", monomorphic && !vm1.protos()[0]->inlineCaches.empty());
+
+    VM vm2;
+    run_test("IC: métodos redefinidos en subclases (polimórfico)",
+             isStringValue(evalGlobal(vm2,
+                                      "CLASE Animal {\n"
+                                      "    VAR patas = 4\n"
+                                      "    FUNC sonido() { RETORNAR \"...\" }\n"
+                                      "}\n"
+                                      "CLASE Perro : Animal { FUNC sonido() { RETORNAR \"guau\" } }\n"
+                                      "CLASE Pato : Animal {\n"
+                                      "    VAR alas = 2\n"
+                                      "    FUNC sonido() { RETORNAR \"cuac\" }\n"
+                                      "}\n"
+                                      "VAR animales = [Animal(), Perro(), Pato(), Perro()]\n"
+                                      "VAR r = \"\"\n"
+                                      "PARA i DESDE 0 HASTA 2 {\n"
+                                      "    PARA CADA a EN animales { r = r + a.sonido() + a.patas }\n"
+                                      "}\n",
+                                      "r"),
+                           "...4guau4cuac4guau4...4guau4cuac4guau4"));
+
+    // Seis clases con el campo `v` en una posición distinta: más clases que vías
+    VM vm3;
+    std::string source;
+    std::string objects = "VAR objetos = [";
+    for (int k = 0; k < 6; ++k) {
+        source += "STRUCT C" + std::to_string(k) + " {";
+        for (int f = 0; f < k; ++f) source += " r" + std::to_string(f) + ": INT,";
+        source += " v: INT }\n";
+        objects += std::string(k > 0 ? ", " : "") + "C" + std::to_string(k) + "(";
+        for (int f = 0; f < k; ++f) objects += "0, ";
+        objects += std::to_string(k + 1) + ")";
+    }
+    source += objects + "]\nVAR r = 0\n"
+              "PARA i DESDE 0 HASTA 3 { PARA CADA o EN objetos { o.v = o.v * 2\n r += o.v } }\n";
+    run_test("IC: sitio megamórfico", isIntValue(evalGlobal(vm3, source, "r"), 21 * (2 + 4 + 8)));
+    bool megamorphic = false;
+    for (const InlineCache& cache : vm3.protos()[0]->inlineCaches) {
+        if (cache.megamorphic && cache.count == InlineCache::kWays) megamorphic = true;
+    }
+    run_test("IC: el sitio megamórfico deja de registrar clases", megamorphic);
+
+    VM vm4;
+    run_test("IC: campo que contiene una función",
+             isIntValue(evalGlobal(vm4,
+                                   "FUNC doble(x) { RETORNAR x * 2 }\n"
+                                   "FUNC triple(x) { RETORNAR x * 3 }\n"
+                                   "STRUCT Op { f: FUNC }\n"
+                                   "VAR ops = [Op(doble), Op(triple)]\nVAR r = 0\n"
+                                   "PARA CADA o EN ops { r += o.f(10) }\n",
+                                   "r"),
+                        50));
+    std::string error = errorOf("STRUCT A { x: INT }\nSTRUCT B { y: INT }\n"
+                                "FUNC leer(o) { RETORNAR o.x }\nVAR a = leer(A(1))\nVAR b = leer(B(2))\n");
+    run_test("IC: un fallo de la caché sigue detectando campos inexistentes",
+             error.find("el campo 'x' no existe en B") != std::string::npos);
+}
+
+bool usesOpcode(const VM& vm, OpCode op) {
+    for (const auto& proto : vm.protos()) {
+        for (Instr instr : proto->code) {
+            if (opOf(instr) == op) return true;
+        }
+    }
+    return false;
+}
+
+// Pruebas de ARRAY<INT> / ARRAY<FLOAT> sin etiquetar
+void test_typed_arrays() {
+    VM vm1;
+    runSource(vm1, "VAR a: ARRAY<INT> = [3, 1, 2]\nVAR f: ARRAY<FLOAT> = [1, 2.5]\nVAR sinTipo = [1, 2]\n");
+    Value a = vm1.getGlobal("a");
+    Value f = vm1.getGlobal("f");
+    run_test("Tipados: ARRAY<INT> contiguo",
+             isObjType(a, ObjType::TYPED_ARRAY) && asTypedArray(a)->elementType == ElementType::INT &&
+                 asTypedArray(a)->ints == std::vector<int64_t>{3, 1, 2});
+    run_test("Tipados: ARRAY<FLOAT> convierte los INT",
+             isObjType(f, ObjType::TYPED_ARRAY) && asTypedArray(f)->floats == std::vector<double>{1.0, 2.5});
+    run_test("Tipados: un ARRAY sin tipo declarado no cambia", isObjType(vm1.getGlobal("sinTipo"), ObjType::ARRAY));
+
+    const std::string loop =
+        "VAR v: ARRAY<INT> = []\n"
+        "PARA i DESDE 0 HASTA 1000 { v.AGREGAR(i) }\n"
+        "PARA i DESDE 0 HASTA LONGITUD(v) { v[i] = v[i] * 2 }\n"
+        "FUNC suma(x: ARRAY<INT>) {\n"
+        "    VAR copia: ARRAY<INT> = x\n"
+        "    VAR s = 0\n"
+        "    PARA j DESDE 0 HASTA LONGITUD(copia) INCREMENTO 2 { s += copia[j] }\n"
+        "    RETORNAR s\n"
+        "}\n"
+        "VAR r = suma(v)\n";
+    VM vm2;
+    run_test("Tipados: bucle hasta LONGITUD", isIntValue(evalGlobal(vm2, loop, "r"), 2 * 249500));
+    run_test("Tipados: el bucle se compila sin comprobar límites",
+             usesOpcode(vm2, OpCode::GETTYPED) && usesOpcode(vm2, OpCode::SETTYPED));
+    VM vm3;
+    run_test("Tipados: una variable reasignada conserva las comprobaciones",
+             isIntValue(evalGlobal(vm3, loop + "v = [1]\n", "r"), 2 * 249500) &&
+                 !usesOpcode(vm3, OpCode::SETTYPED));
+
+    VM vm4;
+    runSource(vm4,
+              "VAR n: ARRAY<INT> = []\nVAR x: ARRAY<FLOAT> = []\n"
+              "PARA i DESDE 0 HASTA 1003 { n.AGREGAR((i * 7919) % 1009 - 500)\n x.AGREGAR(i * 0.5) }\n"
+              "VAR s = n.SUMA()\nVAR mn = n.MINIMO()\nVAR mx = n.MAXIMO()\n"
+              "VAR sx = x.SUMA()\nVAR mnx = x.MINIMO()\nVAR mxx = x.MAXIMO()\n");
+    int64_t sum = 0, low = 1000, high = -1000;
+    for (int64_t i = 0; i < 1003; ++i) {
+        int64_t item = (i * 7919) % 1009 - 500;
+        sum += item;
+        low = std::min(low, item);
+        high = std::max(high, item);
+    }
+    run_test("Tipados: SUMA / MINIMO / MAXIMO de enteros",
+             isIntValue(vm4.getGlobal("s"), sum) && isIntValue(vm4.getGlobal("mn"), low) &&
+                 isIntValue(vm4.getGlobal("mx"), high));
+    run_test("Tipados: SUMA / MINIMO / MAXIMO de reales",
+             vm4.getGlobal("sx").asNumber() == 0.5 * 1002 * 1003 / 2 && vm4.getGlobal("mnx").asNumber() == 0.0 &&
+                 vm4.getGlobal("mxx").asNumber() == 501.0);
+
+    VM vm5;
+    Value big = evalGlobal(vm5,
+                           "VAR n: ARRAY<INT> = []\n"
+                           "PARA i DESDE 0 HASTA 20000 { n.AGREGAR(1125899906842623) }\nVAR s = n.SUMA()\n",
+                           "s");
+    run_test("Tipados: SUMA que desborda int64 pasa a FLOAT",
+             big.isFloat() && std::fabs(big.asFloat() / (20000.0 * 1125899906842623.0) - 1.0) < 1e-12);
+
+    // Cada núcleo que admite la CPU (AVX2 incluido) da lo mismo que el escalar, también
+    // con longitudes que no son múltiplo del ancho del vector
+    bool kernels = true;
+    for (TypedKernel kernel : {TypedKernel::SCALAR, TypedKernel::SSE2, TypedKernel::AVX2}) {
+        if (static_cast<int>(kernel) > static_cast<int>(detectTypedKernel())) continue;
+        setTypedKernel(kernel);
+        kernels = kernels && typedKernel() == kernel;
+        for (size_t count : {1, 3, 4, 7, 4099, 10001}) {
+            std::vector<int64_t> ints(count);
+            std::vector<double> floats(count);
+            for (size_t i = 0; i < count; ++i) {
+                ints[i] = static_cast<int64_t>((i * 7919) % 10007) - 5000;
+                floats[i] = static_cast<double>(ints[i]) * 0.5;
+            }
+            int64_t sum = 0;
+            kernels = kernels && sumInts(ints.data(), count, sum) &&
+                      sum == std::accumulate(ints.begin(), ints.end(), int64_t(0)) &&
+                      minInts(ints.data(), count) == *std::min_element(ints.begin(), ints.end()) &&
+                      maxInts(ints.data(), count) == *std::max_element(ints.begin(), ints.end()) &&
+                      sumFloats(floats.data(), count) == static_cast<double>(sum) * 0.5 &&
+                      minFloats(floats.data(), count) == *std::min_element(floats.begin(), floats.end()) &&
+                      maxFloats(floats.data(), count) == *std::max_element(floats.begin(), floats.end());
+        }
+    }
+    setTypedKernel(detectTypedKernel());
+    run_test("Tipados: los núcleos escalar, SSE2 y AVX2 coinciden", kernels);
+
+    VM vm6;
+    runSource(vm6,
+              "FUNC doble(x) { RETORNAR x * 2 }\nFUNC mitad(x) { RETORNAR x * 0.5 }\n"
+              "FUNC par(x) { RETORNAR x % 2 == 0 }\n"
+              "VAR n: ARRAY<INT> = [1, 2, 3, 4]\n"
+              "VAR m = n.MAPEAR(doble)\nVAR h = n.MAPEAR(mitad)\nVAR p = n.FILTRAR(par)\n"
+              "VAR c = [n.CONTIENE(2), n.CONTIENE(2.0), n.CONTIENE(\"2\")]\n");
+    Value m = vm6.getGlobal("m");
+    Value p = vm6.getGlobal("p");
+    run_test("Tipados: MAPEAR conserva el tipo de elemento",
+             isObjType(m, ObjType::TYPED_ARRAY) && asTypedArray(m)->ints == std::vector<int64_t>{2, 4, 6, 8});
+    run_test("Tipados: MAPEAR con resultados de otro tipo devuelve un ARRAY",
+             isObjType(vm6.getGlobal("h"), ObjType::ARRAY));
+    run_test("Tipados: FILTRAR", isObjType(p, ObjType::TYPED_ARRAY) && asTypedArray(p)->ints == std::vector<int64_t>{2, 4});
+    run_test("Tipados: CONTIENE", valueToString(vm6.getGlobal("c")) == "[VERDADERO, VERDADERO, FALSO]");
+
+    // Cada llamada crea una cadena: el resultado parcial debe sobrevivir a las recolecciones
+    VM vm7;
+    vm7.heap().setNurserySize(64 * 1024);
+    runSource(vm7,
+              "FUNC etiqueta(x) { RETORNAR \"x\" + x }\n"
+              "VAR n: ARRAY<INT> = []\nPARA i DESDE 0 HASTA 20000 { n.AGREGAR(i) }\n"
+              "VAR e = n.MAPEAR(etiqueta)\n");
+    Value tags = vm7.getGlobal("e");
+    run_test("Tipados: MAPEAR sobrevive a la recolección",
+             isObjType(tags, ObjType::ARRAY) && asArray(tags)->items.size() == 20000 &&
+                 isStringValue(asArray(tags)->items[19999], "x19999") && vm7.heap().stats().minorCollections > 0);
+
+    run_test("Tipados: guardar un FLOAT en un ARRAY<INT>",
+             errorOf("VAR a: ARRAY<INT> = [1]\na[0] = 1.5\n").find("ARRAY<INT> no admite valores de tipo FLOAT") !=
+                 std::string::npos);
+    run_test("Tipados: el mismo error en un bucle sin comprobaciones",
+             errorOf("VAR a: ARRAY<INT> = [1, 2]\nPARA i DESDE 0 HASTA LONGITUD(a) { a[i] = \"x\" }\n")
+                     .find("no admite valores de tipo STRING") != std::string::npos);
+    run_test("Tipados: inicializador con elementos de otro tipo",
+             errorOf("VAR a: ARRAY<FLOAT> = [1, \"dos\"]\n").find("ARRAY<FLOAT>") != std::string::npos);
+}
+
+// Pruebas de errores de compilación y ejecución
+void test_errors() {
+    std::string undeclared = errorOf("VAR x = y + 1\n");
+    run_test("Error: identificador no declarado",
+             undeclared.find("no declarado: y") != std::string::npos);
+    run_test("Error: asignación a constante", errorOf("CONST K = 1\nK = 2\n").find("constante") != std::string::npos);
+    std::string division = errorOf("VAR a = 1\n\nVAR b = a / 0\n");
+    run_test("Error: división por cero con número de línea",
+             division.find("línea 3") != std::string::npos && division.find("división por cero") != std::string::npos);
+    std::string nested = errorOf("FUNC f(x) {\n RETORNAR x[5]\n}\nVAR r = f([1])\n");
+    run_test("Error: índice fuera de rango dentro de una función",
+             nested.find("línea 2") != std::string::npos && nested.find("en f") != std::string::npos);
+    run_test("Error: número de argumentos", errorOf("FUNC f(a, b) { }\nf(1)\n").find("espera 2") != std::string::npos);
+    run_test("Error: ROMPER fuera de bucle", errorOf("ROMPER\n").find("ROMPER") != std::string::npos);
+}
+
+// Los tres modos de despacho deben producir el mismo resultado
+void test_dispatch_modes() {
+    const std::string source =
+        "VAR s = 0\nVAR i = 0\nMIENTRAS i < 1000 { s = s + i * 2\n i = i + 1 }\n";
+    bool same = true;
+    uint64_t counted = 0;
+    for (DispatchMode mode : {DispatchMode::THREADED, DispatchMode::SWITCH, DispatchMode::COUNTING}) {
+        VM vm;
+        vm.setDispatchMode(mode);
+        same = same && isIntValue(evalGlobal(vm, source, "s"), 999000);
+        if (mode == DispatchMode::COUNTING) counted = vm.instructionCount();
+    }
+    run_test("VM: modos de despacho equivalentes", same);
+    run_test("VM: el modo COUNTING cuenta instrucciones", counted > 1000);
+}
+
+int main() {
+    std::cout << "Iniciando pruebas de la máquina virtual de MC++" << std::endl;
+
+    test_value_representation();
+    test_arithmetic();
+    test_control_flow();
+    test_functions_and_classes();
+    test_tail_calls();
+    test_inline_caches();
+    test_typed_arrays();
+    test_errors();
+    test_dispatch_modes();
+
+    std::cout << "Pruebas completadas." << std::endl;
+    return 0;
+}